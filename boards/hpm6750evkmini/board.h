@@ -362,6 +362,7 @@
 
 /* SDXC section */
 #define BOARD_APP_SDCARD_SDXC_BASE                 (HPM_SDXC1)
+#define BOARD_APP_SDCARD_SDXC_IRQ                  IRQn_SDXC1
 #define BOARD_APP_SDCARD_SUPPORT_3V3               (1)
 #define BOARD_APP_SDCARD_SUPPORT_1V8               (1)
 #define BOARD_APP_SDCARD_SUPPORT_4BIT              (1)
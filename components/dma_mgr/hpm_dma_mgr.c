@@ -15,6 +15,11 @@
  *
  *****************************************************************************************************************/
 
+/* dma_mgr_reconfigure rewrites the whole channel once more control fields than this changed */
+#ifndef DMA_MGR_RECONFIGURE_MAX_CTRL_CHANGES
+#define DMA_MGR_RECONFIGURE_MAX_CTRL_CHANGES (2U)
+#endif
+
 typedef struct _dma_instance_info {
     DMA_Type *base;
     int32_t irq_num;
@@ -62,6 +67,14 @@ static dma_chn_context_t *dma_mgr_search_chn_context(const dma_resource_t *resou
 static uint32_t dma_mgr_enter_critical(void);
 static void dma_mgr_exit_critical(uint32_t level);
 
+/**
+ * @brief Convert DMA manager channel config to DMA driver channel config
+ *
+ * @param [in] config DMA manager channel config
+ * @param [out] dma_config DMA driver channel config
+ */
+static void dma_mgr_fill_dma_config(const dma_mgr_chn_conf_t *config, dma_channel_config_t *dma_config);
+
 static void dma0_isr(void);
 SDK_DECLARE_EXT_ISR_M(IRQn_HDMA, dma0_isr);
 
@@ -139,6 +152,40 @@ static void dma_mgr_exit_critical(uint32_t level)
     restore_global_irq(level);
 }
 
+static void dma_mgr_fill_dma_config(const dma_mgr_chn_conf_t *config, dma_channel_config_t *dma_config)
+{
+    dma_config->priority = config->priority;
+    dma_config->src_burst_size = config->src_burst_size;
+    dma_config->src_mode = config->src_mode;
+    dma_config->dst_mode = config->dst_mode;
+    dma_config->src_width = config->src_width;
+    dma_config->dst_width = config->dst_width;
+    dma_config->src_addr_ctrl = config->src_addr_ctrl;
+    dma_config->dst_addr_ctrl = config->dst_addr_ctrl;
+    dma_config->src_addr = config->src_addr;
+    dma_config->dst_addr = config->dst_addr;
+    dma_config->size_in_byte = config->size_in_byte;
+    dma_config->linked_ptr = config->linked_ptr;
+    dma_config->interrupt_mask = config->interrupt_mask;
+#if defined(DMA_MGR_HAS_INFINITE_LOOP) && DMA_MGR_HAS_INFINITE_LOOP
+    dma_config->en_infiniteloop = config->en_infiniteloop;
+#endif
+#if defined(DMA_MGR_HAS_HANDSHAKE_OPT) && DMA_MGR_HAS_HANDSHAKE_OPT
+    dma_config->handshake_opt = config->handshake_opt;
+#endif
+#if defined(DMA_MGR_HAS_BURST_OPT) && DMA_MGR_HAS_BURST_OPT
+    dma_config->burst_opt = config->burst_opt;
+#endif
+#if defined(DMA_MGR_HAS_BURST_IN_FIXED_TRANS) && DMA_MGR_HAS_BURST_IN_FIXED_TRANS
+    dma_config->en_src_burst_in_fixed_trans = config->en_src_burst_in_fixed_trans;
+    dma_config->en_dst_burst_in_fixed_trans = config->en_dst_burst_in_fixed_trans;
+#endif
+#if defined(DMA_MGR_HAS_BYTE_ORDER_SWAP) && DMA_MGR_HAS_BYTE_ORDER_SWAP
+    dma_config->swap_mode = config->swap_mode;
+    dma_config->swap_table = config->swap_table;
+#endif
+}
+
 void dma_mgr_init(void)
 {
     (void) memset(HPM_DMA_MGR, 0, sizeof(*HPM_DMA_MGR));
@@ -373,36 +420,7 @@ hpm_stat_t dma_mgr_setup_channel(const dma_resource_t *resource, dma_mgr_chn_con
     } else {
         dmamux_ch = DMA_SOC_CHN_TO_DMAMUX_CHN(resource->base, resource->channel);
         dmamux_config(HPM_DMAMUX, dmamux_ch, config->dmamux_src, config->en_dmamux);
-        dma_config.priority = config->priority;
-        dma_config.src_burst_size = config->src_burst_size;
-        dma_config.src_mode = config->src_mode;
-        dma_config.dst_mode = config->dst_mode;
-        dma_config.src_width = config->src_width;
-        dma_config.dst_width = config->dst_width;
-        dma_config.src_addr_ctrl = config->src_addr_ctrl;
-        dma_config.dst_addr_ctrl = config->dst_addr_ctrl;
-        dma_config.src_addr = config->src_addr;
-        dma_config.dst_addr = config->dst_addr;
-        dma_config.size_in_byte = config->size_in_byte;
-        dma_config.linked_ptr = config->linked_ptr;
-        dma_config.interrupt_mask = config->interrupt_mask;
-#if defined(DMA_MGR_HAS_INFINITE_LOOP) && DMA_MGR_HAS_INFINITE_LOOP
-        dma_config.en_infiniteloop = config->en_infiniteloop;
-#endif
-#if defined(DMA_MGR_HAS_HANDSHAKE_OPT) && DMA_MGR_HAS_HANDSHAKE_OPT
-        dma_config.handshake_opt = config->handshake_opt;
-#endif
-#if defined(DMA_MGR_HAS_BURST_OPT) && DMA_MGR_HAS_BURST_OPT
-        dma_config.burst_opt = config->burst_opt;
-#endif
-#if defined(DMA_MGR_HAS_BURST_IN_FIXED_TRANS) && DMA_MGR_HAS_BURST_IN_FIXED_TRANS
-        dma_config.en_src_burst_in_fixed_trans = config->en_src_burst_in_fixed_trans;
-        dma_config.en_dst_burst_in_fixed_trans = config->en_dst_burst_in_fixed_trans;
-#endif
-#if defined(DMA_MGR_HAS_BYTE_ORDER_SWAP) && DMA_MGR_HAS_BYTE_ORDER_SWAP
-        dma_config.swap_mode = config->swap_mode;
-        dma_config.swap_table = config->swap_table;
-#endif
+        dma_mgr_fill_dma_config(config, &dma_config);
         status = dma_setup_channel(resource->base, resource->channel, &dma_config, false);
     }
     return status;
@@ -418,41 +436,309 @@ hpm_stat_t dma_mgr_config_linked_descriptor(const dma_resource_t *resource, dma_
     if (chn_ctx == NULL) {
         status = status_invalid_argument;
     } else {
-        dma_config.priority = config->priority;
-        dma_config.src_burst_size = config->src_burst_size;
-        dma_config.src_mode = config->src_mode;
-        dma_config.dst_mode = config->dst_mode;
-        dma_config.src_width = config->src_width;
-        dma_config.dst_width = config->dst_width;
-        dma_config.src_addr_ctrl = config->src_addr_ctrl;
-        dma_config.dst_addr_ctrl = config->dst_addr_ctrl;
-        dma_config.src_addr = config->src_addr;
-        dma_config.dst_addr = config->dst_addr;
-        dma_config.size_in_byte = config->size_in_byte;
-        dma_config.linked_ptr = config->linked_ptr;
-        dma_config.interrupt_mask = config->interrupt_mask;
-#if defined(DMA_MGR_HAS_INFINITE_LOOP) && DMA_MGR_HAS_INFINITE_LOOP
-        dma_config.en_infiniteloop = config->en_infiniteloop;
-#endif
-#if defined(DMA_MGR_HAS_HANDSHAKE_OPT) && DMA_MGR_HAS_HANDSHAKE_OPT
-        dma_config.handshake_opt = config->handshake_opt;
-#endif
-#if defined(DMA_MGR_HAS_BURST_OPT) && DMA_MGR_HAS_BURST_OPT
-        dma_config.burst_opt = config->burst_opt;
-#endif
-#if defined(DMA_MGR_HAS_BURST_IN_FIXED_TRANS) && DMA_MGR_HAS_BURST_IN_FIXED_TRANS
-        dma_config.en_src_burst_in_fixed_trans = config->en_src_burst_in_fixed_trans;
-        dma_config.en_dst_burst_in_fixed_trans = config->en_dst_burst_in_fixed_trans;
-#endif
-#if defined(DMA_MGR_HAS_BYTE_ORDER_SWAP) && DMA_MGR_HAS_BYTE_ORDER_SWAP
-        dma_config.swap_mode = config->swap_mode;
-        dma_config.swap_table = config->swap_table;
-#endif
+        dma_mgr_fill_dma_config(config, &dma_config);
         status = dma_config_linked_descriptor(resource->base, (dma_linked_descriptor_t *)descriptor, resource->channel, &dma_config);
     }
     return status;
 }
 
+hpm_stat_t dma_mgr_get_chn_handle(const dma_resource_t *resource, dma_mgr_chn_handle_t *handle)
+{
+    hpm_stat_t status;
+
+    dma_chn_context_t *chn_ctx = dma_mgr_search_chn_context(resource);
+
+    if ((chn_ctx == NULL) || (handle == NULL)) {
+        status = status_invalid_argument;
+    } else {
+        handle->base = resource->base;
+        handle->channel = resource->channel;
+        handle->context = chn_ctx;
+        status = status_success;
+    }
+    return status;
+}
+
+/* a handle stays valid until its channel is released */
+static bool dma_mgr_handle_is_valid(const dma_mgr_chn_handle_t *handle)
+{
+    return (handle != NULL) && (handle->context != NULL) && ((dma_chn_context_t *)handle->context)->is_allocated;
+}
+
+hpm_stat_t dma_mgr_handle_set_src_addr(const dma_mgr_chn_handle_t *handle, uint32_t addr)
+{
+    hpm_stat_t status;
+
+    if (!dma_mgr_handle_is_valid(handle)) {
+        status = status_invalid_argument;
+    } else {
+        dma_set_source_address(handle->base, handle->channel, addr);
+        status = status_success;
+    }
+    return status;
+}
+
+hpm_stat_t dma_mgr_handle_set_dst_addr(const dma_mgr_chn_handle_t *handle, uint32_t addr)
+{
+    hpm_stat_t status;
+
+    if (!dma_mgr_handle_is_valid(handle)) {
+        status = status_invalid_argument;
+    } else {
+        dma_set_destination_address(handle->base, handle->channel, addr);
+        status = status_success;
+    }
+    return status;
+}
+
+hpm_stat_t dma_mgr_handle_set_transize(const dma_mgr_chn_handle_t *handle, uint32_t size)
+{
+    hpm_stat_t status;
+
+    if (!dma_mgr_handle_is_valid(handle)) {
+        status = status_invalid_argument;
+    } else {
+        dma_set_transfer_size(handle->base, handle->channel, size);
+        status = status_success;
+    }
+    return status;
+}
+
+hpm_stat_t dma_mgr_handle_enable_channel(const dma_mgr_chn_handle_t *handle)
+{
+    hpm_stat_t status;
+
+    if (!dma_mgr_handle_is_valid(handle)) {
+        status = status_invalid_argument;
+    } else {
+        status = dma_enable_channel(handle->base, handle->channel);
+    }
+    return status;
+}
+
+hpm_stat_t dma_mgr_handle_disable_channel(const dma_mgr_chn_handle_t *handle)
+{
+    hpm_stat_t status;
+
+    if (!dma_mgr_handle_is_valid(handle)) {
+        status = status_invalid_argument;
+    } else {
+        dma_disable_channel(handle->base, handle->channel);
+        status = status_success;
+    }
+    return status;
+}
+
+hpm_stat_t dma_mgr_handle_check_transfer_status(const dma_mgr_chn_handle_t *handle, uint32_t *status)
+{
+    hpm_stat_t stat;
+
+    if (!dma_mgr_handle_is_valid(handle) || (status == NULL)) {
+        stat = status_invalid_argument;
+    } else {
+        *status = dma_check_transfer_status(handle->base, handle->channel);
+        stat = status_success;
+    }
+    return stat;
+}
+
+hpm_stat_t dma_mgr_reconfigure(const dma_mgr_chn_handle_t *handle, const dma_mgr_chn_conf_t *old_config,
+                               const dma_mgr_chn_conf_t *new_config)
+{
+    hpm_stat_t status;
+    uint32_t ctrl_changes;
+    uint32_t dmamux_ch;
+    bool full_setup;
+    dma_channel_config_t dma_config;
+    const dma_mgr_chn_conf_t *o = old_config;
+    const dma_mgr_chn_conf_t *n = new_config;
+
+    if (!dma_mgr_handle_is_valid(handle) || (old_config == NULL) || (new_config == NULL)) {
+        return status_invalid_argument;
+    }
+
+    if ((n->size_in_byte & ((1 << n->dst_width) - 1))
+     || (n->src_addr & ((1 << n->src_width) - 1))
+     || (n->dst_addr & ((1 << n->dst_width) - 1))
+     || ((1 << n->src_width) & ((1 << n->dst_width) - 1))
+     || ((n->linked_ptr & 0x7))) {
+        return status_dma_alignment_error;
+    }
+
+    if ((o->en_dmamux != n->en_dmamux) || (o->dmamux_src != n->dmamux_src)) {
+        dmamux_ch = DMA_SOC_CHN_TO_DMAMUX_CHN(handle->base, handle->channel);
+        dmamux_config(HPM_DMAMUX, dmamux_ch, n->dmamux_src, n->en_dmamux);
+    }
+
+    /* each control field setter is a read-modify-write of CTRL, rewrite the channel once if many changed */
+    ctrl_changes = (o->priority != n->priority) + (o->src_burst_size != n->src_burst_size)
+                 + (o->src_mode != n->src_mode) + (o->dst_mode != n->dst_mode)
+                 + (o->src_width != n->src_width) + (o->dst_width != n->dst_width)
+                 + (o->src_addr_ctrl != n->src_addr_ctrl) + (o->dst_addr_ctrl != n->dst_addr_ctrl)
+                 + (o->interrupt_mask != n->interrupt_mask);
+    full_setup = (ctrl_changes > DMA_MGR_RECONFIGURE_MAX_CTRL_CHANGES) || (o->linked_ptr != n->linked_ptr)
+              || (o->en_infiniteloop != n->en_infiniteloop) || (o->handshake_opt != n->handshake_opt)
+              || (o->burst_opt != n->burst_opt)
+              || (o->en_src_burst_in_fixed_trans != n->en_src_burst_in_fixed_trans)
+              || (o->en_dst_burst_in_fixed_trans != n->en_dst_burst_in_fixed_trans)
+              || (o->swap_mode != n->swap_mode) || (o->swap_table != n->swap_table);
+
+    if (full_setup) {
+        dma_mgr_fill_dma_config(n, &dma_config);
+        status = dma_setup_channel(handle->base, handle->channel, &dma_config, false);
+    } else {
+        if (o->priority != n->priority) {
+            dma_set_priority(handle->base, handle->channel, n->priority);
+        }
+        if (o->src_burst_size != n->src_burst_size) {
+            dma_set_source_burst_size(handle->base, handle->channel, n->src_burst_size);
+        }
+        if (o->src_mode != n->src_mode) {
+            dma_set_source_work_mode(handle->base, handle->channel, n->src_mode);
+        }
+        if (o->dst_mode != n->dst_mode) {
+            dma_set_destination_work_mode(handle->base, handle->channel, n->dst_mode);
+        }
+        if (o->src_width != n->src_width) {
+            dma_set_source_width(handle->base, handle->channel, n->src_width);
+        }
+        if (o->dst_width != n->dst_width) {
+            dma_set_destination_width(handle->base, handle->channel, n->dst_width);
+        }
+        if (o->src_addr_ctrl != n->src_addr_ctrl) {
+            dma_set_source_address_ctrl(handle->base, handle->channel, n->src_addr_ctrl);
+        }
+        if (o->dst_addr_ctrl != n->dst_addr_ctrl) {
+            dma_set_destination_address_ctrl(handle->base, handle->channel, n->dst_addr_ctrl);
+        }
+        if (o->interrupt_mask != n->interrupt_mask) {
+            dma_disable_channel_interrupt(handle->base, handle->channel, n->interrupt_mask);
+            dma_enable_channel_interrupt(handle->base, handle->channel, ~n->interrupt_mask);
+        }
+        if (o->src_addr != n->src_addr) {
+            dma_set_source_address(handle->base, handle->channel, n->src_addr);
+        }
+        if (o->dst_addr != n->dst_addr) {
+            dma_set_destination_address(handle->base, handle->channel, n->dst_addr);
+        }
+        if ((o->size_in_byte != n->size_in_byte) || (o->src_width != n->src_width)) {
+            dma_set_transfer_size(handle->base, handle->channel, n->size_in_byte >> n->src_width);
+        }
+        status = status_success;
+    }
+    return status;
+}
+
+hpm_stat_t dma_mgr_build_descriptor_chain(const dma_resource_t *resource, dma_mgr_chn_conf_t *config, uint8_t core_id, bool mem_is_src,
+                                          const dma_mgr_segment_t *segs, uint32_t seg_cnt, dma_mgr_linked_descriptor_t *descriptors)
+{
+    hpm_stat_t status;
+    dma_mgr_chn_conf_t desc_config;
+    uint32_t *mem_addr;
+    uint32_t *other_addr;
+    uint8_t other_addr_ctrl;
+    uint32_t cur;
+    uint32_t next;
+    uint32_t desc_idx;
+
+    dma_chn_context_t *chn_ctx = dma_mgr_search_chn_context(resource);
+
+    if ((chn_ctx == NULL) || (config == NULL) || (segs == NULL) || (descriptors == NULL)) {
+        return status_invalid_argument;
+    }
+
+    for (cur = 0; (cur < seg_cnt) && (segs[cur].size == 0); cur++) {
+    }
+    if (cur == seg_cnt) {
+        return status_invalid_argument;
+    }
+
+    desc_config = *config;
+    if (mem_is_src) {
+        mem_addr = &desc_config.src_addr;
+        other_addr = &desc_config.dst_addr;
+        other_addr_ctrl = desc_config.dst_addr_ctrl;
+    } else {
+        mem_addr = &desc_config.dst_addr;
+        other_addr = &desc_config.src_addr;
+        other_addr_ctrl = desc_config.src_addr_ctrl;
+    }
+
+    /* descriptor i holds the (i + 1)th non-empty segment and points to the next one, the last one to config->linked_ptr */
+    status = status_success;
+    desc_idx = 0;
+    while ((status == status_success) && (cur < seg_cnt)) {
+        for (next = cur + 1; (next < seg_cnt) && (segs[next].size == 0); next++) {
+        }
+        *mem_addr = core_local_mem_to_sys_address(core_id, segs[cur].addr);
+        desc_config.size_in_byte = segs[cur].size;
+        if (next < seg_cnt) {
+            desc_config.linked_ptr = core_local_mem_to_sys_address(core_id, (uint32_t)&descriptors[desc_idx + 1]);
+        } else {
+            desc_config.linked_ptr = config->linked_ptr;
+        }
+        status = dma_mgr_config_linked_descriptor(resource, &desc_config, &descriptors[desc_idx]);
+        if (other_addr_ctrl == DMA_ADDRESS_CONTROL_INCREMENT) {
+            *other_addr += segs[cur].size;
+        }
+        desc_idx++;
+        cur = next;
+    }
+
+    return status;
+}
+
+hpm_stat_t dma_mgr_setup_sg_transfer(const dma_resource_t *resource, dma_mgr_chn_conf_t *config, uint8_t core_id, bool mem_is_src,
+                                     const dma_mgr_segment_t *segs, uint32_t seg_cnt, dma_mgr_linked_descriptor_t *descriptors)
+{
+    hpm_stat_t status;
+    dma_mgr_chn_conf_t chn_config;
+    dma_mgr_chn_conf_t chain_config;
+    uint32_t first;
+    uint32_t next;
+
+    dma_chn_context_t *chn_ctx = dma_mgr_search_chn_context(resource);
+
+    if ((chn_ctx == NULL) || (config == NULL) || (segs == NULL)) {
+        return status_invalid_argument;
+    }
+
+    for (first = 0; (first < seg_cnt) && (segs[first].size == 0); first++) {
+    }
+    if (first == seg_cnt) {
+        return status_invalid_argument;
+    }
+    for (next = first + 1; (next < seg_cnt) && (segs[next].size == 0); next++) {
+    }
+
+    chn_config = *config;
+    chn_config.linked_ptr = 0;
+    chn_config.size_in_byte = segs[first].size;
+    if (mem_is_src) {
+        chn_config.src_addr = core_local_mem_to_sys_address(core_id, segs[first].addr);
+    } else {
+        chn_config.dst_addr = core_local_mem_to_sys_address(core_id, segs[first].addr);
+    }
+
+    status = status_success;
+    if (next < seg_cnt) {
+        /* the chain continues where the first segment ends on the other side */
+        chain_config = chn_config;
+        if (mem_is_src && (chain_config.dst_addr_ctrl == DMA_ADDRESS_CONTROL_INCREMENT)) {
+            chain_config.dst_addr += segs[first].size;
+        } else if (!mem_is_src && (chain_config.src_addr_ctrl == DMA_ADDRESS_CONTROL_INCREMENT)) {
+            chain_config.src_addr += segs[first].size;
+        }
+        status = dma_mgr_build_descriptor_chain(resource, &chain_config, core_id, mem_is_src, &segs[next], seg_cnt - next, descriptors);
+        chn_config.linked_ptr = core_local_mem_to_sys_address(core_id, (uint32_t)&descriptors[0]);
+    }
+    if (status == status_success) {
+        status = dma_mgr_setup_channel(resource, &chn_config);
+    }
+
+    return status;
+}
+
 hpm_stat_t dma_mgr_enable_channel(const dma_resource_t *resource)
 {
     hpm_stat_t status;
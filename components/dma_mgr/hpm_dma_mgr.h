@@ -169,6 +169,23 @@ typedef struct hpm_dma_mgr_linked_descriptor {
     uint32_t descriptor[8];
 } dma_mgr_linked_descriptor_t;
 
+/**
+ * @brief DMA channel handle, a resource validated once by dma_mgr_get_chn_handle
+ */
+typedef struct hpm_dma_mgr_chn_handle {
+    DMA_Type *base;                   /**< The DMA intance that the channel belongs to */
+    uint32_t channel;                 /**< Channel index */
+    void *context;                    /**< Channel context, for internal use */
+} dma_mgr_chn_handle_t;
+
+/**
+ * @brief DMA memory segment, one span of a scatter-gather transfer
+ */
+typedef struct hpm_dma_mgr_segment {
+    uint32_t addr;                    /**< Segment address, local to the core passed to dma_mgr_setup_sg_transfer */
+    uint32_t size;                    /**< Segment size in byte, empty segments are skipped */
+} dma_mgr_segment_t;
+
 /**
  * @brief DMA Manager ISR handler
  */
@@ -299,6 +316,149 @@ hpm_stat_t dma_mgr_setup_channel(const dma_resource_t *resource, dma_mgr_chn_con
  */
 hpm_stat_t dma_mgr_config_linked_descriptor(const dma_resource_t *resource, dma_mgr_chn_conf_t *config, dma_mgr_linked_descriptor_t *descriptor);
 
+/**
+ * @brief Get a channel handle, the channel context lookup is done once here instead of in every call
+ *
+ * A handle is taken by dma_mgr_reconfigure and the dma_mgr_handle_* per-transfer calls.
+ *
+ * @param [in] resource DMA resource
+ * @param [out] handle DMA channel handle, valid until the resource is released
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameters are invalid
+ */
+hpm_stat_t dma_mgr_get_chn_handle(const dma_resource_t *resource, dma_mgr_chn_handle_t *handle);
+
+/**
+ * @brief Set DMA channel source address through a channel handle, without the channel context lookup
+ *
+ * The dma_mgr_handle_* functions are the per-transfer calls of a channel set up once, e.g. by dma_mgr_setup_channel
+ * or dma_mgr_reconfigure, and restarted for every frame. The other settings are only available with the
+ * dma_mgr_set_chn_* functions taking a resource.
+ *
+ * @param [in] handle DMA channel handle
+ * @param [in] addr source address
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameters are invalid
+ */
+hpm_stat_t dma_mgr_handle_set_src_addr(const dma_mgr_chn_handle_t *handle, uint32_t addr);
+
+/**
+ * @brief Set DMA channel destination address through a channel handle
+ *
+ * @param [in] handle DMA channel handle
+ * @param [in] addr destination address
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameters are invalid
+ */
+hpm_stat_t dma_mgr_handle_set_dst_addr(const dma_mgr_chn_handle_t *handle, uint32_t addr);
+
+/**
+ * @brief Set DMA channel transfer size through a channel handle
+ *
+ * @param [in] handle DMA channel handle
+ * @param [in] size transfer size of the channel, in source width units like dma_mgr_set_chn_transize
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameters are invalid
+ */
+hpm_stat_t dma_mgr_handle_set_transize(const dma_mgr_chn_handle_t *handle, uint32_t size);
+
+/**
+ * @brief Enable DMA channel through a channel handle, start transfer
+ *
+ * @param [in] handle DMA channel handle
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameters are invalid
+ */
+hpm_stat_t dma_mgr_handle_enable_channel(const dma_mgr_chn_handle_t *handle);
+
+/**
+ * @brief Disable DMA channel through a channel handle
+ *
+ * @param [in] handle DMA channel handle
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameters are invalid
+ */
+hpm_stat_t dma_mgr_handle_disable_channel(const dma_mgr_chn_handle_t *handle);
+
+/**
+ * @brief Check DMA channel transfer status through a channel handle
+ *
+ * @param [in] handle DMA channel handle
+ * @param [out] status transfer status, see dma_mgr_check_chn_transfer_status
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameters are invalid
+ */
+hpm_stat_t dma_mgr_handle_check_transfer_status(const dma_mgr_chn_handle_t *handle, uint32_t *status);
+
+/**
+ * @brief Reconfigure a disabled channel, only the fields that differ between old_config and new_config are written
+ *
+ * A few changed control fields are written one by one, more of them, a new linked_ptr or a change of
+ * the DMAV2 only fields rewrite the whole channel like dma_mgr_setup_channel.
+ *
+ * @param [in] handle DMA channel handle
+ * @param [in] old_config DMA channel config the channel is currently set up with
+ * @param [in] new_config new DMA channel config
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameters are invalid
+ * @retval status_dma_alignment_error if addresses or size do not match the transfer width
+ */
+hpm_stat_t dma_mgr_reconfigure(const dma_mgr_chn_handle_t *handle, const dma_mgr_chn_conf_t *old_config,
+                               const dma_mgr_chn_conf_t *new_config);
+
+/**
+ * @brief Build a linked descriptor chain for a list of memory segments of any length
+ *
+ * Each non-empty segment gets one descriptor linked to the next, the last one is linked to config->linked_ptr,
+ * 0 ends the chain and the system address of descriptors[0] makes it circular. The memory side address of config
+ * is replaced by each segment, the other side is kept, or advanced by the segment size if its address control is
+ * increment. Start the chain with a channel whose linked_ptr is the system address of descriptors[0].
+ *
+ * @param [in] resource DMA resource
+ * @param [in] config DMA channel config, size_in_byte is ignored
+ * @param [in] core_id core the segments and descriptors are local to, for the conversion to system address
+ * @param [in] mem_is_src true - segments are the source, false - segments are the destination
+ * @param [in] segs memory segments
+ * @param [in] seg_cnt memory segment count
+ * @param [out] descriptors linked descriptors, 8 byte aligned and one entry per non-empty segment
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameters are invalid or all segments are empty
+ */
+hpm_stat_t dma_mgr_build_descriptor_chain(const dma_resource_t *resource, dma_mgr_chn_conf_t *config, uint8_t core_id, bool mem_is_src,
+                                          const dma_mgr_segment_t *segs, uint32_t seg_cnt, dma_mgr_linked_descriptor_t *descriptors);
+
+/**
+ * @brief Setup a scatter-gather transfer between a list of memory segments and one peripheral address
+ *
+ * The first non-empty segment is set up in the channel, each following one in a linked descriptor,
+ * built by dma_mgr_build_descriptor_chain, so all segments are transferred in order as one channel transfer,
+ * e.g. both spans of a wrapped ring buffer.
+ * The memory side address of config is replaced by each segment, the other side is kept, or advanced by the
+ * segment size if its address control is increment. The channel is not enabled.
+ *
+ * @param [in] resource DMA resource
+ * @param [in] config DMA channel config, linked_ptr and size_in_byte are ignored
+ * @param [in] core_id core the segments and descriptors are local to, for the conversion to system address
+ * @param [in] mem_is_src true - segments are the source, false - segments are the destination
+ * @param [in] segs memory segments
+ * @param [in] seg_cnt memory segment count
+ * @param [out] descriptors linked descriptors, 8 byte aligned and room for seg_cnt - 1 entries
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameters are invalid or all segments are empty
+ */
+hpm_stat_t dma_mgr_setup_sg_transfer(const dma_resource_t *resource, dma_mgr_chn_conf_t *config, uint8_t core_id, bool mem_is_src,
+                                     const dma_mgr_segment_t *segs, uint32_t seg_cnt, dma_mgr_linked_descriptor_t *descriptors);
+
 /**
  * @brief Enable DMA channel, start transfer
  *
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Host replacement of the soc hpm_interrupt.h, included first on the command line:
+ * the global interrupt state is a variable and the PLIC calls only record the
+ * last enabled or disabled irq, the ISR declarations are plain functions.
+ */
+
+#ifndef HPM_INTERRUPT_H
+#define HPM_INTERRUPT_H
+#include "hpm_common.h"
+
+extern uint32_t host_global_irq_mask;
+extern uint32_t host_irq_enabled;
+extern uint32_t host_irq_priority;
+
+static inline void enable_global_irq(uint32_t mask)
+{
+    host_global_irq_mask |= mask;
+}
+
+static inline uint32_t disable_global_irq(uint32_t mask)
+{
+    uint32_t level = host_global_irq_mask & mask;
+
+    host_global_irq_mask &= ~mask;
+    return level;
+}
+
+static inline void restore_global_irq(uint32_t mask)
+{
+    host_global_irq_mask |= mask;
+}
+
+#define intc_m_enable_irq_with_priority(irq, priority) \
+    do {                                               \
+        host_irq_enabled = (irq);                      \
+        host_irq_priority = (priority);                \
+    } while (0)
+
+#define intc_m_disable_irq(irq) \
+    do {                        \
+        if (host_irq_enabled == (uint32_t)(irq)) { \
+            host_irq_enabled = 0; \
+        }                       \
+    } while (0)
+
+#define SDK_DECLARE_EXT_ISR_M(irq_num, isr) \
+    void default_isr_##irq_num(void);       \
+    void default_isr_##irq_num(void)        \
+    {                                       \
+        isr();                              \
+    }
+
+#define HPM_EXTERN_C
+
+#endif /* HPM_INTERRUPT_H */
@@ -0,0 +1,487 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * dma_mgr_reconfigure, the dma_mgr_handle_* calls, dma_mgr_build_descriptor_chain and dma_mgr_setup_sg_transfer
+ * against the register file of the soc, backed by host memory at the peripheral
+ * base addresses so the real DMA and DMAMUX drivers run unchanged.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "hpm_dma_mgr.h"
+#include "hpm_soc.h"
+
+#define CHAIN_SEGMENTS      (8U)
+#define RANDOM_RECONFIGS    (20000U)
+
+#ifdef HPMSOC_HAS_HPMSDK_DMAV2
+#define CHCTRL_ENABLE_MASK  DMAV2_CHCTRL_CTRL_ENABLE_MASK
+#else
+#define CHCTRL_ENABLE_MASK  DMA_CHCTRL_CTRL_ENABLE_MASK
+#endif
+
+uint32_t host_global_irq_mask = CSR_MSTATUS_MIE_MASK;
+uint32_t host_irq_enabled;
+uint32_t host_irq_priority;
+
+static int failures;
+static dma_mgr_linked_descriptor_t *descriptors;
+
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+static void check(bool ok, const char *what, int line)
+{
+    if (!ok) {
+        printf("line %d: %s failed\n", line, what);
+        failures++;
+    }
+}
+
+static void map_registers(uintptr_t base, size_t size)
+{
+    void *p = mmap((void *)base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+
+    if (p != (void *)base) {
+        printf("cannot map registers at 0x%lx\n", (unsigned long)base);
+        exit(1);
+    }
+}
+
+/* the driver keeps addresses in uint32_t, the descriptors must be below 4 GB */
+static dma_mgr_linked_descriptor_t *alloc_descriptors(uint32_t count)
+{
+    void *p = mmap(NULL, count * sizeof(dma_mgr_linked_descriptor_t), PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+
+    if ((p == MAP_FAILED) || ((uintptr_t)p > UINT32_MAX)) {
+        printf("cannot allocate descriptors below 4 GB\n");
+        exit(1);
+    }
+    return p;
+}
+
+static void default_config(dma_mgr_chn_conf_t *config)
+{
+    dma_mgr_get_default_chn_config(config);
+    config->src_width = DMA_TRANSFER_WIDTH_WORD;
+    config->dst_width = DMA_TRANSFER_WIDTH_WORD;
+    config->src_addr = 0x01080000U;
+    config->dst_addr = 0x01100000U;
+    config->size_in_byte = 256;
+}
+
+static void test_error_paths(dma_resource_t *res, dma_mgr_chn_handle_t *handle)
+{
+    dma_mgr_chn_conf_t old_config, new_config, config;
+    dma_mgr_chn_handle_t bad_handle;
+    dma_resource_t unallocated;
+    dma_mgr_segment_t segs[3] = {{0x01080000U, 64}, {0x01090000U, 64}, {0x010A0000U, 64}};
+    dma_mgr_segment_t empty[3] = {{0x01080000U, 0}, {0x01090000U, 0}, {0x010A0000U, 0}};
+
+    default_config(&old_config);
+    new_config = old_config;
+    config = old_config;
+
+    CHECK(dma_mgr_reconfigure(NULL, &old_config, &new_config) == status_invalid_argument);
+    CHECK(dma_mgr_reconfigure(handle, NULL, &new_config) == status_invalid_argument);
+    CHECK(dma_mgr_reconfigure(handle, &old_config, NULL) == status_invalid_argument);
+    bad_handle = *handle;
+    bad_handle.context = NULL;
+    CHECK(dma_mgr_reconfigure(&bad_handle, &old_config, &new_config) == status_invalid_argument);
+    CHECK(dma_mgr_get_chn_handle(res, NULL) == status_invalid_argument);
+
+    /* a handle of a released channel is refused */
+    CHECK(dma_mgr_request_resource(&unallocated) == status_success);
+    CHECK(dma_mgr_get_chn_handle(&unallocated, &bad_handle) == status_success);
+    CHECK(dma_mgr_release_resource(&unallocated) == status_success);
+    CHECK(dma_mgr_reconfigure(&bad_handle, &old_config, &new_config) == status_invalid_argument);
+    CHECK(dma_mgr_get_chn_handle(&unallocated, &bad_handle) == status_invalid_argument);
+
+    new_config.src_addr += 2;
+    CHECK(dma_mgr_reconfigure(handle, &old_config, &new_config) == status_dma_alignment_error);
+    new_config = old_config;
+    new_config.dst_addr += 1;
+    CHECK(dma_mgr_reconfigure(handle, &old_config, &new_config) == status_dma_alignment_error);
+    new_config = old_config;
+    new_config.size_in_byte = 6;
+    CHECK(dma_mgr_reconfigure(handle, &old_config, &new_config) == status_dma_alignment_error);
+    new_config = old_config;
+    new_config.linked_ptr = 0x01000004U;
+    CHECK(dma_mgr_reconfigure(handle, &old_config, &new_config) == status_dma_alignment_error);
+    new_config = old_config;
+    CHECK(dma_mgr_reconfigure(handle, &old_config, &new_config) == status_success);
+
+    CHECK(dma_mgr_build_descriptor_chain(NULL, &config, HPM_CORE0, true, segs, 3, descriptors) == status_invalid_argument);
+    CHECK(dma_mgr_build_descriptor_chain(&unallocated, &config, HPM_CORE0, true, segs, 3, descriptors) == status_invalid_argument);
+    CHECK(dma_mgr_build_descriptor_chain(res, NULL, HPM_CORE0, true, segs, 3, descriptors) == status_invalid_argument);
+    CHECK(dma_mgr_build_descriptor_chain(res, &config, HPM_CORE0, true, NULL, 3, descriptors) == status_invalid_argument);
+    CHECK(dma_mgr_build_descriptor_chain(res, &config, HPM_CORE0, true, segs, 3, NULL) == status_invalid_argument);
+    CHECK(dma_mgr_build_descriptor_chain(res, &config, HPM_CORE0, true, segs, 0, descriptors) == status_invalid_argument);
+    CHECK(dma_mgr_build_descriptor_chain(res, &config, HPM_CORE0, true, empty, 3, descriptors) == status_invalid_argument);
+    segs[1].size = 62;
+    CHECK(dma_mgr_build_descriptor_chain(res, &config, HPM_CORE0, true, segs, 3, descriptors) == status_dma_alignment_error);
+    segs[1].size = 64;
+
+    CHECK(dma_mgr_setup_sg_transfer(NULL, &config, HPM_CORE0, true, segs, 3, descriptors) == status_invalid_argument);
+    CHECK(dma_mgr_setup_sg_transfer(&unallocated, &config, HPM_CORE0, true, segs, 3, descriptors) == status_invalid_argument);
+    CHECK(dma_mgr_setup_sg_transfer(res, NULL, HPM_CORE0, true, segs, 3, descriptors) == status_invalid_argument);
+    CHECK(dma_mgr_setup_sg_transfer(res, &config, HPM_CORE0, true, NULL, 3, descriptors) == status_invalid_argument);
+    CHECK(dma_mgr_setup_sg_transfer(res, &config, HPM_CORE0, true, empty, 3, descriptors) == status_invalid_argument);
+    CHECK(dma_mgr_setup_sg_transfer(res, &config, HPM_CORE0, true, segs, 0, descriptors) == status_invalid_argument);
+    /* descriptors are only needed when more than one segment is not empty */
+    CHECK(dma_mgr_setup_sg_transfer(res, &config, HPM_CORE0, true, segs, 3, NULL) == status_invalid_argument);
+    empty[1].size = 64;
+    CHECK(dma_mgr_setup_sg_transfer(res, &config, HPM_CORE0, true, empty, 3, NULL) == status_success);
+    empty[1].size = 0;
+    segs[2].size = 62;
+    CHECK(dma_mgr_setup_sg_transfer(res, &config, HPM_CORE0, true, segs, 3, descriptors) == status_dma_alignment_error);
+}
+
+/* config->linked_ptr is ignored by dma_mgr_setup_sg_transfer, the chain always ends with 0 */
+static void test_chain(dma_resource_t *res, bool mem_is_src, uint8_t other_addr_ctrl, uint32_t ignored_link)
+{
+    static const uint32_t sizes[CHAIN_SEGMENTS] = {64, 0, 128, 4, 0, 0, 1024, 32};
+    dma_mgr_segment_t segs[CHAIN_SEGMENTS];
+    dma_mgr_chn_conf_t config;
+    DMA_Type *base = res->base;
+    dma_linked_descriptor_t *desc = (dma_linked_descriptor_t *)descriptors;
+    uint32_t other_addr;
+    uint32_t next_desc;
+    uint32_t desc_idx;
+    bool first = true;
+
+    default_config(&config);
+    config.linked_ptr = ignored_link;
+    if (mem_is_src) {
+        config.dst_addr_ctrl = other_addr_ctrl;
+    } else {
+        config.src_addr_ctrl = other_addr_ctrl;
+    }
+    other_addr = mem_is_src ? config.dst_addr : config.src_addr;
+    for (uint32_t i = 0; i < CHAIN_SEGMENTS; i++) {
+        segs[i].addr = 0x01200000U + i * 0x10000U;
+        segs[i].size = sizes[i];
+    }
+    memset(descriptors, 0x5A, CHAIN_SEGMENTS * sizeof(*descriptors));
+    base->CHCTRL[res->channel].LLPOINTER = 0xFFFFFFF8U;
+
+    CHECK(dma_mgr_setup_sg_transfer(res, &config, HPM_CORE0, mem_is_src, segs, CHAIN_SEGMENTS, descriptors) == status_success);
+
+    /* walk from the channel through the descriptors, one stop per non-empty segment */
+    desc_idx = 0;
+    next_desc = 0;
+    for (uint32_t i = 0; i < CHAIN_SEGMENTS; i++) {
+        uint32_t mem, other, size, link;
+
+        if (sizes[i] == 0) {
+            continue;
+        }
+        if (first) {
+            mem = mem_is_src ? base->CHCTRL[res->channel].SRCADDR : base->CHCTRL[res->channel].DSTADDR;
+            other = mem_is_src ? base->CHCTRL[res->channel].DSTADDR : base->CHCTRL[res->channel].SRCADDR;
+            size = base->CHCTRL[res->channel].TRANSIZE << config.src_width;
+            link = base->CHCTRL[res->channel].LLPOINTER;
+            CHECK(link == (uint32_t)(uintptr_t)&descriptors[0]);
+            first = false;
+        } else {
+            CHECK(next_desc == (uint32_t)(uintptr_t)&desc[desc_idx]);
+            mem = mem_is_src ? desc[desc_idx].src_addr : desc[desc_idx].dst_addr;
+            other = mem_is_src ? desc[desc_idx].dst_addr : desc[desc_idx].src_addr;
+            size = desc[desc_idx].trans_size << config.src_width;
+            link = desc[desc_idx].linked_ptr;
+            CHECK(desc[desc_idx].ctrl == (base->CHCTRL[res->channel].CTRL | CHCTRL_ENABLE_MASK));
+            desc_idx++;
+        }
+        CHECK(mem == segs[i].addr);
+        CHECK(other == other_addr);
+        CHECK(size == segs[i].size);
+        next_desc = link;
+        if (other_addr_ctrl == DMA_ADDRESS_CONTROL_INCREMENT) {
+            other_addr += segs[i].size;
+        }
+    }
+    CHECK(next_desc == 0);
+    /* one descriptor per non-empty segment after the first, nothing written beyond */
+    CHECK(desc_idx == 4);
+    for (uint32_t i = 0; i < sizeof(descriptors[desc_idx].descriptor) / sizeof(uint32_t); i++) {
+        CHECK(descriptors[desc_idx].descriptor[i] == 0x5A5A5A5AU);
+    }
+}
+
+static void test_circular_chain(dma_resource_t *res)
+{
+    dma_mgr_segment_t segs[3] = {{0x01080000U, 64}, {0x01090000U, 0}, {0x010A0000U, 128}};
+    dma_mgr_chn_conf_t config;
+    dma_linked_descriptor_t *desc = (dma_linked_descriptor_t *)descriptors;
+
+    default_config(&config);
+    config.linked_ptr = (uint32_t)(uintptr_t)&descriptors[0];
+    CHECK(dma_mgr_build_descriptor_chain(res, &config, HPM_CORE0, false, segs, 3, descriptors) == status_success);
+    CHECK(desc[0].dst_addr == 0x01080000U);
+    CHECK(desc[0].linked_ptr == (uint32_t)(uintptr_t)&descriptors[1]);
+    CHECK(desc[1].dst_addr == 0x010A0000U);
+    CHECK(desc[1].src_addr == config.src_addr + 64);
+    CHECK(desc[1].linked_ptr == (uint32_t)(uintptr_t)&descriptors[0]);
+    /* the caller's config is left as it was */
+    CHECK(config.src_addr == 0x01080000U);
+    CHECK(config.size_in_byte == 256);
+}
+
+/* LLPOINTER is only written by the full setup, a sentinel there tells which path was taken */
+static bool reconfigure_was_full(dma_mgr_chn_handle_t *handle, dma_mgr_chn_conf_t *old_config,
+                                 dma_mgr_chn_conf_t *new_config)
+{
+    DMA_Type *base = handle->base;
+    uint32_t sentinel = 0xFFFFFFF8U;
+
+    base->CHCTRL[handle->channel].LLPOINTER = sentinel;
+    CHECK(dma_mgr_reconfigure(handle, old_config, new_config) == status_success);
+    return base->CHCTRL[handle->channel].LLPOINTER != sentinel;
+}
+
+/* each of the 9 control fields of the channel, changed to a value that differs from default_config */
+static void change_ctrl_field(dma_mgr_chn_conf_t *config, uint32_t field)
+{
+    switch (field) {
+    case 0:
+        config->priority = DMA_CHANNEL_PRIORITY_HIGH;
+        break;
+    case 1:
+        config->src_burst_size = DMA_NUM_TRANSFER_PER_BURST_4T;
+        break;
+    case 2:
+        config->src_mode = DMA_HANDSHAKE_MODE_HANDSHAKE;
+        break;
+    case 3:
+        config->src_addr_ctrl = DMA_ADDRESS_CONTROL_FIXED;
+        break;
+    case 4:
+        config->dst_addr_ctrl = DMA_ADDRESS_CONTROL_DECREMENT;
+        break;
+    case 5:
+        config->interrupt_mask = DMA_INTERRUPT_MASK_ALL;
+        break;
+    case 6:
+        config->dst_width = DMA_TRANSFER_WIDTH_HALF_WORD;
+        break;
+    case 7:
+        config->src_width = DMA_TRANSFER_WIDTH_HALF_WORD;
+        break;
+    default:
+        config->dst_mode = DMA_HANDSHAKE_MODE_HANDSHAKE;
+        config->src_mode = DMA_HANDSHAKE_MODE_NORMAL;
+        break;
+    }
+}
+
+static void test_max_ctrl_changes(dma_resource_t *res, dma_mgr_chn_handle_t *handle)
+{
+    dma_mgr_chn_conf_t old_config, new_config;
+
+    default_config(&old_config);
+    CHECK(dma_mgr_setup_channel(res, &old_config) == status_success);
+
+    /* addresses and size are not control fields */
+    new_config = old_config;
+    new_config.src_addr += 64;
+    new_config.dst_addr += 64;
+    new_config.size_in_byte = 512;
+    CHECK(!reconfigure_was_full(handle, &old_config, &new_config));
+
+    /* up to the limit the fields are written one by one, one more rewrites the channel */
+    for (uint32_t changes = 1; changes <= 8; changes++) {
+        new_config = old_config;
+        for (uint32_t field = 0; field < changes; field++) {
+            change_ctrl_field(&new_config, field);
+        }
+        CHECK(reconfigure_was_full(handle, &old_config, &new_config) == (changes > DMA_MGR_RECONFIGURE_MAX_CTRL_CHANGES));
+    }
+
+    /* a new linked_ptr always takes the full path */
+    new_config = old_config;
+    new_config.linked_ptr = 0x01000000U;
+    CHECK(reconfigure_was_full(handle, &old_config, &new_config));
+    CHECK(handle->base->CHCTRL[handle->channel].LLPOINTER == 0x01000000U);
+}
+
+/* only the transfer complete flag of the channel, the status reads write back what they find set */
+static void set_chn_tc_status(DMA_Type *base, uint32_t ch)
+{
+#ifdef HPMSOC_HAS_HPMSDK_DMAV2
+    base->INTHALFSTS = 0;
+    base->INTERRSTS = 0;
+    base->INTABORTSTS = 0;
+    base->INTTCSTS = 1U << ch;
+#else
+    base->INTSTATUS = 1U << (DMA_STATUS_TC_SHIFT + ch);
+#endif
+}
+
+/* the handle calls refuse what the reconfigure refuses and write what the resource calls write */
+static void test_handle_calls(dma_resource_t *res, dma_mgr_chn_handle_t *handle)
+{
+    DMA_Type *base = handle->base;
+    uint32_t ch = handle->channel;
+    dma_mgr_chn_handle_t bad_handles[2];
+    dma_resource_t released;
+    uint32_t sts, res_sts;
+
+    bad_handles[0] = *handle;
+    bad_handles[0].context = NULL;
+    CHECK(dma_mgr_request_resource(&released) == status_success);
+    CHECK(dma_mgr_get_chn_handle(&released, &bad_handles[1]) == status_success);
+    CHECK(dma_mgr_release_resource(&released) == status_success);
+    CHECK(dma_mgr_handle_set_src_addr(NULL, 0x01080000U) == status_invalid_argument);
+    CHECK(dma_mgr_handle_check_transfer_status(handle, NULL) == status_invalid_argument);
+    for (uint32_t i = 0; i < 2; i++) {
+        CHECK(dma_mgr_handle_set_src_addr(&bad_handles[i], 0x01080000U) == status_invalid_argument);
+        CHECK(dma_mgr_handle_set_dst_addr(&bad_handles[i], 0x01100000U) == status_invalid_argument);
+        CHECK(dma_mgr_handle_set_transize(&bad_handles[i], 16) == status_invalid_argument);
+        CHECK(dma_mgr_handle_enable_channel(&bad_handles[i]) == status_invalid_argument);
+        CHECK(dma_mgr_handle_disable_channel(&bad_handles[i]) == status_invalid_argument);
+        CHECK(dma_mgr_handle_check_transfer_status(&bad_handles[i], &sts) == status_invalid_argument);
+    }
+
+    for (uint32_t frame = 0; frame < 4; frame++) {
+        uint32_t src = 0x01080000U + frame * 0x100U;
+        uint32_t dst = 0x01100000U + frame * 0x40U;
+        uint32_t size = 16U + frame;
+
+        CHECK(dma_mgr_handle_disable_channel(handle) == status_success);
+        CHECK((base->CHCTRL[ch].CTRL & CHCTRL_ENABLE_MASK) == 0);
+        CHECK(dma_mgr_handle_set_src_addr(handle, src) == status_success);
+        CHECK(dma_mgr_handle_set_dst_addr(handle, dst) == status_success);
+        CHECK(dma_mgr_handle_set_transize(handle, size) == status_success);
+        CHECK(base->CHCTRL[ch].SRCADDR == src);
+        CHECK(base->CHCTRL[ch].DSTADDR == dst);
+        CHECK(base->CHCTRL[ch].TRANSIZE == size);
+        /* the host has no CHEN, both report the same status for it */
+        CHECK(dma_mgr_handle_enable_channel(handle) == dma_mgr_enable_channel(res));
+        CHECK((base->CHCTRL[ch].CTRL & CHCTRL_ENABLE_MASK) != 0);
+        set_chn_tc_status(base, ch);
+        CHECK(dma_mgr_handle_check_transfer_status(handle, &sts) == status_success);
+        CHECK(sts == DMA_MGR_CHANNEL_STATUS_TC);
+        set_chn_tc_status(base, ch);
+        CHECK(dma_mgr_check_chn_transfer_status(res, &res_sts) == status_success);
+        CHECK(sts == res_sts);
+    }
+    CHECK(dma_mgr_handle_disable_channel(handle) == status_success);
+    CHECK((base->CHCTRL[ch].CTRL & CHCTRL_ENABLE_MASK) == 0);
+}
+
+static uint8_t pick(const uint8_t *values, uint32_t count)
+{
+    return values[(uint32_t)rand() % count];
+}
+
+/* the registers after a reconfigure are those a full setup with new_config gives */
+static void test_equivalence(dma_resource_t *res, dma_mgr_chn_handle_t *handle)
+{
+    static const uint8_t widths[] = {DMA_TRANSFER_WIDTH_BYTE, DMA_TRANSFER_WIDTH_HALF_WORD, DMA_TRANSFER_WIDTH_WORD};
+    static const uint8_t addr_ctrls[] = {DMA_ADDRESS_CONTROL_INCREMENT, DMA_ADDRESS_CONTROL_DECREMENT,
+                                         DMA_ADDRESS_CONTROL_FIXED};
+    static const uint8_t masks[] = {DMA_INTERRUPT_MASK_NONE, DMA_INTERRUPT_MASK_ERROR, DMA_INTERRUPT_MASK_ABORT,
+                                    DMA_INTERRUPT_MASK_TERMINAL_COUNT, DMA_INTERRUPT_MASK_ALL};
+    DMA_Type *base = handle->base;
+    uint32_t full = 0;
+
+    srand(1);
+    for (uint32_t i = 0; i < RANDOM_RECONFIGS; i++) {
+        dma_mgr_chn_conf_t config[2];
+        uint32_t ctrl, src, dst, size, link;
+
+        for (int k = 0; k < 2; k++) {
+            default_config(&config[k]);
+            config[k].priority = rand() & 1;
+            config[k].src_burst_size = rand() % 8;
+            config[k].src_mode = rand() & 1;
+            config[k].dst_mode = config[k].src_mode ? 0 : (rand() & 1);
+            config[k].src_width = pick(widths, 3);
+            config[k].dst_width = config[k].src_width;
+            config[k].src_addr_ctrl = pick(addr_ctrls, 3);
+            config[k].dst_addr_ctrl = pick(addr_ctrls, 3);
+            config[k].interrupt_mask = pick(masks, 5);
+            config[k].src_addr = 0x01080000U + (rand() % 256) * 4;
+            config[k].dst_addr = 0x01100000U + (rand() % 256) * 4;
+            config[k].size_in_byte = (1 + rand() % 256) * 4;
+            config[k].linked_ptr = (rand() % 8 == 0) ? 0x01000000U : 0;
+        }
+        /* most reconfigures keep most fields */
+        if (rand() & 1) {
+            dma_mgr_chn_conf_t mixed = config[0];
+
+            mixed.src_addr = config[1].src_addr;
+            mixed.size_in_byte = config[1].size_in_byte;
+            if (rand() & 1) {
+                mixed.priority = config[1].priority;
+            }
+            if (rand() & 1) {
+                mixed.interrupt_mask = config[1].interrupt_mask;
+            }
+            config[1] = mixed;
+        }
+
+        CHECK(dma_mgr_setup_channel(res, &config[0]) == status_success);
+        full += reconfigure_was_full(handle, &config[0], &config[1]);
+        ctrl = base->CHCTRL[handle->channel].CTRL;
+        src = base->CHCTRL[handle->channel].SRCADDR;
+        dst = base->CHCTRL[handle->channel].DSTADDR;
+        size = base->CHCTRL[handle->channel].TRANSIZE;
+        link = base->CHCTRL[handle->channel].LLPOINTER;
+
+        CHECK(dma_mgr_setup_channel(res, &config[1]) == status_success);
+        CHECK(ctrl == base->CHCTRL[handle->channel].CTRL);
+        CHECK(src == base->CHCTRL[handle->channel].SRCADDR);
+        CHECK(dst == base->CHCTRL[handle->channel].DSTADDR);
+        CHECK(size == base->CHCTRL[handle->channel].TRANSIZE);
+        /* the incremental path leaves the sentinel, config[0].linked_ptr == config[1].linked_ptr there */
+        if (link == 0xFFFFFFF8U) {
+            CHECK(config[0].linked_ptr == config[1].linked_ptr);
+        } else {
+            CHECK(link == base->CHCTRL[handle->channel].LLPOINTER);
+        }
+        if (failures > 20) {
+            break;
+        }
+    }
+    printf("%u random reconfigures, %u through the full setup\n", RANDOM_RECONFIGS, full);
+    CHECK((full > 0) && (full < RANDOM_RECONFIGS));
+}
+
+int main(void)
+{
+    dma_resource_t res;
+    dma_mgr_chn_handle_t handle;
+
+    map_registers(HPM_DMAMUX_BASE, 0x4000);
+    map_registers(HPM_HDMA_BASE, 0x4000);
+#if defined(DMA_SOC_MAX_COUNT) && (DMA_SOC_MAX_COUNT > 1)
+    map_registers(HPM_XDMA_BASE, 0x4000);
+#endif
+    descriptors = alloc_descriptors(CHAIN_SEGMENTS);
+
+    dma_mgr_init();
+    CHECK(dma_mgr_request_resource(&res) == status_success);
+    CHECK(dma_mgr_get_chn_handle(&res, &handle) == status_success);
+
+    test_error_paths(&res, &handle);
+    test_handle_calls(&res, &handle);
+    test_chain(&res, true, DMA_ADDRESS_CONTROL_INCREMENT, 0);
+    test_chain(&res, false, DMA_ADDRESS_CONTROL_INCREMENT, 0);
+    test_chain(&res, true, DMA_ADDRESS_CONTROL_FIXED, 0);
+    test_chain(&res, false, DMA_ADDRESS_CONTROL_FIXED, (uint32_t)(uintptr_t)&descriptors[CHAIN_SEGMENTS - 1]);
+    test_circular_chain(&res);
+    test_max_ctrl_changes(&res, &handle);
+    test_equivalence(&res, &handle);
+    CHECK(host_global_irq_mask == CSR_MSTATUS_MIE_MASK);
+
+    printf(failures ? "FAILED\n" : "PASSED.\n");
+    return failures ? 1 : 0;
+}
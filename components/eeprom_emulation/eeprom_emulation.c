@@ -7,73 +7,670 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 
 #include "eeprom_emulation.h"
 #include "hpm_crc32.h"
 
-#define E2P_OFFSET(TYPE, MEMBER) ((uint32_t)(&(((TYPE *)0)->MEMBER)))
-#define E2P_SWAP(a, b)\
-do {\
-    uint32_t tmp = (a);\
-    (a) = (b);\
-    (b) = tmp;\
-} while (0)
+#define E2P_OFFSET(TYPE, MEMBER) ((uint32_t)offsetof(TYPE, MEMBER))
+
+#if E2P_MAX_VAR_CNT >= 0xFFFF
+#error "E2P_MAX_VAR_CNT must be less than 65535"
+#endif
+
+/* open addressing hash index over e2p_info_table, holds table position + 1, 0 means empty */
+#define E2P_INDEX_SIZE (2 * E2P_MAX_VAR_CNT + 1)
 
-static e2p_t e2p_dummy;
 static e2p_t *e2p_raw, *e2p_valid_ctx;
 static e2p_block e2p_info_table[E2P_MAX_VAR_CNT];
+static uint16_t e2p_info_index[E2P_INDEX_SIZE];
+static uint32_t e2p_info_count;
 
 E2P_ATTR
-static void e2p_print_info(e2p_t *e2p)
+static void e2p_index_reset(void)
 {
-    uint32_t info_count;
-    uint32_t valid_count = E2P_MAX_VAR_CNT;
+    memset(e2p_info_table, E2P_EARSED_VAR, sizeof(e2p_info_table));
+    memset(e2p_info_index, 0, sizeof(e2p_info_index));
+    e2p_info_count = 0;
+}
 
-    info_count = (e2p->config.start_addr + e2p->config.sector_cnt * e2p->config.erase_size - e2p->p_info - sizeof(e2p_header)) / sizeof(e2p_block) - 1;
-    for (int i = 0; i < E2P_MAX_VAR_CNT; i++) {
-        if (e2p_info_table[i].block_id == E2P_EARSED_ID) {
-            valid_count = i;
+/*
+ * Return the index position holding block_id, or the empty position where it should be inserted.
+ * The index is never more than half full, so the linear probe always ends on an empty position.
+ */
+
+E2P_ATTR
+static uint32_t e2p_index_probe(uint32_t block_id)
+{
+    uint32_t pos = (block_id * 0x9E3779B1u) % E2P_INDEX_SIZE;
+
+    while (e2p_info_index[pos] != 0) {
+        if (e2p_info_table[e2p_info_index[pos] - 1].block_id == block_id)
+            break;
+        if (++pos == E2P_INDEX_SIZE)
+            pos = 0;
+    }
+
+    return pos;
+}
+
+E2P_ATTR
+static hpm_stat_t e2p_table_update(e2p_block *block)
+{
+    uint32_t i;
+    uint32_t pos;
+
+    if (block->valid_state == e2p_invalid)
+        return E2P_STATUS_OK;
+
+    pos = e2p_index_probe(block->block_id);
+    if (e2p_info_index[pos] != 0) {
+        e2p_trace("block_id[0x%08x] multiple write, flush api solve repeat\n", block->block_id);
+        i = e2p_info_index[pos] - 1;
+    } else {
+        if (e2p_info_count == E2P_MAX_VAR_CNT)
+            return E2P_ERROR_MUL_VAR;
+        i = e2p_info_count++;
+        e2p_info_index[pos] = i + 1;
+    }
+
+    memcpy(&e2p_info_table[i], block, sizeof(e2p_block));
+    return E2P_STATUS_OK;
+}
+
+E2P_ATTR
+static uint32_t e2p_data_crc_calc(uint16_t length, uint8_t *data)
+{
+    return crc32(data, (uint32_t)length);
+}
+
+E2P_ATTR
+static hpm_stat_t e2p_retrieve_info(uint32_t block_id, e2p_block *block)
+{
+    uint32_t pos;
+
+    if (block_id == E2P_EARSED_ID)
+        return E2P_ERROR_BAD_ID;
+
+    pos = e2p_index_probe(block_id);
+    if (e2p_info_index[pos] == 0)
+        return E2P_ERROR_BAD_ID;
+
+    e2p_trace("find read block, pos at table[%u]\n", e2p_info_index[pos] - 1);
+    memcpy(block, &e2p_info_table[e2p_info_index[pos] - 1], sizeof(e2p_block));
+    return E2P_STATUS_OK;
+}
+
+E2P_ATTR
+static hpm_stat_t e2p_check_config(e2p_t *e2p)
+{
+    if (e2p->config.erase_size == 0 || e2p->config.sector_cnt == 0) {
+        e2p_err("config error erase_size = %u, sector_cnt = %u\n", e2p->config.erase_size, e2p->config.sector_cnt);
+        return E2P_ERROR_INIT_ERR;
+    }
+
+    if (e2p->config.flash_read == NULL || e2p->config.flash_write == NULL || e2p->config.flash_erase == NULL) {
+        e2p_err("Not register operate function read = %p, write = %p, erase = %p", \
+                      e2p->config.flash_read, e2p->config.flash_write, e2p->config.flash_erase);
+        return E2P_ERROR_INIT_ERR;
+    }
+
+    return E2P_STATUS_OK;
+}
+
+#if E2P_LOG_MODE
+
+/*
+ * Log structured mode
+ *
+ * Each sector starts with an e2p_sector_header and is then filled with e2p_record entries, each
+ * followed by its data padded to 4 bytes. A record is committed by programming its valid_state
+ * last, so a record torn by a power loss is never taken as valid, and its checked header tells
+ * replay how far to skip. Sectors are opened in sequence number order and replayed in the same
+ * order on boot, the latest record of a block_id wins.
+ *
+ * The garbage collector moves the live records of one victim sector to the write sector and then
+ * erases the victim, doing one record copy or one sector erase per e2p_gc_step() call. A new
+ * sector is always taken with the lowest erase count, and cold sectors are moved once their
+ * erase count falls E2P_LOG_WEAR_LEVEL_DELTA behind.
+ */
+#define E2P_LOG_NONE            (0xFFFFFFFFUL)
+#define E2P_LOG_SEQ_FREE        (0xFFFFFFFFUL)
+#define E2P_LOG_SEQ_RETIRED     (0UL)
+#define E2P_LOG_REC_SIZE(len)   ((sizeof(e2p_record) + (len) + 3UL) & ~3UL)
+
+#if E2P_LOG_GC_FREE_SECTORS < 2
+#error "E2P_LOG_GC_FREE_SECTORS must be at least 2"
+#endif
+
+enum {
+    e2p_gc_idle = 0,    /* collect below E2P_LOG_GC_FREE_SECTORS free sectors, or for wear levelling */
+    e2p_gc_force,       /* collect any sector holding stale records */
+};
+
+typedef struct {
+    uint32_t erase_cnt;
+    uint32_t seq;
+    uint32_t used;      /* end offset of the last record */
+    uint32_t live;      /* size of the records still referenced by the index */
+} e2p_sector_state;
+
+static e2p_sector_state e2p_sectors[E2P_LOG_MAX_SECTOR_CNT];
+static uint32_t e2p_log_active;
+static uint32_t e2p_log_free_cnt;
+static uint32_t e2p_log_next_seq;
+static uint32_t e2p_log_victim;
+static uint32_t e2p_log_cursor;
+
+E2P_ATTR
+static uint32_t e2p_log_sector_addr(uint32_t sector)
+{
+    return e2p_valid_ctx->config.start_addr + sector * e2p_valid_ctx->config.erase_size;
+}
+
+E2P_ATTR
+static uint32_t e2p_log_sector_of(uint32_t addr)
+{
+    return (addr - e2p_valid_ctx->config.start_addr) / e2p_valid_ctx->config.erase_size;
+}
+
+E2P_ATTR
+static hpm_stat_t e2p_log_program(uint32_t addr, void *buf, uint32_t size)
+{
+    uint32_t ret;
+
+    E2P_CRITICAL_ENTER();
+    ret = e2p_valid_ctx->config.flash_write((uint8_t *)buf, addr, size);
+    E2P_CRITICAL_EXIT();
+
+    return (ret == E2P_STATUS_OK) ? E2P_STATUS_OK : E2P_ERROR;
+}
+
+E2P_ATTR
+static hpm_stat_t e2p_log_format_sector(uint32_t sector, uint32_t erase_cnt)
+{
+    e2p_config_t *cfg = &e2p_valid_ctx->config;
+    e2p_sector_header header;
+
+    E2P_CRITICAL_ENTER();
+    cfg->flash_erase(e2p_log_sector_addr(sector), cfg->erase_size);
+    E2P_CRITICAL_EXIT();
+
+    header.magic = E2P_LOG_MAGIC_ID;
+    header.version = cfg->version;
+    header.erase_cnt = erase_cnt;
+    header.seq = E2P_LOG_SEQ_FREE;
+    header.seq_check = E2P_LOG_SEQ_FREE;
+
+    e2p_sectors[sector].erase_cnt = erase_cnt;
+    e2p_sectors[sector].seq = E2P_LOG_SEQ_FREE;
+    e2p_sectors[sector].used = sizeof(e2p_sector_header);
+    e2p_sectors[sector].live = 0;
+    e2p_log_free_cnt++;
+
+    /* the magic goes last, so a torn header never hands out a wrong erase count */
+    if (e2p_log_program(e2p_log_sector_addr(sector) + E2P_OFFSET(e2p_sector_header, version), &header.version,
+            sizeof(e2p_sector_header) - E2P_OFFSET(e2p_sector_header, version)) != E2P_STATUS_OK)
+        return E2P_ERROR;
+    return e2p_log_program(e2p_log_sector_addr(sector), &header.magic, sizeof(header.magic));
+}
+
+/* open the free sector with the lowest erase count for writing, leaving `reserve` free sectors */
+E2P_ATTR
+static hpm_stat_t e2p_log_open_sector(uint32_t reserve)
+{
+    uint32_t sel = E2P_LOG_NONE;
+    uint32_t seq[2] = {e2p_log_next_seq, ~e2p_log_next_seq};
+
+    if (e2p_log_free_cnt <= reserve)
+        return E2P_ERROR_NO_MEM;
+
+    for (uint32_t i = 0; i < e2p_valid_ctx->config.sector_cnt; i++) {
+        if (e2p_sectors[i].seq != E2P_LOG_SEQ_FREE)
+            continue;
+        if (sel == E2P_LOG_NONE || e2p_sectors[i].erase_cnt < e2p_sectors[sel].erase_cnt)
+            sel = i;
+    }
+
+    if (e2p_log_program(e2p_log_sector_addr(sel) + E2P_OFFSET(e2p_sector_header, seq), seq, sizeof(seq)) != E2P_STATUS_OK)
+        return E2P_ERROR;
+
+    e2p_sectors[sel].seq = seq[0];
+    e2p_log_next_seq++;
+    e2p_log_free_cnt--;
+    e2p_log_active = sel;
+    e2p_trace("open sector %u, seq=%u, erase count=%u\n", sel, seq[0], e2p_sectors[sel].erase_cnt);
+    return E2P_STATUS_OK;
+}
+
+E2P_ATTR
+static uint32_t e2p_log_record_check(e2p_record *record)
+{
+    uint32_t buf[3] = {record->block_id, record->length, record->crc};
+
+    return e2p_data_crc_calc(sizeof(buf), (uint8_t *)buf);
+}
+
+/* update the index and move the live size from the sector of the old record to the new one */
+E2P_ATTR
+static hpm_stat_t e2p_log_table_update(e2p_block *block)
+{
+    e2p_block old;
+    uint8_t replaced;
+    hpm_stat_t ret;
+
+    replaced = (e2p_retrieve_info(block->block_id, &old) == E2P_STATUS_OK);
+    ret = e2p_table_update(block);
+    if (E2P_STATUS_OK != ret)
+        return ret;
+
+    if (replaced)
+        e2p_sectors[e2p_log_sector_of(old.data_addr)].live -= E2P_LOG_REC_SIZE(old.length);
+    e2p_sectors[e2p_log_sector_of(block->data_addr)].live += E2P_LOG_REC_SIZE(block->length);
+    return E2P_STATUS_OK;
+}
+
+E2P_ATTR
+static hpm_stat_t e2p_log_append(uint32_t block_id, uint16_t length, uint8_t *data, uint32_t crc, uint32_t reserve)
+{
+    e2p_config_t *cfg = &e2p_valid_ctx->config;
+    uint32_t size = E2P_LOG_REC_SIZE(length);
+    uint16_t state = e2p_valid;
+    e2p_record record;
+    e2p_block block;
+    uint32_t addr;
+    hpm_stat_t ret;
+
+    if (e2p_log_active == E2P_LOG_NONE || e2p_sectors[e2p_log_active].used + size > cfg->erase_size) {
+        ret = e2p_log_open_sector(reserve);
+        if (E2P_STATUS_OK != ret)
+            return ret;
+    }
+
+    addr = e2p_log_sector_addr(e2p_log_active) + e2p_sectors[e2p_log_active].used;
+    e2p_sectors[e2p_log_active].used += size;
+
+    record.block_id = block_id;
+    record.length = length;
+    record.valid_state = e2p_earsed;
+    record.crc = crc;
+    record.check = e2p_log_record_check(&record);
+    if (e2p_log_program(addr, &record, sizeof(e2p_record)) != E2P_STATUS_OK ||
+        e2p_log_program(addr + sizeof(e2p_record), data, length) != E2P_STATUS_OK ||
+        e2p_log_program(addr + E2P_OFFSET(e2p_record, valid_state), &state, sizeof(state)) != E2P_STATUS_OK) {
+        /* nothing may follow a torn record, continue in a new sector */
+        e2p_trace("flash write record error, addr=0x%08x\n", addr);
+        e2p_log_active = E2P_LOG_NONE;
+        return E2P_ERROR;
+    }
+
+    block.block_id = block_id;
+    block.data_addr = addr + sizeof(e2p_record);
+    block.length = length;
+    block.valid_state = e2p_valid;
+    block.crc = crc;
+    return e2p_log_table_update(&block);
+}
+
+E2P_ATTR
+static uint32_t e2p_log_pick_victim(uint8_t mode)
+{
+    uint32_t victim = E2P_LOG_NONE;
+    uint32_t cold = E2P_LOG_NONE;
+    uint32_t max_erase = 0;
+    uint32_t max_stale = 0;
+    uint32_t room = 0;
+    uint32_t stale;
+
+    /* without a free sector, the live records of the victim must fit in the write sector */
+    if (e2p_log_free_cnt == 0 && e2p_log_active != E2P_LOG_NONE)
+        room = e2p_valid_ctx->config.erase_size - e2p_sectors[e2p_log_active].used;
+
+    for (uint32_t i = 0; i < e2p_valid_ctx->config.sector_cnt; i++) {
+        if (e2p_sectors[i].erase_cnt > max_erase)
+            max_erase = e2p_sectors[i].erase_cnt;
+        if (i == e2p_log_active || e2p_sectors[i].seq == E2P_LOG_SEQ_FREE)
+            continue;
+        if (e2p_log_free_cnt == 0 && e2p_sectors[i].live > room)
+            continue;
+        /* a sector left without any live record only costs an erase */
+        if (e2p_sectors[i].live == 0)
+            stale = e2p_valid_ctx->config.erase_size;
+        else
+            stale = e2p_sectors[i].used - sizeof(e2p_sector_header) - e2p_sectors[i].live;
+        if (stale > max_stale) {
+            max_stale = stale;
+            victim = i;
+        }
+        if (cold == E2P_LOG_NONE || e2p_sectors[i].erase_cnt < e2p_sectors[cold].erase_cnt)
+            cold = i;
+    }
+
+    /* a cold sector goes first, a collection that never ends below the threshold would starve it */
+    if (cold != E2P_LOG_NONE && max_erase - e2p_sectors[cold].erase_cnt > E2P_LOG_WEAR_LEVEL_DELTA)
+        return cold;
+    if (mode == e2p_gc_force || e2p_log_free_cnt < E2P_LOG_GC_FREE_SECTORS)
+        return victim;
+    return E2P_LOG_NONE;
+}
+
+/* one unit of garbage collection: a single record copy or a single sector erase */
+E2P_ATTR
+static uint8_t e2p_log_gc_step(uint8_t mode)
+{
+    e2p_config_t *cfg = &e2p_valid_ctx->config;
+    uint32_t seq = E2P_LOG_SEQ_RETIRED;
+    e2p_record record;
+    e2p_block block;
+    uint32_t base;
+
+    if (e2p_log_victim == E2P_LOG_NONE) {
+        e2p_log_victim = e2p_log_pick_victim(mode);
+        if (e2p_log_victim == E2P_LOG_NONE)
+            return 0;
+        e2p_log_cursor = sizeof(e2p_sector_header);
+        e2p_trace("gc sector %u, used=%u, live=%u\n", e2p_log_victim, e2p_sectors[e2p_log_victim].used,
+                e2p_sectors[e2p_log_victim].live);
+    }
+
+    base = e2p_log_sector_addr(e2p_log_victim);
+    if (e2p_sectors[e2p_log_victim].live != 0 && e2p_log_cursor < e2p_sectors[e2p_log_victim].used) {
+        cfg->flash_read((uint8_t *)&record, base + e2p_log_cursor, sizeof(e2p_record));
+        if (record.check != e2p_log_record_check(&record)) {
+            e2p_log_cursor += sizeof(e2p_record);
+            return 1;
+        }
+        /* only the record the index points at is live, the crc is kept so corruption stays visible */
+        if (record.valid_state == e2p_valid && e2p_retrieve_info(record.block_id, &block) == E2P_STATUS_OK &&
+            block.data_addr == base + e2p_log_cursor + sizeof(e2p_record)) {
+            uint8_t buf[record.length];
+            cfg->flash_read(buf, block.data_addr, record.length);
+            if (e2p_log_append(record.block_id, record.length, buf, record.crc, 0) != E2P_STATUS_OK)
+                return 0;
+        }
+        e2p_log_cursor += E2P_LOG_REC_SIZE(record.length);
+        return 1;
+    }
+
+    /* retire the victim first, an interrupted erase is then redone on boot */
+    e2p_log_program(base + E2P_OFFSET(e2p_sector_header, seq), &seq, sizeof(seq));
+    e2p_log_format_sector(e2p_log_victim, e2p_sectors[e2p_log_victim].erase_cnt + 1);
+    e2p_log_victim = E2P_LOG_NONE;
+    return 1;
+}
+
+E2P_ATTR
+static hpm_stat_t e2p_log_replay(uint32_t sector)
+{
+    e2p_config_t *cfg = &e2p_valid_ctx->config;
+    uint32_t base = e2p_log_sector_addr(sector);
+    uint32_t offset = sizeof(e2p_sector_header);
+    e2p_record record;
+    e2p_block block;
+    hpm_stat_t ret;
+
+    while (offset + sizeof(e2p_record) <= cfg->erase_size) {
+        cfg->flash_read((uint8_t *)&record, base + offset, sizeof(e2p_record));
+        if (record.block_id == E2P_EARSED_ID && record.length == e2p_earsed && record.valid_state == e2p_earsed &&
+            record.crc == E2P_EARSED_ID && record.check == E2P_EARSED_ID)
             break;
+        /* header torn, nothing was written behind it */
+        if (record.check != e2p_log_record_check(&record) ||
+            E2P_LOG_REC_SIZE(record.length) > cfg->erase_size - offset) {
+            e2p_trace("torn record header in sector %u, offset=0x%x\n", sector, offset);
+            offset += sizeof(e2p_record);
+            continue;
+        }
+        /* data or commit torn */
+        if (record.valid_state != e2p_valid) {
+            e2p_trace("uncommitted record in sector %u, offset=0x%x\n", sector, offset);
+            offset += E2P_LOG_REC_SIZE(record.length);
+            continue;
         }
+
+        block.block_id = record.block_id;
+        block.data_addr = base + offset + sizeof(e2p_record);
+        block.length = record.length;
+        block.valid_state = e2p_valid;
+        block.crc = record.crc;
+        ret = e2p_log_table_update(&block);
+        if (E2P_STATUS_OK != ret)
+            return ret;
+        offset += E2P_LOG_REC_SIZE(record.length);
     }
 
+    e2p_sectors[sector].used = offset;
+    e2p_log_active = sector;
+    return E2P_STATUS_OK;
+}
+
+E2P_ATTR
+static void e2p_log_print_info(e2p_t *e2p)
+{
     e2p_info("------------ flash->eeprom init ok -----------");
     e2p_info("start address: 0x%08x", e2p->config.start_addr);
     e2p_info("sector count: %u", e2p->config.sector_cnt);
     e2p_info("flash earse granularity: %u", e2p->config.erase_size);
     e2p_info("version: 0x%x", e2p->config.version);
-    e2p_info("end address: 0x%08x", e2p->config.start_addr + e2p->config.sector_cnt * e2p->config.erase_size);
-    e2p_info("data write addr = 0x%08x, info write addr = 0x%08x, remain flash size = 0x%x", \
-            e2p->p_data, e2p->p_info, e2p->remain_size);
-    e2p_info("valid count percent info count( %u / %u )", valid_count, info_count);
+    e2p_info("log mode, free sectors: %u, write sector: %d, valid count: %u", \
+            e2p_log_free_cnt, (int)e2p_log_active, e2p_info_count);
+    for (uint32_t i = 0; i < e2p->config.sector_cnt; i++) {
+        e2p_info("sector %u: erase count = %u, seq = 0x%08x, used = 0x%x, live = 0x%x", \
+                i, e2p_sectors[i].erase_cnt, e2p_sectors[i].seq, e2p_sectors[i].used, e2p_sectors[i].live);
+    }
     e2p_info("----------------------------------------------\n");
 }
 
 E2P_ATTR
-static hpm_stat_t e2p_table_update(e2p_block *block)
+hpm_stat_t e2p_config(e2p_t *e2p)
 {
-    uint32_t i = 0;
+    hpm_stat_t ret = e2p_check_config(e2p);
 
-    if (block->valid_state == e2p_invalid)
-        return E2P_STATUS_OK;
+    if (E2P_STATUS_OK != ret)
+        return ret;
+
+    if (e2p->config.sector_cnt < 3 || e2p->config.sector_cnt > E2P_LOG_MAX_SECTOR_CNT) {
+        e2p_err("Sector count must be from 3 to %u in log mode, %u sector now", \
+                    E2P_LOG_MAX_SECTOR_CNT, e2p->config.sector_cnt);
+        return E2P_ERROR_INIT_ERR;
+    }
 
-    for ( ; i < E2P_MAX_VAR_CNT; i++) {
-        if (e2p_info_table[i].block_id == E2P_EARSED_ID)
+    e2p_config_t *cfg = &e2p->config;
+    e2p_sector_header header;
+    uint32_t max_erase = 0;
+    uint32_t last_seq = E2P_LOG_SEQ_RETIRED;
+
+    e2p_raw = e2p;
+    e2p_valid_ctx = e2p;
+    e2p_index_reset();
+    e2p_log_active = E2P_LOG_NONE;
+    e2p_log_victim = E2P_LOG_NONE;
+    e2p_log_free_cnt = 0;
+    e2p_log_next_seq = E2P_LOG_SEQ_RETIRED + 1;
+
+    for (uint32_t i = 0; i < cfg->sector_cnt; i++) {
+        cfg->flash_read((uint8_t *)&header, e2p_log_sector_addr(i), sizeof(e2p_sector_header));
+        if (header.magic != E2P_LOG_MAGIC_ID || header.version != cfg->version) {
+            /* never formatted, other version or erase interrupted, the erase count is lost */
+            e2p_sectors[i].erase_cnt = E2P_LOG_NONE;
+            e2p_sectors[i].seq = E2P_LOG_SEQ_RETIRED;
+            continue;
+        }
+        e2p_sectors[i].erase_cnt = header.erase_cnt;
+        e2p_sectors[i].seq = header.seq;
+        /* retired, or opening interrupted before anything was written to it */
+        if ((header.seq != E2P_LOG_SEQ_FREE || header.seq_check != E2P_LOG_SEQ_FREE) && header.seq_check != ~header.seq)
+            e2p_sectors[i].seq = E2P_LOG_SEQ_RETIRED;
+        e2p_sectors[i].used = sizeof(e2p_sector_header);
+        e2p_sectors[i].live = 0;
+        if (header.erase_cnt > max_erase)
+            max_erase = header.erase_cnt;
+        if (e2p_sectors[i].seq != E2P_LOG_SEQ_FREE && e2p_sectors[i].seq != E2P_LOG_SEQ_RETIRED &&
+            e2p_sectors[i].seq >= e2p_log_next_seq)
+            e2p_log_next_seq = e2p_sectors[i].seq + 1;
+    }
+
+    for (uint32_t i = 0; i < cfg->sector_cnt; i++) {
+        if (e2p_sectors[i].seq == E2P_LOG_SEQ_FREE) {
+            e2p_log_free_cnt++;
+        } else if (e2p_sectors[i].seq == E2P_LOG_SEQ_RETIRED) {
+            e2p_log_format_sector(i, (e2p_sectors[i].erase_cnt == E2P_LOG_NONE) ? max_erase : e2p_sectors[i].erase_cnt + 1);
+        }
+    }
+
+    /* replay the written sectors from the oldest to the newest */
+    while (1) {
+        uint32_t next = E2P_LOG_NONE;
+
+        for (uint32_t i = 0; i < cfg->sector_cnt; i++) {
+            if (e2p_sectors[i].seq == E2P_LOG_SEQ_FREE || e2p_sectors[i].seq <= last_seq)
+                continue;
+            if (next == E2P_LOG_NONE || e2p_sectors[i].seq < e2p_sectors[next].seq)
+                next = i;
+        }
+        if (next == E2P_LOG_NONE)
             break;
-        if (e2p_info_table[i].block_id == block->block_id) {
-            e2p_trace("block_id[0x%08x] multiple write, flush api solve repeat\n", block->block_id);
+
+        ret = e2p_log_replay(next);
+        if (E2P_STATUS_OK != ret)
+            return ret;
+        last_seq = e2p_sectors[next].seq;
+    }
+
+    /* a collection was cut off after taking the last free sector, finish it before any write */
+    while (e2p_log_free_cnt == 0 && e2p_log_gc_step(e2p_gc_force)) {
+    }
+
+    e2p_log_print_info(e2p);
+    return E2P_STATUS_OK;
+}
+
+E2P_ATTR
+hpm_stat_t e2p_flush(uint8_t flag)
+{
+    uint8_t mode = (flag == E2P_FLUSH_TRY) ? e2p_gc_idle : e2p_gc_force;
+
+    while (e2p_log_gc_step(mode)) {
+    }
+
+    return E2P_STATUS_OK;
+}
+
+E2P_ATTR
+hpm_stat_t e2p_write(uint32_t block_id, uint16_t length, uint8_t *data)
+{
+    e2p_config_t *cfg = &e2p_valid_ctx->config;
+    uint32_t size = E2P_LOG_REC_SIZE(length);
+    uint8_t pending = 0;
+    uint32_t need;
+
+    if (block_id == E2P_EARSED_ID)
+        return E2P_ERROR_BAD_ID;
+
+    if (size > cfg->erase_size - sizeof(e2p_sector_header)) {
+        e2p_trace("block larger than a sector\n");
+        return E2P_ERROR_NO_MEM;
+    }
+
+    /*
+     * Opening a new write sector must leave one free sector to the garbage collector. When the
+     * background collection fell behind, run at most E2P_LOG_WRITE_GC_STEPS steps here, so a write
+     * never costs more than that many record copies or sector erases on top of its own record.
+     */
+    for (uint32_t i = 0; i < E2P_LOG_WRITE_GC_STEPS && e2p_log_free_cnt < E2P_LOG_GC_FREE_SECTORS; i++) {
+        pending = e2p_log_gc_step(e2p_gc_force);
+        if (!pending)
             break;
-        }
     }
 
-    if (i == E2P_MAX_VAR_CNT)
-        return E2P_ERROR_MUL_VAR;
+    /* once the collection took the last free sector, the rest of the victim must still fit behind the write */
+    need = size;
+    if (e2p_log_free_cnt == 0 && e2p_log_victim != E2P_LOG_NONE)
+        need += e2p_sectors[e2p_log_victim].live;
+    if ((e2p_log_active == E2P_LOG_NONE || e2p_sectors[e2p_log_active].used + need > cfg->erase_size) &&
+        e2p_log_free_cnt <= 1)
+        return pending ? E2P_ERROR_BUSY : E2P_ERROR_NO_MEM;
 
-    memcpy(&e2p_info_table[i], block, sizeof(e2p_block));
+    return e2p_log_append(block_id, length, data, e2p_data_crc_calc(length, data), 1);
+}
+
+E2P_ATTR
+uint8_t e2p_gc_step(void)
+{
+    return e2p_log_gc_step(e2p_gc_idle);
+}
+
+E2P_ATTR
+hpm_stat_t e2p_get_sector_info(uint32_t sector, e2p_sector_info_t *info)
+{
+    if (sector >= e2p_valid_ctx->config.sector_cnt || info == NULL)
+        return E2P_ERROR;
+
+    info->erase_cnt = e2p_sectors[sector].erase_cnt;
+    info->used_size = e2p_sectors[sector].used;
+    info->live_size = e2p_sectors[sector].live;
+    info->free = (e2p_sectors[sector].seq == E2P_LOG_SEQ_FREE);
     return E2P_STATUS_OK;
 }
 
+E2P_ATTR
+void e2p_clear(void)
+{
+    e2p_config_t *cfg = &e2p_raw->config;
+
+    E2P_CRITICAL_ENTER();
+    cfg->flash_erase(cfg->start_addr, cfg->sector_cnt * cfg->erase_size);
+    E2P_CRITICAL_EXIT();
+}
+
+E2P_ATTR
+void e2p_show_info(void)
+{
+    e2p_log_print_info(e2p_valid_ctx);
+}
+
+#else
+
+/* boot refuses an area with less room left, writes keep it free */
+#define E2P_INFO_RESERVE (2 * sizeof(e2p_block))
+
+static e2p_t e2p_dummy;
+
+/*
+ * Transaction layout, from the info write address downward: a marker block, then one info
+ * block per staged write in write order. The staged data is one run at the data write address.
+ *
+ * The marker holds the end of the data run in data_addr, the write count in length and the crc
+ * of the info blocks. It is programmed before anything else, block_id last, so boot can always
+ * step over the area of an unfinished transaction. Programming its valid_state commits.
+ */
+ATTR_ALIGN(4) static e2p_block e2p_txn_blocks[E2P_TXN_MAX_VAR_CNT];     /* filled from the end, flash address order */
+ATTR_ALIGN(4) static uint8_t e2p_txn_buf[E2P_TXN_BUF_SIZE];
+static uint32_t e2p_txn_cnt;
+static uint32_t e2p_txn_len;
+static uint8_t e2p_txn_open;
+
+E2P_ATTR
+static void e2p_print_info(e2p_t *e2p)
+{
+    uint32_t info_count;
+    uint32_t valid_count = e2p_info_count;
+
+    info_count = (e2p->config.start_addr + e2p->config.sector_cnt * e2p->config.erase_size - e2p->p_info - sizeof(e2p_header)) / sizeof(e2p_block) - 1;
+
+    e2p_info("------------ flash->eeprom init ok -----------");
+    e2p_info("start address: 0x%08x", e2p->config.start_addr);
+    e2p_info("sector count: %u", e2p->config.sector_cnt);
+    e2p_info("flash earse granularity: %u", e2p->config.erase_size);
+    e2p_info("version: 0x%x", e2p->config.version);
+    e2p_info("end address: 0x%08x", e2p->config.start_addr + e2p->config.sector_cnt * e2p->config.erase_size);
+    e2p_info("data write addr = 0x%08x, info write addr = 0x%08x, remain flash size = 0x%x", \
+            e2p->p_data, e2p->p_info, e2p->remain_size);
+    e2p_info("valid count percent info count( %u / %u )", valid_count, info_count);
+    e2p_info("----------------------------------------------\n");
+}
+
 E2P_ATTR
 static void e2p_format(e2p_t *e2p)
 {
@@ -99,31 +696,6 @@ static void e2p_config_info(e2p_t *e2p)
     E2P_CRITICAL_EXIT();
 }
 
-E2P_ATTR
-static uint32_t e2p_data_crc_calc(uint16_t length, uint8_t *data)
-{
-    return crc32(data, (uint32_t)length);
-}
-
-E2P_ATTR
-static hpm_stat_t e2p_retrieve_info(uint32_t block_id, e2p_block *block)
-{
-    int i = 0;
-
-    if (block_id == E2P_EARSED_ID)
-        return E2P_ERROR_BAD_ID;
-
-    for ( ; i < E2P_MAX_VAR_CNT; i++) {
-        if (e2p_info_table[i].block_id == block_id) {
-            e2p_trace("find read block, pos at table[%u]\n", i);
-            memcpy(block, &e2p_info_table[i], sizeof(e2p_block));
-            break;
-        }
-    }
-
-    return (i == E2P_MAX_VAR_CNT ? E2P_ERROR_BAD_ID : E2P_STATUS_OK);
-}
-
 E2P_ATTR
 static hpm_stat_t e2p_write_private(e2p_t *e2p, uint32_t block_id, uint16_t length, uint8_t *data)
 {
@@ -171,37 +743,83 @@ static hpm_stat_t e2p_write_private(e2p_t *e2p, uint32_t block_id, uint16_t leng
     return E2P_STATUS_OK;
 }
 
+/* program a run split at E2P_PROGRAM_PAGE_SIZE boundaries, bounding each interrupt masked window */
 E2P_ATTR
-static int e2p_info_table_sort(void)
+static hpm_stat_t e2p_program_pages(e2p_config_t *cfg, uint32_t addr, uint8_t *buf, uint32_t size)
 {
-    int count = 0;
+    uint32_t ret;
+    uint32_t chunk;
+
+    while (size > 0) {
+        chunk = E2P_PROGRAM_PAGE_SIZE - (addr % E2P_PROGRAM_PAGE_SIZE);
+        if (chunk > size)
+            chunk = size;
+
+        E2P_CRITICAL_ENTER();
+        ret = cfg->flash_write(buf, addr, chunk);
+        E2P_CRITICAL_EXIT();
+        if (E2P_STATUS_OK != ret)
+            return E2P_ERROR;
+
+        addr += chunk;
+        buf += chunk;
+        size -= chunk;
+    }
+
+    return E2P_STATUS_OK;
+}
+
+E2P_ATTR
+static uint8_t e2p_info_erased(e2p_block *block)
+{
+    uint8_t *p = (uint8_t *)block;
+
+    for (uint32_t i = 0; i < sizeof(e2p_block); i++) {
+        if (p[i] != E2P_EARSED_VAR)
+            return 0;
+    }
+
+    return 1;
+}
+
+/* load a transaction found at the info read address on boot, or step over it when not committed */
+E2P_ATTR
+static hpm_stat_t e2p_txn_replay(e2p_t *e2p, e2p_block *marker)
+{
+    e2p_config_t *cfg = &e2p->config;
+    uint32_t info_size = (marker->length + 1) * sizeof(e2p_block);
+    uint32_t data_size = marker->data_addr - e2p->p_data;
+    uint8_t commit = (marker->valid_state == e2p_valid);
+    crc32_context_t ctx;
     e2p_block block;
+    hpm_stat_t ret;
 
-    do {
-        if (e2p_info_table[count].block_id == E2P_EARSED_ID) {
-            break;
-        }
-        count++;
-    } while (count < E2P_MAX_VAR_CNT);
-
-    if (count == 0)
-        return count;
-
-    for (int i = 0; i < count; i++) {
-        memcpy(&block, &e2p_info_table[i], sizeof(e2p_block));
-        for (int j = i + 1; j < count; j++) {
-            if (e2p_info_table[j].data_addr < block.data_addr) {
-                E2P_SWAP(e2p_info_table[j].block_id, block.block_id);
-                E2P_SWAP(e2p_info_table[j].data_addr, block.data_addr);
-                E2P_SWAP(e2p_info_table[j].length, block.length);
-                E2P_SWAP(e2p_info_table[j].valid_state, block.valid_state);
-                E2P_SWAP(e2p_info_table[j].crc, block.crc);
-            }
+    if (marker->data_addr < e2p->p_data || e2p->remain_size < data_size + info_size) {
+        e2p_err("bad transaction marker, addr=0x%08x", e2p->p_info);
+        return E2P_ERROR_INIT_ERR;
+    }
+
+    if (commit) {
+        crc32_init(&ctx);
+        for (uint32_t i = marker->length; i > 0; i--) {
+            cfg->flash_read((uint8_t *)&block, e2p->p_info - i * sizeof(e2p_block), sizeof(e2p_block));
+            crc32_update(&ctx, (uint8_t *)&block, sizeof(e2p_block));
         }
-        memcpy(&e2p_info_table[i], &block, sizeof(e2p_block));
+        commit = (crc32_final(&ctx) == marker->crc);
+    }
+
+    for (uint32_t i = 1; commit && i <= marker->length; i++) {
+        cfg->flash_read((uint8_t *)&block, e2p->p_info - i * sizeof(e2p_block), sizeof(e2p_block));
+        ret = e2p_table_update(&block);
+        if (E2P_STATUS_OK != ret)
+            return ret;
     }
 
-    return count;
+    e2p_trace("transaction of %u writes %s\n", marker->length, commit ? "loaded" : "dropped");
+    e2p->p_data = marker->data_addr;
+    e2p->p_info -= info_size;
+    e2p->remain_size -= data_size + info_size;
+    return E2P_STATUS_OK;
 }
 
 E2P_ATTR
@@ -220,7 +838,7 @@ static void e2p_dummy_config(e2p_t *e2p)
     }
 
     addr_bisect = cfg->start_addr + cnt_bisect * cfg->erase_size;
-    memset(e2p_info_table, E2P_EARSED_VAR, sizeof(e2p_info_table));
+    e2p_index_reset();
     e2p->p_data = cfg->start_addr;
     e2p->p_info = addr_bisect - sizeof(e2p_block) - sizeof(e2p_header);
     e2p->remain_size = e2p->p_info - e2p->p_data;
@@ -313,16 +931,10 @@ static e2p_t *e2p_get_valid_context(e2p_t *e2p, uint8_t *flush)
 E2P_ATTR
 hpm_stat_t e2p_config(e2p_t *e2p)
 {
-    if (e2p->config.erase_size == 0 || e2p->config.sector_cnt == 0) {
-        e2p_err("config error erase_size = %u, sector_cnt = %u\n", e2p->config.erase_size, e2p->config.sector_cnt);
-        return E2P_ERROR_INIT_ERR;
-    }
+    hpm_stat_t ret = e2p_check_config(e2p);
 
-    if (e2p->config.flash_read == NULL || e2p->config.flash_write == NULL || e2p->config.flash_erase == NULL) {
-        e2p_err("Not register operate function read = %p, write = %p, erase = %p", \
-                      e2p->config.flash_read, e2p->config.flash_write, e2p->config.flash_erase);
-        return E2P_ERROR_INIT_ERR;
-    }
+    if (E2P_STATUS_OK != ret)
+        return ret;
 
     if ((e2p->config.sector_cnt % 2) == 1) {
         e2p_err("Sector count must be even, %u sector now, maybe %u sector?", \
@@ -347,18 +959,27 @@ hpm_stat_t e2p_config(e2p_t *e2p)
         block.data_addr = e2p_valid_ctx->p_info;
         block.length = sizeof(e2p_block);
         cfg->flash_read((uint8_t *)&block, block.data_addr, block.length);
-        if (block.block_id == E2P_EARSED_ID)
-            break;
-
-        int ret = e2p_table_update(&block);
-        if (E2P_STATUS_OK != ret)
-            return ret;
+        if (block.block_id == E2P_EARSED_ID) {
+            if (e2p_info_erased(&block))
+                break;
+            /* transaction marker torn before its block_id, nothing else was written */
+            e2p_valid_ctx->p_info -= sizeof(e2p_block);
+            e2p_valid_ctx->remain_size -= sizeof(e2p_block);
+        } else if (block.block_id == E2P_TXN_ID) {
+            ret = e2p_txn_replay(e2p_valid_ctx, &block);
+            if (E2P_STATUS_OK != ret)
+                return ret;
+        } else {
+            ret = e2p_table_update(&block);
+            if (E2P_STATUS_OK != ret)
+                return ret;
 
-        e2p_valid_ctx->p_data += block.length;
-        e2p_valid_ctx->p_info -= sizeof(e2p_block);
-        e2p_valid_ctx->remain_size -= (block.length + sizeof(e2p_block));
+            e2p_valid_ctx->p_data += block.length;
+            e2p_valid_ctx->p_info -= sizeof(e2p_block);
+            e2p_valid_ctx->remain_size -= (block.length + sizeof(e2p_block));
+        }
 
-        if (e2p_valid_ctx->remain_size < 2 * sizeof(e2p_block)) {
+        if (e2p_valid_ctx->remain_size < E2P_INFO_RESERVE) {
             e2p_info("remain flash is not enough\n");
             return E2P_ERROR_NO_MEM;
         }
@@ -390,7 +1011,8 @@ hpm_stat_t e2p_flush(uint8_t flag)
     cfg->flash_write((uint8_t *)&state, addr_state, sizeof(uint32_t));
     E2P_CRITICAL_EXIT();
 
-    int valid_num = e2p_info_table_sort();
+    /* the table keeps first write order, entries are copied as they are, no sorting is needed */
+    int valid_num = e2p_info_count;
     uint8_t read_buf[cfg->erase_size];
     int count = 0;
     uint32_t read_len = 0;
@@ -406,7 +1028,7 @@ hpm_stat_t e2p_flush(uint8_t flag)
 
     for (int i = 0; i < valid_num;) {
         while (1) {
-            if (e2p_info_table[i].block_id == E2P_EARSED_ID || i >= valid_num)
+            if (i >= valid_num || e2p_info_table[i].block_id == E2P_EARSED_ID)
                 break;
             if (cfg->erase_size - read_len < e2p_info_table[i].length)
                 break;
@@ -450,9 +1072,12 @@ hpm_stat_t e2p_flush(uint8_t flag)
 E2P_ATTR
 hpm_stat_t e2p_write(uint32_t block_id, uint16_t length, uint8_t *data)
 {
-    if (e2p_valid_ctx->remain_size < length + sizeof(e2p_block)) {
+    if (block_id == E2P_TXN_ID)
+        return E2P_ERROR_BAD_ID;
+
+    if (e2p_valid_ctx->remain_size < length + sizeof(e2p_block) + E2P_INFO_RESERVE) {
         e2p_flush(E2P_FLUSH_BEGIN);
-        if (e2p_valid_ctx->remain_size < length + sizeof(e2p_block)) {
+        if (e2p_valid_ctx->remain_size < length + sizeof(e2p_block) + E2P_INFO_RESERVE) {
             e2p_trace("no enough flash write\n");
             return E2P_ERROR_NO_MEM;
         }
@@ -461,6 +1086,146 @@ hpm_stat_t e2p_write(uint32_t block_id, uint16_t length, uint8_t *data)
     return e2p_write_private(e2p_valid_ctx, block_id, length, data);
 }
 
+E2P_ATTR
+hpm_stat_t e2p_txn_begin(void)
+{
+    if (e2p_txn_open)
+        return E2P_ERROR;
+
+    e2p_txn_cnt = 0;
+    e2p_txn_len = 0;
+    e2p_txn_open = 1;
+    return E2P_STATUS_OK;
+}
+
+E2P_ATTR
+hpm_stat_t e2p_txn_write(uint32_t block_id, uint16_t length, uint8_t *data)
+{
+    e2p_block *block;
+
+    if (!e2p_txn_open)
+        return E2P_ERROR;
+
+    if (block_id == E2P_EARSED_ID || block_id == E2P_TXN_ID)
+        return E2P_ERROR_BAD_ID;
+
+    if (e2p_txn_cnt >= E2P_TXN_MAX_VAR_CNT || E2P_TXN_BUF_SIZE - e2p_txn_len < length) {
+        e2p_trace("transaction buffer full\n");
+        return E2P_ERROR_NO_MEM;
+    }
+
+    /* data_addr holds the offset in the data run until commit */
+    block = &e2p_txn_blocks[E2P_TXN_MAX_VAR_CNT - 1 - e2p_txn_cnt];
+    block->block_id = block_id;
+    block->data_addr = e2p_txn_len;
+    block->length = length;
+    block->valid_state = e2p_valid;
+    block->crc = e2p_data_crc_calc(length, data);
+    memcpy(e2p_txn_buf + e2p_txn_len, data, length);
+
+    e2p_txn_cnt++;
+    e2p_txn_len += length;
+    return E2P_STATUS_OK;
+}
+
+E2P_ATTR
+hpm_stat_t e2p_txn_commit(void)
+{
+    e2p_block *blocks = &e2p_txn_blocks[E2P_TXN_MAX_VAR_CNT - e2p_txn_cnt];
+    uint32_t info_size = (e2p_txn_cnt + 1) * sizeof(e2p_block);
+    uint32_t need = e2p_txn_len + info_size + E2P_INFO_RESERVE;
+    uint16_t state = e2p_valid;
+    e2p_block marker;
+    e2p_config_t *cfg;
+    e2p_t *e2p;
+    hpm_stat_t ret;
+
+    if (!e2p_txn_open)
+        return E2P_ERROR;
+
+    e2p_txn_open = 0;
+    if (e2p_txn_cnt == 0)
+        return E2P_STATUS_OK;
+
+    if (e2p_valid_ctx->remain_size < need) {
+        e2p_flush(E2P_FLUSH_BEGIN);
+        if (e2p_valid_ctx->remain_size < need) {
+            e2p_trace("no enough flash write\n");
+            return E2P_ERROR_NO_MEM;
+        }
+    }
+
+    e2p = e2p_valid_ctx;
+    cfg = &e2p->config;
+    for (uint32_t i = 0; i < e2p_txn_cnt; i++)
+        blocks[i].data_addr += e2p->p_data;
+
+    marker.block_id = E2P_TXN_ID;
+    marker.data_addr = e2p->p_data + e2p_txn_len;
+    marker.length = e2p_txn_cnt;
+    marker.valid_state = e2p_earsed;
+    marker.crc = crc32((uint8_t *)blocks, e2p_txn_cnt * sizeof(e2p_block));
+
+    ret = e2p_program_pages(cfg, e2p->p_info + E2P_OFFSET(e2p_block, data_addr), (uint8_t *)&marker.data_addr,
+                            sizeof(e2p_block) - E2P_OFFSET(e2p_block, data_addr));
+    if (E2P_STATUS_OK != ret) {
+        /* boot steps over a marker without block_id by one info block */
+        e2p->p_info -= sizeof(e2p_block);
+        e2p->remain_size -= sizeof(e2p_block);
+        return ret;
+    }
+
+    if (e2p_program_pages(cfg, e2p->p_info, (uint8_t *)&marker.block_id, sizeof(marker.block_id)) != E2P_STATUS_OK ||
+        e2p_program_pages(cfg, e2p->p_data, e2p_txn_buf, e2p_txn_len) != E2P_STATUS_OK ||
+        e2p_program_pages(cfg, e2p->p_info - e2p_txn_cnt * sizeof(e2p_block), (uint8_t *)blocks,
+                          e2p_txn_cnt * sizeof(e2p_block)) != E2P_STATUS_OK ||
+        e2p_program_pages(cfg, e2p->p_info + E2P_OFFSET(e2p_block, valid_state), (uint8_t *)&state,
+                          sizeof(state)) != E2P_STATUS_OK) {
+        e2p_trace("flash write transaction error\n");
+        ret = E2P_ERROR;
+    }
+
+    /* the area is used from now on, committed or not */
+    e2p->p_data += e2p_txn_len;
+    e2p->p_info -= info_size;
+    e2p->remain_size -= e2p_txn_len + info_size;
+    if (E2P_STATUS_OK != ret)
+        return ret;
+
+    for (uint32_t i = e2p_txn_cnt; i > 0; i--) {
+        ret = e2p_table_update(&blocks[i - 1]);
+        if (E2P_STATUS_OK != ret)
+            return ret;
+    }
+
+    e2p_trace("transaction of %u writes committed, remain size=0x%08x\n", e2p_txn_cnt, e2p->remain_size);
+    return E2P_STATUS_OK;
+}
+
+E2P_ATTR
+void e2p_txn_abort(void)
+{
+    e2p_txn_open = 0;
+}
+
+E2P_ATTR
+void e2p_clear(void)
+{
+    e2p_config_t *cfg = &e2p_raw->config;
+
+    E2P_CRITICAL_ENTER();
+    cfg->flash_erase(cfg->start_addr, cfg->sector_cnt * cfg->erase_size * 2);
+    E2P_CRITICAL_EXIT();
+}
+
+E2P_ATTR
+void e2p_show_info(void)
+{
+    e2p_print_info(e2p_valid_ctx);
+}
+
+#endif
+
 E2P_ATTR
 hpm_stat_t e2p_read(uint32_t block_id, uint16_t length, uint8_t *data)
 {
@@ -484,24 +1249,8 @@ hpm_stat_t e2p_read(uint32_t block_id, uint16_t length, uint8_t *data)
     return E2P_STATUS_OK;
 }
 
-E2P_ATTR
-void e2p_clear(void)
-{
-    e2p_config_t *cfg = &e2p_raw->config;
-
-    E2P_CRITICAL_ENTER();
-    cfg->flash_erase(cfg->start_addr, cfg->sector_cnt * cfg->erase_size * 2);
-    E2P_CRITICAL_EXIT();
-}
-
 E2P_ATTR
 uint32_t e2p_generate_id(const char *name)
 {
     return (name[0] << 24) | (name[1] << 16) | (name[2] << 8) | (name[3]);
 }
-
-E2P_ATTR
-void e2p_show_info(void)
-{
-    e2p_print_info(e2p_valid_ctx);
-}
@@ -64,6 +64,48 @@ extern "C" {
 #define E2P_MAX_VAR_CNT     EEPROM_MAX_VAR_CNT
 #endif
 
+/**
+ * @brief log structured mode, records are appended across all sectors and garbage collected
+ *  one sector at a time instead of copying the whole area between two halves on flush
+ */
+#ifndef E2P_LOG_MODE
+#define E2P_LOG_MODE                (0)
+#endif
+
+/* log mode: maximum sector count, sets the size of the per-sector state in RAM */
+#ifndef E2P_LOG_MAX_SECTOR_CNT
+#define E2P_LOG_MAX_SECTOR_CNT      (64)
+#endif
+
+/* log mode: e2p_gc_step collects stale records while fewer sectors are free */
+#ifndef E2P_LOG_GC_FREE_SECTORS
+#define E2P_LOG_GC_FREE_SECTORS     (3)
+#endif
+
+/* log mode: e2p_gc_step moves a sector once its erase count is this far below the most erased one */
+#ifndef E2P_LOG_WEAR_LEVEL_DELTA
+#define E2P_LOG_WEAR_LEVEL_DELTA    (16)
+#endif
+
+/* log mode: garbage collection steps e2p_write runs at most when e2p_gc_step fell behind */
+#ifndef E2P_LOG_WRITE_GC_STEPS
+#define E2P_LOG_WRITE_GC_STEPS      (8)
+#endif
+
+/* transaction: RAM staging size of e2p_txn_write data and variable count, until e2p_txn_commit */
+#ifndef E2P_TXN_BUF_SIZE
+#define E2P_TXN_BUF_SIZE            (512)
+#endif
+
+#ifndef E2P_TXN_MAX_VAR_CNT
+#define E2P_TXN_MAX_VAR_CNT         (32)
+#endif
+
+/* transaction: commit programs are split at this boundary, one critical section each */
+#ifndef E2P_PROGRAM_PAGE_SIZE
+#define E2P_PROGRAM_PAGE_SIZE       (256)
+#endif
+
 enum {
     e2p_state_valid = 0,
     e2p_state_finish = 8,
@@ -86,6 +128,7 @@ enum {
     E2P_ERROR_BAD_ID,
     E2P_ERROR_BAD_ADDR,
     E2P_ERROR_MUL_VAR,
+    E2P_ERROR_BUSY,
 };
 
 typedef struct {
@@ -102,8 +145,31 @@ typedef struct {
     uint16_t valid_state;
     uint32_t crc;
 } e2p_block;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t erase_cnt;
+    uint32_t seq;
+    uint32_t seq_check;     /* ~seq, a torn sequence number is not taken as valid */
+} e2p_sector_header;
+
+typedef struct {
+    uint32_t block_id;
+    uint16_t length;
+    uint16_t valid_state;
+    uint32_t crc;
+    uint32_t check;         /* crc of block_id, length and crc, a torn record can still be skipped */
+} e2p_record;
 #pragma pack(pop)
 
+typedef struct {
+    uint32_t erase_cnt;
+    uint32_t used_size;
+    uint32_t live_size;
+    uint8_t free;
+} e2p_sector_info_t;
+
 typedef struct {
     uint32_t start_addr;
     uint32_t sector_cnt;
@@ -125,9 +191,11 @@ typedef struct {
 } e2p_t;
 
 #define E2P_MAGIC_ID (0x48504D43)       /*'H' 'P' 'M' 'C'*/
+#define E2P_LOG_MAGIC_ID (0x48504D4C)   /*'H' 'P' 'M' 'L'*/
 
 #define E2P_VALID_STATE     (0xFFFFFFF0)
 #define E2P_EARSED_ID       (0xFFFFFFFF)
+#define E2P_TXN_ID          (0xFFFFFFFE)    /* transaction marker, a single cleared bit is never torn */
 #define E2P_EARSED_VAR      (0xFF)
 
 #define E2P_FLUSH_TRY       (0)
@@ -148,6 +216,9 @@ hpm_stat_t e2p_config(e2p_t *e2p);
 
 /**
  * @brief eeprom emulation flush whole area, remove redundancy
+ *
+ * In log mode, E2P_FLUSH_TRY runs e2p_gc_step until it has nothing left to do and
+ * E2P_FLUSH_BEGIN collects every sector holding stale records except the write sector.
  * 
  * @param flag E2P_FLUSH_TRY - conditional flush, E2P_FLUSH_BEGIN - force flush
  * @return hpm_stat_t 
@@ -160,7 +231,8 @@ hpm_stat_t e2p_flush(uint8_t flag);
  * @param block_id custom id
  * @param length data length
  * @param data 
- * @return hpm_stat_t 
+ * @return hpm_stat_t E2P_ERROR_BUSY in log mode, when the write needs a new sector and
+ *  E2P_LOG_WRITE_GC_STEPS steps did not free one, run e2p_gc_step and retry
  */
 hpm_stat_t e2p_write(uint32_t block_id, uint16_t length, uint8_t *data);
 
@@ -192,6 +264,62 @@ void e2p_clear(void);
  */
 void e2p_show_info(void);
 
+#if !E2P_LOG_MODE
+/**
+ * @brief start a transaction, the following e2p_txn_write calls are staged in RAM
+ *
+ * @return hpm_stat_t E2P_ERROR if a transaction is already open
+ */
+hpm_stat_t e2p_txn_begin(void);
+
+/**
+ * @brief stage a write in the open transaction, nothing is programmed until commit
+ *
+ * @param block_id custom id
+ * @param length data length
+ * @param data
+ * @return hpm_stat_t E2P_ERROR_NO_MEM if E2P_TXN_BUF_SIZE or E2P_TXN_MAX_VAR_CNT is exceeded
+ */
+hpm_stat_t e2p_txn_write(uint32_t block_id, uint16_t length, uint8_t *data);
+
+/**
+ * @brief program all staged writes and commit them together
+ *
+ * Data and info records are each programmed as one run split at E2P_PROGRAM_PAGE_SIZE, and a
+ * single marker commits them. After a power loss either every write of the transaction or
+ * none of them is read back.
+ *
+ * @return hpm_stat_t
+ */
+hpm_stat_t e2p_txn_commit(void);
+
+/**
+ * @brief drop the staged writes of the open transaction
+ */
+void e2p_txn_abort(void);
+#endif
+
+#if E2P_LOG_MODE
+/**
+ * @brief log mode, run one step of garbage collection, call it from an idle hook or a low priority task
+ *
+ * A step copies one live record or erases one sector, so the time spent with interrupts masked
+ * is one flash program or one sector erase.
+ *
+ * @return 1 - more work pending, 0 - nothing to collect
+ */
+uint8_t e2p_gc_step(void);
+
+/**
+ * @brief log mode, get erase count and usage of a sector
+ *
+ * @param sector sector index from 0 to sector_cnt - 1
+ * @param info sector info
+ * @return hpm_stat_t
+ */
+hpm_stat_t e2p_get_sector_info(uint32_t sector, e2p_sector_info_t *info);
+#endif
+
 /* 
     e2p_t demo = {
         .config.start_addr = 0x80080000,
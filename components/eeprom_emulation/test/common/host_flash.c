@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_flash.h"
+
+/* NOR flash in RAM: a program only clears bits, an erase sets them all */
+static uint8_t host_flash[HOST_FLASH_SIZE];
+static uint32_t host_flash_cut;
+static uint32_t host_flash_seed = 1;
+static uint32_t host_flash_critical_depth;
+
+host_flash_stat_t host_flash_stat;
+jmp_buf host_flash_power_cut;
+
+uint32_t host_flash_rand(void)
+{
+    host_flash_seed = host_flash_seed * 1103515245u + 12345u;
+    return host_flash_seed >> 8;
+}
+
+static uint8_t *host_flash_at(uint32_t addr, uint32_t size)
+{
+    if (addr < HOST_FLASH_BASE || addr + size > HOST_FLASH_BASE + HOST_FLASH_SIZE) {
+        printf("flash access out of range, addr=0x%08x size=%u\n", addr, size);
+        exit(1);
+    }
+    return &host_flash[addr - HOST_FLASH_BASE];
+}
+
+static void host_flash_power_off(void)
+{
+    host_flash_cut = 0;
+    host_flash_critical_depth = 0;
+    longjmp(host_flash_power_cut, 1);
+}
+
+static uint8_t host_flash_cut_now(void)
+{
+    return (host_flash_cut != 0) && (--host_flash_cut == 0);
+}
+
+static uint32_t host_flash_read(uint8_t *buf, uint32_t addr, uint32_t size)
+{
+    memcpy(buf, host_flash_at(addr, size), size);
+    return 0;
+}
+
+static uint32_t host_flash_write(uint8_t *buf, uint32_t addr, uint32_t size)
+{
+    uint8_t *p = host_flash_at(addr, size);
+    uint32_t n = size;
+
+    if (host_flash_critical_depth == 0) {
+        printf("flash program outside of a critical section, addr=0x%08x\n", addr);
+        exit(1);
+    }
+    if (host_flash_cut_now()) {
+        n = (size != 0) ? host_flash_rand() % size : 0;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        p[i] &= buf[i];
+    }
+    if (n < size) {
+        p[n] &= buf[n] | (uint8_t)host_flash_rand();
+        host_flash_power_off();
+    }
+    host_flash_stat.programs++;
+    return 0;
+}
+
+static void host_flash_erase(uint32_t start_addr, uint32_t size)
+{
+    uint8_t *p = host_flash_at(start_addr, size);
+
+    if (host_flash_critical_depth == 0) {
+        printf("flash erase outside of a critical section, addr=0x%08x\n", start_addr);
+        exit(1);
+    }
+    if (host_flash_cut_now()) {
+        uint32_t n = host_flash_rand() % size;
+
+        memset(p, 0xFF, n);
+        for (uint32_t i = n; i < size; i += 1 + host_flash_rand() % 64) {
+            p[i] |= (uint8_t)host_flash_rand();
+        }
+        host_flash_power_off();
+    }
+    memset(p, 0xFF, size);
+    host_flash_stat.erases++;
+}
+
+void e2p_enter_critical(void)
+{
+    host_flash_critical_depth++;
+    host_flash_stat.criticals++;
+}
+
+void e2p_exit_critical(void)
+{
+    host_flash_critical_depth--;
+}
+
+void host_flash_config(e2p_t *e2p, uint16_t erase_size, uint32_t sector_cnt, uint32_t version)
+{
+    memset(e2p, 0, sizeof(*e2p));
+    e2p->config.start_addr = HOST_FLASH_BASE;
+    e2p->config.erase_size = erase_size;
+    e2p->config.sector_cnt = sector_cnt;
+    e2p->config.version = version;
+    e2p->config.flash_read = host_flash_read;
+    e2p->config.flash_write = host_flash_write;
+    e2p->config.flash_erase = host_flash_erase;
+}
+
+void host_flash_format(void)
+{
+    memset(host_flash, 0xFF, sizeof(host_flash));
+}
+
+void host_flash_cut_after(uint32_t n)
+{
+    host_flash_cut = n;
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef _HOST_FLASH_H
+#define _HOST_FLASH_H
+
+#include <setjmp.h>
+#include "eeprom_emulation.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus  */
+
+#define HOST_FLASH_BASE         (0x80000000UL)
+#define HOST_FLASH_SIZE         (256UL * 1024UL)
+
+typedef struct {
+    uint32_t programs;          /* flash_write calls */
+    uint32_t erases;            /* flash_erase calls */
+    uint32_t criticals;         /* e2p_enter_critical calls */
+} host_flash_stat_t;
+
+extern host_flash_stat_t host_flash_stat;
+
+/* longjmp target of a power cut, set it with setjmp before the operations host_flash_cut_after arms */
+extern jmp_buf host_flash_power_cut;
+
+/**
+ * @brief set up the config of e2p with the host flash callbacks, the flash is left as it is
+ */
+void host_flash_config(e2p_t *e2p, uint16_t erase_size, uint32_t sector_cnt, uint32_t version);
+
+/**
+ * @brief erase the whole host flash
+ */
+void host_flash_format(void);
+
+/**
+ * @brief cut the power at the n-th flash program or erase from now, 0 disarms
+ *
+ * The cut operation is torn: a program leaves a random prefix programmed and one more byte
+ * with a random part of its bits, an erase leaves a random prefix erased and random bits set
+ * in the rest. Then host_flash_power_cut is jumped to.
+ */
+void host_flash_cut_after(uint32_t n);
+
+/**
+ * @brief pseudo random numbers of the test and the torn operations
+ */
+uint32_t host_flash_rand(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus  */
+
+#endif
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef _HPM_NOR_FLASH_H
+#define _HPM_NOR_FLASH_H
+
+#include <stdint.h>
+#include "hpm_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus  */
+
+/* host build: no xpi rom api, the flash is host_flash.c */
+#define E2P_ATTR
+
+typedef struct {
+    uint32_t base_addr;
+    uint32_t sector_size;
+} nor_flash_config_t;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus  */
+
+#endif
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _USER_CONFIG_H
+#define _USER_CONFIG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* host build: errors only, the critical sections are e2p_enter_critical/e2p_exit_critical of host_flash.c */
+#define E2P_DEBUG_LEVEL        (3)
+
+#ifndef EEPROM_MAX_VAR_CNT
+#define EEPROM_MAX_VAR_CNT     (100)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Variable lookup of eeprom_emulation before and after the hash index, on the RAM flash of host_flash.c
+ *
+ * base_e2p_* is eeprom_emulation.c as it was before e2p_info_index, taken from git by the Makefile:
+ * e2p_read scans e2p_info_table and e2p_flush sorts it first. e2p_* is the current one. For each
+ * variable count both are given the same history, every variable written WRITES times, then
+ *  - read: ns per e2p_read, every variable read READ_REPEAT times
+ *  - flush: us per forced e2p_flush, the best of FLUSH_REPEAT
+ *  - boot: us per e2p_config on the written flash, the best of FLUSH_REPEAT
+ * and every variable must read back its last value after the flushes and the boot.
+ *
+ * Each library keeps the halved area in its instance after the first e2p_config, so every later
+ * e2p_config, a boot, runs on the same instance without host_flash_config.
+ *
+ * usage: ./index_bench/IndexBench
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "host_flash.h"
+
+#define ERASE_SIZE          (4096U)
+#define SECTOR_CNT          (HOST_FLASH_SIZE / ERASE_SIZE)
+#define WRITES              (2U)
+#define READ_REPEAT         (20U)
+#define FLUSH_REPEAT        (5U)
+
+/* the functions of the baseline object, renamed by the Makefile */
+hpm_stat_t base_e2p_config(e2p_t *e2p);
+hpm_stat_t base_e2p_flush(uint8_t flag);
+hpm_stat_t base_e2p_write(uint32_t block_id, uint16_t length, uint8_t *data);
+hpm_stat_t base_e2p_read(uint32_t block_id, uint16_t length, uint8_t *data);
+
+typedef struct {
+    const char *name;
+    e2p_t *e2p;
+    hpm_stat_t (*config)(e2p_t *e2p);
+    hpm_stat_t (*flush)(uint8_t flag);
+    hpm_stat_t (*write)(uint32_t block_id, uint16_t length, uint8_t *data);
+    hpm_stat_t (*read)(uint32_t block_id, uint16_t length, uint8_t *data);
+} e2p_api_t;
+
+typedef struct {
+    double read_ns;
+    double flush_us;
+    double boot_us;
+} bench_result_t;
+
+static e2p_t base_e2p, index_e2p;
+static const e2p_api_t base_api = {"before", &base_e2p, base_e2p_config, base_e2p_flush, base_e2p_write, base_e2p_read};
+static const e2p_api_t index_api = {"after", &index_e2p, e2p_config, e2p_flush, e2p_write, e2p_read};
+static const uint32_t var_counts[] = {50, 100, 250, 500, 1000};
+
+static int failures;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static double now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/* ids spread like e2p_generate_id ones, not in table order */
+static uint32_t var_id(uint32_t i)
+{
+    return (i + 1U) * 0x01000193U;
+}
+
+static uint32_t var_value(uint32_t i, uint32_t round)
+{
+    return i * 16U + round;
+}
+
+static void verify(const e2p_api_t *api, uint32_t cnt)
+{
+    uint32_t buf[2];
+
+    for (uint32_t i = 0; i < cnt; i++) {
+        if (api->read(var_id(i), sizeof(buf), (uint8_t *)buf) != E2P_STATUS_OK ||
+            buf[0] != var_value(i, WRITES - 1U) || buf[1] != ~buf[0]) {
+            printf("  %s: var %u does not read back\n", api->name, i);
+            failures++;
+            return;
+        }
+    }
+}
+
+static void bench(const e2p_api_t *api, uint32_t cnt, bench_result_t *result)
+{
+    uint32_t buf[2];
+    uint32_t sum = 0;
+    double t0, t;
+
+    host_flash_format();
+    if (api->e2p->config.sector_cnt == 0) {
+        host_flash_config(api->e2p, ERASE_SIZE, SECTOR_CNT, 0x4553);
+    }
+    CHECK(api->config(api->e2p) == E2P_STATUS_OK);
+    for (uint32_t round = 0; round < WRITES; round++) {
+        for (uint32_t i = 0; i < cnt; i++) {
+            buf[0] = var_value(i, round);
+            buf[1] = ~buf[0];
+            CHECK(api->write(var_id(i), sizeof(buf), (uint8_t *)buf) == E2P_STATUS_OK);
+        }
+    }
+
+    t0 = now_us();
+    for (uint32_t r = 0; r < READ_REPEAT; r++) {
+        for (uint32_t i = 0; i < cnt; i++) {
+            api->read(var_id(i), sizeof(buf), (uint8_t *)buf);
+            sum += buf[0];
+        }
+    }
+    result->read_ns = (now_us() - t0) * 1e3 / (READ_REPEAT * cnt);
+    CHECK(sum != 0);
+
+    result->flush_us = 1e9;
+    for (uint32_t r = 0; r < FLUSH_REPEAT; r++) {
+        t0 = now_us();
+        CHECK(api->flush(E2P_FLUSH_BEGIN) == E2P_STATUS_OK);
+        t = now_us() - t0;
+        result->flush_us = (t < result->flush_us) ? t : result->flush_us;
+    }
+    verify(api, cnt);
+
+    result->boot_us = 1e9;
+    for (uint32_t r = 0; r < FLUSH_REPEAT; r++) {
+        t0 = now_us();
+        CHECK(api->config(api->e2p) == E2P_STATUS_OK);
+        t = now_us() - t0;
+        result->boot_us = (t < result->boot_us) ? t : result->boot_us;
+    }
+    verify(api, cnt);
+}
+
+int main(void)
+{
+    bench_result_t before, after;
+
+    printf("E2P_MAX_VAR_CNT %u, %u writes per variable\n", E2P_MAX_VAR_CNT, WRITES);
+    printf("%6s  %-22s %-24s %-24s\n", "vars", "read ns (before/after)", "flush us (before/after)", "boot us (before/after)");
+    for (uint32_t i = 0; i < sizeof(var_counts) / sizeof(var_counts[0]); i++) {
+        bench(&base_api, var_counts[i], &before);
+        bench(&index_api, var_counts[i], &after);
+        printf("%6u  %8.1f / %-11.1f %8.1f / %-13.1f %8.1f / %-13.1f\n", var_counts[i],
+               before.read_ns, after.read_ns, before.flush_us, after.flush_us, before.boot_us, after.boot_us);
+    }
+
+    if (failures != 0) {
+        printf("FAILED\n");
+        return 1;
+    }
+    printf("PASSED.\n");
+    return 0;
+}
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Log mode of eeprom_emulation on the RAM flash of host_flash.c
+ *
+ * power cut: writes of hot and cold variables of random length, with e2p_gc_step now and
+ *  then, are cut at a random flash operation, the boot after it may be cut too. After each
+ *  boot every variable must read back its last completed write, or the write that was cut.
+ * write latency: with no e2p_gc_step at all, the flash operations of one e2p_write must stay
+ *  in the bound E2P_LOG_WRITE_GC_STEPS gives, E2P_ERROR_BUSY is retried after e2p_gc_step.
+ * wear: the erase counts of the sectors must stay within E2P_LOG_WEAR_LEVEL_DELTA of each other,
+ *  while the cold variables are never rewritten.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_flash.h"
+
+#define ERASE_SIZE          (4096U)
+#define SECTOR_CNT          (8U)
+#define VAR_CNT             (100U)
+#define HOT_VAR_CNT         (8U)
+#define MAX_LENGTH          (240U)
+/* the power cut test writes 40 short variables, the latency test all of them up to MAX_LENGTH */
+#define CUT_VAR_CNT         (40U)
+#define CUT_MAX_LENGTH      (48U)
+#define TRIALS              (5000U)
+#define WRITES_PER_TRIAL    (300U)
+#define LATENCY_WRITES      (200000U)
+
+/* a gc step is a record copy: opening a sector and three programs, or an erase and three programs */
+#define MAX_PROGRAMS_PER_WRITE  (4U * (E2P_LOG_WRITE_GC_STEPS + 1U))
+#define MAX_ERASES_PER_WRITE    (E2P_LOG_WRITE_GC_STEPS)
+
+typedef struct {
+    uint8_t written;
+    uint32_t value;
+    uint16_t length;
+} var_t;
+
+static e2p_t e2p;
+static var_t vars[VAR_CNT];
+/* the write a power cut may have stopped, VAR_CNT for none */
+static uint32_t pending_var = VAR_CNT;
+static var_t pending;
+static uint32_t next_value = 1;
+static int failures;
+
+static void fill(uint8_t *buf, uint32_t value, uint16_t length)
+{
+    for (uint16_t i = 0; i < length; i++) {
+        buf[i] = (uint8_t)((value >> (8 * (i % 4))) + i * 31);
+    }
+}
+
+static uint8_t match(const uint8_t *buf, const var_t *v)
+{
+    uint8_t expect[MAX_LENGTH];
+
+    fill(expect, v->value, v->length);
+    return memcmp(buf, expect, v->length) == 0;
+}
+
+static hpm_stat_t boot(void)
+{
+    host_flash_config(&e2p, ERASE_SIZE, SECTOR_CNT, 0x4553);
+    return e2p_config(&e2p);
+}
+
+static hpm_stat_t write_var(uint32_t id, uint16_t length)
+{
+    uint8_t buf[MAX_LENGTH];
+    hpm_stat_t ret;
+
+    pending_var = id;
+    pending.written = 1;
+    pending.value = next_value++;
+    pending.length = length;
+    fill(buf, pending.value, length);
+    while ((ret = e2p_write(id + 1, length, buf)) == E2P_ERROR_BUSY) {
+        e2p_gc_step();
+    }
+    if (ret == E2P_STATUS_OK) {
+        vars[id] = pending;
+    }
+    pending_var = VAR_CNT;
+    return ret;
+}
+
+/* every variable holds its last completed write, or the cut one, which then counts as done */
+static uint8_t verify(void)
+{
+    uint8_t buf[MAX_LENGTH];
+
+    for (uint32_t id = 0; id < VAR_CNT; id++) {
+        hpm_stat_t ret;
+
+        memset(buf, 0, sizeof(buf));
+        ret = e2p_read(id + 1, sizeof(buf), buf);
+        if (id == pending_var && ret == E2P_STATUS_OK && match(buf, &pending)) {
+            vars[id] = pending;
+            continue;
+        }
+        if (!vars[id].written && ret != E2P_STATUS_OK) {
+            continue;
+        }
+        if (!vars[id].written || ret != E2P_STATUS_OK || !match(buf, &vars[id])) {
+            printf("var %u: read %u, expected %s value %u\n", id, ret, vars[id].written ? "the" : "no", vars[id].value);
+            return 0;
+        }
+    }
+    pending_var = VAR_CNT;
+    return 1;
+}
+
+static void expect(const char *name, uint8_t ok)
+{
+    printf("%-48s %s\n", name, ok ? "ok" : "FAIL");
+    if (!ok) {
+        failures++;
+    }
+}
+
+static uint32_t random_var(uint32_t var_cnt)
+{
+    return (host_flash_rand() % 10 < 8) ? host_flash_rand() % HOT_VAR_CNT : host_flash_rand() % var_cnt;
+}
+
+static void test_power_cut(void)
+{
+    uint32_t cuts = 0, boot_cuts = 0;
+    uint8_t ok = 1;
+
+    host_flash_format();
+    memset(vars, 0, sizeof(vars));
+    if (boot() != E2P_STATUS_OK) {
+        expect("power cut: first boot", 0);
+        return;
+    }
+
+    for (uint32_t t = 0; t < TRIALS && ok; t++) {
+        if (setjmp(host_flash_power_cut) == 0) {
+            host_flash_cut_after(1 + host_flash_rand() % 600);
+            for (uint32_t k = 0; k < WRITES_PER_TRIAL; k++) {
+                if (write_var(random_var(CUT_VAR_CNT), 8 + host_flash_rand() % (CUT_MAX_LENGTH - 7)) != E2P_STATUS_OK) {
+                    printf("trial %u: write failed\n", t);
+                    ok = 0;
+                    break;
+                }
+                if (host_flash_rand() % 3 == 0) {
+                    e2p_gc_step();
+                }
+            }
+            host_flash_cut_after(0);
+        } else {
+            cuts++;
+        }
+
+        /* the boot recovers from the cut, and may be cut itself */
+        if (setjmp(host_flash_power_cut) == 0) {
+            host_flash_cut_after((host_flash_rand() % 4 == 0) ? 1 + host_flash_rand() % 8 : 0);
+            boot();
+            host_flash_cut_after(0);
+        } else {
+            boot_cuts++;
+        }
+        if (boot() != E2P_STATUS_OK) {
+            printf("trial %u: boot failed\n", t);
+            ok = 0;
+        }
+        if (ok && !verify()) {
+            printf("trial %u: lost data\n", t);
+            ok = 0;
+        }
+    }
+
+    printf("%u trials, %u cut while writing, %u cut while booting, %u programs, %u erases\n", TRIALS, cuts,
+           boot_cuts, host_flash_stat.programs, host_flash_stat.erases);
+    expect("power cut: data of every completed write kept", ok);
+}
+
+static void test_write_latency(void)
+{
+    uint32_t max_programs = 0, max_erases = 0, busy = 0;
+    uint8_t ok = 1;
+
+    host_flash_format();
+    memset(vars, 0, sizeof(vars));
+    boot();
+
+    for (uint32_t k = 0; k < LATENCY_WRITES && ok; k++) {
+        uint32_t id = (k < VAR_CNT) ? k : random_var(VAR_CNT);
+        uint8_t buf[MAX_LENGTH];
+        uint16_t length = 8 + host_flash_rand() % (MAX_LENGTH - 7);
+        hpm_stat_t ret;
+
+        fill(buf, next_value, length);
+        do {
+            host_flash_stat_t before = host_flash_stat;
+
+            ret = e2p_write(id + 1, length, buf);
+            if (host_flash_stat.programs - before.programs > max_programs) {
+                max_programs = host_flash_stat.programs - before.programs;
+            }
+            if (host_flash_stat.erases - before.erases > max_erases) {
+                max_erases = host_flash_stat.erases - before.erases;
+            }
+            /* the application runs the collection it left behind */
+            if (ret == E2P_ERROR_BUSY) {
+                busy++;
+                e2p_gc_step();
+            }
+        } while (ret == E2P_ERROR_BUSY);
+        if (ret != E2P_STATUS_OK) {
+            printf("write %u failed, %u\n", k, ret);
+            ok = 0;
+            break;
+        }
+        vars[id].written = 1;
+        vars[id].value = next_value++;
+        vars[id].length = length;
+    }
+
+    printf("%u writes without e2p_gc_step, %u busy, max %u programs (bound %u), max %u erases (bound %u)\n",
+           LATENCY_WRITES, busy, max_programs, MAX_PROGRAMS_PER_WRITE, max_erases, MAX_ERASES_PER_WRITE);
+    expect("write latency: writes completed", ok && verify());
+    expect("write latency: flash operations per write bounded",
+           max_programs <= MAX_PROGRAMS_PER_WRITE && max_erases <= MAX_ERASES_PER_WRITE);
+}
+
+static void test_wear(void)
+{
+    uint32_t min = UINT32_MAX, max = 0;
+    e2p_sector_info_t info;
+
+    /* the cold variables of the previous test stay where they are, only the hot ones change */
+    for (uint32_t k = 0; k < LATENCY_WRITES; k++) {
+        write_var(host_flash_rand() % HOT_VAR_CNT, MAX_LENGTH);
+        e2p_gc_step();
+    }
+    for (uint32_t i = 0; i < SECTOR_CNT; i++) {
+        e2p_get_sector_info(i, &info);
+        if (info.erase_cnt < min) {
+            min = info.erase_cnt;
+        }
+        if (info.erase_cnt > max) {
+            max = info.erase_cnt;
+        }
+    }
+
+    printf("erase count min %u max %u\n", min, max);
+    expect("wear: data kept", verify());
+    /* the cold sector is moved once it is more than E2P_LOG_WEAR_LEVEL_DELTA behind */
+    expect("wear: erase counts within E2P_LOG_WEAR_LEVEL_DELTA + 1", max - min <= E2P_LOG_WEAR_LEVEL_DELTA + 1);
+}
+
+int main(void)
+{
+    test_power_cut();
+    test_write_latency();
+    test_wear();
+
+    printf(failures ? "FAILED\n" : "PASSED.\n");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Transactions of eeprom_emulation on the RAM flash of host_flash.c
+ *
+ * cost: a parameter set of VAR_CNT variables written with e2p_write, then in one transaction,
+ *  the flash programs and critical sections of both are counted.
+ * power off before commit: the staged writes are lost with the RAM, nothing of them is read back.
+ * power cut in commit: the commit is cut at its 1st, 2nd, ... flash operation, then at random
+ *  ones, with single writes in between and the flush a full area needs. After each boot either
+ *  every write of the transaction or none of them is read back, the other variables are unchanged.
+ *
+ * A boot is e2p_config again on the same instance, as the library keeps the halved area in it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_flash.h"
+
+#define ERASE_SIZE          (4096U)
+#define SECTOR_CNT          (8U)
+#define VAR_CNT             (E2P_TXN_MAX_VAR_CNT)
+#define TRIALS              (5000U)
+
+/* the marker in two parts, the data and info runs split at each page, and the commit */
+#define PAGES(size)             (((size) + E2P_PROGRAM_PAGE_SIZE - 1U) / E2P_PROGRAM_PAGE_SIZE + 1U)
+#define MAX_TXN_PROGRAMS(cnt)   (2U + PAGES((cnt) * 8U) + PAGES((cnt) * sizeof(e2p_block)) + 1U)
+
+static e2p_t e2p;
+static uint32_t committed[VAR_CNT];
+static uint32_t staged[VAR_CNT];
+static uint8_t in_txn[VAR_CNT];
+static uint32_t next_value = 1;
+static int failures;
+
+static void expect(const char *name, uint8_t ok)
+{
+    printf("%-48s %s\n", name, ok ? "ok" : "FAIL");
+    if (!ok) {
+        failures++;
+    }
+}
+
+static hpm_stat_t write_var(uint32_t id, uint32_t value)
+{
+    uint32_t buf[2] = {value, ~value};
+
+    return e2p_write(id + 1, sizeof(buf), (uint8_t *)buf);
+}
+
+static hpm_stat_t stage_var(uint32_t id, uint32_t value)
+{
+    uint32_t buf[2] = {value, ~value};
+
+    return e2p_txn_write(id + 1, sizeof(buf), (uint8_t *)buf);
+}
+
+static uint8_t read_var(uint32_t id, uint32_t *value)
+{
+    uint32_t buf[2];
+
+    if (e2p_read(id + 1, sizeof(buf), (uint8_t *)buf) != E2P_STATUS_OK || buf[1] != ~buf[0]) {
+        return 0;
+    }
+    *value = buf[0];
+    return 1;
+}
+
+/* the staged data is RAM, a boot starts without an open transaction */
+static hpm_stat_t reboot(void)
+{
+    e2p_txn_abort();
+    return e2p_config(&e2p);
+}
+
+/* all variables of the transaction new or all old, the others as committed */
+static uint8_t verify(uint8_t *applied)
+{
+    uint32_t nnew = 0, nold = 0;
+    uint32_t value;
+
+    for (uint32_t id = 0; id < VAR_CNT; id++) {
+        if (!read_var(id, &value)) {
+            printf("var %u unreadable\n", id);
+            return 0;
+        }
+        if (in_txn[id] && value == staged[id]) {
+            nnew++;
+        } else if (value == committed[id]) {
+            nold += in_txn[id];
+        } else {
+            printf("var %u: %u, expected %u\n", id, value, committed[id]);
+            return 0;
+        }
+    }
+    if (nnew != 0 && nold != 0) {
+        printf("transaction applied in part, %u new and %u old\n", nnew, nold);
+        return 0;
+    }
+
+    *applied = (nnew != 0);
+    for (uint32_t id = 0; id < VAR_CNT; id++) {
+        if (in_txn[id] && *applied) {
+            committed[id] = staged[id];
+        }
+        in_txn[id] = 0;
+    }
+    return 1;
+}
+
+static void stage_random(uint32_t cnt)
+{
+    for (uint32_t i = 0; i < cnt; i++) {
+        uint32_t id = host_flash_rand() % VAR_CNT;
+
+        staged[id] = next_value++;
+        in_txn[id] = 1;
+        stage_var(id, staged[id]);
+    }
+}
+
+static void test_cost(void)
+{
+    host_flash_stat_t before;
+    uint32_t single_programs, single_criticals, txn_programs, txn_criticals;
+    uint8_t applied = 0;
+
+    before = host_flash_stat;
+    for (uint32_t id = 0; id < VAR_CNT; id++) {
+        committed[id] = next_value++;
+        write_var(id, committed[id]);
+    }
+    single_programs = host_flash_stat.programs - before.programs;
+    single_criticals = host_flash_stat.criticals - before.criticals;
+
+    before = host_flash_stat;
+    e2p_txn_begin();
+    for (uint32_t id = 0; id < VAR_CNT; id++) {
+        staged[id] = next_value++;
+        in_txn[id] = 1;
+        stage_var(id, staged[id]);
+    }
+    expect("cost: commit", e2p_txn_commit() == E2P_STATUS_OK);
+    txn_programs = host_flash_stat.programs - before.programs;
+    txn_criticals = host_flash_stat.criticals - before.criticals;
+
+    printf("%u variables: e2p_write %u programs %u critical sections, transaction %u programs %u critical sections "
+           "(bound %u)\n", VAR_CNT, single_programs, single_criticals, txn_programs, txn_criticals,
+           (uint32_t)MAX_TXN_PROGRAMS(VAR_CNT));
+    expect("cost: programs of the transaction bounded", txn_programs <= MAX_TXN_PROGRAMS(VAR_CNT));
+    expect("cost: one critical section per program", txn_criticals == txn_programs);
+    expect("cost: read back after boot", reboot() == E2P_STATUS_OK && verify(&applied) && applied);
+}
+
+static void test_power_off_before_commit(void)
+{
+    host_flash_stat_t before = host_flash_stat;
+    uint8_t applied = 1;
+
+    e2p_txn_begin();
+    stage_random(VAR_CNT);
+    expect("power off before commit: nothing programmed", host_flash_stat.programs == before.programs);
+    expect("power off before commit: nothing read back", reboot() == E2P_STATUS_OK && verify(&applied) && !applied);
+    expect("power off before commit: a new transaction opens", e2p_txn_begin() == E2P_STATUS_OK);
+    e2p_txn_abort();
+}
+
+/* one transaction, cut at the cut-th flash operation from e2p_txn_begin, 0 for none; 1 when it was cut */
+static int run_cut(uint32_t cut, uint32_t cnt, uint8_t *ok)
+{
+    uint8_t applied;
+    int was_cut = 0;
+
+    if (setjmp(host_flash_power_cut) == 0) {
+        host_flash_cut_after(cut);
+        e2p_txn_begin();
+        stage_random(cnt);
+        if (e2p_txn_commit() != E2P_STATUS_OK) {
+            printf("commit failed\n");
+            *ok = 0;
+        }
+        host_flash_cut_after(0);
+    } else {
+        was_cut = 1;
+    }
+
+    if (reboot() != E2P_STATUS_OK) {
+        printf("boot failed\n");
+        *ok = 0;
+    } else if (!verify(&applied)) {
+        *ok = 0;
+    } else if (!was_cut && !applied) {
+        printf("completed transaction lost\n");
+        *ok = 0;
+    }
+    return was_cut;
+}
+
+static void test_power_cut(void)
+{
+    uint32_t cuts = 0, sweep;
+    uint8_t ok = 1;
+
+    /* every flash operation of one commit */
+    for (sweep = 1; ok && run_cut(sweep, VAR_CNT, &ok); sweep++) {
+    }
+    printf("commit of %u variables cut at each of its %u flash operations\n", VAR_CNT, sweep - 1);
+
+    for (uint32_t t = 0; t < TRIALS && ok; t++) {
+        uint32_t id = host_flash_rand() % VAR_CNT;
+
+        /* single writes in between, their area fills up and the commit flushes it */
+        if (host_flash_rand() % 4 == 0) {
+            committed[id] = next_value++;
+            write_var(id, committed[id]);
+        }
+        cuts += run_cut(1 + host_flash_rand() % 48, 1 + host_flash_rand() % VAR_CNT, &ok);
+    }
+    printf("%u transactions, %u cut, %u programs, %u erases\n", TRIALS, cuts, host_flash_stat.programs,
+           host_flash_stat.erases);
+    expect("power cut in commit: all or nothing of each transaction", ok);
+}
+
+int main(void)
+{
+    host_flash_format();
+    host_flash_config(&e2p, ERASE_SIZE, SECTOR_CNT, 0x4553);
+    if (e2p_config(&e2p) != E2P_STATUS_OK) {
+        printf("FAILED\n");
+        return 1;
+    }
+
+    test_cost();
+    test_power_off_before_commit();
+    test_power_cut();
+
+    printf(failures ? "FAILED\n" : "PASSED.\n");
+    return failures ? 1 : 0;
+}
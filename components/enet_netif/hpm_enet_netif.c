@@ -0,0 +1,391 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include "hpm_enet_netif.h"
+#include "hpm_soc.h"
+#include "hpm_l1c_drv.h"
+#include "lwip/sys.h"
+#include "lwip/etharp.h"
+
+#ifndef HPM_ENET_NETIF_TX_BUSY_RETRY_COUNT
+#define HPM_ENET_NETIF_TX_BUSY_RETRY_COUNT (1000U)
+#endif
+
+static uint32_t hpm_enet_netif_sys_addr(hpm_enet_netif_t *enet_netif, const void *addr)
+{
+    return core_local_mem_to_sys_address(enet_netif->cfg.running_core, (uint32_t) addr);
+}
+
+static void hpm_enet_netif_rx_free(struct pbuf *p)
+{
+    hpm_enet_netif_rx_buff_t *rx_buff = (hpm_enet_netif_rx_buff_t *) p;
+    hpm_enet_netif_t *enet_netif = rx_buff->owner;
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    SYS_ARCH_PROTECT(lev);
+    rx_buff->next = enet_netif->rx_free;
+    enet_netif->rx_free = rx_buff;
+    SYS_ARCH_UNPROTECT(lev);
+}
+
+static hpm_enet_netif_rx_buff_t *hpm_enet_netif_rx_alloc(hpm_enet_netif_t *enet_netif)
+{
+    hpm_enet_netif_rx_buff_t *rx_buff;
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    SYS_ARCH_PROTECT(lev);
+    rx_buff = enet_netif->rx_free;
+    if (rx_buff != NULL) {
+        enet_netif->rx_free = rx_buff->next;
+    }
+    SYS_ARCH_UNPROTECT(lev);
+
+    return rx_buff;
+}
+
+hpm_stat_t hpm_enet_netif_setup(hpm_enet_netif_t *enet_netif, const hpm_enet_netif_config_t *config)
+{
+    if ((enet_netif == NULL) || (config == NULL) || (config->base == NULL) || (config->desc == NULL) ||
+        (config->mac == NULL) || ((config->rx_pool_count > 0U) && (config->rx_pool_buff == NULL))) {
+        return status_invalid_argument;
+    }
+
+    enet_desc_t *desc = config->desc;
+    if ((desc->rx_buff_cfg.count + config->rx_pool_count > HPM_ENET_NETIF_RX_BUFF_MAX_COUNT) ||
+        (desc->tx_buff_cfg.count > HPM_ENET_NETIF_TX_DESC_MAX_COUNT) ||
+        (desc->rx_buff_cfg.count == 0U) || (desc->tx_buff_cfg.count == 0U)) {
+        return status_invalid_argument;
+    }
+
+    memset(enet_netif, 0, sizeof(*enet_netif));
+    enet_netif->cfg = *config;
+
+    /* pbufs are never padded for the CRC, let the MAC append it */
+    enet_netif->tx_control = desc->tx_control_config;
+    enet_netif->tx_control.disable_crc = false;
+    enet_netif->tx_control.enable_crcr = false;
+
+    for (uint32_t i = 0; i < desc->rx_buff_cfg.count + config->rx_pool_count; i++) {
+        hpm_enet_netif_rx_buff_t *rx_buff = &enet_netif->rx_buff[i];
+
+        rx_buff->pc.custom_free_function = hpm_enet_netif_rx_free;
+        rx_buff->owner = enet_netif;
+        if (i < desc->rx_buff_cfg.count) {
+            rx_buff->buff = (uint8_t *) (desc->rx_buff_cfg.buffer + i * desc->rx_buff_cfg.size);
+            enet_netif->rx_desc_buff[i] = rx_buff;
+        } else {
+            rx_buff->buff = config->rx_pool_buff + (i - desc->rx_buff_cfg.count) * desc->rx_buff_cfg.size;
+            rx_buff->next = enet_netif->rx_free;
+            enet_netif->rx_free = rx_buff;
+        }
+    }
+
+    enet_netif->tx_clean = desc->tx_desc_list_cur - desc->tx_desc_list_head;
+
+    return status_success;
+}
+
+err_t hpm_enet_netif_init(struct netif *netif)
+{
+    LWIP_ASSERT("netif != NULL", (netif != NULL));
+    LWIP_ASSERT("netif->state != NULL", (netif->state != NULL));
+
+    hpm_enet_netif_t *enet_netif = (hpm_enet_netif_t *) netif->state;
+
+    netif->hwaddr_len = ETH_HWADDR_LEN;
+    memcpy(netif->hwaddr, enet_netif->cfg.mac, ETH_HWADDR_LEN);
+    netif->mtu = 1500;
+    netif->flags |= NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_IGMP;
+#if LWIP_IPV4
+    netif->output = etharp_output;
+#endif
+    netif->linkoutput = hpm_enet_netif_output;
+
+    return ERR_OK;
+}
+
+static void hpm_enet_netif_rx_rearm(hpm_enet_netif_t *enet_netif, enet_rx_desc_t *rx_desc, uint32_t seg_count)
+{
+    enet_desc_t *desc = enet_netif->cfg.desc;
+
+    for (uint32_t i = 0; i < seg_count; i++) {
+        uint32_t idx = rx_desc - desc->rx_desc_list_head;
+        rx_desc->rdes2_bm.buffer1 = hpm_enet_netif_sys_addr(enet_netif, enet_netif->rx_desc_buff[idx]->buff);
+        fencerw();
+        rx_desc->rdes0_bm.own = 1;
+        rx_desc = (enet_rx_desc_t *) rx_desc->rdes3_bm.next_desc;
+    }
+}
+
+static struct pbuf *hpm_enet_netif_rx_copy(hpm_enet_netif_t *enet_netif, enet_frame_t *frame, uint32_t seg_count)
+{
+    enet_desc_t *desc = enet_netif->cfg.desc;
+    enet_rx_desc_t *rx_desc = frame->rx_desc;
+    struct pbuf *p = pbuf_alloc(PBUF_RAW, (u16_t) frame->length, PBUF_POOL);
+
+    if (p == NULL) {
+        return NULL;
+    }
+
+    uint32_t offset = 0;
+    for (uint32_t i = 0; (i < seg_count) && (offset < frame->length); i++) {
+        uint32_t idx = rx_desc - desc->rx_desc_list_head;
+        uint32_t size = frame->length - offset;
+        if (size > desc->rx_buff_cfg.size) {
+            size = desc->rx_buff_cfg.size;
+        }
+        pbuf_take_at(p, enet_netif->rx_desc_buff[idx]->buff, (u16_t) size, (u16_t) offset);
+        offset += size;
+        rx_desc = (enet_rx_desc_t *) rx_desc->rdes3_bm.next_desc;
+    }
+    enet_netif->stats.rx_copied++;
+    enet_netif->stats.rx_copied_bytes += frame->length;
+
+    return p;
+}
+
+static struct pbuf *hpm_enet_netif_rx_frame(hpm_enet_netif_t *enet_netif, enet_frame_t *frame)
+{
+    enet_desc_t *desc = enet_netif->cfg.desc;
+    uint32_t seg_count = desc->rx_frame_info.seg_count;
+    struct pbuf *p = NULL;
+
+    if ((desc->rx_frame_info.ls_rx_desc->rdes0_bm.es != 0U) || (desc->rx_frame_info.ls_rx_desc->rdes0_bm.fl < 4U)) {
+        enet_netif->stats.rx_dropped++;
+        hpm_enet_netif_rx_rearm(enet_netif, frame->rx_desc, seg_count);
+        return NULL;
+    }
+
+    if (seg_count == 1U) {
+        /* Hand the DMA buffer to lwIP and give the descriptor a spare one */
+        hpm_enet_netif_rx_buff_t *spare = hpm_enet_netif_rx_alloc(enet_netif);
+        if (spare != NULL) {
+            uint32_t idx = frame->rx_desc - desc->rx_desc_list_head;
+            hpm_enet_netif_rx_buff_t *rx_buff = enet_netif->rx_desc_buff[idx];
+            p = pbuf_alloced_custom(PBUF_RAW, (u16_t) frame->length, PBUF_REF, &rx_buff->pc,
+                                    rx_buff->buff, desc->rx_buff_cfg.size);
+            if (p != NULL) {
+                enet_netif->rx_desc_buff[idx] = spare;
+                enet_netif->stats.rx_zero_copy++;
+            } else {
+                hpm_enet_netif_rx_free(&spare->pc.pbuf);
+            }
+        }
+    }
+
+    if (p == NULL) {
+        p = hpm_enet_netif_rx_copy(enet_netif, frame, seg_count);
+    }
+
+    if (p == NULL) {
+        enet_netif->stats.rx_dropped++;
+    } else {
+#if defined(LWIP_PTP) && LWIP_PTP
+        p->time_sec  = frame->rx_desc->rdes7_bm.rtsh;
+        p->time_nsec = frame->rx_desc->rdes6_bm.rtsl;
+#endif
+        enet_netif->stats.rx_frames++;
+    }
+
+    hpm_enet_netif_rx_rearm(enet_netif, frame->rx_desc, seg_count);
+
+    return p;
+}
+
+uint32_t hpm_enet_netif_input(struct netif *netif)
+{
+    hpm_enet_netif_t *enet_netif = (hpm_enet_netif_t *) netif->state;
+    enet_desc_t *desc = enet_netif->cfg.desc;
+    uint32_t count = 0;
+
+    /* Bounded so that a busy link cannot starve the caller */
+    for (uint32_t i = 0; i < desc->rx_buff_cfg.count; i++) {
+        enet_frame_t frame = enet_get_received_frame_interrupt(&desc->rx_desc_list_cur, &desc->rx_frame_info,
+                                                               desc->rx_buff_cfg.count);
+        if (frame.rx_desc == NULL) {
+            break;
+        }
+
+        struct pbuf *p = hpm_enet_netif_rx_frame(enet_netif, &frame);
+        desc->rx_frame_info.seg_count = 0;
+        enet_rx_resume(enet_netif->cfg.base);
+
+        if (p != NULL) {
+            if (netif->input(p, netif) != ERR_OK) {
+                pbuf_free(p);
+            } else {
+                count++;
+            }
+        }
+    }
+    enet_rx_resume(enet_netif->cfg.base);
+
+    return count;
+}
+
+void hpm_enet_netif_tx_reclaim(hpm_enet_netif_t *enet_netif)
+{
+    enet_desc_t *desc = enet_netif->cfg.desc;
+
+    while (enet_netif->tx_used > 0U) {
+        enet_tx_desc_t *tx_desc = desc->tx_desc_list_head + enet_netif->tx_clean;
+        if (tx_desc->tdes0_bm.own != 0U) {
+            break;
+        }
+        if (enet_netif->tx_pbuf[enet_netif->tx_clean] != NULL) {
+            pbuf_free(enet_netif->tx_pbuf[enet_netif->tx_clean]);
+            enet_netif->tx_pbuf[enet_netif->tx_clean] = NULL;
+        }
+        enet_netif->tx_clean = (enet_netif->tx_clean + 1U) % desc->tx_buff_cfg.count;
+        enet_netif->tx_used--;
+    }
+}
+
+/* Fill a descriptor, only the first one of a frame is left to the CPU until all of them are written */
+static void hpm_enet_netif_tx_fill(hpm_enet_netif_t *enet_netif, enet_tx_desc_t *tx_desc, uint32_t addr,
+                                   uint32_t len, bool first, bool last)
+{
+    enet_tx_control_config_t *config = &enet_netif->tx_control;
+    enet_tx_desc_t value;
+
+    value.tdes0 = 0;
+    value.tdes1 = 0;
+    value.tdes0_bm.tch = 1;
+    if (first) {
+        value.tdes0_bm.fs = 1;
+        value.tdes0_bm.dc = config->disable_crc;
+        value.tdes0_bm.dp = config->disable_pad;
+        value.tdes0_bm.crcr = config->enable_crcr;
+        value.tdes0_bm.cic = config->cic;
+        value.tdes0_bm.vlic = config->vlic;
+        value.tdes0_bm.ttse = config->enable_ttse;
+        value.tdes1_bm.saic = config->saic;
+    } else {
+        value.tdes0_bm.own = 1;
+    }
+    if (last) {
+        value.tdes0_bm.ls = 1;
+        value.tdes0_bm.ic = config->enable_ioc;
+    }
+    value.tdes1_bm.tbs1 = len & ENET_DMATxDesc_TBS1;
+
+    tx_desc->tdes2_bm.buffer1 = addr;
+    tx_desc->tdes1 = value.tdes1;
+    tx_desc->tdes0 = value.tdes0;
+}
+
+err_t hpm_enet_netif_output(struct netif *netif, struct pbuf *p)
+{
+    hpm_enet_netif_t *enet_netif = (hpm_enet_netif_t *) netif->state;
+    enet_desc_t *desc = enet_netif->cfg.desc;
+    uint32_t desc_count = desc->tx_buff_cfg.count;
+    uint32_t seg_count = 0;
+    bool zero_copy = true;
+    struct pbuf *q;
+
+    for (q = p; q != NULL; q = q->next) {
+        if (q->len == 0U) {
+            continue;
+        }
+        seg_count++;
+        if (((seg_count > 1U) || !HPM_ENET_NETIF_TX_UNALIGNED_FIRST_SEG) &&
+            (((uint32_t) q->payload % ENET_SOC_BUFF_ADDR_ALIGNMENT) != 0U)) {
+            zero_copy = false;
+        }
+        if (q->len > ENET_DMATxDesc_TBS1) {
+            zero_copy = false;
+        }
+        /* PBUF_REF payloads may change once this function returns, the DMA must not read them later */
+        if (PBUF_NEEDS_COPY(q)) {
+            zero_copy = false;
+        }
+    }
+    if ((seg_count == 0U) || (seg_count > desc_count)) {
+        zero_copy = false;
+    }
+    if (!zero_copy && (p->tot_len > desc->tx_buff_cfg.size)) {
+        return ERR_BUF;
+    }
+
+    uint32_t needed = zero_copy ? seg_count : 1U;
+    uint32_t retry = HPM_ENET_NETIF_TX_BUSY_RETRY_COUNT;
+    hpm_enet_netif_tx_reclaim(enet_netif);
+    while ((desc_count - enet_netif->tx_used < needed) && (retry-- > 0U)) {
+        hpm_enet_netif_tx_reclaim(enet_netif);
+    }
+    if (desc_count - enet_netif->tx_used < needed) {
+        enet_netif->stats.tx_busy++;
+        return ERR_MEM;
+    }
+
+    uint32_t first_idx = (enet_netif->tx_clean + enet_netif->tx_used) % desc_count;
+    uint32_t idx = first_idx;
+    enet_tx_desc_t *first_desc = desc->tx_desc_list_head + first_idx;
+    enet_tx_desc_t *last_desc = first_desc;
+
+    if (zero_copy) {
+        uint32_t i = 0;
+        for (q = p; q != NULL; q = q->next) {
+            if (q->len == 0U) {
+                continue;
+            }
+            if (l1c_dc_is_enabled()) {
+                uint32_t aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t) q->payload);
+                uint32_t aligned_end = HPM_L1C_CACHELINE_ALIGN_UP((uint32_t) q->payload + q->len);
+                l1c_dc_writeback(aligned_start, aligned_end - aligned_start);
+            }
+            last_desc = desc->tx_desc_list_head + idx;
+            hpm_enet_netif_tx_fill(enet_netif, last_desc, hpm_enet_netif_sys_addr(enet_netif, q->payload), q->len,
+                                   i == 0U, i == seg_count - 1U);
+            i++;
+            if (i < seg_count) {
+                idx = (idx + 1U) % desc_count;
+            }
+        }
+        /* The payloads are read by the DMA until the last descriptor is released */
+        pbuf_ref(p);
+        enet_netif->tx_pbuf[idx] = p;
+        enet_netif->stats.tx_zero_copy++;
+    } else {
+        uint8_t *buff = (uint8_t *) (desc->tx_buff_cfg.buffer + first_idx * desc->tx_buff_cfg.size);
+        pbuf_copy_partial(p, buff, p->tot_len, 0);
+        hpm_enet_netif_tx_fill(enet_netif, first_desc, (uint32_t) buff, p->tot_len, true, true);
+        enet_netif->stats.tx_copied++;
+        enet_netif->stats.tx_copied_bytes += p->tot_len;
+    }
+
+    enet_netif->tx_used += needed;
+    desc->tx_desc_list_cur = desc->tx_desc_list_head + (idx + 1U) % desc_count;
+
+    fencerw();
+    first_desc->tdes0_bm.own = 1;
+    fencerw();
+    enet_netif->cfg.base->DMA_TX_POLL_DEMAND = 1;
+    enet_netif->stats.tx_frames++;
+
+#if defined(LWIP_PTP) && LWIP_PTP
+    if (enet_netif->tx_control.enable_ttse) {
+        uint32_t ts_retry = HPM_ENET_NETIF_TX_TS_RETRY_COUNT;
+        while ((last_desc->tdes0_bm.own != 0U) && (ts_retry-- > 0U)) {
+        }
+        p->time_sec  = last_desc->tdes7_bm.ttsh;
+        p->time_nsec = last_desc->tdes6_bm.ttsl;
+    }
+#else
+    (void) last_desc;
+#endif
+
+    return ERR_OK;
+}
+
+void hpm_enet_netif_get_stats(hpm_enet_netif_t *enet_netif, hpm_enet_netif_stats_t *stats)
+{
+    if ((enet_netif != NULL) && (stats != NULL)) {
+        *stats = enet_netif->stats;
+    }
+}
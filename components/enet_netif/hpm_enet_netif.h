@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_ENET_NETIF_H
+#define HPM_ENET_NETIF_H
+
+#include "hpm_common.h"
+#include "hpm_enet_drv.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error "hpm_enet_netif requires LWIP_SUPPORT_CUSTOM_PBUF"
+#endif
+
+/**
+ * @brief Upper limit of receive descriptors plus spare receive buffers of one interface
+ */
+#ifndef HPM_ENET_NETIF_RX_BUFF_MAX_COUNT
+#define HPM_ENET_NETIF_RX_BUFF_MAX_COUNT (96U)
+#endif
+
+/**
+ * @brief Upper limit of transmit descriptors of one interface
+ */
+#ifndef HPM_ENET_NETIF_TX_DESC_MAX_COUNT
+#define HPM_ENET_NETIF_TX_DESC_MAX_COUNT (64U)
+#endif
+
+/**
+ * @brief Map the first pbuf of a frame onto a transmit descriptor at any byte address
+ *
+ * The transmit DMA reads buffer 1 from any byte address. lwIP aligns the transport payload of the
+ * frames it allocates, so with ETH_PAD_SIZE 0 the Ethernet header starts at 2 mod 4. Set to 0 to
+ * require ENET_SOC_BUFF_ADDR_ALIGNMENT for the first pbuf as well, such frames are then copied.
+ */
+#ifndef HPM_ENET_NETIF_TX_UNALIGNED_FIRST_SEG
+#define HPM_ENET_NETIF_TX_UNALIGNED_FIRST_SEG (1)
+#endif
+
+/**
+ * @brief Polls of the last descriptor while waiting for a transmit timestamp
+ */
+#ifndef HPM_ENET_NETIF_TX_TS_RETRY_COUNT
+#define HPM_ENET_NETIF_TX_TS_RETRY_COUNT (10000U)
+#endif
+
+/**
+ * @brief enet netif config
+ */
+typedef struct {
+    ENET_Type *base;            /**< ENET instance */
+    enet_desc_t *desc;          /**< Descriptor chains and buffers already set up by enet_controller_init() */
+    uint8_t *rx_pool_buff;      /**< Spare receive buffers, desc->rx_buff_cfg.size bytes each, in non-cacheable memory */
+    uint32_t rx_pool_count;     /**< Number of spare receive buffers */
+    const uint8_t *mac;         /**< MAC address, ETH_HWADDR_LEN bytes */
+    uint8_t running_core;       /**< Core used to map core local memory to system addresses */
+} hpm_enet_netif_config_t;
+
+/**
+ * @brief enet netif statistics
+ */
+typedef struct {
+    uint32_t rx_frames;         /**< Frames passed to lwIP */
+    uint32_t rx_zero_copy;      /**< Frames passed as the DMA buffer itself */
+    uint32_t rx_copied;         /**< Frames copied into the pbuf pool, no spare buffer or multiple segments */
+    uint32_t rx_copied_bytes;
+    uint32_t rx_dropped;        /**< Error frames and frames without a pbuf */
+    uint32_t tx_frames;         /**< Frames handed to the DMA */
+    uint32_t tx_zero_copy;      /**< Frames transmitted from the pbuf payloads */
+    uint32_t tx_copied;         /**< Frames copied into the descriptor buffer */
+    uint32_t tx_copied_bytes;
+    uint32_t tx_busy;           /**< Frames rejected for lack of free descriptors */
+} hpm_enet_netif_stats_t;
+
+struct hpm_enet_netif;
+
+/**
+ * @brief Receive buffer wrapped as a custom pbuf while lwIP owns it
+ */
+typedef struct hpm_enet_netif_rx_buff {
+    struct pbuf_custom pc;              /**< Must be the first member */
+    struct hpm_enet_netif *owner;
+    uint8_t *buff;
+    struct hpm_enet_netif_rx_buff *next;
+} hpm_enet_netif_rx_buff_t;
+
+/**
+ * @brief enet netif context, passed as the state of netif_add()
+ */
+typedef struct hpm_enet_netif {
+    hpm_enet_netif_config_t cfg;
+    enet_tx_control_config_t tx_control;
+    hpm_enet_netif_rx_buff_t rx_buff[HPM_ENET_NETIF_RX_BUFF_MAX_COUNT];
+    hpm_enet_netif_rx_buff_t *rx_desc_buff[HPM_ENET_NETIF_RX_BUFF_MAX_COUNT];  /**< Buffer attached to each receive descriptor */
+    hpm_enet_netif_rx_buff_t *rx_free;                                          /**< Spare buffers not owned by lwIP */
+    struct pbuf *tx_pbuf[HPM_ENET_NETIF_TX_DESC_MAX_COUNT];                     /**< pbuf held until the DMA releases the descriptor */
+    uint32_t tx_clean;          /**< Oldest descriptor handed to the DMA */
+    uint32_t tx_used;           /**< Descriptors handed to the DMA and not reclaimed yet */
+    hpm_enet_netif_stats_t stats;
+} hpm_enet_netif_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Set up the context, the receive descriptors keep their buffers and the spare ones go to the free list
+ *
+ * @param [out] enet_netif context
+ * @param [in] config configuration
+ * @retval status_invalid_argument the descriptor or buffer counts exceed the compile time limits
+ * @retval status_success
+ */
+hpm_stat_t hpm_enet_netif_setup(hpm_enet_netif_t *enet_netif, const hpm_enet_netif_config_t *config);
+
+/**
+ * @brief netif_add() init callback, netif->state must point to a set up @ref hpm_enet_netif_t
+ *
+ * @param [in] netif lwIP interface
+ * @return ERR_OK
+ */
+err_t hpm_enet_netif_init(struct netif *netif);
+
+/**
+ * @brief Pass all received frames to netif->input
+ *
+ * @param [in] netif lwIP interface
+ * @return number of frames accepted by netif->input
+ */
+uint32_t hpm_enet_netif_input(struct netif *netif);
+
+/**
+ * @brief netif linkoutput, pbuf payloads are mapped onto the transmit descriptors when possible,
+ *        frames holding volatile (PBUF_REF) payloads are always copied. Every pbuf after the first
+ *        must start on ENET_SOC_BUFF_ADDR_ALIGNMENT, see @ref HPM_ENET_NETIF_TX_UNALIGNED_FIRST_SEG
+ *
+ * @param [in] netif lwIP interface
+ * @param [in] p frame
+ * @retval ERR_MEM not enough free transmit descriptors
+ * @retval ERR_BUF the frame does not fit a descriptor buffer and cannot be mapped
+ * @retval ERR_OK
+ */
+err_t hpm_enet_netif_output(struct netif *netif, struct pbuf *p);
+
+/**
+ * @brief Free the pbufs of the descriptors the DMA has finished with
+ *
+ * @param [in] enet_netif context
+ */
+void hpm_enet_netif_tx_reclaim(hpm_enet_netif_t *enet_netif);
+
+/**
+ * @brief Get the statistics
+ *
+ * @param [in] enet_netif context
+ * @param [out] stats statistics
+ */
+void hpm_enet_netif_get_stats(hpm_enet_netif_t *enet_netif, hpm_enet_netif_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_ENET_NETIF_H */
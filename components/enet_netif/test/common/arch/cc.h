@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef CC_H
+#define CC_H
+
+/* lwIP port of the host build */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LWIP_PLATFORM_DIAG(x) do { printf x; } while (0)
+#define LWIP_PLATFORM_ASSERT(x) do { printf("lwIP assertion \"%s\" failed at line %d in %s\n", x, __LINE__, __FILE__); \
+                                     abort(); } while (0)
+#define LWIP_RAND() ((u32_t)rand())
+
+/* the heap of lwIP is the DMA memory of the zero-copy frames */
+#define LWIP_MEM_SECTION ".bss.lwip_ram_heap"
+
+#endif /* CC_H */
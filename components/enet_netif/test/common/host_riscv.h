@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Included first on the command line: the RISC-V fence of riscv_core.h becomes a
+ * compiler barrier, the soc headers including riscv_core.h later keep this definition.
+ */
+
+#ifndef HOST_RISCV_H
+#define HOST_RISCV_H
+
+#include "riscv/riscv_core.h"
+
+#undef fencerw
+#define fencerw() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#endif /* HOST_RISCV_H */
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _HPM_L1_CACHE_H
+#define _HPM_L1_CACHE_H
+
+/* cache maintenance of the host build, the write backs are checked by enet_netif_test.c */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HPM_L1C_CACHELINE_SIZE (64)
+#define HPM_L1C_CACHELINE_ALIGN_DOWN(n) ((uint32_t)(n) & ~(HPM_L1C_CACHELINE_SIZE - 1U))
+#define HPM_L1C_CACHELINE_ALIGN_UP(n)   HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)(n) + HPM_L1C_CACHELINE_SIZE - 1U)
+
+bool l1c_dc_is_enabled(void);
+void l1c_dc_writeback(uint32_t addr, uint32_t size);
+
+#endif /* _HPM_L1_CACHE_H */
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef LWIPOPTS_H
+#define LWIPOPTS_H
+
+/* the options of the single port lwIP samples, without an OS, DHCP or the sequential API */
+
+#define NO_SYS                          1
+#define SYS_LIGHTWEIGHT_PROT            0
+#define LWIP_TIMERS                     1
+#define LWIP_NETIF_TX_SINGLE_PBUF       1
+
+#define MEM_ALIGNMENT                   4
+#define MEM_SIZE                        (16 * 1024)
+#define MEMP_NUM_PBUF                   32
+#define PBUF_POOL_SIZE                  16
+#define PBUF_POOL_BUFSIZE               1600
+
+#define LWIP_IPV4                       1
+#define LWIP_IPV6                       0
+#define LWIP_ARP                        1
+#define ETHARP_SUPPORT_STATIC_ENTRIES   1
+#define ARP_QUEUEING                    0
+#define IP_REASSEMBLY                   0
+#define IP_FRAG                         0
+#define LWIP_ICMP                       1
+#define LWIP_RAW                        0
+#define LWIP_UDP                        1
+#define LWIP_TCP                        1
+#define TCP_MSS                         (1500 - 40)
+#define TCP_SND_BUF                     (4 * TCP_MSS)
+#define TCP_WND                         (2 * TCP_MSS)
+#define LWIP_DHCP                       0
+#define LWIP_DNS                        0
+#define LWIP_IGMP                       0
+
+#define LWIP_NETCONN                    0
+#define LWIP_SOCKET                     0
+#define LWIP_STATS                      0
+#define LWIP_PROVIDE_ERRNO              1
+
+#endif /* LWIPOPTS_H */
@@ -0,0 +1,452 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Zero-copy paths of hpm_enet_netif.c with the pbufs lwIP allocates itself
+ *
+ * lwIP runs on the host and the descriptor rings are set up by the ENET driver as in
+ * enet_controller_init(). The test plays the DMA: it writes received frames into the buffer of
+ * the next receive descriptor and takes the transmitted frames from the descriptors handed over
+ * by the netif. Checked:
+ * 1. ICMP echo requests are passed to lwIP in their receive buffers and the replies lwIP
+ *    allocates are transmitted from the pbufs.
+ * 2. UDP datagrams, a chained UDP datagram, a TCP SYN and RST are transmitted from the pbufs,
+ *    a UDP datagram with a PBUF_REF payload is copied.
+ * 3. Received frames held by the application use up the spare buffers, the next ones are copied,
+ *    and the spare buffers come back when the pbufs are freed.
+ * Every transmitted frame is compared with the expected one and every pbuf handed to the DMA must
+ * have been written back from the cache.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hpm_enet_netif.h"
+#include "lwip/etharp.h"
+#include "lwip/inet_chksum.h"
+#include "lwip/init.h"
+#include "lwip/prot/tcp.h"
+#include "lwip/tcp.h"
+#include "lwip/udp.h"
+#include "netif/ethernet.h"
+
+#define RX_DESC_CNT         (8U)
+#define RX_POOL_CNT         (4U)
+#define TX_DESC_CNT         (8U)
+#define BUFF_SIZE           (ENET_MAX_BUFF_SIZE)
+#define ECHO_CNT            (20U)
+#define UDP_PORT            (5001U)
+#define HOLD_CNT            (RX_POOL_CNT + 2U)
+#define WRITEBACK_CNT       (64U)
+
+#define ETH_HLEN            (14U)
+#define IP_HDR_LEN          (20U)
+#define UDP_HDR_LEN         (8U)
+#define ICMP_HDR_LEN        (8U)
+
+ATTR_ALIGN(ENET_SOC_DESC_ADDR_ALIGNMENT) static enet_rx_desc_t rx_desc_tab[RX_DESC_CNT];
+ATTR_ALIGN(ENET_SOC_DESC_ADDR_ALIGNMENT) static enet_tx_desc_t tx_desc_tab[TX_DESC_CNT];
+ATTR_ALIGN(ENET_SOC_BUFF_ADDR_ALIGNMENT) static uint8_t rx_buff[RX_DESC_CNT][BUFF_SIZE];
+ATTR_ALIGN(ENET_SOC_BUFF_ADDR_ALIGNMENT) static uint8_t rx_pool_buff[RX_POOL_CNT][BUFF_SIZE];
+ATTR_ALIGN(ENET_SOC_BUFF_ADDR_ALIGNMENT) static uint8_t tx_buff[TX_DESC_CNT][BUFF_SIZE];
+
+static ENET_Type enet;
+static enet_desc_t desc;
+static hpm_enet_netif_t enet_netif;
+static struct netif netif;
+static struct udp_pcb *udp;
+
+static const uint8_t local_mac[ETH_HWADDR_LEN] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+static const struct eth_addr peer_mac = {{0x02, 0x00, 0x00, 0x00, 0x00, 0x02}};
+static ip4_addr_t local_ip, peer_ip, netmask;
+
+static enet_rx_desc_t *dma_rx;
+static enet_tx_desc_t *dma_tx;
+static uint8_t tx_frame[BUFF_SIZE];
+static uint32_t tx_frame_len;
+static uint32_t tx_frame_cnt;
+
+static struct {
+    uint32_t start;
+    uint32_t end;
+} writeback[WRITEBACK_CNT];
+static uint32_t writeback_cnt;
+
+static struct pbuf *held[HOLD_CNT];
+static uint32_t held_cnt;
+static bool hold;
+
+static uint8_t payload[1500];
+static int failures;
+
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+static void check(bool ok, const char *what, int line)
+{
+    if (!ok) {
+        printf("line %d: %s failed\n", line, what);
+        failures++;
+    }
+}
+
+u32_t sys_now(void)
+{
+    return 0;
+}
+
+bool l1c_dc_is_enabled(void)
+{
+    return true;
+}
+
+void l1c_dc_writeback(uint32_t addr, uint32_t size)
+{
+    if (writeback_cnt < WRITEBACK_CNT) {
+        writeback[writeback_cnt].start = addr;
+        writeback[writeback_cnt].end = addr + size;
+        writeback_cnt++;
+    }
+}
+
+static bool written_back(uint32_t addr, uint32_t len)
+{
+    for (uint32_t i = 0; i < writeback_cnt; i++) {
+        if ((addr >= writeback[i].start) && (addr + len <= writeback[i].end)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+/* DMA: the next receive descriptor takes the frame */
+static bool dma_receive(const uint8_t *frame, uint32_t len)
+{
+    enet_rx_desc_t *rx_desc = dma_rx;
+
+    if (rx_desc->rdes0_bm.own == 0U) {
+        return false;
+    }
+    memcpy((uint8_t *)(uintptr_t)rx_desc->rdes2_bm.buffer1, frame, len);
+    rx_desc->rdes0 = 0;
+    rx_desc->rdes0_bm.fs = 1;
+    rx_desc->rdes0_bm.ls = 1;
+    rx_desc->rdes0_bm.fl = len + 4U;
+    dma_rx = (enet_rx_desc_t *)(uintptr_t)rx_desc->rdes3_bm.next_desc;
+    return true;
+}
+
+/* DMA: send the frames handed over, the last one stays in tx_frame */
+static void dma_transmit(void)
+{
+    while (dma_tx->tdes0_bm.own != 0U) {
+        enet_tx_desc_t *tx_desc = dma_tx;
+        bool last = false;
+
+        CHECK(tx_desc->tdes0_bm.fs == 1U);
+        tx_frame_len = 0;
+        for (uint32_t i = 0; (i < TX_DESC_CNT) && !last; i++) {
+            uint32_t addr = tx_desc->tdes2_bm.buffer1;
+            uint32_t len = tx_desc->tdes1_bm.tbs1;
+            bool copied = (addr >= (uint32_t)(uintptr_t)tx_buff) &&
+                          (addr < (uint32_t)(uintptr_t)tx_buff + sizeof(tx_buff));
+
+            CHECK((i == 0U) || (tx_desc->tdes0_bm.own == 1U));
+            CHECK(copied || written_back(addr, len));
+            if (tx_frame_len + len <= sizeof(tx_frame)) {
+                memcpy(tx_frame + tx_frame_len, (uint8_t *)(uintptr_t)addr, len);
+                tx_frame_len += len;
+            }
+            last = tx_desc->tdes0_bm.ls != 0U;
+            tx_desc->tdes0_bm.own = 0;
+            tx_desc = (enet_tx_desc_t *)(uintptr_t)tx_desc->tdes3_bm.next_desc;
+        }
+        CHECK(last);
+        dma_tx = tx_desc;
+        tx_frame_cnt++;
+    }
+    writeback_cnt = 0;
+}
+
+/* Ethernet and IPv4 header from the peer, returns the offset of the IP payload */
+static uint32_t build_ip(uint8_t *frame, uint8_t proto, uint32_t ip_payload_len)
+{
+    uint8_t *ip = frame + ETH_HLEN;
+    uint16_t chksum;
+
+    memcpy(frame, local_mac, ETH_HWADDR_LEN);
+    memcpy(frame + ETH_HWADDR_LEN, peer_mac.addr, ETH_HWADDR_LEN);
+    put16(frame + 12, ETHTYPE_IP);
+
+    memset(ip, 0, IP_HDR_LEN);
+    ip[0] = 0x45;
+    put16(ip + 2, (uint16_t)(IP_HDR_LEN + ip_payload_len));
+    ip[8] = 64;
+    ip[9] = proto;
+    memcpy(ip + 12, &peer_ip, 4);
+    memcpy(ip + 16, &local_ip, 4);
+    chksum = inet_chksum(ip, IP_HDR_LEN);
+    memcpy(ip + 10, &chksum, 2);
+
+    return ETH_HLEN + IP_HDR_LEN;
+}
+
+/* a frame from the netif to the peer, returns the IP payload or NULL */
+static const uint8_t *check_ip(uint8_t proto, uint32_t ip_payload_len)
+{
+    const uint8_t *ip = tx_frame + ETH_HLEN;
+
+    if ((tx_frame_len != ETH_HLEN + IP_HDR_LEN + ip_payload_len) ||
+        (memcmp(tx_frame, peer_mac.addr, ETH_HWADDR_LEN) != 0) ||
+        (memcmp(tx_frame + ETH_HWADDR_LEN, local_mac, ETH_HWADDR_LEN) != 0) ||
+        (get16(tx_frame + 12) != ETHTYPE_IP) || (ip[9] != proto) || (inet_chksum(ip, IP_HDR_LEN) != 0) ||
+        (memcmp(ip + 12, &local_ip, 4) != 0) || (memcmp(ip + 16, &peer_ip, 4) != 0)) {
+        return NULL;
+    }
+    return ip + IP_HDR_LEN;
+}
+
+static void udp_recv_cb(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+    (void)arg;
+    (void)pcb;
+    (void)addr;
+    (void)port;
+
+    if (hold && (held_cnt < HOLD_CNT)) {
+        held[held_cnt++] = p;
+    } else {
+        pbuf_free(p);
+    }
+}
+
+static err_t test_netif_init(struct netif *n)
+{
+    n->name[0] = 'e';
+    n->name[1] = 'n';
+    return hpm_enet_netif_init(n);
+}
+
+static void setup(void)
+{
+    hpm_enet_netif_config_t config = {0};
+
+    desc.tx_desc_list_head = tx_desc_tab;
+    desc.rx_desc_list_head = rx_desc_tab;
+    desc.tx_buff_cfg.buffer = (uint32_t)(uintptr_t)tx_buff;
+    desc.tx_buff_cfg.count = TX_DESC_CNT;
+    desc.tx_buff_cfg.size = BUFF_SIZE;
+    desc.rx_buff_cfg.buffer = (uint32_t)(uintptr_t)rx_buff;
+    desc.rx_buff_cfg.count = RX_DESC_CNT;
+    desc.rx_buff_cfg.size = BUFF_SIZE;
+    enet_get_default_tx_control_config(&enet, &desc.tx_control_config);
+    enet_dma_tx_desc_chain_init(&enet, &desc);
+    enet_dma_rx_desc_chain_init(&enet, &desc);
+    dma_rx = rx_desc_tab;
+    dma_tx = tx_desc_tab;
+
+    config.base = &enet;
+    config.desc = &desc;
+    config.rx_pool_buff = (uint8_t *)rx_pool_buff;
+    config.rx_pool_count = RX_POOL_CNT;
+    config.mac = local_mac;
+    config.running_core = HPM_CORE0;
+    CHECK(hpm_enet_netif_setup(&enet_netif, &config) == status_success);
+
+    lwip_init();
+    IP4_ADDR(&local_ip, 192, 168, 100, 10);
+    IP4_ADDR(&peer_ip, 192, 168, 100, 2);
+    IP4_ADDR(&netmask, 255, 255, 255, 0);
+    netif_add(&netif, &local_ip, &netmask, &peer_ip, &enet_netif, test_netif_init, ethernet_input);
+    netif_set_default(&netif);
+    netif_set_up(&netif);
+    netif_set_link_up(&netif);
+    CHECK(etharp_add_static_entry(&peer_ip, (struct eth_addr *)&peer_mac) == ERR_OK);
+
+    udp = udp_new();
+    CHECK((udp != NULL) && (udp_bind(udp, IP4_ADDR_ANY, UDP_PORT) == ERR_OK));
+    udp_recv(udp, udp_recv_cb, NULL);
+}
+
+static void test_echo(void)
+{
+    static uint8_t frame[BUFF_SIZE];
+
+    for (uint32_t i = 0; i < ECHO_CNT; i++) {
+        uint32_t data_len = i * 70U;
+        uint32_t off = build_ip(frame, IP_PROTO_ICMP, ICMP_HDR_LEN + data_len);
+        uint8_t *icmp = frame + off;
+        const uint8_t *reply;
+        uint16_t chksum;
+
+        icmp[0] = 8;
+        icmp[1] = 0;
+        put16(icmp + 2, 0);
+        put16(icmp + 4, 0x1234);
+        put16(icmp + 6, (uint16_t)i);
+        memcpy(icmp + ICMP_HDR_LEN, payload, data_len);
+        chksum = inet_chksum(icmp, (u16_t)(ICMP_HDR_LEN + data_len));
+        memcpy(icmp + 2, &chksum, 2);
+
+        CHECK(dma_receive(frame, off + ICMP_HDR_LEN + data_len));
+        CHECK(hpm_enet_netif_input(&netif) == 1U);
+        dma_transmit();
+        reply = check_ip(IP_PROTO_ICMP, ICMP_HDR_LEN + data_len);
+        if ((reply == NULL) || (reply[0] != 0) || (get16(reply + 4) != 0x1234) || (get16(reply + 6) != i) ||
+            (inet_chksum((void *)reply, (u16_t)(ICMP_HDR_LEN + data_len)) != 0) ||
+            (memcmp(reply + ICMP_HDR_LEN, payload, data_len) != 0)) {
+            printf("echo %u: wrong reply\n", i);
+            failures++;
+        }
+    }
+}
+
+static bool check_udp(uint32_t len, uint32_t offset)
+{
+    const uint8_t *udp = check_ip(IP_PROTO_UDP, UDP_HDR_LEN + len);
+
+    return (udp != NULL) && (get16(udp) == UDP_PORT) && (get16(udp + 2) == UDP_PORT) &&
+           (get16(udp + 4) == UDP_HDR_LEN + len) && (memcmp(udp + UDP_HDR_LEN, payload + offset, len) == 0);
+}
+
+static void test_udp_tcp(void)
+{
+    static const uint32_t lens[] = {1, 18, 64, 333, 1024, 1472};
+    struct tcp_pcb *tcp = tcp_new();
+    struct pbuf *p;
+    const uint8_t *seg;
+
+    CHECK(tcp != NULL);
+
+    /* headers in front of the payload, as udp_send() of a PBUF_TRANSPORT pbuf */
+    for (uint32_t i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+        p = pbuf_alloc(PBUF_TRANSPORT, (u16_t)lens[i], PBUF_RAM);
+        CHECK(p != NULL);
+        pbuf_take(p, payload + i, (u16_t)lens[i]);
+        CHECK(udp_sendto(udp, p, (ip_addr_t *)&peer_ip, UDP_PORT) == ERR_OK);
+        pbuf_free(p);
+        dma_transmit();
+        if (!check_udp(lens[i], i)) {
+            printf("udp %u byte: wrong frame\n", lens[i]);
+            failures++;
+        }
+    }
+
+    /* no room for the headers, lwIP chains a header pbuf in front */
+    p = pbuf_alloc(PBUF_RAW, 600, PBUF_RAM);
+    CHECK(p != NULL);
+    pbuf_take(p, payload, 600);
+    CHECK(udp_sendto(udp, p, (ip_addr_t *)&peer_ip, UDP_PORT) == ERR_OK);
+    pbuf_free(p);
+    dma_transmit();
+    CHECK(check_udp(600, 0));
+
+    /* a volatile payload must be copied */
+    p = pbuf_alloc(PBUF_RAW, 256, PBUF_REF);
+    CHECK(p != NULL);
+    p->payload = payload;
+    CHECK(udp_sendto(udp, p, (ip_addr_t *)&peer_ip, UDP_PORT) == ERR_OK);
+    pbuf_free(p);
+    dma_transmit();
+    CHECK(check_udp(256, 0));
+
+    /* TCP builds its segments in one PBUF_RAM each */
+    CHECK(tcp_connect(tcp, (ip_addr_t *)&peer_ip, 80, NULL) == ERR_OK);
+    dma_transmit();
+    seg = check_ip(IP_PROTO_TCP, tx_frame_len - ETH_HLEN - IP_HDR_LEN);
+    CHECK((seg != NULL) && (get16(seg + 2) == 80) && ((seg[13] & TCP_SYN) != 0U));
+    tcp_abort(tcp);
+    dma_transmit();
+    seg = check_ip(IP_PROTO_TCP, tx_frame_len - ETH_HLEN - IP_HDR_LEN);
+    CHECK((seg != NULL) && ((seg[13] & TCP_RST) != 0U));
+}
+
+static void test_rx_hold(void)
+{
+    static uint8_t frame[BUFF_SIZE];
+
+    hold = true;
+    for (uint32_t i = 0; i < HOLD_CNT + 1U; i++) {
+        uint32_t len = 100U + i * 100U;
+        uint32_t off = build_ip(frame, IP_PROTO_UDP, UDP_HDR_LEN + len);
+        uint8_t *udp = frame + off;
+
+        /* the last frame arrives once the held pbufs are freed */
+        if (i == HOLD_CNT) {
+            hold = false;
+            for (uint32_t j = 0; j < held_cnt; j++) {
+                uint32_t held_len = 100U + j * 100U;
+                CHECK((held[j]->tot_len == held_len) &&
+                      (pbuf_memcmp(held[j], 0, payload + j, (u16_t)held_len) == 0));
+                pbuf_free(held[j]);
+            }
+            CHECK(held_cnt == HOLD_CNT);
+        }
+        put16(udp, UDP_PORT);
+        put16(udp + 2, UDP_PORT);
+        put16(udp + 4, (uint16_t)(UDP_HDR_LEN + len));
+        put16(udp + 6, 0);
+        memcpy(udp + UDP_HDR_LEN, payload + i, len);
+        CHECK(dma_receive(frame, off + UDP_HDR_LEN + len));
+        CHECK(hpm_enet_netif_input(&netif) == 1U);
+    }
+}
+
+int main(void)
+{
+    hpm_enet_netif_stats_t before, after;
+
+    for (uint32_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t)(i * 7U + 3U);
+    }
+    setup();
+    /* the gratuitous ARP request of netif_set_link_up() */
+    dma_transmit();
+
+    hpm_enet_netif_get_stats(&enet_netif, &before);
+    test_echo();
+    hpm_enet_netif_get_stats(&enet_netif, &after);
+    printf("echo: rx %u zero-copy %u copied, tx %u zero-copy %u copied\n", after.rx_zero_copy - before.rx_zero_copy,
+           after.rx_copied - before.rx_copied, after.tx_zero_copy - before.tx_zero_copy,
+           after.tx_copied - before.tx_copied);
+    CHECK(after.rx_zero_copy - before.rx_zero_copy == ECHO_CNT);
+    CHECK(after.tx_zero_copy - before.tx_zero_copy == ECHO_CNT);
+
+    before = after;
+    test_udp_tcp();
+    hpm_enet_netif_get_stats(&enet_netif, &after);
+    printf("udp, tcp: tx %u zero-copy %u copied\n", after.tx_zero_copy - before.tx_zero_copy,
+           after.tx_copied - before.tx_copied);
+    /* six PBUF_TRANSPORT datagrams, the chained one, SYN and RST, the PBUF_REF payload is copied */
+    CHECK(after.tx_zero_copy - before.tx_zero_copy == 9U);
+    CHECK(after.tx_copied - before.tx_copied == 1U);
+
+    before = after;
+    test_rx_hold();
+    hpm_enet_netif_get_stats(&enet_netif, &after);
+    printf("held frames: rx %u zero-copy %u copied\n", after.rx_zero_copy - before.rx_zero_copy,
+           after.rx_copied - before.rx_copied);
+    CHECK(after.rx_zero_copy - before.rx_zero_copy == RX_POOL_CNT + 1U);
+    CHECK(after.rx_copied - before.rx_copied == HOLD_CNT - RX_POOL_CNT);
+
+    hpm_enet_netif_tx_reclaim(&enet_netif);
+    CHECK(enet_netif.tx_used == 0U);
+    CHECK(after.tx_frames == tx_frame_cnt);
+    CHECK((after.rx_dropped == 0U) && (after.tx_busy == 0U));
+
+    printf(failures ? "FAILED\n" : "PASSED.\n");
+    return failures ? 1 : 0;
+}
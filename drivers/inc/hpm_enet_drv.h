@@ -551,6 +551,12 @@ typedef struct {
     uint32_t mmc_intr_mask_tx;
 } enet_int_config_t;
 
+/** @brief Enet receive interrupt coalescing config struct */
+typedef struct {
+    uint8_t frame_count;        /* raise the receive interrupt once per frame_count descriptors, 0 or 1 for every frame */
+    uint8_t watchdog;           /* receive interrupt watchdog timer in units of 256 bus clock cycles, 0 for disable */
+} enet_rx_coalescing_config_t;
+
 /*
  *  @brief Bit definition of TDES1
  */
@@ -647,6 +653,18 @@ void enet_set_line_speed(ENET_Type *ptr, enet_line_speed_t speed);
  */
 void enet_set_duplex_mode(ENET_Type *ptr, enet_duplex_mode_t mode);
 
+/**
+ * @brief Enable or disable the checksum offload of received frames
+ *
+ * @note The IPv4 header and the TCP/UDP/ICMP payload checksums are checked by the MAC,
+ *       a frame failing the check is reported with the error summary bit of its last descriptor.
+ *       Checksums of transmitted frames are inserted according to the cic field of the transmit control config.
+ *
+ * @param[in] ptr An Ethernet peripheral base address
+ * @param[in] enable true: enable, false: disable
+ */
+void enet_enable_rx_checksum_offload(ENET_Type *ptr, bool enable);
+
 /**
  * @brief Read phy
  *
@@ -774,6 +792,29 @@ void enet_dma_rx_desc_chain_init(ENET_Type *ptr,  enet_desc_t *desc);
  */
 void enet_dma_flush(ENET_Type *ptr);
 
+/**
+ * @brief Get a default receive interrupt coalescing config, one interrupt per frame
+ *
+ * @param[in] ptr An Ethernet peripheral base address
+ * @param[out] config A pointer to a receive interrupt coalescing config structure
+ */
+void enet_get_default_rx_coalescing_config(ENET_Type *ptr, enet_rx_coalescing_config_t *config);
+
+/**
+ * @brief Set the receive interrupt coalescing
+ *
+ * @note The interrupt on completion is disabled on all receive descriptors but every frame_count one,
+ *       the watchdog raises the interrupt for frames left pending on the other descriptors.
+ *       Call it after enet_controller_init().
+ *
+ * @param[in] ptr An Ethernet peripheral base address
+ * @param[in] desc A pointer to descriptor config
+ * @param[in] config A pointer to a receive interrupt coalescing config structure
+ * @retval status_invalid_argument frames are coalesced without the watchdog
+ * @retval status_success
+ */
+hpm_stat_t enet_set_rx_coalescing(ENET_Type *ptr, enet_desc_t *desc, enet_rx_coalescing_config_t *config);
+
 /**
  * @brief Initialize a PTP timer
  *
@@ -243,6 +243,15 @@ void enet_set_duplex_mode(ENET_Type *ptr, enet_duplex_mode_t mode)
     ptr->MACCFG |= ENET_MACCFG_DM_SET(mode);
 }
 
+void enet_enable_rx_checksum_offload(ENET_Type *ptr, bool enable)
+{
+    if (enable) {
+        ptr->MACCFG |= ENET_MACCFG_IPC_MASK;
+    } else {
+        ptr->MACCFG &= ~ENET_MACCFG_IPC_MASK;
+    }
+}
+
 hpm_stat_t enet_controller_init(ENET_Type *ptr, enet_inf_type_t inf_type, enet_desc_t *desc, enet_mac_config_t *config, enet_int_config_t *int_config)
 {
     /* select an interface */
@@ -744,6 +753,33 @@ void enet_dma_tx_desc_chain_init(ENET_Type *ptr, enet_desc_t *desc)
     ptr->DMA_TX_DESC_LIST_ADDR = (uint32_t)desc->tx_desc_list_head;
 }
 
+void enet_get_default_rx_coalescing_config(ENET_Type *ptr, enet_rx_coalescing_config_t *config)
+{
+    (void) ptr;
+    config->frame_count = 1;
+    config->watchdog    = 0;
+}
+
+hpm_stat_t enet_set_rx_coalescing(ENET_Type *ptr, enet_desc_t *desc, enet_rx_coalescing_config_t *config)
+{
+    uint32_t frame_count = (config->frame_count == 0) ? 1 : config->frame_count;
+    enet_rx_desc_t *dma_rx_desc;
+
+    /* frames on descriptors without interrupt on completion would wait for the next interrupt */
+    if ((frame_count > 1) && (config->watchdog == 0)) {
+        return status_invalid_argument;
+    }
+
+    ptr->DMA_RX_INTR_WDOG = ENET_DMA_RX_INTR_WDOG_RIWT_SET(config->watchdog);
+
+    for (uint32_t i = 0; i < desc->rx_buff_cfg.count; i++) {
+        dma_rx_desc = desc->rx_desc_list_head + i;
+        dma_rx_desc->rdes1_bm.dic = ((i + 1) % frame_count) ? 1 : 0;
+    }
+
+    return status_success;
+}
+
 void enet_dma_rx_desc_chain_init(ENET_Type *ptr,  enet_desc_t *desc)
 {
     uint32_t i = 0;
@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * agile_modbus_slave_util_callback() driven by synthetic RTU and TCP frames, no serial port or socket
+ *
+ * Every table has MAP_CNT mapping objects of MAP_LEN registers with a gap of one address, so a
+ * request of 125 registers spans 32 objects. Three slaves share the same storage:
+ *
+ *   linear: get/set only, maps_sorted = 0, every address is looked up in the whole array
+ *   sorted: get/set only, maps_sorted = 1, binary search, get copies the whole object
+ *   range:  get_range/set_range, maps_sorted = 1, only the requested registers are copied
+ *
+ * 1. A random mix of MIX_CNT requests (read/write bits and registers, single writes, mask write,
+ *    write and read) from both frame types. Every response is parsed by a master and checked
+ *    against a shadow copy, the unmapped gaps read as 0, and the three slaves must leave the
+ *    same storage behind.
+ * 2. req/s and get/set calls per request of the largest reads and writes, for every slave and
+ *    frame type. The range slave must call get/set once per object covered and nothing more.
+ *
+ * ./slave_util/SlaveUtilBench [requests] (default 50000)
+ */
+
+#include "agile_modbus.h"
+#include "agile_modbus_rtu.h"
+#include "agile_modbus_tcp.h"
+#include "agile_modbus_slave_util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DBG_ENABLE
+#define DBG_COLOR
+#define DBG_SECTION_NAME "slave_util"
+#define DBG_LEVEL        DBG_LOG
+#include "dbg_log.h"
+
+#define MAP_CNT    40
+#define MAP_LEN    3
+#define MAP_STEP   (MAP_LEN + 1)
+#define ADDR_CNT   (MAP_CNT * MAP_STEP)
+#define MIX_CNT    20000
+#define BENCH_REQS 50000
+
+static uint16_t _registers[ADDR_CNT];
+static uint8_t _bits[ADDR_CNT];
+static uint16_t _shadow_registers[ADDR_CNT];
+static uint8_t _shadow_bits[ADDR_CNT];
+static long _gets;
+static long _sets;
+static long _errors;
+
+static int reg_get(int n, void *buf)
+{
+    _gets++;
+    memcpy(buf, &_registers[n * MAP_STEP], MAP_LEN * sizeof(uint16_t));
+    return 0;
+}
+
+static int reg_set(int n, int index, int len, void *buf)
+{
+    _sets++;
+    memcpy(&_registers[n * MAP_STEP + index], (uint16_t *)buf + index, len * sizeof(uint16_t));
+    return 0;
+}
+
+static int reg_get_range(int n, int index, int len, void *buf)
+{
+    _gets++;
+    memcpy(buf, &_registers[n * MAP_STEP + index], len * sizeof(uint16_t));
+    return 0;
+}
+
+static int reg_set_range(int n, int index, int len, void *buf)
+{
+    _sets++;
+    memcpy(&_registers[n * MAP_STEP + index], buf, len * sizeof(uint16_t));
+    return 0;
+}
+
+static int bit_get(int n, void *buf)
+{
+    _gets++;
+    memcpy(buf, &_bits[n * MAP_STEP], MAP_LEN);
+    return 0;
+}
+
+static int bit_set(int n, int index, int len, void *buf)
+{
+    _sets++;
+    memcpy(&_bits[n * MAP_STEP + index], (uint8_t *)buf + index, len);
+    return 0;
+}
+
+static int bit_get_range(int n, int index, int len, void *buf)
+{
+    _gets++;
+    memcpy(buf, &_bits[n * MAP_STEP + index], len);
+    return 0;
+}
+
+static int bit_set_range(int n, int index, int len, void *buf)
+{
+    _sets++;
+    memcpy(&_bits[n * MAP_STEP + index], buf, len);
+    return 0;
+}
+
+/* The interfaces do not tell which object they belong to, so every object gets its own */
+#define MAP_FUNCS(n)                                                                                                    \
+    static int reg_get_##n(void *buf, int bufsz) { (void)bufsz; return reg_get(n, buf); }                               \
+    static int reg_set_##n(int index, int len, void *buf, int bufsz) { (void)bufsz; return reg_set(n, index, len, buf); } \
+    static int reg_get_range_##n(int index, int len, void *buf, int bufsz) { (void)bufsz; return reg_get_range(n, index, len, buf); } \
+    static int reg_set_range_##n(int index, int len, void *buf, int bufsz) { (void)bufsz; return reg_set_range(n, index, len, buf); } \
+    static int bit_get_##n(void *buf, int bufsz) { (void)bufsz; return bit_get(n, buf); }                               \
+    static int bit_set_##n(int index, int len, void *buf, int bufsz) { (void)bufsz; return bit_set(n, index, len, buf); } \
+    static int bit_get_range_##n(int index, int len, void *buf, int bufsz) { (void)bufsz; return bit_get_range(n, index, len, buf); } \
+    static int bit_set_range_##n(int index, int len, void *buf, int bufsz) { (void)bufsz; return bit_set_range(n, index, len, buf); }
+
+#define MAP_FUNCS_10(d)                                                                                     \
+    MAP_FUNCS(d##0) MAP_FUNCS(d##1) MAP_FUNCS(d##2) MAP_FUNCS(d##3) MAP_FUNCS(d##4) MAP_FUNCS(d##5) \
+    MAP_FUNCS(d##6) MAP_FUNCS(d##7) MAP_FUNCS(d##8) MAP_FUNCS(d##9)
+
+MAP_FUNCS_10()
+MAP_FUNCS_10(1)
+MAP_FUNCS_10(2)
+MAP_FUNCS_10(3)
+
+#define MAP(n, t)       {(n) * MAP_STEP, (n) * MAP_STEP + MAP_LEN - 1, t##_get_##n, t##_set_##n, NULL, NULL}
+#define MAP_RO(n, t)    {(n) * MAP_STEP, (n) * MAP_STEP + MAP_LEN - 1, t##_get_##n, NULL, NULL, NULL}
+#define MAP_RANGE(n, t) {(n) * MAP_STEP, (n) * MAP_STEP + MAP_LEN - 1, t##_get_##n, t##_set_##n, t##_get_range_##n, t##_set_range_##n}
+
+#define MAPS_10(M, d, t) \
+    M(d##0, t), M(d##1, t), M(d##2, t), M(d##3, t), M(d##4, t), M(d##5, t), M(d##6, t), M(d##7, t), M(d##8, t), M(d##9, t)
+#define MAPS(M, t) {MAPS_10(M, , t), MAPS_10(M, 1, t), MAPS_10(M, 2, t), MAPS_10(M, 3, t)}
+
+/* Listed in ascending address order, agile_modbus_slave_util_check_maps() verifies it */
+static const agile_modbus_slave_util_map_t _bit_maps[MAP_CNT] = MAPS(MAP, bit);
+static const agile_modbus_slave_util_map_t _input_bit_maps[MAP_CNT] = MAPS(MAP_RO, bit);
+static const agile_modbus_slave_util_map_t _register_maps[MAP_CNT] = MAPS(MAP, reg);
+static const agile_modbus_slave_util_map_t _input_register_maps[MAP_CNT] = MAPS(MAP_RO, reg);
+static const agile_modbus_slave_util_map_t _bit_range_maps[MAP_CNT] = MAPS(MAP_RANGE, bit);
+static const agile_modbus_slave_util_map_t _register_range_maps[MAP_CNT] = MAPS(MAP_RANGE, reg);
+
+#define SLAVE_UTIL(bits, input_bits, registers, input_registers, sorted)                                        \
+    {                                                                                                            \
+        bits, MAP_CNT, input_bits, MAP_CNT, registers, MAP_CNT, input_registers, MAP_CNT, NULL, NULL, NULL, sorted \
+    }
+
+static const agile_modbus_slave_util_t _slave_utils[] = {
+    SLAVE_UTIL(_bit_maps, _input_bit_maps, _register_maps, _input_register_maps, 0),
+    SLAVE_UTIL(_bit_maps, _input_bit_maps, _register_maps, _input_register_maps, 1),
+    SLAVE_UTIL(_bit_range_maps, _bit_range_maps, _register_range_maps, _register_range_maps, 1),
+};
+
+static const char *_slave_names[] = {"linear", "sorted", "range"};
+
+#define SLAVE_CNT (int)(sizeof(_slave_utils) / sizeof(_slave_utils[0]))
+
+/* A master and a slave of one frame type, the frames are copied between their buffers */
+typedef struct {
+    const char *name;
+    agile_modbus_t *master;
+    agile_modbus_t *slave;
+} link_t;
+
+static agile_modbus_rtu_t _rtu_master, _rtu_slave;
+static agile_modbus_tcp_t _tcp_master, _tcp_slave;
+static uint8_t _rtu_buf[4][AGILE_MODBUS_MAX_ADU_LENGTH];
+static uint8_t _tcp_buf[4][AGILE_MODBUS_MAX_ADU_LENGTH];
+static link_t _links[2];
+
+static void links_init(void)
+{
+    agile_modbus_rtu_init(&_rtu_master, _rtu_buf[0], sizeof(_rtu_buf[0]), _rtu_buf[1], sizeof(_rtu_buf[1]));
+    agile_modbus_rtu_init(&_rtu_slave, _rtu_buf[2], sizeof(_rtu_buf[2]), _rtu_buf[3], sizeof(_rtu_buf[3]));
+    agile_modbus_tcp_init(&_tcp_master, _tcp_buf[0], sizeof(_tcp_buf[0]), _tcp_buf[1], sizeof(_tcp_buf[1]));
+    agile_modbus_tcp_init(&_tcp_slave, _tcp_buf[2], sizeof(_tcp_buf[2]), _tcp_buf[3], sizeof(_tcp_buf[3]));
+
+    _links[0] = (link_t){"RTU", &_rtu_master._ctx, &_rtu_slave._ctx};
+    _links[1] = (link_t){"TCP", &_tcp_master._ctx, &_tcp_slave._ctx};
+    for (int i = 0; i < 2; i++) {
+        agile_modbus_set_slave(_links[i].master, 1);
+        agile_modbus_set_slave(_links[i].slave, 1);
+    }
+}
+
+/**
+ * @brief   Hand the request in the send buffer of the master to the slave
+ * @return  >0: response length, copied to the read buffer of the master; <=0: no response
+ */
+static int transfer(const link_t *link, int req_len, const agile_modbus_slave_util_t *slave_util)
+{
+    memcpy(link->slave->read_buf, link->master->send_buf, req_len);
+    int rsp_len = agile_modbus_slave_handle(link->slave, req_len, 0, agile_modbus_slave_util_callback, slave_util, NULL);
+    if (rsp_len > 0)
+        memcpy(link->master->read_buf, link->slave->send_buf, rsp_len);
+
+    return rsp_len;
+}
+
+static int is_mapped(int addr)
+{
+    return (addr % MAP_STEP) < MAP_LEN;
+}
+
+static void check(int ok, const char *what, int slave, int addr)
+{
+    if (!ok) {
+        LOG_E("%s: %s slave, address %d", what, _slave_names[slave], addr);
+        _errors++;
+    }
+}
+
+static void check_registers(const uint16_t *dest, int addr, int nb, int slave)
+{
+    for (int i = 0; i < nb; i++) {
+        uint16_t expect = is_mapped(addr + i) ? _shadow_registers[addr + i] : 0;
+        if (dest[i] != expect) {
+            check(0, "register read back wrong", slave, addr + i);
+            return;
+        }
+    }
+}
+
+static void check_bits(const uint8_t *dest, int addr, int nb, int slave)
+{
+    for (int i = 0; i < nb; i++) {
+        uint8_t expect = is_mapped(addr + i) ? _shadow_bits[addr + i] : 0;
+        if (dest[i] != expect) {
+            check(0, "bit read back wrong", slave, addr + i);
+            return;
+        }
+    }
+}
+
+static void shadow_write_registers(int addr, int nb, const uint16_t *src)
+{
+    for (int i = 0; i < nb; i++) {
+        if (is_mapped(addr + i))
+            _shadow_registers[addr + i] = src[i];
+    }
+}
+
+static void shadow_write_bits(int addr, int nb, const uint8_t *src)
+{
+    for (int i = 0; i < nb; i++) {
+        if (is_mapped(addr + i))
+            _shadow_bits[addr + i] = src[i] ? 1 : 0;
+    }
+}
+
+static void storage_init(void)
+{
+    for (int i = 0; i < ADDR_CNT; i++) {
+        _registers[i] = (uint16_t)(i * 7919);
+        _bits[i] = (uint8_t)((i * 5) % 3 == 0);
+    }
+
+    memcpy(_shadow_registers, _registers, sizeof(_registers));
+    memcpy(_shadow_bits, _bits, sizeof(_bits));
+}
+
+/**
+ * @brief   Random request mix on one slave, every response is checked against the shadow copy
+ * @return  hash of the storage left behind
+ */
+static unsigned long run_mix(int slave, int cnt)
+{
+    const agile_modbus_slave_util_t *slave_util = &_slave_utils[slave];
+    uint16_t regs[AGILE_MODBUS_MAX_READ_REGISTERS];
+    uint8_t bits[ADDR_CNT];
+    unsigned long hash = 5381;
+
+    storage_init();
+    srand(1);
+    for (int it = 0; (it < cnt) && (_errors < 10); it++) {
+        const link_t *link = &_links[it & 1];
+        agile_modbus_t *master = link->master;
+        int addr = rand() % ADDR_CNT;
+        int nb = 1 + rand() % (ADDR_CNT - addr);
+        int nb_regs = (nb > AGILE_MODBUS_MAX_WR_WRITE_REGISTERS) ? AGILE_MODBUS_MAX_WR_WRITE_REGISTERS : nb;
+        int function = rand() % 9;
+        int req_len, rsp_len, rc;
+
+        for (int i = 0; i < nb; i++) {
+            regs[i % AGILE_MODBUS_MAX_READ_REGISTERS] = (uint16_t)rand();
+            bits[i] = rand() & 1;
+        }
+
+        switch (function) {
+        case 0:
+            req_len = agile_modbus_serialize_read_registers(master, addr, nb_regs);
+            rsp_len = transfer(link, req_len, slave_util);
+            rc = agile_modbus_deserialize_read_registers(master, rsp_len, regs);
+            check(rc == nb_regs, "read registers failed", slave, addr);
+            check_registers(regs, addr, nb_regs, slave);
+            break;
+
+        case 1:
+            req_len = agile_modbus_serialize_read_input_registers(master, addr, nb_regs);
+            rsp_len = transfer(link, req_len, slave_util);
+            rc = agile_modbus_deserialize_read_input_registers(master, rsp_len, regs);
+            check(rc == nb_regs, "read input registers failed", slave, addr);
+            check_registers(regs, addr, nb_regs, slave);
+            break;
+
+        case 2:
+            req_len = agile_modbus_serialize_read_bits(master, addr, nb);
+            rsp_len = transfer(link, req_len, slave_util);
+            rc = agile_modbus_deserialize_read_bits(master, rsp_len, bits);
+            check(rc == nb, "read bits failed", slave, addr);
+            check_bits(bits, addr, nb, slave);
+            break;
+
+        case 3:
+            req_len = agile_modbus_serialize_read_input_bits(master, addr, nb);
+            rsp_len = transfer(link, req_len, slave_util);
+            rc = agile_modbus_deserialize_read_input_bits(master, rsp_len, bits);
+            check(rc == nb, "read input bits failed", slave, addr);
+            check_bits(bits, addr, nb, slave);
+            break;
+
+        case 4:
+            req_len = agile_modbus_serialize_write_registers(master, addr, nb_regs, regs);
+            rsp_len = transfer(link, req_len, slave_util);
+            check(agile_modbus_deserialize_write_registers(master, rsp_len) >= 0, "write registers failed", slave, addr);
+            shadow_write_registers(addr, nb_regs, regs);
+            break;
+
+        case 5:
+            req_len = agile_modbus_serialize_write_bits(master, addr, nb, bits);
+            rsp_len = transfer(link, req_len, slave_util);
+            check(agile_modbus_deserialize_write_bits(master, rsp_len) >= 0, "write bits failed", slave, addr);
+            shadow_write_bits(addr, nb, bits);
+            break;
+
+        case 6:
+            if (rand() & 1) {
+                req_len = agile_modbus_serialize_write_register(master, addr, regs[0]);
+                rsp_len = transfer(link, req_len, slave_util);
+                check(agile_modbus_deserialize_write_register(master, rsp_len) >= 0, "write register failed", slave, addr);
+                shadow_write_registers(addr, 1, regs);
+            } else {
+                req_len = agile_modbus_serialize_write_bit(master, addr, bits[0]);
+                rsp_len = transfer(link, req_len, slave_util);
+                check(agile_modbus_deserialize_write_bit(master, rsp_len) >= 0, "write bit failed", slave, addr);
+                shadow_write_bits(addr, 1, bits);
+            }
+            break;
+
+        case 7: {
+            uint16_t and_mask = (uint16_t)rand();
+            uint16_t or_mask = (uint16_t)rand();
+            req_len = agile_modbus_serialize_mask_write_register(master, addr, and_mask, or_mask);
+            rsp_len = transfer(link, req_len, slave_util);
+            check(agile_modbus_deserialize_mask_write_register(master, rsp_len) >= 0, "mask write failed", slave, addr);
+            if (is_mapped(addr))
+                _shadow_registers[addr] = (_shadow_registers[addr] & and_mask) | (or_mask & ~and_mask);
+        } break;
+
+        default: {
+            int read_addr = rand() % (ADDR_CNT - nb_regs + 1);
+            req_len = agile_modbus_serialize_write_and_read_registers(master, addr, nb_regs, regs, read_addr, nb_regs);
+            rsp_len = transfer(link, req_len, slave_util);
+            shadow_write_registers(addr, nb_regs, regs);
+            rc = agile_modbus_deserialize_write_and_read_registers(master, rsp_len, regs);
+            check(rc == nb_regs, "write and read registers failed", slave, addr);
+            check_registers(regs, read_addr, nb_regs, slave);
+        } break;
+        }
+    }
+
+    for (int i = 0; i < ADDR_CNT; i++)
+        hash = hash * 33 + _registers[i] * 2 + _bits[i];
+
+    return hash;
+}
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+typedef struct {
+    const char *name;
+    int function;
+    int nb;
+    int objects; /**< Mapping objects covered from address 0 */
+} bench_req_t;
+
+static const bench_req_t _bench_reqs[] = {
+    {"read 125 registers", AGILE_MODBUS_FC_READ_HOLDING_REGISTERS, AGILE_MODBUS_MAX_READ_REGISTERS, 32},
+    {"write 123 registers", AGILE_MODBUS_FC_WRITE_MULTIPLE_REGISTERS, AGILE_MODBUS_MAX_WRITE_REGISTERS, 31},
+    {"read 160 coils", AGILE_MODBUS_FC_READ_COILS, ADDR_CNT, MAP_CNT},
+    {"write 160 coils", AGILE_MODBUS_FC_WRITE_MULTIPLE_COILS, ADDR_CNT, MAP_CNT},
+};
+
+static void bench(const link_t *link, const bench_req_t *req, int slave, int cnt)
+{
+    const agile_modbus_slave_util_t *slave_util = &_slave_utils[slave];
+    uint16_t regs[AGILE_MODBUS_MAX_READ_REGISTERS] = {0};
+    uint8_t bits[ADDR_CNT] = {0};
+    int req_len;
+
+    switch (req->function) {
+    case AGILE_MODBUS_FC_READ_HOLDING_REGISTERS:
+        req_len = agile_modbus_serialize_read_registers(link->master, 0, req->nb);
+        break;
+    case AGILE_MODBUS_FC_WRITE_MULTIPLE_REGISTERS:
+        req_len = agile_modbus_serialize_write_registers(link->master, 0, req->nb, regs);
+        break;
+    case AGILE_MODBUS_FC_READ_COILS:
+        req_len = agile_modbus_serialize_read_bits(link->master, 0, req->nb);
+        break;
+    default:
+        req_len = agile_modbus_serialize_write_bits(link->master, 0, req->nb, bits);
+        break;
+    }
+
+    _gets = 0;
+    _sets = 0;
+    double start = now_us();
+    for (int i = 0; i < cnt; i++) {
+        if (transfer(link, req_len, slave_util) <= 0) {
+            check(0, "no response", slave, 0);
+            return;
+        }
+    }
+    double elapsed = now_us() - start;
+
+    LOG_I("  %s %-6s %9.0f req/s, %5.1f get %5.1f set calls/req", link->name, _slave_names[slave], cnt / (elapsed / 1e6),
+          (double)_gets / cnt, (double)_sets / cnt);
+
+    if (slave_util->tab_registers[0].get_range != NULL) {
+        int is_read = (req->function == AGILE_MODBUS_FC_READ_HOLDING_REGISTERS) || (req->function == AGILE_MODBUS_FC_READ_COILS);
+        long expect_gets = is_read ? (long)req->objects * cnt : 0;
+        long expect_sets = is_read ? 0 : (long)req->objects * cnt;
+        check((_gets == expect_gets) && (_sets == expect_sets), "range interfaces not called once per object", slave, 0);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int cnt = (argc > 1) ? atoi(argv[1]) : BENCH_REQS;
+    unsigned long hashes[SLAVE_CNT];
+
+    if (cnt <= 0) {
+        LOG_E("Usage: ./SlaveUtilBench [requests]");
+        return -1;
+    }
+
+    for (int i = 0; i < SLAVE_CNT; i++) {
+        if (_slave_utils[i].maps_sorted && (agile_modbus_slave_util_check_maps(&_slave_utils[i]) != 0)) {
+            LOG_E("%s slave maps are not sorted.", _slave_names[i]);
+            return -1;
+        }
+    }
+
+    links_init();
+
+    for (int i = 0; i < SLAVE_CNT; i++) {
+        hashes[i] = run_mix(i, MIX_CNT);
+        LOG_I("%d mixed RTU and TCP requests on the %s slave, storage hash %08lx", MIX_CNT, _slave_names[i], hashes[i] & 0xFFFFFFFF);
+        check(hashes[i] == hashes[0], "storage differs from the linear slave", i, 0);
+    }
+
+    for (unsigned r = 0; r < sizeof(_bench_reqs) / sizeof(_bench_reqs[0]); r++) {
+        LOG_I("%s from address 0, %d mapping objects:", _bench_reqs[r].name, _bench_reqs[r].objects);
+        for (int l = 0; l < 2; l++) {
+            for (int i = 0; i < SLAVE_CNT; i++)
+                bench(&_links[l], &_bench_reqs[r], i, cnt);
+        }
+    }
+
+    if (_errors > 0) {
+        LOG_E("FAILED, %ld errors.", _errors);
+        return -1;
+    }
+
+    LOG_I("PASSED.");
+    return 0;
+}
@@ -0,0 +1,253 @@
+#include "agile_modbus.h"
+#include "agile_modbus_tcp_server.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DBG_ENABLE
+#define DBG_COLOR
+#define DBG_SECTION_NAME "tcp_server"
+#define DBG_LEVEL        DBG_LOG
+#include "dbg_log.h"
+
+#define MAX_MASTERS    64
+#define MAX_DEPTH      32
+#define READ_NB        60
+#define LOOP_WINDOW    1024
+#define REQ_STREAM_LEN (MAX_DEPTH * AGILE_MODBUS_TCP_PRESET_REQ_LENGTH)
+
+/* In memory stand-in of a socket: the server writes responses into a window the master drains */
+typedef struct {
+    uint8_t buf[LOOP_WINDOW];
+    int len;
+    int flushes;
+} loop_conn_t;
+
+typedef struct {
+    agile_modbus_tcp_t ctx_tcp;
+    uint8_t send_buf[AGILE_MODBUS_MAX_ADU_LENGTH];
+    uint8_t read_buf[AGILE_MODBUS_MAX_ADU_LENGTH];
+    uint8_t req[REQ_STREAM_LEN]; /**< Pipelined requests not taken by the server yet */
+    int req_len;
+    uint16_t next_tid;           /**< Transaction identifier of the next expected response */
+    int pending;                 /**< Requests without response */
+    loop_conn_t loop;
+    agile_modbus_tcp_server_conn_t *conn;
+} master_t;
+
+static agile_modbus_tcp_server_t _server;
+static agile_modbus_tcp_server_conn_t _conns[MAX_MASTERS];
+static master_t _masters[MAX_MASTERS + 1];
+static long _errors;
+
+static int loop_send(void *arg, const uint8_t *buf, int len)
+{
+    loop_conn_t *loop = (loop_conn_t *)arg;
+    if (len > LOOP_WINDOW - loop->len)
+        return -1;
+
+    memcpy(loop->buf + loop->len, buf, len);
+    loop->len += len;
+    return 0;
+}
+
+static int loop_send_space(void *arg)
+{
+    loop_conn_t *loop = (loop_conn_t *)arg;
+    return LOOP_WINDOW - loop->len;
+}
+
+static void loop_flush(void *arg)
+{
+    loop_conn_t *loop = (loop_conn_t *)arg;
+    loop->flushes++;
+}
+
+static const agile_modbus_tcp_server_ops_t loop_ops = {loop_send, loop_send_space, loop_flush};
+
+static int slave_callback(agile_modbus_t *ctx, struct agile_modbus_slave_info *slave_info, const void *data)
+{
+    (void)data;
+    if (slave_info->sft->function != AGILE_MODBUS_FC_READ_HOLDING_REGISTERS)
+        return -AGILE_MODBUS_EXCEPTION_ILLEGAL_FUNCTION;
+
+    /* The context is the first member of its connection */
+    agile_modbus_tcp_server_conn_t *conn = (agile_modbus_tcp_server_conn_t *)ctx;
+    int base = (int)(conn - _conns) * 1000;
+    for (int i = 0; i < slave_info->nb; i++)
+        agile_modbus_slave_register_set(ctx->send_buf + slave_info->send_index, i, (base + slave_info->address + i) & 0xFFFF);
+
+    return 0;
+}
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double da = *(const double *)a, db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+/* Check and remove the responses of one master, in transaction order */
+static void master_drain(master_t *m, int index)
+{
+    int offset = 0;
+
+    while (m->loop.len - offset >= 6) {
+        uint8_t *rsp = m->loop.buf + offset;
+        int frame_length = 6 + ((rsp[4] << 8) + rsp[5]);
+        if (m->loop.len - offset < frame_length)
+            break;
+
+        uint16_t tid = (rsp[0] << 8) + rsp[1];
+        int address = index * 7;
+        if ((tid != m->next_tid) || (rsp[7] != AGILE_MODBUS_FC_READ_HOLDING_REGISTERS) || (rsp[8] != READ_NB * 2)) {
+            _errors++;
+        } else {
+            for (int i = 0; i < READ_NB; i++) {
+                if (agile_modbus_slave_register_get(rsp + 9, i) != ((index * 1000 + address + i) & 0xFFFF)) {
+                    _errors++;
+                    break;
+                }
+            }
+        }
+
+        m->next_tid++;
+        m->pending--;
+        offset += frame_length;
+    }
+
+    m->loop.len -= offset;
+    memmove(m->loop.buf, m->loop.buf + offset, m->loop.len);
+}
+
+/* Feed the requests in chunks of random size, as TCP segments would split them */
+static int master_feed(master_t *m)
+{
+    while (m->req_len > 0) {
+        int chunk = 1 + rand() % m->req_len;
+        int taken = agile_modbus_tcp_server_input(m->conn, m->req, chunk);
+        if (taken < 0)
+            return -1;
+
+        m->req_len -= taken;
+        memmove(m->req, m->req + taken, m->req_len);
+        if (taken < chunk)
+            break;
+    }
+
+    return 0;
+}
+
+static int check_limits(int nb_masters)
+{
+    agile_modbus_tcp_server_stats_t stats;
+    uint8_t bad[12] = {0, 1, 0, 1, 0, 6, 1, 3, 0, 0, 0, 1};
+    int rc = 0;
+
+    /* Bounded pool */
+    if (agile_modbus_tcp_server_open(&_server, &_masters[nb_masters].loop) != NULL) {
+        LOG_E("Pool overflow accepted.");
+        rc = -1;
+    }
+
+    /* Invalid protocol identifier */
+    if (agile_modbus_tcp_server_input(_masters[0].conn, bad, sizeof(bad)) >= 0) {
+        LOG_E("Invalid MBAP header accepted.");
+        rc = -1;
+    }
+
+    agile_modbus_tcp_server_get_stats(&_server, &stats);
+    if ((stats.rejected != 1) || (stats.frame_errors != 1))
+        rc = -1;
+
+    return rc;
+}
+
+int main(int argc, char *argv[])
+{
+    int nb_masters = (argc > 1) ? atoi(argv[1]) : 16;
+    int depth = (argc > 2) ? atoi(argv[2]) : 8;
+    int rounds = (argc > 3) ? atoi(argv[3]) : 20000;
+
+    if ((nb_masters < 1) || (nb_masters > MAX_MASTERS) || (depth < 1) || (depth > MAX_DEPTH) || (rounds < 1)) {
+        LOG_E("Please enter TcpServerBench [masters 1-%d] [depth 1-%d] [rounds]!", MAX_MASTERS, MAX_DEPTH);
+        return -1;
+    }
+
+    srand(1);
+    agile_modbus_tcp_server_init(&_server, _conns, nb_masters, &loop_ops, slave_callback, NULL);
+    agile_modbus_tcp_server_set_slave(&_server, 1, 1);
+
+    for (int i = 0; i < nb_masters; i++) {
+        master_t *m = &_masters[i];
+        agile_modbus_tcp_init(&m->ctx_tcp, m->send_buf, sizeof(m->send_buf), m->read_buf, sizeof(m->read_buf));
+        agile_modbus_set_slave(&m->ctx_tcp._ctx, 1);
+        m->next_tid = 1;
+        m->conn = agile_modbus_tcp_server_open(&_server, &m->loop);
+    }
+
+    double *latency = malloc(sizeof(double) * rounds);
+    double start = now_us();
+    long requests = 0;
+
+    for (int r = 0; r < rounds; r++) {
+        double round_start = now_us();
+
+        /* Every master pipelines depth requests, then the responses are drained */
+        for (int i = 0; i < nb_masters; i++) {
+            master_t *m = &_masters[i];
+            for (int d = 0; d < depth; d++) {
+                int len = agile_modbus_serialize_read_registers(&m->ctx_tcp._ctx, i * 7, READ_NB);
+                memcpy(m->req + m->req_len, m->send_buf, len);
+                m->req_len += len;
+                m->pending++;
+            }
+        }
+
+        for (int busy = 1; busy;) {
+            busy = 0;
+            for (int i = 0; i < nb_masters; i++) {
+                master_t *m = &_masters[i];
+                if (master_feed(m) < 0)
+                    _errors++;
+                master_drain(m, i);
+                /* The window opened again */
+                if (agile_modbus_tcp_server_process(m->conn) < 0)
+                    _errors++;
+                master_drain(m, i);
+                if ((m->req_len > 0) || (m->pending > 0))
+                    busy = 1;
+            }
+        }
+
+        latency[r] = now_us() - round_start;
+        requests += nb_masters * depth;
+    }
+
+    double elapsed = now_us() - start;
+    agile_modbus_tcp_server_stats_t stats;
+    agile_modbus_tcp_server_get_stats(&_server, &stats);
+    qsort(latency, rounds, sizeof(double), cmp_double);
+
+    LOG_I("%d masters, %d pipelined requests of %d registers, %d rounds", nb_masters, depth, READ_NB, rounds);
+    LOG_I("Throughput: %.0f req/s", requests / (elapsed / 1e6));
+    LOG_I("Round latency: p50 %.2f us, p99 %.2f us, max %.2f us", latency[rounds / 2], latency[rounds * 99 / 100], latency[rounds - 1]);
+    LOG_I("Requests %u, responses %u, deferred %u", (unsigned)stats.requests, (unsigned)stats.responses, (unsigned)stats.deferred);
+
+    if ((check_limits(nb_masters) < 0) || (_errors > 0) || (stats.responses != (uint32_t)requests)) {
+        LOG_E("FAILED, %ld errors.", _errors);
+        free(latency);
+        return -1;
+    }
+
+    LOG_I("PASSED.");
+    free(latency);
+    return 0;
+}
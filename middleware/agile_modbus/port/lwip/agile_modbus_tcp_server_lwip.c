@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <string.h>
+#include "agile_modbus_tcp_server_lwip.h"
+#include "lwip/opt.h"
+
+static int conn_send(void *arg, const uint8_t *buf, int len);
+static int conn_send_space(void *arg);
+static void conn_flush(void *arg);
+
+static const agile_modbus_tcp_server_ops_t lwip_ops = {
+    conn_send,
+    conn_send_space,
+    conn_flush,
+};
+
+static int conn_send(void *arg, const uint8_t *buf, int len)
+{
+    agile_modbus_tcp_server_lwip_conn_t *lwip_conn = (agile_modbus_tcp_server_lwip_conn_t *)arg;
+
+    /* the response buffer is shared by all connections */
+    if (altcp_write(lwip_conn->pcb, buf, (u16_t)len, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+        return -1;
+    }
+    return 0;
+}
+
+static int conn_send_space(void *arg)
+{
+    agile_modbus_tcp_server_lwip_conn_t *lwip_conn = (agile_modbus_tcp_server_lwip_conn_t *)arg;
+
+    /* a response may take two segments */
+    if (altcp_sndqueuelen(lwip_conn->pcb) + 2U > TCP_SND_QUEUELEN) {
+        return 0;
+    }
+    return altcp_sndbuf(lwip_conn->pcb);
+}
+
+static void conn_flush(void *arg)
+{
+    agile_modbus_tcp_server_lwip_conn_t *lwip_conn = (agile_modbus_tcp_server_lwip_conn_t *)arg;
+
+    altcp_output(lwip_conn->pcb);
+}
+
+static err_t conn_close(agile_modbus_tcp_server_lwip_conn_t *lwip_conn, bool abort)
+{
+    struct altcp_pcb *pcb = lwip_conn->pcb;
+    err_t err = ERR_OK;
+
+    lwip_conn->pcb = NULL;
+    if (lwip_conn->pending != NULL) {
+        pbuf_free(lwip_conn->pending);
+        lwip_conn->pending = NULL;
+    }
+    agile_modbus_tcp_server_close(lwip_conn->conn);
+
+    if (pcb != NULL) {
+        altcp_arg(pcb, NULL);
+        altcp_recv(pcb, NULL);
+        altcp_sent(pcb, NULL);
+        altcp_err(pcb, NULL);
+        altcp_poll(pcb, NULL, 0);
+        if (abort || (altcp_close(pcb) != ERR_OK)) {
+            altcp_abort(pcb);
+            err = ERR_ABRT;
+        }
+    }
+    return err;
+}
+
+/* hand pending data to the server, the receive window only reopens for the bytes it takes */
+static err_t conn_feed(agile_modbus_tcp_server_lwip_conn_t *lwip_conn)
+{
+    while (lwip_conn->pending != NULL) {
+        struct pbuf *q = lwip_conn->pending;
+        int len = q->len - lwip_conn->pending_offset;
+        int taken = agile_modbus_tcp_server_input(lwip_conn->conn, (const uint8_t *)q->payload + lwip_conn->pending_offset, len);
+
+        if (taken < 0) {
+            return conn_close(lwip_conn, true);
+        }
+        if (taken > 0) {
+            altcp_recved(lwip_conn->pcb, (u16_t)taken);
+        }
+        if (taken < len) {
+            lwip_conn->pending_offset += (u16_t)taken;
+            break;
+        }
+
+        lwip_conn->pending_offset = 0;
+        lwip_conn->pending = pbuf_dechain(q);
+        pbuf_free(q);
+    }
+    return ERR_OK;
+}
+
+static err_t conn_recv(void *arg, struct altcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+    agile_modbus_tcp_server_lwip_conn_t *lwip_conn = (agile_modbus_tcp_server_lwip_conn_t *)arg;
+    (void)pcb;
+
+    if (p == NULL) {
+        /* closed by the client */
+        return conn_close(lwip_conn, false);
+    }
+    if (err != ERR_OK) {
+        pbuf_free(p);
+        return err;
+    }
+
+    if (lwip_conn->pending != NULL) {
+        pbuf_cat(lwip_conn->pending, p);
+    } else {
+        lwip_conn->pending = p;
+        lwip_conn->pending_offset = 0;
+    }
+    return conn_feed(lwip_conn);
+}
+
+static err_t conn_sent(void *arg, struct altcp_pcb *pcb, u16_t len)
+{
+    agile_modbus_tcp_server_lwip_conn_t *lwip_conn = (agile_modbus_tcp_server_lwip_conn_t *)arg;
+    (void)pcb;
+    (void)len;
+
+    /* requests deferred for send space */
+    if (agile_modbus_tcp_server_process(lwip_conn->conn) < 0) {
+        return conn_close(lwip_conn, true);
+    }
+    return conn_feed(lwip_conn);
+}
+
+static err_t conn_poll(void *arg, struct altcp_pcb *pcb)
+{
+    agile_modbus_tcp_server_lwip_conn_t *lwip_conn = (agile_modbus_tcp_server_lwip_conn_t *)arg;
+
+    if (agile_modbus_tcp_server_poll(lwip_conn->conn) < 0) {
+        return conn_close(lwip_conn, false);
+    }
+    return conn_sent(arg, pcb, 0);
+}
+
+static void conn_err(void *arg, err_t err)
+{
+    agile_modbus_tcp_server_lwip_conn_t *lwip_conn = (agile_modbus_tcp_server_lwip_conn_t *)arg;
+    (void)err;
+
+    /* the pcb is already freed */
+    lwip_conn->pcb = NULL;
+    conn_close(lwip_conn, false);
+}
+
+static err_t server_accept(void *arg, struct altcp_pcb *newpcb, err_t err)
+{
+    agile_modbus_tcp_server_lwip_t *lwip_server = (agile_modbus_tcp_server_lwip_t *)arg;
+    agile_modbus_tcp_server_lwip_conn_t *lwip_conn;
+    agile_modbus_tcp_server_conn_t *conn;
+
+    if ((err != ERR_OK) || (newpcb == NULL)) {
+        return ERR_VAL;
+    }
+
+    conn = agile_modbus_tcp_server_open(&lwip_server->server, newpcb);
+    if (conn == NULL) {
+        altcp_abort(newpcb);
+        return ERR_ABRT;
+    }
+
+    lwip_conn = &lwip_server->lwip_conns[conn - lwip_server->server.conns];
+    lwip_conn->pcb = newpcb;
+    lwip_conn->pending = NULL;
+    lwip_conn->pending_offset = 0;
+    conn->arg = lwip_conn;
+
+    altcp_arg(newpcb, lwip_conn);
+    altcp_recv(newpcb, conn_recv);
+    altcp_sent(newpcb, conn_sent);
+    altcp_err(newpcb, conn_err);
+    altcp_poll(newpcb, conn_poll, AGILE_MODBUS_TCP_SERVER_LWIP_POLL_INTERVAL);
+    /* responses are complete messages, do not wait for the ACK of the previous one */
+    altcp_nagle_disable(newpcb);
+
+    return ERR_OK;
+}
+
+err_t agile_modbus_tcp_server_lwip_init(agile_modbus_tcp_server_lwip_t *lwip_server, agile_modbus_tcp_server_conn_t *conns,
+                                        agile_modbus_tcp_server_lwip_conn_t *lwip_conns, int nb_conns,
+                                        agile_modbus_slave_callback_t slave_cb, const void *slave_data)
+{
+    if ((lwip_server == NULL) || (lwip_conns == NULL)) {
+        return ERR_ARG;
+    }
+    if (agile_modbus_tcp_server_init(&lwip_server->server, conns, nb_conns, &lwip_ops, slave_cb, slave_data) < 0) {
+        return ERR_ARG;
+    }
+
+    memset(lwip_conns, 0, sizeof(agile_modbus_tcp_server_lwip_conn_t) * nb_conns);
+    for (int i = 0; i < nb_conns; i++) {
+        lwip_conns[i].owner = lwip_server;
+        lwip_conns[i].conn = &conns[i];
+    }
+    lwip_server->lwip_conns = lwip_conns;
+    lwip_server->listen_pcb = NULL;
+
+    return ERR_OK;
+}
+
+err_t agile_modbus_tcp_server_lwip_start(agile_modbus_tcp_server_lwip_t *lwip_server, u16_t port)
+{
+    struct altcp_pcb *pcb;
+    struct altcp_pcb *listen_pcb;
+    err_t err;
+
+    pcb = altcp_new_ip_type(NULL, IPADDR_TYPE_ANY);
+    if (pcb == NULL) {
+        return ERR_MEM;
+    }
+
+    err = altcp_bind(pcb, IP_ANY_TYPE, port);
+    if (err != ERR_OK) {
+        altcp_close(pcb);
+        return err;
+    }
+
+    listen_pcb = altcp_listen(pcb);
+    if (listen_pcb == NULL) {
+        altcp_close(pcb);
+        return ERR_MEM;
+    }
+
+    lwip_server->listen_pcb = listen_pcb;
+    altcp_arg(listen_pcb, lwip_server);
+    altcp_accept(listen_pcb, server_accept);
+
+    return ERR_OK;
+}
+
+void agile_modbus_tcp_server_lwip_stop(agile_modbus_tcp_server_lwip_t *lwip_server)
+{
+    if (lwip_server->listen_pcb != NULL) {
+        altcp_arg(lwip_server->listen_pcb, NULL);
+        altcp_accept(lwip_server->listen_pcb, NULL);
+        altcp_close(lwip_server->listen_pcb);
+        lwip_server->listen_pcb = NULL;
+    }
+
+    for (int i = 0; i < lwip_server->server.nb_conns; i++) {
+        if (lwip_server->lwip_conns[i].pcb != NULL) {
+            conn_close(&lwip_server->lwip_conns[i], false);
+        }
+    }
+}
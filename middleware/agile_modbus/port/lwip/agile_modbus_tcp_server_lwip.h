@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef AGILE_MODBUS_TCP_SERVER_LWIP_H
+#define AGILE_MODBUS_TCP_SERVER_LWIP_H
+
+#include "agile_modbus_tcp_server.h"
+#include "lwip/altcp.h"
+
+/**
+ * @brief Interval of the idle timeout and retry poll, in units of the lwIP coarse timer (500ms)
+ */
+#ifndef AGILE_MODBUS_TCP_SERVER_LWIP_POLL_INTERVAL
+#define AGILE_MODBUS_TCP_SERVER_LWIP_POLL_INTERVAL (2U)
+#endif
+
+struct agile_modbus_tcp_server_lwip;
+
+/**
+ * @brief lwIP state of one connection
+ */
+typedef struct agile_modbus_tcp_server_lwip_conn {
+    struct agile_modbus_tcp_server_lwip *owner;
+    agile_modbus_tcp_server_conn_t *conn;   /**< Server connection with the same index */
+    struct altcp_pcb *pcb;
+    struct pbuf *pending;                   /**< Received data not taken by the server yet */
+    u16_t pending_offset;                   /**< Bytes of the first pending pbuf already taken */
+} agile_modbus_tcp_server_lwip_conn_t;
+
+/**
+ * @brief Modbus TCP server on the lwIP raw API, all calls must come from the lwIP core context
+ */
+typedef struct agile_modbus_tcp_server_lwip {
+    agile_modbus_tcp_server_t server;
+    agile_modbus_tcp_server_lwip_conn_t *lwip_conns;
+    struct altcp_pcb *listen_pcb;
+} agile_modbus_tcp_server_lwip_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize the server
+ *
+ * @param [out] lwip_server server
+ * @param [in] conns server connection pool
+ * @param [in] lwip_conns lwIP connection states, one per server connection
+ * @param [in] nb_conns number of connections, the maximum of simultaneous clients
+ * @param [in] slave_cb slave callback function, e.g. agile_modbus_slave_util_callback
+ * @param [in] slave_data slave callback function private data
+ * @retval ERR_ARG invalid argument
+ * @retval ERR_OK
+ */
+err_t agile_modbus_tcp_server_lwip_init(agile_modbus_tcp_server_lwip_t *lwip_server, agile_modbus_tcp_server_conn_t *conns,
+                                        agile_modbus_tcp_server_lwip_conn_t *lwip_conns, int nb_conns,
+                                        agile_modbus_slave_callback_t slave_cb, const void *slave_data);
+
+/**
+ * @brief Listen on a port
+ *
+ * @param [in] lwip_server server
+ * @param [in] port TCP port, 502 for Modbus
+ * @retval ERR_MEM no pcb
+ * @retval ERR_OK
+ */
+err_t agile_modbus_tcp_server_lwip_start(agile_modbus_tcp_server_lwip_t *lwip_server, u16_t port);
+
+/**
+ * @brief Stop listening and close every connection
+ *
+ * @param [in] lwip_server server
+ */
+void agile_modbus_tcp_server_lwip_stop(agile_modbus_tcp_server_lwip_t *lwip_server);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AGILE_MODBUS_TCP_SERVER_LWIP_H */
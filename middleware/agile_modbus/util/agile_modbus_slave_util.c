@@ -28,23 +28,254 @@
  */
 
 /**
- * @brief   Get the mapping object from the mapping object array according to the register address
+ * @brief   Get the first mapping object overlapping an address range
  * @param   maps mapping object array
  * @param   nb_maps number of arrays
- * @param   address register address
- * @return  !=NULL: mapping object; =NULL: failure
+ * @param   sorted !=0: the array is sorted by address without overlap and is binary searched
+ * @param   address first register address, moved to the first address covered by the returned object
+ * @param   end_address register address after the range
+ * @return  !=NULL: mapping object; =NULL: no more object in the range
  */
-static const agile_modbus_slave_util_map_t *get_map_by_addr(const agile_modbus_slave_util_map_t *maps, int nb_maps, int address)
+static const agile_modbus_slave_util_map_t *get_map_by_range(const agile_modbus_slave_util_map_t *maps, int nb_maps, int sorted,
+                                                             int *address, int end_address)
 {
-    for (int i = 0; i < nb_maps; i++) {
-        const agile_modbus_slave_util_map_t *map = &maps[i];
-        if (address >= map->start_addr && address <= map->end_addr)
-            return map;
+    if (*address >= end_address)
+        return NULL;
+
+    if (sorted) {
+        int low = 0;
+        int high = nb_maps;
+
+        /* first object ending at or after the address */
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            if (maps[mid].end_addr < *address)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+
+        if (low >= nb_maps || maps[low].start_addr >= end_address)
+            return NULL;
+
+        if (*address < maps[low].start_addr)
+            *address = maps[low].start_addr;
+
+        return &maps[low];
+    }
+
+    for (; *address < end_address; (*address)++) {
+        for (int i = 0; i < nb_maps; i++) {
+            const agile_modbus_slave_util_map_t *map = &maps[i];
+            if (*address >= map->start_addr && *address <= map->end_addr)
+                return map;
+        }
     }
 
     return NULL;
 }
 
+/**
+ * @brief   Copy register data from the mapping buffer to the response
+ * @param   dst response data area
+ * @param   dst_index index of the first register in the response
+ * @param   map_buf mapping buffer, one byte per bit or one uint16_t per register
+ * @param   index index of the first register in the mapping buffer
+ * @param   len number of registers
+ * @param   is_bit !=0: coils or discrete inputs
+ */
+static void map_buf_to_pdu(uint8_t *dst, int dst_index, const uint8_t *map_buf, int index, int len, int is_bit)
+{
+    if (is_bit) {
+        for (int j = 0; j < len; j++) {
+            agile_modbus_slave_io_set(dst, dst_index + j, map_buf[index + j]);
+        }
+    } else {
+        const uint16_t *ptr = (const uint16_t *)map_buf;
+        for (int j = 0; j < len; j++) {
+            agile_modbus_slave_register_set(dst, dst_index + j, ptr[index + j]);
+        }
+    }
+}
+
+/**
+ * @brief   Copy register data from the request to the mapping buffer
+ * @param   map_buf mapping buffer, one byte per bit or one uint16_t per register
+ * @param   index index of the first register in the mapping buffer
+ * @param   src request data area
+ * @param   src_index index of the first register in the request
+ * @param   len number of registers
+ * @param   is_bit !=0: coils
+ */
+static void pdu_to_map_buf(uint8_t *map_buf, int index, uint8_t *src, int src_index, int len, int is_bit)
+{
+    if (is_bit) {
+        for (int j = 0; j < len; j++) {
+            map_buf[index + j] = agile_modbus_slave_io_get(src, src_index + j);
+        }
+    } else {
+        uint16_t *ptr = (uint16_t *)map_buf;
+        for (int j = 0; j < len; j++) {
+            ptr[index + j] = agile_modbus_slave_register_get(src, src_index + j);
+        }
+    }
+}
+
+/**
+ * @brief   Get the whole register data of a mapping object through the get interface
+ * @param   map mapping object
+ * @param   map_buf mapping buffer
+ * @param   is_bit !=0: coils or discrete inputs
+ */
+static void map_get_all(const agile_modbus_slave_util_map_t *map, uint8_t *map_buf, int is_bit)
+{
+    int map_size = (map->end_addr - map->start_addr + 1) * (is_bit ? 1 : 2);
+
+    if (map_size > AGILE_MODBUS_MAX_PDU_LENGTH)
+        map_size = AGILE_MODBUS_MAX_PDU_LENGTH;
+
+    memset(map_buf, 0, map_size);
+    if (map->get)
+        map->get(map_buf, AGILE_MODBUS_MAX_PDU_LENGTH);
+}
+
+/**
+ * @brief   Read the registers of one mapping object into the response
+ * @param   map mapping object
+ * @param   index index of the first register in the mapping object
+ * @param   len number of registers
+ * @param   dst response data area
+ * @param   dst_index index of the first register in the response
+ * @param   is_bit !=0: coils or discrete inputs
+ * @param   map_buf mapping buffer
+ * @return  =0: normal; <0: exception returned by get_range
+ */
+static int map_read(const agile_modbus_slave_util_map_t *map, int index, int len, uint8_t *dst, int dst_index, int is_bit, uint8_t *map_buf)
+{
+    if (map->get_range) {
+        int max_len = AGILE_MODBUS_MAX_PDU_LENGTH / (is_bit ? 1 : 2);
+
+        while (len > 0) {
+            int chunk = (len > max_len) ? max_len : len;
+            int rc = map->get_range(index, chunk, map_buf, AGILE_MODBUS_MAX_PDU_LENGTH);
+            if (rc < 0)
+                return rc;
+
+            map_buf_to_pdu(dst, dst_index, map_buf, 0, chunk, is_bit);
+            index += chunk;
+            dst_index += chunk;
+            len -= chunk;
+        }
+    } else if (map->get) {
+        map_get_all(map, map_buf, is_bit);
+        map_buf_to_pdu(dst, dst_index, map_buf, index, len, is_bit);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief   Write the registers of one mapping object from the request
+ * @param   map mapping object
+ * @param   index index of the first register in the mapping object
+ * @param   len number of registers
+ * @param   src request data area
+ * @param   src_index index of the first register in the request
+ * @param   is_bit !=0: coils
+ * @param   map_buf mapping buffer
+ * @return  =0: normal; !=0: value returned by set or set_range
+ */
+static int map_write(const agile_modbus_slave_util_map_t *map, int index, int len, uint8_t *src, int src_index, int is_bit, uint8_t *map_buf)
+{
+    if (map->set_range) {
+        int max_len = AGILE_MODBUS_MAX_PDU_LENGTH / (is_bit ? 1 : 2);
+
+        while (len > 0) {
+            int chunk = (len > max_len) ? max_len : len;
+
+            pdu_to_map_buf(map_buf, 0, src, src_index, chunk, is_bit);
+            int rc = map->set_range(index, chunk, map_buf, AGILE_MODBUS_MAX_PDU_LENGTH);
+            if (rc != 0)
+                return rc;
+
+            index += chunk;
+            src_index += chunk;
+            len -= chunk;
+        }
+    } else if (map->set) {
+        map_get_all(map, map_buf, is_bit);
+        pdu_to_map_buf(map_buf, index, src, src_index, len, is_bit);
+
+        int rc = map->set(index, len, map_buf, AGILE_MODBUS_MAX_PDU_LENGTH);
+        if (rc != 0)
+            return rc;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief   Read a register range over all the mapping objects it covers
+ * @param   maps mapping object array
+ * @param   nb_maps number of arrays
+ * @param   sorted !=0: the array is sorted by address without overlap
+ * @param   address first register address
+ * @param   nb number of registers
+ * @param   dst response data area
+ * @param   is_bit !=0: coils or discrete inputs
+ * @return  =0: normal; <0: exception
+ */
+static int read_range(const agile_modbus_slave_util_map_t *maps, int nb_maps, int sorted, int address, int nb, uint8_t *dst, int is_bit)
+{
+    uint8_t map_buf[AGILE_MODBUS_MAX_PDU_LENGTH];
+    const agile_modbus_slave_util_map_t *map;
+    int end_address = address + nb;
+    int now_address = address;
+
+    while ((map = get_map_by_range(maps, nb_maps, sorted, &now_address, end_address)) != NULL) {
+        int len = ((map->end_addr < end_address) ? map->end_addr + 1 : end_address) - now_address;
+
+        int rc = map_read(map, now_address - map->start_addr, len, dst, now_address - address, is_bit, map_buf);
+        if (rc < 0)
+            return rc;
+
+        now_address += len;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief   Write a register range over all the mapping objects it covers
+ * @param   maps mapping object array
+ * @param   nb_maps number of arrays
+ * @param   sorted !=0: the array is sorted by address without overlap
+ * @param   address first register address
+ * @param   nb number of registers
+ * @param   src request data area
+ * @param   is_bit !=0: coils
+ * @return  =0: normal; !=0: value returned by set or set_range
+ */
+static int write_range(const agile_modbus_slave_util_map_t *maps, int nb_maps, int sorted, int address, int nb, uint8_t *src, int is_bit)
+{
+    uint8_t map_buf[AGILE_MODBUS_MAX_PDU_LENGTH];
+    const agile_modbus_slave_util_map_t *map;
+    int end_address = address + nb;
+    int now_address = address;
+
+    while ((map = get_map_by_range(maps, nb_maps, sorted, &now_address, end_address)) != NULL) {
+        int len = ((map->end_addr < end_address) ? map->end_addr + 1 : end_address) - now_address;
+
+        int rc = map_write(map, now_address - map->start_addr, len, src, now_address - address, is_bit, map_buf);
+        if (rc != 0)
+            return rc;
+
+        now_address += len;
+    }
+
+    return 0;
+}
+
 /**
  * @brief   read register
  * @param   ctx modbus handle
@@ -57,23 +288,22 @@ static const agile_modbus_slave_util_map_t *get_map_by_addr(const agile_modbus_s
  */
 static int read_registers(agile_modbus_t *ctx, struct agile_modbus_slave_info *slave_info, const agile_modbus_slave_util_t *slave_util)
 {
-    uint8_t map_buf[AGILE_MODBUS_MAX_PDU_LENGTH];
     int function = slave_info->sft->function;
-    int address = slave_info->address;
-    int nb = slave_info->nb;
-    int send_index = slave_info->send_index;
     const agile_modbus_slave_util_map_t *maps = NULL;
     int nb_maps = 0;
+    int is_bit = 0;
 
     switch (function) {
     case AGILE_MODBUS_FC_READ_COILS: {
         maps = slave_util->tab_bits;
         nb_maps = slave_util->nb_bits;
+        is_bit = 1;
     } break;
 
     case AGILE_MODBUS_FC_READ_DISCRETE_INPUTS: {
         maps = slave_util->tab_input_bits;
         nb_maps = slave_util->nb_input_bits;
+        is_bit = 1;
     } break;
 
     case AGILE_MODBUS_FC_READ_HOLDING_REGISTERS: {
@@ -93,39 +323,8 @@ static int read_registers(agile_modbus_t *ctx, struct agile_modbus_slave_info *s
     if (maps == NULL)
         return 0;
 
-    for (int now_address = address, i = 0; now_address < address + nb; now_address++, i++) {
-        const agile_modbus_slave_util_map_t *map = get_map_by_addr(maps, nb_maps, now_address);
-        if (map == NULL)
-            continue;
-
-        int map_len = map->end_addr - now_address + 1;
-        if (map->get) {
-            memset(map_buf, 0, sizeof(map_buf));
-            map->get(map_buf, sizeof(map_buf));
-            int index = now_address - map->start_addr;
-            int need_len = address + nb - now_address;
-            if (need_len > map_len) {
-                need_len = map_len;
-            }
-
-            if (function == AGILE_MODBUS_FC_READ_COILS || function == AGILE_MODBUS_FC_READ_DISCRETE_INPUTS) {
-                uint8_t *ptr = map_buf;
-                for (int j = 0; j < need_len; j++) {
-                    agile_modbus_slave_io_set(ctx->send_buf + send_index, i + j, ptr[index + j]);
-                }
-            } else {
-                uint16_t *ptr = (uint16_t *)map_buf;
-                for (int j = 0; j < need_len; j++) {
-                    agile_modbus_slave_register_set(ctx->send_buf + send_index, i + j, ptr[index + j]);
-                }
-            }
-        }
-
-        now_address += map_len - 1;
-        i += map_len - 1;
-    }
-
-    return 0;
+    return read_range(maps, nb_maps, slave_util->maps_sorted, slave_info->address, slave_info->nb,
+                      ctx->send_buf + slave_info->send_index, is_bit);
 }
 
 /**
@@ -140,22 +339,25 @@ static int read_registers(agile_modbus_t *ctx, struct agile_modbus_slave_info *s
  */
 static int write_registers(agile_modbus_t *ctx, struct agile_modbus_slave_info *slave_info, const agile_modbus_slave_util_t *slave_util)
 {
-    uint8_t map_buf[AGILE_MODBUS_MAX_PDU_LENGTH];
     int function = slave_info->sft->function;
-    int address = slave_info->address;
-    int nb = 0;
     const agile_modbus_slave_util_map_t *maps = NULL;
     int nb_maps = 0;
+    int nb = slave_info->nb;
+    uint8_t *src = slave_info->buf;
+    uint8_t single[2];
+    int is_bit = 0;
     (void)ctx;
     switch (function) {
     case AGILE_MODBUS_FC_WRITE_SINGLE_COIL:
     case AGILE_MODBUS_FC_WRITE_MULTIPLE_COILS: {
         maps = slave_util->tab_bits;
         nb_maps = slave_util->nb_bits;
+        is_bit = 1;
         if (function == AGILE_MODBUS_FC_WRITE_SINGLE_COIL) {
+            int data = *((int *)slave_info->buf);
+            single[0] = data ? 1 : 0;
+            src = single;
             nb = 1;
-        } else {
-            nb = slave_info->nb;
         }
     } break;
 
@@ -164,9 +366,10 @@ static int write_registers(agile_modbus_t *ctx, struct agile_modbus_slave_info *
         maps = slave_util->tab_registers;
         nb_maps = slave_util->nb_registers;
         if (function == AGILE_MODBUS_FC_WRITE_SINGLE_REGISTER) {
+            int data = *((int *)slave_info->buf);
+            agile_modbus_slave_register_set(single, 0, data);
+            src = single;
             nb = 1;
-        } else {
-            nb = slave_info->nb;
         }
     } break;
 
@@ -177,58 +380,7 @@ static int write_registers(agile_modbus_t *ctx, struct agile_modbus_slave_info *
     if (maps == NULL)
         return 0;
 
-    for (int now_address = address, i = 0; now_address < address + nb; now_address++, i++) {
-        const agile_modbus_slave_util_map_t *map = get_map_by_addr(maps, nb_maps, now_address);
-        if (map == NULL)
-            continue;
-
-        int map_len = map->end_addr - now_address + 1;
-        if (map->set) {
-            memset(map_buf, 0, sizeof(map_buf));
-            if (map->get) {
-                map->get(map_buf, sizeof(map_buf));
-            }
-
-            int index = now_address - map->start_addr;
-            int need_len = address + nb - now_address;
-            if (need_len > map_len) {
-                need_len = map_len;
-            }
-
-            if (function == AGILE_MODBUS_FC_WRITE_SINGLE_COIL || function == AGILE_MODBUS_FC_WRITE_MULTIPLE_COILS) {
-                uint8_t *ptr = map_buf;
-                if (function == AGILE_MODBUS_FC_WRITE_SINGLE_COIL) {
-                    int data = *((int *)slave_info->buf);
-                    ptr[index] = data;
-                } else {
-                    for (int j = 0; j < need_len; j++) {
-                        uint8_t data = agile_modbus_slave_io_get(slave_info->buf, i + j);
-                        ptr[index + j] = data;
-                    }
-                }
-            } else {
-                uint16_t *ptr = (uint16_t *)map_buf;
-                if (function == AGILE_MODBUS_FC_WRITE_SINGLE_REGISTER) {
-                    int data = *((int *)slave_info->buf);
-                    ptr[index] = data;
-                } else {
-                    for (int j = 0; j < need_len; j++) {
-                        uint16_t data = agile_modbus_slave_register_get(slave_info->buf, i + j);
-                        ptr[index + j] = data;
-                    }
-                }
-            }
-
-            int rc = map->set(index, need_len, map_buf, sizeof(map_buf));
-            if (rc != 0)
-                return rc;
-        }
-
-        now_address += map_len - 1;
-        i += map_len - 1;
-    }
-
-    return 0;
+    return write_range(maps, nb_maps, slave_util->maps_sorted, slave_info->address, nb, src, is_bit);
 }
 
 /**
@@ -243,7 +395,6 @@ static int write_registers(agile_modbus_t *ctx, struct agile_modbus_slave_info *
  */
 static int mask_write_register(agile_modbus_t *ctx, struct agile_modbus_slave_info *slave_info, const agile_modbus_slave_util_t *slave_util)
 {
-    uint8_t map_buf[AGILE_MODBUS_MAX_PDU_LENGTH];
     int address = slave_info->address;
     const agile_modbus_slave_util_map_t *maps = slave_util->tab_registers;
     int nb_maps = slave_util->nb_registers;
@@ -251,22 +402,34 @@ static int mask_write_register(agile_modbus_t *ctx, struct agile_modbus_slave_in
     if (maps == NULL)
         return 0;
 
-    const agile_modbus_slave_util_map_t *map = get_map_by_addr(maps, nb_maps, address);
+    int now_address = address;
+    const agile_modbus_slave_util_map_t *map = get_map_by_range(maps, nb_maps, slave_util->maps_sorted, &now_address, address + 1);
     if (map == NULL)
         return 0;
 
-    if (map->set) {
-        memset(map_buf, 0, sizeof(map_buf));
-        if (map->get) {
-            map->get(map_buf, sizeof(map_buf));
-        }
+    uint8_t map_buf[AGILE_MODBUS_MAX_PDU_LENGTH];
+    int index = address - map->start_addr;
+    uint16_t and = (slave_info->buf[0] << 8) + slave_info->buf[1];
+    uint16_t or = (slave_info->buf[2] << 8) + slave_info->buf[3];
+
+    if (map->set_range) {
+        uint8_t reg[2] = {0};
+        int rc = map_read(map, index, 1, reg, 0, 0, map_buf);
+        if (rc < 0)
+            return rc;
+
+        uint16_t data = agile_modbus_slave_register_get(reg, 0);
+        data = (data & and) | (or &(~and));
+        agile_modbus_slave_register_set(reg, 0, data);
+
+        rc = map_write(map, index, 1, reg, 0, 0, map_buf);
+        if (rc != 0)
+            return rc;
+    } else if (map->set) {
+        map_get_all(map, map_buf, 0);
 
-        int index = address - map->start_addr;
         uint16_t *ptr = (uint16_t *)map_buf;
         uint16_t data = ptr[index];
-        uint16_t and = (slave_info->buf[0] << 8) + slave_info->buf[1];
-        uint16_t or = (slave_info->buf[2] << 8) + slave_info->buf[3];
-
         data = (data & and) | (or &(~and));
         ptr[index] = data;
 
@@ -290,13 +453,10 @@ static int mask_write_register(agile_modbus_t *ctx, struct agile_modbus_slave_in
  */
 static int write_read_registers(agile_modbus_t *ctx, struct agile_modbus_slave_info *slave_info, const agile_modbus_slave_util_t *slave_util)
 {
-    uint8_t map_buf[AGILE_MODBUS_MAX_PDU_LENGTH];
     int address = slave_info->address;
     int nb = (slave_info->buf[0] << 8) + slave_info->buf[1];
     int address_write = (slave_info->buf[2] << 8) + slave_info->buf[3];
     int nb_write = (slave_info->buf[4] << 8) + slave_info->buf[5];
-    int send_index = slave_info->send_index;
-
     const agile_modbus_slave_util_map_t *maps = slave_util->tab_registers;
     int nb_maps = slave_util->nb_registers;
 
@@ -304,66 +464,12 @@ static int write_read_registers(agile_modbus_t *ctx, struct agile_modbus_slave_i
         return 0;
 
     /* Write first. 7 is the offset of the first values to write */
-    for (int now_address = address_write, i = 0; now_address < address_write + nb_write; now_address++, i++) {
-        const agile_modbus_slave_util_map_t *map = get_map_by_addr(maps, nb_maps, now_address);
-        if (map == NULL)
-            continue;
-
-        int map_len = map->end_addr - now_address + 1;
-        if (map->set) {
-            memset(map_buf, 0, sizeof(map_buf));
-            if (map->get) {
-                map->get(map_buf, sizeof(map_buf));
-            }
-
-            int index = now_address - map->start_addr;
-            uint16_t *ptr = (uint16_t *)map_buf;
-            int need_len = address_write + nb_write - now_address;
-            if (need_len > map_len) {
-                need_len = map_len;
-            }
-
-            for (int j = 0; j < need_len; j++) {
-                uint16_t data = agile_modbus_slave_register_get(slave_info->buf + 7, i + j);
-                ptr[index + j] = data;
-            }
-
-            int rc = map->set(index, need_len, map_buf, sizeof(map_buf));
-            if (rc != 0)
-                return rc;
-        }
-
-        now_address += map_len - 1;
-        i += map_len - 1;
-    }
+    int rc = write_range(maps, nb_maps, slave_util->maps_sorted, address_write, nb_write, slave_info->buf + 7, 0);
+    if (rc != 0)
+        return rc;
 
     /* and read the data for the response */
-    for (int now_address = address, i = 0; now_address < address + nb; now_address++, i++) {
-        const agile_modbus_slave_util_map_t *map = get_map_by_addr(maps, nb_maps, now_address);
-        if (map == NULL)
-            continue;
-
-        int map_len = map->end_addr - now_address + 1;
-        if (map->get) {
-            memset(map_buf, 0, sizeof(map_buf));
-            map->get(map_buf, sizeof(map_buf));
-            int index = now_address - map->start_addr;
-            uint16_t *ptr = (uint16_t *)map_buf;
-            int need_len = address + nb - now_address;
-            if (need_len > map_len) {
-                need_len = map_len;
-            }
-
-            for (int j = 0; j < need_len; j++) {
-                agile_modbus_slave_register_set(ctx->send_buf + send_index, i + j, ptr[index + j]);
-            }
-        }
-
-        now_address += map_len - 1;
-        i += map_len - 1;
-    }
-
-    return 0;
+    return read_range(maps, nb_maps, slave_util->maps_sorted, address, nb, ctx->send_buf + slave_info->send_index, 0);
 }
 
 /**
@@ -374,6 +480,45 @@ static int write_read_registers(agile_modbus_t *ctx, struct agile_modbus_slave_i
  * @{
  */
 
+/**
+ * @brief   Check that every mapping object array is sorted by address without overlap
+ * @note    The arrays are not sorted here or anywhere else, the caller lists them in ascending address order.
+ *          Set maps_sorted of the slave function structure only when this check passes
+ * @param   slave_util slave function structure
+ * @return  =0: sorted; <0: an array is unsorted, overlapping or has an object ending before it starts
+ */
+int agile_modbus_slave_util_check_maps(const agile_modbus_slave_util_t *slave_util)
+{
+    const agile_modbus_slave_util_map_t *tabs[4];
+    int nbs[4];
+
+    if (slave_util == NULL)
+        return -1;
+
+    tabs[0] = slave_util->tab_bits;
+    nbs[0] = slave_util->nb_bits;
+    tabs[1] = slave_util->tab_input_bits;
+    nbs[1] = slave_util->nb_input_bits;
+    tabs[2] = slave_util->tab_registers;
+    nbs[2] = slave_util->nb_registers;
+    tabs[3] = slave_util->tab_input_registers;
+    nbs[3] = slave_util->nb_input_registers;
+
+    for (int t = 0; t < 4; t++) {
+        if (tabs[t] == NULL)
+            continue;
+
+        for (int i = 0; i < nbs[t]; i++) {
+            if (tabs[t][i].end_addr < tabs[t][i].start_addr)
+                return -1;
+            if (i > 0 && tabs[t][i].start_addr <= tabs[t][i - 1].end_addr)
+                return -1;
+        }
+    }
+
+    return 0;
+}
+
 /**
  * @brief   Slave callback function
  * @param   ctx modbus handle
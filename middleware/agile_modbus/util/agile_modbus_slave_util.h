@@ -40,6 +40,8 @@ typedef struct agile_modbus_slave_util_map {
     int end_addr;                                         /**< end address */
     int (*get)(void *buf, int bufsz);                     /**< Get register data interface */
     int (*set)(int index, int len, void *buf, int bufsz); /**< Set register data interface */
+    int (*get_range)(int index, int len, void *buf, int bufsz); /**< Optional, get only len registers from index into buf[0], replaces get */
+    int (*set_range)(int index, int len, void *buf, int bufsz); /**< Optional, set len registers from index with buf[0], replaces set */
 } agile_modbus_slave_util_map_t;
 
 /**
@@ -57,6 +59,10 @@ typedef struct agile_modbus_slave_util {
     int (*addr_check)(agile_modbus_t *ctx, struct agile_modbus_slave_info *slave_info);       /**< Address checking interface */
     int (*special_function)(agile_modbus_t *ctx, struct agile_modbus_slave_info *slave_info); /**<Special function code processing interface */
     int (*done)(agile_modbus_t *ctx, struct agile_modbus_slave_info *slave_info, int ret);    /**< Processing end interface */
+    int maps_sorted;                                                                          /**< !=0: the arrays are binary searched instead of scanned address by address.
+                                                                                                   Nothing sorts them at init: the caller must list every array in ascending
+                                                                                                   address order without overlap and set this only after
+                                                                                                   agile_modbus_slave_util_check_maps() returned 0 */
 } agile_modbus_slave_util_t;
 
 /**
@@ -66,6 +72,7 @@ typedef struct agile_modbus_slave_util {
 /** @addtogroup SLAVE_UTIL_Exported_Functions
  * @{
  */
+int agile_modbus_slave_util_check_maps(const agile_modbus_slave_util_t *slave_util);
 int agile_modbus_slave_util_callback(agile_modbus_t *ctx, struct agile_modbus_slave_info *slave_info, const void *data);
 /**
  * @}
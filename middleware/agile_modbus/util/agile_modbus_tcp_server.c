@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "agile_modbus.h"
+
+#if AGILE_MODBUS_USING_TCP
+
+#include "agile_modbus_tcp_server.h"
+#include <string.h>
+
+/** @addtogroup UTIL
+ * @{
+ */
+
+/** @defgroup TCP_SERVER TCP Server
+ * @brief   Transport independent Modbus TCP server: connection pool, MBAP framing and pipelined requests.
+ *          The transport feeds received bytes with agile_modbus_tcp_server_input() and gets the responses
+ *          through agile_modbus_tcp_server_ops_t, all calls of one server must come from the same context.
+ * @{
+ */
+
+/** @defgroup TCP_SERVER_Private_Functions TCP Server Private Functions
+ * @{
+ */
+
+/**
+ * @brief   Handle the complete frames in the receive buffer, in order
+ * @param   conn connection
+ * @return  =0: normal; <0: invalid MBAP header or the transport failed, the connection has to be closed
+ */
+static int process_frames(agile_modbus_tcp_server_conn_t *conn)
+{
+    agile_modbus_tcp_server_t *server = conn->server;
+    agile_modbus_t *ctx = &conn->ctx_tcp._ctx;
+    int offset = 0;
+    int sent = 0;
+    int rc = 0;
+
+    while (conn->rx_len - offset >= AGILE_MODBUS_TCP_SERVER_MBAP_LENGTH) {
+        uint8_t *frame = conn->rx_buf + offset;
+        int length = (frame[4] << 8) + frame[5];
+
+        /* Protocol identifier and length, unit identifier plus function code at least */
+        if ((frame[2] != 0) || (frame[3] != 0) || (length < 2) ||
+            (length > AGILE_MODBUS_TCP_MAX_ADU_LENGTH - AGILE_MODBUS_TCP_SERVER_MBAP_LENGTH)) {
+            server->stats.frame_errors++;
+            rc = -1;
+            break;
+        }
+
+        int frame_length = AGILE_MODBUS_TCP_SERVER_MBAP_LENGTH + length;
+        if (conn->rx_len - offset < frame_length)
+            break;
+
+        /* Keep the request until its response fits */
+        if (server->ops->send_space && (server->ops->send_space(conn->arg) < AGILE_MODBUS_TCP_MAX_ADU_LENGTH)) {
+            server->stats.deferred++;
+            break;
+        }
+
+        ctx->read_buf = frame;
+        ctx->read_bufsz = frame_length;
+        int rsp_length = agile_modbus_slave_handle(ctx, frame_length, server->slave_strict, server->slave_cb, server->slave_data, NULL);
+        offset += frame_length;
+        server->stats.requests++;
+        conn->idle_ticks = 0;
+
+        if (rsp_length > 0) {
+            if (server->ops->send(conn->arg, server->send_buf, rsp_length) < 0) {
+                rc = -1;
+                break;
+            }
+            server->stats.responses++;
+            sent = 1;
+        } else {
+            server->stats.no_responses++;
+        }
+    }
+
+    if (offset > 0) {
+        conn->rx_len -= offset;
+        memmove(conn->rx_buf, conn->rx_buf + offset, conn->rx_len);
+    }
+
+    if (sent && server->ops->flush)
+        server->ops->flush(conn->arg);
+
+    return rc;
+}
+
+/**
+ * @}
+ */
+
+/** @defgroup TCP_SERVER_Exported_Functions TCP Server Exported Functions
+ * @{
+ */
+
+/**
+ * @brief   Initialize the server
+ * @param   server server structure
+ * @param   conns connection pool, the number of simultaneous connections is bounded by it
+ * @param   nb_conns number of connections in the pool
+ * @param   ops transport interface
+ * @param   slave_cb slave callback function, e.g. agile_modbus_slave_util_callback
+ * @param   slave_data slave callback function private data
+ * @return  0: success; -1: invalid argument
+ */
+int agile_modbus_tcp_server_init(agile_modbus_tcp_server_t *server, agile_modbus_tcp_server_conn_t *conns, int nb_conns,
+                                 const agile_modbus_tcp_server_ops_t *ops, agile_modbus_slave_callback_t slave_cb, const void *slave_data)
+{
+    if ((server == NULL) || (conns == NULL) || (nb_conns <= 0) || (ops == NULL) || (ops->send == NULL))
+        return -1;
+
+    memset(server, 0, sizeof(agile_modbus_tcp_server_t));
+    server->ops = ops;
+    server->conns = conns;
+    server->nb_conns = nb_conns;
+    server->slave = -1;
+    server->slave_cb = slave_cb;
+    server->slave_data = slave_data;
+
+    for (int i = nb_conns - 1; i >= 0; i--) {
+        conns[i].arg = NULL;
+        conns[i].next = server->free_conns;
+        server->free_conns = &conns[i];
+    }
+
+    return 0;
+}
+
+/**
+ * @brief   Set the slave address of every connection
+ * @param   server server structure
+ * @param   slave slave address
+ * @param   slave_strict slave address strict check flag
+ *     @arg 0: Do not compare slave addresses
+ *     @arg 1: Compare slave address
+ */
+void agile_modbus_tcp_server_set_slave(agile_modbus_tcp_server_t *server, int slave, uint8_t slave_strict)
+{
+    server->slave = slave;
+    server->slave_strict = slave_strict;
+
+    for (int i = 0; i < server->nb_conns; i++) {
+        if (server->conns[i].arg != NULL)
+            agile_modbus_set_slave(&server->conns[i].ctx_tcp._ctx, slave);
+    }
+}
+
+/**
+ * @brief   Set the idle timeout
+ * @param   server server structure
+ * @param   idle_timeout agile_modbus_tcp_server_poll() calls without request before a connection times out, 0: never
+ */
+void agile_modbus_tcp_server_set_idle_timeout(agile_modbus_tcp_server_t *server, int idle_timeout)
+{
+    server->idle_timeout = idle_timeout;
+}
+
+/**
+ * @brief   Take a connection from the pool
+ * @param   server server structure
+ * @param   arg transport connection, not NULL
+ * @return  !=NULL: connection; =NULL: the pool is empty, refuse the transport connection
+ */
+agile_modbus_tcp_server_conn_t *agile_modbus_tcp_server_open(agile_modbus_tcp_server_t *server, void *arg)
+{
+    agile_modbus_tcp_server_conn_t *conn = server->free_conns;
+
+    if ((conn == NULL) || (arg == NULL)) {
+        server->stats.rejected++;
+        return NULL;
+    }
+
+    server->free_conns = conn->next;
+    conn->next = NULL;
+
+    agile_modbus_tcp_init(&conn->ctx_tcp, server->send_buf, sizeof(server->send_buf), conn->rx_buf, sizeof(conn->rx_buf));
+    agile_modbus_set_slave(&conn->ctx_tcp._ctx, server->slave);
+    conn->server = server;
+    conn->arg = arg;
+    conn->idle_ticks = 0;
+    conn->rx_len = 0;
+
+    server->nb_active++;
+    server->stats.accepted++;
+
+    return conn;
+}
+
+/**
+ * @brief   Return a connection to the pool, unprocessed requests are dropped
+ * @param   conn connection
+ */
+void agile_modbus_tcp_server_close(agile_modbus_tcp_server_conn_t *conn)
+{
+    agile_modbus_tcp_server_t *server = conn->server;
+
+    if (conn->arg == NULL)
+        return;
+
+    conn->arg = NULL;
+    conn->rx_len = 0;
+    conn->next = server->free_conns;
+    server->free_conns = conn;
+    server->nb_active--;
+}
+
+/**
+ * @brief   Feed received bytes, complete requests are answered in order
+ * @note    Bytes are refused while the receive buffer is full of requests waiting for send space,
+ *          keep them and feed them again after agile_modbus_tcp_server_process()
+ * @param   conn connection
+ * @param   data received bytes
+ * @param   len number of bytes
+ * @return  >=0: number of bytes taken; <0: the connection has to be closed
+ */
+int agile_modbus_tcp_server_input(agile_modbus_tcp_server_conn_t *conn, const uint8_t *data, int len)
+{
+    int consumed = 0;
+
+    if (conn->arg == NULL)
+        return -1;
+
+    while (consumed < len) {
+        int n = len - consumed;
+        if (n > AGILE_MODBUS_TCP_SERVER_RX_BUFSZ - conn->rx_len)
+            n = AGILE_MODBUS_TCP_SERVER_RX_BUFSZ - conn->rx_len;
+        if (n == 0)
+            break;
+
+        memcpy(conn->rx_buf + conn->rx_len, data + consumed, n);
+        conn->rx_len += n;
+        consumed += n;
+
+        if (process_frames(conn) < 0)
+            return -1;
+    }
+
+    return consumed;
+}
+
+/**
+ * @brief   Handle the requests that waited for send space, call it when the transport has sent data
+ * @param   conn connection
+ * @return  =0: normal; <0: the connection has to be closed
+ */
+int agile_modbus_tcp_server_process(agile_modbus_tcp_server_conn_t *conn)
+{
+    if (conn->arg == NULL)
+        return -1;
+
+    return process_frames(conn);
+}
+
+/**
+ * @brief   Periodic tick of a connection, counts the idle timeout
+ * @param   conn connection
+ * @return  =0: normal; <0: the connection timed out and has to be closed
+ */
+int agile_modbus_tcp_server_poll(agile_modbus_tcp_server_conn_t *conn)
+{
+    agile_modbus_tcp_server_t *server = conn->server;
+
+    if (conn->arg == NULL)
+        return -1;
+
+    if (server->idle_timeout > 0) {
+        conn->idle_ticks++;
+        if (conn->idle_ticks >= server->idle_timeout) {
+            server->stats.timeouts++;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief   Get the statistics
+ * @param   server server structure
+ * @param   stats statistics
+ */
+void agile_modbus_tcp_server_get_stats(agile_modbus_tcp_server_t *server, agile_modbus_tcp_server_stats_t *stats)
+{
+    *stats = server->stats;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#endif /* AGILE_MODBUS_USING_TCP */
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __PKG_AGILE_MODBUS_TCP_SERVER_H
+#define __PKG_AGILE_MODBUS_TCP_SERVER_H
+
+#include "agile_modbus.h"
+
+#if AGILE_MODBUS_USING_TCP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @addtogroup UTIL
+ * @{
+ */
+
+/** @addtogroup TCP_SERVER
+ * @{
+ */
+
+/** @defgroup TCP_SERVER_Exported_Constants TCP Server Exported Constants
+ * @{
+ */
+
+/**
+ * @brief   Receive buffer size of one connection, at least one ADU
+ */
+#ifndef AGILE_MODBUS_TCP_SERVER_RX_BUFSZ
+#define AGILE_MODBUS_TCP_SERVER_RX_BUFSZ (AGILE_MODBUS_TCP_MAX_ADU_LENGTH * 2)
+#endif
+
+/**
+ * @brief   MBAP header length up to and including the length field
+ */
+#define AGILE_MODBUS_TCP_SERVER_MBAP_LENGTH 6
+
+/**
+ * @}
+ */
+
+/** @defgroup TCP_SERVER_Exported_Types TCP Server Exported Types
+ * @{
+ */
+
+typedef struct agile_modbus_tcp_server agile_modbus_tcp_server_t;
+
+/**
+ * @brief   Transport interface, arg is the transport connection passed to agile_modbus_tcp_server_open()
+ */
+typedef struct agile_modbus_tcp_server_ops {
+    int (*send)(void *arg, const uint8_t *buf, int len); /**< Queue a response, buf is reused afterwards. =0: success; <0: the connection is broken */
+    int (*send_space)(void *arg);                        /**< Optional, bytes that can be queued now. Requests wait while it is below one ADU */
+    void (*flush)(void *arg);                            /**< Optional, push the responses queued by one input or process call */
+} agile_modbus_tcp_server_ops_t;
+
+/**
+ * @brief   Connection context
+ */
+typedef struct agile_modbus_tcp_server_conn {
+    agile_modbus_tcp_t ctx_tcp;                 /**< Modbus handle, first member so the slave callback can cast ctx to the connection */
+    agile_modbus_tcp_server_t *server;          /**< Owner */
+    void *arg;                                  /**< Transport connection, NULL: free */
+    struct agile_modbus_tcp_server_conn *next;  /**< Free list */
+    int idle_ticks;                             /**< agile_modbus_tcp_server_poll() calls since the last request */
+    int rx_len;                                 /**< Valid bytes in rx_buf */
+    uint8_t rx_buf[AGILE_MODBUS_TCP_SERVER_RX_BUFSZ]; /**< Unprocessed requests, always starts at a frame */
+} agile_modbus_tcp_server_conn_t;
+
+/**
+ * @brief   Server statistics
+ */
+typedef struct agile_modbus_tcp_server_stats {
+    uint32_t accepted;     /**< Connections opened */
+    uint32_t rejected;     /**< Connections refused, the pool was empty */
+    uint32_t timeouts;     /**< Connections idle for too long */
+    uint32_t requests;     /**< Frames handed to agile_modbus_slave_handle() */
+    uint32_t responses;    /**< Responses queued */
+    uint32_t no_responses; /**< Frames without response: broadcast, other slave or invalid PDU */
+    uint32_t frame_errors; /**< Invalid MBAP headers, the connection has to be closed */
+    uint32_t deferred;     /**< Processing stopped for lack of send space */
+} agile_modbus_tcp_server_stats_t;
+
+/**
+ * @brief   Server structure
+ */
+struct agile_modbus_tcp_server {
+    const agile_modbus_tcp_server_ops_t *ops;   /**< Transport interface */
+    agile_modbus_tcp_server_conn_t *conns;      /**< Connection pool */
+    int nb_conns;                               /**< Number of connections in the pool */
+    agile_modbus_tcp_server_conn_t *free_conns; /**< Free connections */
+    int nb_active;                              /**< Open connections */
+    int slave;                                  /**< Slave address of every connection */
+    uint8_t slave_strict;                       /**< Slave address strict check flag of agile_modbus_slave_handle() */
+    agile_modbus_slave_callback_t slave_cb;     /**< Slave callback function */
+    const void *slave_data;                     /**< Slave callback function private data */
+    int idle_timeout;                           /**< Idle agile_modbus_tcp_server_poll() calls before closing, 0: never */
+    agile_modbus_tcp_server_stats_t stats;      /**< Statistics */
+    uint8_t send_buf[AGILE_MODBUS_TCP_MAX_ADU_LENGTH]; /**< Response buffer shared by the connections */
+};
+
+/**
+ * @}
+ */
+
+/** @addtogroup TCP_SERVER_Exported_Functions
+ * @{
+ */
+int agile_modbus_tcp_server_init(agile_modbus_tcp_server_t *server, agile_modbus_tcp_server_conn_t *conns, int nb_conns,
+                                 const agile_modbus_tcp_server_ops_t *ops, agile_modbus_slave_callback_t slave_cb, const void *slave_data);
+void agile_modbus_tcp_server_set_slave(agile_modbus_tcp_server_t *server, int slave, uint8_t slave_strict);
+void agile_modbus_tcp_server_set_idle_timeout(agile_modbus_tcp_server_t *server, int idle_timeout);
+agile_modbus_tcp_server_conn_t *agile_modbus_tcp_server_open(agile_modbus_tcp_server_t *server, void *arg);
+void agile_modbus_tcp_server_close(agile_modbus_tcp_server_conn_t *conn);
+int agile_modbus_tcp_server_input(agile_modbus_tcp_server_conn_t *conn, const uint8_t *data, int len);
+int agile_modbus_tcp_server_process(agile_modbus_tcp_server_conn_t *conn);
+int agile_modbus_tcp_server_poll(agile_modbus_tcp_server_conn_t *conn);
+void agile_modbus_tcp_server_get_stats(agile_modbus_tcp_server_t *server, agile_modbus_tcp_server_stats_t *stats);
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AGILE_MODBUS_USING_TCP */
+
+#endif /* __PKG_AGILE_MODBUS_TCP_SERVER_H */
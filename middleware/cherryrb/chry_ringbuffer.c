@@ -7,6 +7,15 @@
 #include <string.h>
 #include "chry_ringbuffer.h"
 
+/*
+ * in is only moved by the writer and out only by the reader. Each side loads the pointer of
+ * the other side with acquire and stores its own with release after the data copy, so the
+ * reader never sees data before it is written and the writer never reuses space still being
+ * read, also when writer and reader run on different harts.
+ */
+#define CHRY_RB_LOAD_ACQUIRE(ptr)       __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define CHRY_RB_STORE_RELEASE(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+
 /*****************************************************************************
 * @brief        init ringbuffer
 * 
@@ -35,6 +44,7 @@ int chry_ringbuffer_init(chry_ringbuffer_t *rb, void *pool, uint32_t size)
     rb->out = 0;
     rb->mask = size - 1;
     rb->pool = pool;
+    rb->drop = 0;
 
     return 0;
 }
@@ -50,6 +60,7 @@ void chry_ringbuffer_reset(chry_ringbuffer_t *rb)
 {
     rb->in = 0;
     rb->out = 0;
+    rb->drop = 0;
 }
 
 /*****************************************************************************
@@ -62,7 +73,7 @@ void chry_ringbuffer_reset(chry_ringbuffer_t *rb)
 *****************************************************************************/
 void chry_ringbuffer_reset_read(chry_ringbuffer_t *rb)
 {
-    rb->out = rb->in;
+    CHRY_RB_STORE_RELEASE(&rb->out, CHRY_RB_LOAD_ACQUIRE(&rb->in));
 }
 
 /*****************************************************************************
@@ -140,12 +151,14 @@ bool chry_ringbuffer_check_empty(chry_ringbuffer_t *rb)
 *****************************************************************************/
 bool chry_ringbuffer_write_byte(chry_ringbuffer_t *rb, uint8_t byte)
 {
-    if (chry_ringbuffer_check_full(rb)) {
+    uint32_t in = rb->in;
+
+    if ((in - CHRY_RB_LOAD_ACQUIRE(&rb->out)) > rb->mask) {
         return false;
     }
 
-    ((uint8_t *)(rb->pool))[rb->in & rb->mask] = byte;
-    rb->in++;
+    ((uint8_t *)(rb->pool))[in & rb->mask] = byte;
+    CHRY_RB_STORE_RELEASE(&rb->in, in + 1);
     return true;
 }
 
@@ -166,7 +179,7 @@ bool chry_ringbuffer_overwrite_byte(chry_ringbuffer_t *rb, uint8_t byte)
     }
 
     ((uint8_t *)(rb->pool))[rb->in & rb->mask] = byte;
-    rb->in++;
+    CHRY_RB_STORE_RELEASE(&rb->in, rb->in + 1);
     return true;
 }
 
@@ -183,7 +196,7 @@ bool chry_ringbuffer_overwrite_byte(chry_ringbuffer_t *rb, uint8_t byte)
 *****************************************************************************/
 bool chry_ringbuffer_peek_byte(chry_ringbuffer_t *rb, uint8_t *byte)
 {
-    if (chry_ringbuffer_check_empty(rb)) {
+    if (CHRY_RB_LOAD_ACQUIRE(&rb->in) == rb->out) {
         return false;
     }
 
@@ -206,7 +219,7 @@ bool chry_ringbuffer_read_byte(chry_ringbuffer_t *rb, uint8_t *byte)
 {
     bool ret;
     ret = chry_ringbuffer_peek_byte(rb, byte);
-    rb->out += ret;
+    CHRY_RB_STORE_RELEASE(&rb->out, rb->out + ret);
     return ret;
 }
 
@@ -222,11 +235,11 @@ bool chry_ringbuffer_read_byte(chry_ringbuffer_t *rb, uint8_t *byte)
 *****************************************************************************/
 bool chry_ringbuffer_drop_byte(chry_ringbuffer_t *rb)
 {
-    if (chry_ringbuffer_check_empty(rb)) {
+    if (CHRY_RB_LOAD_ACQUIRE(&rb->in) == rb->out) {
         return false;
     }
 
-    rb->out += 1;
+    CHRY_RB_STORE_RELEASE(&rb->out, rb->out + 1);
     return true;
 }
 
@@ -247,7 +260,7 @@ uint32_t chry_ringbuffer_write(chry_ringbuffer_t *rb, void *data, uint32_t size)
     uint32_t offset;
     uint32_t remain;
 
-    unused = (rb->mask + 1) - (rb->in - rb->out);
+    unused = (rb->mask + 1) - (rb->in - CHRY_RB_LOAD_ACQUIRE(&rb->out));
 
     if (size > unused) {
         size = unused;
@@ -261,7 +274,7 @@ uint32_t chry_ringbuffer_write(chry_ringbuffer_t *rb, void *data, uint32_t size)
     memcpy(((uint8_t *)(rb->pool)) + offset, data, remain);
     memcpy(rb->pool, (uint8_t *)data + remain, size - remain);
 
-    rb->in += size;
+    CHRY_RB_STORE_RELEASE(&rb->in, rb->in + size);
 
     return size;
 }
@@ -300,7 +313,7 @@ uint32_t chry_ringbuffer_overwrite(chry_ringbuffer_t *rb, void *data, uint32_t s
     memcpy(((uint8_t *)(rb->pool)) + offset, data, remain);
     memcpy(rb->pool, (uint8_t *)data + remain, size - remain);
 
-    rb->in += size;
+    CHRY_RB_STORE_RELEASE(&rb->in, rb->in + size);
 
     return size;
 }
@@ -322,7 +335,7 @@ uint32_t chry_ringbuffer_peek(chry_ringbuffer_t *rb, void *data, uint32_t size)
     uint32_t offset;
     uint32_t remain;
 
-    used = rb->in - rb->out;
+    used = CHRY_RB_LOAD_ACQUIRE(&rb->in) - rb->out;
     if (size > used) {
         size = used;
     }
@@ -352,7 +365,7 @@ uint32_t chry_ringbuffer_peek(chry_ringbuffer_t *rb, void *data, uint32_t size)
 uint32_t chry_ringbuffer_read(chry_ringbuffer_t *rb, void *data, uint32_t size)
 {
     size = chry_ringbuffer_peek(rb, data, size);
-    rb->out += size;
+    CHRY_RB_STORE_RELEASE(&rb->out, rb->out + size);
     return size;
 }
 
@@ -370,12 +383,12 @@ uint32_t chry_ringbuffer_drop(chry_ringbuffer_t *rb, uint32_t size)
 {
     uint32_t used;
 
-    used = rb->in - rb->out;
+    used = CHRY_RB_LOAD_ACQUIRE(&rb->in) - rb->out;
     if (size > used) {
         size = used;
     }
 
-    rb->out += size;
+    CHRY_RB_STORE_RELEASE(&rb->out, rb->out + size);
     return size;
 }
 
@@ -393,7 +406,7 @@ void *chry_ringbuffer_linear_write_setup(chry_ringbuffer_t *rb, uint32_t *size)
     uint32_t offset;
     uint32_t remain;
 
-    unused = (rb->mask + 1) - (rb->in - rb->out);
+    unused = (rb->mask + 1) - (rb->in - CHRY_RB_LOAD_ACQUIRE(&rb->out));
 
     offset = rb->in & rb->mask;
 
@@ -423,7 +436,7 @@ void *chry_ringbuffer_linear_read_setup(chry_ringbuffer_t *rb, uint32_t *size)
     uint32_t offset;
     uint32_t remain;
 
-    used = rb->in - rb->out;
+    used = CHRY_RB_LOAD_ACQUIRE(&rb->in) - rb->out;
 
     offset = rb->out & rb->mask;
 
@@ -451,11 +464,11 @@ uint32_t chry_ringbuffer_linear_write_done(chry_ringbuffer_t *rb, uint32_t size)
 {
     uint32_t unused;
 
-    unused = (rb->mask + 1) - (rb->in - rb->out);
+    unused = (rb->mask + 1) - (rb->in - CHRY_RB_LOAD_ACQUIRE(&rb->out));
     if (size > unused) {
         size = unused;
     }
-    rb->in += size;
+    CHRY_RB_STORE_RELEASE(&rb->in, rb->in + size);
 
     return size;
 }
@@ -472,3 +485,416 @@ uint32_t chry_ringbuffer_linear_read_done(chry_ringbuffer_t *rb, uint32_t size)
 {
     return chry_ringbuffer_drop(rb, size);
 }
+
+/* split size byte starting at index into at most two spans, the second one from pool start */
+static uint32_t chry_ringbuffer_split(chry_ringbuffer_t *rb, uint32_t index, uint32_t size,
+                                      chry_ringbuffer_seg_t seg[2])
+{
+    uint32_t offset;
+    uint32_t remain;
+
+    if (size == 0) {
+        seg[0].buf = NULL;
+        seg[0].size = 0;
+        seg[1].buf = NULL;
+        seg[1].size = 0;
+        return 0;
+    }
+
+    offset = index & rb->mask;
+
+    remain = rb->mask + 1 - offset;
+    remain = remain > size ? size : remain;
+
+    seg[0].buf = ((uint8_t *)(rb->pool)) + offset;
+    seg[0].size = remain;
+
+    if (remain == size) {
+        seg[1].buf = NULL;
+        seg[1].size = 0;
+        return 1;
+    }
+
+    seg[1].buf = rb->pool;
+    seg[1].size = size - remain;
+    return 2;
+}
+
+/*****************************************************************************
+* @brief        get all free space as up to two segments, the second one
+*               starts at pool start when the free space wraps. fill them
+*               in order, e.g. by one chained dma transfer, then commit
+*               with chry_ringbuffer_linear_write_done.
+* 
+* @param[in]    rb          ringbuffer instance
+* @param[out]   seg         segment array, unused entries get size 0
+* 
+* @retval uint32_t          segment count, 0 if full
+*****************************************************************************/
+uint32_t chry_ringbuffer_get_write_segments(chry_ringbuffer_t *rb, chry_ringbuffer_seg_t seg[2])
+{
+    uint32_t unused;
+
+    unused = (rb->mask + 1) - (rb->in - CHRY_RB_LOAD_ACQUIRE(&rb->out));
+
+    return chry_ringbuffer_split(rb, rb->in, unused, seg);
+}
+
+/*****************************************************************************
+* @brief        get all used data as up to two segments, the second one
+*               starts at pool start when the data wraps. consume them in
+*               order, then release with chry_ringbuffer_linear_read_done.
+* 
+* @param[in]    rb          ringbuffer instance
+* @param[out]   seg         segment array, unused entries get size 0
+* 
+* @retval uint32_t          segment count, 0 if empty
+*****************************************************************************/
+uint32_t chry_ringbuffer_get_read_segments(chry_ringbuffer_t *rb, chry_ringbuffer_seg_t seg[2])
+{
+    uint32_t used;
+
+    used = CHRY_RB_LOAD_ACQUIRE(&rb->in) - rb->out;
+
+    return chry_ringbuffer_split(rb, rb->out, used, seg);
+}
+
+/*
+ * Record framing
+ *
+ * Each record is a 16 bit length in native byte order followed by the data, either may wrap
+ * around pool end. A record is published with one store of in after it is complete, so the
+ * reader sees whole records only. Do not mix record and byte stream calls on one ringbuffer.
+ */
+#define CHRY_RB_RECORD_HEAD    sizeof(uint16_t)
+#define CHRY_RB_RECORD_LEN_MAX 0xFFFFUL
+
+static void chry_ringbuffer_copy_in(chry_ringbuffer_t *rb, uint32_t index, const void *data, uint32_t size)
+{
+    uint32_t offset;
+    uint32_t remain;
+
+    offset = index & rb->mask;
+
+    remain = rb->mask + 1 - offset;
+    remain = remain > size ? size : remain;
+
+    memcpy(((uint8_t *)(rb->pool)) + offset, data, remain);
+    memcpy(rb->pool, (const uint8_t *)data + remain, size - remain);
+}
+
+static void chry_ringbuffer_copy_out(chry_ringbuffer_t *rb, uint32_t index, void *data, uint32_t size)
+{
+    uint32_t offset;
+    uint32_t remain;
+
+    offset = index & rb->mask;
+
+    remain = rb->mask + 1 - offset;
+    remain = remain > size ? size : remain;
+
+    memcpy(data, ((uint8_t *)(rb->pool)) + offset, remain);
+    memcpy((uint8_t *)data + remain, rb->pool, size - remain);
+}
+
+/*****************************************************************************
+* @brief        write one record with length prefix, all or nothing,
+*               a record that does not fit is dropped and counted,
+*               in single write thread not need lock
+* 
+* @param[in]    rb          ringbuffer instance
+* @param[in]    data        data pointer
+* @param[in]    size        size in byte, 1 to 65535
+* 
+* @retval uint32_t          size, 0 if dropped
+*****************************************************************************/
+uint32_t chry_ringbuffer_write_record(chry_ringbuffer_t *rb, void *data, uint32_t size)
+{
+    uint32_t unused;
+    uint16_t len;
+
+    unused = (rb->mask + 1) - (rb->in - CHRY_RB_LOAD_ACQUIRE(&rb->out));
+
+    if ((size == 0) || (size > CHRY_RB_RECORD_LEN_MAX) || ((size + CHRY_RB_RECORD_HEAD) > unused)) {
+        __atomic_store_n(&rb->drop, rb->drop + 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    len = (uint16_t)size;
+    chry_ringbuffer_copy_in(rb, rb->in, &len, CHRY_RB_RECORD_HEAD);
+    chry_ringbuffer_copy_in(rb, rb->in + CHRY_RB_RECORD_HEAD, data, size);
+
+    CHRY_RB_STORE_RELEASE(&rb->in, rb->in + CHRY_RB_RECORD_HEAD + size);
+
+    return size;
+}
+
+/*****************************************************************************
+* @brief        get data length of the next record
+* 
+* @param[in]    rb          ringbuffer instance
+* 
+* @retval uint32_t          record length in byte, 0 if empty
+*****************************************************************************/
+uint32_t chry_ringbuffer_peek_record_len(chry_ringbuffer_t *rb)
+{
+    uint16_t len;
+
+    if (CHRY_RB_LOAD_ACQUIRE(&rb->in) == rb->out) {
+        return 0;
+    }
+
+    chry_ringbuffer_copy_out(rb, rb->out, &len, CHRY_RB_RECORD_HEAD);
+    return len;
+}
+
+/*****************************************************************************
+* @brief        get the next record in place as up to two segments,
+*               the record stays until chry_ringbuffer_drop_record
+* 
+* @param[in]    rb          ringbuffer instance
+* @param[out]   seg         segment array, unused entries get size 0
+* 
+* @retval uint32_t          record length in byte, 0 if empty
+*****************************************************************************/
+uint32_t chry_ringbuffer_read_record(chry_ringbuffer_t *rb, chry_ringbuffer_seg_t seg[2])
+{
+    uint32_t len;
+
+    len = chry_ringbuffer_peek_record_len(rb);
+    chry_ringbuffer_split(rb, rb->out + CHRY_RB_RECORD_HEAD, len, seg);
+
+    return len;
+}
+
+/*****************************************************************************
+* @brief        drop the next record
+* 
+* @param[in]    rb          ringbuffer instance
+* 
+* @retval true              Success
+* @retval false             ringbuffer is empty
+*****************************************************************************/
+bool chry_ringbuffer_drop_record(chry_ringbuffer_t *rb)
+{
+    uint32_t len;
+
+    len = chry_ringbuffer_peek_record_len(rb);
+    if (len == 0) {
+        return false;
+    }
+
+    CHRY_RB_STORE_RELEASE(&rb->out, rb->out + CHRY_RB_RECORD_HEAD + len);
+    return true;
+}
+
+/*****************************************************************************
+* @brief        get count of records dropped by chry_ringbuffer_write_record
+* 
+* @param[in]    rb          ringbuffer instance
+* 
+* @retval uint32_t          dropped record count
+*****************************************************************************/
+uint32_t chry_ringbuffer_get_record_drop(chry_ringbuffer_t *rb)
+{
+    return __atomic_load_n(&rb->drop, __ATOMIC_RELAXED);
+}
+
+/*
+ * Multi producer multi consumer ringbuffer
+ *
+ * A writer reserves space by a compare and swap on prod, which packs the reserve pointer in the
+ * low 24 bits with the count of writers still copying in the high 8 bits, copies its data, then
+ * leaves. The writer that brings the count to zero publishes the reserve pointer to in, so no
+ * writer ever waits on another one and a preempted writer only delays the visibility of newer
+ * data. Readers do the same with cons and out.
+ */
+#define CHRY_RB_MPMC_PTR_MASK  0x00FFFFFFUL
+#define CHRY_RB_MPMC_CNT_SHIFT 24
+#define CHRY_RB_MPMC_CNT_ONE   (1UL << CHRY_RB_MPMC_CNT_SHIFT)
+#define CHRY_RB_MPMC_CNT_MAX   0xFFUL
+
+/* reserve size byte behind the published pointer of the other side, all or nothing */
+static uint32_t chry_ringbuffer_mpmc_reserve(uint32_t *state, uint32_t *other, uint32_t capacity, bool writer,
+                                             uint32_t size, uint32_t *head)
+{
+    uint32_t old;
+    uint32_t avail;
+    uint32_t used;
+
+    old = __atomic_load_n(state, __ATOMIC_RELAXED);
+    do {
+        if ((old >> CHRY_RB_MPMC_CNT_SHIFT) == CHRY_RB_MPMC_CNT_MAX) {
+            return 0;
+        }
+
+        *head = old & CHRY_RB_MPMC_PTR_MASK;
+        if (writer) {
+            used = (*head - __atomic_load_n(other, __ATOMIC_ACQUIRE)) & CHRY_RB_MPMC_PTR_MASK;
+            avail = capacity - used;
+        } else {
+            avail = (__atomic_load_n(other, __ATOMIC_ACQUIRE) - *head) & CHRY_RB_MPMC_PTR_MASK;
+        }
+
+        if ((size == 0) || (size > avail)) {
+            return 0;
+        }
+    } while (!__atomic_compare_exchange_n(state, &old,
+                                          (old & ~CHRY_RB_MPMC_PTR_MASK) + CHRY_RB_MPMC_CNT_ONE +
+                                          ((*head + size) & CHRY_RB_MPMC_PTR_MASK),
+                                          true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+    return size;
+}
+
+/* leave after the copy, the last one out publishes everything reserved so far */
+static void chry_ringbuffer_mpmc_publish(uint32_t *state, uint32_t *tail, uint32_t capacity)
+{
+    uint32_t now;
+    uint32_t end;
+    uint32_t cur;
+    uint32_t dist;
+
+    now = __atomic_sub_fetch(state, CHRY_RB_MPMC_CNT_ONE, __ATOMIC_ACQ_REL);
+    if ((now >> CHRY_RB_MPMC_CNT_SHIFT) != 0) {
+        return;
+    }
+
+    /* a later last one out may have published further already, never move tail back */
+    end = now & CHRY_RB_MPMC_PTR_MASK;
+    cur = __atomic_load_n(tail, __ATOMIC_RELAXED);
+    dist = (end - cur) & CHRY_RB_MPMC_PTR_MASK;
+    while ((dist != 0) && (dist <= capacity)) {
+        if (__atomic_compare_exchange_n(tail, &cur, end, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+            break;
+        }
+        dist = (end - cur) & CHRY_RB_MPMC_PTR_MASK;
+    }
+}
+
+/*****************************************************************************
+* @brief        init multi producer multi consumer ringbuffer
+* 
+* @param[in]    rb          ringbuffer instance
+* @param[in]    pool        memory pool address
+* @param[in]    size        memory size in byte,
+*                           must be power of 2 and not more than 8M !!!
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+int chry_ringbuffer_mpmc_init(chry_ringbuffer_mpmc_t *rb, void *pool, uint32_t size)
+{
+    if (NULL == rb) {
+        return -1;
+    }
+
+    if (NULL == pool) {
+        return -1;
+    }
+
+    if ((size < 2) || (size & (size - 1)) || (size > (CHRY_RB_MPMC_PTR_MASK + 1) / 2)) {
+        return -1;
+    }
+
+    rb->prod = 0;
+    rb->in = 0;
+    rb->cons = 0;
+    rb->out = 0;
+    rb->mask = size - 1;
+    rb->pool = pool;
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        get multi producer multi consumer ringbuffer used size in byte,
+*               data still being written or read is not counted
+* 
+* @param[in]    rb          ringbuffer instance
+* 
+* @retval uint32_t          used size in byte
+*****************************************************************************/
+uint32_t chry_ringbuffer_mpmc_get_used(chry_ringbuffer_mpmc_t *rb)
+{
+    return (__atomic_load_n(&rb->in, __ATOMIC_ACQUIRE) - __atomic_load_n(&rb->cons, __ATOMIC_RELAXED)) & CHRY_RB_MPMC_PTR_MASK;
+}
+
+/*****************************************************************************
+* @brief        get multi producer multi consumer ringbuffer free size in byte
+* 
+* @param[in]    rb          ringbuffer instance
+* 
+* @retval uint32_t          free size in byte
+*****************************************************************************/
+uint32_t chry_ringbuffer_mpmc_get_free(chry_ringbuffer_mpmc_t *rb)
+{
+    return (rb->mask + 1) - ((__atomic_load_n(&rb->prod, __ATOMIC_RELAXED) - __atomic_load_n(&rb->out, __ATOMIC_ACQUIRE)) & CHRY_RB_MPMC_PTR_MASK);
+}
+
+/*****************************************************************************
+* @brief        write data to multi producer multi consumer ringbuffer,
+*               lock free, all or nothing, the data of one call is kept contiguous
+* 
+* @param[in]    rb          ringbuffer instance
+* @param[in]    data        data pointer
+* @param[in]    size        size in byte
+* 
+* @retval uint32_t          size, or 0 when there is not enough free space
+*****************************************************************************/
+uint32_t chry_ringbuffer_mpmc_write(chry_ringbuffer_mpmc_t *rb, void *data, uint32_t size)
+{
+    uint32_t head;
+    uint32_t offset;
+    uint32_t remain;
+
+    size = chry_ringbuffer_mpmc_reserve(&rb->prod, &rb->out, rb->mask + 1, true, size, &head);
+    if (size == 0) {
+        return 0;
+    }
+
+    offset = head & rb->mask;
+
+    remain = rb->mask + 1 - offset;
+    remain = remain > size ? size : remain;
+
+    memcpy(((uint8_t *)(rb->pool)) + offset, data, remain);
+    memcpy(rb->pool, (uint8_t *)data + remain, size - remain);
+
+    chry_ringbuffer_mpmc_publish(&rb->prod, &rb->in, rb->mask + 1);
+
+    return size;
+}
+
+/*****************************************************************************
+* @brief        read data from multi producer multi consumer ringbuffer,
+*               lock free, all or nothing
+* 
+* @param[in]    rb          ringbuffer instance
+* @param[in]    data        data pointer
+* @param[in]    size        size in byte
+* 
+* @retval uint32_t          size, or 0 when less data is available
+*****************************************************************************/
+uint32_t chry_ringbuffer_mpmc_read(chry_ringbuffer_mpmc_t *rb, void *data, uint32_t size)
+{
+    uint32_t head;
+    uint32_t offset;
+    uint32_t remain;
+
+    size = chry_ringbuffer_mpmc_reserve(&rb->cons, &rb->in, rb->mask + 1, false, size, &head);
+    if (size == 0) {
+        return 0;
+    }
+
+    offset = head & rb->mask;
+
+    remain = rb->mask + 1 - offset;
+    remain = remain > size ? size : remain;
+
+    memcpy(data, ((uint8_t *)(rb->pool)) + offset, remain);
+    memcpy((uint8_t *)data + remain, rb->pool, size - remain);
+
+    chry_ringbuffer_mpmc_publish(&rb->cons, &rb->out, rb->mask + 1);
+
+    return size;
+}
@@ -19,8 +19,30 @@ typedef struct {
     uint32_t out;  /*!< Define the read pointer.                */
     uint32_t mask; /*!< Define the write and read pointer mask. */
     void *pool;    /*!< Define the memory pointer.              */
+    uint32_t drop; /*!< Define the dropped record count.        */
 } chry_ringbuffer_t;
 
+/*
+ * chry_ringbuffer_t is safe without lock for one writer and one reader, also on different harts,
+ * as long as the instance and pool are placed in memory both harts see coherently, e.g. noncacheable.
+ *
+ * chry_ringbuffer_mpmc_t is lock free for any number of writers and readers, up to 255 of each
+ * inside a call at the same time, with pool size up to 8M.
+ */
+typedef struct {
+    uint32_t prod; /*!< Define the write reserve pointer and active writer count. */
+    uint32_t in;   /*!< Define the write pointer.                               */
+    uint32_t cons; /*!< Define the read reserve pointer and active reader count.  */
+    uint32_t out;  /*!< Define the read pointer.                                */
+    uint32_t mask; /*!< Define the write and read pointer mask.                 */
+    void *pool;    /*!< Define the memory pointer.                              */
+} chry_ringbuffer_mpmc_t;
+
+typedef struct {
+    void *buf;     /*!< Define the segment memory pointer.      */
+    uint32_t size; /*!< Define the segment size in byte.        */
+} chry_ringbuffer_seg_t;
+
 extern int chry_ringbuffer_init(chry_ringbuffer_t *rb, void *pool, uint32_t size);
 extern void chry_ringbuffer_reset(chry_ringbuffer_t *rb);
 extern void chry_ringbuffer_reset_read(chry_ringbuffer_t *rb);
@@ -49,6 +71,21 @@ extern void *chry_ringbuffer_linear_read_setup(chry_ringbuffer_t *rb, uint32_t *
 extern uint32_t chry_ringbuffer_linear_write_done(chry_ringbuffer_t *rb, uint32_t size);
 extern uint32_t chry_ringbuffer_linear_read_done(chry_ringbuffer_t *rb, uint32_t size);
 
+extern uint32_t chry_ringbuffer_get_write_segments(chry_ringbuffer_t *rb, chry_ringbuffer_seg_t seg[2]);
+extern uint32_t chry_ringbuffer_get_read_segments(chry_ringbuffer_t *rb, chry_ringbuffer_seg_t seg[2]);
+
+extern uint32_t chry_ringbuffer_write_record(chry_ringbuffer_t *rb, void *data, uint32_t size);
+extern uint32_t chry_ringbuffer_peek_record_len(chry_ringbuffer_t *rb);
+extern uint32_t chry_ringbuffer_read_record(chry_ringbuffer_t *rb, chry_ringbuffer_seg_t seg[2]);
+extern bool chry_ringbuffer_drop_record(chry_ringbuffer_t *rb);
+extern uint32_t chry_ringbuffer_get_record_drop(chry_ringbuffer_t *rb);
+
+extern int chry_ringbuffer_mpmc_init(chry_ringbuffer_mpmc_t *rb, void *pool, uint32_t size);
+extern uint32_t chry_ringbuffer_mpmc_get_used(chry_ringbuffer_mpmc_t *rb);
+extern uint32_t chry_ringbuffer_mpmc_get_free(chry_ringbuffer_mpmc_t *rb);
+extern uint32_t chry_ringbuffer_mpmc_write(chry_ringbuffer_mpmc_t *rb, void *data, uint32_t size);
+extern uint32_t chry_ringbuffer_mpmc_read(chry_ringbuffer_mpmc_t *rb, void *data, uint32_t size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Throughput of chry_ringbuffer_t and chry_ringbuffer_mpmc_t against the ringbuffer
+ * as it was before the acquire/release ordering, plain in/out without barriers
+ *
+ * 1. one thread writes and reads back chunk byte at a time: ns per write + read,
+ *    the cost of the calls themselves.
+ * 2. one writer and one reader thread: MB/s through the ring for each chunk size.
+ * 3. BENCH_WRITERS writers and BENCH_READERS readers of 8 byte messages: the mpmc ring
+ *    against the old ring behind a pthread mutex, the way it had to be shared before.
+ *
+ * The old ring is only fast in 2 because nothing orders its data against in/out,
+ * on a weakly ordered cpu its reader may see stale data. Every result is the best of
+ * BENCH_REPEAT runs; the data of every run is checked, a mismatch ends with FAILED.
+ *
+ * ./bench/RbBench
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "chry_ringbuffer.h"
+
+#define POOL_SIZE           (4096)
+#define CALL_CNT            (2000000u)
+#define STREAM_BYTES        (4u << 20)
+#define MSG_CNT             (200000u)
+#define BENCH_WRITERS       (4)
+#define BENCH_READERS       (4)
+#define BENCH_REPEAT        (5)
+
+/* chry_ringbuffer_write/read before the acquire/release ordering */
+typedef struct {
+    uint32_t in;
+    uint32_t out;
+    uint32_t mask;
+    void *pool;
+} old_rb_t;
+
+static void old_rb_init(old_rb_t *rb, void *pool, uint32_t size)
+{
+    rb->in = 0;
+    rb->out = 0;
+    rb->mask = size - 1;
+    rb->pool = pool;
+}
+
+static uint32_t old_rb_write(old_rb_t *rb, void *data, uint32_t size)
+{
+    uint32_t unused;
+    uint32_t offset;
+    uint32_t remain;
+
+    unused = (rb->mask + 1) - (rb->in - rb->out);
+
+    if (size > unused) {
+        size = unused;
+    }
+
+    offset = rb->in & rb->mask;
+
+    remain = rb->mask + 1 - offset;
+    remain = remain > size ? size : remain;
+
+    memcpy(((uint8_t *)(rb->pool)) + offset, data, remain);
+    memcpy(rb->pool, (uint8_t *)data + remain, size - remain);
+
+    rb->in += size;
+
+    return size;
+}
+
+static uint32_t old_rb_read(old_rb_t *rb, void *data, uint32_t size)
+{
+    uint32_t used;
+    uint32_t offset;
+    uint32_t remain;
+
+    used = rb->in - rb->out;
+    if (size > used) {
+        size = used;
+    }
+
+    offset = rb->out & rb->mask;
+
+    remain = rb->mask + 1 - offset;
+    remain = remain > size ? size : remain;
+
+    memcpy(data, ((uint8_t *)(rb->pool)) + offset, remain);
+    memcpy((uint8_t *)data + remain, rb->pool, size - remain);
+
+    rb->out += size;
+
+    return size;
+}
+
+typedef enum {
+    ring_old,
+    ring_old_locked,
+    ring_spsc,
+    ring_mpmc,
+} ring_t;
+
+static const char *ring_name[] = {"old", "old + mutex", "spsc", "mpmc"};
+
+static uint8_t pool[POOL_SIZE] __attribute__((aligned(64)));
+static old_rb_t old_rb;
+static chry_ringbuffer_t spsc;
+static chry_ringbuffer_mpmc_t mpmc;
+static pthread_mutex_t old_lock = PTHREAD_MUTEX_INITIALIZER;
+static ring_t ring;
+static uint32_t chunk;
+static uint32_t bad;
+
+static uint64_t time_ns(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000000ull + t.tv_nsec;
+}
+
+static void ring_init(void)
+{
+    old_rb_init(&old_rb, pool, sizeof(pool));
+    chry_ringbuffer_init(&spsc, pool, sizeof(pool));
+    chry_ringbuffer_mpmc_init(&mpmc, pool, sizeof(pool));
+}
+
+static uint32_t ring_write(void *data, uint32_t size)
+{
+    uint32_t n;
+
+    switch (ring) {
+    case ring_old:
+        return old_rb_write(&old_rb, data, size);
+    case ring_old_locked:
+        pthread_mutex_lock(&old_lock);
+        n = old_rb_write(&old_rb, data, size);
+        pthread_mutex_unlock(&old_lock);
+        return n;
+    case ring_spsc:
+        return chry_ringbuffer_write(&spsc, data, size);
+    default:
+        return chry_ringbuffer_mpmc_write(&mpmc, data, size);
+    }
+}
+
+static uint32_t ring_read(void *data, uint32_t size)
+{
+    uint32_t n;
+
+    switch (ring) {
+    case ring_old:
+        return old_rb_read(&old_rb, data, size);
+    case ring_old_locked:
+        pthread_mutex_lock(&old_lock);
+        n = old_rb_read(&old_rb, data, size);
+        pthread_mutex_unlock(&old_lock);
+        return n;
+    case ring_spsc:
+        return chry_ringbuffer_read(&spsc, data, size);
+    default:
+        return chry_ringbuffer_mpmc_read(&mpmc, data, size);
+    }
+}
+
+static double bench_calls(void)
+{
+    uint8_t in[256], out[256];
+    uint64_t best = UINT64_MAX;
+
+    for (uint32_t i = 0; i < sizeof(in); i++) {
+        in[i] = (uint8_t)i;
+    }
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        uint64_t t0;
+
+        ring_init();
+        t0 = time_ns();
+        for (uint32_t i = 0; i < CALL_CNT; i++) {
+            ring_write(in, chunk);
+            ring_read(out, chunk);
+        }
+        t0 = time_ns() - t0;
+        if (t0 < best) {
+            best = t0;
+        }
+        if (memcmp(in, out, chunk) != 0) {
+            bad++;
+        }
+    }
+    return (double)best / CALL_CNT;
+}
+
+/* the byte at stream position pos is (uint8_t)pos */
+static void *stream_writer(void *arg)
+{
+    uint8_t buf[256];
+
+    (void)arg;
+    for (uint32_t pos = 0; pos < STREAM_BYTES;) {
+        uint32_t w;
+
+        for (uint32_t i = 0; i < chunk; i++) {
+            buf[i] = (uint8_t)(pos + i);
+        }
+        w = ring_write(buf, chunk);
+        if (w == 0) {
+            sched_yield();
+        }
+        pos += w;
+    }
+    return NULL;
+}
+
+static void *stream_reader(void *arg)
+{
+    uint8_t buf[256];
+    uint32_t errors = 0;
+
+    (void)arg;
+    for (uint32_t pos = 0; pos < STREAM_BYTES;) {
+        uint32_t r = ring_read(buf, chunk);
+
+        if (r == 0) {
+            sched_yield();
+        }
+        for (uint32_t i = 0; i < r; i++) {
+            errors += (buf[i] != (uint8_t)(pos + i));
+        }
+        pos += r;
+    }
+    __atomic_add_fetch(&bad, errors, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+static double bench_stream(void)
+{
+    uint64_t best = UINT64_MAX;
+
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        pthread_t w, rd;
+        uint64_t t0;
+
+        ring_init();
+        t0 = time_ns();
+        pthread_create(&w, NULL, stream_writer, NULL);
+        pthread_create(&rd, NULL, stream_reader, NULL);
+        pthread_join(w, NULL);
+        pthread_join(rd, NULL);
+        t0 = time_ns() - t0;
+        if (t0 < best) {
+            best = t0;
+        }
+    }
+    return STREAM_BYTES * 1e3 / best;
+}
+
+static uint32_t msg_left;
+static uint64_t msg_sum;
+
+static void *msg_writer(void *arg)
+{
+    uint64_t msg = (uint64_t)(uintptr_t)arg << 32;
+
+    for (uint32_t seq = 0; seq < MSG_CNT;) {
+        if (ring_write(&msg, sizeof(msg)) == sizeof(msg)) {
+            msg++;
+            seq++;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *msg_reader(void *arg)
+{
+    uint64_t msg, sum = 0;
+
+    (void)arg;
+    while (__atomic_load_n(&msg_left, __ATOMIC_RELAXED)) {
+        if (ring_read(&msg, sizeof(msg)) == sizeof(msg)) {
+            sum += msg & UINT32_MAX;
+            __atomic_sub_fetch(&msg_left, 1, __ATOMIC_RELAXED);
+        } else {
+            sched_yield();
+        }
+    }
+    __atomic_add_fetch(&msg_sum, sum, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+static double bench_msgs(void)
+{
+    uint64_t best = UINT64_MAX;
+
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        pthread_t w[BENCH_WRITERS], rd[BENCH_READERS];
+        uint64_t t0;
+
+        ring_init();
+        msg_left = BENCH_WRITERS * MSG_CNT;
+        msg_sum = 0;
+        t0 = time_ns();
+        for (uintptr_t i = 0; i < BENCH_READERS; i++) {
+            pthread_create(&rd[i], NULL, msg_reader, NULL);
+        }
+        for (uintptr_t i = 0; i < BENCH_WRITERS; i++) {
+            pthread_create(&w[i], NULL, msg_writer, (void *)i);
+        }
+        for (int i = 0; i < BENCH_WRITERS; i++) {
+            pthread_join(w[i], NULL);
+        }
+        for (int i = 0; i < BENCH_READERS; i++) {
+            pthread_join(rd[i], NULL);
+        }
+        t0 = time_ns() - t0;
+        if (t0 < best) {
+            best = t0;
+        }
+        if (msg_sum != (uint64_t)BENCH_WRITERS * MSG_CNT * (MSG_CNT - 1) / 2) {
+            bad++;
+        }
+    }
+    return BENCH_WRITERS * MSG_CNT * 1e3 / best;
+}
+
+int main(void)
+{
+    static const uint32_t chunks[] = {1, 16, 64, 256};
+    static const ring_t single[] = {ring_old, ring_spsc, ring_mpmc};
+    static const ring_t multi[] = {ring_old_locked, ring_mpmc};
+
+    printf("ns per write + read in one thread\n");
+    for (unsigned c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+        chunk = chunks[c];
+        printf("  chunk %3u:", chunk);
+        for (unsigned i = 0; i < sizeof(single) / sizeof(single[0]); i++) {
+            ring = single[i];
+            printf("  %s %7.1f", ring_name[ring], bench_calls());
+        }
+        printf("\n");
+    }
+
+    printf("MB/s, one writer and one reader thread\n");
+    for (unsigned c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+        chunk = chunks[c];
+        printf("  chunk %3u:", chunk);
+        for (unsigned i = 0; i < sizeof(single) / sizeof(single[0]); i++) {
+            ring = single[i];
+            printf("  %s %7.1f", ring_name[ring], bench_stream());
+        }
+        printf("\n");
+    }
+
+    printf("M msg/s of 8 byte, %d writer and %d reader threads\n ", BENCH_WRITERS, BENCH_READERS);
+    for (unsigned i = 0; i < sizeof(multi) / sizeof(multi[0]); i++) {
+        ring = multi[i];
+        printf("  %s %6.2f", ring_name[ring], bench_msgs());
+    }
+    printf("\n");
+
+    printf(bad ? "FAILED\n" : "PASSED.\n");
+    return bad ? 1 : 0;
+}
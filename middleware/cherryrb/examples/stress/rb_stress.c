@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * pthread stress test of chry_ringbuffer_t with one writer and one reader thread,
+ * and of chry_ringbuffer_mpmc_t with MPMC_WRITERS writer and MPMC_READERS reader threads
+ *
+ * spsc: a byte stream of a known sequence goes through chry_ringbuffer_write/read with
+ * chunks of 1, 7, 64 and 1000 byte, through the linear setup/done calls, and as records
+ * of 1 to RECORD_MAX byte, the reader checks every byte.
+ * mpmc: every writer sends MPMC_MSG_CNT messages {writer, seq}, a reader must see the seq
+ * of each writer increasing, no message twice and none lost, checked with counts and sums.
+ *
+ * ./stress/RbStress, make SANITIZE=thread for a ThreadSanitizer build
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "chry_ringbuffer.h"
+
+#define POOL_SIZE           (4096)
+#define STREAM_SIZE         (8u << 20)
+#define RECORD_MAX          (300)
+#define RECORD_CNT          (200000u)
+#define MPMC_WRITERS        (4)
+#define MPMC_READERS        (4)
+#define MPMC_MSG_CNT        (100000u)
+
+typedef struct {
+    uint32_t writer;
+    uint32_t seq;
+} msg_t;
+
+static uint8_t pool[POOL_SIZE] __attribute__((aligned(64)));
+static chry_ringbuffer_t rb;
+static chry_ringbuffer_mpmc_t mpmc;
+static uint32_t chunk;
+static int failures;
+
+static uint8_t pattern(uint32_t pos)
+{
+    return (uint8_t)((pos * 131u) ^ (pos >> 9));
+}
+
+static int failure_cnt(void)
+{
+    return __atomic_load_n(&failures, __ATOMIC_RELAXED);
+}
+
+static void fail(const char *what, uint32_t pos)
+{
+    printf("%s at %u\n", what, pos);
+    __atomic_add_fetch(&failures, 1, __ATOMIC_RELAXED);
+}
+
+static void *stream_writer(void *arg)
+{
+    uint8_t buf[1024];
+    uint32_t pos = 0;
+
+    (void)arg;
+    while ((pos < STREAM_SIZE) && !failure_cnt()) {
+        uint32_t n = (STREAM_SIZE - pos < chunk) ? STREAM_SIZE - pos : chunk;
+        uint32_t w;
+
+        for (uint32_t i = 0; i < n; i++) {
+            buf[i] = pattern(pos + i);
+        }
+        w = chry_ringbuffer_write(&rb, buf, n);
+        if (w == 0) {
+            sched_yield();
+        }
+        pos += w;
+    }
+    return NULL;
+}
+
+static void *stream_reader(void *arg)
+{
+    uint8_t buf[1024];
+    uint32_t pos = 0;
+
+    (void)arg;
+    while ((pos < STREAM_SIZE) && !failure_cnt()) {
+        uint32_t r = chry_ringbuffer_read(&rb, buf, chunk);
+
+        if (r == 0) {
+            sched_yield();
+        }
+        for (uint32_t i = 0; i < r; i++) {
+            if (buf[i] != pattern(pos + i)) {
+                fail("stream byte wrong", pos + i);
+                return NULL;
+            }
+        }
+        pos += r;
+    }
+    return NULL;
+}
+
+static void *linear_writer(void *arg)
+{
+    uint32_t pos = 0;
+
+    (void)arg;
+    while ((pos < STREAM_SIZE) && !failure_cnt()) {
+        uint32_t size;
+        uint8_t *p = chry_ringbuffer_linear_write_setup(&rb, &size);
+
+        if (size > STREAM_SIZE - pos) {
+            size = STREAM_SIZE - pos;
+        }
+        if (size > chunk) {
+            size = chunk;
+        }
+        if (size == 0) {
+            sched_yield();
+            continue;
+        }
+        for (uint32_t i = 0; i < size; i++) {
+            p[i] = pattern(pos + i);
+        }
+        pos += chry_ringbuffer_linear_write_done(&rb, size);
+    }
+    return NULL;
+}
+
+static void *linear_reader(void *arg)
+{
+    uint32_t pos = 0;
+
+    (void)arg;
+    while ((pos < STREAM_SIZE) && !failure_cnt()) {
+        uint32_t size;
+        uint8_t *p = chry_ringbuffer_linear_read_setup(&rb, &size);
+
+        if (size == 0) {
+            sched_yield();
+            continue;
+        }
+        for (uint32_t i = 0; i < size; i++) {
+            if (p[i] != pattern(pos + i)) {
+                fail("linear byte wrong", pos + i);
+                return NULL;
+            }
+        }
+        pos += chry_ringbuffer_linear_read_done(&rb, size);
+    }
+    return NULL;
+}
+
+/* record n has 1 + n % RECORD_MAX byte of the pattern starting at n */
+static void *record_writer(void *arg)
+{
+    uint8_t buf[RECORD_MAX];
+
+    (void)arg;
+    for (uint32_t n = 0; (n < RECORD_CNT) && !failure_cnt();) {
+        uint32_t len = 1 + n % RECORD_MAX;
+
+        for (uint32_t i = 0; i < len; i++) {
+            buf[i] = pattern(n + i);
+        }
+        if (chry_ringbuffer_write_record(&rb, buf, len) == len) {
+            n++;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *record_reader(void *arg)
+{
+    (void)arg;
+    for (uint32_t n = 0; (n < RECORD_CNT) && !failure_cnt();) {
+        chry_ringbuffer_seg_t seg[2];
+        uint32_t len = chry_ringbuffer_read_record(&rb, seg);
+        uint32_t i = 0;
+
+        if (len == 0) {
+            sched_yield();
+            continue;
+        }
+        if ((len != 1 + n % RECORD_MAX) || (seg[0].size + seg[1].size != len)) {
+            fail("record length wrong", n);
+            return NULL;
+        }
+        for (int s = 0; s < 2; s++) {
+            for (uint32_t j = 0; j < seg[s].size; j++, i++) {
+                if (((uint8_t *)seg[s].buf)[j] != pattern(n + i)) {
+                    fail("record byte wrong", n);
+                    return NULL;
+                }
+            }
+        }
+        chry_ringbuffer_drop_record(&rb);
+        n++;
+    }
+    return NULL;
+}
+
+static void run_pair(const char *name, void *(*writer)(void *), void *(*reader)(void *))
+{
+    pthread_t w, r;
+    int before = failure_cnt();
+
+    chry_ringbuffer_init(&rb, pool, sizeof(pool));
+    pthread_create(&w, NULL, writer, NULL);
+    pthread_create(&r, NULL, reader, NULL);
+    pthread_join(w, NULL);
+    pthread_join(r, NULL);
+    printf("spsc %-24s %s\n", name, (failure_cnt() == before) ? "ok" : "FAIL");
+}
+
+static void *mpmc_writer(void *arg)
+{
+    msg_t m = {.writer = (uint32_t)(uintptr_t)arg};
+
+    while ((m.seq < MPMC_MSG_CNT) && !failure_cnt()) {
+        uint32_t w = chry_ringbuffer_mpmc_write(&mpmc, &m, sizeof(m));
+
+        if (w == sizeof(m)) {
+            m.seq++;
+        } else if (w == 0) {
+            sched_yield();
+        } else {
+            fail("mpmc partial write", m.seq);
+        }
+    }
+    return NULL;
+}
+
+static uint32_t mpmc_left;
+static uint64_t mpmc_sum[MPMC_WRITERS];
+static uint32_t mpmc_cnt[MPMC_WRITERS];
+
+static void *mpmc_reader(void *arg)
+{
+    uint32_t last[MPMC_WRITERS];
+
+    (void)arg;
+    memset(last, 0xff, sizeof(last));
+    while (__atomic_load_n(&mpmc_left, __ATOMIC_RELAXED) && !failure_cnt()) {
+        msg_t m;
+        uint32_t r = chry_ringbuffer_mpmc_read(&mpmc, &m, sizeof(m));
+
+        if (r == 0) {
+            sched_yield();
+            continue;
+        }
+        if (r != sizeof(m)) {
+            fail("mpmc partial read", r);
+        } else if ((m.writer >= MPMC_WRITERS) || (m.seq >= MPMC_MSG_CNT)) {
+            fail("mpmc garbage message", m.seq);
+        } else if ((last[m.writer] != UINT32_MAX) && (m.seq <= last[m.writer])) {
+            fail("mpmc message out of order", m.seq);
+        } else {
+            last[m.writer] = m.seq;
+            __atomic_add_fetch(&mpmc_sum[m.writer], m.seq, __ATOMIC_RELAXED);
+            __atomic_add_fetch(&mpmc_cnt[m.writer], 1, __ATOMIC_RELAXED);
+            __atomic_sub_fetch(&mpmc_left, 1, __ATOMIC_RELAXED);
+        }
+    }
+    return NULL;
+}
+
+static void run_mpmc(void)
+{
+    pthread_t w[MPMC_WRITERS], r[MPMC_READERS];
+    int before = failure_cnt();
+
+    chry_ringbuffer_mpmc_init(&mpmc, pool, sizeof(pool));
+    mpmc_left = MPMC_WRITERS * MPMC_MSG_CNT;
+    for (uintptr_t i = 0; i < MPMC_READERS; i++) {
+        pthread_create(&r[i], NULL, mpmc_reader, (void *)i);
+    }
+    for (uintptr_t i = 0; i < MPMC_WRITERS; i++) {
+        pthread_create(&w[i], NULL, mpmc_writer, (void *)i);
+    }
+    for (int i = 0; i < MPMC_WRITERS; i++) {
+        pthread_join(w[i], NULL);
+    }
+    for (int i = 0; i < MPMC_READERS; i++) {
+        pthread_join(r[i], NULL);
+    }
+    for (int i = 0; i < MPMC_WRITERS; i++) {
+        if ((mpmc_cnt[i] != MPMC_MSG_CNT) || (mpmc_sum[i] != (uint64_t)MPMC_MSG_CNT * (MPMC_MSG_CNT - 1) / 2)) {
+            fail("mpmc messages lost or repeated, writer", i);
+        }
+    }
+    if (chry_ringbuffer_mpmc_get_used(&mpmc) != 0) {
+        fail("mpmc not empty, used", chry_ringbuffer_mpmc_get_used(&mpmc));
+    }
+    printf("mpmc %d writers, %d readers      %s\n", MPMC_WRITERS, MPMC_READERS, (failure_cnt() == before) ? "ok" : "FAIL");
+}
+
+int main(void)
+{
+    static const uint32_t chunks[] = {1, 7, 64, 1000};
+    char name[32];
+
+    for (unsigned i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        chunk = chunks[i];
+        snprintf(name, sizeof(name), "write/read, chunk %u", chunk);
+        run_pair(name, stream_writer, stream_reader);
+    }
+    chunk = 512;
+    run_pair("linear setup/done", linear_writer, linear_reader);
+    run_pair("records", record_writer, record_reader);
+    run_mpmc();
+
+    printf(failure_cnt() ? "FAILED\n" : "PASSED.\n");
+    return failure_cnt() ? 1 : 0;
+}
@@ -166,6 +166,12 @@
 //#define ERPC_TRANSPORT_MU_USE_MCMGR ERPC_TRANSPORT_MU_USE_MCMGR_DISABLED
 //@}
 
+//! @def ERPC_CRC16_SLICES
+//!
+//! Bytes processed per step of the software CRC-16 over each message: 1 (512 B of tables) or 4 (2 KiB of tables,
+//! about 3.5 times faster). Default value is set to 4.
+//#define ERPC_CRC16_SLICES (4U)
+
 //! @def ERPC_PRE_POST_ACTION
 //!
 //! Enable eRPC pre and post callback functions shim code. Take look into "erpc_pre_post_action.h". Can be used for
@@ -49,7 +49,8 @@ public:
     /*!
      * @brief Compute a ITU-CCITT CRC-16 over the provided data.
      *
-     * This implementation is slow but small in size.
+     * Table driven, ERPC_CRC16_SLICES bytes per step. A backend registered with erpc_crc16_set_backend()
+     * replaces it for data of at least its minimum length.
      *
      * @param[in] data Pointer to data used for crc16.
      * @param[in] lengthInBytes Data length.
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ * All rights reserved.
+ *
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _EMBEDDED_RPC__CRC16_BACKEND_H_
+#define _EMBEDDED_RPC__CRC16_BACKEND_H_
+
+#include <stdint.h>
+
+/*!
+ * @addtogroup infra_transport
+ * @{
+ * @file
+ */
+
+////////////////////////////////////////////////////////////////////////////////
+// Types
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+ * @brief CRC-16 compute function.
+ *
+ * Must return the ITU-CCITT CRC-16 (poly 0x1021, no reflection, no final XOR) of the data.
+ *
+ * @param[in] crcStart Start value for crc function.
+ * @param[in] data Pointer to data used for crc16.
+ * @param[in] lengthInBytes Data length.
+ *
+ * @return Computed CRC-16.
+ */
+typedef uint16_t (*erpc_crc16_backend_t)(uint16_t crcStart, const uint8_t *data, uint32_t lengthInBytes);
+
+////////////////////////////////////////////////////////////////////////////////
+// API
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * @brief Replace the software CRC-16 of all Crc16 objects, e.g. by a CRC peripheral.
+ *
+ * Call it before any eRPC message is sent or received.
+ *
+ * @param[in] backend Compute function, NULL restores the software implementation.
+ * @param[in] minLength Shorter data is still computed in software, where the peripheral setup costs more than
+ * the CRC itself.
+ */
+void erpc_crc16_set_backend(erpc_crc16_backend_t backend, uint32_t minLength);
+
+/*!
+ * @brief Compute the CRC-16 in software, for backends falling back on it.
+ *
+ * @param[in] crcStart Start value for crc function.
+ * @param[in] data Pointer to data used for crc16.
+ * @param[in] lengthInBytes Data length.
+ *
+ * @return Computed CRC-16.
+ */
+uint16_t erpc_crc16_compute_software(uint16_t crcStart, const uint8_t *data, uint32_t lengthInBytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+/*! @} */
+
+#endif // _EMBEDDED_RPC__CRC16_BACKEND_H_
@@ -185,6 +185,16 @@
     #endif
 #endif
 
+// Set default CRC-16 slicing.
+#if !defined(ERPC_CRC16_SLICES)
+    //! @brief Bytes folded per step of the software CRC-16.
+    #define ERPC_CRC16_SLICES (4U)
+#endif
+
+#if (ERPC_CRC16_SLICES != 1U) && (ERPC_CRC16_SLICES != 4U)
+    #error "ERPC_CRC16_SLICES must be 1 or 4."
+#endif
+
 // Disabling pre and post callback function related code.
 #if !defined(ERPC_PRE_POST_ACTION)
     #define ERPC_PRE_POST_ACTION (ERPC_PRE_POST_ACTION_DISABLED)
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ * All rights reserved.
+ *
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "erpc_crc16_hpm.h"
+#include "erpc_config_internal.h"
+#include "erpc_crc16_backend.h"
+#include "erpc_manually_constructed.hpp"
+#include "erpc_threading.h"
+
+using namespace erpc;
+
+////////////////////////////////////////////////////////////////////////////////
+// Variables
+////////////////////////////////////////////////////////////////////////////////
+
+static CRC_Type *s_crcBase = NULL;
+static uint32_t s_crcChannel;
+#if !ERPC_THREADS_IS(NONE)
+ERPC_MANUALLY_CONSTRUCTED(Mutex, s_crcMutex);
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Code
+////////////////////////////////////////////////////////////////////////////////
+
+static uint16_t erpc_crc16_hpm_compute(uint16_t crcStart, const uint8_t *data, uint32_t lengthInBytes)
+{
+#if !ERPC_THREADS_IS(NONE)
+    Mutex::Guard lock(*s_crcMutex.get());
+#endif
+    crc_channel_config_t config;
+
+    // ITU-CCITT, the start value of the Crc16 object
+    config.preset = crc_preset_none;
+    config.init = crcStart;
+    config.poly = 0x1021U;
+    config.poly_width = CRC_POLY_WIDTH_16;
+    config.in_byte_order = crc_in_byte_order_lsb;
+    config.refin = crc_refin_false;
+    config.refout = crc_refout_false;
+    config.xorout = 0U;
+    (void)crc_setup_channel_config(s_crcBase, s_crcChannel, &config);
+
+    crc_calc_large_block_fast(s_crcBase, s_crcChannel, const_cast<uint8_t *>(data), lengthInBytes);
+
+    return (uint16_t)crc_get_result(s_crcBase, s_crcChannel);
+}
+
+hpm_stat_t erpc_crc16_hpm_init(CRC_Type *base, uint32_t channel)
+{
+    if ((base == NULL) || (channel >= ARRAY_SIZE(base->CHN)))
+    {
+        return status_invalid_argument;
+    }
+
+#if !ERPC_THREADS_IS(NONE)
+    if (!s_crcMutex.isUsed())
+    {
+        s_crcMutex.construct();
+    }
+#endif
+
+    s_crcBase = base;
+    s_crcChannel = channel;
+    erpc_crc16_set_backend(erpc_crc16_hpm_compute, ERPC_CRC16_HPM_MIN_LENGTH);
+
+    return status_success;
+}
+
+void erpc_crc16_hpm_deinit(void)
+{
+    erpc_crc16_set_backend(NULL, 0U);
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ * All rights reserved.
+ *
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _EMBEDDED_RPC__CRC16_HPM_H_
+#define _EMBEDDED_RPC__CRC16_HPM_H_
+
+#include "hpm_common.h"
+#include "hpm_crc_drv.h"
+
+/*!
+ * @addtogroup port_crc16_hpm
+ * @{
+ * @file
+ */
+
+//! @brief Messages shorter than this are checked in software, the table is faster than the channel setup.
+#ifndef ERPC_CRC16_HPM_MIN_LENGTH
+#define ERPC_CRC16_HPM_MIN_LENGTH (64U)
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// API
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * @brief Compute the eRPC CRC-16 with a channel of the CRC peripheral.
+ *
+ * The channel is reconfigured for every message, it must not be used by anything else. Each core needs its own
+ * channel, the calls of one core are serialized with a mutex when eRPC uses threads.
+ *
+ * @param[in] base CRC base address.
+ * @param[in] channel CRC channel index.
+ *
+ * @retval status_invalid_argument Invalid base or channel.
+ * @retval status_success
+ */
+hpm_stat_t erpc_crc16_hpm_init(CRC_Type *base, uint32_t channel);
+
+/*!
+ * @brief Return to the software CRC-16.
+ */
+void erpc_crc16_hpm_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/*! @} */
+
+#endif // _EMBEDDED_RPC__CRC16_HPM_H_
@@ -30,13 +30,19 @@ struct rpmsg_lite_instance *RPMsgBaseTransport::s_rpmsg = NULL;
 int32_t RPMsgTransport::rpmsg_read_cb(void *payload, uint32_t payload_len, uint32_t src, void *priv)
 {
     RPMsgTransport *transport = (RPMsgTransport *)priv;
+    int32_t ret_val = RL_RELEASE;
+
+    /* Only a queued payload is held, any other buffer goes back to rpmsg right away. */
     if (payload_len <= ERPC_DEFAULT_BUFFER_SIZE)
     {
         MessageBuffer message((uint8_t *)payload, payload_len);
         message.setUsed((uint16_t)payload_len);
-        (void)transport->m_messageQueue.add(message);
+        if (transport->m_messageQueue.add(message))
+        {
+            ret_val = RL_HOLD;
+        }
     }
-    return RL_HOLD;
+    return ret_val;
 }
 
 RPMsgTransport::RPMsgTransport(void)
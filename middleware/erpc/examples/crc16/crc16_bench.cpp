@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * erpc::Crc16 against the bitwise ITU-CCITT CRC-16 it replaced
+ *
+ * 1. Every length from 0 to CHECK_LEN at the buffer offsets 0 to 7, with the default and with
+ *    random start values, must give the bitwise CRC. A CRC chained over pieces must equal the
+ *    CRC of the whole, and a backend must only be called from its minimum length on.
+ * 2. MB/s of the bitwise loop and of computeCRC16() for 16 B to 64 KiB, the best of
+ *    BENCH_REPEAT runs of BENCH_BYTES each.
+ *
+ * Built for ERPC_CRC16_SLICES 4 and 1:
+ * ./crc16/Crc16Bench, ./crc16/Crc16BenchSlice1
+ */
+
+#include "erpc_crc16.hpp"
+#include "erpc_crc16_backend.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+using namespace erpc;
+
+#define CHECK_LEN (4100U)
+#define MAX_LEN (64U * 1024U)
+#define BENCH_BYTES (16U << 20)
+#define BENCH_REPEAT (5)
+
+static uint8_t s_data[MAX_LEN + 8];
+static uint32_t s_backendCalls;
+static int s_failures;
+
+/* the bytewise shift register of the original erpc_crc16.cpp */
+static uint16_t crc16Bitwise(uint32_t crc, const uint8_t *data, uint32_t lengthInBytes)
+{
+    for (uint32_t j = 0; j < lengthInBytes; ++j)
+    {
+        crc ^= (uint32_t)data[j] << 8;
+        for (uint32_t i = 0; i < 8U; ++i)
+        {
+            uint32_t temp = crc << 1;
+            if ((crc & 0x8000U) != 0U)
+            {
+                temp ^= 0x1021U;
+            }
+            crc = temp;
+        }
+    }
+
+    return (uint16_t)crc;
+}
+
+static uint16_t countingBackend(uint16_t crcStart, const uint8_t *data, uint32_t lengthInBytes)
+{
+    ++s_backendCalls;
+    return erpc_crc16_compute_software(crcStart, data, lengthInBytes);
+}
+
+static double timeSeconds(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void check(bool ok, const char *what, uint32_t offset, uint32_t length)
+{
+    if (!ok)
+    {
+        printf("%s, offset %u, %u byte\n", what, offset, length);
+        ++s_failures;
+    }
+}
+
+static void checkLengths(uint32_t crcStart)
+{
+    Crc16 crc(crcStart);
+
+    for (uint32_t offset = 0; offset < 8U; ++offset)
+    {
+        for (uint32_t length = 0; length <= CHECK_LEN; ++length)
+        {
+            if (crc.computeCRC16(s_data + offset, length) != crc16Bitwise(crcStart, s_data + offset, length))
+            {
+                check(false, "CRC differs from the bitwise CRC", offset, length);
+                return;
+            }
+        }
+    }
+}
+
+static void checkChained(void)
+{
+    uint16_t whole = crc16Bitwise(0xEF4AU, s_data, MAX_LEN);
+    uint32_t pos = 0;
+    uint16_t crc = 0xEF4AU;
+
+    /* no final XOR, so the CRC of one piece is the start value of the next */
+    while (pos < MAX_LEN)
+    {
+        uint32_t length = 1U + (uint32_t)rand() % 3000U;
+        if (length > MAX_LEN - pos)
+        {
+            length = MAX_LEN - pos;
+        }
+        crc = erpc_crc16_compute_software(crc, s_data + pos, length);
+        pos += length;
+    }
+    check(crc == whole, "CRC chained over pieces differs", 0, MAX_LEN);
+}
+
+static void checkBackend(void)
+{
+    Crc16 crc;
+
+    s_backendCalls = 0;
+    erpc_crc16_set_backend(countingBackend, 64U);
+    check(crc.computeCRC16(s_data, 63U) == crc16Bitwise(0xEF4AU, s_data, 63U), "CRC below the backend minimum wrong",
+          0, 63U);
+    check(crc.computeCRC16(s_data, 64U) == crc16Bitwise(0xEF4AU, s_data, 64U), "CRC of the backend wrong", 0, 64U);
+    erpc_crc16_set_backend(NULL, 0);
+    check(crc.computeCRC16(s_data, 100U) == crc16Bitwise(0xEF4AU, s_data, 100U), "CRC after removing the backend wrong",
+          0, 100U);
+    check(s_backendCalls == 1U, "backend not called exactly from its minimum length", 0, 64U);
+}
+
+static void bench(uint32_t length)
+{
+    Crc16 crc;
+    uint32_t calls = BENCH_BYTES / length;
+    double bestBitwise = 1e9;
+    double bestTable = 1e9;
+    volatile uint16_t sink;
+
+    for (int r = 0; r < BENCH_REPEAT; ++r)
+    {
+        double t0 = timeSeconds();
+        /* the bitwise loop runs an eighth of the calls to keep the run short */
+        for (uint32_t i = 0; i < calls / 8U; ++i)
+        {
+            sink = crc16Bitwise(0xEF4AU, s_data, length);
+        }
+        double t1 = timeSeconds();
+        for (uint32_t i = 0; i < calls; ++i)
+        {
+            sink = crc.computeCRC16(s_data, length);
+        }
+        double t2 = timeSeconds();
+
+        bestBitwise = ((t1 - t0) * 8 < bestBitwise) ? (t1 - t0) * 8 : bestBitwise;
+        bestTable = (t2 - t1 < bestTable) ? t2 - t1 : bestTable;
+    }
+    (void)sink;
+
+    double bytes = (double)calls * length;
+    printf("  %6u byte: bitwise %7.1f MB/s, computeCRC16 %7.1f MB/s, %5.1fx\n", length, bytes / bestBitwise / 1e6,
+           bytes / bestTable / 1e6, bestBitwise / bestTable);
+}
+
+int main(void)
+{
+    srand(1);
+    for (uint32_t i = 0; i < sizeof(s_data); ++i)
+    {
+        s_data[i] = (uint8_t)rand();
+    }
+
+    printf("ERPC_CRC16_SLICES %u\n", (unsigned)ERPC_CRC16_SLICES);
+    checkLengths(0xEF4AU);
+    for (int i = 0; i < 4; ++i)
+    {
+        checkLengths((uint32_t)rand() & 0xFFFFU);
+    }
+    checkChained();
+    checkBackend();
+    printf("lengths 0 to %u at offsets 0 to 7 %s\n", CHECK_LEN, s_failures ? "FAIL" : "ok");
+
+    for (uint32_t length = 16U; length <= MAX_LEN; length *= 2U)
+    {
+        bench(length);
+    }
+
+    printf(s_failures ? "FAILED\n" : "PASSED.\n");
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef RPMSG_CONFIG_H_
+#define RPMSG_CONFIG_H_
+
+#include "erpc_config_internal.h"
+
+/*
+ * RPMsg-Lite of the host examples over the POSIX environment and platform.
+ *
+ * The rpmsg buffers are larger than ERPC_DEFAULT_BUFFER_SIZE and more than the
+ * ERPC_DEFAULT_BUFFERS_COUNT - 1 messages the bare-metal eRPC transport queues, so
+ * both kinds of payload its rx callback does not queue can be sent to it.
+ */
+#define RL_MS_PER_INTERVAL (1)
+#define RL_BUFFER_PAYLOAD_SIZE (496U)
+#define RL_BUFFER_COUNT (8U)
+#define RL_API_HAS_ZEROCOPY (1)
+#define RL_USE_STATIC_API (0)
+#define RL_CLEAR_USED_BUFFERS (0)
+#define RL_USE_MCMGR_IPC_ISR_HANDLER (0)
+#define RL_USE_ENVIRONMENT_CONTEXT (0)
+#define RL_DEBUG_CHECK_BUFFERS (0)
+
+#endif /* RPMSG_CONFIG_H_ */
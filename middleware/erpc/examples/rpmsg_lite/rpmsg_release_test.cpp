@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Rx buffer release of the bare-metal eRPC RPMsg transport (erpc_rpmsg_lite_transport.cpp)
+ *
+ * Two processes stand in for the two cores over the POSIX RPMsg-Lite environment and platform.
+ * The remote runs RPMsgTransport with the RPMsg message buffer factory, the master talks plain
+ * RPMsg-Lite to it. The rx callback of RPMsgTransport may only hold the buffers it queued:
+ *
+ * 1. Payloads larger than ERPC_DEFAULT_BUFFER_SIZE are not queued and must go back to the ring.
+ * 2. A burst sent while the remote does not receive overflows the transport queue, the payloads
+ *    it drops must go back to the ring as well.
+ *
+ * Every round sends more of both than the ring has buffers, so a single leaked buffer per round
+ * ends the test: the master gets no tx buffer within ALLOC_TIMEOUT_MS. An echo after each step
+ * checks that the remote is still served and only queued the payloads it should, and at the end
+ * all RL_BUFFER_COUNT tx buffers of the master must be free again.
+ *
+ * ./rpmsg_lite/RpmsgReleaseTest [rounds] (default 50)
+ */
+
+#include "erpc_config_internal.h"
+#include "erpc_mbf_setup.h"
+#include "erpc_rpmsg_lite_transport.hpp"
+
+extern "C" {
+#include "rpmsg_lite.h"
+#include "rpmsg_platform.h"
+#include "rpmsg_queue.h"
+}
+
+#include <cstdio>
+#include <cstdlib>
+#include <csignal>
+#include <cstring>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace erpc;
+
+#define SHM_NAME "/erpc_rpmsg_release_test"
+#define SHM_SIZE (64U * 1024U)
+#define MASTER_ADDR (100U)
+#define REMOTE_ADDR (101U)
+#define ALLOC_TIMEOUT_MS (2000U)
+#define REPLY_TIMEOUT_MS (2000U)
+#define STALL_MS (20U)
+#define ROUNDS (50)
+
+/* messages the bare-metal transport queues, its StaticQueue keeps one slot free */
+#define QUEUE_LEN (ERPC_DEFAULT_BUFFERS_COUNT - 1U)
+
+enum
+{
+    kCmdEcho,     /*!< reply with the same seq */
+    kCmdOversize, /*!< RL_BUFFER_PAYLOAD_SIZE bytes, must never be queued */
+    kCmdStall,    /*!< stop receiving for arg ms, then reply with the number of kCmdBurst queued */
+    kCmdBurst,    /*!< sent after kCmdStall */
+    kCmdQuit,     /*!< reply and end the remote */
+    kCmdError,    /*!< reply: the remote received a message it should not have */
+};
+
+typedef struct
+{
+    uint32_t type;
+    uint32_t seq;
+    uint32_t arg;
+} cmd_t;
+
+static struct rpmsg_lite_instance *s_master;
+static struct rpmsg_lite_endpoint *s_ept;
+static rpmsg_queue_handle s_queue;
+static uint32_t s_seq;
+static int s_failures;
+
+static void fail(const char *what, uint32_t arg)
+{
+    printf("%s: %u\n", what, arg);
+    ++s_failures;
+}
+
+/* remote: answer the commands through RPMsgTransport until kCmdQuit */
+static int runRemote(int ready)
+{
+    void *base = platform_shmem_map(SHM_NAME, SHM_SIZE, 0);
+    RPMsgTransport transport;
+
+    if ((base == NULL) || (transport.init(REMOTE_ADDR, MASTER_ADDR, base, RL_PLATFORM_POSIX_LINK_ID, NULL, NULL) !=
+                           kErpcStatus_Success))
+    {
+        printf("remote init failed\n");
+        return 1;
+    }
+    MessageBufferFactory *mbf =
+        reinterpret_cast<MessageBufferFactory *>(erpc_mbf_rpmsg_init(reinterpret_cast<erpc_transport_t>(&transport)));
+
+    /* the endpoint exists, the master may send */
+    (void)write(ready, "r", 1);
+    (void)close(ready);
+
+    for (bool quit = false; !quit;)
+    {
+        MessageBuffer message;
+        cmd_t cmd;
+        cmd_t reply;
+
+        /* RPMsgTransport::receive() spins, wait for a message without burning the cpu first */
+        while (!transport.hasMessage())
+        {
+            usleep(50);
+        }
+        (void)transport.receive(&message);
+        memcpy(&cmd, message.get(), sizeof(cmd));
+        reply = cmd;
+
+        switch (cmd.type)
+        {
+            case kCmdEcho:
+                break;
+            case kCmdStall:
+                usleep(cmd.arg * 1000U);
+                reply.arg = 0;
+                while (transport.hasMessage())
+                {
+                    MessageBuffer burst;
+                    cmd_t got;
+
+                    (void)transport.receive(&burst);
+                    memcpy(&got, burst.get(), sizeof(got));
+                    reply.arg += (got.type == kCmdBurst) ? 1U : 1000U;
+                    mbf->dispose(&burst);
+                }
+                break;
+            case kCmdQuit:
+                quit = true;
+                break;
+            default:
+                reply.type = kCmdError;
+                reply.arg = message.getUsed();
+                break;
+        }
+
+        if (mbf->prepareServerBufferForSend(&message) != kErpcStatus_Success)
+        {
+            printf("remote has no tx buffer\n");
+            return 1;
+        }
+        memcpy(message.get(), &reply, sizeof(reply));
+        message.setUsed(sizeof(reply));
+        if (transport.send(&message) != kErpcStatus_Success)
+        {
+            printf("remote send failed\n");
+            return 1;
+        }
+    }
+
+    /* let the master take the last reply before the link goes down */
+    sleep(1);
+    return 0;
+}
+
+static bool sendCmd(uint32_t type, uint32_t arg, uint32_t length)
+{
+    uint32_t size;
+    void *buf = rpmsg_lite_alloc_tx_buffer(s_master, &size, ALLOC_TIMEOUT_MS);
+    cmd_t cmd = {type, s_seq, arg};
+
+    if (buf == NULL)
+    {
+        fail("no tx buffer, the remote leaked rx buffers, command", type);
+        return false;
+    }
+    memset(buf, 0x5a, length);
+    memcpy(buf, &cmd, sizeof(cmd));
+    if (rpmsg_lite_send_nocopy(s_master, s_ept, REMOTE_ADDR, buf, length) != RL_SUCCESS)
+    {
+        fail("send failed, command", type);
+        return false;
+    }
+    return true;
+}
+
+/* the reply to the last command */
+static bool recvReply(cmd_t *reply, uint32_t timeout)
+{
+    uint32_t src;
+    uint32_t length;
+
+    do
+    {
+        if (rpmsg_queue_recv(s_master, s_queue, &src, (char *)reply, sizeof(*reply), &length, timeout) != RL_SUCCESS)
+        {
+            return false;
+        }
+    } while (reply->seq != s_seq);
+
+    return true;
+}
+
+static bool echo(const char *after)
+{
+    cmd_t reply;
+
+    ++s_seq;
+    if (!sendCmd(kCmdEcho, 0, sizeof(cmd_t)))
+    {
+        return false;
+    }
+    if (!recvReply(&reply, REPLY_TIMEOUT_MS) || (reply.type != kCmdEcho))
+    {
+        printf("after %s: ", after);
+        fail("no echo, remote replied", reply.type);
+        return false;
+    }
+    return true;
+}
+
+static bool runRound(void)
+{
+    cmd_t reply;
+
+    /* 1. never queued: too large for ERPC_DEFAULT_BUFFER_SIZE */
+    for (uint32_t i = 0; i < 2U * RL_BUFFER_COUNT; ++i)
+    {
+        if (!sendCmd(kCmdOversize, 0, RL_BUFFER_PAYLOAD_SIZE))
+        {
+            return false;
+        }
+    }
+    if (!echo("oversized payloads"))
+    {
+        return false;
+    }
+
+    /* 2. the transport queue overflows while the remote sleeps */
+    ++s_seq;
+    if (!sendCmd(kCmdStall, STALL_MS, sizeof(cmd_t)))
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < 2U * RL_BUFFER_COUNT; ++i)
+    {
+        if (!sendCmd(kCmdBurst, i, sizeof(cmd_t)))
+        {
+            return false;
+        }
+    }
+    if (!recvReply(&reply, REPLY_TIMEOUT_MS + STALL_MS) || (reply.type != kCmdStall) || (reply.arg > QUEUE_LEN))
+    {
+        fail("burst: wrong number of queued messages", reply.arg);
+        return false;
+    }
+
+    return echo("burst");
+}
+
+int main(int argc, char *argv[])
+{
+    int rounds = (argc > 1) ? atoi(argv[1]) : ROUNDS;
+    cmd_t reply;
+    int ready[2];
+    char up;
+    pid_t pid;
+    int status;
+
+    if (rounds <= 0)
+    {
+        printf("Usage: ./RpmsgReleaseTest [rounds]\n");
+        return 1;
+    }
+
+    if (pipe(ready) != 0)
+    {
+        printf("pipe failed\nFAILED\n");
+        return 1;
+    }
+    pid = fork();
+    if (pid == 0)
+    {
+        (void)close(ready[0]);
+        return runRemote(ready[1]);
+    }
+    (void)close(ready[1]);
+
+    void *base = platform_shmem_map(SHM_NAME, SHM_SIZE, 1);
+    if (base == NULL)
+    {
+        printf("master shared memory map failed\nFAILED\n");
+        return 1;
+    }
+    s_master = rpmsg_lite_master_init(base, SHM_SIZE, RL_PLATFORM_POSIX_LINK_ID, RL_NO_FLAGS);
+    s_queue = (s_master != NULL) ? rpmsg_queue_create(s_master) : NULL;
+    s_ept = (s_queue != NULL) ? rpmsg_lite_create_ept(s_master, MASTER_ADDR, rpmsg_queue_rx_cb, s_queue) : NULL;
+    if (s_ept == NULL)
+    {
+        printf("master init failed\nFAILED\n");
+        return 1;
+    }
+
+    /* what arrives before the endpoint of the remote exists is dropped */
+    if ((read(ready[0], &up, 1) != 1) || !echo("init"))
+    {
+        fail("remote not up", 0);
+    }
+
+    int done = 0;
+    while ((done < rounds) && (s_failures == 0) && runRound())
+    {
+        ++done;
+    }
+    printf("%d of %d rounds of %u oversized payloads and bursts of %u, %u queued by the transport\n", done, rounds,
+           2U * RL_BUFFER_COUNT, 2U * RL_BUFFER_COUNT, QUEUE_LEN);
+
+    if (s_failures == 0)
+    {
+        ++s_seq;
+        if (!sendCmd(kCmdQuit, 0, sizeof(cmd_t)) || !recvReply(&reply, REPLY_TIMEOUT_MS))
+        {
+            fail("no reply to quit", s_seq);
+        }
+        /* every tx buffer of the master is an rx buffer of the remote, all must be back */
+        for (uint32_t i = 0; (i < RL_BUFFER_COUNT) && (s_failures == 0); ++i)
+        {
+            uint32_t size;
+            if (rpmsg_lite_alloc_tx_buffer(s_master, &size, ALLOC_TIMEOUT_MS) == NULL)
+            {
+                fail("rx buffers not released by the remote", RL_BUFFER_COUNT - i);
+            }
+        }
+    }
+    else
+    {
+        (void)kill(pid, SIGKILL);
+    }
+
+    (void)waitpid(pid, &status, 0);
+    if ((s_failures == 0) && (!WIFEXITED(status) || (WEXITSTATUS(status) != 0)))
+    {
+        fail("remote failed, status", (uint32_t)status);
+    }
+    (void)rpmsg_lite_destroy_ept(s_master, s_ept);
+    (void)rpmsg_queue_destroy(s_master, s_queue);
+    (void)rpmsg_lite_deinit(s_master);
+    platform_shmem_unmap();
+
+    printf(s_failures ? "FAILED\n" : "PASSED.\n");
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,382 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Round trip of eRPC messages over RPMsgRTOSTransport (erpc_rpmsg_lite_rtos_transport.cpp)
+ *
+ * Two processes stand in for the two cores over the POSIX RPMsg-Lite environment and platform.
+ * The master sends a BasicCodec invocation with a binary payload, the remote replies with every
+ * payload byte incremented and the master checks the reply.
+ *
+ *   zero-copy: the RPMsg message buffer factory serializes into rpmsg tx buffers, the transport
+ *              sends them with rpmsg_lite_send_nocopy() and holds the received ones
+ *   copy:      the same messages serialized into local buffers, sent with rpmsg_lite_send() and
+ *              received with rpmsg_queue_recv(), both copying
+ *
+ * calls/s and the p50 / p99 latency of a call are printed for payloads of 16 to 448 bytes.
+ *
+ * ./rpmsg_lite/RpmsgRoundTrip [calls] (default 5000 per payload size)
+ */
+
+#include "erpc_basic_codec.hpp"
+#include "erpc_mbf_setup.h"
+#include "erpc_rpmsg_lite_rtos_transport.hpp"
+
+extern "C" {
+#include "rpmsg_platform.h"
+#include "rpmsg_queue.h"
+}
+
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace erpc;
+
+#define SHM_NAME "/erpc_rpmsg_round_trip"
+#define SHM_SIZE (64U * 1024U)
+#define MASTER_ADDR (100U)
+#define REMOTE_ADDR (101U)
+#define CALLS (5000)
+#define MAX_MESSAGE (512U)
+
+static const uint32_t s_sizes[] = { 16U, 64U, 256U, 448U };
+#define SIZE_CNT (sizeof(s_sizes) / sizeof(s_sizes[0]))
+
+/* the copying path borrows the endpoint and queue the transport keeps protected */
+class RoundTripTransport : public RPMsgRTOSTransport
+{
+public:
+    erpc_status_t sendCopy(const uint8_t *data, uint32_t length)
+    {
+        return (rpmsg_lite_send(s_rpmsg, m_rpmsg_ept, m_dst_addr, (char *)data, length, RL_BLOCK) == RL_SUCCESS) ?
+                   kErpcStatus_Success :
+                   kErpcStatus_SendFailed;
+    }
+
+    erpc_status_t receiveCopy(uint8_t *data, uint32_t *length)
+    {
+        uint32_t src;
+        return (rpmsg_queue_recv(s_rpmsg, m_rpmsg_queue, &src, (char *)data, MAX_MESSAGE, length, RL_BLOCK) ==
+                RL_SUCCESS) ?
+                   kErpcStatus_Success :
+                   kErpcStatus_ReceiveFailed;
+    }
+};
+
+static double timeUs(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+/* read an invocation or reply from the codec, the payload stays in the message buffer */
+static bool readMessage(BasicCodec &codec, uint32_t *sequence, uint32_t *length, uint8_t **data)
+{
+    message_type_t type;
+    uint32_t service;
+    uint32_t request;
+
+    codec.startReadMessage(&type, &service, &request, sequence);
+    codec.readBinary(length, data);
+    return codec.isStatusOk();
+}
+
+static void writeMessage(BasicCodec &codec, message_type_t type, uint32_t sequence, uint32_t length,
+                         const uint8_t *data)
+{
+    codec.startWriteMessage(type, 1U, 1U, sequence);
+    codec.writeBinary(length, data);
+}
+
+/* remote: the reply carries every payload byte incremented */
+static int serveZeroCopy(RoundTripTransport &transport, MessageBufferFactory *mbf, long calls)
+{
+    static uint8_t reply[MAX_MESSAGE];
+    BasicCodec codec;
+
+    for (long i = 0; i < calls; ++i)
+    {
+        MessageBuffer message;
+        uint32_t sequence;
+        uint32_t length;
+        uint8_t *data;
+
+        if (transport.receive(&message) != kErpcStatus_Success)
+        {
+            return 1;
+        }
+        codec.setBuffer(message);
+        if (!readMessage(codec, &sequence, &length, &data))
+        {
+            return 1;
+        }
+        for (uint32_t k = 0; k < length; ++k)
+        {
+            reply[k] = (uint8_t)(data[k] + 1U);
+        }
+        if (mbf->prepareServerBufferForSend(codec.getBuffer()) != kErpcStatus_Success)
+        {
+            return 1;
+        }
+        codec.setBuffer(*codec.getBuffer());
+        writeMessage(codec, kReplyMessage, sequence, length, reply);
+        if (!codec.isStatusOk() || (transport.send(codec.getBuffer()) != kErpcStatus_Success))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int serveCopy(RoundTripTransport &transport, long calls)
+{
+    static uint8_t in[MAX_MESSAGE];
+    static uint8_t out[MAX_MESSAGE];
+    static uint8_t reply[MAX_MESSAGE];
+    BasicCodec codec;
+
+    for (long i = 0; i < calls; ++i)
+    {
+        uint32_t received;
+        uint32_t sequence;
+        uint32_t length;
+        uint8_t *data;
+
+        if (transport.receiveCopy(in, &received) != kErpcStatus_Success)
+        {
+            return 1;
+        }
+        MessageBuffer rx(in, sizeof(in));
+        rx.setUsed((uint16_t)received);
+        codec.setBuffer(rx);
+        if (!readMessage(codec, &sequence, &length, &data))
+        {
+            return 1;
+        }
+        for (uint32_t k = 0; k < length; ++k)
+        {
+            reply[k] = (uint8_t)(data[k] + 1U);
+        }
+        MessageBuffer tx(out, sizeof(out));
+        codec.setBuffer(tx);
+        writeMessage(codec, kReplyMessage, sequence, length, reply);
+        if (!codec.isStatusOk() || (transport.sendCopy(out, codec.getBuffer()->getUsed()) != kErpcStatus_Success))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int runRemote(long calls, int ready)
+{
+    void *base = platform_shmem_map(SHM_NAME, SHM_SIZE, 0);
+    RoundTripTransport transport;
+
+    if ((base == NULL) || (transport.init(REMOTE_ADDR, MASTER_ADDR, base, RL_PLATFORM_POSIX_LINK_ID, NULL, NULL) !=
+                           kErpcStatus_Success))
+    {
+        printf("remote init failed\n");
+        return 1;
+    }
+    MessageBufferFactory *mbf =
+        reinterpret_cast<MessageBufferFactory *>(erpc_mbf_rpmsg_init(reinterpret_cast<erpc_transport_t>(&transport)));
+
+    /* the endpoint exists, the master may send */
+    (void)write(ready, "r", 1);
+    (void)close(ready);
+
+    if ((serveZeroCopy(transport, mbf, calls * SIZE_CNT) != 0) || (serveCopy(transport, calls * SIZE_CNT) != 0))
+    {
+        printf("remote failed\n");
+        return 1;
+    }
+
+    /* let the master take the last reply before the link goes down */
+    sleep(1);
+    return 0;
+}
+
+static bool checkReply(BasicCodec &codec, const uint8_t *payload, uint32_t size, uint32_t sequence)
+{
+    uint32_t replySequence;
+    uint32_t length;
+    uint8_t *data;
+
+    if (!readMessage(codec, &replySequence, &length, &data) || (replySequence != sequence) || (length != size))
+    {
+        return false;
+    }
+    for (uint32_t k = 0; k < size; ++k)
+    {
+        if (data[k] != (uint8_t)(payload[k] + 1U))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool callZeroCopy(RoundTripTransport &transport, MessageBufferFactory *mbf, const uint8_t *payload,
+                         uint32_t size, uint32_t sequence)
+{
+    BasicCodec codec;
+    MessageBuffer tx = mbf->create();
+    MessageBuffer rx;
+
+    codec.setBuffer(tx);
+    writeMessage(codec, kInvocationMessage, sequence, size, payload);
+    if (!codec.isStatusOk() || (transport.send(codec.getBuffer()) != kErpcStatus_Success) ||
+        (transport.receive(&rx) != kErpcStatus_Success))
+    {
+        return false;
+    }
+    codec.setBuffer(rx);
+    bool ok = checkReply(codec, payload, size, sequence);
+    mbf->dispose(&rx);
+    return ok;
+}
+
+static bool callCopy(RoundTripTransport &transport, const uint8_t *payload, uint32_t size, uint32_t sequence)
+{
+    static uint8_t in[MAX_MESSAGE];
+    static uint8_t out[MAX_MESSAGE];
+    BasicCodec codec;
+    MessageBuffer tx(out, sizeof(out));
+    uint32_t received;
+
+    codec.setBuffer(tx);
+    writeMessage(codec, kInvocationMessage, sequence, size, payload);
+    if (!codec.isStatusOk() || (transport.sendCopy(out, codec.getBuffer()->getUsed()) != kErpcStatus_Success) ||
+        (transport.receiveCopy(in, &received) != kErpcStatus_Success))
+    {
+        return false;
+    }
+    MessageBuffer rx(in, sizeof(in));
+    rx.setUsed((uint16_t)received);
+    codec.setBuffer(rx);
+    return checkReply(codec, payload, size, sequence);
+}
+
+int main(int argc, char *argv[])
+{
+    long calls = (argc > 1) ? atol(argv[1]) : CALLS;
+    double result[2][SIZE_CNT][3];
+    uint8_t payload[MAX_MESSAGE];
+    uint32_t sequence = 0;
+    int failures = 0;
+    int ready[2];
+    char up;
+    pid_t pid;
+    int status;
+
+    if (calls <= 0)
+    {
+        printf("Usage: ./RpmsgRoundTrip [calls]\n");
+        return 1;
+    }
+
+    if (pipe(ready) != 0)
+    {
+        printf("pipe failed\nFAILED\n");
+        return 1;
+    }
+    pid = fork();
+    if (pid == 0)
+    {
+        (void)close(ready[0]);
+        return runRemote(calls, ready[1]);
+    }
+    (void)close(ready[1]);
+
+    void *base = platform_shmem_map(SHM_NAME, SHM_SIZE, 1);
+    RoundTripTransport *transport = new RoundTripTransport();
+    if ((base == NULL) ||
+        (transport->init(MASTER_ADDR, REMOTE_ADDR, base, SHM_SIZE, RL_PLATFORM_POSIX_LINK_ID) != kErpcStatus_Success))
+    {
+        printf("master init failed\nFAILED\n");
+        return 1;
+    }
+    MessageBufferFactory *mbf =
+        reinterpret_cast<MessageBufferFactory *>(erpc_mbf_rpmsg_init(reinterpret_cast<erpc_transport_t>(transport)));
+
+    /* what arrives before the endpoint of the remote exists is dropped */
+    if (read(ready[0], &up, 1) != 1)
+    {
+        (void)kill(pid, SIGKILL);
+        printf("remote not up\nFAILED\n");
+        return 1;
+    }
+
+    srand(1);
+    for (uint32_t k = 0; k < sizeof(payload); ++k)
+    {
+        payload[k] = (uint8_t)rand();
+    }
+
+    std::vector<double> latency(calls);
+    for (int copy = 0; (copy < 2) && (failures == 0); ++copy)
+    {
+        for (uint32_t s = 0; (s < SIZE_CNT) && (failures == 0); ++s)
+        {
+            double start = timeUs();
+            for (long i = 0; i < calls; ++i)
+            {
+                double t0 = timeUs();
+                bool ok = (copy != 0) ? callCopy(*transport, payload, s_sizes[s], sequence) :
+                                        callZeroCopy(*transport, mbf, payload, s_sizes[s], sequence);
+                latency[i] = timeUs() - t0;
+                ++sequence;
+                if (!ok)
+                {
+                    printf("wrong reply, %u byte, call %ld\n", s_sizes[s], i);
+                    ++failures;
+                    break;
+                }
+            }
+            double elapsed = timeUs() - start;
+            std::sort(latency.begin(), latency.end());
+            result[copy][s][0] = calls / (elapsed / 1e6);
+            result[copy][s][1] = latency[calls / 2];
+            result[copy][s][2] = latency[calls * 99 / 100];
+        }
+    }
+
+    if (failures == 0)
+    {
+        printf("%ld calls per size, calls/s, p50 and p99 us\n", calls);
+        for (uint32_t s = 0; s < SIZE_CNT; ++s)
+        {
+            printf("  %3u byte: zero-copy %7.0f %6.1f %6.1f, copy %7.0f %6.1f %6.1f\n", s_sizes[s], result[0][s][0],
+                   result[0][s][1], result[0][s][2], result[1][s][0], result[1][s][1], result[1][s][2]);
+        }
+    }
+    else
+    {
+        (void)kill(pid, SIGKILL);
+    }
+
+    (void)waitpid(pid, &status, 0);
+    if ((failures == 0) && (!WIFEXITED(status) || (WEXITSTATUS(status) != 0)))
+    {
+        printf("remote failed, status %d\n", status);
+        ++failures;
+    }
+    delete transport;
+    platform_shmem_unmap();
+
+    printf(failures ? "FAILED\n" : "PASSED.\n");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,860 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ * All rights reserved.
+ *
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**************************************************************************
+ * FILE NAME
+ *
+ *       rpmsg_env_posix.c
+ *
+ *
+ * DESCRIPTION
+ *
+ *       This file is POSIX (pthread) Implementation of env layer for OpenAMP.
+ *       The platform layer delivers the notifications of the other side from
+ *       its own thread, which is the "interrupt context" of this environment.
+ *
+ *
+ **************************************************************************/
+
+#include "rpmsg_compiler.h"
+#include "rpmsg_env.h"
+#include "rpmsg_platform.h"
+#include "virtqueue.h"
+#include "rpmsg_lite.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static int32_t env_init_counter = 0;
+static pthread_mutex_t env_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t env_cond   = PTHREAD_COND_INITIALIZER;
+static uint32_t env_link_events  = 0U;
+
+/* RL_ENV_MAX_MUTEX_COUNT is an arbitrary count greater than 'count'
+   if the inital count is 1, this function behaves as a mutex
+   if it is greater than 1, it acts as a "resource allocator" with
+   the maximum of 'count' resources available.
+   Currently, only the first use-case is applicable/applied in RPMsg-Lite.
+ */
+#define RL_ENV_MAX_MUTEX_COUNT (10)
+
+/* Max supported ISR counts */
+#define ISR_COUNT (32U)
+/*!
+ * Structure to keep track of registered ISR's.
+ */
+struct isr_info
+{
+    void *data;
+};
+static struct isr_info isr_table[ISR_COUNT];
+
+/*!
+ * Message queue, elements are copied in and out of a ring.
+ */
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    uint32_t element_size;
+    uint32_t length;
+    uint32_t head;
+    uint32_t count;
+    uint8_t data[];
+} env_queue_t;
+
+#if defined(RL_USE_ENVIRONMENT_CONTEXT) && (RL_USE_ENVIRONMENT_CONTEXT == 1)
+#error "This RPMsg-Lite port requires RL_USE_ENVIRONMENT_CONTEXT set to 0"
+#endif
+
+/*!
+ * env_in_isr
+ *
+ * @returns - true, if currently in ISR
+ *
+ */
+static int32_t env_in_isr(void)
+{
+    return platform_in_isr();
+}
+
+/*!
+ * env_deadline
+ *
+ * Converts a relative timeout to an absolute CLOCK_MONOTONIC time.
+ *
+ */
+static void env_deadline(struct timespec *ts, uint32_t timeout_ms)
+{
+    (void)clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += (time_t)(timeout_ms / 1000U);
+    ts->tv_nsec += (long)(timeout_ms % 1000U) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L)
+    {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+/*!
+ * env_cond_init
+ *
+ * Initializes a condition variable waiting on CLOCK_MONOTONIC.
+ *
+ */
+static int32_t env_cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    int32_t retval;
+
+    if (pthread_condattr_init(&attr) != 0)
+    {
+        return -1;
+    }
+    retval = ((pthread_condattr_setclock(&attr, CLOCK_MONOTONIC) == 0) && (pthread_cond_init(cond, &attr) == 0)) ? 0 : -1;
+    (void)pthread_condattr_destroy(&attr);
+    return retval;
+}
+
+/*!
+ * env_cond_wait
+ *
+ * Waits on the condition, the mutex must be held.
+ *
+ * @returns - 0 when signaled, -1 on timeout
+ *
+ */
+static int32_t env_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex, uint32_t timeout_ms)
+{
+    struct timespec ts;
+
+    if (timeout_ms == RL_BLOCK)
+    {
+        (void)pthread_cond_wait(cond, mutex);
+        return 0;
+    }
+    if (timeout_ms == RL_DONT_BLOCK)
+    {
+        return -1;
+    }
+
+    env_deadline(&ts, timeout_ms);
+    return (pthread_cond_timedwait(cond, mutex, &ts) == ETIMEDOUT) ? -1 : 0;
+}
+
+/*!
+ * env_wait_for_link_up
+ *
+ * Wait until the link_state parameter of the rpmsg_lite_instance is set.
+ * Utilize a condition variable to avoid busy loop implementation.
+ *
+ */
+uint32_t env_wait_for_link_up(volatile uint32_t *link_state, uint32_t link_id, uint32_t timeout_ms)
+{
+    struct timespec ts;
+    uint32_t retval = 1U;
+
+    if (timeout_ms != RL_BLOCK)
+    {
+        env_deadline(&ts, timeout_ms);
+    }
+
+    (void)pthread_mutex_lock(&env_mutex);
+    env_link_events &= ~(1UL << link_id);
+    while ((*link_state != 1U) && ((env_link_events & (1UL << link_id)) == 0U))
+    {
+        if (timeout_ms == RL_BLOCK)
+        {
+            (void)pthread_cond_wait(&env_cond, &env_mutex);
+        }
+        else if (pthread_cond_timedwait(&env_cond, &env_mutex, &ts) == ETIMEDOUT)
+        {
+            /* timeout */
+            retval = (*link_state == 1U) ? 1U : 0U;
+            break;
+        }
+        else
+        {
+        }
+    }
+    (void)pthread_mutex_unlock(&env_mutex);
+
+    return retval;
+}
+
+/*!
+ * env_tx_callback
+ *
+ * Set event to notify task waiting in env_wait_for_link_up().
+ *
+ */
+void env_tx_callback(uint32_t link_id)
+{
+    (void)pthread_mutex_lock(&env_mutex);
+    env_link_events |= (1UL << link_id);
+    (void)pthread_cond_broadcast(&env_cond);
+    (void)pthread_mutex_unlock(&env_mutex);
+}
+
+/*!
+ * env_init
+ *
+ * Initializes OS/BM environment.
+ *
+ */
+int32_t env_init(void)
+{
+    int32_t retval = 0;
+
+    /* Hold the lock over platform_init() so that concurrent
+     * callers return only once the platform is ready. */
+    (void)pthread_mutex_lock(&env_mutex);
+    /* verify 'env_init_counter' */
+    RL_ASSERT(env_init_counter >= 0);
+    if (env_init_counter < 0)
+    {
+        /* coco begin validated: (env_init_counter < 0) condition will never met unless RAM is corrupted */
+        (void)pthread_mutex_unlock(&env_mutex);
+        return -1;
+        /* coco end */
+    }
+    env_init_counter++;
+    /* multiple call of 'env_init' - return ok */
+    if (env_init_counter == 1)
+    {
+        /* first call */
+        (void)pthread_cond_destroy(&env_cond);
+        if (env_cond_init(&env_cond) != 0)
+        {
+            env_init_counter--;
+            (void)pthread_mutex_unlock(&env_mutex);
+            return -1;
+        }
+        env_link_events = 0U;
+        (void)memset(isr_table, 0, sizeof(isr_table));
+        retval = platform_init();
+    }
+    (void)pthread_mutex_unlock(&env_mutex);
+
+    return retval;
+}
+
+/*!
+ * env_deinit
+ *
+ * Uninitializes OS/BM environment.
+ *
+ * @returns - execution status
+ */
+int32_t env_deinit(void)
+{
+    int32_t retval = 0;
+
+    (void)pthread_mutex_lock(&env_mutex);
+    /* verify 'env_init_counter' */
+    RL_ASSERT(env_init_counter > 0);
+    if (env_init_counter <= 0)
+    {
+        (void)pthread_mutex_unlock(&env_mutex);
+        return -1;
+    }
+
+    /* counter on zero - call platform deinit */
+    env_init_counter--;
+    /* multiple call of 'env_deinit' - return ok */
+    if (env_init_counter <= 0)
+    {
+        /* last call */
+        retval = platform_deinit();
+        (void)memset(isr_table, 0, sizeof(isr_table));
+    }
+    (void)pthread_mutex_unlock(&env_mutex);
+
+    return retval;
+}
+
+/*!
+ * env_allocate_memory - implementation
+ *
+ * @param size
+ */
+void *env_allocate_memory(uint32_t size)
+{
+    return (malloc(size));
+}
+
+/*!
+ * env_free_memory - implementation
+ *
+ * @param ptr
+ */
+void env_free_memory(void *ptr)
+{
+    if (ptr != ((void *)0))
+    {
+        free(ptr);
+    }
+}
+
+/*!
+ *
+ * env_memset - implementation
+ *
+ * @param ptr
+ * @param value
+ * @param size
+ */
+void env_memset(void *ptr, int32_t value, uint32_t size)
+{
+    (void)memset(ptr, value, size);
+}
+
+/*!
+ *
+ * env_memcpy - implementation
+ *
+ * @param dst
+ * @param src
+ * @param len
+ */
+void env_memcpy(void *dst, void const *src, uint32_t len)
+{
+    (void)memcpy(dst, src, len);
+}
+
+/*!
+ *
+ * env_strcmp - implementation
+ *
+ * @param dst
+ * @param src
+ */
+
+int32_t env_strcmp(const char *dst, const char *src)
+{
+    return (strcmp(dst, src));
+}
+
+/*!
+ *
+ * env_strncpy - implementation
+ *
+ * @param dest
+ * @param src
+ * @param len
+ */
+void env_strncpy(char *dest, const char *src, uint32_t len)
+{
+    (void)strncpy(dest, src, len);
+}
+
+/*!
+ *
+ * env_strncmp - implementation
+ *
+ * @param dest
+ * @param src
+ * @param len
+ */
+int32_t env_strncmp(char *dest, const char *src, uint32_t len)
+{
+    return (strncmp(dest, src, len));
+}
+
+/*!
+ *
+ * env_mb - implementation
+ *
+ * MEM_BARRIER() is a RISC-V fence for GCC, use the compiler builtin
+ * so that the host architecture gets its own barrier.
+ *
+ */
+void env_mb(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/*!
+ * env_rmb - implementation
+ */
+void env_rmb(void)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+/*!
+ * env_wmb - implementation
+ */
+void env_wmb(void)
+{
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/*!
+ * env_map_vatopa - implementation
+ *
+ * @param address
+ */
+uint32_t env_map_vatopa(void *address)
+{
+    return platform_vatopa(address);
+}
+
+/*!
+ * env_map_patova - implementation
+ *
+ * @param address
+ */
+void *env_map_patova(uint32_t address)
+{
+    return platform_patova(address);
+}
+
+/*!
+ * env_create_mutex
+ *
+ * Creates a mutex with the given initial count.
+ *
+ */
+int32_t env_create_mutex(void **lock, int32_t count)
+{
+    sem_t *sem;
+
+    if ((count < 0) || (count > RL_ENV_MAX_MUTEX_COUNT))
+    {
+        return -1;
+    }
+
+    sem = (sem_t *)env_allocate_memory(sizeof(sem_t));
+    if (sem == ((void *)0))
+    {
+        return -1;
+    }
+    if (sem_init(sem, 0, (unsigned int)count) != 0)
+    {
+        env_free_memory(sem);
+        return -1;
+    }
+
+    *lock = sem;
+    return 0;
+}
+
+/*!
+ * env_delete_mutex
+ *
+ * Deletes the given lock
+ *
+ */
+void env_delete_mutex(void *lock)
+{
+    (void)sem_destroy((sem_t *)lock);
+    env_free_memory(lock);
+}
+
+/*!
+ * env_lock_mutex
+ *
+ * Tries to acquire the lock, if lock is not available then call to
+ * this function will suspend.
+ */
+void env_lock_mutex(void *lock)
+{
+    if (env_in_isr() == 0)
+    {
+        while (sem_wait((sem_t *)lock) != 0)
+        {
+            /* interrupted by a signal */
+        }
+    }
+}
+
+/*!
+ * env_unlock_mutex
+ *
+ * Releases the given lock.
+ */
+void env_unlock_mutex(void *lock)
+{
+    if (env_in_isr() == 0)
+    {
+        (void)sem_post((sem_t *)lock);
+    }
+}
+
+/*!
+ * env_create_sync_lock
+ *
+ * Creates a synchronization lock primitive. It is used
+ * when signal has to be sent from the interrupt context to main
+ * thread context.
+ */
+int32_t env_create_sync_lock(void **lock, int32_t state)
+{
+    return env_create_mutex(lock, state); /* state=1 .. initially free */
+}
+
+/*!
+ * env_delete_sync_lock
+ *
+ * Deletes the given lock
+ *
+ */
+void env_delete_sync_lock(void *lock)
+{
+    if (lock != ((void *)0))
+    {
+        env_delete_mutex(lock);
+    }
+}
+
+/*!
+ * env_acquire_sync_lock
+ *
+ * Tries to acquire the lock, if lock is not available then call to
+ * this function waits for lock to become available.
+ */
+void env_acquire_sync_lock(void *lock)
+{
+    if (env_in_isr() != 0)
+    {
+        (void)sem_trywait((sem_t *)lock);
+    }
+    else
+    {
+        while (sem_wait((sem_t *)lock) != 0)
+        {
+            /* interrupted by a signal */
+        }
+    }
+}
+
+/*!
+ * env_release_sync_lock
+ *
+ * Releases the given lock.
+ */
+void env_release_sync_lock(void *lock)
+{
+    (void)sem_post((sem_t *)lock);
+}
+
+/*!
+ * env_sleep_msec
+ *
+ * Suspends the calling thread for given time , in msecs.
+ */
+void env_sleep_msec(uint32_t num_msec)
+{
+    platform_time_delay(num_msec);
+}
+
+/*!
+ * env_register_isr
+ *
+ * Registers interrupt handler data for the given interrupt vector.
+ *
+ * @param vector_id - virtual interrupt vector number
+ * @param data      - interrupt handler data (virtqueue)
+ */
+void env_register_isr(uint32_t vector_id, void *data)
+{
+    RL_ASSERT(vector_id < ISR_COUNT);
+    if (vector_id < ISR_COUNT)
+    {
+        isr_table[vector_id].data = data;
+    }
+}
+
+/*!
+ * env_unregister_isr
+ *
+ * Unregisters interrupt handler data for the given interrupt vector.
+ *
+ * @param vector_id - virtual interrupt vector number
+ */
+void env_unregister_isr(uint32_t vector_id)
+{
+    RL_ASSERT(vector_id < ISR_COUNT);
+    if (vector_id < ISR_COUNT)
+    {
+        isr_table[vector_id].data = ((void *)0);
+    }
+}
+
+/*!
+ * env_enable_interrupt
+ *
+ * Enables the given interrupt
+ *
+ * @param vector_id   - virtual interrupt vector number
+ */
+
+void env_enable_interrupt(uint32_t vector_id)
+{
+    (void)platform_interrupt_enable(vector_id);
+}
+
+/*!
+ * env_disable_interrupt
+ *
+ * Disables the given interrupt
+ *
+ * @param vector_id   - virtual interrupt vector number
+ */
+
+void env_disable_interrupt(uint32_t vector_id)
+{
+    (void)platform_interrupt_disable(vector_id);
+}
+
+/*!
+ * env_map_memory
+ *
+ * Enables memory mapping for given memory region.
+ *
+ * @param pa   - physical address of memory
+ * @param va   - logical address of memory
+ * @param size - memory size
+ * param flags - flags for cache/uncached  and access type
+ */
+
+void env_map_memory(uint32_t pa, uint32_t va, uint32_t size, uint32_t flags)
+{
+    platform_map_mem_region(va, pa, size, flags);
+}
+
+/*!
+ * env_disable_cache
+ *
+ * Disables system caches.
+ *
+ */
+
+void env_disable_cache(void)
+{
+    platform_cache_all_flush_invalidate();
+    platform_cache_disable();
+}
+
+/*!
+ *
+ * env_get_timestamp
+ *
+ * Returns a 64 bit time stamp, in msecs.
+ *
+ *
+ */
+uint64_t env_get_timestamp(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000U) + ((uint64_t)ts.tv_nsec / 1000000U);
+}
+
+/*========================================================= */
+/* Util data / functions  */
+
+void env_isr(uint32_t vector)
+{
+    struct isr_info *info;
+    RL_ASSERT(vector < ISR_COUNT);
+    if (vector < ISR_COUNT)
+    {
+        info = &isr_table[vector];
+        if (info->data != ((void *)0))
+        {
+            virtqueue_notification((struct virtqueue *)info->data);
+        }
+    }
+}
+
+/*
+ * env_create_queue
+ *
+ * Creates a message queue.
+ *
+ * @param queue -  pointer to created queue
+ * @param length -  maximum number of elements in the queue
+ * @param element_size - queue element size in bytes
+ *
+ * @return - status of function execution
+ */
+int32_t env_create_queue(void **queue, int32_t length, int32_t element_size)
+{
+    env_queue_t *q;
+
+    if ((length <= 0) || (element_size <= 0))
+    {
+        return -1;
+    }
+
+    q = (env_queue_t *)env_allocate_memory((uint32_t)(sizeof(env_queue_t) + ((uint32_t)length * (uint32_t)element_size)));
+    if (q == ((void *)0))
+    {
+        return -1;
+    }
+
+    q->element_size = (uint32_t)element_size;
+    q->length       = (uint32_t)length;
+    q->head         = 0U;
+    q->count        = 0U;
+    if (pthread_mutex_init(&q->mutex, ((void *)0)) != 0)
+    {
+        env_free_memory(q);
+        return -1;
+    }
+    if (env_cond_init(&q->not_empty) != 0)
+    {
+        (void)pthread_mutex_destroy(&q->mutex);
+        env_free_memory(q);
+        return -1;
+    }
+    if (env_cond_init(&q->not_full) != 0)
+    {
+        (void)pthread_cond_destroy(&q->not_empty);
+        (void)pthread_mutex_destroy(&q->mutex);
+        env_free_memory(q);
+        return -1;
+    }
+
+    *queue = q;
+    return 0;
+}
+
+/*!
+ * env_delete_queue
+ *
+ * Deletes the message queue.
+ *
+ * @param queue - queue to delete
+ */
+
+void env_delete_queue(void *queue)
+{
+    env_queue_t *q = (env_queue_t *)queue;
+
+    (void)pthread_cond_destroy(&q->not_full);
+    (void)pthread_cond_destroy(&q->not_empty);
+    (void)pthread_mutex_destroy(&q->mutex);
+    env_free_memory(q);
+}
+
+/*!
+ * env_put_queue
+ *
+ * Put an element in a queue.
+ *
+ * @param queue - queue to put element in
+ * @param msg - pointer to the message to be put into the queue
+ * @param timeout_ms - timeout in ms
+ *
+ * @return - status of function execution
+ */
+
+int32_t env_put_queue(void *queue, void *msg, uint32_t timeout_ms)
+{
+    env_queue_t *q = (env_queue_t *)queue;
+    int32_t retval = 0;
+
+    /* the interrupt context never blocks */
+    if (env_in_isr() != 0)
+    {
+        timeout_ms = RL_DONT_BLOCK;
+    }
+
+    (void)pthread_mutex_lock(&q->mutex);
+    while (q->count == q->length)
+    {
+        if (env_cond_wait(&q->not_full, &q->mutex, timeout_ms) != 0)
+        {
+            break;
+        }
+    }
+    if (q->count < q->length)
+    {
+        env_memcpy(&q->data[((q->head + q->count) % q->length) * q->element_size], msg, q->element_size);
+        q->count++;
+        (void)pthread_cond_signal(&q->not_empty);
+        retval = 1;
+    }
+    (void)pthread_mutex_unlock(&q->mutex);
+
+    return retval;
+}
+
+/*!
+ * env_get_queue
+ *
+ * Get an element out of a queue.
+ *
+ * @param queue - queue to get element from
+ * @param msg - pointer to a memory to save the message
+ * @param timeout_ms - timeout in ms
+ *
+ * @return - status of function execution
+ */
+
+int32_t env_get_queue(void *queue, void *msg, uint32_t timeout_ms)
+{
+    env_queue_t *q = (env_queue_t *)queue;
+    int32_t retval = 0;
+
+    if (env_in_isr() != 0)
+    {
+        timeout_ms = RL_DONT_BLOCK;
+    }
+
+    (void)pthread_mutex_lock(&q->mutex);
+    while (q->count == 0U)
+    {
+        if (env_cond_wait(&q->not_empty, &q->mutex, timeout_ms) != 0)
+        {
+            break;
+        }
+    }
+    if (q->count > 0U)
+    {
+        env_memcpy(msg, &q->data[q->head * q->element_size], q->element_size);
+        q->head = (q->head + 1U) % q->length;
+        q->count--;
+        (void)pthread_cond_signal(&q->not_full);
+        retval = 1;
+    }
+    (void)pthread_mutex_unlock(&q->mutex);
+
+    return retval;
+}
+
+/*!
+ * env_get_current_queue_size
+ *
+ * Get current queue size.
+ *
+ * @param queue - queue pointer
+ *
+ * @return - Number of queued items in the queue
+ */
+
+int32_t env_get_current_queue_size(void *queue)
+{
+    env_queue_t *q = (env_queue_t *)queue;
+    int32_t count;
+
+    (void)pthread_mutex_lock(&q->mutex);
+    count = (int32_t)q->count;
+    (void)pthread_mutex_unlock(&q->mutex);
+
+    return count;
+}
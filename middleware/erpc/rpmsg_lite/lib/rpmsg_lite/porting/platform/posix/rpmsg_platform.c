@@ -0,0 +1,464 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ * All rights reserved.
+ *
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "rpmsg_platform.h"
+#include "rpmsg_env.h"
+
+#if defined(RL_USE_ENVIRONMENT_CONTEXT) && (RL_USE_ENVIRONMENT_CONTEXT == 1)
+#error "This RPMsg-Lite port requires RL_USE_ENVIRONMENT_CONTEXT set to 0"
+#endif
+
+#define PLATFORM_SHMEM_MAGIC      (0x52504D53U) /* "RPMS" */
+#define PLATFORM_SHMEM_CTRL_SIZE  (4096U)
+/* rpmsg_lite stores the shared memory address in 32 bits */
+#define PLATFORM_SHMEM_ADDR_HINT  ((void *)0x40000000UL)
+#define PLATFORM_SHMEM_OPEN_RETRY (5000U)
+
+/*
+ * Control block at the beginning of the shared memory object,
+ * side 0 is the master and side 1 the remote.
+ */
+typedef struct
+{
+    volatile uint32_t magic;
+    uint32_t pending[2];    /* vectors notified to each side */
+    pthread_mutex_t mutex;
+    pthread_cond_t cond[2];
+} platform_shmem_ctrl_t;
+
+static char *s_shmem_base = ((void *)0);
+static uint32_t s_shmem_size = 0U;
+static char s_shmem_name[64];
+static uint32_t s_side = 0U;
+static platform_shmem_ctrl_t *s_ctrl = ((void *)0);
+static pthread_t s_isr_thread;
+static int32_t s_isr_running = 0;
+static int32_t s_disable_counter = 0;
+static uint32_t s_registered = 0U;
+static __thread int32_t s_in_isr = 0;
+
+static void platform_ctrl_lock(void)
+{
+    /* the other process died holding the lock, the notification bits are still consistent */
+    if (pthread_mutex_lock(&s_ctrl->mutex) == EOWNERDEAD)
+    {
+        (void)pthread_mutex_consistent(&s_ctrl->mutex);
+    }
+}
+
+static void platform_ctrl_unlock(void)
+{
+    (void)pthread_mutex_unlock(&s_ctrl->mutex);
+}
+
+static int32_t platform_ctrl_init(platform_shmem_ctrl_t *ctrl)
+{
+    pthread_mutexattr_t mutex_attr;
+    pthread_condattr_t cond_attr;
+    int32_t retval = -1;
+
+    if ((pthread_mutexattr_init(&mutex_attr) == 0) && (pthread_condattr_init(&cond_attr) == 0))
+    {
+        if ((pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED) == 0) &&
+            (pthread_mutexattr_setrobust(&mutex_attr, PTHREAD_MUTEX_ROBUST) == 0) &&
+            (pthread_condattr_setpshared(&cond_attr, PTHREAD_PROCESS_SHARED) == 0) &&
+            (pthread_mutex_init(&ctrl->mutex, &mutex_attr) == 0) && (pthread_cond_init(&ctrl->cond[0], &cond_attr) == 0) &&
+            (pthread_cond_init(&ctrl->cond[1], &cond_attr) == 0))
+        {
+            ctrl->pending[0] = 0U;
+            ctrl->pending[1] = 0U;
+            retval = 0;
+        }
+        (void)pthread_condattr_destroy(&cond_attr);
+        (void)pthread_mutexattr_destroy(&mutex_attr);
+    }
+
+    return retval;
+}
+
+static void *platform_isr_thread(void *arg)
+{
+    uint32_t pending;
+    uint32_t vector_id;
+
+    (void)arg;
+    s_in_isr = 1;
+
+    platform_ctrl_lock();
+    while (s_isr_running != 0)
+    {
+        /* a notification stays pending until its virtqueue is registered, like a latched interrupt */
+        pending = s_ctrl->pending[s_side] & s_registered;
+        if ((pending == 0U) || (s_disable_counter > 0))
+        {
+            (void)pthread_cond_wait(&s_ctrl->cond[s_side], &s_ctrl->mutex);
+            continue;
+        }
+        s_ctrl->pending[s_side] &= ~pending;
+        platform_ctrl_unlock();
+
+        for (vector_id = 0U; pending != 0U; vector_id++, pending >>= 1U)
+        {
+            if ((pending & 1U) != 0U)
+            {
+                env_isr(vector_id);
+            }
+        }
+
+        platform_ctrl_lock();
+    }
+    platform_ctrl_unlock();
+
+    return ((void *)0);
+}
+
+/**
+ * platform_shmem_map
+ *
+ * @param name Name of the POSIX shared memory object, e.g. "/rpmsg_lite".
+ * @param size Size for rpmsg_lite, without the control block.
+ * @param master Non-zero to create the object, zero to open the one of the master.
+ *
+ * @return Address to pass to rpmsg_lite_master_init() or rpmsg_lite_remote_init(), NULL on failure.
+ */
+void *platform_shmem_map(const char *name, uint32_t size, int32_t master)
+{
+    size_t total = (size_t)PLATFORM_SHMEM_CTRL_SIZE + size;
+    int flags = MAP_SHARED;
+    void *addr;
+    int fd = -1;
+    uint32_t retry;
+
+    if ((s_shmem_base != ((void *)0)) || (strlen(name) >= sizeof(s_shmem_name)))
+    {
+        return ((void *)0);
+    }
+
+    if (master != 0)
+    {
+        (void)shm_unlink(name);
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+        if ((fd >= 0) && (ftruncate(fd, (off_t)total) != 0))
+        {
+            (void)close(fd);
+            (void)shm_unlink(name);
+            fd = -1;
+        }
+    }
+    else
+    {
+        /* wait for the master to create the object */
+        for (retry = 0U; retry < PLATFORM_SHMEM_OPEN_RETRY; retry++)
+        {
+            struct stat st;
+            fd = shm_open(name, O_RDWR, 0600);
+            if ((fd >= 0) && (fstat(fd, &st) == 0) && ((size_t)st.st_size >= total))
+            {
+                break;
+            }
+            if (fd >= 0)
+            {
+                (void)close(fd);
+                fd = -1;
+            }
+            platform_time_delay(1U);
+        }
+    }
+    if (fd < 0)
+    {
+        return ((void *)0);
+    }
+
+#ifdef MAP_32BIT
+    flags |= MAP_32BIT;
+#endif
+    addr = mmap(PLATFORM_SHMEM_ADDR_HINT, total, PROT_READ | PROT_WRITE, flags, fd, 0);
+    (void)close(fd);
+    if (addr == MAP_FAILED)
+    {
+        return ((void *)0);
+    }
+    if (((uintptr_t)addr + total - 1U) > (uintptr_t)UINT32_MAX)
+    {
+        (void)munmap(addr, total);
+        return ((void *)0);
+    }
+
+    s_ctrl = (platform_shmem_ctrl_t *)addr;
+    if (master != 0)
+    {
+        if (platform_ctrl_init(s_ctrl) != 0)
+        {
+            (void)munmap(addr, total);
+            (void)shm_unlink(name);
+            return ((void *)0);
+        }
+        __atomic_store_n(&s_ctrl->magic, PLATFORM_SHMEM_MAGIC, __ATOMIC_RELEASE);
+    }
+    else
+    {
+        for (retry = 0U; retry < PLATFORM_SHMEM_OPEN_RETRY; retry++)
+        {
+            if (__atomic_load_n(&s_ctrl->magic, __ATOMIC_ACQUIRE) == PLATFORM_SHMEM_MAGIC)
+            {
+                break;
+            }
+            platform_time_delay(1U);
+        }
+        if (retry == PLATFORM_SHMEM_OPEN_RETRY)
+        {
+            (void)munmap(addr, total);
+            return ((void *)0);
+        }
+    }
+
+    s_shmem_base = (char *)addr;
+    s_shmem_size = (uint32_t)total;
+    s_side = (master != 0) ? 0U : 1U;
+    (void)strcpy(s_shmem_name, name);
+
+    return s_shmem_base + PLATFORM_SHMEM_CTRL_SIZE;
+}
+
+/**
+ * platform_shmem_unmap
+ *
+ * Unmaps the shared memory, the master also removes the object.
+ * Call it after rpmsg_lite_deinit().
+ */
+void platform_shmem_unmap(void)
+{
+    if (s_shmem_base != ((void *)0))
+    {
+        /* the notification thread waits in the control block */
+        (void)platform_deinit();
+        (void)munmap(s_shmem_base, s_shmem_size);
+        if (s_side == 0U)
+        {
+            (void)shm_unlink(s_shmem_name);
+        }
+        s_shmem_base = ((void *)0);
+        s_ctrl = ((void *)0);
+    }
+}
+
+int32_t platform_init_interrupt(uint32_t vector_id, void *isr_data)
+{
+    /* Register ISR to environment layer */
+    env_register_isr(vector_id, isr_data);
+
+    platform_ctrl_lock();
+    s_registered |= (1UL << vector_id);
+    (void)pthread_cond_broadcast(&s_ctrl->cond[s_side]);
+    platform_ctrl_unlock();
+
+    return 0;
+}
+
+int32_t platform_deinit_interrupt(uint32_t vector_id)
+{
+    platform_ctrl_lock();
+    s_registered &= ~(1UL << vector_id);
+    platform_ctrl_unlock();
+
+    /* Unregister ISR from environment layer */
+    env_unregister_isr(vector_id);
+
+    return 0;
+}
+
+void platform_notify(uint32_t vector_id)
+{
+    uint32_t peer = 1U - s_side;
+
+    platform_ctrl_lock();
+    s_ctrl->pending[peer] |= (1UL << vector_id);
+    (void)pthread_cond_signal(&s_ctrl->cond[peer]);
+    platform_ctrl_unlock();
+}
+
+/**
+ * platform_time_delay
+ *
+ * @param num_msec Delay time in ms.
+ *
+ * This is not an accurate delay, it ensures at least num_msec passed when return.
+ */
+void platform_time_delay(uint32_t num_msec)
+{
+    struct timespec ts;
+
+    ts.tv_sec  = (time_t)(num_msec / 1000U);
+    ts.tv_nsec = (long)(num_msec % 1000U) * 1000000L;
+    while (nanosleep(&ts, &ts) != 0)
+    {
+        /* interrupted by a signal, sleep the remaining time */
+    }
+}
+
+/**
+ * platform_in_isr
+ *
+ * Return whether CPU is processing IRQ
+ *
+ * @return True for the notification thread, false otherwise.
+ *
+ */
+int32_t platform_in_isr(void)
+{
+    return s_in_isr;
+}
+
+/**
+ * platform_interrupt_enable
+ *
+ * Enable peripheral-related interrupt
+ *
+ * @param vector_id Virtual vector ID that needs to be converted to IRQ number
+ *
+ * @return vector_id Return value is never checked.
+ *
+ */
+int32_t platform_interrupt_enable(uint32_t vector_id)
+{
+    RL_ASSERT(0 < s_disable_counter);
+
+    platform_ctrl_lock();
+    s_disable_counter--;
+
+    if (s_disable_counter == 0)
+    {
+        /* deliver what was notified meanwhile */
+        (void)pthread_cond_broadcast(&s_ctrl->cond[s_side]);
+    }
+    platform_ctrl_unlock();
+    return ((int32_t)vector_id);
+}
+
+/**
+ * platform_interrupt_disable
+ *
+ * Disable peripheral-related interrupt.
+ *
+ * @param vector_id Virtual vector ID that needs to be converted to IRQ number
+ *
+ * @return vector_id Return value is never checked.
+ *
+ */
+int32_t platform_interrupt_disable(uint32_t vector_id)
+{
+    RL_ASSERT(0 <= s_disable_counter);
+
+    /* virtqueues share the notification thread
+       if counter is set - the interrupts are disabled */
+    platform_ctrl_lock();
+    s_disable_counter++;
+    platform_ctrl_unlock();
+    return ((int32_t)vector_id);
+}
+
+/**
+ * platform_map_mem_region
+ *
+ * Dummy implementation
+ *
+ */
+void platform_map_mem_region(uint32_t vrt_addr, uint32_t phy_addr, uint32_t size, uint32_t flags)
+{
+}
+
+/**
+ * platform_cache_all_flush_invalidate
+ *
+ * Dummy implementation, the host caches are coherent
+ *
+ */
+void platform_cache_all_flush_invalidate(void)
+{
+}
+
+/**
+ * platform_cache_disable
+ *
+ * Dummy implementation
+ *
+ */
+void platform_cache_disable(void)
+{
+}
+
+/**
+ * platform_vatopa
+ *
+ * The processes map the shared memory at different addresses,
+ * the "physical" address is the offset in the object.
+ */
+uint32_t platform_vatopa(void *addr)
+{
+    return ((uint32_t)((char *)addr - s_shmem_base));
+}
+
+/**
+ * platform_patova
+ */
+void *platform_patova(uint32_t addr)
+{
+    return ((void *)(s_shmem_base + addr));
+}
+
+/**
+ * platform_init
+ *
+ * platform/environment init
+ */
+int32_t platform_init(void)
+{
+    if (s_ctrl == ((void *)0))
+    {
+        /* platform_shmem_map() first */
+        return -1;
+    }
+
+    s_disable_counter = 0;
+    s_registered = 0U;
+    s_isr_running = 1;
+    if (pthread_create(&s_isr_thread, ((void *)0), platform_isr_thread, ((void *)0)) != 0)
+    {
+        s_isr_running = 0;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * platform_deinit
+ *
+ * platform/environment deinit process
+ */
+int32_t platform_deinit(void)
+{
+    if (s_isr_running != 0)
+    {
+        platform_ctrl_lock();
+        s_isr_running = 0;
+        (void)pthread_cond_broadcast(&s_ctrl->cond[s_side]);
+        platform_ctrl_unlock();
+        (void)pthread_join(s_isr_thread, ((void *)0));
+    }
+
+    return 0;
+}
@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _HPM_BOARD_H
+#define _HPM_BOARD_H
+
+/* the parts of board.h the sdxc diskio layer uses, for the host build */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "hpm_common.h"
+
+#define BOARD_RUNNING_CORE              (0)
+#define BOARD_APP_SDCARD_SDXC_BASE      (NULL)
+#define BOARD_APP_EMMC_SDXC_BASE        (NULL)
+
+#endif /* _HPM_BOARD_H */
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _HPM_L1C_DRV_H
+#define _HPM_L1C_DRV_H
+
+/* cache maintenance of the host build, counted by ram_sd.c */
+
+#include <stdint.h>
+
+#define HPM_L1C_CACHELINE_SIZE          (64)
+
+void l1c_dc_flush(uint32_t addr, uint32_t size);
+void l1c_dc_invalidate(uint32_t addr, uint32_t size);
+
+static inline uint32_t core_local_mem_to_sys_address(uint8_t core_id, uint32_t addr)
+{
+    (void)core_id;
+    return addr;
+}
+
+#endif /* _HPM_L1C_DRV_H */
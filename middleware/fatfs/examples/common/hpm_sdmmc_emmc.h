@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _HPM_SDMMC_EMMC_H
+#define _HPM_SDMMC_EMMC_H
+
+/* the host build enables only SD_FATFS_ENABLE */
+
+#endif /* _HPM_SDMMC_EMMC_H */
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _HPM_SDMMC_SD_H
+#define _HPM_SDMMC_SD_H
+
+/* the sd card api the sdxc diskio layer uses, implemented over a ram disk by ram_sd.c */
+
+#include "hpm_common.h"
+
+typedef struct {
+    uint32_t reserved;
+} SDMMCHOST_Type;
+
+typedef struct {
+    SDMMCHOST_Type *base;
+} sdmmc_host_t;
+
+typedef struct {
+    sdmmc_host_t *host;
+    uint32_t block_count;
+    uint32_t block_size;
+    struct {
+        uint32_t erase_sector_size;
+    } csd;
+} sd_card_t;
+
+hpm_stat_t board_init_sd_host_params(sdmmc_host_t *host, SDMMCHOST_Type *base);
+bool sdmmchost_is_card_detected(sdmmc_host_t *host);
+
+hpm_stat_t sd_init(sd_card_t *card);
+void sd_deinit(sd_card_t *card);
+hpm_stat_t sd_read_status(sd_card_t *card);
+hpm_stat_t sd_read_blocks(sd_card_t *card, uint8_t *buffer, uint32_t start_block, uint32_t block_count);
+hpm_stat_t sd_write_blocks(sd_card_t *card, const uint8_t *buffer, uint32_t start_block, uint32_t block_count);
+
+#endif /* _HPM_SDMMC_SD_H */
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hpm_l1c_drv.h"
+#include "hpm_sdmmc_sd.h"
+#include "hpm_sdmmc_disk.h"
+#include "ram_sd.h"
+
+ram_sd_stat_t ram_sd_stat;
+uint8_t *ram_sd_disk;
+
+/* buffer of the sd_disk_read/write call in progress */
+static uintptr_t call_start;
+static uintptr_t call_end;
+
+DSTATUS __real_sd_disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count);
+DSTATUS __real_sd_disk_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count);
+
+void ram_sd_stat_clear(void)
+{
+    memset(&ram_sd_stat, 0, sizeof(ram_sd_stat));
+}
+
+static bool in_call_buffer(uintptr_t addr)
+{
+    return (addr >= call_start) && (addr < call_end);
+}
+
+/*
+ * A transfer into the caller's buffer may only invalidate lines inside it, a bounce buffer
+ * must be whole cache lines
+ */
+static void check_invalidate(uintptr_t addr, uint32_t size)
+{
+    uintptr_t start = addr & ~(uintptr_t)(HPM_L1C_CACHELINE_SIZE - 1);
+    uintptr_t end = (addr + size + HPM_L1C_CACHELINE_SIZE - 1) & ~(uintptr_t)(HPM_L1C_CACHELINE_SIZE - 1);
+
+    if (in_call_buffer(addr)) {
+        if ((start < call_start) || (end > call_end)) {
+            ram_sd_stat.stray_invalidates++;
+        }
+    } else if ((start != addr) || (end != addr + size)) {
+        ram_sd_stat.stray_invalidates++;
+    }
+}
+
+static hpm_stat_t transfer(uint8_t *buffer, uint32_t start_block, uint32_t block_count, bool read)
+{
+    uint32_t size = block_count * RAM_SD_SECTOR_SIZE;
+
+    if (((uintptr_t)buffer & 3U) != 0U) {
+        ram_sd_stat.unaligned_dma++;
+    }
+    if ((block_count == 0U) || (start_block + block_count > RAM_SD_SECTOR_CNT)) {
+        return status_invalid_argument;
+    }
+    ram_sd_stat.cmds++;
+    ram_sd_stat.bytes += size;
+    if (!in_call_buffer((uintptr_t)buffer)) {
+        ram_sd_stat.bounced += size;
+    }
+    if (read) {
+        memcpy(buffer, ram_sd_disk + (uint64_t)start_block * RAM_SD_SECTOR_SIZE, size);
+        check_invalidate((uintptr_t)buffer, size);
+    } else {
+        memcpy(ram_sd_disk + (uint64_t)start_block * RAM_SD_SECTOR_SIZE, buffer, size);
+    }
+    return status_success;
+}
+
+void l1c_dc_flush(uint32_t addr, uint32_t size)
+{
+    (void)addr;
+    (void)size;
+}
+
+void l1c_dc_invalidate(uint32_t addr, uint32_t size)
+{
+    check_invalidate(addr, size);
+}
+
+hpm_stat_t board_init_sd_host_params(sdmmc_host_t *host, SDMMCHOST_Type *base)
+{
+    host->base = base;
+    return status_success;
+}
+
+bool sdmmchost_is_card_detected(sdmmc_host_t *host)
+{
+    (void)host;
+    return true;
+}
+
+hpm_stat_t sd_init(sd_card_t *card)
+{
+    if (ram_sd_disk == NULL) {
+        ram_sd_disk = calloc(RAM_SD_SECTOR_CNT, RAM_SD_SECTOR_SIZE);
+        if (ram_sd_disk == NULL) {
+            return status_fail;
+        }
+    }
+    card->block_count = RAM_SD_SECTOR_CNT;
+    card->block_size = RAM_SD_SECTOR_SIZE;
+    card->csd.erase_sector_size = 128;
+    return status_success;
+}
+
+void sd_deinit(sd_card_t *card)
+{
+    (void)card;
+}
+
+hpm_stat_t sd_read_status(sd_card_t *card)
+{
+    (void)card;
+    return status_success;
+}
+
+hpm_stat_t sd_read_blocks(sd_card_t *card, uint8_t *buffer, uint32_t start_block, uint32_t block_count)
+{
+    (void)card;
+    return transfer(buffer, start_block, block_count, true);
+}
+
+hpm_stat_t sd_write_blocks(sd_card_t *card, const uint8_t *buffer, uint32_t start_block, uint32_t block_count)
+{
+    (void)card;
+    return transfer((uint8_t *)buffer, start_block, block_count, false);
+}
+
+DSTATUS __wrap_sd_disk_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
+{
+    DSTATUS status;
+
+    call_start = (uintptr_t)buff;
+    call_end = call_start + count * RAM_SD_SECTOR_SIZE;
+    status = __real_sd_disk_read(pdrv, buff, sector, count);
+    call_start = call_end = 0;
+    return status;
+}
+
+DSTATUS __wrap_sd_disk_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count)
+{
+    DSTATUS status;
+
+    call_start = (uintptr_t)buff;
+    call_end = call_start + count * RAM_SD_SECTOR_SIZE;
+    status = __real_sd_disk_write(pdrv, buff, sector, count);
+    call_start = call_end = 0;
+    return status;
+}
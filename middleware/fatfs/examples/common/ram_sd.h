@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef RAM_SD_H
+#define RAM_SD_H
+
+#include <stdint.h>
+
+/*
+ * A ram disk behind the sd card api of hpm_sdmmc_sd.h. Like the sdmmc library it needs word
+ * aligned buffers and invalidates the transfer range rounded out to whole cache lines after
+ * a read. sd_disk_read/write are wrapped (-Wl,--wrap) to know the buffer of each diskio call.
+ */
+#define RAM_SD_SECTOR_SIZE      (512U)
+#define RAM_SD_SECTOR_CNT       (131072U)
+
+typedef struct {
+    uint32_t cmds;              /* sd_read_blocks and sd_write_blocks calls */
+    uint64_t bytes;             /* moved by them */
+    uint64_t bounced;           /* of those, through a buffer other than the one of the diskio call */
+    uint32_t stray_invalidates; /* invalidates reaching cache lines outside the buffers */
+    uint32_t unaligned_dma;     /* transfers from or to buffers that are not word aligned */
+} ram_sd_stat_t;
+
+extern ram_sd_stat_t ram_sd_stat;
+extern uint8_t *ram_sd_disk;
+
+void ram_sd_stat_clear(void);
+
+#endif /* RAM_SD_H */
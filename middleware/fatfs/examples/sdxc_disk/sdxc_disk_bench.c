@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * The sdxc diskio layer (src/portable/sdxc/hpm_sdmmc_disk.c) over a ram disk (common/ram_sd.c)
+ *
+ * 1. sd_disk_read/write of runs of 1, 8 and 64 sectors from buffers at +0 (cache line aligned),
+ *    +16 (word aligned) and +1 byte. Every read is checked against the disk, the guard bytes
+ *    around the buffer must stay, and no invalidate may reach a cache line outside the buffer.
+ * 2. A FatFs volume on the ram disk: a DATA_LOG_SIZE file is written with f_write records of
+ *    512, 4096 and 32768 byte from the same buffer offsets, then read back and checked.
+ *
+ * Both print the commands per diskio call or per MiB, the share of bytes bounced through the
+ * aligned buffer of the diskio layer and the host MB/s, for 1 the best of BENCH_REPEAT runs.
+ * A cache line aligned buffer must go to the card directly, one command per call.
+ *
+ * ./sdxc_disk/SdxcDiskBench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ff.h"
+#include "hpm_sdmmc_disk.h"
+#include "ram_sd.h"
+
+#define DISKIO_BYTES        (16U << 20)
+#define DATA_LOG_SIZE       (16U << 20)
+#define BENCH_REPEAT        (5)
+#define GUARD               (0x5aU)
+
+/* the diskio layer passes buffer addresses as uint32_t, so they must be below 4 GiB: built with -no-pie */
+static uint8_t mem[64 * 1024 + 128] __attribute__((aligned(64)));
+static uint8_t expect[64 * 1024];
+static FATFS fs;
+static FIL fil;
+static int failures;
+
+static const uint32_t offsets[] = {0, 16, 1};
+
+static double time_s(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void check(bool ok, const char *what, uint32_t offset, uint32_t size)
+{
+    if (!ok) {
+        printf("%s, buffer +%u, %u byte\n", what, offset, size);
+        failures++;
+    }
+}
+
+static void fill(uint8_t *p, uint32_t size, uint32_t seed)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        p[i] = (uint8_t)(seed >> 24);
+    }
+}
+
+static void bench_diskio(uint32_t offset, uint32_t run)
+{
+    uint8_t *buf = mem + 64 + offset;
+    uint32_t size = run * RAM_SD_SECTOR_SIZE;
+    uint32_t calls = DISKIO_BYTES / size;
+    double best_read = 1e9, best_write = 1e9;
+    ram_sd_stat_t read_stat = {0}, write_stat = {0};
+
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        double t0, t1, t2;
+
+        ram_sd_stat_clear();
+        t0 = time_s();
+        for (uint32_t i = 0; i < calls; i++) {
+            uint32_t sector = (i * run) % (RAM_SD_SECTOR_CNT - run);
+
+            buf[-1] = GUARD;
+            buf[size] = GUARD;
+            if (sd_disk_read(DEV_SD, buf, sector, run) != RES_OK) {
+                check(false, "sd_disk_read failed", offset, size);
+                return;
+            }
+            if ((r == 0) && ((memcmp(buf, ram_sd_disk + sector * RAM_SD_SECTOR_SIZE, size) != 0)
+                             || (buf[-1] != GUARD) || (buf[size] != GUARD))) {
+                check(false, "read data or guard bytes wrong", offset, size);
+                return;
+            }
+        }
+        t1 = time_s();
+        read_stat = ram_sd_stat;
+        ram_sd_stat_clear();
+        fill(buf, size, run);
+        for (uint32_t i = 0; i < calls; i++) {
+            uint32_t sector = (i * run) % (RAM_SD_SECTOR_CNT - run);
+
+            buf[0] = (uint8_t)i;
+            if (sd_disk_write(DEV_SD, buf, sector, run) != RES_OK) {
+                check(false, "sd_disk_write failed", offset, size);
+                return;
+            }
+            if ((r == 0) && (memcmp(buf, ram_sd_disk + sector * RAM_SD_SECTOR_SIZE, size) != 0)) {
+                check(false, "written data wrong", offset, size);
+                return;
+            }
+        }
+        t2 = time_s();
+        write_stat = ram_sd_stat;
+        best_read = (t1 - t0 < best_read) ? t1 - t0 : best_read;
+        best_write = (t2 - t1 < best_write) ? t2 - t1 : best_write;
+    }
+
+    printf("  +%-2u %2u sectors: read %4.2f cmds %3u%% bounced %6.0f MB/s, write %4.2f cmds %3u%% bounced %6.0f MB/s\n",
+           offset, run, (double)read_stat.cmds / calls, (unsigned)(read_stat.bounced * 100 / read_stat.bytes),
+           DISKIO_BYTES / best_read / 1e6, (double)write_stat.cmds / calls,
+           (unsigned)(write_stat.bounced * 100 / write_stat.bytes), DISKIO_BYTES / best_write / 1e6);
+    check(read_stat.stray_invalidates + write_stat.stray_invalidates == 0, "invalidate outside the buffer", offset, size);
+    check(read_stat.unaligned_dma + write_stat.unaligned_dma == 0, "dma from a byte aligned buffer", offset, size);
+    if (offset == 0) {
+        check((read_stat.cmds == calls) && (write_stat.cmds == calls) && (read_stat.bounced == 0)
+              && (write_stat.bounced == 0), "cache line aligned buffer not transferred directly", offset, size);
+    }
+}
+
+static void bench_data_log(uint32_t offset, uint32_t record)
+{
+    uint8_t *buf = mem + 64 + offset;
+    double t0, t1, t2;
+    ram_sd_stat_t write_stat, read_stat;
+    UINT n;
+
+    fill(expect, record, record + offset);
+    ram_sd_stat_clear();
+    t0 = time_s();
+    if (f_open(&fil, "3:/log.bin", FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) {
+        check(false, "f_open for write failed", offset, record);
+        return;
+    }
+    for (uint32_t pos = 0; pos < DATA_LOG_SIZE; pos += record) {
+        memcpy(buf, expect, record);
+        buf[0] = (uint8_t)(pos / record);
+        if ((f_write(&fil, buf, record, &n) != FR_OK) || (n != record)) {
+            check(false, "f_write failed", offset, record);
+            f_close(&fil);
+            return;
+        }
+    }
+    f_close(&fil);
+    t1 = time_s();
+    write_stat = ram_sd_stat;
+
+    ram_sd_stat_clear();
+    if (f_open(&fil, "3:/log.bin", FA_READ) != FR_OK) {
+        check(false, "f_open for read failed", offset, record);
+        return;
+    }
+    for (uint32_t pos = 0; pos < DATA_LOG_SIZE; pos += record) {
+        expect[0] = (uint8_t)(pos / record);
+        buf[-1] = GUARD;
+        buf[record] = GUARD;
+        if ((f_read(&fil, buf, record, &n) != FR_OK) || (n != record) || (memcmp(buf, expect, record) != 0)
+            || (buf[-1] != GUARD) || (buf[record] != GUARD)) {
+            check(false, "f_read data or guard bytes wrong", offset, record);
+            break;
+        }
+    }
+    f_close(&fil);
+    t2 = time_s();
+    read_stat = ram_sd_stat;
+
+    printf("  +%-2u %5u byte: write %5.1f cmds/MiB %3u%% bounced %6.0f MB/s, read %5.1f cmds/MiB %3u%% bounced %6.0f MB/s\n",
+           offset, record, (double)write_stat.cmds / (DATA_LOG_SIZE >> 20),
+           (unsigned)(write_stat.bounced * 100 / write_stat.bytes), DATA_LOG_SIZE / (t1 - t0) / 1e6,
+           (double)read_stat.cmds / (DATA_LOG_SIZE >> 20), (unsigned)(read_stat.bounced * 100 / read_stat.bytes),
+           DATA_LOG_SIZE / (t2 - t1) / 1e6);
+    check(read_stat.stray_invalidates + write_stat.stray_invalidates == 0, "invalidate outside the buffer", offset, record);
+    check(read_stat.unaligned_dma + write_stat.unaligned_dma == 0, "dma from a byte aligned buffer", offset, record);
+}
+
+int main(void)
+{
+    static const uint32_t runs[] = {1, 8, 64};
+    static const uint32_t records[] = {512, 4096, 32768};
+    static BYTE work[FF_MAX_SS * 8];
+    MKFS_PARM parm = {.fmt = FM_ANY};
+
+    if (sd_disk_initialize(DEV_SD) != RES_OK) {
+        printf("sd_disk_initialize failed\nFAILED\n");
+        return 1;
+    }
+    fill(ram_sd_disk, RAM_SD_SECTOR_CNT * RAM_SD_SECTOR_SIZE, 1);
+
+    printf("sd_disk_read/write, %u MiB per run\n", DISKIO_BYTES >> 20);
+    for (unsigned o = 0; o < sizeof(offsets) / sizeof(offsets[0]); o++) {
+        for (unsigned r = 0; r < sizeof(runs) / sizeof(runs[0]); r++) {
+            bench_diskio(offsets[o], runs[r]);
+        }
+    }
+
+    if ((f_mkfs("3:", &parm, work, sizeof(work)) != FR_OK) || (f_mount(&fs, "3:", 1) != FR_OK)) {
+        printf("f_mkfs or f_mount failed\nFAILED\n");
+        return 1;
+    }
+    printf("FatFs data log of %u MiB\n", DATA_LOG_SIZE >> 20);
+    for (unsigned o = 0; o < sizeof(offsets) / sizeof(offsets[0]); o++) {
+        for (unsigned r = 0; r < sizeof(records) / sizeof(records[0]); r++) {
+            bench_data_log(offsets[o], records[r]);
+        }
+    }
+    f_mount(NULL, "3:", 0);
+
+    printf(failures ? "FAILED\n" : "PASSED.\n");
+    return failures ? 1 : 0;
+}
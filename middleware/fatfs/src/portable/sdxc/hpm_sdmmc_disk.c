@@ -50,6 +50,68 @@ static void sdmmc_get_card_and_aligned_buf_info(BYTE pdrv, void **card, uint32_t
 #endif
 }
 
+/*
+ * The SDXC DMA needs word aligned buffers, so other buffers are bounced.
+ * In 26-bit ADMA2 length mode one descriptor covers a whole request, so a direct transfer is one command
+ * however many sectors FatFs asks for.
+ */
+#define SDMMC_DISK_IS_DMA_ALIGNED(addr)         (((uint32_t)(addr) & 3U) == 0U)
+#define SDMMC_DISK_IS_CACHELINE_ALIGNED(addr)   (((uint32_t)(addr) & (HPM_L1C_CACHELINE_SIZE - 1U)) == 0U)
+
+/* The sdmmc library flushes and invalidates the transfer range itself unless this is disabled */
+#if !defined(HPM_SDMMC_ENABLE_CACHE_MAINTENANCE) || (HPM_SDMMC_ENABLE_CACHE_MAINTENANCE == 1)
+#define SDMMC_DISK_BOUNCE_CACHE_MAINTENANCE 0
+#else
+#define SDMMC_DISK_BOUNCE_CACHE_MAINTENANCE 1
+#endif
+
+static DSTATUS sdmmc_card_bounce_write(sdmmc_write_op_t card_write, void *card, uint32_t *aligned_buf, uint32_t aligned_buf_size,
+                                       const BYTE *buff, LBA_t sector, UINT count)
+{
+    uint32_t sys_aligned_buf_addr = core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t) aligned_buf);
+    uint32_t remaining_size = SD_SECTOR_SIZE * count;
+    while (remaining_size > 0) {
+        uint32_t write_size = MIN(aligned_buf_size, remaining_size);
+        memcpy(aligned_buf, buff, write_size);
+#if SDMMC_DISK_BOUNCE_CACHE_MAINTENANCE
+        l1c_dc_flush(sys_aligned_buf_addr, write_size);
+#endif
+        uint32_t sector_count = (uint32_t) write_size / SD_SECTOR_SIZE;
+        if (card_write(card, (const uint8_t *) sys_aligned_buf_addr, (uint32_t) sector, sector_count) !=
+            status_success) {
+            return RES_ERROR;
+        }
+        buff += write_size;
+        sector += sector_count;
+        remaining_size -= write_size;
+    }
+
+    return RES_OK;
+}
+
+static DSTATUS sdmmc_card_bounce_read(sdmmc_read_op_t card_read, void *card, uint32_t *aligned_buf, uint32_t aligned_buf_size,
+                                      BYTE *buff, LBA_t sector, UINT count)
+{
+    uint32_t sys_aligned_buf_addr = core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t) aligned_buf);
+    uint32_t remaining_size = SD_SECTOR_SIZE * count;
+    while (remaining_size > 0) {
+        uint32_t read_size = MIN(aligned_buf_size, remaining_size);
+        uint32_t sector_count = read_size / SD_SECTOR_SIZE;
+        if (card_read(card, (uint8_t *) sys_aligned_buf_addr, sector, sector_count) != status_success) {
+            return RES_ERROR;
+        }
+#if SDMMC_DISK_BOUNCE_CACHE_MAINTENANCE
+        l1c_dc_invalidate(sys_aligned_buf_addr, read_size);
+#endif
+        memcpy(buff, aligned_buf, read_size);
+        buff += read_size;
+        sector += sector_count;
+        remaining_size -= read_size;
+    }
+
+    return RES_OK;
+}
+
 static DSTATUS sdmmc_card_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT count)
 {
     sdmmc_write_op_t card_write;
@@ -67,26 +129,12 @@ static DSTATUS sdmmc_card_write(BYTE pdrv, const BYTE *buff, LBA_t sector, UINT
         card_write = (sdmmc_write_op_t)emmc_write_blocks;
     }
 #endif
-    if (((uint32_t) buff % 4) != 0) {
-        uint32_t sys_aligned_buf_addr = core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t) aligned_buf);
-        uint32_t remaining_size = SD_SECTOR_SIZE * count;
-        while (remaining_size > 0) {
-            uint32_t write_size = MIN(aligned_buf_size, remaining_size);
-            memcpy(aligned_buf, buff, write_size);
-            l1c_dc_flush(sys_aligned_buf_addr, write_size);
-            uint32_t sector_count = (uint32_t) write_size / SD_SECTOR_SIZE;
-            if (card_write(card, (const uint8_t *) sys_aligned_buf_addr, (uint32_t) sector, sector_count) !=
-                status_success) {
-                return RES_ERROR;
-            }
-            buff += write_size;
-            sector += sector_count;
-            remaining_size -= write_size;
-        }
-    } else {
-        if (card_write(card, (const uint8_t *) buff, (uint32_t) sector, (uint32_t) count) != status_success) {
-            return RES_ERROR;
-        }
+    if (!SDMMC_DISK_IS_DMA_ALIGNED(buff)) {
+        return sdmmc_card_bounce_write(card_write, card, aligned_buf, aligned_buf_size, buff, sector, count);
+    }
+    /* Flushing never discards data, so partial cache lines at either end are safe to write from directly */
+    if (card_write(card, (const uint8_t *) buff, (uint32_t) sector, (uint32_t) count) != status_success) {
+        return RES_ERROR;
     }
 
     return RES_OK;
@@ -109,27 +157,29 @@ static DSTATUS sdmmc_card_read(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count)
         card_read = (sdmmc_read_op_t)emmc_read_blocks;
     }
 #endif
-    if (((uint32_t) buff % 4) != 0) {
-        uint32_t sys_aligned_buf_addr = core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t) aligned_buf);
-        uint32_t remaining_size = SD_SECTOR_SIZE * count;
-        while (remaining_size > 0) {
-            uint32_t read_size = MIN(aligned_buf_size, remaining_size);
-            uint32_t sector_count = read_size / SD_SECTOR_SIZE;
-            if (card_read(card, (uint8_t *) sys_aligned_buf_addr, sector, sector_count) != status_success) {
-                return RES_ERROR;
-            }
-            l1c_dc_invalidate(sys_aligned_buf_addr, read_size);
-            memcpy(buff, aligned_buf, read_size);
-            buff += read_size;
-            sector += sector_count;
-            remaining_size -= read_size;
-        }
-    } else {
+    if (!SDMMC_DISK_IS_DMA_ALIGNED(buff) || (!SDMMC_DISK_IS_CACHELINE_ALIGNED(buff) && (count <= 2U))) {
+        return sdmmc_card_bounce_read(card_read, card, aligned_buf, aligned_buf_size, buff, sector, count);
+    }
+    if (SDMMC_DISK_IS_CACHELINE_ALIGNED(buff)) {
         if (card_read(card, (uint8_t *) buff, sector, count) != status_success) {
             return RES_ERROR;
         }
+        return RES_OK;
     }
-    return RES_OK;
+    /*
+     * The first and last cache lines of an unaligned buffer are shared with the caller's neighbours,
+     * invalidating them after the DMA would drop whatever was written there meanwhile.
+     * Read the inner sectors directly, their cache lines lie inside the buffer, then bounce the first and the last
+     * sector, copying them in after the inner invalidate.
+     */
+    if (card_read(card, (uint8_t *) (buff + SD_SECTOR_SIZE), sector + 1U, count - 2U) != status_success) {
+        return RES_ERROR;
+    }
+    if (sdmmc_card_bounce_read(card_read, card, aligned_buf, aligned_buf_size, buff, sector, 1U) != RES_OK) {
+        return RES_ERROR;
+    }
+    return sdmmc_card_bounce_read(card_read, card, aligned_buf, aligned_buf_size, buff + SD_SECTOR_SIZE * (count - 1U),
+                                  sector + count - 1U, 1U);
 }
 #endif
 
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Software fft benchmark
+ *
+ * Times the complex fft of sw_dsp/hpm_math_sw.c for N = 16..4096 against the cooley tukey
+ * routine it replaced (kept below as old_cfft_float) and against hpm_dsp_cfft_rd4_f32 of the
+ * sw_dsp/ref backend, which only takes N = 16, 64, 256 and 1024. Each result is compared with
+ * a double precision fft, the error is the largest difference divided by the largest output
+ * magnitude.
+ *
+ * usage: FftBench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "hpm_math.h"
+
+#define FFT_MIN_M (4U)
+#define FFT_MAX_M (12U)
+#define FFT_MAX_N (1U << FFT_MAX_M)
+
+static int failures;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("  check failed at line %d: %s\n", __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+/*
+ * hpm_software_cfft_float before the plan based fft: twiddles are chained by a complex multiply
+ * per butterfly and the bit reversal indexes are built in 2^m words after the end of src.
+ */
+typedef struct {
+    float real;
+    float imag;
+} old_complex_t;
+
+static old_complex_t old_comp_mul(old_complex_t x, old_complex_t y)
+{
+    old_complex_t c;
+    c.real = x.real * y.real - x.imag * y.imag;
+    c.imag = x.real * y.imag + x.imag * y.real;
+    return c;
+}
+
+static void old_cfft_float(float *src, uint32_t m)
+{
+    uint32_t len = 1 << m;
+    old_complex_t t;
+    old_complex_t w = {1, 0};
+    old_complex_t *c = (old_complex_t *)src;
+    uint32_t *memory = (uint32_t *)(src + 2 * len);
+
+    for (uint32_t i = 0; i < len; i++) {
+        memory[i] = (memory[i >> 1] >> 1) | ((i & 1) << (m - 1));
+    }
+    for (uint32_t i = 0; i < len; i++) {
+        if (i < memory[i]) {
+            t = c[i];
+            c[i] = c[memory[i]];
+            c[memory[i]] = t;
+        }
+    }
+    for (uint32_t n = 1; n < len; n <<= 1) {
+        old_complex_t cn;
+        old_complex_t wn;
+        cn.real = cosf(HPM_MATH_PI / n);
+        cn.imag = -sinf(HPM_MATH_PI / n);
+        for (uint32_t rl = n << 1, j = 0; j < len; j += rl) {
+            wn = w;
+            for (uint32_t k = 0; k < n; k++, wn = old_comp_mul(wn, cn)) {
+                old_complex_t a = c[j + k], b = old_comp_mul(wn, c[j + n + k]);
+                c[j + k].real = a.real + b.real;
+                c[j + k].imag = a.imag + b.imag;
+                c[j + n + k].real = a.real - b.real;
+                c[j + n + k].imag = a.imag - b.imag;
+            }
+        }
+    }
+}
+
+static uint32_t s_seed = 0x12345678U;
+static float s_input[2 * FFT_MAX_N];
+/* the old routine needs 2^m words of scratch after the samples */
+static float s_buf[3 * FFT_MAX_N];
+static double s_ref[2 * FFT_MAX_N];
+static hpm_sw_fft_plan_t s_plan;
+
+static float rand_f32(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return (float)((int32_t)(s_seed >> 8) - 0x800000) / (float)0x800000;
+}
+
+static void ref_fft(const float *src, double *dst, uint32_t m)
+{
+    uint32_t n = 1U << m;
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t j = 0;
+        for (uint32_t b = 0; b < m; b++) {
+            j |= ((i >> b) & 1U) << (m - 1 - b);
+        }
+        dst[2 * j] = src[2 * i];
+        dst[2 * j + 1] = src[2 * i + 1];
+    }
+    for (uint32_t h = 1; h < n; h <<= 1) {
+        for (uint32_t j = 0; j < n; j += h << 1) {
+            for (uint32_t k = 0; k < h; k++) {
+                double wr = cos(-HPM_MATH_PI * k / h);
+                double wi = sin(-HPM_MATH_PI * k / h);
+                double *a = &dst[2 * (j + k)];
+                double *b = &dst[2 * (j + k + h)];
+                double tr = b[0] * wr - b[1] * wi;
+                double ti = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - tr;
+                b[1] = a[1] - ti;
+                a[0] += tr;
+                a[1] += ti;
+            }
+        }
+    }
+}
+
+static double rel_error(const float *got, const double *expect, uint32_t n)
+{
+    double err = 0.0, mag = 0.0;
+
+    for (uint32_t i = 0; i < 2 * n; i++) {
+        if (fabs(got[i] - expect[i]) > err) {
+            err = fabs(got[i] - expect[i]);
+        }
+        if (fabs(expect[i]) > mag) {
+            mag = fabs(expect[i]);
+        }
+    }
+    return err / mag;
+}
+
+static double now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void load(uint32_t n)
+{
+    memcpy(s_buf, s_input, 2 * n * sizeof(float));
+    memset(&s_buf[2 * n], 0, n * sizeof(float));
+}
+
+static void run_old(uint32_t m)
+{
+    load(1U << m);
+    old_cfft_float(s_buf, m);
+}
+
+static void run_plan(uint32_t m)
+{
+    (void)m;
+    load(s_plan.len);
+    hpm_sw_cfft_f32(&s_plan, s_buf);
+}
+
+static void run_rd4(uint32_t m)
+{
+    load(1U << m);
+    CHECK(hpm_dsp_cfft_rd4_f32(s_buf, m) == 0);
+}
+
+/* time of one call including the copy of the input, every run leaves its output in s_buf */
+static double bench(void (*run)(uint32_t), uint32_t m, uint32_t iterations)
+{
+    uint32_t reps = iterations * (FFT_MAX_N >> m);
+    double start = now_us();
+
+    for (uint32_t i = 0; i < reps; i++) {
+        run(m);
+    }
+    return (now_us() - start) / reps;
+}
+
+static bool rd4_supported(uint32_t m)
+{
+    return ((m & 1U) == 0U) && (m <= 10U);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iterations = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 20U;
+
+    if (iterations == 0) {
+        iterations = 1;
+    }
+    for (uint32_t i = 0; i < 2 * FFT_MAX_N; i++) {
+        s_input[i] = rand_f32();
+    }
+
+    /* out of range sizes are rejected and leave the samples alone */
+    load(16);
+    CHECK(hpm_software_cfft_float(s_buf, 0) == -1);
+    CHECK(hpm_software_cfft_float(s_buf, HPM_MATH_SW_FFT_MAX_M + 1) == -1);
+    CHECK(memcmp(s_buf, s_input, 32 * sizeof(float)) == 0);
+    CHECK(hpm_sw_fft_plan_create(&s_plan, HPM_MATH_SW_FFT_MAX_M + 1) == -1);
+
+    printf("%6s %10s %10s %10s   %9s %9s %9s\n", "N", "old us", "plan us", "rd4 us", "old err", "plan err", "rd4 err");
+    for (uint32_t m = FFT_MIN_M; m <= FFT_MAX_M; m++) {
+        uint32_t n = 1U << m;
+        double t_old, t_plan, t_rd4 = 0.0;
+        double e_old, e_plan, e_rd4 = 0.0;
+
+        ref_fft(s_input, s_ref, m);
+        CHECK(hpm_sw_fft_plan_create(&s_plan, m) == 0);
+
+        t_old = bench(run_old, m, iterations);
+        e_old = rel_error(s_buf, s_ref, n);
+        t_plan = bench(run_plan, m, iterations);
+        e_plan = rel_error(s_buf, s_ref, n);
+        CHECK(e_plan < 1e-6);
+        CHECK(e_plan <= e_old * 1.5);
+        /* the compatibility wrapper runs the same plan */
+        load(n);
+        CHECK(hpm_software_cfft_float(s_buf, m) == 0);
+        CHECK(rel_error(s_buf, s_ref, n) == e_plan);
+
+        if (rd4_supported(m)) {
+            t_rd4 = bench(run_rd4, m, iterations);
+            e_rd4 = rel_error(s_buf, s_ref, n);
+            CHECK(e_rd4 < 1e-6);
+            printf("%6u %10.2f %10.2f %10.2f   %9.2e %9.2e %9.2e\n", n, t_old, t_plan, t_rd4, e_old, e_plan, e_rd4);
+        } else {
+            printf("%6u %10.2f %10.2f %10s   %9.2e %9.2e %9s\n", n, t_old, t_plan, "-", e_old, e_plan, "-");
+        }
+    }
+
+    if (failures != 0) {
+        printf("FAILED\n");
+        return 1;
+    }
+    printf("PASSED.\n");
+    return 0;
+}
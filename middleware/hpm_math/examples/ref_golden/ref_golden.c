@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Golden vector check of the sw_dsp/ref backend
+ *
+ * The inputs come from a fixed pseudo random sequence, so the runs are reproducible.
+ * Every result of the backend is compared against a double precision model of the
+ * function as documented in nds_dsp/riscv_dsp_*.h, with a tolerance that matches the
+ * output format (a few ulp scaled by the problem size for floats, 1-2 LSB for Q formats).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "hpm_math.h"
+
+#define VEC_SIZE  (256U)
+#define MAT_SIZE  (8U)
+#define FFT_MAX_M (10U)
+#define FFT_MAX_N (1U << FFT_MAX_M)
+
+static uint32_t s_seed = 0x12345678U;
+static uint32_t s_checks;
+static uint32_t s_failures;
+
+static float32_t rand_f32(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return (float32_t)((int32_t)(s_seed >> 8) - 0x800000) / (float32_t)0x800000;
+}
+
+static q31_t f_to_q31(double x)
+{
+    return (q31_t)lround(x * 2147483648.0 * 0.999);
+}
+
+static q15_t f_to_q15(double x)
+{
+    return (q15_t)lround(x * 32768.0 * 0.999);
+}
+
+static void check(const char *name, double got, double expect, double tol)
+{
+    s_checks++;
+    if (!(fabs(got - expect) <= tol)) {
+        if (s_failures < 20U) {
+            printf("  %-16s got %.9g expected %.9g (tol %.3g)\n", name, got, expect, tol);
+        }
+        s_failures++;
+    }
+}
+
+static void check_vec_f32(const char *name, const float32_t *got, const double *expect, uint32_t n, double tol)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        check(name, got[i], expect[i], tol);
+    }
+}
+
+static void test_statistics(void)
+{
+    float32_t x[VEC_SIZE];
+    q15_t xq[VEC_SIZE];
+    double sum = 0.0, sum_sqr = 0.0, mean, var, qsum = 0.0;
+    double max = -2.0;
+    uint32_t max_idx = 0, idx;
+
+    for (uint32_t i = 0; i < VEC_SIZE; i++) {
+        x[i] = rand_f32();
+        xq[i] = f_to_q15(x[i]);
+        sum += x[i];
+        qsum += xq[i];
+        sum_sqr += (double)x[i] * x[i];
+        if (x[i] > max) {
+            max = x[i];
+            max_idx = i;
+        }
+    }
+    mean = sum / VEC_SIZE;
+    var = 0.0;
+    for (uint32_t i = 0; i < VEC_SIZE; i++) {
+        var += (x[i] - mean) * (x[i] - mean);
+    }
+    var /= (VEC_SIZE - 1U);
+
+    check("mean_f32", riscv_dsp_mean_f32(x, VEC_SIZE), mean, 1e-6);
+    check("var_f32", riscv_dsp_var_f32(x, VEC_SIZE), var, 1e-6);
+    check("std_f32", riscv_dsp_std_f32(x, VEC_SIZE), sqrt(var), 1e-6);
+    check("rms_f32", riscv_dsp_rms_f32(x, VEC_SIZE), sqrt(sum_sqr / VEC_SIZE), 1e-6);
+    check("max_f32", riscv_dsp_max_f32(x, VEC_SIZE, &idx), max, 0.0);
+    check("max_f32 index", idx, max_idx, 0.0);
+    check("mean_q15", riscv_dsp_mean_q15(xq, VEC_SIZE), floor(qsum / VEC_SIZE), 1.0);
+}
+
+static void test_basic(void)
+{
+    float32_t a[VEC_SIZE], b[VEC_SIZE], c[VEC_SIZE];
+    q31_t a31[VEC_SIZE], b31[VEC_SIZE], c31[VEC_SIZE];
+    q15_t a15[VEC_SIZE], b15[VEC_SIZE], c15[VEC_SIZE];
+    double dot = 0.0;
+
+    for (uint32_t i = 0; i < VEC_SIZE; i++) {
+        a[i] = rand_f32();
+        b[i] = rand_f32();
+        a31[i] = f_to_q31(a[i]);
+        b31[i] = f_to_q31(b[i]);
+        a15[i] = f_to_q15(a[i]);
+        b15[i] = f_to_q15(b[i]);
+        dot += (double)a[i] * b[i];
+    }
+
+    riscv_dsp_add_f32(a, b, c, VEC_SIZE);
+    for (uint32_t i = 0; i < VEC_SIZE; i++) {
+        check("add_f32", c[i], (double)a[i] + b[i], 1e-6);
+    }
+    check("dprod_f32", riscv_dsp_dprod_f32(a, b, VEC_SIZE), dot, 1e-4);
+
+    /* the sum saturates, the product is truncated to the operand format */
+    riscv_dsp_mul_q31(a31, b31, c31, VEC_SIZE);
+    for (uint32_t i = 0; i < VEC_SIZE; i++) {
+        check("mul_q31", c31[i], floor((double)a31[i] * b31[i] / 2147483648.0), 1.0);
+    }
+    riscv_dsp_add_q31(a31, b31, c31, VEC_SIZE);
+    for (uint32_t i = 0; i < VEC_SIZE; i++) {
+        double s = (double)a31[i] + b31[i];
+        s = (s > 2147483647.0) ? 2147483647.0 : ((s < -2147483648.0) ? -2147483648.0 : s);
+        check("add_q31", c31[i], s, 0.0);
+    }
+    riscv_dsp_add_q15(a15, b15, c15, VEC_SIZE);
+    for (uint32_t i = 0; i < VEC_SIZE; i++) {
+        double s = (double)a15[i] + b15[i];
+        s = (s > 32767.0) ? 32767.0 : ((s < -32768.0) ? -32768.0 : s);
+        check("add_q15", c15[i], s, 0.0);
+    }
+    riscv_dsp_mul_q15(a15, b15, c15, VEC_SIZE);
+    for (uint32_t i = 0; i < VEC_SIZE; i++) {
+        check("mul_q15", c15[i], floor((double)a15[i] * b15[i] / 32768.0), 1.0);
+    }
+    /* 0.75 * 2^1 */
+    riscv_dsp_scale_q31(a31, f_to_q31(0.75), 1, c31, VEC_SIZE);
+    for (uint32_t i = 0; i < VEC_SIZE; i++) {
+        double s = (double)a31[i] * f_to_q31(0.75) / 1073741824.0;
+        s = (s > 2147483647.0) ? 2147483647.0 : ((s < -2147483648.0) ? -2147483648.0 : s);
+        check("scale_q31", c31[i], floor(s), 1.0);
+    }
+}
+
+static void test_complex(void)
+{
+    float32_t a[2 * VEC_SIZE], b[2 * VEC_SIZE], c[2 * VEC_SIZE];
+    double re = 0.0, im = 0.0;
+
+    for (uint32_t i = 0; i < 2U * VEC_SIZE; i++) {
+        a[i] = rand_f32();
+        b[i] = rand_f32();
+    }
+    riscv_dsp_cmag_f32(a, c, VEC_SIZE);
+    for (uint32_t i = 0; i < VEC_SIZE; i++) {
+        check("cmag_f32", c[i], hypot(a[2 * i], a[2 * i + 1]), 1e-6);
+    }
+    riscv_dsp_cmul_f32(a, b, c, VEC_SIZE);
+    for (uint32_t i = 0; i < VEC_SIZE; i++) {
+        double ar = a[2 * i], ai = a[2 * i + 1], br = b[2 * i], bi = b[2 * i + 1];
+        check("cmul_f32 re", c[2 * i], ar * br - ai * bi, 1e-6);
+        check("cmul_f32 im", c[2 * i + 1], ar * bi + ai * br, 1e-6);
+        re += ar * br - ai * bi;
+        im += ar * bi + ai * br;
+    }
+    riscv_dsp_cdprod_f32(a, b, VEC_SIZE, c);
+    check("cdprod_f32 re", c[0], re, 1e-4);
+    check("cdprod_f32 im", c[1], im, 1e-4);
+}
+
+static void test_filtering(void)
+{
+    enum { TAPS = 17, BLOCK = 64, BLOCKS = 4, NSTAGE = 2 };
+    float32_t coeff[TAPS], state[TAPS + BLOCK - 1], x[BLOCKS * BLOCK], y[BLOCKS * BLOCK];
+    double expect[BLOCKS * BLOCK];
+    riscv_dsp_fir_f32_t fir = {TAPS, state, coeff};
+    /* two stable low-pass sections, a1/a2 are stored negated as in the header example */
+    float32_t bq_coeff[5 * NSTAGE] = {0.0675f, 0.1349f, 0.0675f, 1.1430f, -0.4128f,
+                                      0.2066f, 0.4131f, 0.2066f, 0.3695f, -0.1958f};
+    float32_t bq_state[4 * NSTAGE] = {0};
+    riscv_dsp_bq_df1_f32_t bq = {NSTAGE, bq_state, bq_coeff};
+    double w[NSTAGE][4] = {{0}};
+
+    for (uint32_t i = 0; i < TAPS; i++) {
+        coeff[i] = rand_f32() / TAPS;
+    }
+    for (uint32_t i = 0; i < BLOCKS * BLOCK; i++) {
+        x[i] = rand_f32();
+    }
+    memset(state, 0, sizeof(state));
+
+    /* coefficients are stored time reversed: y[n] = sum coeff[TAPS - 1 - k] * x[n - k] */
+    for (uint32_t n = 0; n < BLOCKS * BLOCK; n++) {
+        double acc = 0.0;
+        for (uint32_t k = 0; k < TAPS; k++) {
+            if (n >= k) {
+                acc += (double)coeff[TAPS - 1U - k] * x[n - k];
+            }
+        }
+        expect[n] = acc;
+    }
+    for (uint32_t blk = 0; blk < BLOCKS; blk++) {
+        riscv_dsp_fir_f32(&fir, x + blk * BLOCK, y + blk * BLOCK, BLOCK);
+    }
+    check_vec_f32("fir_f32", y, expect, BLOCKS * BLOCK, 1e-6);
+
+    /* direct form I, state per stage [x[n-1], x[n-2], y[n-1], y[n-2]] */
+    for (uint32_t n = 0; n < BLOCKS * BLOCK; n++) {
+        double in = x[n];
+        for (uint32_t s = 0; s < NSTAGE; s++) {
+            const float32_t *c = bq_coeff + 5U * s;
+            double out = c[0] * in + c[1] * w[s][0] + c[2] * w[s][1] + c[3] * w[s][2] + c[4] * w[s][3];
+            w[s][1] = w[s][0];
+            w[s][0] = in;
+            w[s][3] = w[s][2];
+            w[s][2] = out;
+            in = out;
+        }
+        expect[n] = in;
+    }
+    for (uint32_t blk = 0; blk < BLOCKS; blk++) {
+        riscv_dsp_bq_df1_f32(&bq, x + blk * BLOCK, y + blk * BLOCK, BLOCK);
+    }
+    check_vec_f32("bq_df1_f32", y, expect, BLOCKS * BLOCK, 1e-5);
+}
+
+static void test_matrix(void)
+{
+    float32_t a[MAT_SIZE * MAT_SIZE], b[MAT_SIZE * MAT_SIZE], c[MAT_SIZE * MAT_SIZE], inv[MAT_SIZE * MAT_SIZE];
+    float64_t a64[MAT_SIZE * MAT_SIZE], b64[MAT_SIZE * MAT_SIZE], c64[MAT_SIZE * MAT_SIZE];
+
+    for (uint32_t i = 0; i < MAT_SIZE * MAT_SIZE; i++) {
+        a[i] = rand_f32();
+        b[i] = rand_f32();
+        a64[i] = a[i];
+        b64[i] = b[i];
+    }
+    /* diagonally dominant, so that the inverse is well conditioned */
+    for (uint32_t i = 0; i < MAT_SIZE; i++) {
+        a[i * MAT_SIZE + i] += (float32_t)MAT_SIZE;
+    }
+
+    riscv_dsp_mat_add_f64(a64, b64, c64, MAT_SIZE, MAT_SIZE);
+    for (uint32_t i = 0; i < MAT_SIZE * MAT_SIZE; i++) {
+        check("mat_add_f64", c64[i], a64[i] + b64[i], 0.0);
+    }
+    riscv_dsp_mat_mul_f64(a64, b64, c64, MAT_SIZE, MAT_SIZE, MAT_SIZE);
+    riscv_dsp_mat_mul_f32(a, b, c, MAT_SIZE, MAT_SIZE, MAT_SIZE);
+    for (uint32_t r = 0; r < MAT_SIZE; r++) {
+        for (uint32_t col = 0; col < MAT_SIZE; col++) {
+            double acc64 = 0.0, acc = 0.0;
+            for (uint32_t k = 0; k < MAT_SIZE; k++) {
+                acc64 += a64[r * MAT_SIZE + k] * b64[k * MAT_SIZE + col];
+                acc += (double)a[r * MAT_SIZE + k] * b[k * MAT_SIZE + col];
+            }
+            check("mat_mul_f64", c64[r * MAT_SIZE + col], acc64, 1e-12);
+            check("mat_mul_f32", c[r * MAT_SIZE + col], acc, 1e-5);
+        }
+    }
+    riscv_dsp_mat_trans_f32(a, c, MAT_SIZE, MAT_SIZE);
+    for (uint32_t r = 0; r < MAT_SIZE; r++) {
+        for (uint32_t col = 0; col < MAT_SIZE; col++) {
+            check("mat_trans_f32", c[col * MAT_SIZE + r], a[r * MAT_SIZE + col], 0.0);
+        }
+    }
+    /* the inverse overwrites its source, check A * inv(A) = I on a copy */
+    memcpy(c, a, sizeof(a));
+    check("mat_inv_f32 ret", riscv_dsp_mat_inv_f32(c, inv, MAT_SIZE), 0, 0.0);
+    for (uint32_t r = 0; r < MAT_SIZE; r++) {
+        for (uint32_t col = 0; col < MAT_SIZE; col++) {
+            double acc = 0.0;
+            for (uint32_t k = 0; k < MAT_SIZE; k++) {
+                acc += (double)a[r * MAT_SIZE + k] * inv[k * MAT_SIZE + col];
+            }
+            check("mat_inv_f32", acc, (r == col) ? 1.0 : 0.0, 1e-5);
+        }
+    }
+}
+
+static void dft(const double *x, double *y, uint32_t n)
+{
+    for (uint32_t k = 0; k < n; k++) {
+        double re = 0.0, im = 0.0;
+        for (uint32_t t = 0; t < n; t++) {
+            double angle = -2.0 * HPM_MATH_PI * (double)((uint64_t)k * t % n) / n;
+            re += x[2 * t] * cos(angle) - x[2 * t + 1] * sin(angle);
+            im += x[2 * t] * sin(angle) + x[2 * t + 1] * cos(angle);
+        }
+        y[2 * k] = re;
+        y[2 * k + 1] = im;
+    }
+}
+
+static void test_transform(void)
+{
+    static float32_t buf[2 * FFT_MAX_N], orig[2 * FFT_MAX_N];
+    static q31_t buf31[2 * FFT_MAX_N];
+    static double x[2 * FFT_MAX_N], y[2 * FFT_MAX_N];
+
+    for (uint32_t m = 3; m <= FFT_MAX_M; m++) {
+        uint32_t n = 1U << m;
+        double tol = 1e-6 * n;
+
+        for (uint32_t i = 0; i < 2U * n; i++) {
+            orig[i] = buf[i] = rand_f32();
+            buf31[i] = f_to_q31(buf[i]);
+            x[i] = buf[i];
+        }
+        dft(x, y, n);
+
+        riscv_dsp_cfft_f32(buf, m);
+        check_vec_f32("cfft_f32", buf, y, 2U * n, tol);
+        riscv_dsp_cifft_f32(buf, m);
+        for (uint32_t i = 0; i < 2U * n; i++) {
+            check("cifft_f32", buf[i], orig[i], 1e-6 * m);
+        }
+
+        /* every stage is scaled by 1/2, the forward output is X / N */
+        riscv_dsp_cfft_q31(buf31, m);
+        for (uint32_t i = 0; i < 2U * n; i++) {
+            check("cfft_q31", buf31[i] / 2147483648.0, y[i] * 0.999 / n, 4.0 * m / 2147483648.0 + 1e-9);
+        }
+
+        if (m >= 4U) {
+            /* n real samples, output [X[0], X[n/2], re(X[1]), im(X[1]), ...] */
+            for (uint32_t i = 0; i < n; i++) {
+                x[2 * i] = buf[i] = orig[i];
+                x[2 * i + 1] = 0.0;
+            }
+            dft(x, y, n);
+            check("rfft_f32 ret", riscv_dsp_rfft_f32(buf, m), 0, 0.0);
+            check("rfft_f32 dc", buf[0], y[0], tol);
+            check("rfft_f32 nyq", buf[1], y[n], tol);
+            for (uint32_t k = 1; k < n / 2U; k++) {
+                check("rfft_f32 re", buf[2 * k], y[2 * k], tol);
+                check("rfft_f32 im", buf[2 * k + 1], y[2 * k + 1], tol);
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    static const struct {
+        const char *name;
+        void (*run)(void);
+    } tests[] = {
+        {"statistics", test_statistics},
+        {"basic", test_basic},
+        {"complex", test_complex},
+        {"filtering", test_filtering},
+        {"matrix", test_matrix},
+        {"transform", test_transform},
+    };
+
+    for (uint32_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+        uint32_t failures = s_failures;
+        uint32_t checks = s_checks;
+
+        tests[i].run();
+        printf("%-12s %6u checks, %u failed\n", tests[i].name, s_checks - checks, s_failures - failures);
+    }
+
+    if (s_failures != 0U) {
+        printf("FAILED\n");
+        return 1;
+    }
+    printf("PASSED.\n");
+    return 0;
+}
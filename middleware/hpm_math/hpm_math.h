@@ -52,15 +52,23 @@
 #define HPM_MATH_PI (3.14159265358979323846)
 
 /**
- * @brief HPM_MATH_SW_FFT_CHECKLIST Enabled to use table lookup to speed up the software fft,
- *  but will increase the code space,and only support sampling points 2^( 2-10).
- *
- * With this option turned off,
- * the software fft can support as many sample points as necessary with sufficient space
+ * @brief HPM_MATH_SW_FFT_MAX_M Base 2 logarithm of the largest sample number supported by the
+ *  software fft, up to 12 (4096 points). The twiddle and bit reversal tables are const arrays
+ *  generated for 4096 points by sw_dsp/hpm_math_sw_fft_tbl.py and take 32KB of read-only data.
  *
  */
-#define HPM_MATH_SW_FFT_CHECKLIST
+#define HPM_MATH_SW_FFT_MAX_M (12U)
+
+#endif
 
+/*
+ * The hpm_dsp_* wrappers below only have a body for HPM_DSP_HW_NDS32. The riscv_dsp_* symbols
+ * they call come from the prebuilt nds dsp library (CONFIG_HPM_MATH_DSP), or from the portable C
+ * implementation in sw_dsp/ref (CONFIG_HPM_MATH_DSP_SW_REF, which defines HPM_MATH_DSP_SW_REF) that
+ * also builds with host toolchains.
+ */
+#if defined(HPM_EN_MATH_DSP_LIB) && defined(HPM_DSP_CORE) && (HPM_DSP_CORE != HPM_DSP_HW_NDS32)
+#error "hpm_math: unsupported HPM_DSP_CORE"
 #endif
 
 #ifdef  __cplusplus
@@ -5761,20 +5769,130 @@ static inline void hpm_dsp_idct4_q31(q31_t *src, uint32_t m)
 #endif
 }
 
+#endif
+
+#include <stdint.h>
+
 /**
  * @brief Software implementation does not depend on any hardware
  *
  */
 
+#ifndef HPM_MATH_SW_FFT_MAX_M
+#define HPM_MATH_SW_FFT_MAX_M (12U)
+#endif
+
 /**
- * @brief Construct a new hpm software cfft float object
+ * @brief Software fft plan
  *
- * @param src requires double the space than other interfaces, 0-n for input data, n-2n for buffers, 0-n for output data
- * @param m 2^n sampling points, including real and imaginary parts
+ * A plan only references the shared twiddle and bit reversal tables, so it is cheap to create
+ * and may be kept on the stack. All plans of any size share the same tables.
  */
-void hpm_software_cfft_float(float *src, uint32_t m);
+typedef struct {
+    uint32_t m;                 /**< base 2 logarithm of the sample number */
+    uint32_t len;               /**< sample number */
+    const float *twiddle;       /**< twiddle table, cos and sin pairs */
+    const uint16_t *bitrev;     /**< bit reversal table */
+} hpm_sw_fft_plan_t;
 
-#endif
+/**
+ * @brief Create a software fft plan
+ *
+ * The shared tables are const, so plans may be created from any task or interrupt.
+ *
+ * @param[out] plan  plan to initialize
+ * @param[in]  m     base 2 logarithm of the sample number, from 1 to HPM_MATH_SW_FFT_MAX_M.
+ *                   For the real transforms it is the number of real samples, from 2.
+ * @return 0 success; -1 failure
+ */
+int32_t hpm_sw_fft_plan_create(hpm_sw_fft_plan_t *plan, uint32_t m);
+
+/**
+ * @brief In-place complex fft, radix-4 with a radix-2 stage for odd m
+ *
+ * @param[in]     plan  plan created by hpm_sw_fft_plan_create
+ * @param[in,out] src   2^m complex samples arranged as [real, imaginary, ..., real, imaginary]
+ */
+void hpm_sw_cfft_f32(const hpm_sw_fft_plan_t *plan, float *src);
+
+/**
+ * @brief In-place complex ifft, the output is scaled by 1/2^m
+ *
+ * @param[in]     plan  plan created by hpm_sw_fft_plan_create
+ * @param[in,out] src   2^m complex samples arranged as [real, imaginary, ..., real, imaginary]
+ */
+void hpm_sw_cifft_f32(const hpm_sw_fft_plan_t *plan, float *src);
+
+/**
+ * @brief Out-of-place complex fft, the bit reversal is merged into the copy to dst
+ *
+ * @param[in]  plan  plan created by hpm_sw_fft_plan_create
+ * @param[in]  src   2^m complex input samples, left unchanged
+ * @param[out] dst   2^m complex output samples, must not overlap src
+ */
+void hpm_sw_cfft_f32_out(const hpm_sw_fft_plan_t *plan, const float *src, float *dst);
+
+/**
+ * @brief Out-of-place complex ifft, the output is scaled by 1/2^m
+ *
+ * @param[in]  plan  plan created by hpm_sw_fft_plan_create
+ * @param[in]  src   2^m complex input samples, left unchanged
+ * @param[out] dst   2^m complex output samples, must not overlap src
+ */
+void hpm_sw_cifft_f32_out(const hpm_sw_fft_plan_t *plan, const float *src, float *dst);
+
+/**
+ * @brief In-place real fft, computed with a 2^(m-1) point complex fft
+ *
+ * The output layout is the same as hpm_dsp_rfft_f32:
+ * [X[0], X[N/2], re(X[1]), im(X[1]), ..., re(X[N/2-1]), im(X[N/2-1])], N = 2^m.
+ *
+ * @param[in]     plan  plan created by hpm_sw_fft_plan_create, m is the number of real samples
+ * @param[in,out] src   2^m real samples
+ * @return 0 success; -1 failure
+ */
+int32_t hpm_sw_rfft_f32(const hpm_sw_fft_plan_t *plan, float *src);
+
+/**
+ * @brief In-place real ifft, the input layout is the output of hpm_sw_rfft_f32 and the output
+ * is scaled by 1/2^m
+ *
+ * @param[in]     plan  plan created by hpm_sw_fft_plan_create, m is the number of real samples
+ * @param[in,out] src   2^m values
+ * @return 0 success; -1 failure
+ */
+int32_t hpm_sw_rifft_f32(const hpm_sw_fft_plan_t *plan, float *src);
+
+/**
+ * @brief Out-of-place real fft
+ *
+ * @param[in]  plan  plan created by hpm_sw_fft_plan_create, m is the number of real samples
+ * @param[in]  src   2^m real samples, left unchanged
+ * @param[out] dst   2^m output values, must not overlap src
+ * @return 0 success; -1 failure
+ */
+int32_t hpm_sw_rfft_f32_out(const hpm_sw_fft_plan_t *plan, const float *src, float *dst);
+
+/**
+ * @brief Out-of-place real ifft
+ *
+ * @param[in]  plan  plan created by hpm_sw_fft_plan_create, m is the number of real samples
+ * @param[in]  src   2^m input values, left unchanged
+ * @param[out] dst   2^m real samples, must not overlap src
+ * @return 0 success; -1 failure
+ */
+int32_t hpm_sw_rifft_f32_out(const hpm_sw_fft_plan_t *plan, const float *src, float *dst);
+
+/**
+ * @brief Construct a new hpm software cfft float object
+ *
+ * Kept for compatibility, same as hpm_sw_cfft_f32 with a plan created for m.
+ *
+ * @param src 2^m complex samples, the output is stored in the input vector
+ * @param m 2^m sampling points, from 1 to HPM_MATH_SW_FFT_MAX_M
+ * @return 0 success; -1 failure, m is out of range and src is left unchanged
+ */
+int32_t hpm_software_cfft_float(float *src, uint32_t m);
 
 #if defined(HPMSOC_HAS_HPMSDK_FFA) && defined(HPM_EN_MATH_DSP_LIB)
 
@@ -6595,7 +6713,8 @@ static inline void hpm_dsp_sort_merge_f32(const riscv_dsp_sort_merge_f32_t * ins
 #endif
 
 #ifdef HPM_MATH_NN_TINYENGINE
-#ifdef HPM_EN_MATH_DSP_LIB
+/* the helpers below use the P extension intrinsics, the sw_dsp/ref backend has no replacement for them */
+#if defined(HPM_EN_MATH_DSP_LIB) && !defined(HPM_MATH_DSP_SW_REF)
 
 #include "riscv_math_types.h"
 #include <string.h>
@@ -0,0 +1,79 @@
+#!/usr/bin/env python
+#-*- coding: utf-8 -*-
+#
+# Copyright (c) 2024 HPMicro
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+"""
+    hpm_math_sw_fft_tbl
+    ~~~~~~~~~~~~~~~~~~~
+    Generate hpm_math_sw_fft_tbl.h, the twiddle and bit reversal tables of the
+    software fft in hpm_math_sw.c, for 2^m points. Smaller transforms index the
+    same tables with a stride.
+
+    usage: python hpm_math_sw_fft_tbl.py [m] > hpm_math_sw_fft_tbl.h
+"""
+
+import math
+import struct
+import sys
+
+HEADER = """/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Generated by hpm_math_sw_fft_tbl.py {m}, do not edit */
+
+#ifndef __HPM_MATH_SW_FFT_TBL_H__
+#define __HPM_MATH_SW_FFT_TBL_H__
+
+#include <stdint.h>
+
+#define HPM_MATH_SW_FFT_TBL_M ({m}U)
+#define HPM_MATH_SW_FFT_TBL_LEN (1UL << HPM_MATH_SW_FFT_TBL_M)
+
+/* cos and sin pairs of 2*pi*i/HPM_MATH_SW_FFT_TBL_LEN, i from 0 to 3/4 of the circle */"""
+
+FOOTER = """
+#endif /* __HPM_MATH_SW_FFT_TBL_H__ */
+"""
+
+
+def to_f32(x):
+    return struct.unpack('<f', struct.pack('<f', x))[0]
+
+
+def gen(m):
+    n = 1 << m
+    out = [HEADER.format(m=m)]
+
+    out.append('static const float hpm_math_sw_fft_twiddle[%d] = {' % (2 * (n * 3 // 4)))
+    for i in range(0, n * 3 // 4, 2):
+        line = []
+        for k in range(i, i + 2):
+            angle = 2.0 * math.pi * k / n
+            line.append('%.9ef, %.9ef,' % (to_f32(math.cos(angle)), to_f32(math.sin(angle))))
+        out.append('    ' + ' '.join(line))
+    out.append('};\n')
+
+    out.append('/* HPM_MATH_SW_FFT_TBL_M bit reversal of the index */')
+    out.append('static const uint16_t hpm_math_sw_fft_bitrev[%d] = {' % n)
+    rev = [0] * n
+    for i in range(1, n):
+        rev[i] = (rev[i >> 1] >> 1) | ((i & 1) << (m - 1))
+    for i in range(0, n, 12):
+        out.append('    ' + ' '.join('0x%04X,' % v for v in rev[i:i + 12]))
+    out.append('};')
+    out.append(FOOTER)
+    return '\n'.join(out)
+
+
+if __name__ == '__main__':
+    m = int(sys.argv[1]) if len(sys.argv) > 1 else 12
+    if m < 2 or m > 16:
+        sys.exit('m must be between 2 and 16')
+    sys.stdout.write(gen(m))
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __HPM_MATH_REF_COMMON_H__
+#define __HPM_MATH_REF_COMMON_H__
+
+/*
+ * Helpers shared by the portable C implementation of the riscv_dsp_* API.
+ *
+ * The reference backend is built instead of the prebuilt NDS32 DSP library
+ * when CONFIG_HPM_MATH_DSP_SW_REF is set. Every loop is written as a plain
+ * element-wise or reduction loop without intrinsics, so that it can be
+ * auto-vectorized by any C99 compiler, including host x86/riscv64 toolchains.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "hpm_math.h"
+
+#define REF_Q31_MAX ((q31_t)0x7FFFFFFF)
+#define REF_Q31_MIN ((q31_t)0x80000000)
+#define REF_Q15_MAX ((q15_t)0x7FFF)
+#define REF_Q15_MIN ((q15_t)0x8000)
+#define REF_Q7_MAX  ((q7_t)0x7F)
+#define REF_Q7_MIN  ((q7_t)0x80)
+
+#define REF_PI (3.14159265358979323846)
+
+static inline q31_t ref_sat_q31(q63_t x)
+{
+    return (x > REF_Q31_MAX) ? REF_Q31_MAX : ((x < REF_Q31_MIN) ? REF_Q31_MIN : (q31_t)x);
+}
+
+static inline q15_t ref_sat_q15(q63_t x)
+{
+    return (x > REF_Q15_MAX) ? REF_Q15_MAX : ((x < REF_Q15_MIN) ? REF_Q15_MIN : (q15_t)x);
+}
+
+static inline q7_t ref_sat_q7(q63_t x)
+{
+    return (x > REF_Q7_MAX) ? REF_Q7_MAX : ((x < REF_Q7_MIN) ? REF_Q7_MIN : (q7_t)x);
+}
+
+static inline uint8_t ref_sat_u8(q63_t x)
+{
+    return (x > 0xFF) ? 0xFF : ((x < 0) ? 0 : (uint8_t)x);
+}
+
+/* shift left for a positive shift, arithmetic shift right for a negative one */
+static inline q63_t ref_shift_q63(q63_t x, int32_t shift)
+{
+    return (shift >= 0) ? (q63_t)((uint64_t)x << shift) : (x >> (-shift));
+}
+
+static inline uint64_t ref_isqrt_u64(uint64_t x)
+{
+    uint64_t res = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (x >= res + bit) {
+            x -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return res;
+}
+
+#endif /* __HPM_MATH_REF_COMMON_H__ */
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "hpm_math_ref_common.h"
+
+#if defined(HPM_MATH_DSP_COMPLEX) && defined(HPM_EN_MATH_DSP_LIB)
+
+/*
+ * Complex vectors are stored as interleaved [real, imag] pairs.
+ */
+
+/*
+ * Complex conjugate
+ */
+void riscv_dsp_cconj_f32(const float32_t *src, float32_t *dst, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        dst[2 * i] = src[2 * i];
+        dst[2 * i + 1] = -src[2 * i + 1];
+    }
+}
+
+void riscv_dsp_cconj_q31(const q31_t *src, q31_t *dst, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        dst[2 * i] = src[2 * i];
+        dst[2 * i + 1] = ref_sat_q31(-(q63_t)src[2 * i + 1]);
+    }
+}
+
+void riscv_dsp_cconj_q15(const q15_t *src, q15_t *dst, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        dst[2 * i] = src[2 * i];
+        dst[2 * i + 1] = ref_sat_q15(-(q31_t)src[2 * i + 1]);
+    }
+}
+
+/*
+ * Complex dot product, the sum is written to dst[0] (real) and dst[1] (imag)
+ */
+void riscv_dsp_cdprod_f32(const float32_t *src1, const float32_t *src2, uint32_t size, float32_t *dst)
+{
+    float32_t re;
+    float32_t im;
+
+    riscv_dsp_cdprod_typ2_f32(src1, src2, size, &re, &im);
+    dst[0] = re;
+    dst[1] = im;
+}
+
+/* Q13 result */
+void riscv_dsp_cdprod_q15(const q15_t *src1, const q15_t *src2, uint32_t size, q15_t *dst)
+{
+    q63_t re = 0;
+    q63_t im = 0;
+
+    for (uint32_t i = 0; i < size; i++) {
+        re += (q63_t)src1[2 * i] * src2[2 * i] - (q63_t)src1[2 * i + 1] * src2[2 * i + 1];
+        im += (q63_t)src1[2 * i] * src2[2 * i + 1] + (q63_t)src1[2 * i + 1] * src2[2 * i];
+    }
+    dst[0] = ref_sat_q15(re >> 17);
+    dst[1] = ref_sat_q15(im >> 17);
+}
+
+/* Q29 result */
+void riscv_dsp_cdprod_q31(const q31_t *src1, const q31_t *src2, uint32_t size, q31_t *dst)
+{
+    q63_t re = 0;
+    q63_t im = 0;
+
+    for (uint32_t i = 0; i < size; i++) {
+        re += (((q63_t)src1[2 * i] * src2[2 * i]) >> 14) - (((q63_t)src1[2 * i + 1] * src2[2 * i + 1]) >> 14);
+        im += (((q63_t)src1[2 * i] * src2[2 * i + 1]) >> 14) + (((q63_t)src1[2 * i + 1] * src2[2 * i]) >> 14);
+    }
+    dst[0] = ref_sat_q31(re >> 19);
+    dst[1] = ref_sat_q31(im >> 19);
+}
+
+void riscv_dsp_cdprod_typ2_f32(const float32_t *src1, const float32_t *src2, uint32_t size, float32_t *rout, float32_t *iout)
+{
+    float32_t re = 0.0f;
+    float32_t im = 0.0f;
+
+    for (uint32_t i = 0; i < size; i++) {
+        re += src1[2 * i] * src2[2 * i] - src1[2 * i + 1] * src2[2 * i + 1];
+        im += src1[2 * i] * src2[2 * i + 1] + src1[2 * i + 1] * src2[2 * i];
+    }
+    *rout = re;
+    *iout = im;
+}
+
+/* Q24 result */
+void riscv_dsp_cdprod_typ2_q15(const q15_t *src1, const q15_t *src2, uint32_t size, q31_t *rout, q31_t *iout)
+{
+    q63_t re = 0;
+    q63_t im = 0;
+
+    for (uint32_t i = 0; i < size; i++) {
+        re += (q63_t)src1[2 * i] * src2[2 * i] - (q63_t)src1[2 * i + 1] * src2[2 * i + 1];
+        im += (q63_t)src1[2 * i] * src2[2 * i + 1] + (q63_t)src1[2 * i + 1] * src2[2 * i];
+    }
+    *rout = ref_sat_q31(re >> 6);
+    *iout = ref_sat_q31(im >> 6);
+}
+
+/* Q48 result */
+void riscv_dsp_cdprod_typ2_q31(const q31_t *src1, const q31_t *src2, uint32_t size, q63_t *rout, q63_t *iout)
+{
+    q63_t re = 0;
+    q63_t im = 0;
+
+    for (uint32_t i = 0; i < size; i++) {
+        re += (((q63_t)src1[2 * i] * src2[2 * i]) >> 14) - (((q63_t)src1[2 * i + 1] * src2[2 * i + 1]) >> 14);
+        im += (((q63_t)src1[2 * i] * src2[2 * i + 1]) >> 14) + (((q63_t)src1[2 * i + 1] * src2[2 * i]) >> 14);
+    }
+    *rout = re;
+    *iout = im;
+}
+
+/*
+ * Complex magnitude and magnitude squared
+ */
+void riscv_dsp_cmag_f32(const float32_t *src, float32_t *dst, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        dst[i] = sqrtf(src[2 * i] * src[2 * i] + src[2 * i + 1] * src[2 * i + 1]);
+    }
+}
+
+/* Q13 result */
+void riscv_dsp_cmag_q15(const q15_t *src, q15_t *dst, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        uint64_t sqr = (uint64_t)((q31_t)src[2 * i] * src[2 * i]) + (uint64_t)((q31_t)src[2 * i + 1] * src[2 * i + 1]);
+        /* sqrt(Q30) is Q15 */
+        dst[i] = ref_sat_q15((q63_t)(ref_isqrt_u64(sqr) >> 2));
+    }
+}
+
+/* Q29 result */
+void riscv_dsp_cmag_q31(const q31_t *src, q31_t *dst, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        uint64_t sqr = (uint64_t)((q63_t)src[2 * i] * src[2 * i]) +
+                       (uint64_t)((q63_t)src[2 * i + 1] * src[2 * i + 1]);
+        /* sqrt(Q62) is Q31 */
+        dst[i] = ref_sat_q31((q63_t)(ref_isqrt_u64(sqr) >> 2));
+    }
+}
+
+void riscv_dsp_cmag_sqr_f32(const float32_t *src, float32_t *dst, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        dst[i] = src[2 * i] * src[2 * i] + src[2 * i + 1] * src[2 * i + 1];
+    }
+}
+
+/* Q13 result */
+void riscv_dsp_cmag_sqr_q15(const q15_t *src, q15_t *dst, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        q63_t sqr = (q31_t)src[2 * i] * src[2 * i] + (q63_t)((q31_t)src[2 * i + 1] * src[2 * i + 1]);
+        dst[i] = ref_sat_q15(sqr >> 17);
+    }
+}
+
+/* Q29 result */
+void riscv_dsp_cmag_sqr_q31(const q31_t *src, q31_t *dst, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        dst[i] = ref_sat_q31((((q63_t)src[2 * i] * src[2 * i]) >> 33) +
+                             (((q63_t)src[2 * i + 1] * src[2 * i + 1]) >> 33));
+    }
+}
+
+/*
+ * Complex-by-complex and complex-by-real multiplication
+ */
+void riscv_dsp_cmul_f32(const float32_t *src1, const float32_t *src2, float32_t *dst, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        float32_t a = src1[2 * i];
+        float32_t b = src1[2 * i + 1];
+        float32_t c = src2[2 * i];
+        float32_t d = src2[2 * i + 1];
+
+        dst[2 * i] = a * c - b * d;
+        dst[2 * i + 1] = a * d + b * c;
+    }
+}
+
+/* Q13 result */
+void riscv_dsp_cmul_q15(const q15_t *src1, const q15_t *src2, q15_t *dst, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        q31_t a = src1[2 * i];
+        q31_t b = src1[2 * i + 1];
+        q31_t c = src2[2 * i];
+        q31_t d = src2[2 * i + 1];
+
+        dst[2 * i] = ref_sat_q15(((q63_t)a * c - (q63_t)b * d) >> 17);
+        dst[2 * i + 1] = ref_sat_q15(((q63_t)a * d + (q63_t)b * c) >> 17);
+    }
+}
+
+/* Q29 result */
+void riscv_dsp_cmul_q31(const q31_t *src1, const q31_t *src2, q31_t *dst, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        q63_t a = src1[2 * i];
+        q63_t b = src1[2 * i + 1];
+        q63_t c = src2[2 * i];
+        q63_t d = src2[2 * i + 1];
+
+        dst[2 * i] = ref_sat_q31(((a * c) >> 33) - ((b * d) >> 33));
+        dst[2 * i + 1] = ref_sat_q31(((a * d) >> 33) + ((b * c) >> 33));
+    }
+}
+
+void riscv_dsp_cmul_real_f32(const float32_t *src, const float32_t *real, float32_t *dst, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        dst[2 * i] = src[2 * i] * real[i];
+        dst[2 * i + 1] = src[2 * i + 1] * real[i];
+    }
+}
+
+void riscv_dsp_cmul_real_q15(const q15_t *src, const q15_t *real, q15_t *dst, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        dst[2 * i] = ref_sat_q15(((q31_t)src[2 * i] * real[i]) >> 15);
+        dst[2 * i + 1] = ref_sat_q15(((q31_t)src[2 * i + 1] * real[i]) >> 15);
+    }
+}
+
+void riscv_dsp_cmul_real_q31(const q31_t *src, const q31_t *real, q31_t *dst, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        dst[2 * i] = ref_sat_q31(((q63_t)src[2 * i] * real[i]) >> 31);
+        dst[2 * i + 1] = ref_sat_q31(((q63_t)src[2 * i + 1] * real[i]) >> 31);
+    }
+}
+
+#endif
@@ -0,0 +1,794 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include "hpm_math_ref_common.h"
+
+#if defined(HPM_MATH_DSP_FILTERING) && defined(HPM_EN_MATH_DSP_LIB)
+
+/*
+ * Multiply helpers returning the product in the format of the operands
+ */
+#define REF_MUL_F(a, b)      ((a) * (b))
+#define REF_MUL_Q31(a, b)    ((q63_t)(a) * (b))
+#define REF_MUL_Q31_HI(a, b) (((q63_t)(a) * (b)) >> 32)
+#define REF_MUL_Q15(a, b)    ((q63_t)(a) * (b))
+#define REF_MUL_Q7(a, b)     ((q31_t)(a) * (b))
+
+#define REF_OUT_F(acc)          (acc)
+#define REF_OUT_Q31(acc)        ref_sat_q31((acc) >> 31)
+#define REF_OUT_Q31_HI(acc)     ref_sat_q31((acc) * 2)
+#define REF_OUT_Q15(acc)        ref_sat_q15((acc) >> 15)
+#define REF_OUT_Q7(acc)         ref_sat_q7((acc) >> 7)
+
+/*
+ * FIR
+ *
+ * The state holds coeff_size - 1 previous samples followed by the new block, the
+ * coefficients are stored in time reversed order.
+ */
+#define REF_FIR(inst, src, dst, size, acc_t, mul, out)                          \
+    do {                                                                        \
+        uint32_t taps = (inst)->coeff_size;                                     \
+        for (uint32_t n = 0; n < (size); n++) {                                 \
+            acc_t acc = 0;                                                      \
+            (inst)->state[taps - 1U + n] = (src)[n];                            \
+            for (uint32_t k = 0; k < taps; k++) {                               \
+                acc += mul((inst)->state[n + k], (inst)->coeff[k]);             \
+            }                                                                   \
+            (dst)[n] = out(acc);                                                \
+        }                                                                       \
+        memmove((inst)->state, (inst)->state + (size),                          \
+                (taps - 1U) * sizeof((inst)->state[0]));                        \
+    } while (0)
+
+void riscv_dsp_fir_f32(const riscv_dsp_fir_f32_t *instance, float32_t *src, float32_t *dst, uint32_t size)
+{
+    REF_FIR(instance, src, dst, size, float32_t, REF_MUL_F, REF_OUT_F);
+}
+
+void riscv_dsp_fir_q31(const riscv_dsp_fir_q31_t *instance, q31_t *src, q31_t *dst, uint32_t size)
+{
+    REF_FIR(instance, src, dst, size, q63_t, REF_MUL_Q31, REF_OUT_Q31);
+}
+
+void riscv_dsp_fir_fast_q31(const riscv_dsp_fir_q31_t *instance, q31_t *src, q31_t *dst, uint32_t size)
+{
+    REF_FIR(instance, src, dst, size, q63_t, REF_MUL_Q31_HI, REF_OUT_Q31_HI);
+}
+
+void riscv_dsp_fir_q15(const riscv_dsp_fir_q15_t *instance, q15_t *src, q15_t *dst, uint32_t size)
+{
+    REF_FIR(instance, src, dst, size, q63_t, REF_MUL_Q15, REF_OUT_Q15);
+}
+
+void riscv_dsp_fir_fast_q15(const riscv_dsp_fir_q15_t *instance, q15_t *src, q15_t *dst, uint32_t size)
+{
+    REF_FIR(instance, src, dst, size, q31_t, REF_MUL_Q7, REF_OUT_Q15);
+}
+
+void riscv_dsp_fir_q7(const riscv_dsp_fir_q7_t *instance, q7_t *src, q7_t *dst, uint32_t size)
+{
+    REF_FIR(instance, src, dst, size, q31_t, REF_MUL_Q7, REF_OUT_Q7);
+}
+
+/*
+ * Decimation FIR, one output for every M inputs
+ */
+#define REF_DCMFIR(inst, src, dst, size, acc_t, mul, out)                       \
+    do {                                                                        \
+        uint32_t taps = (inst)->coeff_size;                                     \
+        uint32_t m = (inst)->M;                                                 \
+        uint32_t outsize = (size) / m;                                          \
+        memcpy((inst)->state + taps - 1U, (src), (size) * sizeof((src)[0]));    \
+        for (uint32_t n = 0; n < outsize; n++) {                                \
+            acc_t acc = 0;                                                      \
+            for (uint32_t k = 0; k < taps; k++) {                               \
+                acc += mul((inst)->state[n * m + k], (inst)->coeff[k]);         \
+            }                                                                   \
+            (dst)[n] = out(acc);                                                \
+        }                                                                       \
+        memmove((inst)->state, (inst)->state + outsize * m,                     \
+                (taps - 1U) * sizeof((inst)->state[0]));                        \
+    } while (0)
+
+void riscv_dsp_dcmfir_f32(const riscv_dsp_dcmfir_f32_t *instance, float32_t *src, float32_t *dst, uint32_t size)
+{
+    REF_DCMFIR(instance, src, dst, size, float32_t, REF_MUL_F, REF_OUT_F);
+}
+
+void riscv_dsp_dcmfir_q31(const riscv_dsp_dcmfir_q31_t *instance, q31_t *src, q31_t *dst, uint32_t size)
+{
+    REF_DCMFIR(instance, src, dst, size, q63_t, REF_MUL_Q31, REF_OUT_Q31);
+}
+
+void riscv_dsp_dcmfir_fast_q31(const riscv_dsp_dcmfir_q31_t *instance, q31_t *src, q31_t *dst, uint32_t size)
+{
+    REF_DCMFIR(instance, src, dst, size, q63_t, REF_MUL_Q31_HI, REF_OUT_Q31_HI);
+}
+
+void riscv_dsp_dcmfir_q15(const riscv_dsp_dcmfir_q15_t *instance, q15_t *src, q15_t *dst, uint32_t size)
+{
+    REF_DCMFIR(instance, src, dst, size, q63_t, REF_MUL_Q15, REF_OUT_Q15);
+}
+
+void riscv_dsp_dcmfir_fast_q15(const riscv_dsp_dcmfir_q15_t *instance, q15_t *src, q15_t *dst, uint32_t size)
+{
+    REF_DCMFIR(instance, src, dst, size, q31_t, REF_MUL_Q7, REF_OUT_Q15);
+}
+
+/*
+ * Upsampling FIR, L outputs for every input, each one using a polyphase of plen taps
+ */
+#define REF_UPSPLFIR(inst, src, dst, size, acc_t, mul, out)                     \
+    do {                                                                        \
+        uint32_t l = (inst)->L;                                                 \
+        uint32_t plen = (inst)->plen;                                           \
+        for (uint32_t n = 0; n < (size); n++) {                                 \
+            (inst)->state[plen - 1U + n] = (src)[n];                            \
+            for (uint32_t j = 0; j < l; j++) {                                  \
+                acc_t acc = 0;                                                  \
+                for (uint32_t k = 0; k < plen; k++) {                           \
+                    acc += mul((inst)->state[n + k],                            \
+                               (inst)->coeff[(l - 1U - j) + k * l]);            \
+                }                                                               \
+                (dst)[n * l + j] = out(acc);                                    \
+            }                                                                   \
+        }                                                                       \
+        memmove((inst)->state, (inst)->state + (size),                          \
+                (plen - 1U) * sizeof((inst)->state[0]));                        \
+    } while (0)
+
+void riscv_dsp_upsplfir_f32(const riscv_dsp_upsplfir_f32_t *instance, float32_t *src, float32_t *dst, uint32_t size)
+{
+    REF_UPSPLFIR(instance, src, dst, size, float32_t, REF_MUL_F, REF_OUT_F);
+}
+
+void riscv_dsp_upsplfir_q31(const riscv_dsp_upsplfir_q31_t *instance, q31_t *src, q31_t *dst, uint32_t size)
+{
+    REF_UPSPLFIR(instance, src, dst, size, q63_t, REF_MUL_Q31, REF_OUT_Q31);
+}
+
+void riscv_dsp_upsplfir_q15(const riscv_dsp_upsplfir_q15_t *instance, q15_t *src, q15_t *dst, uint32_t size)
+{
+    REF_UPSPLFIR(instance, src, dst, size, q63_t, REF_MUL_Q15, REF_OUT_Q15);
+}
+
+/*
+ * Sparse FIR
+ *
+ * The state is a circular buffer of delay + size samples, the scratch buffers of the
+ * NDS32 implementation are not needed here.
+ */
+#define REF_SPAFIR(inst, src, dst, size, acc_t, mul, out)                       \
+    do {                                                                        \
+        int32_t len = (int32_t)(inst)->delay + (int32_t)(size);                 \
+        int32_t idx = (inst)->index;                                            \
+        for (uint32_t n = 0; n < (size); n++) {                                 \
+            (inst)->state[idx] = (src)[n];                                      \
+            idx = (idx + 1 == len) ? 0 : idx + 1;                               \
+        }                                                                       \
+        for (uint32_t n = 0; n < (size); n++) {                                 \
+            acc_t acc = 0;                                                      \
+            for (uint32_t k = 0; k < (inst)->coeff_size; k++) {                 \
+                int32_t pos = idx - (int32_t)(size) + (int32_t)n - (inst)->nezdelay[k]; \
+                pos = (pos < 0) ? pos + len : pos;                              \
+                acc += mul((inst)->state[pos], (inst)->coeff[k]);               \
+            }                                                                   \
+            (dst)[n] = out(acc);                                                \
+        }                                                                       \
+        (inst)->index = (uint16_t)idx;                                          \
+    } while (0)
+
+void riscv_dsp_spafir_f32(riscv_dsp_spafir_f32_t *instance, float32_t *src, float32_t *dst, float32_t *buf, uint32_t size)
+{
+    (void)buf;
+    REF_SPAFIR(instance, src, dst, size, float32_t, REF_MUL_F, REF_OUT_F);
+}
+
+void riscv_dsp_spafir_q31(riscv_dsp_spafir_q31_t *instance, q31_t *src, q31_t *dst, q31_t *buf, uint32_t size)
+{
+    (void)buf;
+    REF_SPAFIR(instance, src, dst, size, q63_t, REF_MUL_Q31, REF_OUT_Q31);
+}
+
+void riscv_dsp_spafir_q15(riscv_dsp_spafir_q15_t *instance, q15_t *src, q15_t *dst, q15_t *buf1, q31_t *buf2, uint32_t size)
+{
+    (void)buf1;
+    (void)buf2;
+    REF_SPAFIR(instance, src, dst, size, q63_t, REF_MUL_Q15, REF_OUT_Q15);
+}
+
+void riscv_dsp_spafir_q7(riscv_dsp_spafir_q7_t *instance, q7_t *src, q7_t *dst, q7_t *buf1, q31_t *buf2, uint32_t size)
+{
+    (void)buf1;
+    (void)buf2;
+    REF_SPAFIR(instance, src, dst, size, q31_t, REF_MUL_Q7, REF_OUT_Q7);
+}
+
+/*
+ * Lattice FIR
+ */
+void riscv_dsp_lfir_f32(const riscv_dsp_lfir_f32_t *instance, float32_t *src, float32_t *dst, uint32_t size)
+{
+    for (uint32_t n = 0; n < size; n++) {
+        float32_t f = src[n];
+        float32_t g = src[n];
+
+        for (uint32_t z = 0; z < instance->stage; z++) {
+            float32_t k = instance->coeff[z];
+            float32_t gold = instance->state[z];
+            float32_t fnext = f + k * gold;
+
+            instance->state[z] = g;
+            g = k * f + gold;
+            f = fnext;
+        }
+        dst[n] = f;
+    }
+}
+
+void riscv_dsp_lfir_q31(const riscv_dsp_lfir_q31_t *instance, q31_t *src, q31_t *dst, uint32_t size)
+{
+    for (uint32_t n = 0; n < size; n++) {
+        q31_t f = src[n];
+        q31_t g = src[n];
+
+        for (uint32_t z = 0; z < instance->stage; z++) {
+            q31_t k = instance->coeff[z];
+            q31_t gold = instance->state[z];
+            q31_t fnext = ref_sat_q31((q63_t)f + (((q63_t)k * gold) >> 31));
+
+            instance->state[z] = g;
+            g = ref_sat_q31((((q63_t)k * f) >> 31) + gold);
+            f = fnext;
+        }
+        dst[n] = f;
+    }
+}
+
+void riscv_dsp_lfir_q15(const riscv_dsp_lfir_q15_t *instance, q15_t *src, q15_t *dst, uint32_t size)
+{
+    for (uint32_t n = 0; n < size; n++) {
+        q15_t f = src[n];
+        q15_t g = src[n];
+
+        for (uint32_t z = 0; z < instance->stage; z++) {
+            q15_t k = instance->coeff[z];
+            q15_t gold = instance->state[z];
+            q15_t fnext = ref_sat_q15(f + (((q31_t)k * gold) >> 15));
+
+            instance->state[z] = g;
+            g = ref_sat_q15((((q31_t)k * f) >> 15) + gold);
+            f = fnext;
+        }
+        dst[n] = f;
+    }
+}
+
+/*
+ * Lattice IIR
+ *
+ * The state window of nstage + 1 values slides by one sample per output.
+ */
+void riscv_dsp_liir_f32(const riscv_dsp_liir_f32_t *instance, float32_t *src, float32_t *dst, uint32_t size)
+{
+    uint32_t nstage = instance->nstage;
+
+    for (uint32_t n = 0; n < size; n++) {
+        float32_t *state = instance->state + n;
+        float32_t f = src[n];
+        float32_t acc = 0.0f;
+
+        for (uint32_t j = 0; j < nstage; j++) {
+            float32_t k = instance->rcoeff[j];
+            float32_t fnext = f - k * state[j];
+            float32_t gnext = fnext * k + state[j];
+
+            acc += gnext * instance->lcoeff[j];
+            state[j] = gnext;
+            f = fnext;
+        }
+        acc += f * instance->lcoeff[nstage];
+        state[nstage] = f;
+        dst[n] = acc;
+    }
+    memmove(instance->state, instance->state + size, nstage * sizeof(float32_t));
+}
+
+void riscv_dsp_liir_q31(const riscv_dsp_liir_q31_t *instance, q31_t *src, q31_t *dst, uint32_t size)
+{
+    uint32_t nstage = instance->nstage;
+
+    for (uint32_t n = 0; n < size; n++) {
+        q31_t *state = instance->state + n;
+        q31_t f = src[n];
+        q63_t acc = 0;
+
+        for (uint32_t j = 0; j < nstage; j++) {
+            q31_t k = instance->rcoeff[j];
+            q31_t fnext = ref_sat_q31((q63_t)f - (((q63_t)k * state[j]) >> 31));
+            q31_t gnext = ref_sat_q31((((q63_t)fnext * k) >> 31) + state[j]);
+
+            acc += (q63_t)gnext * instance->lcoeff[j];
+            state[j] = gnext;
+            f = fnext;
+        }
+        acc += (q63_t)f * instance->lcoeff[nstage];
+        state[nstage] = f;
+        dst[n] = ref_sat_q31(acc >> 31);
+    }
+    memmove(instance->state, instance->state + size, nstage * sizeof(q31_t));
+}
+
+void riscv_dsp_liir_fast_q31(const riscv_dsp_liir_q31_t *instance, q31_t *src, q31_t *dst, uint32_t size)
+{
+    riscv_dsp_liir_q31(instance, src, dst, size);
+}
+
+void riscv_dsp_liir_q15(const riscv_dsp_liir_q15_t *instance, q15_t *src, q15_t *dst, uint32_t size)
+{
+    uint32_t nstage = instance->nstage;
+
+    for (uint32_t n = 0; n < size; n++) {
+        q15_t *state = instance->state + n;
+        q15_t f = src[n];
+        q63_t acc = 0;
+
+        for (uint32_t j = 0; j < nstage; j++) {
+            q15_t k = instance->rcoeff[j];
+            q15_t fnext = ref_sat_q15(f - (((q31_t)k * state[j]) >> 15));
+            q15_t gnext = ref_sat_q15((((q31_t)fnext * k) >> 15) + state[j]);
+
+            acc += (q31_t)gnext * instance->lcoeff[j];
+            state[j] = gnext;
+            f = fnext;
+        }
+        acc += (q31_t)f * instance->lcoeff[nstage];
+        state[nstage] = f;
+        dst[n] = ref_sat_q15(acc >> 15);
+    }
+    memmove(instance->state, instance->state + size, nstage * sizeof(q15_t));
+}
+
+void riscv_dsp_liir_fast_q15(const riscv_dsp_liir_q15_t *instance, q15_t *src, q15_t *dst, uint32_t size)
+{
+    riscv_dsp_liir_q15(instance, src, dst, size);
+}
+
+/*
+ * LMS and normalized LMS
+ */
+void riscv_dsp_lms_f32(const riscv_dsp_lms_f32_t *instance, float32_t *src, float32_t *ref, float32_t *dst,
+                       float32_t *err, uint32_t size)
+{
+    uint32_t taps = instance->coeff_size;
+
+    for (uint32_t n = 0; n < size; n++) {
+        float32_t *x = instance->state + n;
+        float32_t acc = 0.0f;
+        float32_t w;
+
+        x[taps - 1U] = src[n];
+        for (uint32_t k = 0; k < taps; k++) {
+            acc += x[k] * instance->coeff[k];
+        }
+        dst[n] = acc;
+        err[n] = ref[n] - acc;
+        w = err[n] * instance->mu;
+        for (uint32_t k = 0; k < taps; k++) {
+            instance->coeff[k] += w * x[k];
+        }
+    }
+    memmove(instance->state, instance->state + size, (taps - 1U) * sizeof(float32_t));
+}
+
+void riscv_dsp_lms_q31(const riscv_dsp_lms_q31_t *instance, q31_t *src, q31_t *ref, q31_t *dst,
+                       q31_t *err, uint32_t size)
+{
+    uint32_t taps = instance->coeff_size;
+
+    for (uint32_t n = 0; n < size; n++) {
+        q31_t *x = instance->state + n;
+        q63_t acc = 0;
+        q31_t w;
+
+        x[taps - 1U] = src[n];
+        for (uint32_t k = 0; k < taps; k++) {
+            acc += (q63_t)x[k] * instance->coeff[k];
+        }
+        dst[n] = ref_sat_q31(acc >> (31 - instance->shift));
+        err[n] = ref_sat_q31((q63_t)ref[n] - dst[n]);
+        w = (q31_t)(((q63_t)err[n] * instance->mu) >> 31);
+        for (uint32_t k = 0; k < taps; k++) {
+            instance->coeff[k] = ref_sat_q31((q63_t)instance->coeff[k] + (((q63_t)w * x[k]) >> 31));
+        }
+    }
+    memmove(instance->state, instance->state + size, (taps - 1U) * sizeof(q31_t));
+}
+
+void riscv_dsp_lms_q15(const riscv_dsp_lms_q15_t *instance, q15_t *src, q15_t *ref, q15_t *dst,
+                       q15_t *err, uint32_t size)
+{
+    uint32_t taps = instance->coeff_size;
+
+    for (uint32_t n = 0; n < size; n++) {
+        q15_t *x = instance->state + n;
+        q63_t acc = 0;
+        q15_t w;
+
+        x[taps - 1U] = src[n];
+        for (uint32_t k = 0; k < taps; k++) {
+            acc += (q31_t)x[k] * instance->coeff[k];
+        }
+        dst[n] = ref_sat_q15(acc >> (15 - instance->shift));
+        err[n] = ref_sat_q15((q31_t)ref[n] - dst[n]);
+        w = ref_sat_q15(((q31_t)err[n] * instance->mu) >> 15);
+        for (uint32_t k = 0; k < taps; k++) {
+            instance->coeff[k] = ref_sat_q15(instance->coeff[k] + (((q31_t)w * x[k]) >> 15));
+        }
+    }
+    memmove(instance->state, instance->state + size, (taps - 1U) * sizeof(q15_t));
+}
+
+/* the energy of the current window is recomputed per sample, which is exact for any block size */
+void riscv_dsp_nlms_f32(riscv_dsp_nlms_f32_t *instance, float32_t *src, float32_t *ref, float32_t *dst,
+                        float32_t *err, uint32_t size)
+{
+    uint32_t taps = instance->coeff_size;
+
+    for (uint32_t n = 0; n < size; n++) {
+        float32_t *x = instance->state + n;
+        float32_t acc = 0.0f;
+        float32_t energy = 0.0f;
+        float32_t w;
+
+        x[taps - 1U] = src[n];
+        for (uint32_t k = 0; k < taps; k++) {
+            acc += x[k] * instance->coeff[k];
+            energy += x[k] * x[k];
+        }
+        dst[n] = acc;
+        err[n] = ref[n] - acc;
+        w = err[n] * instance->mu / (energy + 1e-6f);
+        for (uint32_t k = 0; k < taps; k++) {
+            instance->coeff[k] += w * x[k];
+        }
+        instance->energy = energy;
+    }
+    memmove(instance->state, instance->state + size, (taps - 1U) * sizeof(float32_t));
+}
+
+void riscv_dsp_nlms_q31(riscv_dsp_nlms_q31_t *instance, q31_t *src, q31_t *ref, q31_t *dst,
+                        q31_t *err, uint32_t size)
+{
+    uint32_t taps = instance->coeff_size;
+
+    for (uint32_t n = 0; n < size; n++) {
+        q31_t *x = instance->state + n;
+        q63_t acc = 0;
+        q63_t energy = 0;
+        q31_t w;
+
+        x[taps - 1U] = src[n];
+        for (uint32_t k = 0; k < taps; k++) {
+            acc += (q63_t)x[k] * instance->coeff[k];
+            energy += ((q63_t)x[k] * x[k]) >> 31;
+        }
+        dst[n] = ref_sat_q31(acc >> (31 - instance->postshift));
+        err[n] = ref_sat_q31((q63_t)ref[n] - dst[n]);
+        /* mu * e / (energy + delta), all in Q31 */
+        w = ref_sat_q31(((((q63_t)err[n] * instance->mu) >> 31) << 31) / (energy + 1));
+        for (uint32_t k = 0; k < taps; k++) {
+            instance->coeff[k] = ref_sat_q31((q63_t)instance->coeff[k] + (((q63_t)w * x[k]) >> 31));
+        }
+        instance->energy = ref_sat_q31(energy);
+        instance->x0 = src[n];
+    }
+    memmove(instance->state, instance->state + size, (taps - 1U) * sizeof(q31_t));
+}
+
+void riscv_dsp_nlms_q15(riscv_dsp_nlms_q15_t *instance, q15_t *src, q15_t *ref, q15_t *dst,
+                        q15_t *err, uint32_t size)
+{
+    uint32_t taps = instance->coeff_size;
+
+    for (uint32_t n = 0; n < size; n++) {
+        q15_t *x = instance->state + n;
+        q63_t acc = 0;
+        q63_t energy = 0;
+        q15_t w;
+
+        x[taps - 1U] = src[n];
+        for (uint32_t k = 0; k < taps; k++) {
+            acc += (q31_t)x[k] * instance->coeff[k];
+            energy += ((q31_t)x[k] * x[k]) >> 15;
+        }
+        dst[n] = ref_sat_q15(acc >> (15 - instance->postshift));
+        err[n] = ref_sat_q15((q31_t)ref[n] - dst[n]);
+        /* mu * e / (energy + delta), all in Q15 */
+        w = ref_sat_q15(((((q31_t)err[n] * instance->mu) >> 15) * (q63_t)32768) / (energy + 1));
+        for (uint32_t k = 0; k < taps; k++) {
+            instance->coeff[k] = ref_sat_q15(instance->coeff[k] + (((q31_t)w * x[k]) >> 15));
+        }
+        instance->energy = ref_sat_q15(energy);
+        instance->x0 = src[n];
+    }
+    memmove(instance->state, instance->state + size, (taps - 1U) * sizeof(q15_t));
+}
+
+/*
+ * Convolution and correlation
+ */
+#define REF_CONV(src1, len1, src2, len2, dst, first, count, acc_t, mul, out)    \
+    do {                                                                        \
+        for (uint32_t n = (first); n < (first) + (count); n++) {                \
+            uint32_t kmin = (n >= (len2)) ? n - (len2) + 1U : 0U;               \
+            uint32_t kmax = (n < (len1)) ? n : (len1) - 1U;                     \
+            acc_t acc = 0;                                                      \
+            for (uint32_t k = kmin; k <= kmax; k++) {                           \
+                acc += mul((src1)[k], (src2)[n - k]);                           \
+            }                                                                   \
+            (dst)[n] = out(acc);                                                \
+        }                                                                       \
+    } while (0)
+
+void riscv_dsp_conv_f32(float32_t *src1, uint32_t len1, float32_t *src2, uint32_t len2, float32_t *dst)
+{
+    REF_CONV(src1, len1, src2, len2, dst, 0U, len1 + len2 - 1U, float32_t, REF_MUL_F, REF_OUT_F);
+}
+
+void riscv_dsp_conv_q31(q31_t *src1, uint32_t len1, q31_t *src2, uint32_t len2, q31_t *dst)
+{
+    REF_CONV(src1, len1, src2, len2, dst, 0U, len1 + len2 - 1U, q63_t, REF_MUL_Q31, REF_OUT_Q31);
+}
+
+void riscv_dsp_conv_q15(q15_t *src1, uint32_t len1, q15_t *src2, uint32_t len2, q15_t *dst)
+{
+    REF_CONV(src1, len1, src2, len2, dst, 0U, len1 + len2 - 1U, q63_t, REF_MUL_Q15, REF_OUT_Q15);
+}
+
+void riscv_dsp_conv_q7(q7_t *src1, uint32_t len1, q7_t *src2, uint32_t len2, q7_t *dst)
+{
+    REF_CONV(src1, len1, src2, len2, dst, 0U, len1 + len2 - 1U, q31_t, REF_MUL_Q7, REF_OUT_Q7);
+}
+
+#define REF_CONV_PARTIAL_CHECK(len1, len2, startindex, size)                   \
+    do {                                                                        \
+        if (((uint64_t)(startindex) + (size)) > ((uint64_t)(len1) + (len2) - 1U)) { \
+            return -1;                                                          \
+        }                                                                       \
+    } while (0)
+
+int32_t riscv_dsp_conv_partial_f32(float32_t *src1, uint32_t len1, float32_t *src2, uint32_t len2,
+                                   float32_t *dst, uint32_t startindex, uint32_t size)
+{
+    REF_CONV_PARTIAL_CHECK(len1, len2, startindex, size);
+    REF_CONV(src1, len1, src2, len2, dst, startindex, size, float32_t, REF_MUL_F, REF_OUT_F);
+    return 0;
+}
+
+int32_t riscv_dsp_conv_partial_q31(q31_t *src1, uint32_t len1, q31_t *src2, uint32_t len2,
+                                   q31_t *dst, uint32_t startindex, uint32_t size)
+{
+    REF_CONV_PARTIAL_CHECK(len1, len2, startindex, size);
+    REF_CONV(src1, len1, src2, len2, dst, startindex, size, q63_t, REF_MUL_Q31, REF_OUT_Q31);
+    return 0;
+}
+
+int32_t riscv_dsp_conv_partial_q15(q15_t *src1, uint32_t len1, q15_t *src2, uint32_t len2,
+                                   q15_t *dst, uint32_t startindex, uint32_t size)
+{
+    REF_CONV_PARTIAL_CHECK(len1, len2, startindex, size);
+    REF_CONV(src1, len1, src2, len2, dst, startindex, size, q63_t, REF_MUL_Q15, REF_OUT_Q15);
+    return 0;
+}
+
+int32_t riscv_dsp_conv_partial_q7(q7_t *src1, uint32_t len1, q7_t *src2, uint32_t len2,
+                                  q7_t *dst, uint32_t startindex, uint32_t size)
+{
+    REF_CONV_PARTIAL_CHECK(len1, len2, startindex, size);
+    REF_CONV(src1, len1, src2, len2, dst, startindex, size, q31_t, REF_MUL_Q7, REF_OUT_Q7);
+    return 0;
+}
+
+/* dst[m + max - 1] = sum(src1[n + m] * src2[n]) for -(max - 1) <= m <= max - 1 */
+#define REF_CORR(src1, len1, src2, len2, dst, acc_t, mul, out)                  \
+    do {                                                                        \
+        int32_t max = (int32_t)(((len1) > (len2)) ? (len1) : (len2));           \
+        for (int32_t m = 1 - max; m < max; m++) {                               \
+            acc_t acc = 0;                                                      \
+            for (int32_t n = 0; n < (int32_t)(len2); n++) {                     \
+                if ((n + m >= 0) && (n + m < (int32_t)(len1))) {                \
+                    acc += mul((src1)[n + m], (src2)[n]);                       \
+                }                                                               \
+            }                                                                   \
+            (dst)[m + max - 1] = out(acc);                                      \
+        }                                                                       \
+    } while (0)
+
+void riscv_dsp_corr_f32(float32_t *src1, uint32_t len1, float32_t *src2, uint32_t len2, float32_t *dst)
+{
+    REF_CORR(src1, len1, src2, len2, dst, float32_t, REF_MUL_F, REF_OUT_F);
+}
+
+void riscv_dsp_corr_q31(q31_t *src1, uint32_t len1, q31_t *src2, uint32_t len2, q31_t *dst)
+{
+    REF_CORR(src1, len1, src2, len2, dst, q63_t, REF_MUL_Q31, REF_OUT_Q31);
+}
+
+void riscv_dsp_corr_q15(q15_t *src1, uint32_t len1, q15_t *src2, uint32_t len2, q15_t *dst)
+{
+    REF_CORR(src1, len1, src2, len2, dst, q63_t, REF_MUL_Q15, REF_OUT_Q15);
+}
+
+void riscv_dsp_corr_q7(q7_t *src1, uint32_t len1, q7_t *src2, uint32_t len2, q7_t *dst)
+{
+    REF_CORR(src1, len1, src2, len2, dst, q31_t, REF_MUL_Q7, REF_OUT_Q7);
+}
+
+/*
+ * Biquad cascade, direct form I
+ *
+ * Coefficients per stage are {b0, b1, b2, a1, a2} with the feedback terms added, the
+ * state per stage is {x[n-1], x[n-2], y[n-1], y[n-2]}. Stage outputs feed the next stage
+ * through dst.
+ */
+void riscv_dsp_bq_df1_f32(const riscv_dsp_bq_df1_f32_t *instance, float32_t *src, float32_t *dst, uint32_t size)
+{
+    float32_t *in = src;
+
+    for (uint32_t s = 0; s < instance->nstage; s++) {
+        const float32_t *c = instance->coeff + 5U * s;
+        float32_t *st = instance->state + 4U * s;
+
+        for (uint32_t n = 0; n < size; n++) {
+            float32_t x = in[n];
+            float32_t y = c[0] * x + c[1] * st[0] + c[2] * st[1] + c[3] * st[2] + c[4] * st[3];
+
+            st[1] = st[0];
+            st[0] = x;
+            st[3] = st[2];
+            st[2] = y;
+            dst[n] = y;
+        }
+        in = dst;
+    }
+}
+
+#define REF_BQ_DF1_Q(inst, src, dst, size, type, frac, mul, acc_to_q63, sat)   \
+    do {                                                                        \
+        type *in = (src);                                                       \
+        for (uint32_t s = 0; s < (inst)->nstage; s++) {                         \
+            const type *c = (inst)->coeff + 5U * s;                             \
+            type *st = (inst)->state + 4U * s;                                  \
+            for (uint32_t n = 0; n < (size); n++) {                             \
+                type x = in[n];                                                 \
+                q63_t acc = mul(c[0], x) + mul(c[1], st[0]) + mul(c[2], st[1]) + \
+                            mul(c[3], st[2]) + mul(c[4], st[3]);                \
+                type y = sat(acc_to_q63(acc, (frac) - (inst)->shift));          \
+                st[1] = st[0];                                                  \
+                st[0] = x;                                                      \
+                st[3] = st[2];                                                  \
+                st[2] = y;                                                      \
+                (dst)[n] = y;                                                   \
+            }                                                                   \
+            in = (dst);                                                         \
+        }                                                                       \
+    } while (0)
+
+#define REF_ACC_SHR(acc, sh) ((acc) >> (sh))
+#define REF_ACC_HI_SHL(acc, sh) ref_shift_q63((acc), 32 - (sh))
+
+void riscv_dsp_bq_df1_q31(const riscv_dsp_bq_df1_q31_t *instance, q31_t *src, q31_t *dst, uint32_t size)
+{
+    REF_BQ_DF1_Q(instance, src, dst, size, q31_t, 31, REF_MUL_Q31, REF_ACC_SHR, ref_sat_q31);
+}
+
+void riscv_dsp_bq_df1_fast_q31(const riscv_dsp_bq_df1_q31_t *instance, q31_t *src, q31_t *dst, uint32_t size)
+{
+    REF_BQ_DF1_Q(instance, src, dst, size, q31_t, 31, REF_MUL_Q31_HI, REF_ACC_HI_SHL, ref_sat_q31);
+}
+
+void riscv_dsp_bq_df1_q15(const riscv_dsp_bq_df1_q15_t *instance, q15_t *src, q15_t *dst, uint32_t size)
+{
+    REF_BQ_DF1_Q(instance, src, dst, size, q15_t, 15, REF_MUL_Q15, REF_ACC_SHR, ref_sat_q15);
+}
+
+void riscv_dsp_bq_df1_fast_q15(const riscv_dsp_bq_df1_q15_t *instance, q15_t *src, q15_t *dst, uint32_t size)
+{
+    REF_BQ_DF1_Q(instance, src, dst, size, q15_t, 15, REF_MUL_Q15, REF_ACC_SHR, ref_sat_q15);
+}
+
+/* Q63 x Q31 product returned in Q62 */
+static inline q63_t ref_mul_q63_q31(q63_t a, q31_t b)
+{
+    return (q63_t)(((q63_t)(uint32_t)a * b) >> 32) + (a >> 32) * b;
+}
+
+/* feedback states y[n-1] and y[n-2] are kept in Q63 to preserve precision */
+void riscv_dsp_bq_df1_32x64_q31(const riscv_dsp_bq_df1_32x64_q31_t *instance, q31_t *src, q31_t *dst, uint32_t size)
+{
+    q31_t *in = src;
+
+    for (uint32_t s = 0; s < instance->nstage; s++) {
+        const q31_t *c = instance->coeff + 5U * s;
+        q63_t *st = instance->state + 4U * s;
+
+        for (uint32_t n = 0; n < size; n++) {
+            q31_t x = in[n];
+            q63_t acc = (q63_t)c[0] * x + (q63_t)c[1] * (q31_t)st[0] + (q63_t)c[2] * (q31_t)st[1] +
+                        ref_mul_q63_q31(st[2], c[3]) + ref_mul_q63_q31(st[3], c[4]);
+            q63_t y = ref_shift_q63(acc, instance->shift + 1);
+
+            st[1] = st[0];
+            st[0] = x;
+            st[3] = st[2];
+            st[2] = y;
+            dst[n] = (q31_t)(y >> 32);
+        }
+        in = dst;
+    }
+}
+
+/*
+ * Biquad cascade, direct form II transposed, state per stage is {d1, d2}
+ */
+#define REF_BQ_DF2T(inst, src, dst, size, type)                                 \
+    do {                                                                        \
+        type *in = (src);                                                       \
+        for (uint32_t s = 0; s < (inst)->nstage; s++) {                         \
+            const type *c = (inst)->coeff + 5U * s;                             \
+            type d1 = (inst)->state[2U * s];                                    \
+            type d2 = (inst)->state[2U * s + 1U];                               \
+            for (uint32_t n = 0; n < (size); n++) {                             \
+                type x = in[n];                                                 \
+                type y = c[0] * x + d1;                                         \
+                d1 = c[1] * x + c[3] * y + d2;                                  \
+                d2 = c[2] * x + c[4] * y;                                       \
+                (dst)[n] = y;                                                   \
+            }                                                                   \
+            (inst)->state[2U * s] = d1;                                         \
+            (inst)->state[2U * s + 1U] = d2;                                    \
+            in = (dst);                                                         \
+        }                                                                       \
+    } while (0)
+
+void riscv_dsp_bq_df2T_f32(const riscv_dsp_bq_df2T_f32_t *instance, float32_t *src, float32_t *dst, uint32_t size)
+{
+    REF_BQ_DF2T(instance, src, dst, size, float32_t);
+}
+
+void riscv_dsp_bq_df2T_f64(const riscv_dsp_bq_df2T_f64_t *instance, float64_t *src, float64_t *dst, uint32_t size)
+{
+    REF_BQ_DF2T(instance, src, dst, size, float64_t);
+}
+
+/* interleaved stereo samples share the coefficients, each channel owns two states per stage */
+void riscv_dsp_bq_stereo_df2T_f32(const riscv_dsp_bq_stereo_df2T_f32_t *instance, float32_t *src, float32_t *dst, uint32_t size)
+{
+    float32_t *in = src;
+
+    for (uint32_t s = 0; s < instance->nstage; s++) {
+        const float32_t *c = instance->coeff + 5U * s;
+        float32_t *st = instance->state + 4U * s;
+
+        for (uint32_t n = 0; n < size; n++) {
+            for (uint32_t ch = 0; ch < 2U; ch++) {
+                float32_t x = in[2U * n + ch];
+                float32_t y = c[0] * x + st[2U * ch];
+
+                st[2U * ch] = c[1] * x + c[3] * y + st[2U * ch + 1U];
+                st[2U * ch + 1U] = c[2] * x + c[4] * y;
+                dst[2U * n + ch] = y;
+            }
+        }
+        in = dst;
+    }
+}
+
+#endif
@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "hpm_math_ref_common.h"
+
+#if defined(HPM_MATH_DSP_MATRIX) && defined(HPM_EN_MATH_DSP_LIB)
+
+/*
+ * All matrices are stored in row-major order.
+ */
+
+/*
+ * Addition and subtraction
+ */
+#define REF_MAT_ELEMENTWISE(src1, src2, dst, row, col, expr)                    \
+    do {                                                                        \
+        uint32_t count = (row) * (col);                                         \
+        for (uint32_t i = 0; i < count; i++) {                                  \
+            (dst)[i] = expr;                                                    \
+        }                                                                       \
+    } while (0)
+
+void riscv_dsp_mat_add_f32(const float32_t *src1, const float32_t *src2, float32_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_ELEMENTWISE(src1, src2, dst, row, col, src1[i] + src2[i]);
+}
+
+void riscv_dsp_mat_add_f64(const float64_t *src1, const float64_t *src2, float64_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_ELEMENTWISE(src1, src2, dst, row, col, src1[i] + src2[i]);
+}
+
+void riscv_dsp_mat_add_q31(const q31_t *src1, const q31_t *src2, q31_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_ELEMENTWISE(src1, src2, dst, row, col, ref_sat_q31((q63_t)src1[i] + src2[i]));
+}
+
+void riscv_dsp_mat_add_q15(const q15_t *src1, const q15_t *src2, q15_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_ELEMENTWISE(src1, src2, dst, row, col, ref_sat_q15((q31_t)src1[i] + src2[i]));
+}
+
+void riscv_dsp_mat_sub_f32(const float32_t *src1, const float32_t *src2, float32_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_ELEMENTWISE(src1, src2, dst, row, col, src1[i] - src2[i]);
+}
+
+void riscv_dsp_mat_sub_f64(const float64_t *src1, const float64_t *src2, float64_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_ELEMENTWISE(src1, src2, dst, row, col, src1[i] - src2[i]);
+}
+
+void riscv_dsp_mat_sub_q31(const q31_t *src1, const q31_t *src2, q31_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_ELEMENTWISE(src1, src2, dst, row, col, ref_sat_q31((q63_t)src1[i] - src2[i]));
+}
+
+void riscv_dsp_mat_sub_q15(const q15_t *src1, const q15_t *src2, q15_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_ELEMENTWISE(src1, src2, dst, row, col, ref_sat_q15((q31_t)src1[i] - src2[i]));
+}
+
+/*
+ * Scale: dst = (src * scale_fract) >> (N - shift)
+ */
+void riscv_dsp_mat_scale_f32(const float32_t *src, float32_t scale, float32_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_ELEMENTWISE(src, src, dst, row, col, src[i] * scale);
+}
+
+void riscv_dsp_mat_scale_q31(const q31_t *src, q31_t scale_fract, int32_t shift, q31_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_ELEMENTWISE(src, src, dst, row, col, ref_sat_q31(ref_shift_q63((q63_t)src[i] * scale_fract, shift - 31)));
+}
+
+void riscv_dsp_mat_scale_q15(const q15_t *src, q15_t scale_fract, int32_t shift, q15_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_ELEMENTWISE(src, src, dst, row, col, ref_sat_q15(ref_shift_q63((q31_t)src[i] * scale_fract, shift - 15)));
+}
+
+/*
+ * Transpose
+ */
+#define REF_MAT_TRANS(src, dst, row, col)                                       \
+    do {                                                                        \
+        for (uint32_t r = 0; r < (row); r++) {                                  \
+            for (uint32_t c = 0; c < (col); c++) {                              \
+                (dst)[c * (row) + r] = (src)[r * (col) + c];                    \
+            }                                                                   \
+        }                                                                       \
+    } while (0)
+
+void riscv_dsp_mat_trans_f32(const float32_t *src, float32_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_TRANS(src, dst, row, col);
+}
+
+void riscv_dsp_mat_trans_f64(const float64_t *src, float64_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_TRANS(src, dst, row, col);
+}
+
+void riscv_dsp_mat_trans_q31(const q31_t *src, q31_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_TRANS(src, dst, row, col);
+}
+
+void riscv_dsp_mat_trans_q15(const q15_t *src, q15_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_TRANS(src, dst, row, col);
+}
+
+void riscv_dsp_mat_trans_q7(const q7_t *src, q7_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_TRANS(src, dst, row, col);
+}
+
+void riscv_dsp_mat_trans_u8(const uint8_t *src, uint8_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_TRANS(src, dst, row, col);
+}
+
+/*
+ * Multiplication: dst[row, col2] = src1[row, col] * src2[col, col2]
+ *
+ * The inner loop walks along a row of src2, so that it is contiguous and can be
+ * vectorized across the output columns.
+ */
+#define REF_MAT_MUL(src1, src2, dst, row, col, col2, acc_t, mul, out)           \
+    do {                                                                        \
+        for (uint32_t r = 0; r < (row); r++) {                                  \
+            for (uint32_t c = 0; c < (col2); c++) {                             \
+                acc_t acc = 0;                                                  \
+                for (uint32_t k = 0; k < (col); k++) {                          \
+                    acc += mul((src1)[r * (col) + k], (src2)[k * (col2) + c]);  \
+                }                                                               \
+                (dst)[r * (col2) + c] = out(acc);                               \
+            }                                                                   \
+        }                                                                       \
+    } while (0)
+
+#define REF_MUL_F(a, b)      ((a) * (b))
+#define REF_MUL_Q63(a, b)    ((q63_t)(a) * (b))
+#define REF_MUL_Q31_HI(a, b) (((q63_t)(a) * (b)) >> 32)
+#define REF_MUL_Q31(a, b)    ((q31_t)(a) * (b))
+
+#define REF_OUT_F(acc)      (acc)
+#define REF_OUT_Q31(acc)    ref_sat_q31((acc) >> 31)
+#define REF_OUT_Q31_HI(acc) ref_sat_q31((acc) * 2)
+#define REF_OUT_Q15(acc)    ref_sat_q15((acc) >> 15)
+#define REF_OUT_Q7(acc)     ref_sat_q7((acc) >> 7)
+
+void riscv_dsp_mat_mul_f32(const float32_t *src1, const float32_t *src2, float32_t *dst,
+                           uint32_t row, uint32_t col, uint32_t col2)
+{
+    REF_MAT_MUL(src1, src2, dst, row, col, col2, float32_t, REF_MUL_F, REF_OUT_F);
+}
+
+void riscv_dsp_mat_mul_f64(const float64_t *src1, const float64_t *src2, float64_t *dst,
+                           uint32_t row, uint32_t col, uint32_t col2)
+{
+    REF_MAT_MUL(src1, src2, dst, row, col, col2, float64_t, REF_MUL_F, REF_OUT_F);
+}
+
+void riscv_dsp_mat_mul_q31(const q31_t *src1, const q31_t *src2, q31_t *dst,
+                           uint32_t row, uint32_t col, uint32_t col2)
+{
+    REF_MAT_MUL(src1, src2, dst, row, col, col2, q63_t, REF_MUL_Q63, REF_OUT_Q31);
+}
+
+void riscv_dsp_mat_mul_fast_q31(const q31_t *src1, const q31_t *src2, q31_t *dst,
+                                uint32_t row, uint32_t col, uint32_t col2)
+{
+    REF_MAT_MUL(src1, src2, dst, row, col, col2, q63_t, REF_MUL_Q31_HI, REF_OUT_Q31_HI);
+}
+
+void riscv_dsp_mat_mul_q15(const q15_t *src1, const q15_t *src2, q15_t *dst,
+                           uint32_t row, uint32_t col, uint32_t col2)
+{
+    REF_MAT_MUL(src1, src2, dst, row, col, col2, q63_t, REF_MUL_Q63, REF_OUT_Q15);
+}
+
+void riscv_dsp_mat_mul_fast_q15(const q15_t *src1, const q15_t *src2, q15_t *dst,
+                                uint32_t row, uint32_t col, uint32_t col2)
+{
+    REF_MAT_MUL(src1, src2, dst, row, col, col2, q31_t, REF_MUL_Q31, REF_OUT_Q15);
+}
+
+void riscv_dsp_mat_mul_q7(const q7_t *src1, const q7_t *src2, q7_t *dst,
+                          uint32_t row, uint32_t col, uint32_t col2)
+{
+    REF_MAT_MUL(src1, src2, dst, row, col, col2, q31_t, REF_MUL_Q31, REF_OUT_Q7);
+}
+
+void riscv_dsp_mat_mul_vxm_q7(const q7_t *src1, const q7_t *src2, q7_t *dst, uint32_t col, uint32_t col2)
+{
+    REF_MAT_MUL(src1, src2, dst, 1U, col, col2, q31_t, REF_MUL_Q31, REF_OUT_Q7);
+}
+
+void riscv_dsp_mat_mul_mxv_f32(const float32_t *src1, const float32_t *src2, float32_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_MUL(src1, src2, dst, row, col, 1U, float32_t, REF_MUL_F, REF_OUT_F);
+}
+
+void riscv_dsp_mat_mul_mxv_q31(const q31_t *src1, const q31_t *src2, q31_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_MUL(src1, src2, dst, row, col, 1U, q63_t, REF_MUL_Q63, REF_OUT_Q31);
+}
+
+void riscv_dsp_mat_mul_mxv_q15(const q15_t *src1, const q15_t *src2, q15_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_MUL(src1, src2, dst, row, col, 1U, q63_t, REF_MUL_Q63, REF_OUT_Q15);
+}
+
+void riscv_dsp_mat_mul_mxv_q7(const q7_t *src1, const q7_t *src2, q7_t *dst, uint32_t row, uint32_t col)
+{
+    REF_MAT_MUL(src1, src2, dst, row, col, 1U, q31_t, REF_MUL_Q31, REF_OUT_Q7);
+}
+
+/* dst[size1, size2] = src1[size1, 1] * src2[1, size2] */
+void riscv_dsp_mat_oprod_q31(const q31_t *src1, const q31_t *src2, q31_t *dst, uint32_t size1, uint32_t size2)
+{
+    REF_MAT_MUL(src1, src2, dst, size1, 1U, size2, q63_t, REF_MUL_Q63, REF_OUT_Q31);
+}
+
+/* square of a size x size matrix, size must be a multiple of 4 */
+int32_t riscv_dsp_mat_pwr2_cache_f64(const float64_t *src, float64_t *dst, uint32_t size)
+{
+    if ((size % 4U) != 0U) {
+        return -1;
+    }
+    REF_MAT_MUL(src, src, dst, size, size, size, float64_t, REF_MUL_F, REF_OUT_F);
+    return 0;
+}
+
+/*
+ * Complex multiplication with interleaved [real, imag] elements
+ */
+#define REF_CMAT_MUL(src1, src2, dst, row, col, col2, acc_t, mul, out)          \
+    do {                                                                        \
+        for (uint32_t r = 0; r < (row); r++) {                                  \
+            for (uint32_t c = 0; c < (col2); c++) {                             \
+                acc_t re = 0;                                                   \
+                acc_t im = 0;                                                   \
+                for (uint32_t k = 0; k < (col); k++) {                          \
+                    uint32_t a = 2U * (r * (col) + k);                          \
+                    uint32_t b = 2U * (k * (col2) + c);                         \
+                    re += mul((src1)[a], (src2)[b]) - mul((src1)[a + 1U], (src2)[b + 1U]); \
+                    im += mul((src1)[a], (src2)[b + 1U]) + mul((src1)[a + 1U], (src2)[b]); \
+                }                                                               \
+                (dst)[2U * (r * (col2) + c)] = out(re);                         \
+                (dst)[2U * (r * (col2) + c) + 1U] = out(im);                    \
+            }                                                                   \
+        }                                                                       \
+    } while (0)
+
+void riscv_dsp_cmat_mul_f32(const float32_t *src1, const float32_t *src2, float32_t *dst,
+                            uint32_t row, uint32_t col, uint32_t col2)
+{
+    REF_CMAT_MUL(src1, src2, dst, row, col, col2, float32_t, REF_MUL_F, REF_OUT_F);
+}
+
+void riscv_dsp_cmat_mul_q31(const q31_t *src1, const q31_t *src2, q31_t *dst,
+                            uint32_t row, uint32_t col, uint32_t col2)
+{
+    REF_CMAT_MUL(src1, src2, dst, row, col, col2, q63_t, REF_MUL_Q31_HI, REF_OUT_Q31_HI);
+}
+
+void riscv_dsp_cmat_mul_q15(const q15_t *src1, const q15_t *src2, q15_t *dst,
+                            uint32_t row, uint32_t col, uint32_t col2)
+{
+    REF_CMAT_MUL(src1, src2, dst, row, col, col2, q63_t, REF_MUL_Q63, REF_OUT_Q15);
+}
+
+/*
+ * Inverse by Gauss-Jordan elimination with partial pivoting
+ *
+ * src is reduced to the identity matrix while dst accumulates the inverse.
+ */
+#define REF_MAT_INV(type, absfn, src, dst, size)                                \
+    do {                                                                        \
+        uint32_t n = (size);                                                    \
+        for (uint32_t i = 0; i < n * n; i++) {                                  \
+            (dst)[i] = ((i / n) == (i % n)) ? (type)1 : (type)0;                \
+        }                                                                       \
+        for (uint32_t c = 0; c < n; c++) {                                      \
+            uint32_t p = c;                                                     \
+            type pivot;                                                         \
+            for (uint32_t r = c + 1U; r < n; r++) {                             \
+                if (absfn((src)[r * n + c]) > absfn((src)[p * n + c])) {        \
+                    p = r;                                                      \
+                }                                                               \
+            }                                                                   \
+            if ((src)[p * n + c] == (type)0) {                                  \
+                return -1;                                                      \
+            }                                                                   \
+            if (p != c) {                                                       \
+                for (uint32_t k = 0; k < n; k++) {                              \
+                    type t = (src)[p * n + k];                                  \
+                    (src)[p * n + k] = (src)[c * n + k];                        \
+                    (src)[c * n + k] = t;                                       \
+                    t = (dst)[p * n + k];                                       \
+                    (dst)[p * n + k] = (dst)[c * n + k];                        \
+                    (dst)[c * n + k] = t;                                       \
+                }                                                               \
+            }                                                                   \
+            pivot = (src)[c * n + c];                                           \
+            for (uint32_t k = 0; k < n; k++) {                                  \
+                (src)[c * n + k] /= pivot;                                      \
+                (dst)[c * n + k] /= pivot;                                      \
+            }                                                                   \
+            for (uint32_t r = 0; r < n; r++) {                                  \
+                type f = (src)[r * n + c];                                      \
+                if ((r == c) || (f == (type)0)) {                               \
+                    continue;                                                   \
+                }                                                               \
+                for (uint32_t k = 0; k < n; k++) {                              \
+                    (src)[r * n + k] -= f * (src)[c * n + k];                   \
+                    (dst)[r * n + k] -= f * (dst)[c * n + k];                   \
+                }                                                               \
+            }                                                                   \
+        }                                                                       \
+        return 0;                                                               \
+    } while (0)
+
+int32_t riscv_dsp_mat_inv_f32(float32_t *src, float32_t *dst, uint32_t size)
+{
+    REF_MAT_INV(float32_t, fabsf, src, dst, size);
+}
+
+int32_t riscv_dsp_mat_inv_f64(float64_t *src, float64_t *dst, uint32_t size)
+{
+    REF_MAT_INV(float64_t, fabs, src, dst, size);
+}
+
+#endif
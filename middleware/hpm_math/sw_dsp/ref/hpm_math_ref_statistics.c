@@ -0,0 +1,434 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "hpm_math_ref_common.h"
+
+#if defined(HPM_MATH_DSP_STATISTICS) && defined(HPM_EN_MATH_DSP_LIB)
+
+/*
+ * Maximum / minimum
+ *
+ * The first occurrence wins when several elements share the extreme value.
+ */
+#define REF_EXTREME(type, src, size, index, cmp, absfn) \
+    do {                                                \
+        type best;                                      \
+        uint32_t best_idx = 0;                          \
+        if ((size) == 0U) {                             \
+            if ((index) != NULL) {                      \
+                *(index) = 0;                           \
+            }                                           \
+            return 0;                                   \
+        }                                               \
+        best = absfn((src)[0]);                         \
+        for (uint32_t i = 1; i < (size); i++) {         \
+            type v = absfn((src)[i]);                   \
+            if (v cmp best) {                           \
+                best = v;                               \
+                best_idx = i;                           \
+            }                                           \
+        }                                               \
+        if ((index) != NULL) {                          \
+            *(index) = best_idx;                        \
+        }                                               \
+        return best;                                    \
+    } while (0)
+
+#define REF_NOABS(x) (x)
+#define REF_ABS_F32(x) fabsf(x)
+#define REF_ABS_Q31(x) (((x) < 0) ? (((x) == REF_Q31_MIN) ? REF_Q31_MAX : (q31_t)-(x)) : (x))
+#define REF_ABS_Q15(x) ((q15_t)(((x) < 0) ? (((x) == REF_Q15_MIN) ? REF_Q15_MAX : -(x)) : (x)))
+#define REF_ABS_Q7(x)  ((q7_t)(((x) < 0) ? (((x) == REF_Q7_MIN) ? REF_Q7_MAX : -(x)) : (x)))
+
+float32_t riscv_dsp_max_f32(const float32_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(float32_t, src, size, index, >, REF_NOABS);
+}
+
+float32_t riscv_dsp_absmax_f32(const float32_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(float32_t, src, size, index, >, REF_ABS_F32);
+}
+
+float32_t riscv_dsp_max_val_f32(const float32_t *src, uint32_t size)
+{
+    float32_t res;
+
+    if (size == 0U) {
+        return 0.0f;
+    }
+    res = src[0];
+    for (uint32_t i = 1; i < size; i++) {
+        res = (src[i] > res) ? src[i] : res;
+    }
+    return res;
+}
+
+q15_t riscv_dsp_max_q15(const q15_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(q15_t, src, size, index, >, REF_NOABS);
+}
+
+q15_t riscv_dsp_absmax_q15(const q15_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(q15_t, src, size, index, >, REF_ABS_Q15);
+}
+
+q31_t riscv_dsp_max_q31(const q31_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(q31_t, src, size, index, >, REF_NOABS);
+}
+
+q31_t riscv_dsp_absmax_q31(const q31_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(q31_t, src, size, index, >, REF_ABS_Q31);
+}
+
+q7_t riscv_dsp_max_q7(const q7_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(q7_t, src, size, index, >, REF_NOABS);
+}
+
+q7_t riscv_dsp_absmax_q7(const q7_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(q7_t, src, size, index, >, REF_ABS_Q7);
+}
+
+uint8_t riscv_dsp_max_u8(const uint8_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(uint8_t, src, size, index, >, REF_NOABS);
+}
+
+float32_t riscv_dsp_min_f32(const float32_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(float32_t, src, size, index, <, REF_NOABS);
+}
+
+float32_t riscv_dsp_absmin_f32(const float32_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(float32_t, src, size, index, <, REF_ABS_F32);
+}
+
+q15_t riscv_dsp_min_q15(const q15_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(q15_t, src, size, index, <, REF_NOABS);
+}
+
+q15_t riscv_dsp_absmin_q15(const q15_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(q15_t, src, size, index, <, REF_ABS_Q15);
+}
+
+q31_t riscv_dsp_min_q31(const q31_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(q31_t, src, size, index, <, REF_NOABS);
+}
+
+q31_t riscv_dsp_absmin_q31(const q31_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(q31_t, src, size, index, <, REF_ABS_Q31);
+}
+
+q7_t riscv_dsp_min_q7(const q7_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(q7_t, src, size, index, <, REF_NOABS);
+}
+
+q7_t riscv_dsp_absmin_q7(const q7_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(q7_t, src, size, index, <, REF_ABS_Q7);
+}
+
+uint8_t riscv_dsp_min_u8(const uint8_t *src, uint32_t size, uint32_t *index)
+{
+    REF_EXTREME(uint8_t, src, size, index, <, REF_NOABS);
+}
+
+/*
+ * Mean
+ */
+float32_t riscv_dsp_mean_f32(const float32_t *src, uint32_t size)
+{
+    float32_t sum = 0.0f;
+
+    if (size == 0U) {
+        return 0.0f;
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        sum += src[i];
+    }
+    return sum / (float32_t)size;
+}
+
+#define REF_MEAN_INT(type, src, size)                   \
+    do {                                                \
+        q63_t sum = 0;                                  \
+        if ((size) == 0U) {                             \
+            return 0;                                   \
+        }                                               \
+        for (uint32_t i = 0; i < (size); i++) {         \
+            sum += (src)[i];                            \
+        }                                               \
+        return (type)(sum / (q63_t)(size));             \
+    } while (0)
+
+q15_t riscv_dsp_mean_q15(const q15_t *src, uint32_t size)
+{
+    REF_MEAN_INT(q15_t, src, size);
+}
+
+q31_t riscv_dsp_mean_q31(const q31_t *src, uint32_t size)
+{
+    REF_MEAN_INT(q31_t, src, size);
+}
+
+q7_t riscv_dsp_mean_q7(const q7_t *src, uint32_t size)
+{
+    REF_MEAN_INT(q7_t, src, size);
+}
+
+uint8_t riscv_dsp_mean_u8(const uint8_t *src, uint32_t size)
+{
+    REF_MEAN_INT(uint8_t, src, size);
+}
+
+/*
+ * Power (sum of squares)
+ */
+float32_t riscv_dsp_pwr_f32(const float32_t *src, uint32_t size)
+{
+    float32_t sum = 0.0f;
+
+    for (uint32_t i = 0; i < size; i++) {
+        sum += src[i] * src[i];
+    }
+    return sum;
+}
+
+/* Q30 result */
+q63_t riscv_dsp_pwr_q15(const q15_t *src, uint32_t size)
+{
+    q63_t sum = 0;
+
+    for (uint32_t i = 0; i < size; i++) {
+        sum += (q31_t)src[i] * src[i];
+    }
+    return sum;
+}
+
+/* Q48 result */
+q63_t riscv_dsp_pwr_q31(const q31_t *src, uint32_t size)
+{
+    q63_t sum = 0;
+
+    for (uint32_t i = 0; i < size; i++) {
+        sum += ((q63_t)src[i] * src[i]) >> 14;
+    }
+    return sum;
+}
+
+/* Q14 result */
+q31_t riscv_dsp_pwr_q7(const q7_t *src, uint32_t size)
+{
+    q31_t sum = 0;
+
+    for (uint32_t i = 0; i < size; i++) {
+        sum += (q15_t)src[i] * src[i];
+    }
+    return sum;
+}
+
+/*
+ * Root mean square
+ */
+float32_t riscv_dsp_rms_f32(const float32_t *src, uint32_t size)
+{
+    if (size == 0U) {
+        return 0.0f;
+    }
+    return sqrtf(riscv_dsp_pwr_f32(src, size) / (float32_t)size);
+}
+
+q15_t riscv_dsp_rms_q15(const q15_t *src, uint32_t size)
+{
+    if (size == 0U) {
+        return 0;
+    }
+    /* sqrt of a Q30 mean square is a Q15 value */
+    return ref_sat_q15((q63_t)ref_isqrt_u64((uint64_t)(riscv_dsp_pwr_q15(src, size) / size)));
+}
+
+q31_t riscv_dsp_rms_q31(const q31_t *src, uint32_t size)
+{
+    if (size == 0U) {
+        return 0;
+    }
+    /* sqrt of a Q48 mean square is a Q24 value */
+    return ref_sat_q31((q63_t)ref_isqrt_u64((uint64_t)(riscv_dsp_pwr_q31(src, size) / size)) << 7);
+}
+
+/*
+ * Variance and standard deviation use the unbiased estimator (divided by size - 1).
+ */
+float32_t riscv_dsp_var_f32(const float32_t *src, uint32_t size)
+{
+    float32_t mean;
+    float32_t sum = 0.0f;
+
+    if (size <= 1U) {
+        return 0.0f;
+    }
+    mean = riscv_dsp_mean_f32(src, size);
+    for (uint32_t i = 0; i < size; i++) {
+        float32_t d = src[i] - mean;
+        sum += d * d;
+    }
+    return sum / (float32_t)(size - 1U);
+}
+
+/* Q30 result */
+q31_t riscv_dsp_var_q15(const q15_t *src, uint32_t size)
+{
+    q63_t sum = 0;
+    q63_t sum_sqr = 0;
+
+    if (size <= 1U) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        sum += src[i];
+        sum_sqr += (q31_t)src[i] * src[i];
+    }
+    return ref_sat_q31((q63_t)(((double)sum_sqr - (double)sum * (double)sum / size) / (size - 1U)));
+}
+
+/* Q48 result */
+q63_t riscv_dsp_var_q31(const q31_t *src, uint32_t size)
+{
+    q63_t mean;
+    q63_t sum = 0;
+
+    if (size <= 1U) {
+        return 0;
+    }
+    mean = riscv_dsp_mean_q31(src, size);
+    for (uint32_t i = 0; i < size; i++) {
+        q63_t d = (q63_t)src[i] - mean;
+        sum += (d * d) >> 14;
+    }
+    return sum / (q63_t)(size - 1U);
+}
+
+float32_t riscv_dsp_std_f32(const float32_t *src, uint32_t size)
+{
+    return sqrtf(riscv_dsp_var_f32(src, size));
+}
+
+q15_t riscv_dsp_std_q15(const q15_t *src, uint32_t size)
+{
+    return ref_sat_q15((q63_t)ref_isqrt_u64((uint64_t)riscv_dsp_var_q15(src, size)));
+}
+
+q31_t riscv_dsp_std_q31(const q31_t *src, uint32_t size)
+{
+    return ref_sat_q31((q63_t)ref_isqrt_u64((uint64_t)riscv_dsp_var_q31(src, size)) << 7);
+}
+
+/* Q7 result: 8 integer bits hold the full uint8_t range */
+q15_t riscv_dsp_std_u8(const uint8_t *src, uint32_t size)
+{
+    q63_t sum = 0;
+    q63_t sum_sqr = 0;
+    double var;
+
+    if (size <= 1U) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        sum += src[i];
+        sum_sqr += (q31_t)src[i] * src[i];
+    }
+    var = ((double)sum_sqr - (double)sum * (double)sum / size) / (size - 1U);
+    return ref_sat_q15((q63_t)(sqrt(var) * 128.0));
+}
+
+/*
+ * Entropy, relative entropy and log-sum-exp
+ */
+float32_t riscv_dsp_entropy_f32(const float32_t *src, uint32_t size)
+{
+    float32_t sum = 0.0f;
+
+    for (uint32_t i = 0; i < size; i++) {
+        sum += src[i] * logf(src[i]);
+    }
+    return -sum;
+}
+
+float32_t riscv_dsp_relative_entropy_f32(const float32_t *src1, const float32_t *src2, uint32_t size)
+{
+    float32_t sum = 0.0f;
+
+    for (uint32_t i = 0; i < size; i++) {
+        sum += src1[i] * logf(src1[i] / src2[i]);
+    }
+    return sum;
+}
+
+float32_t riscv_dsp_lse_f32(const float32_t *src, uint32_t size)
+{
+    float32_t max;
+    float32_t sum = 0.0f;
+
+    if (size == 0U) {
+        return -INFINITY;
+    }
+    max = riscv_dsp_max_val_f32(src, size);
+    for (uint32_t i = 0; i < size; i++) {
+        sum += expf(src[i] - max);
+    }
+    return max + logf(sum);
+}
+
+float32_t riscv_dsp_lse_dprod_f32(const float32_t *src1, const float32_t *src2, uint32_t size, float32_t *buffer)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        buffer[i] = src1[i] + src2[i];
+    }
+    return riscv_dsp_lse_f32(buffer, size);
+}
+
+/*
+ * Naive Gaussian Bayes estimator, buf receives the log-probability of each class
+ */
+uint32_t riscv_dsp_gaussian_naive_bayes_est_f32(const riscv_dsp_gaussian_naivebayes_f32_t *instance,
+                                                const float32_t *src,
+                                                float32_t *buf)
+{
+    const float32_t *mean = instance->mean;
+    const float32_t *var = instance->var;
+    uint32_t index;
+
+    for (uint32_t c = 0; c < instance->numofclass; c++) {
+        float32_t acc1 = logf(instance->classprior[c]);
+        float32_t acc2 = 0.0f;
+
+        for (uint32_t d = 0; d < instance->dimofvec; d++) {
+            float32_t v = var[d] + instance->additiveofvar;
+            float32_t diff = src[d] - mean[d];
+            acc1 -= 0.5f * logf(2.0f * (float32_t)REF_PI * v);
+            acc2 += diff * diff / v;
+        }
+        buf[c] = acc1 - 0.5f * acc2;
+        mean += instance->dimofvec;
+        var += instance->dimofvec;
+    }
+    riscv_dsp_max_f32(buf, instance->numofclass, &index);
+    return index;
+}
+
+#endif
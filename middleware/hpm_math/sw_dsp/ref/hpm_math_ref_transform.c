@@ -0,0 +1,455 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "hpm_math_ref_common.h"
+
+#if defined(HPM_MATH_DSP_TRANSFORM) && defined(HPM_EN_MATH_DSP_LIB)
+
+/*
+ * Supported ranges of m (log2 of the sample number), as documented by the DSP library
+ */
+#define REF_CFFT_MIN_M (3U)
+#define REF_CFFT_MAX_M (10U)
+#define REF_RFFT_MIN_M (4U)
+#define REF_RFFT_MAX_M (10U)
+#define REF_DCT_MIN_M  (3U)
+#define REF_DCT_MAX_M  (8U)
+#define REF_DCT4_MAX_M (7U)
+
+#define REF_FFT_FORWARD (-1)
+#define REF_FFT_INVERSE (1)
+
+/*
+ * Complex radix-2 decimation-in-time FFT, in place on interleaved [real, imag] data
+ *
+ * The floating-point inverse is scaled by 1/N. The fixed-point transforms scale every
+ * stage by 1/2 in both directions, so the forward output is X/N and the inverse of that
+ * output gives back the input scaled by 1/N.
+ */
+#define REF_BITREV(type, src, n)                                                \
+    do {                                                                        \
+        for (uint32_t i = 0, j = 0; i < (n); i++) {                             \
+            uint32_t bit = (n) >> 1;                                            \
+            if (i < j) {                                                        \
+                type t = (src)[2U * i];                                         \
+                (src)[2U * i] = (src)[2U * j];                                  \
+                (src)[2U * j] = t;                                              \
+                t = (src)[2U * i + 1U];                                         \
+                (src)[2U * i + 1U] = (src)[2U * j + 1U];                        \
+                (src)[2U * j + 1U] = t;                                         \
+            }                                                                   \
+            while ((bit != 0U) && ((j & bit) != 0U)) {                          \
+                j ^= bit;                                                       \
+                bit >>= 1;                                                      \
+            }                                                                   \
+            j |= bit;                                                           \
+        }                                                                       \
+    } while (0)
+
+#define REF_CFFT_FLOAT(type, src, m, dir)                                       \
+    do {                                                                        \
+        uint32_t n = 1UL << (m);                                                \
+        REF_BITREV(type, src, n);                                               \
+        for (uint32_t len = 2U; len <= n; len <<= 1) {                          \
+            uint32_t half = len >> 1;                                           \
+            for (uint32_t k = 0; k < half; k++) {                               \
+                double angle = (dir) * 2.0 * REF_PI * k / len;                  \
+                type wr = (type)cos(angle);                                     \
+                type wi = (type)sin(angle);                                     \
+                for (uint32_t i = k; i < n; i += len) {                         \
+                    uint32_t a = 2U * i;                                        \
+                    uint32_t b = 2U * (i + half);                               \
+                    type br = (src)[b] * wr - (src)[b + 1U] * wi;               \
+                    type bi = (src)[b] * wi + (src)[b + 1U] * wr;               \
+                    (src)[b] = (src)[a] - br;                                   \
+                    (src)[b + 1U] = (src)[a + 1U] - bi;                         \
+                    (src)[a] += br;                                             \
+                    (src)[a + 1U] += bi;                                        \
+                }                                                               \
+            }                                                                   \
+        }                                                                       \
+        if ((dir) == REF_FFT_INVERSE) {                                         \
+            type scale = (type)1 / (type)n;                                     \
+            for (uint32_t i = 0; i < 2U * n; i++) {                             \
+                (src)[i] *= scale;                                              \
+            }                                                                   \
+        }                                                                       \
+    } while (0)
+
+#define REF_CFFT_FIXED(type, src, m, dir, frac, sat)                            \
+    do {                                                                        \
+        uint32_t n = 1UL << (m);                                                \
+        REF_BITREV(type, src, n);                                               \
+        for (uint32_t len = 2U; len <= n; len <<= 1) {                          \
+            uint32_t half = len >> 1;                                           \
+            for (uint32_t k = 0; k < half; k++) {                               \
+                double angle = (dir) * 2.0 * REF_PI * k / len;                  \
+                q63_t wr = sat((q63_t)round(cos(angle) * (double)(1LL << (frac)))); \
+                q63_t wi = sat((q63_t)round(sin(angle) * (double)(1LL << (frac)))); \
+                for (uint32_t i = k; i < n; i += len) {                         \
+                    uint32_t a = 2U * i;                                        \
+                    uint32_t b = 2U * (i + half);                               \
+                    q63_t br = (((src)[b] * wr) >> (frac)) - (((src)[b + 1U] * wi) >> (frac)); \
+                    q63_t bi = (((src)[b] * wi) >> (frac)) + (((src)[b + 1U] * wr) >> (frac)); \
+                    q63_t ar = (src)[a];                                        \
+                    q63_t ai = (src)[a + 1U];                                   \
+                    (src)[a] = sat((ar + br) >> 1);                             \
+                    (src)[a + 1U] = sat((ai + bi) >> 1);                        \
+                    (src)[b] = sat((ar - br) >> 1);                             \
+                    (src)[b + 1U] = sat((ai - bi) >> 1);                        \
+                }                                                               \
+            }                                                                   \
+        }                                                                       \
+    } while (0)
+
+static void ref_cfft_f32(float32_t *src, uint32_t m, int32_t dir)
+{
+    REF_CFFT_FLOAT(float32_t, src, m, dir);
+}
+
+static void ref_cfft_f64(float64_t *src, uint32_t m, int32_t dir)
+{
+    REF_CFFT_FLOAT(float64_t, src, m, dir);
+}
+
+static void ref_cfft_q31(q31_t *src, uint32_t m, int32_t dir)
+{
+    REF_CFFT_FIXED(q31_t, src, m, dir, 31, ref_sat_q31);
+}
+
+static void ref_cfft_q15(q15_t *src, uint32_t m, int32_t dir)
+{
+    REF_CFFT_FIXED(q15_t, src, m, dir, 15, ref_sat_q15);
+}
+
+static inline bool ref_rd2_m_valid(uint32_t m)
+{
+    return (m >= REF_CFFT_MIN_M) && (m <= REF_CFFT_MAX_M);
+}
+
+static inline bool ref_rd4_m_valid(uint32_t m)
+{
+    return (m >= 4U) && (m <= REF_CFFT_MAX_M) && ((m & 1U) == 0U);
+}
+
+#define REF_CFFT_ENTRY(name, type, impl, dir, valid)                            \
+    int32_t riscv_dsp_##name(type *src, uint32_t m)                             \
+    {                                                                           \
+        if (!valid(m)) {                                                        \
+            return -1;                                                          \
+        }                                                                       \
+        impl(src, m, dir);                                                      \
+        return 0;                                                               \
+    }
+
+REF_CFFT_ENTRY(cfft_rd2_f32, float32_t, ref_cfft_f32, REF_FFT_FORWARD, ref_rd2_m_valid)
+REF_CFFT_ENTRY(cifft_rd2_f32, float32_t, ref_cfft_f32, REF_FFT_INVERSE, ref_rd2_m_valid)
+REF_CFFT_ENTRY(cfft_rd2_q31, q31_t, ref_cfft_q31, REF_FFT_FORWARD, ref_rd2_m_valid)
+REF_CFFT_ENTRY(cifft_rd2_q31, q31_t, ref_cfft_q31, REF_FFT_INVERSE, ref_rd2_m_valid)
+REF_CFFT_ENTRY(cfft_rd2_q15, q15_t, ref_cfft_q15, REF_FFT_FORWARD, ref_rd2_m_valid)
+REF_CFFT_ENTRY(cifft_rd2_q15, q15_t, ref_cfft_q15, REF_FFT_INVERSE, ref_rd2_m_valid)
+REF_CFFT_ENTRY(cfft_rd4_f32, float32_t, ref_cfft_f32, REF_FFT_FORWARD, ref_rd4_m_valid)
+REF_CFFT_ENTRY(cifft_rd4_f32, float32_t, ref_cfft_f32, REF_FFT_INVERSE, ref_rd4_m_valid)
+REF_CFFT_ENTRY(cfft_rd4_q31, q31_t, ref_cfft_q31, REF_FFT_FORWARD, ref_rd4_m_valid)
+REF_CFFT_ENTRY(cifft_rd4_q31, q31_t, ref_cfft_q31, REF_FFT_INVERSE, ref_rd4_m_valid)
+REF_CFFT_ENTRY(cfft_rd4_q15, q15_t, ref_cfft_q15, REF_FFT_FORWARD, ref_rd4_m_valid)
+REF_CFFT_ENTRY(cifft_rd4_q15, q15_t, ref_cfft_q15, REF_FFT_INVERSE, ref_rd4_m_valid)
+
+#define REF_CFFT_VOID_ENTRY(name, type, impl, dir)                              \
+    void riscv_dsp_##name(type *src, uint32_t m)                                \
+    {                                                                           \
+        if (ref_rd2_m_valid(m)) {                                               \
+            impl(src, m, dir);                                                  \
+        }                                                                       \
+    }
+
+REF_CFFT_VOID_ENTRY(cfft_f32, float32_t, ref_cfft_f32, REF_FFT_FORWARD)
+REF_CFFT_VOID_ENTRY(cifft_f32, float32_t, ref_cfft_f32, REF_FFT_INVERSE)
+REF_CFFT_VOID_ENTRY(cfft_f64, float64_t, ref_cfft_f64, REF_FFT_FORWARD)
+REF_CFFT_VOID_ENTRY(cifft_f64, float64_t, ref_cfft_f64, REF_FFT_INVERSE)
+REF_CFFT_VOID_ENTRY(cfft_q31, q31_t, ref_cfft_q31, REF_FFT_FORWARD)
+REF_CFFT_VOID_ENTRY(cifft_q31, q31_t, ref_cfft_q31, REF_FFT_INVERSE)
+REF_CFFT_VOID_ENTRY(cfft_q15, q15_t, ref_cfft_q15, REF_FFT_FORWARD)
+REF_CFFT_VOID_ENTRY(cifft_q15, q15_t, ref_cfft_q15, REF_FFT_INVERSE)
+
+/*
+ * Real FFT
+ *
+ * The N real samples are transformed as N/2 complex samples z[n] = x[2n] + i * x[2n+1],
+ * and then split into the spectrum of the real sequence. The output layout is
+ * [X[0], X[N/2], re(X[1]), im(X[1]), ..., re(X[N/2-1]), im(X[N/2-1])].
+ *
+ * With A = Z[k] and B = conj(Z[N/2-k]), the split step is
+ *   X[k] = (A + B) / 2 - i * W^k * (A - B) / 2,  W = exp(-2 * pi * i / N)
+ * and the inverse merge step is
+ *   Z[k] = (X[k] + conj(X[N/2-k])) / 2 + i * W^-k * (X[k] - conj(X[N/2-k])) / 2
+ */
+#define REF_RFFT_SPLIT(type, acc_t, src, n, dir, mul, out, bsh, wscale, sat)    \
+    do {                                                                        \
+        uint32_t h = (n) >> 1;                                                  \
+        acc_t r0 = (src)[0];                                                    \
+        acc_t i0 = (src)[1];                                                    \
+        (src)[0] = sat(out(r0 + i0, 1));                                        \
+        (src)[1] = sat(out(r0 - i0, 1));                                        \
+        for (uint32_t k = 1; k <= (h >> 1); k++) {                              \
+            uint32_t j = h - k;                                                 \
+            double angle = (dir) * 2.0 * REF_PI * k / (n);                      \
+            acc_t wr = (acc_t)(cos(angle) * (wscale));                          \
+            acc_t wi = (acc_t)(sin(angle) * (wscale));                          \
+            acc_t ar = (src)[2U * k];                                           \
+            acc_t ai = (src)[2U * k + 1U];                                      \
+            acc_t br = (src)[2U * j];                                           \
+            acc_t bi = -(acc_t)(src)[2U * j + 1U];                              \
+            /* e = (A + B), d = (A - B) rotated by -i * W^k (forward) or i * W^-k (inverse) */ \
+            acc_t er = ar + br;                                                 \
+            acc_t ei = ai + bi;                                                 \
+            acc_t dr = ar - br;                                                 \
+            acc_t di = ai - bi;                                                 \
+            acc_t tr = mul(dr, wr) - mul(di, wi);                               \
+            acc_t ti = mul(dr, wi) + mul(di, wr);                               \
+            acc_t xr;                                                           \
+            acc_t xi;                                                           \
+            if ((dir) == REF_FFT_FORWARD) {                                     \
+                xr = er + ti;                                                   \
+                xi = ei - tr;                                                   \
+            } else {                                                            \
+                xr = er - ti;                                                   \
+                xi = ei + tr;                                                   \
+            }                                                                   \
+            /* the mirrored bin is the conjugate-symmetric counterpart */       \
+            acc_t yr;                                                           \
+            acc_t yi;                                                           \
+            if ((dir) == REF_FFT_FORWARD) {                                     \
+                yr = er - ti;                                                   \
+                yi = -ei - tr;                                                  \
+            } else {                                                            \
+                yr = er + ti;                                                   \
+                yi = -ei + tr;                                                  \
+            }                                                                   \
+            (src)[2U * k] = sat(out(xr, bsh));                                  \
+            (src)[2U * k + 1U] = sat(out(xi, bsh));                             \
+            if (j != k) {                                                       \
+                (src)[2U * j] = sat(out(yr, bsh));                              \
+                (src)[2U * j + 1U] = sat(out(yi, bsh));                         \
+            }                                                                   \
+        }                                                                       \
+    } while (0)
+
+#define REF_MUL_F(a, w)        ((a) * (w))
+#define REF_MUL_Q(a, w)        (((a) * (w)) >> 30)
+#define REF_OUT_F(x, sh)       ((x) * 0.5f)
+#define REF_OUT_F64(x, sh)     ((x) * 0.5)
+#define REF_OUT_Q(x, sh)       ((x) >> (sh))
+#define REF_NOSAT(x)           (x)
+
+static inline bool ref_rfft_m_valid(uint32_t m)
+{
+    return (m >= REF_RFFT_MIN_M) && (m <= REF_RFFT_MAX_M);
+}
+
+int32_t riscv_dsp_rfft_f32(float32_t *src, uint32_t m)
+{
+    if (!ref_rfft_m_valid(m)) {
+        return -1;
+    }
+    ref_cfft_f32(src, m - 1U, REF_FFT_FORWARD);
+    /* the DC and Nyquist bins are not halved */
+    src[0] *= 2.0f;
+    src[1] *= 2.0f;
+    REF_RFFT_SPLIT(float32_t, float32_t, src, 1UL << m, REF_FFT_FORWARD, REF_MUL_F, REF_OUT_F, 1, 1.0, REF_NOSAT);
+    return 0;
+}
+
+int32_t riscv_dsp_rifft_f32(float32_t *src, uint32_t m)
+{
+    if (!ref_rfft_m_valid(m)) {
+        return -1;
+    }
+    REF_RFFT_SPLIT(float32_t, float32_t, src, 1UL << m, REF_FFT_INVERSE, REF_MUL_F, REF_OUT_F, 1, 1.0, REF_NOSAT);
+    ref_cfft_f32(src, m - 1U, REF_FFT_INVERSE);
+    return 0;
+}
+
+int32_t riscv_dsp_rfft_f64(float64_t *src, uint32_t m)
+{
+    if (!ref_rfft_m_valid(m)) {
+        return -1;
+    }
+    ref_cfft_f64(src, m - 1U, REF_FFT_FORWARD);
+    src[0] *= 2.0;
+    src[1] *= 2.0;
+    REF_RFFT_SPLIT(float64_t, float64_t, src, 1UL << m, REF_FFT_FORWARD, REF_MUL_F, REF_OUT_F64, 1, 1.0, REF_NOSAT);
+    return 0;
+}
+
+int32_t riscv_dsp_rifft_f64(float64_t *src, uint32_t m)
+{
+    if (!ref_rfft_m_valid(m)) {
+        return -1;
+    }
+    REF_RFFT_SPLIT(float64_t, float64_t, src, 1UL << m, REF_FFT_INVERSE, REF_MUL_F, REF_OUT_F64, 1, 1.0, REF_NOSAT);
+    ref_cfft_f64(src, m - 1U, REF_FFT_INVERSE);
+    return 0;
+}
+
+/*
+ * fixed-point: the N/2 point cfft already scales by 2/N, the split step supplies the
+ * remaining 1/2 so that rfft returns X/N; rifft of that spectrum returns x/N
+ */
+int32_t riscv_dsp_rfft_q31(q31_t *src, uint32_t m)
+{
+    if (!ref_rfft_m_valid(m)) {
+        return -1;
+    }
+    ref_cfft_q31(src, m - 1U, REF_FFT_FORWARD);
+    REF_RFFT_SPLIT(q31_t, q63_t, src, 1UL << m, REF_FFT_FORWARD, REF_MUL_Q, REF_OUT_Q, 2, 1073741824.0, ref_sat_q31);
+    return 0;
+}
+
+int32_t riscv_dsp_rifft_q31(q31_t *src, uint32_t m)
+{
+    if (!ref_rfft_m_valid(m)) {
+        return -1;
+    }
+    REF_RFFT_SPLIT(q31_t, q63_t, src, 1UL << m, REF_FFT_INVERSE, REF_MUL_Q, REF_OUT_Q, 1, 1073741824.0, ref_sat_q31);
+    ref_cfft_q31(src, m - 1U, REF_FFT_INVERSE);
+    return 0;
+}
+
+int32_t riscv_dsp_rfft_q15(q15_t *src, uint32_t m)
+{
+    if (!ref_rfft_m_valid(m)) {
+        return -1;
+    }
+    ref_cfft_q15(src, m - 1U, REF_FFT_FORWARD);
+    REF_RFFT_SPLIT(q15_t, q63_t, src, 1UL << m, REF_FFT_FORWARD, REF_MUL_Q, REF_OUT_Q, 2, 1073741824.0, ref_sat_q15);
+    return 0;
+}
+
+int32_t riscv_dsp_rifft_q15(q15_t *src, uint32_t m)
+{
+    if (!ref_rfft_m_valid(m)) {
+        return -1;
+    }
+    REF_RFFT_SPLIT(q15_t, q63_t, src, 1UL << m, REF_FFT_INVERSE, REF_MUL_Q, REF_OUT_Q, 1, 1073741824.0, ref_sat_q15);
+    ref_cfft_q15(src, m - 1U, REF_FFT_INVERSE);
+    return 0;
+}
+
+/*
+ * DCT type II and type IV, computed directly with a stack copy of the input
+ *
+ *   DCT-II:  X[k] = sum(x[n] * cos(pi * (2n + 1) * k / 2N))
+ *   IDCT:    x[n] = X[0] / N + 2 / N * sum(X[k] * cos(pi * (2n + 1) * k / 2N)), k >= 1
+ *   DCT-IV:  X[k] = sum(x[n] * cos(pi / N * (n + 1/2) * (k + 1/2))), its inverse is 2 / N * DCT-IV
+ *
+ * The fixed-point forward transforms are scaled by 1/N, so that the inverse of their
+ * output gives back the input.
+ */
+static inline double ref_dct2_cos(uint32_t n, uint32_t k, uint32_t len)
+{
+    return cos(REF_PI * (2.0 * n + 1.0) * k / (2.0 * len));
+}
+
+static inline double ref_dct4_cos(uint32_t n, uint32_t k, uint32_t len)
+{
+    return cos(REF_PI / len * (n + 0.5) * (k + 0.5));
+}
+
+#define REF_DCT(type, src, m, maxm, expr, out)                                  \
+    do {                                                                        \
+        type x[1UL << (maxm)];                                                  \
+        uint32_t len = 1UL << (m);                                              \
+        if (((m) < REF_DCT_MIN_M) || ((m) > (maxm))) {                          \
+            return;                                                             \
+        }                                                                       \
+        for (uint32_t i = 0; i < len; i++) {                                    \
+            x[i] = (src)[i];                                                    \
+        }                                                                       \
+        for (uint32_t k = 0; k < len; k++) {                                    \
+            double acc = 0.0;                                                   \
+            for (uint32_t i = 0; i < len; i++) {                                \
+                acc += (double)x[i] * (expr);                                   \
+            }                                                                   \
+            (src)[k] = out(acc, len);                                           \
+        }                                                                       \
+    } while (0)
+
+#define REF_DCT_OUT_F(acc, len)      ((float32_t)(acc))
+#define REF_DCT_OUT_F_INV(acc, len)  ((float32_t)((acc) / (len)))
+#define REF_DCT_OUT_F_INV4(acc, len) ((float32_t)(2.0 * (acc) / (len)))
+#define REF_DCT_OUT_Q31(acc, len)    ref_sat_q31((q63_t)round((acc) / (len)))
+#define REF_DCT_OUT_Q15(acc, len)    ref_sat_q15((q63_t)round((acc) / (len)))
+#define REF_DCT_OUT_Q31_N(acc, len)  ref_sat_q31((q63_t)round(acc))
+#define REF_DCT_OUT_Q15_N(acc, len)  ref_sat_q15((q63_t)round(acc))
+#define REF_DCT_OUT_Q31_2(acc, len)  ref_sat_q31((q63_t)round(2.0 * (acc)))
+#define REF_DCT_OUT_Q15_2(acc, len)  ref_sat_q15((q63_t)round(2.0 * (acc)))
+
+/* IDCT kernel, the DC term has half the weight of the others */
+#define REF_IDCT_KERNEL(i, k, len) (((i) == 0U) ? 1.0 : 2.0) * ref_dct2_cos(k, i, len)
+
+void riscv_dsp_dct_f32(float32_t *src, uint32_t m)
+{
+    REF_DCT(float32_t, src, m, REF_DCT_MAX_M, ref_dct2_cos(i, k, len), REF_DCT_OUT_F);
+}
+
+void riscv_dsp_idct_f32(float32_t *src, uint32_t m)
+{
+    REF_DCT(float32_t, src, m, REF_DCT_MAX_M, REF_IDCT_KERNEL(i, k, len), REF_DCT_OUT_F_INV);
+}
+
+void riscv_dsp_dct_q31(q31_t *src, uint32_t m)
+{
+    REF_DCT(q31_t, src, m, REF_DCT_MAX_M, ref_dct2_cos(i, k, len), REF_DCT_OUT_Q31);
+}
+
+void riscv_dsp_idct_q31(q31_t *src, uint32_t m)
+{
+    REF_DCT(q31_t, src, m, REF_DCT_MAX_M, REF_IDCT_KERNEL(i, k, len), REF_DCT_OUT_Q31_N);
+}
+
+void riscv_dsp_dct_q15(q15_t *src, uint32_t m)
+{
+    REF_DCT(q15_t, src, m, REF_DCT_MAX_M, ref_dct2_cos(i, k, len), REF_DCT_OUT_Q15);
+}
+
+void riscv_dsp_idct_q15(q15_t *src, uint32_t m)
+{
+    REF_DCT(q15_t, src, m, REF_DCT_MAX_M, REF_IDCT_KERNEL(i, k, len), REF_DCT_OUT_Q15_N);
+}
+
+void riscv_dsp_dct4_f32(float32_t *src, uint32_t m)
+{
+    REF_DCT(float32_t, src, m, REF_DCT4_MAX_M, ref_dct4_cos(i, k, len), REF_DCT_OUT_F);
+}
+
+void riscv_dsp_idct4_f32(float32_t *src, uint32_t m)
+{
+    REF_DCT(float32_t, src, m, REF_DCT4_MAX_M, ref_dct4_cos(i, k, len), REF_DCT_OUT_F_INV4);
+}
+
+void riscv_dsp_dct4_q31(q31_t *src, uint32_t m)
+{
+    REF_DCT(q31_t, src, m, REF_DCT4_MAX_M, ref_dct4_cos(i, k, len), REF_DCT_OUT_Q31);
+}
+
+void riscv_dsp_idct4_q31(q31_t *src, uint32_t m)
+{
+    REF_DCT(q31_t, src, m, REF_DCT4_MAX_M, ref_dct4_cos(i, k, len), REF_DCT_OUT_Q31_2);
+}
+
+void riscv_dsp_dct4_q15(q15_t *src, uint32_t m)
+{
+    REF_DCT(q15_t, src, m, REF_DCT4_MAX_M, ref_dct4_cos(i, k, len), REF_DCT_OUT_Q15);
+}
+
+void riscv_dsp_idct4_q15(q15_t *src, uint32_t m)
+{
+    REF_DCT(q15_t, src, m, REF_DCT4_MAX_M, ref_dct4_cos(i, k, len), REF_DCT_OUT_Q15_2);
+}
+
+#endif
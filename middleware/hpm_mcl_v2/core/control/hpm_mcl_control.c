@@ -8,166 +8,167 @@
 #include "hpm_mcl_control.h"
 #include "hpm_mcl_math.h"
 
-float hpm_mcl_control_sin(float x)
+hpm_mcl_type_t hpm_mcl_control_sin(hpm_mcl_type_t x)
 {
-    return sinf(x);
+    return MCL_MATH_SIN(x);
 }
 
-float hpm_mcl_control_cos(float x)
+hpm_mcl_type_t hpm_mcl_control_cos(hpm_mcl_type_t x)
 {
-    return cosf(x);
+    return MCL_MATH_COS(x);
 }
 
-float hpm_mcl_control_arctan(float y, float x)
+hpm_mcl_type_t hpm_mcl_control_arctan(hpm_mcl_type_t y, hpm_mcl_type_t x)
 {
-    return atan2((double)y, (double)x);
+    return MCL_MATH_ATAN2(y, x);
 }
 
-hpm_mcl_stat_t hpm_mcl_control_clarke(float ia, float ib, float ic,
-                    float *alpha, float *beta)
+hpm_mcl_stat_t hpm_mcl_control_clarke(hpm_mcl_type_t ia, hpm_mcl_type_t ib, hpm_mcl_type_t ic,
+                    hpm_mcl_type_t *alpha, hpm_mcl_type_t *beta)
 {
     (void)ic;
     MCL_ASSERT_OPT(alpha != NULL, mcl_invalid_pointer);
     MCL_ASSERT_OPT(beta != NULL, mcl_invalid_pointer);
     *alpha = ia;
-    *beta = SQRT3_DIV3 * ia + (SQRT3_DIV3 * 2) * ib;
+    *beta = MCL_MATH_ADD(MCL_MATH_MUL(MCL_MATH_CONST(SQRT3_DIV3), ia), MCL_MATH_MUL(MCL_MATH_CONST(SQRT3_DIV3 * 2), ib));
 
     return mcl_success;
 }
 
-hpm_mcl_stat_t hpm_mcl_control_park(float alpha, float beta, float sin_x, float cos_x,
-                    float *d, float *q)
+hpm_mcl_stat_t hpm_mcl_control_park(hpm_mcl_type_t alpha, hpm_mcl_type_t beta, hpm_mcl_type_t sin_x, hpm_mcl_type_t cos_x,
+                    hpm_mcl_type_t *d, hpm_mcl_type_t *q)
 {
     MCL_ASSERT_OPT(d != NULL, mcl_invalid_pointer);
     MCL_ASSERT_OPT(q != NULL, mcl_invalid_pointer);
-    *d = cos_x * alpha + sin_x * beta;
-    *q = -sin_x * alpha + cos_x *beta;
+    *d = MCL_MATH_ADD(MCL_MATH_MUL(cos_x, alpha), MCL_MATH_MUL(sin_x, beta));
+    *q = MCL_MATH_SUB(MCL_MATH_MUL(cos_x, beta), MCL_MATH_MUL(sin_x, alpha));
 
     return mcl_success;
 }
 
-hpm_mcl_stat_t hpm_mcl_control_pi(float ref, float sens, mcl_control_pid_t *pid_x, float *output)
+hpm_mcl_stat_t hpm_mcl_control_pi(hpm_mcl_type_t ref, hpm_mcl_type_t sens, mcl_control_pid_t *pid_x, hpm_mcl_type_t *output)
 {
-    float err;
-    float val;
+    hpm_mcl_type_t err;
+    hpm_mcl_type_t val;
 
     MCL_ASSERT_OPT(output != NULL, mcl_invalid_pointer);
-    err = ref - sens;
-    pid_x->integral += pid_x->cfg.ki * err;
+    err = MCL_MATH_SUB(ref, sens);
+    pid_x->integral = MCL_MATH_ADD(pid_x->integral, MCL_MATH_MUL(pid_x->cfg.ki, err));
     MCL_VALUE_LIMIT(pid_x->integral, pid_x->cfg.integral_min, pid_x->cfg.integral_max);
-    val = pid_x->cfg.kp * err + pid_x->integral;
+    val = MCL_MATH_ADD(MCL_MATH_MUL(pid_x->cfg.kp, err), pid_x->integral);
     MCL_VALUE_LIMIT(val, pid_x->cfg.output_min, pid_x->cfg.output_max);
     *output = val;
 
     return mcl_success;
 }
 
-hpm_mcl_stat_t hpm_mcl_control_inv_park(float d, float q, float sin_x,
-                        float cos_x, float *alpha, float *beta)
+hpm_mcl_stat_t hpm_mcl_control_inv_park(hpm_mcl_type_t d, hpm_mcl_type_t q, hpm_mcl_type_t sin_x,
+                        hpm_mcl_type_t cos_x, hpm_mcl_type_t *alpha, hpm_mcl_type_t *beta)
 {
     MCL_ASSERT_OPT(alpha != NULL, mcl_invalid_pointer);
     MCL_ASSERT_OPT(beta != NULL, mcl_invalid_pointer);
-    *alpha = cos_x * d - sin_x * q;
-    *beta = sin_x * d + cos_x * q;
+    *alpha = MCL_MATH_SUB(MCL_MATH_MUL(cos_x, d), MCL_MATH_MUL(sin_x, q));
+    *beta = MCL_MATH_ADD(MCL_MATH_MUL(sin_x, d), MCL_MATH_MUL(cos_x, q));
 
     return mcl_success;
 }
 
-hpm_mcl_stat_t hpm_mcl_control_svpwm(float alpha, float beta, float vbus, mcl_control_svpwm_duty_t *duty)
+hpm_mcl_stat_t hpm_mcl_control_svpwm(hpm_mcl_type_t alpha, hpm_mcl_type_t beta, hpm_mcl_type_t vbus, mcl_control_svpwm_duty_t *duty)
 {
-    float val0, val1;
-    float val2, val3;
-    float val4, val5, val6;
+    hpm_mcl_type_t val0, val1;
+    hpm_mcl_type_t val2, val3;
+    hpm_mcl_type_t val4, val5, val6;
     mcl_svpwm_sector_t sector;
 
     MCL_ASSERT_OPT(duty != NULL, mcl_invalid_pointer);
     MCL_ASSERT(vbus != 0, mcl_invalid_argument);
-    vbus = 1 / (vbus * 2 / 3);
-    alpha = alpha * vbus;
-    beta = beta * vbus;
-    val0 = beta / alpha;
-    val1 = alpha / beta;
+    vbus = MCL_MATH_DIV(MCL_MATH_CONST(1.5f), vbus);
+    alpha = MCL_MATH_MUL(alpha, vbus);
+    beta = MCL_MATH_MUL(beta, vbus);
+    /* sector boundaries compared by multiplication, no division and no infinity on the axes */
+    val0 = MCL_MATH_MUL(MCL_MATH_CONST(SQRT3), alpha);
+    val1 = MCL_MATH_MUL(MCL_MATH_CONST(-SQRT3_DIV3), beta);
 
     if (beta > 0) {
         if (alpha > 0) {
-            if (val0 < SQRT3) {
+            if (beta < val0) {
                 sector = svpwm_sector1;
             } else {
                 sector = svpwm_sector2;
             }
-        } else if (val1 > -SQRT3_DIV3) {
+        } else if (alpha > val1) {
             sector = svpwm_sector2;
         } else {
             sector = svpwm_sector3;
         }
     } else if (alpha > 0) {
-        if (val0 < -SQRT3) {
+        if (beta < MCL_MATH_NEG(val0)) {
             sector = svpwm_sector5;
         } else {
             sector = svpwm_sector6;
         }
-    } else if (val0 < SQRT3) {
+    } else if (beta > val0) {
         sector = svpwm_sector4;
     } else {
         sector = svpwm_sector5;
     }
-    val2 = SQRT3_DIV3 * beta;
-    val3 = SQRT3_DIV3 * 2 * beta;
+    val2 = MCL_MATH_MUL(MCL_MATH_CONST(SQRT3_DIV3), beta);
+    val3 = MCL_MATH_MUL(MCL_MATH_CONST(SQRT3_DIV3 * 2), beta);
 
 
     switch (sector) {
     case svpwm_sector1:
-        val4 = (alpha - val2);
-        val5 = (1 - val4 - val3) / 2;
-        val4 += val5;
-        val6 = val4 + val3;
+        val4 = MCL_MATH_SUB(alpha, val2);
+        val5 = MCL_MATH_DIV2(MCL_MATH_SUB(MCL_MATH_SUB(MCL_MATH_CONST(1), val4), val3));
+        val4 = MCL_MATH_ADD(val4, val5);
+        val6 = MCL_MATH_ADD(val4, val3);
         duty->a = val5;
         duty->b = val4;
         duty->c = val6;
         break;
     case svpwm_sector2:
-        val4 = alpha + val2;
-        val2 = val2 - alpha;
-        val5 = (1 - val4 - val2) / 2;
-        val2 += val5;
-        val6 = val2 + val4;
+        val4 = MCL_MATH_ADD(alpha, val2);
+        val2 = MCL_MATH_SUB(val2, alpha);
+        val5 = MCL_MATH_DIV2(MCL_MATH_SUB(MCL_MATH_SUB(MCL_MATH_CONST(1), val4), val2));
+        val2 = MCL_MATH_ADD(val2, val5);
+        val6 = MCL_MATH_ADD(val2, val4);
         duty->a = val2;
         duty->b = val5;
         duty->c = val6;
         break;
     case svpwm_sector3:
-        val4 = -alpha - val2;
-        val5 = (1 - val4 - val3) / 2;
-        val3 += val5;
-        val6 = val3 + val4;
+        val4 = MCL_MATH_SUB(MCL_MATH_NEG(alpha), val2);
+        val5 = MCL_MATH_DIV2(MCL_MATH_SUB(MCL_MATH_SUB(MCL_MATH_CONST(1), val4), val3));
+        val3 = MCL_MATH_ADD(val3, val5);
+        val6 = MCL_MATH_ADD(val3, val4);
         duty->a = val6;
         duty->b = val5;
         duty->c = val3;
         break;
     case svpwm_sector4:
-        val4 = val2 - alpha;
-        val5 = (1 - val4 + val3) / 2;
-        val3 = val5 - val3;
-        val6 = val3 + val4;
+        val4 = MCL_MATH_SUB(val2, alpha);
+        val5 = MCL_MATH_DIV2(MCL_MATH_ADD(MCL_MATH_SUB(MCL_MATH_CONST(1), val4), val3));
+        val3 = MCL_MATH_SUB(val5, val3);
+        val6 = MCL_MATH_ADD(val3, val4);
         duty->a = val6;
         duty->b = val3;
         duty->c = val5;
         break;
     case svpwm_sector5:
-        val4 = alpha - val2;
-        val2 = -val2 - alpha;
-        val5 = (1 - val4 - val2) / 2;
-        val2 += val5;
-        val6 = val2 + val4;
+        val4 = MCL_MATH_SUB(alpha, val2);
+        val2 = MCL_MATH_SUB(MCL_MATH_NEG(val2), alpha);
+        val5 = MCL_MATH_DIV2(MCL_MATH_SUB(MCL_MATH_SUB(MCL_MATH_CONST(1), val4), val2));
+        val2 = MCL_MATH_ADD(val2, val5);
+        val6 = MCL_MATH_ADD(val2, val4);
         duty->a = val2;
         duty->b = val6;
         duty->c = val5;
         break;
     case svpwm_sector6:
-        val4 = val2 + alpha;
-        val5 = (1 - val4 + val3) / 2;
-        val4 += val5;
-        val6 = val4 - val3;
+        val4 = MCL_MATH_ADD(val2, alpha);
+        val5 = MCL_MATH_DIV2(MCL_MATH_ADD(MCL_MATH_SUB(MCL_MATH_CONST(1), val4), val3));
+        val4 = MCL_MATH_ADD(val4, val5);
+        val6 = MCL_MATH_SUB(val4, val3);
         duty->a = val5;
         duty->b = val6;
         duty->c = val4;
@@ -180,38 +181,38 @@ hpm_mcl_stat_t hpm_mcl_control_svpwm(float alpha, float beta, float vbus, mcl_co
         break;
     }
 
-    MCL_VALUE_LIMIT(duty->a, 0, 1);
-    MCL_VALUE_LIMIT(duty->b, 0, 1);
-    MCL_VALUE_LIMIT(duty->c, 0, 1);
+    MCL_VALUE_LIMIT(duty->a, 0, MCL_MATH_CONST(1));
+    MCL_VALUE_LIMIT(duty->b, 0, MCL_MATH_CONST(1));
+    MCL_VALUE_LIMIT(duty->c, 0, MCL_MATH_CONST(1));
 
     return mcl_success;
 }
 
-hpm_mcl_stat_t hpm_mcl_control_step_svpwm(float alpha, float beta, float vbus, mcl_control_svpwm_duty_t *duty)
+hpm_mcl_stat_t hpm_mcl_control_step_svpwm(hpm_mcl_type_t alpha, hpm_mcl_type_t beta, hpm_mcl_type_t vbus, mcl_control_svpwm_duty_t *duty)
 {
-    float ta0on = 0, ta1on = 0, tb0on = 0, tb1on = 0;
+    hpm_mcl_type_t ta0on = 0, ta1on = 0, tb0on = 0, tb1on = 0;
 
     MCL_ASSERT_OPT(duty != NULL, mcl_invalid_pointer);
     MCL_ASSERT(vbus != 0, mcl_invalid_argument);
-    vbus = 1 / (vbus * 2 / 3);
-    alpha = alpha * vbus;
-    beta = beta * vbus;
+    vbus = MCL_MATH_DIV(MCL_MATH_CONST(1.5f), vbus);
+    alpha = MCL_MATH_MUL(alpha, vbus);
+    beta = MCL_MATH_MUL(beta, vbus);
 
     if (alpha > 0) {
         ta1on = alpha;
     } else {
-        ta0on = -alpha;
+        ta0on = MCL_MATH_NEG(alpha);
     }
     if (beta > 0) {
         tb1on = beta;
     } else {
-        tb0on = -beta;
+        tb0on = MCL_MATH_NEG(beta);
     }
 
-    MCL_VALUE_LIMIT(ta0on, 0, 1);
-    MCL_VALUE_LIMIT(ta1on, 0, 1);
-    MCL_VALUE_LIMIT(tb0on, 0, 1);
-    MCL_VALUE_LIMIT(tb1on, 0, 1);
+    MCL_VALUE_LIMIT(ta0on, 0, MCL_MATH_CONST(1));
+    MCL_VALUE_LIMIT(ta1on, 0, MCL_MATH_CONST(1));
+    MCL_VALUE_LIMIT(tb0on, 0, MCL_MATH_CONST(1));
+    MCL_VALUE_LIMIT(tb1on, 0, MCL_MATH_CONST(1));
 
     duty->a0 = ta0on;
     duty->a1 = ta1on;
@@ -255,7 +256,7 @@ hpm_mcl_stat_t hpm_mcl_control_dead_area_polarity_detection(mcl_control_dead_are
 
     out_q = hpm_mcl_control_lowpass_filter(iq, &dead_area->q_mem, dead_area->cfg.lowpass_k);
     out_d = hpm_mcl_control_lowpass_filter(id, &dead_area->d_mem, dead_area->cfg.lowpass_k);
-    sens_theta = atan2f(out_q, out_d);
+    sens_theta = hpm_mcl_math_atan2(out_q, out_d);
     theta += sens_theta;
     theta = MCL_ANGLE_MOD_X(0, MCL_2PI, theta);
 
@@ -305,6 +306,8 @@ void hpm_mcl_control_smc_process(mcl_control_smc_t *smc_cfg, float ualpha, float
     float beta_err;
     float speed;
     float sens, ref;
+    float sin_x, cos_x;
+    hpm_mcl_type_t pll_out;
 
     smc_cfg->ialpha_mem = smc_cfg->cfg.factor.smc_f *
                                         smc_cfg->ialpha_mem + smc_cfg->cfg.factor.smc_g *
@@ -339,9 +342,11 @@ void hpm_mcl_control_smc_process(mcl_control_smc_t *smc_cfg, float ualpha, float
     smc_cfg->beta_cal = (1 - smc_cfg->cfg.factor.filter_coeff) *
                                         smc_cfg->beta_cal + smc_cfg->cfg.factor.filter_coeff *
                                         smc_cfg->zbeta_cal;
-    ref = -smc_cfg->alpha_cal * cosf(smc_cfg->theta_mem);
-    sens = smc_cfg->beta_cal * sinf(smc_cfg->theta_mem);
-    hpm_mcl_control_pi(ref, sens, &smc_cfg->cfg.pll, &speed);
+    hpm_mcl_math_sincos(smc_cfg->theta_mem, &sin_x, &cos_x);
+    ref = -smc_cfg->alpha_cal * cos_x;
+    sens = smc_cfg->beta_cal * sin_x;
+    hpm_mcl_control_pi(MCL_MATH_FLOAT_TO_TYPE(ref), MCL_MATH_FLOAT_TO_TYPE(sens), &smc_cfg->cfg.pll, &pll_out);
+    speed = MCL_MATH_CONVERT_FLOAT(pll_out);
     smc_cfg->theta_mem += speed * smc_cfg->cfg.const_data.loop_ts;
     smc_cfg->theta_mem = MCL_ANGLE_MOD_X(0, MCL_2PI, smc_cfg->theta_mem);
     smc_cfg->theta = MCL_ANGLE_MOD_X(0, MCL_2PI, smc_cfg->theta_mem + smc_cfg->cfg.theta0);
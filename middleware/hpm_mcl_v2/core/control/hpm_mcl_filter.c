@@ -20,24 +20,25 @@ hpm_mcl_stat_t hpm_mcl_filter_iir_df1_init(mcl_filter_iir_df1_t *iir, mcl_filter
     return mcl_success;
 }
 
-float hpm_mcl_filter_iir_df1(mcl_filter_iir_df1_t *iir, float input)
+hpm_mcl_type_t hpm_mcl_filter_iir_df1(mcl_filter_iir_df1_t *iir, hpm_mcl_type_t input)
 {
     uint8_t i = 0;
-    float y = 0;
+    hpm_mcl_type_t y = 0;
 
     MCL_ASSERT_OPT(iir != NULL, mcl_invalid_pointer);
     iir->mem[0].x0 = input;
     for (i = 0; i < iir->cfg->section; i++) {
-        y = iir->cfg->matrix[i].b0 * iir->mem[i].x0 +
-            iir->cfg->matrix[i].b1 * iir->mem[i].x1 +
-            iir->cfg->matrix[i].b2 * iir->mem[i].x2 -
-            iir->cfg->matrix[i].a1 * iir->mem[i].y1 -
-            iir->cfg->matrix[i].a2 * iir->mem[i].y2;
+        /* feedback on the scaled output, the unscaled sum has the dc gain 1/scale and overflows a Q value */
+        y = MCL_MATH_ADD(MCL_MATH_MUL(iir->cfg->matrix[i].b0, iir->mem[i].x0),
+            MCL_MATH_MUL(iir->cfg->matrix[i].b1, iir->mem[i].x1));
+        y = MCL_MATH_ADD(y, MCL_MATH_MUL(iir->cfg->matrix[i].b2, iir->mem[i].x2));
+        y = MCL_MATH_MUL(y, iir->cfg->matrix[i].scale);
+        y = MCL_MATH_SUB(y, MCL_MATH_MUL(iir->cfg->matrix[i].a1, iir->mem[i].y1));
+        y = MCL_MATH_SUB(y, MCL_MATH_MUL(iir->cfg->matrix[i].a2, iir->mem[i].y2));
         iir->mem[i].x2 = iir->mem[i].x1;
         iir->mem[i].x1 = iir->mem[i].x0;
         iir->mem[i].y2 = iir->mem[i].y1;
         iir->mem[i].y1 = y;
-        y *= iir->cfg->matrix[i].scale;
         if ((i+1) < iir->cfg->section) {
             iir->mem[i+1].x0 = y;
         }
@@ -8,18 +8,19 @@
 #define HPM_MCL_FILTER_H
 
 #include "hpm_common.h"
+#include "hpm_mcl_math.h"
 
 /**
  * @brief Gain matrix for iir filter type df1
  *
  */
 typedef struct {
-    float b0;
-    float b1;
-    float b2;
-    float a1;
-    float a2;
-    float scale;
+    hpm_mcl_type_t b0;
+    hpm_mcl_type_t b1;
+    hpm_mcl_type_t b2;
+    hpm_mcl_type_t a1;
+    hpm_mcl_type_t a2;
+    hpm_mcl_type_t scale;
 } mcl_filter_iir_df1_matrix_t;
 
 /**
@@ -27,11 +28,11 @@ typedef struct {
  *
  */
 typedef struct {
-    float x0;
-    float x1;
-    float x2;
-    float y1;
-    float y2;
+    hpm_mcl_type_t x0;
+    hpm_mcl_type_t x1;
+    hpm_mcl_type_t x2;
+    hpm_mcl_type_t y1;
+    hpm_mcl_type_t y2;
 } mcl_filter_iir_df1_memory_t;
 
 /**
@@ -74,7 +75,7 @@ hpm_mcl_stat_t hpm_mcl_filter_iir_df1_init(mcl_filter_iir_df1_t *iir, mcl_filter
  * @param input raw data
  * @return Filtered data
  */
-float hpm_mcl_filter_iir_df1(mcl_filter_iir_df1_t *iir, float input);
+hpm_mcl_type_t hpm_mcl_filter_iir_df1(mcl_filter_iir_df1_t *iir, hpm_mcl_type_t input);
 
 #ifdef __cplusplus
 }
@@ -35,3 +35,303 @@ void hpm_mcl_debug_update_data(mcl_debug_t *debug, uint8_t chn, void *data, mcl_
         break;
     }
 }
+
+/* the interrupt and the background run on the same hart, keeping the compiler from reordering is enough */
+#define MCL_DEBUG_SCOPE_BARRIER() __asm volatile("" ::: "memory")
+
+enum {
+    mcl_debug_scope_half_free = 0,
+    mcl_debug_scope_half_filling = 1,
+    mcl_debug_scope_half_ready = 2,
+};
+
+static void hpm_mcl_debug_scope_put_u16(uint8_t *buf, uint16_t val)
+{
+    buf[0] = val & 0xff;
+    buf[1] = val >> 8;
+}
+
+static void hpm_mcl_debug_scope_put_u32(uint8_t *buf, uint32_t val)
+{
+    hpm_mcl_debug_scope_put_u16(buf, val & 0xffff);
+    hpm_mcl_debug_scope_put_u16(&buf[2], val >> 16);
+}
+
+static void hpm_mcl_debug_scope_checksum(uint8_t *buf, uint32_t len)
+{
+    uint32_t i;
+    uint32_t sum0 = 0;
+    uint32_t sum1 = 0;
+
+    for (i = 2; i < len - MCL_DEBUG_SCOPE_CHECKSUM_SIZE; i++) {
+        sum0 += buf[i];
+        sum1 += sum0;
+        if ((i & 0xff) == 0) {
+            sum0 %= 255;
+            sum1 %= 255;
+        }
+    }
+    sum0 %= 255;
+    sum1 %= 255;
+    hpm_mcl_debug_scope_put_u16(&buf[len - MCL_DEBUG_SCOPE_CHECKSUM_SIZE], (sum1 << 8) | sum0);
+}
+
+static float hpm_mcl_debug_scope_read_float(mcl_debug_scope_chn_t *chn)
+{
+    switch (chn->type) {
+    case mcl_debug_data_i8:
+        return *(int8_t *)chn->addr;
+    case mcl_debug_data_i16:
+        return *(int16_t *)chn->addr;
+    case mcl_debug_data_i32:
+        return *(int32_t *)chn->addr;
+    default:
+        return *(float *)chn->addr;
+    }
+}
+
+hpm_mcl_stat_t hpm_mcl_debug_scope_init(mcl_debug_scope_t *scope, mcl_debug_scope_cfg_t *cfg)
+{
+    MCL_ASSERT(scope != NULL, mcl_invalid_pointer);
+    MCL_ASSERT(cfg != NULL, mcl_invalid_pointer);
+    MCL_ASSERT(cfg->buf != NULL, mcl_invalid_pointer);
+    MCL_ASSERT((cfg->buf_size / 2) <= 0xffff, mcl_invalid_argument);
+    memset(scope, 0, sizeof(mcl_debug_scope_t));
+    scope->cfg = cfg;
+    scope->half_size = cfg->buf_size / 2;
+    scope->half[0].buf = cfg->buf;
+    scope->half[1].buf = cfg->buf + scope->half_size;
+    scope->state = mcl_debug_scope_idle;
+
+    return mcl_success;
+}
+
+hpm_mcl_stat_t hpm_mcl_debug_scope_add_chn(mcl_debug_scope_t *scope, void *addr, mcl_debug_data_type_t type)
+{
+    uint16_t size;
+
+    MCL_ASSERT(scope != NULL, mcl_invalid_pointer);
+    MCL_ASSERT(addr != NULL, mcl_invalid_pointer);
+    MCL_ASSERT(scope->state == mcl_debug_scope_idle, mcl_fail);
+    MCL_ASSERT(scope->chn_num < MCL_DEBUG_SCOPE_CHN_NUM, mcl_invalid_argument);
+    size = MCL_DEBUG_DATA_TYPE_GET_SIZE(type);
+    MCL_ASSERT(scope->half_size >= (uint32_t)(MCL_DEBUG_SCOPE_HEADER_SIZE + scope->record_size + size + MCL_DEBUG_SCOPE_CHECKSUM_SIZE),
+        mcl_invalid_argument);
+    scope->chn[scope->chn_num].addr = addr;
+    scope->chn[scope->chn_num].type = type;
+    scope->chn_num++;
+    scope->record_size += size;
+    scope->record_per_frame = (scope->half_size - MCL_DEBUG_SCOPE_HEADER_SIZE - MCL_DEBUG_SCOPE_CHECKSUM_SIZE) / scope->record_size;
+
+    return mcl_success;
+}
+
+hpm_mcl_stat_t hpm_mcl_debug_scope_start(mcl_debug_scope_t *scope)
+{
+    uint8_t i;
+    uint8_t *desc;
+
+    MCL_ASSERT(scope != NULL, mcl_invalid_pointer);
+    MCL_ASSERT(scope->chn_num > 0, mcl_fail);
+    MCL_ASSERT((scope->cfg->trigger.mode == mcl_debug_trigger_none) || (scope->cfg->trigger.chn < scope->chn_num),
+        mcl_invalid_argument);
+    /* the interrupt ignores the scope while idle */
+    scope->state = mcl_debug_scope_idle;
+    MCL_DEBUG_SCOPE_BARRIER();
+    scope->half[0].state = mcl_debug_scope_half_free;
+    scope->half[1].state = mcl_debug_scope_half_free;
+    scope->fill = 0;
+    scope->drain = 0;
+    scope->stop_request = false;
+    scope->decimation_cnt = 0;
+    scope->seq = 0;
+    scope->index = 0;
+    scope->lost = 0;
+    scope->remain = scope->cfg->record_num;
+    scope->trigger_last_valid = false;
+
+    desc = scope->descriptor;
+    desc[0] = MCL_DEBUG_SCOPE_SYNC0;
+    desc[1] = MCL_DEBUG_SCOPE_SYNC1;
+    desc[2] = MCL_DEBUG_SCOPE_FRAME_DESCRIPTOR;
+    desc[3] = scope->chn_num;
+    hpm_mcl_debug_scope_put_u16(&desc[4], scope->cfg->decimation > 1 ? scope->cfg->decimation : 1);
+    hpm_mcl_debug_scope_put_u16(&desc[6], 0);
+    for (i = 0; i < scope->chn_num; i++) {
+        desc[8 + i] = scope->chn[i].type >> 8;
+    }
+    hpm_mcl_debug_scope_checksum(desc, 8 + scope->chn_num + MCL_DEBUG_SCOPE_CHECKSUM_SIZE);
+    scope->descriptor_pending = true;
+    scope->descriptor_out = false;
+    MCL_DEBUG_SCOPE_BARRIER();
+    scope->state = (scope->cfg->trigger.mode == mcl_debug_trigger_none) ? mcl_debug_scope_running : mcl_debug_scope_armed;
+
+    return mcl_success;
+}
+
+void hpm_mcl_debug_scope_stop(mcl_debug_scope_t *scope)
+{
+    scope->stop_request = true;
+}
+
+static void hpm_mcl_debug_scope_seal(mcl_debug_scope_t *scope, mcl_debug_scope_half_t *half, uint16_t flags)
+{
+    uint8_t *buf = half->buf;
+
+    half->flags |= flags;
+    buf[0] = MCL_DEBUG_SCOPE_SYNC0;
+    buf[1] = MCL_DEBUG_SCOPE_SYNC1;
+    buf[2] = MCL_DEBUG_SCOPE_FRAME_DATA;
+    buf[3] = scope->chn_num;
+    hpm_mcl_debug_scope_put_u16(&buf[4], scope->seq++);
+    hpm_mcl_debug_scope_put_u16(&buf[6], half->record_num);
+    hpm_mcl_debug_scope_put_u32(&buf[8], half->first_index);
+    hpm_mcl_debug_scope_put_u16(&buf[12], half->flags);
+    hpm_mcl_debug_scope_put_u16(&buf[14], half->lost);
+    MCL_DEBUG_SCOPE_BARRIER();
+    half->state = mcl_debug_scope_half_ready;
+    scope->fill ^= 1;
+}
+
+void hpm_mcl_debug_scope_sample(mcl_debug_scope_t *scope)
+{
+    uint8_t i;
+    uint8_t *dst;
+    float val;
+    bool hit;
+    uint16_t flags = 0;
+    mcl_debug_scope_half_t *half;
+
+    if ((scope->state != mcl_debug_scope_armed) && (scope->state != mcl_debug_scope_running)) {
+        return;
+    }
+    half = &scope->half[scope->fill];
+    if (scope->stop_request) {
+        if (half->state == mcl_debug_scope_half_filling) {
+            hpm_mcl_debug_scope_seal(scope, half, MCL_DEBUG_SCOPE_FLAG_LAST);
+        }
+        scope->state = mcl_debug_scope_done;
+        return;
+    }
+    if (++scope->decimation_cnt < scope->cfg->decimation) {
+        return;
+    }
+    scope->decimation_cnt = 0;
+
+    if (scope->state == mcl_debug_scope_armed) {
+        val = hpm_mcl_debug_scope_read_float(&scope->chn[scope->cfg->trigger.chn]);
+        hit = false;
+        if (scope->trigger_last_valid) {
+            if ((scope->cfg->trigger.mode & mcl_debug_trigger_rising) &&
+                (scope->trigger_last < scope->cfg->trigger.level) && (val >= scope->cfg->trigger.level)) {
+                hit = true;
+            }
+            if ((scope->cfg->trigger.mode & mcl_debug_trigger_falling) &&
+                (scope->trigger_last > scope->cfg->trigger.level) && (val <= scope->cfg->trigger.level)) {
+                hit = true;
+            }
+        }
+        scope->trigger_last = val;
+        scope->trigger_last_valid = true;
+        if (!hit) {
+            return;
+        }
+        scope->state = mcl_debug_scope_running;
+        flags = MCL_DEBUG_SCOPE_FLAG_TRIGGER;
+    }
+
+    if (half->state != mcl_debug_scope_half_filling) {
+        if (half->state != mcl_debug_scope_half_free) {
+            /* both halves wait for the drain */
+            scope->lost++;
+            scope->index++;
+            return;
+        }
+        half->record_num = 0;
+        half->first_index = scope->index;
+        half->flags = flags;
+        half->lost = scope->lost > 0xffff ? 0xffff : scope->lost;
+        if (scope->lost != 0) {
+            half->flags |= MCL_DEBUG_SCOPE_FLAG_LOST;
+        }
+        scope->lost = 0;
+        half->state = mcl_debug_scope_half_filling;
+    }
+
+    dst = half->buf + MCL_DEBUG_SCOPE_HEADER_SIZE + half->record_num * scope->record_size;
+    for (i = 0; i < scope->chn_num; i++) {
+        switch (MCL_DEBUG_DATA_TYPE_GET_SIZE(scope->chn[i].type)) {
+        case 1:
+            *dst = *(uint8_t *)scope->chn[i].addr;
+            dst += 1;
+            break;
+        case 2:
+            memcpy(dst, scope->chn[i].addr, 2);
+            dst += 2;
+            break;
+        default:
+            memcpy(dst, scope->chn[i].addr, 4);
+            dst += 4;
+            break;
+        }
+    }
+    half->record_num++;
+    scope->index++;
+
+    if ((scope->cfg->record_num != 0) && (--scope->remain == 0)) {
+        hpm_mcl_debug_scope_seal(scope, half, MCL_DEBUG_SCOPE_FLAG_LAST);
+        scope->state = mcl_debug_scope_done;
+    } else if (half->record_num >= scope->record_per_frame) {
+        hpm_mcl_debug_scope_seal(scope, half, 0);
+    }
+}
+
+bool hpm_mcl_debug_scope_get_frame(mcl_debug_scope_t *scope, uint8_t **buf, uint32_t *len)
+{
+    mcl_debug_scope_half_t *half;
+
+    if (scope->descriptor_pending) {
+        scope->descriptor_out = true;
+        *buf = scope->descriptor;
+        *len = 8 + scope->chn_num + MCL_DEBUG_SCOPE_CHECKSUM_SIZE;
+        return true;
+    }
+    half = &scope->half[scope->drain];
+    if (half->state != mcl_debug_scope_half_ready) {
+        return false;
+    }
+    MCL_DEBUG_SCOPE_BARRIER();
+    *buf = half->buf;
+    *len = MCL_DEBUG_SCOPE_HEADER_SIZE + half->record_num * scope->record_size + MCL_DEBUG_SCOPE_CHECKSUM_SIZE;
+    /* checksum outside the interrupt, the half belongs to the background until released */
+    hpm_mcl_debug_scope_checksum(*buf, *len);
+
+    return true;
+}
+
+void hpm_mcl_debug_scope_release_frame(mcl_debug_scope_t *scope)
+{
+    if (scope->descriptor_out) {
+        scope->descriptor_out = false;
+        scope->descriptor_pending = false;
+        return;
+    }
+    MCL_DEBUG_SCOPE_BARRIER();
+    scope->half[scope->drain].state = mcl_debug_scope_half_free;
+    scope->drain ^= 1;
+}
+
+uint32_t hpm_mcl_debug_scope_drain(mcl_debug_scope_t *scope)
+{
+    uint8_t *buf;
+    uint32_t len;
+    uint32_t num = 0;
+
+    while (hpm_mcl_debug_scope_get_frame(scope, &buf, &len)) {
+        scope->cfg->callback.write_buf(buf, len);
+        hpm_mcl_debug_scope_release_frame(scope);
+        num++;
+    }
+
+    return num;
+}
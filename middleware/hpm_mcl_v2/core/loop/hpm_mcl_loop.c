@@ -109,13 +109,16 @@ hpm_mcl_stat_t hpm_mcl_loop_disable_all_user_set_value(mcl_loop_t *loop)
 
 hpm_mcl_stat_t hpm_mcl_detect_offline_para(mcl_loop_t *loop)
 {
-    float ia, ib, ic;
+    float ia_fp, ib_fp;
     float theta;
-    float alpha, beta;
-    float sinx, cosx;
-    float sens_d, sens_q;
+    float alpha_fp, beta_fp;
     float ref_d = 0, ref_q = 0;
     float ud, uq;
+    hpm_mcl_type_t ia, ib, ic;
+    hpm_mcl_type_t alpha, beta;
+    hpm_mcl_type_t sinx, cosx;
+    hpm_mcl_type_t sens_d, sens_q;
+    hpm_mcl_type_t ud_pi, uq_pi;
     hpm_mcl_stat_t status;
     mcl_control_svpwm_duty_t duty;
     mcl_control_dead_area_pwm_offset_t duty_offset;
@@ -129,18 +132,22 @@ hpm_mcl_stat_t hpm_mcl_detect_offline_para(mcl_loop_t *loop)
 
     MCL_ASSERT_OPT(loop != NULL, mcl_invalid_pointer);
     if (loop->cfg->enable_offline_param_detection) {
-        MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_get_value(loop->analog, analog_a_current, &ia), loop->status, loop_status_fail);
-        MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_get_value(loop->analog, analog_b_current, &ib), loop->status, loop_status_fail);
+        MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_get_value(loop->analog, analog_a_current, &ia_fp), loop->status, loop_status_fail);
+        MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_get_value(loop->analog, analog_b_current, &ib_fp), loop->status, loop_status_fail);
         if (loop->rundata.offline_detection.mode == offline_param_detection_mode_flux) {
             theta = hpm_mcl_encoder_get_theta(loop->encoder);
         } else {
             theta = 0;
         }
-        ic = -(ia + ib);
-        sinx = loop->control->method.sin_x(theta);
-        cosx = loop->control->method.cos_x(theta);
+        ia = MCL_MATH_FLOAT_TO_TYPE(ia_fp);
+        ib = MCL_MATH_FLOAT_TO_TYPE(ib_fp);
+        ic = MCL_MATH_NEG(MCL_MATH_ADD(ia, ib));
+        sinx = loop->control->method.sin_x(MCL_MATH_FLOAT_TO_TYPE(theta));
+        cosx = loop->control->method.cos_x(MCL_MATH_FLOAT_TO_TYPE(theta));
         loop->control->method.clarke(ia, ib, ic, &alpha, &beta);
         loop->control->method.park(alpha, beta, sinx, cosx, &sens_d, &sens_q);
+        alpha_fp = MCL_MATH_CONVERT_FLOAT(alpha);
+        beta_fp = MCL_MATH_CONVERT_FLOAT(beta);
         uq = 0;
         ud = 0;
         switch (loop->rundata.offline_detection.mode) {
@@ -180,11 +187,11 @@ hpm_mcl_stat_t hpm_mcl_detect_offline_para(mcl_loop_t *loop)
                     break;
                 case offline_param_detection_mode_flux:
                     loop->rundata.offline_detection.result = loop->control->cfg->offline_param_detection_cfg.result;
-                    if (MCL_MATH_IS_ZERO(loop->rundata.offline_detection.result.rs) ||
-                        MCL_MATH_IS_ZERO(loop->rundata.offline_detection.result.ls) ||
-                        MCL_MATH_IS_ZERO(loop->rundata.offline_detection.result.flux) ||
-                        MCL_MATH_IS_ZERO(loop->rundata.offline_detection.result.lq) ||
-                        MCL_MATH_IS_ZERO(loop->rundata.offline_detection.result.ld) ||
+                    if (MCL_FLOAT_IS_ZERO(loop->rundata.offline_detection.result.rs) ||
+                        MCL_FLOAT_IS_ZERO(loop->rundata.offline_detection.result.ls) ||
+                        MCL_FLOAT_IS_ZERO(loop->rundata.offline_detection.result.flux) ||
+                        MCL_FLOAT_IS_ZERO(loop->rundata.offline_detection.result.lq) ||
+                        MCL_FLOAT_IS_ZERO(loop->rundata.offline_detection.result.ld) ||
                         MCL_FLOAT_IS_INFINITY(loop->rundata.offline_detection.result.ld) ||
                         MCL_FLOAT_IS_INFINITY(loop->rundata.offline_detection.result.flux) ||
                         MCL_FLOAT_IS_INFINITY(loop->rundata.offline_detection.result.lq) ||
@@ -204,7 +211,7 @@ hpm_mcl_stat_t hpm_mcl_detect_offline_para(mcl_loop_t *loop)
             }
             break;
         case offline_param_detection_mode_rs:
-            status = loop->control->method.offline_param_detection_rs(&loop->control->cfg->offline_param_detection_cfg, alpha, beta, &ud, &uq);
+            status = loop->control->method.offline_param_detection_rs(&loop->control->cfg->offline_param_detection_cfg, alpha_fp, beta_fp, &ud, &uq);
             if (status == mcl_success) {
                 loop->rundata.offline_detection.mode = offline_param_detection_mode_wait;
                 loop->rundata.offline_detection.last_mode = offline_param_detection_mode_rs;
@@ -213,13 +220,13 @@ hpm_mcl_stat_t hpm_mcl_detect_offline_para(mcl_loop_t *loop)
             }
             break;
         case offline_param_detection_mode_ld:
-            if (loop->control->method.offline_param_detection_ld(&loop->control->cfg->offline_param_detection_cfg, alpha, beta, &ud, &uq) == mcl_success) {
+            if (loop->control->method.offline_param_detection_ld(&loop->control->cfg->offline_param_detection_cfg, alpha_fp, beta_fp, &ud, &uq) == mcl_success) {
                 loop->rundata.offline_detection.mode = offline_param_detection_mode_wait;
                 loop->rundata.offline_detection.last_mode = offline_param_detection_mode_ld;
             }
             break;
         case offline_param_detection_mode_lq:
-            if (loop->control->method.offline_param_detection_lq(&loop->control->cfg->offline_param_detection_cfg, alpha, beta, &ud, &uq) == mcl_success) {
+            if (loop->control->method.offline_param_detection_lq(&loop->control->cfg->offline_param_detection_cfg, alpha_fp, beta_fp, &ud, &uq) == mcl_success) {
                 loop->rundata.offline_detection.mode = offline_param_detection_mode_wait;
                 loop->rundata.offline_detection.last_mode = offline_param_detection_mode_lq;
             }
@@ -231,7 +238,7 @@ hpm_mcl_stat_t hpm_mcl_detect_offline_para(mcl_loop_t *loop)
             }
             break;
         case offline_param_detection_mode_flux:
-            status = loop->control->method.offline_param_detection_flux(&loop->control->cfg->offline_param_detection_cfg, alpha, beta,
+            status = loop->control->method.offline_param_detection_flux(&loop->control->cfg->offline_param_detection_cfg, alpha_fp, beta_fp,
                 loop->rundata.offline_detection.last_ualpha, loop->rundata.offline_detection.last_ubeta, &ref_d, &ref_q);
             if (status == mcl_success) {
                 loop->rundata.offline_detection.mode = offline_param_detection_mode_wait;
@@ -239,8 +246,10 @@ hpm_mcl_stat_t hpm_mcl_detect_offline_para(mcl_loop_t *loop)
             } else if (status == status_fail) {
                 loop->rundata.offline_detection.mode = offline_param_detection_mode_error;
             }
-            loop->control->method.currentd_pid(ref_d, sens_d, &loop->control->cfg->currentd_pid_cfg, &ud);
-            loop->control->method.currentq_pid(ref_q, sens_q, &loop->control->cfg->currentq_pid_cfg, &uq);
+            loop->control->method.currentd_pid(MCL_MATH_FLOAT_TO_TYPE(ref_d), sens_d, &loop->control->cfg->currentd_pid_cfg, &ud_pi);
+            loop->control->method.currentq_pid(MCL_MATH_FLOAT_TO_TYPE(ref_q), sens_q, &loop->control->cfg->currentq_pid_cfg, &uq_pi);
+            ud = MCL_MATH_CONVERT_FLOAT(ud_pi);
+            uq = MCL_MATH_CONVERT_FLOAT(uq_pi);
             break;
         case offline_param_detection_mode_end:
         case offline_param_detection_mode_error:
@@ -249,37 +258,78 @@ hpm_mcl_stat_t hpm_mcl_detect_offline_para(mcl_loop_t *loop)
             loop->rundata.offline_detection.mode = offline_param_detection_mode_init;
             break;
         }
-        loop->control->method.invpark(ud, uq, sinx, cosx, &alpha, &beta);
+        loop->control->method.invpark(MCL_MATH_FLOAT_TO_TYPE(ud), MCL_MATH_FLOAT_TO_TYPE(uq), sinx, cosx, &alpha, &beta);
         loop->control->method.svpwm(alpha, beta, *loop->const_vbus, &duty);
-        loop->rundata.offline_detection.last_ualpha = alpha;
-        loop->rundata.offline_detection.last_ualpha = beta;
-        loop->control->method.dead_area_polarity_detection(&loop->control->cfg->dead_area_compensation_cfg, sens_d, sens_q, theta,
+        loop->rundata.offline_detection.last_ualpha = MCL_MATH_CONVERT_FLOAT(alpha);
+        loop->rundata.offline_detection.last_ualpha = MCL_MATH_CONVERT_FLOAT(beta);
+        loop->control->method.dead_area_polarity_detection(&loop->control->cfg->dead_area_compensation_cfg,
+                                                MCL_MATH_CONVERT_FLOAT(sens_d), MCL_MATH_CONVERT_FLOAT(sens_q), theta,
                                                 loop->const_time.dead_area_ts, *loop->const_time.current_ts, &duty_offset);
-        duty.a += duty_offset.a_offset;
-        duty.b += duty_offset.b_offset;
-        duty.c += duty_offset.c_offset;
+        duty.a = MCL_MATH_ADD(duty.a, MCL_MATH_FLOAT_TO_TYPE(duty_offset.a_offset));
+        duty.b = MCL_MATH_ADD(duty.b, MCL_MATH_FLOAT_TO_TYPE(duty_offset.b_offset));
+        duty.c = MCL_MATH_ADD(duty.c, MCL_MATH_FLOAT_TO_TYPE(duty_offset.c_offset));
     } else {
         duty.a = 0;
         duty.b = 0;
         duty.c = 0;
     }
-    hpm_mcl_drivers_update_bldc_duty(loop->drivers, duty.a, duty.b, duty.c);
+    hpm_mcl_drivers_update_bldc_duty(loop->drivers, MCL_MATH_CONVERT_FLOAT(duty.a),
+                                    MCL_MATH_CONVERT_FLOAT(duty.b), MCL_MATH_CONVERT_FLOAT(duty.c));
     return  mcl_success;
 }
 
-hpm_mcl_stat_t hpm_mcl_current_foc_loop(mcl_loop_t *loop)
+hpm_mcl_stat_t hpm_mcl_loop_outer_ref(mcl_loop_t *loop, hpm_mcl_type_t *ref_d, hpm_mcl_type_t *ref_q, hpm_mcl_type_t *sens_speed)
 {
-    float ref_speed = 0;
-    float sens_speed;
-    float ref_position = 0;
-    float ia, ib, ic;
-    float theta;
-    float alpha, beta;
-    float sinx, cosx;
-    float sens_d, sens_q;
-    float ref_d = 0, ref_q = 0;
-    float ud, uq;
+    hpm_mcl_type_t ref_speed = 0;
+    hpm_mcl_type_t ref_position = 0;
     float theta_abs;
+
+    *sens_speed = 0;
+    if (loop->cfg->enable_position_loop) {
+        loop->time.position_ts += *loop->const_time.current_ts;
+        MCL_FUNCTION_SET_IF_ELSE_TRUE(loop->ref_position.enable, ref_position, MCL_MATH_FLOAT_TO_TYPE(loop->ref_position.value), loop->exec_ref.position);
+        if (loop->time.position_ts >= *loop->const_time.position_ts) {
+            loop->time.position_ts = 0;
+            MCL_ASSERT_EXEC_CODE_AND_RETURN(hpm_mcl_encoder_get_absolute_theta(loop->encoder, &theta_abs) == mcl_success,
+            loop->status = loop_status_fail, mcl_fail);
+            loop->control->method.position_pid(ref_position, MCL_MATH_FLOAT_TO_TYPE(theta_abs), &loop->control->cfg->position_pid_cfg, &loop->exec_ref.speed);
+        }
+    } else {
+        loop->exec_ref.speed = 0;
+        loop->time.position_ts = 0;
+    }
+    if (loop->cfg->enable_speed_loop) {
+        loop->time.speed_ts += *loop->const_time.current_ts;
+        MCL_FUNCTION_SET_IF_ELSE_TRUE(loop->ref_speed.enable, ref_speed, MCL_MATH_FLOAT_TO_TYPE(loop->ref_speed.value), loop->exec_ref.speed);
+        if (loop->time.speed_ts >= *loop->const_time.speed_ts) {
+            loop->time.speed_ts = 0;
+            *sens_speed = MCL_MATH_FLOAT_TO_TYPE(hpm_mcl_encoder_get_speed(loop->encoder));
+            loop->control->method.speed_pid(ref_speed, *sens_speed,
+            &loop->control->cfg->speed_pid_cfg, &loop->exec_ref.iq);
+        }
+    } else {
+        loop->time.speed_ts = 0;
+        loop->exec_ref.iq = 0;
+    }
+    MCL_VALUE_SET_IF_TRUE(loop->ref_id.enable, *ref_d, MCL_MATH_FLOAT_TO_TYPE(loop->ref_id.value));
+    MCL_FUNCTION_SET_IF_ELSE_TRUE(loop->ref_iq.enable, *ref_q, MCL_MATH_FLOAT_TO_TYPE(loop->ref_iq.value), loop->exec_ref.iq);
+
+    return mcl_success;
+}
+
+hpm_mcl_stat_t hpm_mcl_current_foc_loop(mcl_loop_t *loop)
+{
+    hpm_mcl_type_t sens_speed = 0;
+    float ia_fp, ib_fp;
+    float theta_fp;
+    hpm_mcl_type_t ia, ib, ic;
+    hpm_mcl_type_t theta;
+    hpm_mcl_type_t alpha, beta;
+    hpm_mcl_type_t sinx, cosx;
+    hpm_mcl_type_t sens_d, sens_q;
+    hpm_mcl_type_t ref_d = 0, ref_q = 0;
+    hpm_mcl_type_t ud, uq;
+    hpm_mcl_stat_t status;
     mcl_hardware_clc_cfg_t *clc_cfg;
     mcl_control_svpwm_duty_t duty;
 #if defined(MCL_CFG_EN_DEAD_AREA_COMPENSATION) && MCL_CFG_EN_DEAD_AREA_COMPENSATION
@@ -287,57 +337,36 @@ hpm_mcl_stat_t hpm_mcl_current_foc_loop(mcl_loop_t *loop)
 #endif
 
 #if defined(MCL_CFG_EN_THETA_FORECAST) && MCL_CFG_EN_THETA_FORECAST
-    float sinx_, cosx_;
-    float theta_forecast;
+    hpm_mcl_type_t sinx_, cosx_;
+    hpm_mcl_type_t theta_forecast;
 #endif
 
     MCL_ASSERT_OPT(loop != NULL, mcl_invalid_pointer);
-    theta = hpm_mcl_encoder_get_theta(loop->encoder);
+    theta_fp = hpm_mcl_encoder_get_theta(loop->encoder);
+    theta = MCL_MATH_FLOAT_TO_TYPE(theta_fp);
 #if defined(MCL_CFG_EN_THETA_FORECAST) && MCL_CFG_EN_THETA_FORECAST
-    theta_forecast = hpm_mcl_encoder_get_forecast_theta(loop->encoder);
+    theta_forecast = MCL_MATH_FLOAT_TO_TYPE(hpm_mcl_encoder_get_forecast_theta(loop->encoder));
 #endif
     if (loop->enable) {
-        if (loop->cfg->enable_position_loop) {
-            loop->time.position_ts += *loop->const_time.current_ts;
-            MCL_FUNCTION_SET_IF_ELSE_TRUE(loop->ref_position.enable, ref_position, loop->ref_position.value, loop->exec_ref.position);
-            if (loop->time.position_ts >= *loop->const_time.position_ts) {
-                loop->time.position_ts = 0;
-                MCL_ASSERT_EXEC_CODE_AND_RETURN(hpm_mcl_encoder_get_absolute_theta(loop->encoder, &theta_abs) == mcl_success,
-                loop->status = loop_status_fail, mcl_fail);
-                loop->control->method.position_pid(ref_position, theta_abs, &loop->control->cfg->position_pid_cfg, &loop->exec_ref.speed);
-            }
-        } else {
-            loop->exec_ref.speed = 0;
-            loop->time.position_ts = 0;
-        }
-        if (loop->cfg->enable_speed_loop) {
-            loop->time.speed_ts += *loop->const_time.current_ts;
-            MCL_FUNCTION_SET_IF_ELSE_TRUE(loop->ref_speed.enable, ref_speed, loop->ref_speed.value, loop->exec_ref.speed);
-            if (loop->time.speed_ts >= *loop->const_time.speed_ts) {
-                loop->time.speed_ts = 0;
-                sens_speed = hpm_mcl_encoder_get_speed(loop->encoder);
-                loop->control->method.speed_pid(ref_speed, sens_speed,
-                &loop->control->cfg->speed_pid_cfg, &loop->exec_ref.iq);
-            }
-        } else {
-            loop->time.speed_ts = 0;
-            loop->exec_ref.iq = 0;
+        status = hpm_mcl_loop_outer_ref(loop, &ref_d, &ref_q, &sens_speed);
+        if (status != mcl_success) {
+            return status;
         }
-        MCL_VALUE_SET_IF_TRUE(loop->ref_id.enable, ref_d, loop->ref_id.value);
-        MCL_FUNCTION_SET_IF_ELSE_TRUE(loop->ref_iq.enable, ref_q, loop->ref_iq.value, loop->exec_ref.iq);
         switch (loop->cfg->mode) {
         case mcl_mode_foc:
             /**
              * @brief current sample
              *
              */
-            MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_get_value(loop->analog, analog_a_current, &ia), loop->status, loop_status_fail);
-            MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_get_value(loop->analog, analog_b_current, &ib), loop->status, loop_status_fail);
-            ic = -(ia + ib);
+            MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_get_value(loop->analog, analog_a_current, &ia_fp), loop->status, loop_status_fail);
+            MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_get_value(loop->analog, analog_b_current, &ib_fp), loop->status, loop_status_fail);
+            ia = MCL_MATH_FLOAT_TO_TYPE(ia_fp);
+            ib = MCL_MATH_FLOAT_TO_TYPE(ib_fp);
+            ic = MCL_MATH_NEG(MCL_MATH_ADD(ia, ib));
             loop->control->method.clarke(ia, ib, ic, &alpha, &beta);
 #if defined(MCL_CFG_EN_SENSORLESS_SMC) && MCL_CFG_EN_SENSORLESS_SMC
             loop->control->method.smc_process(&loop->control->cfg->smc_cfg, loop->control->cfg->smc_cfg.ualpha,
-                loop->control->cfg->smc_cfg.ubeta, alpha, beta);
+                loop->control->cfg->smc_cfg.ubeta, MCL_MATH_CONVERT_FLOAT(alpha), MCL_MATH_CONVERT_FLOAT(beta));
 #endif
             sinx = loop->control->method.sin_x(theta);
             cosx = loop->control->method.cos_x(theta);
@@ -347,8 +376,9 @@ hpm_mcl_stat_t hpm_mcl_current_foc_loop(mcl_loop_t *loop)
 #if defined(MCL_CFG_EN_DQ_AXIS_DECOUPLING) && MCL_CFG_EN_DQ_AXIS_DECOUPLING
             if (loop->cfg->enable_dq_axis_decoupling) {
                 if (loop->cfg->enable_speed_loop) {
-                    ud -= sens_q * sens_speed * (*loop->encoder->pole_num) * (*loop->lq);
-                    uq += sens_speed * (*loop->encoder->pole_num) * (*loop->ld * sens_q + *loop->flux);
+                    ud = MCL_MATH_SUB(ud, MCL_MATH_MUL(MCL_MATH_MUL_INT(MCL_MATH_MUL(sens_q, sens_speed), (*loop->encoder->pole_num)), (*loop->lq)));
+                    uq = MCL_MATH_ADD(uq, MCL_MATH_MUL(MCL_MATH_MUL_INT(sens_speed, (*loop->encoder->pole_num)),
+                                                        MCL_MATH_ADD(MCL_MATH_MUL(*loop->ld, sens_q), *loop->flux)));
                 }
             }
 #endif
@@ -361,82 +391,78 @@ hpm_mcl_stat_t hpm_mcl_current_foc_loop(mcl_loop_t *loop)
 #endif
 
 #if defined(MCL_CFG_EN_SENSORLESS_SMC) && MCL_CFG_EN_SENSORLESS_SMC
-            loop->control->cfg->smc_cfg.ualpha = alpha;
-            loop->control->cfg->smc_cfg.ubeta = beta;
+            loop->control->cfg->smc_cfg.ualpha = MCL_MATH_CONVERT_FLOAT(alpha);
+            loop->control->cfg->smc_cfg.ubeta = MCL_MATH_CONVERT_FLOAT(beta);
 #endif
             loop->control->method.svpwm(alpha, beta, *loop->const_vbus, &duty);
 #if defined(MCL_CFG_EN_DEAD_AREA_COMPENSATION) && MCL_CFG_EN_DEAD_AREA_COMPENSATION
             if (loop->cfg->enable_dead_area_compensation) {
-                loop->control->method.dead_area_polarity_detection(&loop->control->cfg->dead_area_compensation_cfg, sens_d, sens_q, theta, loop->const_time.dead_area_ts,
-                                                                    *loop->const_time.current_ts, &duty_offset);
-                duty.a += duty_offset.a_offset;
-                duty.b += duty_offset.b_offset;
-                duty.c += duty_offset.c_offset;
+                loop->control->method.dead_area_polarity_detection(&loop->control->cfg->dead_area_compensation_cfg,
+                                                                    MCL_MATH_CONVERT_FLOAT(sens_d), MCL_MATH_CONVERT_FLOAT(sens_q), theta_fp,
+                                                                    loop->const_time.dead_area_ts, *loop->const_time.current_ts, &duty_offset);
+                duty.a = MCL_MATH_ADD(duty.a, MCL_MATH_FLOAT_TO_TYPE(duty_offset.a_offset));
+                duty.b = MCL_MATH_ADD(duty.b, MCL_MATH_FLOAT_TO_TYPE(duty_offset.b_offset));
+                duty.c = MCL_MATH_ADD(duty.c, MCL_MATH_FLOAT_TO_TYPE(duty_offset.c_offset));
             }
 #endif
-            hpm_mcl_drivers_update_bldc_duty(loop->drivers, duty.a, duty.b, duty.c);
+            hpm_mcl_drivers_update_bldc_duty(loop->drivers, MCL_MATH_CONVERT_FLOAT(duty.a),
+                                            MCL_MATH_CONVERT_FLOAT(duty.b), MCL_MATH_CONVERT_FLOAT(duty.c));
 
             break;
         case mcl_mode_hardware_foc:
             clc_cfg = (mcl_hardware_clc_cfg_t *)loop->hardware;
-            clc_cfg->clc_set_val(loop_chn_id, clc_cfg->convert_float_to_clc_val(ref_d));
-            clc_cfg->clc_set_val(loop_chn_iq, clc_cfg->convert_float_to_clc_val(ref_q));
+            clc_cfg->clc_set_val(loop_chn_id, clc_cfg->convert_float_to_clc_val(MCL_MATH_CONVERT_FLOAT(ref_d)));
+            clc_cfg->clc_set_val(loop_chn_iq, clc_cfg->convert_float_to_clc_val(MCL_MATH_CONVERT_FLOAT(ref_q)));
             break;
         default:
             break;
         }
     } else {
-        duty.a = 0;
-        duty.b = 0;
-        duty.c = 0;
-        hpm_mcl_drivers_update_bldc_duty(loop->drivers, duty.a, duty.b, duty.c);
+        hpm_mcl_drivers_update_bldc_duty(loop->drivers, 0, 0, 0);
     }
     return  mcl_success;
 }
 
 hpm_mcl_stat_t hpm_mcl_step_foc_loop(mcl_loop_t *loop)
 {
-    float ia, ib;
-    float theta;
-    float alpha, beta;
-    float sinx, cosx;
-    float sens_d, sens_q;
-    float ref_d = 0;
-    float ud, uq;
-    float sinx_, cosx_;
-    float theta_;
+    float ia_fp, ib_fp;
+    float theta_fp;
+    float theta_next;
+    hpm_mcl_type_t alpha, beta;
+    hpm_mcl_type_t sinx, cosx;
+    hpm_mcl_type_t sens_d, sens_q;
+    hpm_mcl_type_t ref_d = 0;
+    hpm_mcl_type_t ud, uq;
+    hpm_mcl_type_t sinx_, cosx_;
     mcl_control_svpwm_duty_t duty;
 
     MCL_ASSERT_OPT(loop != NULL, mcl_invalid_pointer);
-    theta =  hpm_mcl_path_get_current_theta(loop->path);
-    theta_ = MCL_ANGLE_MOD_X(0, MCL_PI * 2, (hpm_mcl_path_get_next_theta(loop->path) - (0.25f * MCL_PI)));
+    theta_fp =  hpm_mcl_path_get_current_theta(loop->path);
+    theta_next = MCL_ANGLE_MOD_X(0, MCL_PI * 2, (hpm_mcl_path_get_next_theta(loop->path) - (0.25f * MCL_PI)));
 
     if (loop->enable) {
-        MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_get_value(loop->analog, analog_a_current, &ia), loop->status, loop_status_fail);
-        MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_get_value(loop->analog, analog_b_current, &ib), loop->status, loop_status_fail);
-        MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_step_convert(loop->analog, ia, analog_a_current, theta, &ia), loop->status, loop_status_fail);
-        MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_step_convert(loop->analog, ib, analog_b_current, theta, &ib), loop->status, loop_status_fail);
-
-        theta =  MCL_ANGLE_MOD_X(0, MCL_PI * 2, (theta - (0.25f * MCL_PI)));
-        MCL_VALUE_SET_IF_TRUE(loop->ref_id.enable, ref_d, loop->ref_id.value);
-        alpha = ia;
-        beta = ib;
-        sinx = loop->control->method.sin_x(theta);
-        cosx = loop->control->method.cos_x(theta);
+        MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_get_value(loop->analog, analog_a_current, &ia_fp), loop->status, loop_status_fail);
+        MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_get_value(loop->analog, analog_b_current, &ib_fp), loop->status, loop_status_fail);
+        MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_step_convert(loop->analog, ia_fp, analog_a_current, theta_fp, &ia_fp), loop->status, loop_status_fail);
+        MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_step_convert(loop->analog, ib_fp, analog_b_current, theta_fp, &ib_fp), loop->status, loop_status_fail);
+
+        theta_fp =  MCL_ANGLE_MOD_X(0, MCL_PI * 2, (theta_fp - (0.25f * MCL_PI)));
+        MCL_VALUE_SET_IF_TRUE(loop->ref_id.enable, ref_d, MCL_MATH_FLOAT_TO_TYPE(loop->ref_id.value));
+        alpha = MCL_MATH_FLOAT_TO_TYPE(ia_fp);
+        beta = MCL_MATH_FLOAT_TO_TYPE(ib_fp);
+        sinx = loop->control->method.sin_x(MCL_MATH_FLOAT_TO_TYPE(theta_fp));
+        cosx = loop->control->method.cos_x(MCL_MATH_FLOAT_TO_TYPE(theta_fp));
         loop->control->method.park(alpha, beta, sinx, cosx, &sens_d, &sens_q);
         loop->control->method.currentd_pid(ref_d, sens_d, &loop->control->cfg->currentd_pid_cfg, &ud);
         loop->control->method.currentq_pid(0, sens_q, &loop->control->cfg->currentq_pid_cfg, &uq);
-        sinx_ = loop->control->method.sin_x(theta_);
-        cosx_ = loop->control->method.cos_x(theta_);
+        sinx_ = loop->control->method.sin_x(MCL_MATH_FLOAT_TO_TYPE(theta_next));
+        cosx_ = loop->control->method.cos_x(MCL_MATH_FLOAT_TO_TYPE(theta_next));
         loop->control->method.invpark(ud, uq, sinx_, cosx_, &alpha, &beta);
         loop->control->method.step_svpwm(alpha, beta, *loop->const_vbus, &duty);
-        hpm_mcl_drivers_update_step_duty(loop->drivers, duty.a0, duty.a1, duty.b0, duty.b1);
+        hpm_mcl_drivers_update_step_duty(loop->drivers, MCL_MATH_CONVERT_FLOAT(duty.a0), MCL_MATH_CONVERT_FLOAT(duty.a1),
+                                        MCL_MATH_CONVERT_FLOAT(duty.b0), MCL_MATH_CONVERT_FLOAT(duty.b1));
     } else {
-        duty.a0 = 0;
-        duty.a1 = 0;
-        duty.b0 = 0;
-        duty.b1 = 0;
-        hpm_mcl_drivers_update_step_duty(loop->drivers, duty.a0, duty.a1, duty.b0, duty.b1);
+        hpm_mcl_drivers_update_step_duty(loop->drivers, 0, 0, 0, 0);
     }
     return  mcl_success;
 }
@@ -445,8 +471,7 @@ hpm_mcl_stat_t hpm_mcl_block_loop(mcl_loop_t *loop)
 {
     hpm_mcl_type_t speed_pi_out;
     float speed_pi_out_fp;
-    float ref_speed = 0;
-    mcl_control_svpwm_duty_t duty;
+    hpm_mcl_type_t ref_speed = 0;
 
     MCL_ASSERT_OPT(loop != NULL, mcl_invalid_pointer);
     if (loop->enable) {
@@ -455,10 +480,10 @@ hpm_mcl_stat_t hpm_mcl_block_loop(mcl_loop_t *loop)
         }
         if (loop->cfg->enable_speed_loop) {
             loop->time.speed_ts += *loop->const_time.speed_ts;
-            MCL_FUNCTION_SET_IF_ELSE_TRUE(loop->ref_speed.enable, ref_speed, loop->ref_speed.value, loop->exec_ref.speed);
+            MCL_FUNCTION_SET_IF_ELSE_TRUE(loop->ref_speed.enable, ref_speed, MCL_MATH_FLOAT_TO_TYPE(loop->ref_speed.value), loop->exec_ref.speed);
             if (loop->time.speed_ts >= *loop->const_time.speed_ts) {
                 loop->time.speed_ts = 0;
-                loop->control->method.speed_pid(ref_speed, hpm_mcl_encoder_get_speed(loop->encoder),
+                loop->control->method.speed_pid(ref_speed, MCL_MATH_FLOAT_TO_TYPE(hpm_mcl_encoder_get_speed(loop->encoder)),
                 &loop->control->cfg->speed_pid_cfg, &speed_pi_out);
             }
         } else {
@@ -471,15 +496,9 @@ hpm_mcl_stat_t hpm_mcl_block_loop(mcl_loop_t *loop)
         } else {
             loop->rundata.block.dir = motor_dir_back;
         }
-        duty.a = speed_pi_out_fp;
-        duty.b = speed_pi_out_fp;
-        duty.c = speed_pi_out_fp;
-        hpm_mcl_drivers_update_bldc_duty(loop->drivers, duty.a, duty.b, duty.c);
+        hpm_mcl_drivers_update_bldc_duty(loop->drivers, speed_pi_out_fp, speed_pi_out_fp, speed_pi_out_fp);
     } else {
-        duty.a = 0;
-        duty.b = 0;
-        duty.c = 0;
-        hpm_mcl_drivers_update_bldc_duty(loop->drivers, duty.a, duty.b, duty.c);
+        hpm_mcl_drivers_update_bldc_duty(loop->drivers, 0, 0, 0);
     }
     return  mcl_success;
 }
@@ -132,10 +132,10 @@ typedef struct {
     mcl_user_value_t ref_speed;
     mcl_user_value_t ref_position;
     struct {
-        float id;
-        float iq;
-        float speed;
-        float position;
+        hpm_mcl_type_t id;
+        hpm_mcl_type_t iq;
+        hpm_mcl_type_t speed;
+        hpm_mcl_type_t position;
     } exec_ref;
     struct {
         float speed_ts;
@@ -145,6 +145,52 @@ typedef struct {
     bool enable;
 } mcl_loop_t;
 
+/**
+ * @brief Several loops whose current loops are run in lockstep, the working data is laid out
+ * per quantity over all axes. Index k counts the axes taken by the batch in the current period.
+ *
+ */
+typedef struct {
+    uint8_t num;
+    mcl_loop_t *loop[MCL_LOOP_BATCH_AXIS_NUM];
+    uint8_t axis[MCL_LOOP_BATCH_AXIS_NUM];  /**< loop index of batch slot k */
+    struct {
+        hpm_mcl_type_t ia[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t ib[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t theta[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t theta_forecast[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t speed_e[MCL_LOOP_BATCH_AXIS_NUM];   /**< speed * pole_num for dq decoupling, 0 if it is off */
+        hpm_mcl_type_t ref_d[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t ref_q[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t vbus[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t ld[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t lq[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t flux[MCL_LOOP_BATCH_AXIS_NUM];
+    } in;
+    struct {
+        hpm_mcl_type_t kp[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t ki[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t integral[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t integral_max[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t integral_min[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t output_max[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t output_min[MCL_LOOP_BATCH_AXIS_NUM];
+    } pid_d, pid_q;
+    struct {
+        hpm_mcl_type_t i_alpha[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t i_beta[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t d[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t q[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t ud[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t uq[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t alpha[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t beta[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t duty_a[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t duty_b[MCL_LOOP_BATCH_AXIS_NUM];
+        hpm_mcl_type_t duty_c[MCL_LOOP_BATCH_AXIS_NUM];
+    } out;
+} mcl_loop_batch_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -218,6 +264,43 @@ hpm_mcl_stat_t hpm_mcl_loop_disable_all_user_set_value(mcl_loop_t *loop);
  */
 hpm_mcl_stat_t hpm_mcl_loop(mcl_loop_t *loop);
 
+/**
+ * @brief Internal use, position and speed loops of a period and the current references they produce
+ *
+ * @param loop @ref mcl_loop_t
+ * @param ref_d d-axis current reference
+ * @param ref_q q-axis current reference
+ * @param sens_speed speed sampled by the speed loop in this period, 0 if the speed loop did not run
+ * @return hpm_mcl_stat_t
+ */
+hpm_mcl_stat_t hpm_mcl_loop_outer_ref(mcl_loop_t *loop, hpm_mcl_type_t *ref_d, hpm_mcl_type_t *ref_q, hpm_mcl_type_t *sens_speed);
+
+/**
+ * @brief Group initialised loops for @ref hpm_mcl_loop_batch
+ *
+ * @param batch @ref mcl_loop_batch_t
+ * @param loop array of loops
+ * @param num number of loops, 1 - MCL_LOOP_BATCH_AXIS_NUM
+ * @return hpm_mcl_stat_t
+ */
+hpm_mcl_stat_t hpm_mcl_loop_batch_init(mcl_loop_batch_t *batch, mcl_loop_t **loop, uint8_t num);
+
+/**
+ * @brief Run all loops of the batch once, call it once per pwm period instead of calling
+ *        @ref hpm_mcl_loop for every axis.
+ *
+ * Enabled axes in mcl_mode_foc run the current loop in lockstep: clarke, park, the current pi,
+ * inverse park and svpwm are evaluated stage by stage over all axes with the built-in algorithms,
+ * callbacks set in mcl_control_method_t are not used. Axes in other modes, disabled axes and axes
+ * with dead area compensation enabled are run by @ref hpm_mcl_loop. Pid gains are
+ * read from each loop every period and the integrals are written back, so an axis can move
+ * between the two paths at any time. A batch of one axis is run by @ref hpm_mcl_loop.
+ *
+ * @param batch @ref mcl_loop_batch_t
+ * @return hpm_mcl_stat_t the last error of any axis
+ */
+hpm_mcl_stat_t hpm_mcl_loop_batch(mcl_loop_batch_t *batch);
+
 /**
  * @brief Call this function in the interrupt function to update the motor's sector
  *
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "hpm_mcl_loop.h"
+
+#define MCL_BATCH_MAX(a, b) (((a) > (b)) ? (a) : (b))
+#define MCL_BATCH_MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+hpm_mcl_stat_t hpm_mcl_loop_batch_init(mcl_loop_batch_t *batch, mcl_loop_t **loop, uint8_t num)
+{
+    uint8_t i;
+
+    MCL_ASSERT(batch != NULL, mcl_invalid_pointer);
+    MCL_ASSERT(loop != NULL, mcl_invalid_pointer);
+    MCL_ASSERT((num > 0) && (num <= MCL_LOOP_BATCH_AXIS_NUM), mcl_invalid_argument);
+    for (i = 0; i < num; i++) {
+        MCL_ASSERT(loop[i] != NULL, mcl_invalid_pointer);
+        batch->loop[i] = loop[i];
+    }
+    batch->num = num;
+
+    return mcl_success;
+}
+
+static bool hpm_mcl_loop_batch_is_lockstep(mcl_loop_t *loop)
+{
+    if ((!loop->enable) || (loop->cfg->mode != mcl_mode_foc)) {
+        return false;
+    }
+#if defined(MCL_CFG_EN_DEAD_AREA_COMPENSATION) && MCL_CFG_EN_DEAD_AREA_COMPENSATION
+    if (loop->cfg->enable_dead_area_compensation) {
+        return false;
+    }
+#endif
+    return true;
+}
+
+static void hpm_mcl_loop_batch_load_pid(mcl_control_pid_t *pid, uint8_t k, hpm_mcl_type_t *kp, hpm_mcl_type_t *ki,
+                                        hpm_mcl_type_t *integral, hpm_mcl_type_t *integral_max, hpm_mcl_type_t *integral_min,
+                                        hpm_mcl_type_t *output_max, hpm_mcl_type_t *output_min)
+{
+    kp[k] = pid->cfg.kp;
+    ki[k] = pid->cfg.ki;
+    integral[k] = pid->integral;
+    integral_max[k] = pid->cfg.integral_max;
+    integral_min[k] = pid->cfg.integral_min;
+    output_max[k] = pid->cfg.output_max;
+    output_min[k] = pid->cfg.output_min;
+}
+
+/**
+ * @brief Sensor reads and outer loops, one axis at a time
+ *
+ */
+static hpm_mcl_stat_t hpm_mcl_loop_batch_gather(mcl_loop_batch_t *batch, uint8_t *num)
+{
+    uint8_t i, k = 0;
+    float ia, ib;
+    hpm_mcl_type_t sens_speed;
+    mcl_loop_t *loop;
+    hpm_mcl_stat_t status = mcl_success;
+    hpm_mcl_stat_t ret = mcl_success;
+
+    for (i = 0; i < batch->num; i++) {
+        loop = batch->loop[i];
+        if (!hpm_mcl_loop_batch_is_lockstep(loop)) {
+            status = hpm_mcl_loop(loop);
+            if (status != mcl_success) {
+                ret = status;
+            }
+            continue;
+        }
+        batch->in.theta[k] = MCL_MATH_FLOAT_TO_TYPE(hpm_mcl_encoder_get_theta(loop->encoder));
+#if defined(MCL_CFG_EN_THETA_FORECAST) && MCL_CFG_EN_THETA_FORECAST
+        batch->in.theta_forecast[k] = MCL_MATH_FLOAT_TO_TYPE(hpm_mcl_encoder_get_forecast_theta(loop->encoder));
+#else
+        batch->in.theta_forecast[k] = batch->in.theta[k];
+#endif
+        batch->in.ref_d[k] = 0;
+        batch->in.ref_q[k] = 0;
+        status = hpm_mcl_loop_outer_ref(loop, &batch->in.ref_d[k], &batch->in.ref_q[k], &sens_speed);
+        if (status != mcl_success) {
+            ret = status;
+            continue;
+        }
+        MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_get_value(loop->analog, analog_a_current, &ia), loop->status, loop_status_fail);
+        MCL_STATUS_SET_IF_TRUE(mcl_success != hpm_mcl_analog_get_value(loop->analog, analog_b_current, &ib), loop->status, loop_status_fail);
+        batch->in.ia[k] = MCL_MATH_FLOAT_TO_TYPE(ia);
+        batch->in.ib[k] = MCL_MATH_FLOAT_TO_TYPE(ib);
+        batch->in.vbus[k] = *loop->const_vbus;
+        batch->in.speed_e[k] = 0;
+#if defined(MCL_CFG_EN_DQ_AXIS_DECOUPLING) && MCL_CFG_EN_DQ_AXIS_DECOUPLING
+        if (loop->cfg->enable_dq_axis_decoupling && loop->cfg->enable_speed_loop) {
+            batch->in.speed_e[k] = MCL_MATH_MUL_INT(sens_speed, (*loop->encoder->pole_num));
+        }
+#else
+        (void)sens_speed;
+#endif
+        batch->in.ld[k] = *loop->ld;
+        batch->in.lq[k] = *loop->lq;
+        batch->in.flux[k] = *loop->flux;
+        hpm_mcl_loop_batch_load_pid(&loop->control->cfg->currentd_pid_cfg, k, batch->pid_d.kp, batch->pid_d.ki, batch->pid_d.integral,
+            batch->pid_d.integral_max, batch->pid_d.integral_min, batch->pid_d.output_max, batch->pid_d.output_min);
+        hpm_mcl_loop_batch_load_pid(&loop->control->cfg->currentq_pid_cfg, k, batch->pid_q.kp, batch->pid_q.ki, batch->pid_q.integral,
+            batch->pid_q.integral_max, batch->pid_q.integral_min, batch->pid_q.output_max, batch->pid_q.output_min);
+        batch->axis[k] = i;
+        k++;
+    }
+    *num = k;
+
+    return ret;
+}
+
+/**
+ * @brief pi over all axes, same arithmetic as hpm_mcl_control_pi
+ *
+ */
+static void hpm_mcl_loop_batch_pi(uint8_t num, const hpm_mcl_type_t *ref, const hpm_mcl_type_t *sens,
+                                  hpm_mcl_type_t *kp, hpm_mcl_type_t *ki, hpm_mcl_type_t *integral,
+                                  hpm_mcl_type_t *integral_max, hpm_mcl_type_t *integral_min,
+                                  hpm_mcl_type_t *output_max, hpm_mcl_type_t *output_min, hpm_mcl_type_t *out)
+{
+    uint8_t k;
+    hpm_mcl_type_t err, val;
+
+    for (k = 0; k < num; k++) {
+        err = MCL_MATH_SUB(ref[k], sens[k]);
+        val = MCL_MATH_ADD(integral[k], MCL_MATH_MUL(ki[k], err));
+        MCL_VALUE_LIMIT(val, integral_min[k], integral_max[k]);
+        integral[k] = val;
+        val = MCL_MATH_ADD(MCL_MATH_MUL(kp[k], err), val);
+        MCL_VALUE_LIMIT(val, output_min[k], output_max[k]);
+        out[k] = val;
+    }
+}
+
+static void hpm_mcl_loop_batch_compute(mcl_loop_batch_t *batch, uint8_t num)
+{
+    uint8_t k;
+    hpm_mcl_type_t s, c;
+    hpm_mcl_type_t va, vb, vc, vmax, vmin, mid, inv;
+#if defined(MCL_CFG_EN_SENSORLESS_SMC) && MCL_CFG_EN_SENSORLESS_SMC
+    mcl_control_t *control;
+#endif
+
+    /* clarke */
+    for (k = 0; k < num; k++) {
+        batch->out.i_alpha[k] = batch->in.ia[k];
+        batch->out.i_beta[k] = MCL_MATH_ADD(MCL_MATH_MUL(MCL_MATH_CONST(SQRT3_DIV3), batch->in.ia[k]),
+                                            MCL_MATH_MUL(MCL_MATH_CONST(SQRT3_DIV3 * 2), batch->in.ib[k]));
+    }
+#if defined(MCL_CFG_EN_SENSORLESS_SMC) && MCL_CFG_EN_SENSORLESS_SMC
+    for (k = 0; k < num; k++) {
+        control = batch->loop[batch->axis[k]]->control;
+        control->method.smc_process(&control->cfg->smc_cfg, control->cfg->smc_cfg.ualpha, control->cfg->smc_cfg.ubeta,
+            MCL_MATH_CONVERT_FLOAT(batch->out.i_alpha[k]), MCL_MATH_CONVERT_FLOAT(batch->out.i_beta[k]));
+    }
+#endif
+    /* park */
+    for (k = 0; k < num; k++) {
+        MCL_MATH_SINCOS(batch->in.theta[k], &s, &c);
+        batch->out.d[k] = MCL_MATH_ADD(MCL_MATH_MUL(c, batch->out.i_alpha[k]), MCL_MATH_MUL(s, batch->out.i_beta[k]));
+        batch->out.q[k] = MCL_MATH_SUB(MCL_MATH_MUL(c, batch->out.i_beta[k]), MCL_MATH_MUL(s, batch->out.i_alpha[k]));
+    }
+    /* current loops */
+    hpm_mcl_loop_batch_pi(num, batch->in.ref_d, batch->out.d, batch->pid_d.kp, batch->pid_d.ki, batch->pid_d.integral,
+        batch->pid_d.integral_max, batch->pid_d.integral_min, batch->pid_d.output_max, batch->pid_d.output_min, batch->out.ud);
+    hpm_mcl_loop_batch_pi(num, batch->in.ref_q, batch->out.q, batch->pid_q.kp, batch->pid_q.ki, batch->pid_q.integral,
+        batch->pid_q.integral_max, batch->pid_q.integral_min, batch->pid_q.output_max, batch->pid_q.output_min, batch->out.uq);
+#if defined(MCL_CFG_EN_DQ_AXIS_DECOUPLING) && MCL_CFG_EN_DQ_AXIS_DECOUPLING
+    for (k = 0; k < num; k++) {
+        batch->out.ud[k] = MCL_MATH_SUB(batch->out.ud[k],
+                            MCL_MATH_MUL(MCL_MATH_MUL(batch->out.q[k], batch->in.speed_e[k]), batch->in.lq[k]));
+        batch->out.uq[k] = MCL_MATH_ADD(batch->out.uq[k], MCL_MATH_MUL(batch->in.speed_e[k],
+                            MCL_MATH_ADD(MCL_MATH_MUL(batch->in.ld[k], batch->out.q[k]), batch->in.flux[k])));
+    }
+#endif
+    /* inverse park */
+    for (k = 0; k < num; k++) {
+        MCL_MATH_SINCOS(batch->in.theta_forecast[k], &s, &c);
+        batch->out.alpha[k] = MCL_MATH_SUB(MCL_MATH_MUL(c, batch->out.ud[k]), MCL_MATH_MUL(s, batch->out.uq[k]));
+        batch->out.beta[k] = MCL_MATH_ADD(MCL_MATH_MUL(s, batch->out.ud[k]), MCL_MATH_MUL(c, batch->out.uq[k]));
+    }
+#if defined(MCL_CFG_EN_SENSORLESS_SMC) && MCL_CFG_EN_SENSORLESS_SMC
+    for (k = 0; k < num; k++) {
+        control = batch->loop[batch->axis[k]]->control;
+        control->cfg->smc_cfg.ualpha = MCL_MATH_CONVERT_FLOAT(batch->out.alpha[k]);
+        control->cfg->smc_cfg.ubeta = MCL_MATH_CONVERT_FLOAT(batch->out.beta[k]);
+    }
+#endif
+    /*
+     * svpwm by min-max zero sequence injection, the same duty as the sector search of
+     * hpm_mcl_control_svpwm, without the sector branches
+     */
+    for (k = 0; k < num; k++) {
+        inv = MCL_MATH_DIV(MCL_MATH_CONST(1), batch->in.vbus[k]);
+        va = batch->out.alpha[k];
+        vb = MCL_MATH_ADD(MCL_MATH_MUL(MCL_MATH_CONST(-0.5f), batch->out.alpha[k]),
+                          MCL_MATH_MUL(MCL_MATH_CONST(SQRT3 / 2), batch->out.beta[k]));
+        vc = MCL_MATH_SUB(MCL_MATH_MUL(MCL_MATH_CONST(-0.5f), batch->out.alpha[k]),
+                          MCL_MATH_MUL(MCL_MATH_CONST(SQRT3 / 2), batch->out.beta[k]));
+        vmax = MCL_BATCH_MAX(MCL_BATCH_MAX(va, vb), vc);
+        vmin = MCL_BATCH_MIN(MCL_BATCH_MIN(va, vb), vc);
+        mid = MCL_MATH_DIV2(MCL_MATH_ADD(vmax, vmin));
+        batch->out.duty_a[k] = MCL_MATH_SUB(MCL_MATH_CONST(0.5f), MCL_MATH_MUL(MCL_MATH_SUB(va, mid), inv));
+        batch->out.duty_b[k] = MCL_MATH_SUB(MCL_MATH_CONST(0.5f), MCL_MATH_MUL(MCL_MATH_SUB(vb, mid), inv));
+        batch->out.duty_c[k] = MCL_MATH_SUB(MCL_MATH_CONST(0.5f), MCL_MATH_MUL(MCL_MATH_SUB(vc, mid), inv));
+        MCL_VALUE_LIMIT(batch->out.duty_a[k], 0, MCL_MATH_CONST(1));
+        MCL_VALUE_LIMIT(batch->out.duty_b[k], 0, MCL_MATH_CONST(1));
+        MCL_VALUE_LIMIT(batch->out.duty_c[k], 0, MCL_MATH_CONST(1));
+    }
+}
+
+static hpm_mcl_stat_t hpm_mcl_loop_batch_scatter(mcl_loop_batch_t *batch, uint8_t num)
+{
+    uint8_t k;
+    mcl_loop_t *loop;
+    hpm_mcl_stat_t ret = mcl_success;
+
+    for (k = 0; k < num; k++) {
+        loop = batch->loop[batch->axis[k]];
+        loop->control->cfg->currentd_pid_cfg.integral = batch->pid_d.integral[k];
+        loop->control->cfg->currentq_pid_cfg.integral = batch->pid_q.integral[k];
+        if (hpm_mcl_drivers_update_bldc_duty(loop->drivers, MCL_MATH_CONVERT_FLOAT(batch->out.duty_a[k]),
+                MCL_MATH_CONVERT_FLOAT(batch->out.duty_b[k]), MCL_MATH_CONVERT_FLOAT(batch->out.duty_c[k])) != mcl_success) {
+            ret = mcl_drivers_update_error;
+        }
+    }
+
+    return ret;
+}
+
+hpm_mcl_stat_t hpm_mcl_loop_batch(mcl_loop_batch_t *batch)
+{
+    uint8_t num;
+    hpm_mcl_stat_t status;
+    hpm_mcl_stat_t ret;
+
+    MCL_ASSERT_OPT(batch != NULL, mcl_invalid_pointer);
+    /* nothing to share with a single axis, the gather and scatter would only add to hpm_mcl_loop */
+    if (batch->num == 1) {
+        return hpm_mcl_loop(batch->loop[0]);
+    }
+    ret = hpm_mcl_loop_batch_gather(batch, &num);
+    if (num > 0) {
+        hpm_mcl_loop_batch_compute(batch, num);
+        status = hpm_mcl_loop_batch_scatter(batch, num);
+        if (status != mcl_success) {
+            ret = status;
+        }
+    }
+
+    return ret;
+}
@@ -77,7 +77,7 @@ hpm_mcl_stat_t hpm_mcl_analog_get_value(mcl_analog_t *analog, mcl_analog_chn_t c
         val0 = (val0 * analog->board_parameter[chn].adc_reference_vol / analog->board_parameter[chn].sample_precision) /
                 analog->board_parameter[chn].opamp_gain / analog->board_parameter[chn].sample_res;
         if (analog->cfg->enable_filter[chn]) {
-            val0 = hpm_mcl_filter_iir_df1(analog->iir[chn], val0);
+            val0 = MCL_MATH_CONVERT_FLOAT(hpm_mcl_filter_iir_df1(analog->iir[chn], MCL_MATH_FLOAT_TO_TYPE(val0)));
         }
     }
     analog->current[chn] = val0;
@@ -30,8 +30,11 @@ hpm_mcl_stat_t hpm_mcl_encoder_init(mcl_encoder_t *encoder, mcl_cfg_t *mcl_cfg,
      */
     memset(encoder->cal_speed.memory, 0, MCL_ENCODER_CAL_STRUCT_MAX_MEMMORY * sizeof(uint32_t));
     encoder->mcu_clock_tick = &mcl_cfg->physical.time.mcu_clock_tick;
-    encoder->cal_speed.pll_method.cfg = (mcl_encoder_cal_speed_pll_cfg_t *)&encoder_cfg->cal_speed_pll_cfg;
-    encoder->cal_speed.pll_method.period_call_time_s = (float *)&encoder_cfg->period_call_time_s;
+    /* the speed methods share one union, the pointers would otherwise be read as the first theta_last */
+    if (encoder_cfg->speed_cal_method == encoder_method_pll) {
+        encoder->cal_speed.pll_method.cfg = (mcl_encoder_cal_speed_pll_cfg_t *)&encoder_cfg->cal_speed_pll_cfg;
+        encoder->cal_speed.pll_method.period_call_time_s = (float *)&encoder_cfg->period_call_time_s;
+    }
     encoder->iirfilter = iir;
     encoder->current_loop_ts = &mcl_cfg->physical.time.current_loop_ts;
     encoder->pole_num = &mcl_cfg->physical.motor.pole_num;
@@ -166,7 +169,8 @@ hpm_mcl_stat_t hpm_mcl_encoder_process(mcl_encoder_t *encoder, uint32_t tick_det
         encoder->cal_speed.m_t_method.theta_last = theta;
         break;
     case encoder_method_pll:
-        theta_delta = sinf(theta) * cosf(encoder->cal_speed.pll_method.theta_last) - cosf(theta) * sinf(encoder->cal_speed.pll_method.theta_last);
+        /* sin(a)cos(b) - cos(a)sin(b) = sin(a - b) */
+        theta_delta = hpm_mcl_math_sin(theta - encoder->cal_speed.pll_method.theta_last);
         encoder->cal_speed.pll_method.pi_integrator += theta_delta * encoder->cal_speed.pll_method.cfg->ki;
         speed = theta_delta * encoder->cal_speed.pll_method.cfg->kp + encoder->cal_speed.pll_method.pi_integrator;
         theta_integrator = speed * (*encoder->cal_speed.pll_method.period_call_time_s) + encoder->cal_speed.pll_method.theta_last;
@@ -180,14 +184,16 @@ hpm_mcl_stat_t hpm_mcl_encoder_process(mcl_encoder_t *encoder, uint32_t tick_det
      * @brief iir filter
      *
      */
-    speed = hpm_mcl_filter_iir_df1(encoder->iirfilter, speed);
+    speed = MCL_MATH_CONVERT_FLOAT(hpm_mcl_filter_iir_df1(encoder->iirfilter, MCL_MATH_FLOAT_TO_TYPE(speed)));
     theta = MCL_ANGLE_MOD_X(0, 2 * MCL_PI, theta * (*encoder->pole_num));
     theta_forecast = MCL_ANGLE_MOD_X(0, 2 * MCL_PI, theta + speed * (*encoder->current_loop_ts) * (*encoder->pole_num));
 
     encoder->result.theta = theta;
     encoder->result.speed = speed;
     encoder->result.theta_forecast = theta_forecast;
-    encoder->cal_speed.m_t_method.speed_filter_last = encoder->result.speed;
+    if (encoder->cfg->speed_cal_method == encoder_method_m_t) {
+        encoder->cal_speed.m_t_method.speed_filter_last = encoder->result.speed;
+    }
     return mcl_success;
 }
 
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Closed loop FOC speed control of the simulated motor (sim/hpm_mcl_sim.h)
+ *
+ * The run aligns the rotor, accelerates to the reference speed, and applies a load
+ * step half way. It reports the execution time of encoder + loop per current loop
+ * period, and the speed and q-axis current tracking errors after the start-up.
+ *
+ * ./closed_loop/ClosedLoop [speed in r/s, default 20]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hpm_mcl_loop.h"
+#include "hpm_mcl_sim.h"
+
+#define PWM_FREQUENCY       (20000.0f)
+#define CURRENT_BANDWIDTH   (500.0f)
+#define RUN_TIME_S          (2.0f)
+#define SETTLE_TIME_S       (0.5f)
+#define LOAD_TORQUE         (0.01f)
+#define SPEED_RMS_LIMIT     (2.0f)      /* rad/s */
+#define IQ_RMS_LIMIT        (0.1f)      /* A */
+
+typedef struct {
+    mcl_encoder_t encoder;
+    mcl_filter_iir_df1_t encoder_iir;
+    mcl_filter_iir_df1_memory_t encoder_iir_mem[2];
+    mcl_analog_t analog;
+    mcl_drivers_t drivers;
+    mcl_control_t control;
+    mcl_loop_t loop;
+    struct {
+        mcl_cfg_t mcl;
+        mcl_encoer_cfg_t encoder;
+        mcl_filter_iir_df1_cfg_t encoder_iir;
+        mcl_filter_iir_df1_matrix_t encoder_iir_mat[2];
+        mcl_analog_cfg_t analog;
+        mcl_drivers_cfg_t drivers;
+        mcl_control_cfg_t control;
+        mcl_loop_cfg_t loop;
+    } cfg;
+} motor_t;
+
+static motor_t motor;
+static mcl_sim_t sim;
+
+static void control_init(void)
+{
+}
+
+static uint32_t time_ns(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint32_t)(t.tv_sec * 1000000000ull + t.tv_nsec);
+}
+
+static void motor_cfg_init(motor_t *m)
+{
+    mcl_cfg_t *c = &m->cfg.mcl;
+    float kp = 0.00263f * CURRENT_BANDWIDTH * 2 * MCL_PI;
+    float ki = 0.5f * CURRENT_BANDWIDTH * 2 * MCL_PI / PWM_FREQUENCY;
+    mcl_control_pid_cfg_t *current[2] = {&m->cfg.control.currentd_pid_cfg.cfg, &m->cfg.control.currentq_pid_cfg.cfg};
+
+    for (int i = 0; i < 2; i++) {
+        c->physical.board.analog[i].adc_reference_vol = 3.3f;
+        c->physical.board.analog[i].opamp_gain = 10;
+        c->physical.board.analog[i].sample_precision = 4095;
+        c->physical.board.analog[i].sample_res = 0.01f;
+    }
+    c->physical.board.num_current_sample_res = 2;
+    c->physical.board.pwm_dead_time_tick = 100;
+    c->physical.board.pwm_frequency = PWM_FREQUENCY;
+    c->physical.board.pwm_reload = 10000;
+    c->physical.motor.i_max = 9;
+    c->physical.motor.inertia = 2e-5f;
+    c->physical.motor.ls = 0.00263f;
+    c->physical.motor.pole_num = 2;
+    c->physical.motor.res = 0.5f;
+    c->physical.motor.vbus = 24;
+    c->physical.motor.flux = 0.01f;
+    c->physical.motor.ld = 0.0026f;
+    c->physical.motor.lq = 0.0026f;
+    c->physical.motor.hall = phase_120;
+    c->physical.time.current_loop_ts = 1 / PWM_FREQUENCY;
+    c->physical.time.adc_sample_ts = 1 / PWM_FREQUENCY;
+    c->physical.time.encoder_process_ts = 1 / PWM_FREQUENCY;
+    c->physical.time.speed_loop_ts = 5 / PWM_FREQUENCY;
+    c->physical.time.position_loop_ts = 20 / PWM_FREQUENCY;
+    c->physical.time.mcu_clock_tick = 480000000;
+    c->physical.time.pwm_clock_tick = 200000000;
+
+    m->cfg.analog.enable_a_current = true;
+    m->cfg.analog.enable_b_current = true;
+
+    m->cfg.encoder.disable_start_sample_interrupt = true;
+    m->cfg.encoder.period_call_time_s = 1 / PWM_FREQUENCY;
+    m->cfg.encoder.precision = 4000;
+    m->cfg.encoder.speed_abs_switch_m_t = 5;
+    m->cfg.encoder.speed_cal_method = encoder_method_m;
+    m->cfg.encoder.cal_speed_pll_cfg.kp = 1000;
+    m->cfg.encoder.cal_speed_pll_cfg.ki = 100000;
+    m->cfg.encoder.timeout_s = 0.5f;
+    /* 2nd order sections of the low pass used by the samples */
+    m->cfg.encoder_iir.section = 2;
+    m->cfg.encoder_iir.matrix = m->cfg.encoder_iir_mat;
+    m->cfg.encoder_iir_mat[0] = (mcl_filter_iir_df1_matrix_t){.a1 = -1.947404031871316831825424742419272661209f,
+        .a2 = 0.95152023575172306468772376319975592196f, .b0 = 1, .b1 = 2, .b2 = 1,
+        .scale = 0.001029050970101526990552187612593115773f};
+    m->cfg.encoder_iir_mat[1] = (mcl_filter_iir_df1_matrix_t){.a1 = -1.88285893096534651114382086234400048852f,
+        .a2 = 0.886838706662149367510039610351668670774f, .b0 = 1, .b1 = 2, .b2 = 1,
+        .scale = 0.000994943924200649039424337871651005116f};
+
+    m->cfg.control.callback.init = control_init;
+    for (int i = 0; i < 2; i++) {
+        current[i]->integral_max = 15;
+        current[i]->integral_min = -15;
+        current[i]->output_max = 15;
+        current[i]->output_min = -15;
+        current[i]->kp = kp;
+        current[i]->ki = ki;
+    }
+    m->cfg.control.speed_pid_cfg.cfg.integral_max = 5;
+    m->cfg.control.speed_pid_cfg.cfg.integral_min = -5;
+    m->cfg.control.speed_pid_cfg.cfg.output_max = 5;
+    m->cfg.control.speed_pid_cfg.cfg.output_min = -5;
+    m->cfg.control.speed_pid_cfg.cfg.kp = 0.05f;
+    m->cfg.control.speed_pid_cfg.cfg.ki = 0.0005f;
+
+    m->cfg.loop.mode = mcl_mode_foc;
+    m->cfg.loop.enable_speed_loop = true;
+}
+
+static void motor_period(motor_t *m)
+{
+    hpm_mcl_encoder_process(&m->encoder, m->cfg.mcl.physical.time.mcu_clock_tick / PWM_FREQUENCY);
+    hpm_mcl_loop(&m->loop);
+}
+
+int main(int argc, char **argv)
+{
+    float ref_rps = (argc > 1) ? atof(argv[1]) : 20;
+    mcl_cfg_t *c = &motor.cfg.mcl;
+    mcl_sim_cfg_t sim_cfg;
+    mcl_sim_timing_t timing;
+    mcl_sim_error_t speed_err = {0}, iq_err = {0};
+    mcl_user_value_t id = {.value = 1, .enable = true};
+    mcl_user_value_t iq = {.value = 0, .enable = true};
+    mcl_user_value_t speed = {.value = ref_rps * 2 * MCL_PI, .enable = true};
+    uint32_t periods = (uint32_t)(PWM_FREQUENCY * RUN_TIME_S);
+    bool failed;
+
+    motor_cfg_init(&motor);
+    hpm_mcl_sim_get_default_cfg(&sim_cfg, sim_motor_bldc, c);
+    sim_cfg.encoder_lines = 4000;
+    sim_cfg.friction = 1e-5f;
+    if (hpm_mcl_sim_init(&sim, &sim_cfg, c) != mcl_success) {
+        printf("sim init failed\n");
+        return 1;
+    }
+    hpm_mcl_sim_set_callback(&sim, &motor.cfg.drivers, &motor.cfg.analog, &motor.cfg.encoder);
+
+    hpm_mcl_analog_init(&motor.analog, &motor.cfg.analog, c);
+    hpm_mcl_filter_iir_df1_init(&motor.encoder_iir, &motor.cfg.encoder_iir, &motor.encoder_iir_mem[0]);
+    hpm_mcl_encoder_init(&motor.encoder, c, &motor.cfg.encoder, &motor.encoder_iir);
+    hpm_mcl_drivers_init(&motor.drivers, &motor.cfg.drivers);
+    hpm_mcl_control_init(&motor.control, &motor.cfg.control);
+    hpm_mcl_loop_init(&motor.loop, &motor.cfg.loop, c, &motor.encoder, &motor.analog, &motor.control,
+                      &motor.drivers, NULL);
+    hpm_mcl_loop_enable(&motor.loop);
+
+    /* angle alignment as in the samples: hold id at a forced angle, then take the encoder zero */
+    hpm_mcl_loop_set_current_d(&motor.loop, id);
+    hpm_mcl_loop_set_current_q(&motor.loop, iq);
+    hpm_mcl_encoder_force_theta(&motor.encoder, 0, true);
+    for (uint32_t i = 0; i < (uint32_t)PWM_FREQUENCY; i++) {
+        motor_period(&motor);
+        hpm_mcl_sim_step(&sim);
+    }
+    hpm_mcl_encoder_set_initial_theta(&motor.encoder, hpm_mcl_encoder_get_raw_theta(&motor.encoder));
+    hpm_mcl_encoder_force_theta(&motor.encoder, 0, false);
+    id.value = 0;
+    hpm_mcl_loop_set_current_d(&motor.loop, id);
+    iq.enable = false;
+    hpm_mcl_loop_set_current_q(&motor.loop, iq);
+    hpm_mcl_loop_set_speed(&motor.loop, speed);
+
+    hpm_mcl_sim_timing_init(&timing, 10);
+    for (uint32_t i = 0; i < periods; i++) {
+        uint32_t t0 = time_ns();
+
+        motor_period(&motor);
+        hpm_mcl_sim_timing_record(&timing, time_ns() - t0);
+        hpm_mcl_sim_step(&sim);
+        if (i == periods / 2) {
+            sim.cfg.load_torque = LOAD_TORQUE;
+        }
+        if (i > (uint32_t)(PWM_FREQUENCY * SETTLE_TIME_S)) {
+            hpm_mcl_sim_error_record(&speed_err, speed.value, sim.speed);
+            hpm_mcl_sim_error_record(&iq_err, motor.loop.exec_ref.iq, sim.iq);
+        }
+        if (i % (uint32_t)(PWM_FREQUENCY / 5) == 0) {
+            printf("t=%.2f speed %.2f rad/s iq %.3f A id %.3f A ref iq %.3f A\n", i / PWM_FREQUENCY, sim.speed,
+                   sim.iq, sim.id, motor.loop.exec_ref.iq);
+        }
+    }
+
+    printf("encoder + loop ns: p50 %u p90 %u p99 %u max %u mean %.1f (%u beyond histogram)\n",
+           hpm_mcl_sim_timing_percentile(&timing, 50), hpm_mcl_sim_timing_percentile(&timing, 90),
+           hpm_mcl_sim_timing_percentile(&timing, 99), timing.max, (double)timing.sum / timing.count,
+           timing.overflow);
+    printf("speed error rms %.3f max %.3f rad/s, iq error rms %.4f max %.4f A\n", hpm_mcl_sim_error_rms(&speed_err),
+           speed_err.max_abs, hpm_mcl_sim_error_rms(&iq_err), iq_err.max_abs);
+
+    failed = (hpm_mcl_sim_error_rms(&speed_err) > SPEED_RMS_LIMIT) || (hpm_mcl_sim_error_rms(&iq_err) > IQ_RMS_LIMIT);
+    printf(failed ? "FAILED\n" : "PASSED.\n");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Functions the library expects from the application, host versions for the examples */
+
+#include <stdint.h>
+
+void mcl_user_delay_us(uint64_t tick)
+{
+    (void)tick;
+}
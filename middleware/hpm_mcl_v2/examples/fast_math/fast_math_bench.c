@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Accuracy and speed of the MCL_CFG_EN_FAST_MATH functions of hpm_mcl_math.h
+ *
+ * sincos and atan2 are compared against libm in double precision, including the
+ * inputs outside the fixed cost domain (huge, infinite and NaN angles), and the
+ * svpwm duty cycles against a min-max common mode reference. The timings are host
+ * ns per call next to sinf + cosf and atan2f.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "hpm_mcl_control.h"
+
+#define SWEEP_POINTS    (4000000)
+#define BENCH_CALLS     (20000000)
+#define SINCOS_MAX_ERR  (2e-7)      /* |x| <= 1000 rad */
+#define ATAN2_MAX_ERR   (3e-6)
+#define SVPWM_MAX_ERR   (1e-5)
+
+static mcl_control_t control;
+static mcl_control_cfg_t control_cfg;
+static int failures;
+
+static double now(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void control_init(void)
+{
+}
+
+static void expect(const char *name, double value, double limit)
+{
+    bool ok = value <= limit;
+
+    printf("%-40s %10.3g (limit %.3g) %s\n", name, value, limit, ok ? "ok" : "FAIL");
+    if (!ok) {
+        failures++;
+    }
+}
+
+static void check_sincos(void)
+{
+    static const double range[] = {7, 100, 1000};
+
+    for (unsigned r = 0; r < sizeof(range) / sizeof(range[0]); r++) {
+        double err = 0;
+        char name[48];
+
+        for (long i = -SWEEP_POINTS; i <= SWEEP_POINTS; i++) {
+            float x = (float)(range[r] * i / SWEEP_POINTS);
+            float s, c;
+
+            hpm_mcl_math_sincos(x, &s, &c);
+            err = fmax(err, fmax(fabs(s - sin((double)x)), fabs(c - cos((double)x))));
+        }
+        snprintf(name, sizeof(name), "sincos max error, |x| <= %g", range[r]);
+        expect(name, err, SINCOS_MAX_ERR);
+    }
+
+    /* reduced through fmod, the result must still be finite and follow libm for exact floats */
+    {
+        static const float large[] = {1e9f, -1e9f, 3.3e9f, -3.3e9f, 1e10f, -1e10f};
+        double err = 0;
+
+        for (unsigned i = 0; i < sizeof(large) / sizeof(large[0]); i++) {
+            float s, c;
+
+            hpm_mcl_math_sincos(large[i], &s, &c);
+            err = fmax(err, fmax(fabs(s - sin((double)large[i])), fabs(c - cos((double)large[i]))));
+        }
+        expect("sincos max error, 1e9 <= |x| <= 1e10", err, 1e-4);
+    }
+    {
+        static const float bad[] = {INFINITY, -INFINITY, NAN};
+        int not_nan = 0;
+
+        for (unsigned i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+            float s, c;
+
+            hpm_mcl_math_sincos(bad[i], &s, &c);
+            not_nan += !isnan(s) + !isnan(c);
+        }
+        expect("sincos of inf/nan not NaN", not_nan, 0);
+    }
+}
+
+static void check_atan2(void)
+{
+    double err = 0;
+
+    for (int i = 0; i < 4000; i++) {
+        for (int j = 0; j < 1000; j++) {
+            float y = sinf(i * 0.0017f) * (j + 1) * 0.01f;
+            float x = cosf(i * 0.0017f) * (j + 1) * 0.01f;
+
+            err = fmax(err, fabs(hpm_mcl_math_atan2(y, x) - atan2((double)y, (double)x)));
+        }
+    }
+    expect("atan2 max error", err, ATAN2_MAX_ERR);
+    expect("atan2(0, 0)", fabs(hpm_mcl_math_atan2(0, 0)), 0);
+}
+
+static void check_svpwm(void)
+{
+    double err = 0;
+
+    srand(1);
+    for (int i = 0; i < 2000000; i++) {
+        float vbus = 12 + rand() % 40;
+        float alpha = ((rand() / (float)RAND_MAX) - 0.5f) * vbus * 0.9f;
+        float beta = ((rand() / (float)RAND_MAX) - 0.5f) * vbus * 0.9f;
+        float va = alpha, vb = -0.5f * alpha + SQRT3 / 2 * beta, vc = -0.5f * alpha - SQRT3 / 2 * beta;
+        float mid = (fmaxf(fmaxf(va, vb), vc) + fminf(fminf(va, vb), vc)) / 2;
+        float a = fminf(fmaxf(0.5f - (va - mid) / vbus, 0), 1);
+        float b = fminf(fmaxf(0.5f - (vb - mid) / vbus, 0), 1);
+        float c = fminf(fmaxf(0.5f - (vc - mid) / vbus, 0), 1);
+        mcl_control_svpwm_duty_t duty;
+
+        if (control.method.svpwm(alpha, beta, vbus, &duty) != mcl_success) {
+            err = INFINITY;
+            break;
+        }
+        err = fmax(err, fmax(fabs(a - duty.a), fmax(fabs(b - duty.b), fabs(c - duty.c))));
+    }
+    expect("svpwm max duty error", err, SVPWM_MAX_ERR);
+}
+
+static void bench(void)
+{
+    volatile float sink;
+    mcl_control_svpwm_duty_t duty;
+    double t, fast, libm;
+
+    t = now();
+    for (int i = 0; i < BENCH_CALLS; i++) {
+        float s, c;
+
+        hpm_mcl_math_sincos(i * 3.1e-7f, &s, &c);
+        sink = s + c;
+    }
+    fast = now() - t;
+    t = now();
+    for (int i = 0; i < BENCH_CALLS; i++) {
+        float x = i * 3.1e-7f;
+
+        sink = sinf(x) + cosf(x);
+    }
+    libm = now() - t;
+    printf("sincos: fast %.2f ns, sinf + cosf %.2f ns\n", fast / BENCH_CALLS * 1e9, libm / BENCH_CALLS * 1e9);
+
+    t = now();
+    for (int i = 0; i < BENCH_CALLS; i++) {
+        float x = i * 3.1e-7f - 3;
+
+        sink = hpm_mcl_math_atan2(x, 1.3f - x);
+    }
+    fast = now() - t;
+    t = now();
+    for (int i = 0; i < BENCH_CALLS; i++) {
+        float x = i * 3.1e-7f - 3;
+
+        sink = atan2f(x, 1.3f - x);
+    }
+    libm = now() - t;
+    printf("atan2:  fast %.2f ns, atan2f %.2f ns\n", fast / BENCH_CALLS * 1e9, libm / BENCH_CALLS * 1e9);
+
+    t = now();
+    for (int i = 0; i < BENCH_CALLS; i++) {
+        float s, c;
+
+        hpm_mcl_math_sincos(i * 3.1e-7f, &s, &c);
+        control.method.svpwm(10 * c, 10 * s, 24, &duty);
+        sink = duty.a;
+    }
+    fast = now() - t;
+    printf("sincos + svpwm %.2f ns\n", fast / BENCH_CALLS * 1e9);
+    (void)sink;
+}
+
+int main(void)
+{
+    control_cfg.callback.init = control_init;
+    hpm_mcl_control_init(&control, &control_cfg);
+
+    check_sincos();
+    check_atan2();
+    check_svpwm();
+    bench();
+
+    printf(failures ? "FAILED\n" : "PASSED.\n");
+    return failures ? 1 : 0;
+}
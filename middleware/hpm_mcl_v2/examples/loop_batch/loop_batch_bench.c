@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * hpm_mcl_loop_batch against one hpm_mcl_loop per axis, for 1, 2, 4 and 8 axes
+ *
+ * Two identical sets of foc axes with the speed loop enabled, every other one with
+ * dq axis decoupling, are fed the same angles and adc samples. One set runs
+ * hpm_mcl_loop per axis, the other hpm_mcl_loop_batch. The duty cycles of both must
+ * agree within DUTY_MAX_DIFF every period; the host ns per pwm period of both are the
+ * best of BENCH_REPEAT runs of BENCH_PERIODS periods.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "hpm_mcl_loop.h"
+
+#define AXIS_MAX            (8)
+#define CHECK_PERIODS       (20000U)
+#define BENCH_PERIODS       (2000U)
+#define BENCH_REPEAT        (20)
+#define DUTY_MAX_DIFF       (1e-5f)
+
+typedef struct {
+    mcl_encoder_t encoder;
+    mcl_filter_iir_df1_t encoder_iir;
+    mcl_filter_iir_df1_memory_t encoder_iir_mem;
+    mcl_analog_t analog;
+    mcl_drivers_t drivers;
+    mcl_control_t control;
+    mcl_loop_t loop;
+    struct {
+        mcl_cfg_t mcl;
+        mcl_encoer_cfg_t encoder;
+        mcl_filter_iir_df1_cfg_t encoder_iir;
+        mcl_filter_iir_df1_matrix_t encoder_iir_mat;
+        mcl_analog_cfg_t analog;
+        mcl_drivers_cfg_t drivers;
+        mcl_control_cfg_t control;
+        mcl_loop_cfg_t loop;
+    } cfg;
+} axis_t;
+
+/* [0] hpm_mcl_loop per axis, [1] hpm_mcl_loop_batch */
+static axis_t axis[2][AXIS_MAX];
+static uint32_t adc_seed;
+static float duty_log[AXIS_MAX * 3];
+static uint32_t duty_count;
+
+static void init_none(void)
+{
+}
+
+static hpm_mcl_stat_t callback_success(void)
+{
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t drivers_channel(mcl_drivers_channel_t chn)
+{
+    (void)chn;
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t analog_sample_location(mcl_analog_chn_t chn, uint32_t tick)
+{
+    (void)chn;
+    (void)tick;
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t analog_get_value(mcl_analog_chn_t chn, int32_t *value)
+{
+    (void)chn;
+    adc_seed = adc_seed * 1664525u + 1013904223u;
+    *value = 1500 + (adc_seed >> 22);
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t drivers_update_duty(mcl_drivers_channel_t chn, float duty)
+{
+    (void)chn;
+    duty_log[duty_count++ % (AXIS_MAX * 3)] = duty;
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t encoder_get_theta(float *theta)
+{
+    *theta = 0;
+    return mcl_success;
+}
+
+static void axis_init(axis_t *a, bool decoupling)
+{
+    mcl_cfg_t *c = &a->cfg.mcl;
+    mcl_control_pid_cfg_t *pid[3] = {&a->cfg.control.currentd_pid_cfg.cfg, &a->cfg.control.currentq_pid_cfg.cfg,
+                                     &a->cfg.control.speed_pid_cfg.cfg};
+    mcl_user_value_t speed = {.value = 100, .enable = true};
+
+    for (int i = 0; i < 2; i++) {
+        c->physical.board.analog[i].adc_reference_vol = 3.3f;
+        c->physical.board.analog[i].opamp_gain = 10;
+        c->physical.board.analog[i].sample_precision = 4095;
+        c->physical.board.analog[i].sample_res = 0.01f;
+    }
+    c->physical.board.num_current_sample_res = 2;
+    c->physical.board.pwm_dead_time_tick = 100;
+    c->physical.motor.pole_num = 2;
+    c->physical.motor.vbus = 24;
+    c->physical.motor.res = 0.5f;
+    c->physical.motor.ls = 0.0026f;
+    c->physical.motor.ld = 0.0026f;
+    c->physical.motor.lq = 0.0026f;
+    c->physical.motor.flux = 0.01f;
+    c->physical.time.current_loop_ts = 1 / 20000.0f;
+    c->physical.time.speed_loop_ts = 5 / 20000.0f;
+    c->physical.time.adc_sample_ts = 1 / 20000.0f;
+    c->physical.time.pwm_clock_tick = 200000000;
+
+    a->cfg.analog.enable_a_current = true;
+    a->cfg.analog.enable_b_current = true;
+    a->cfg.analog.callback.init = callback_success;
+    a->cfg.analog.callback.update_sample_location = analog_sample_location;
+    a->cfg.analog.callback.get_value = analog_get_value;
+
+    a->cfg.encoder.disable_start_sample_interrupt = true;
+    a->cfg.encoder.period_call_time_s = 1 / 20000.0f;
+    a->cfg.encoder.precision = 4000;
+    a->cfg.encoder.timeout_s = 0.5f;
+    a->cfg.encoder.speed_cal_method = encoder_method_m;
+    a->cfg.encoder.callback.start_sample = callback_success;
+    a->cfg.encoder.callback.get_theta = encoder_get_theta;
+    a->cfg.encoder_iir.section = 1;
+    a->cfg.encoder_iir.matrix = &a->cfg.encoder_iir_mat;
+    a->cfg.encoder_iir_mat.b0 = 1;
+    a->cfg.encoder_iir_mat.scale = 1;
+
+    a->cfg.drivers.callback.init = init_none;
+    a->cfg.drivers.callback.update_duty_cycle = drivers_update_duty;
+    a->cfg.drivers.callback.enable_all_drivers = callback_success;
+    a->cfg.drivers.callback.disable_all_drivers = callback_success;
+    a->cfg.drivers.callback.enable_drivers = drivers_channel;
+    a->cfg.drivers.callback.disable_drivers = drivers_channel;
+
+    a->cfg.control.callback.init = init_none;
+    for (int i = 0; i < 3; i++) {
+        pid[i]->kp = (i == 2) ? 0.05f : 8.2f;
+        pid[i]->ki = (i == 2) ? 0.0005f : 0.08f;
+        pid[i]->integral_max = 15;
+        pid[i]->integral_min = -15;
+        pid[i]->output_max = 15;
+        pid[i]->output_min = -15;
+    }
+
+    a->cfg.loop.mode = mcl_mode_foc;
+    a->cfg.loop.enable_speed_loop = true;
+#if defined(MCL_CFG_EN_DQ_AXIS_DECOUPLING) && MCL_CFG_EN_DQ_AXIS_DECOUPLING
+    a->cfg.loop.enable_dq_axis_decoupling = decoupling;
+#else
+    (void)decoupling;
+#endif
+
+    hpm_mcl_filter_iir_df1_init(&a->encoder_iir, &a->cfg.encoder_iir, &a->encoder_iir_mem);
+    if ((hpm_mcl_analog_init(&a->analog, &a->cfg.analog, c) != mcl_success)
+     || (hpm_mcl_encoder_init(&a->encoder, c, &a->cfg.encoder, &a->encoder_iir) != mcl_success)
+     || (hpm_mcl_drivers_init(&a->drivers, &a->cfg.drivers) != mcl_success)
+     || (hpm_mcl_control_init(&a->control, &a->cfg.control) != mcl_success)
+     || (hpm_mcl_loop_init(&a->loop, &a->cfg.loop, c, &a->encoder, &a->analog, &a->control, &a->drivers, NULL)
+         != mcl_success)) {
+        printf("axis init failed\n");
+        exit(1);
+    }
+    hpm_mcl_loop_enable(&a->loop);
+    hpm_mcl_loop_set_speed(&a->loop, speed);
+}
+
+/* a different electrical angle and speed for every axis, the same in both sets */
+static void set_encoder(int num, uint32_t period)
+{
+    for (int s = 0; s < 2; s++) {
+        for (int i = 0; i < num; i++) {
+            float theta = fmodf(0.01f * period * (i + 1) + i, 2 * MCL_PI);
+
+            axis[s][i].encoder.result.theta = theta;
+            axis[s][i].encoder.result.theta_forecast = fmodf(theta + 0.02f, 2 * MCL_PI);
+            axis[s][i].encoder.result.speed = 50 + 10 * i;
+        }
+    }
+}
+
+static uint64_t time_ns(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000000ull + t.tv_nsec;
+}
+
+static bool run(int num)
+{
+    mcl_loop_t *loops[AXIS_MAX];
+    mcl_loop_batch_t batch;
+    uint64_t best_loop = UINT64_MAX, best_batch = UINT64_MAX;
+    float max_diff = 0;
+
+    memset(axis, 0, sizeof(axis));
+    for (int i = 0; i < num; i++) {
+        axis_init(&axis[0][i], i & 1);
+        axis_init(&axis[1][i], i & 1);
+        loops[i] = &axis[1][i].loop;
+    }
+    if (hpm_mcl_loop_batch_init(&batch, loops, num) != mcl_success) {
+        printf("batch init failed\n");
+        return false;
+    }
+
+    for (uint32_t period = 0; period < CHECK_PERIODS; period++) {
+        float ref[AXIS_MAX * 3];
+
+        set_encoder(num, period);
+        adc_seed = period;
+        duty_count = 0;
+        for (int i = 0; i < num; i++) {
+            hpm_mcl_loop(&axis[0][i].loop);
+        }
+        memcpy(ref, duty_log, sizeof(float) * num * 3);
+        adc_seed = period;
+        duty_count = 0;
+        hpm_mcl_loop_batch(&batch);
+        for (int i = 0; i < num * 3; i++) {
+            max_diff = fmaxf(max_diff, fabsf(ref[i] - duty_log[i]));
+        }
+    }
+
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        uint64_t t0, t1, t2;
+
+        t0 = time_ns();
+        for (uint32_t period = 0; period < BENCH_PERIODS; period++) {
+            for (int i = 0; i < num; i++) {
+                hpm_mcl_loop(&axis[0][i].loop);
+            }
+        }
+        t1 = time_ns();
+        for (uint32_t period = 0; period < BENCH_PERIODS; period++) {
+            hpm_mcl_loop_batch(&batch);
+        }
+        t2 = time_ns();
+        if ((t1 - t0) < best_loop) {
+            best_loop = t1 - t0;
+        }
+        if ((t2 - t1) < best_batch) {
+            best_batch = t2 - t1;
+        }
+    }
+
+    printf("%d axes: hpm_mcl_loop %7.1f ns, hpm_mcl_loop_batch %7.1f ns per period (%5.1f / %5.1f per axis), "
+           "max duty diff %.2e\n", num, (double)best_loop / BENCH_PERIODS, (double)best_batch / BENCH_PERIODS,
+           (double)best_loop / BENCH_PERIODS / num, (double)best_batch / BENCH_PERIODS / num, max_diff);
+
+    return max_diff <= DUTY_MAX_DIFF;
+}
+
+int main(void)
+{
+    static const int axes[] = {1, 2, 4, 8};
+    bool passed = true;
+
+    for (unsigned i = 0; i < sizeof(axes) / sizeof(axes[0]); i++) {
+        passed = run(axes[i]) && passed;
+    }
+
+    printf(passed ? "PASSED.\n" : "FAILED\n");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Error of the HPM_MCL_Q_EN control and filter kernels against float
+ *
+ * The kernels are built with MCL_Q_FRAC_BITS fractional bits and fed random inputs,
+ * the reference is the float algorithm evaluated in double precision on the same,
+ * already quantized, inputs and coefficients, so only the error of the Q arithmetic
+ * is measured. The max error is printed in LSB of the format next to its limit.
+ * The constants of clarke and svpwm are quantized too, their limits grow with the
+ * input range. The pi controller is checked for one step from the same state and in
+ * a closed loop with a first order plant, the iir filter over RANDOM_POINTS steps.
+ *
+ * ./q_format/QFormatError, make Q_FRAC_BITS=20 for another format
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "hpm_mcl_control.h"
+#include "hpm_mcl_filter.h"
+
+#define RANDOM_POINTS       (1000000)
+#define LSB                 (1.0 / MCL_Q_ONE)
+
+#define CURRENT_RANGE       (20.0)      /* A */
+
+/* limits in LSB of MCL_Q_FRAC_BITS */
+#define SINCOS_MAX_LSB      (1.0)
+/* plus the 3e-6 rad of the polynomial, it shows above 20 bits */
+#define ATAN2_MAX_LSB       (2.0 + 3.0e-6 / LSB)
+/* half a LSB of each of the two constants times the current range, one rounding per product */
+#define CLARKE_MAX_LSB      (0.5 * 2 * CURRENT_RANGE + 2)
+#define PARK_MAX_LSB        (2.0)
+/* 1.5 / vbus is rounded to the format, its error scales the duty of the whole voltage range */
+#define SVPWM_MAX_LSB       (32.0)
+#define PI_STEP_MAX_LSB     (2.0)
+#define PI_LOOP_MAX_LSB     (16.0)
+/* the rounding of each section is amplified by the noise gain of its poles next to 1 */
+#define IIR_MAX_LSB         (256.0)
+
+#define T(x) MCL_MATH_FLOAT_TO_TYPE(x)
+#define D(x) ((double)(x) * LSB)
+
+static uint32_t seed = 1;
+static int failures;
+static mcl_control_t control;
+static mcl_control_cfg_t control_cfg;
+
+static double rnd(double lo, double hi)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (seed >> 8) / 16777216.0;
+}
+
+static void control_init(void)
+{
+}
+
+static void expect(const char *name, double err, double limit_lsb)
+{
+    bool ok = err <= limit_lsb * LSB;
+
+    printf("%-24s %8.3f LSB (limit %.1f) %s\n", name, err / LSB, limit_lsb, ok ? "ok" : "FAIL");
+    if (!ok) {
+        failures++;
+    }
+}
+
+static void check_sincos_atan2(void)
+{
+    double sincos_err = 0, atan2_err = 0;
+
+    for (int i = 0; i < RANDOM_POINTS; i++) {
+        hpm_mcl_type_t th = T(rnd(-100, 100));
+        hpm_mcl_type_t y = T(rnd(-20, 20));
+        hpm_mcl_type_t x = T(rnd(-20, 20));
+
+        sincos_err = fmax(sincos_err, fabs(D(control.method.sin_x(th)) - sin(D(th))));
+        sincos_err = fmax(sincos_err, fabs(D(control.method.cos_x(th)) - cos(D(th))));
+        atan2_err = fmax(atan2_err, fabs(D(control.method.arctan_x(y, x)) - atan2(D(y), D(x))));
+    }
+    expect("sin/cos, |x| <= 100", sincos_err, SINCOS_MAX_LSB);
+    expect("atan2", atan2_err, ATAN2_MAX_LSB);
+}
+
+static void check_transforms(void)
+{
+    double clarke_err = 0, park_err = 0;
+
+    for (int i = 0; i < RANDOM_POINTS; i++) {
+        hpm_mcl_type_t ia = T(rnd(-CURRENT_RANGE, CURRENT_RANGE)), ib = T(rnd(-CURRENT_RANGE, CURRENT_RANGE));
+        hpm_mcl_type_t d = T(rnd(-24, 24)), q = T(rnd(-24, 24));
+        hpm_mcl_type_t th = T(rnd(-MCL_PI, MCL_PI));
+        hpm_mcl_type_t s = control.method.sin_x(th), c = control.method.cos_x(th);
+        hpm_mcl_type_t a, b;
+
+        control.method.clarke(ia, ib, 0, &a, &b);
+        clarke_err = fmax(clarke_err, fabs(D(a) - D(ia)));
+        clarke_err = fmax(clarke_err, fabs(D(b) - (D(ia) + 2 * D(ib)) / sqrt(3)));
+
+        control.method.park(ia, ib, s, c, &a, &b);
+        park_err = fmax(park_err, fabs(D(a) - (D(c) * D(ia) + D(s) * D(ib))));
+        park_err = fmax(park_err, fabs(D(b) - (D(c) * D(ib) - D(s) * D(ia))));
+
+        control.method.invpark(d, q, s, c, &a, &b);
+        park_err = fmax(park_err, fabs(D(a) - (D(c) * D(d) - D(s) * D(q))));
+        park_err = fmax(park_err, fabs(D(b) - (D(s) * D(d) + D(c) * D(q))));
+    }
+    expect("clarke", clarke_err, CLARKE_MAX_LSB);
+    expect("park/inv park", park_err, PARK_MAX_LSB);
+}
+
+/* min-max common mode injection, the svpwm of hpm_mcl_control_svpwm in closed form */
+static void check_svpwm(void)
+{
+    double err = 0;
+
+    for (int i = 0; i < RANDOM_POINTS; i++) {
+        hpm_mcl_type_t vbus = T(rnd(12, 48));
+        hpm_mcl_type_t alpha = T(rnd(-0.45, 0.45) * D(vbus));
+        hpm_mcl_type_t beta = T(rnd(-0.45, 0.45) * D(vbus));
+        double va = D(alpha), vb = -0.5 * D(alpha) + sqrt(3) / 2 * D(beta), vc = -0.5 * D(alpha) - sqrt(3) / 2 * D(beta);
+        double mid = (fmax(fmax(va, vb), vc) + fmin(fmin(va, vb), vc)) / 2;
+        mcl_control_svpwm_duty_t duty;
+
+        if (control.method.svpwm(alpha, beta, vbus, &duty) != mcl_success) {
+            err = INFINITY;
+            break;
+        }
+        err = fmax(err, fabs(D(duty.a) - fmin(fmax(0.5 - (va - mid) / D(vbus), 0), 1)));
+        err = fmax(err, fabs(D(duty.b) - fmin(fmax(0.5 - (vb - mid) / D(vbus), 0), 1)));
+        err = fmax(err, fabs(D(duty.c) - fmin(fmax(0.5 - (vc - mid) / D(vbus), 0), 1)));
+    }
+    expect("svpwm duty", err, SVPWM_MAX_LSB);
+}
+
+static void check_pi(void)
+{
+    mcl_control_pid_t pid = {.cfg = {.kp = T(3.3f), .ki = T(0.0785f), .integral_max = T(15), .integral_min = T(-15),
+                                     .output_max = T(15), .output_min = T(-15)}};
+    double step_err = 0, loop_err = 0;
+    double integral, plant_q = 0, plant_f = 0, ref = 0;
+
+    /* one step from the integral the Q controller holds */
+    for (int i = 0; i < RANDOM_POINTS; i++) {
+        hpm_mcl_type_t ref = T(rnd(-2, 2)), sens = T(rnd(-2, 2));
+        hpm_mcl_type_t out;
+        double e = D(ref) - D(sens);
+
+        integral = D(pid.integral);
+        control.method.currentd_pid(ref, sens, &pid, &out);
+        integral = fmin(fmax(integral + D(pid.cfg.ki) * e, D(pid.cfg.integral_min)), D(pid.cfg.integral_max));
+        step_err = fmax(step_err, fabs(D(out) - fmin(fmax(D(pid.cfg.kp) * e + integral, D(pid.cfg.output_min)),
+                                                      D(pid.cfg.output_max))));
+    }
+    expect("pi, one step", step_err, PI_STEP_MAX_LSB);
+
+    /* the loop removes the drift the rounding of the integral accumulates in open loop */
+    pid.integral = 0;
+    integral = 0;
+    for (int i = 0; i < RANDOM_POINTS; i++) {
+        hpm_mcl_type_t out;
+        double e;
+
+        if (i % 2000 == 0) {
+            ref = D(T(rnd(-10, 10)));
+        }
+        e = ref - plant_f;
+        control.method.currentd_pid(T(ref), T(plant_q), &pid, &out);
+        plant_q += (D(out) - plant_q) * 0.05;
+        integral = fmin(fmax(integral + D(pid.cfg.ki) * e, D(pid.cfg.integral_min)), D(pid.cfg.integral_max));
+        plant_f += (fmin(fmax(D(pid.cfg.kp) * e + integral, D(pid.cfg.output_min)), D(pid.cfg.output_max)) - plant_f) * 0.05;
+        loop_err = fmax(loop_err, fabs(plant_q - plant_f));
+    }
+    expect("pi, closed loop", loop_err, PI_LOOP_MAX_LSB);
+}
+
+/*
+ * The Q filter feeds back the scaled output of each section, the float reference is the
+ * unscaled form with the scale applied to the section output, both are the same filter.
+ */
+static void check_iir(void)
+{
+    static const float coef[2][3] = {{-1.947404031871316831825424742419272661209f, 0.95152023575172306468772376319975592196f,
+                                      0.001029050970101526990552187612593115773f},
+                                     {-1.88285893096534651114382086234400048852f, 0.886838706662149367510039610351668670774f,
+                                      0.000994943924200649039424337871651005116f}};
+    mcl_filter_iir_df1_matrix_t mat[2];
+    mcl_filter_iir_df1_cfg_t cfg = {.section = 2, .matrix = mat};
+    mcl_filter_iir_df1_memory_t mem[2];
+    mcl_filter_iir_df1_t iir;
+    double x[2][3] = {0}, y[2][2] = {0};
+    double err = 0;
+    /* b0 + b1 + b2 times the input must stay in the integer range of the format */
+    double level = fmin(1.0, MCL_Q_MAX * LSB / 8 / 175.66);
+
+    for (int s = 0; s < 2; s++) {
+        mat[s] = (mcl_filter_iir_df1_matrix_t){.a1 = T(coef[s][0]), .a2 = T(coef[s][1]), .b0 = T(1), .b1 = T(2),
+                                               .b2 = T(1), .scale = T(coef[s][2])};
+    }
+    hpm_mcl_filter_iir_df1_init(&iir, &cfg, mem);
+    for (int i = 0; i < RANDOM_POINTS; i++) {
+        hpm_mcl_type_t in = T(level * (125.66 + rnd(-5, 5) + ((i / 20000) & 1) * 50));
+        double v = D(in);
+
+        for (int s = 0; s < 2; s++) {
+            double u;
+
+            x[s][2] = x[s][1];
+            x[s][1] = x[s][0];
+            x[s][0] = v;
+            u = D(mat[s].b0) * x[s][0] + D(mat[s].b1) * x[s][1] + D(mat[s].b2) * x[s][2]
+              - D(mat[s].a1) * y[s][0] - D(mat[s].a2) * y[s][1];
+            y[s][1] = y[s][0];
+            y[s][0] = u;
+            v = u * D(mat[s].scale);
+        }
+        err = fmax(err, fabs(D(hpm_mcl_filter_iir_df1(&iir, in)) - v));
+    }
+    expect("iir df1, 2 sections", err, IIR_MAX_LSB);
+}
+
+int main(void)
+{
+    control_cfg.callback.init = control_init;
+    hpm_mcl_control_init(&control, &control_cfg);
+
+    printf("MCL_Q_FRAC_BITS %d, 1 LSB = %.3g\n", MCL_Q_FRAC_BITS, LSB);
+    check_sincos_atan2();
+    check_transforms();
+    check_svpwm();
+    check_pi();
+    check_iir();
+
+    printf(failures ? "FAILED\n" : "PASSED.\n");
+    return failures ? 1 : 0;
+}
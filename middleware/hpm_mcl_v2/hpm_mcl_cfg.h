@@ -35,6 +35,40 @@
 
 #define MCL_CFG_EN_SENSORLESS_SMC   MCL_EN_SENSORLESS_SMC
 
+/**
+ * @brief Fixed cost polynomial sin, cos and atan2 instead of libm in the control loops
+ *
+ */
+#ifndef MCL_EN_FAST_MATH
+#define MCL_EN_FAST_MATH            (1)
+#endif
+
+#define MCL_CFG_EN_FAST_MATH        MCL_EN_FAST_MATH
+
+/**
+ * @brief Fractional bits of hpm_mcl_type_t when HPM_MCL_Q_EN is defined
+ *
+ */
+#ifndef MCL_Q_FRAC_BITS
+#define MCL_Q_FRAC_BITS             (15)
+#endif
+
+/**
+ * @brief Maximum number of axes run in lockstep by hpm_mcl_loop_batch
+ *
+ */
+#ifndef MCL_LOOP_BATCH_AXIS_NUM
+#define MCL_LOOP_BATCH_AXIS_NUM     (8)
+#endif
+
+/**
+ * @brief Maximum number of variables recorded by the debug scope
+ *
+ */
+#ifndef MCL_DEBUG_SCOPE_CHN_NUM
+#define MCL_DEBUG_SCOPE_CHN_NUM     (32)
+#endif
+
 #ifndef MCL_USER_DEFINED_DEBUG_FIFO
 #define MCL_USER_DEFINED_DEBUG_FIFO (100)
 #endif
@@ -67,7 +67,8 @@ void hpm_mcl_debug_init(mcl_debug_t *debug);
 
 /**
  * @brief Sends data in the buffer to the outside, Depending on how the callback function works,
- *        this function could potentially hang the application
+ *        this function could potentially hang the application.
+ *        Use the scope capture below to record from an interrupt without waiting for the link.
  *
  * @param debug @ref mcl_debug_t
  */
@@ -83,4 +84,190 @@ void hpm_mcl_debug_send_scope(mcl_debug_t *debug);
  */
 void hpm_mcl_debug_update_data(mcl_debug_t *debug, uint8_t chn, void *data, mcl_debug_data_type_t type);
 
+/**
+ * @brief Scope capture.
+ *        The control interrupt calls @ref hpm_mcl_debug_scope_sample, which copies the registered variables
+ *        into one half of a double buffer and never waits. A filled half is sealed into a frame and handed to
+ *        the background, which streams it with @ref hpm_mcl_debug_scope_drain or a DMA driven link through
+ *        @ref hpm_mcl_debug_scope_get_frame and @ref hpm_mcl_debug_scope_release_frame.
+ *        One producer and one consumer, no lock is needed.
+ *
+ *        Frames are little endian, the fletcher-16 checksum covers everything after the sync bytes.
+ *        Data frame:
+ *          aa bb | 01 | chn_num u8 | seq u16 | record_num u16 | first_index u32 | flags u16 | lost u16 |
+ *          record_num * record | checksum u16
+ *        record is the value of every channel in registration order, in the size of its type.
+ *        Descriptor frame, sent first after every start:
+ *          aa bb | 02 | chn_num u8 | decimation u16 | reserved u16 | chn_num * type code u8 | checksum u16
+ *        The type code is the high byte of @ref mcl_debug_data_type_t.
+ *        middleware/hpm_mcl_v2/tools/mcl_scope_decode.py converts a captured stream to csv.
+ */
+#define MCL_DEBUG_SCOPE_SYNC0               (0xaa)
+#define MCL_DEBUG_SCOPE_SYNC1               (0xbb)
+#define MCL_DEBUG_SCOPE_FRAME_DATA          (0x01)
+#define MCL_DEBUG_SCOPE_FRAME_DESCRIPTOR    (0x02)
+#define MCL_DEBUG_SCOPE_HEADER_SIZE         (16)
+#define MCL_DEBUG_SCOPE_CHECKSUM_SIZE       (2)
+#define MCL_DEBUG_SCOPE_DESCRIPTOR_SIZE     (8 + MCL_DEBUG_SCOPE_CHN_NUM + MCL_DEBUG_SCOPE_CHECKSUM_SIZE)
+
+#define MCL_DEBUG_SCOPE_FLAG_TRIGGER        (1 << 0)    /**< The first record of the frame is the trigger point */
+#define MCL_DEBUG_SCOPE_FLAG_LOST           (1 << 1)    /**< Records were dropped before this frame, count in lost */
+#define MCL_DEBUG_SCOPE_FLAG_LAST           (1 << 2)    /**< Last frame of a single capture or of a stop */
+
+/**
+ * @brief Trigger condition, evaluated on decimated samples
+ *
+ */
+typedef enum {
+    mcl_debug_trigger_none = 0,     /**< Record from the first sample after start */
+    mcl_debug_trigger_rising = 1,
+    mcl_debug_trigger_falling = 2,
+    mcl_debug_trigger_both = 3,
+} mcl_debug_trigger_mode_t;
+
+/**
+ * @brief Variable recorded by the scope
+ *
+ */
+typedef struct {
+    void *addr;
+    mcl_debug_data_type_t type;
+} mcl_debug_scope_chn_t;
+
+/**
+ * @brief Scope capture configuration
+ *
+ */
+typedef struct {
+    mcl_debug_callback_t callback;  /**< Used by @ref hpm_mcl_debug_scope_drain only */
+    uint8_t *buf;                   /**< Split into two halves, each half holds one frame */
+    uint32_t buf_size;              /**< Each half must fit the header, one record and the checksum, and at most 65535 bytes */
+    uint16_t decimation;            /**< Record one of every decimation samples, 0 and 1 record all */
+    uint32_t record_num;            /**< Records after the trigger, 0 - stream until stopped */
+    struct {
+        mcl_debug_trigger_mode_t mode;
+        uint8_t chn;                /**< Index of the registered channel compared with level */
+        float level;
+    } trigger;
+} mcl_debug_scope_cfg_t;
+
+/**
+ * @brief State of the scope
+ *
+ */
+typedef enum {
+    mcl_debug_scope_idle = 0,
+    mcl_debug_scope_armed = 1,      /**< Waiting for the trigger */
+    mcl_debug_scope_running = 2,
+    mcl_debug_scope_done = 3,       /**< Capture complete, frames may still wait to be drained */
+} mcl_debug_scope_state_t;
+
+/**
+ * @brief One half of the double buffer
+ *
+ */
+typedef struct {
+    volatile uint8_t state;         /**< Written by the interrupt when filled, by the background when released */
+    uint16_t record_num;
+    uint32_t first_index;
+    uint16_t flags;
+    uint16_t lost;
+    uint8_t *buf;
+} mcl_debug_scope_half_t;
+
+/**
+ * @brief Scope running data
+ *
+ */
+typedef struct {
+    mcl_debug_scope_cfg_t *cfg;
+    mcl_debug_scope_chn_t chn[MCL_DEBUG_SCOPE_CHN_NUM];
+    uint8_t chn_num;
+    uint16_t record_size;
+    uint16_t record_per_frame;
+    uint32_t half_size;
+    mcl_debug_scope_half_t half[2];
+    uint8_t fill;                   /**< Half written by the interrupt */
+    uint8_t drain;                  /**< Half read by the background */
+    volatile mcl_debug_scope_state_t state;
+    volatile bool stop_request;
+    volatile bool descriptor_pending;
+    bool descriptor_out;            /**< The frame handed out by get_frame is the descriptor */
+    uint16_t decimation_cnt;
+    uint16_t seq;
+    uint32_t index;
+    uint32_t remain;
+    uint32_t lost;
+    float trigger_last;
+    bool trigger_last_valid;
+    uint8_t descriptor[MCL_DEBUG_SCOPE_DESCRIPTOR_SIZE];
+} mcl_debug_scope_t;
+
+/**
+ * @brief Initialise the scope, channels are registered afterwards
+ *
+ * @param scope @ref mcl_debug_scope_t
+ * @param cfg @ref mcl_debug_scope_cfg_t
+ * @return hpm_mcl_stat_t
+ */
+hpm_mcl_stat_t hpm_mcl_debug_scope_init(mcl_debug_scope_t *scope, mcl_debug_scope_cfg_t *cfg);
+
+/**
+ * @brief Register a variable, only while the scope is idle
+ *
+ * @param scope @ref mcl_debug_scope_t
+ * @param addr address of the variable, read on every recorded sample
+ * @param type @ref mcl_debug_data_type_t
+ * @return hpm_mcl_stat_t
+ */
+hpm_mcl_stat_t hpm_mcl_debug_scope_add_chn(mcl_debug_scope_t *scope, void *addr, mcl_debug_data_type_t type);
+
+/**
+ * @brief Drop all frames and arm the trigger, the descriptor frame is queued for the drain
+ *
+ * @param scope @ref mcl_debug_scope_t
+ * @return hpm_mcl_stat_t
+ */
+hpm_mcl_stat_t hpm_mcl_debug_scope_start(mcl_debug_scope_t *scope);
+
+/**
+ * @brief Ask the interrupt to seal the half being filled and stop, takes effect on the next sample
+ *
+ * @param scope @ref mcl_debug_scope_t
+ */
+void hpm_mcl_debug_scope_stop(mcl_debug_scope_t *scope);
+
+/**
+ * @brief Record one sample, called from the control interrupt, constant time and never blocks.
+ *        When both halves are waiting for the drain the sample is dropped and counted as lost.
+ *
+ * @param scope @ref mcl_debug_scope_t
+ */
+void hpm_mcl_debug_scope_sample(mcl_debug_scope_t *scope);
+
+/**
+ * @brief Oldest frame waiting to be sent, the descriptor frame first after a start
+ *
+ * @param scope @ref mcl_debug_scope_t
+ * @param buf frame start
+ * @param len frame length in bytes
+ * @return true a frame is returned and must be released with @ref hpm_mcl_debug_scope_release_frame
+ */
+bool hpm_mcl_debug_scope_get_frame(mcl_debug_scope_t *scope, uint8_t **buf, uint32_t *len);
+
+/**
+ * @brief Give the frame returned by @ref hpm_mcl_debug_scope_get_frame back to the interrupt
+ *
+ * @param scope @ref mcl_debug_scope_t
+ */
+void hpm_mcl_debug_scope_release_frame(mcl_debug_scope_t *scope);
+
+/**
+ * @brief Send all waiting frames through callback.write_buf, called from the background loop
+ *
+ * @param scope @ref mcl_debug_scope_t
+ * @return number of frames sent
+ */
+uint32_t hpm_mcl_debug_scope_drain(mcl_debug_scope_t *scope);
+
 #endif
@@ -8,6 +8,7 @@
 #define HPM_MCL_MATH_H
 #include "hpm_mcl_cfg.h"
 
+#include <stdint.h>
 #ifndef HPM_MCL_MATH_HARDWARE_ACC
 #include <math.h>
 #endif
@@ -22,18 +23,354 @@
 #define SQRT3_DIV3 (0.5773502691896258f)    /**< sqrt(3)/3 */
 #define MCL_SUM_OF_SQUARE_MODE(a, b) sqrtf((float)((a * a) + (b * b)))
 
+#if defined(MCL_CFG_EN_FAST_MATH) && MCL_CFG_EN_FAST_MATH
+/**
+ * @brief Fast math, the angle is reduced to [-pi/4, pi/4] by the nearest multiple of pi/2,
+ * then sin and cos are minimax polynomials of degree 7 and 8. Max error against double
+ * precision is 1e-7 for |x| <= 1000 rad and grows with |x| beyond that. No table and no
+ * loop, so the cost is the same for every input up to MCL_FAST_MATH_MAX_ARG. Larger inputs
+ * are first reduced by fmod in double, so that the quadrant index fits int32_t, and NaN or
+ * infinity give NaN as sinf/cosf do.
+ *
+ */
+#define MCL_FAST_MATH_2_DIV_PI      (0.63661977236758134f)
+#define MCL_FAST_MATH_PI_DIV2_HI    (1.5703125f)                /**< pi/2 high part, exact in float */
+#define MCL_FAST_MATH_PI_DIV2_LO    (4.8382679489661923e-4f)    /**< pi/2 - MCL_FAST_MATH_PI_DIV2_HI */
+#define MCL_FAST_MATH_2PI           (6.28318530717958648)       /**< double, the reduction of a large float needs it */
+#define MCL_FAST_MATH_MAX_ARG       (1.0e9f)                    /**< |x| * 2/pi stays well below INT32_MAX */
+
+static inline void hpm_mcl_math_sincos(float x, float *sin_x, float *cos_x)
+{
+    int32_t k;
+    float r, r2, s, c;
+
+    /* also true for NaN, converting it or a huge value to int32_t is undefined */
+    if (!((x < MCL_FAST_MATH_MAX_ARG) && (x > -MCL_FAST_MATH_MAX_ARG))) {
+        x = (float)fmod((double)x, MCL_FAST_MATH_2PI);
+        if (x != x) {
+            *sin_x = x;
+            *cos_x = x;
+            return;
+        }
+    }
+    k = (int32_t)(x * MCL_FAST_MATH_2_DIV_PI + ((x < 0) ? -0.5f : 0.5f));
+    r = (x - (float)k * MCL_FAST_MATH_PI_DIV2_HI) - (float)k * MCL_FAST_MATH_PI_DIV2_LO;
+    r2 = r * r;
+    s = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+    c = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+    switch ((uint32_t)k & 3) {
+    case 0:
+        *sin_x = s;
+        *cos_x = c;
+        break;
+    case 1:
+        *sin_x = c;
+        *cos_x = -s;
+        break;
+    case 2:
+        *sin_x = -s;
+        *cos_x = -c;
+        break;
+    default:
+        *sin_x = -c;
+        *cos_x = s;
+        break;
+    }
+}
+
+static inline float hpm_mcl_math_sin(float x)
+{
+    float s, c;
+
+    hpm_mcl_math_sincos(x, &s, &c);
+    return s;
+}
+
+static inline float hpm_mcl_math_cos(float x)
+{
+    float s, c;
+
+    hpm_mcl_math_sincos(x, &s, &c);
+    return c;
+}
+
+/**
+ * @brief atan2 with one division, the ratio of the smaller to the larger magnitude goes through
+ * a minimax polynomial of degree 11 on [0, 1]. Max error is 2e-6 rad, atan2(0, 0) is 0.
+ *
+ */
+static inline float hpm_mcl_math_atan2(float y, float x)
+{
+    float ax, ay, z, z2, a;
+
+    ax = (x < 0) ? -x : x;
+    ay = (y < 0) ? -y : y;
+    if (ax == 0 && ay == 0) {
+        return 0;
+    }
+    z = (ay < ax) ? (ay / ax) : (ax / ay);
+    z2 = z * z;
+    a = z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f + z2 * (-0.11643287f
+        + z2 * (0.05265332f + z2 * -0.01172120f)))));
+    if (ay > ax) {
+        a = 1.57079632679489662f - a;
+    }
+    if (x < 0) {
+        a = 3.14159265358979324f - a;
+    }
+    return (y < 0) ? -a : a;
+}
+#else
+static inline void hpm_mcl_math_sincos(float x, float *sin_x, float *cos_x)
+{
+    *sin_x = sinf(x);
+    *cos_x = cosf(x);
+}
+
+static inline float hpm_mcl_math_sin(float x)
+{
+    return sinf(x);
+}
+
+static inline float hpm_mcl_math_cos(float x)
+{
+    return cosf(x);
+}
+
+static inline float hpm_mcl_math_atan2(float y, float x)
+{
+    return atan2f(y, x);
+}
+#endif
+
 /**
  * @brief Enable Q format
  *
+ * HPM_MCL_Q_EN builds the control, filter and loop modules on int32_t values with
+ * MCL_Q_FRAC_BITS fractional bits instead of float. The interfaces carry volts, amperes
+ * and radians, so the default Q16.15 keeps an integer range of +-65536 for position and
+ * speed, products are formed in 64 bits and every result saturates instead of wrapping.
+ * Sensors, drivers and the user interface stay in float and are converted at the loop.
+ * Pid gains, iir coefficients and mcl_physical_para_q_t are given in the same format,
+ * e.g. MCL_MATH_FLOAT_TO_TYPE(0.05f). Iir poles close to the unit circle and small integral
+ * gains lose precision at 15 bits, raise MCL_Q_FRAC_BITS when the signal range allows.
+ *
  */
 #ifndef HPM_MCL_Q_EN
 typedef float hpm_mcl_type_t;
 #define MCL_MATH_IS_ZERO(x) MCL_FLOAT_IS_ZERO((x))
 #define MCL_MATH_CONVERT_FLOAT(x) (x)
+#define MCL_MATH_FLOAT_TO_TYPE(x) (x)
+#define MCL_MATH_CONST(x) (x)
+#define MCL_MATH_ADD(a, b) ((a) + (b))
+#define MCL_MATH_SUB(a, b) ((a) - (b))
+#define MCL_MATH_NEG(a) (-(a))
+#define MCL_MATH_MUL(a, b) ((a) * (b))
+#define MCL_MATH_MUL_INT(a, n) ((a) * (n))
+#define MCL_MATH_DIV(a, b) ((a) / (b))
+#define MCL_MATH_DIV2(a) ((a) / 2)
+#define MCL_MATH_SIN(x) hpm_mcl_math_sin((x))
+#define MCL_MATH_COS(x) hpm_mcl_math_cos((x))
+#define MCL_MATH_SINCOS(x, s, c) hpm_mcl_math_sincos((x), (s), (c))
+#define MCL_MATH_ATAN2(y, x) hpm_mcl_math_atan2((y), (x))
 #else
 typedef int32_t hpm_mcl_type_t;
+
+#if (MCL_Q_FRAC_BITS < 8) || (MCL_Q_FRAC_BITS > 28)
+#error "MCL_Q_FRAC_BITS out of range"
+#endif
+
+/* saturating add and subtract from the P extension, the intrinsic headers come with hpm_math */
+#if defined(__riscv_dsp) && defined(HPM_EN_MATH_DSP_LIB) && HPM_EN_MATH_DSP_LIB
+#define MCL_Q_USE_DSP (1)
+#if __riscv_xlen == 64
+#include <nds_intrinsic.h>
+#else
+#include "nds32_intrinsic.h"
+#endif
+#endif
+
+#define MCL_Q_ONE       (1L << MCL_Q_FRAC_BITS)
+#define MCL_Q_MAX       (INT32_MAX)
+#define MCL_Q_MIN       (INT32_MIN)
+#define MCL_Q30_ONE     (1L << 30)
+
+/**
+ * @brief Constant to Q format at compile time, rounded to nearest
+ *
+ */
+#define MCL_Q(x) ((int32_t)((x) * (float)MCL_Q_ONE + (((x) < 0) ? -0.5f : 0.5f)))
+#define MCL_Q30(x) ((int32_t)((x) * 1073741824.0 + (((x) < 0) ? -0.5 : 0.5)))
+
+static inline int32_t hpm_mcl_q_sat(int64_t x)
+{
+    if (x > MCL_Q_MAX) {
+        return MCL_Q_MAX;
+    } else if (x < MCL_Q_MIN) {
+        return MCL_Q_MIN;
+    }
+    return (int32_t)x;
+}
+
+static inline int32_t hpm_mcl_q_add(int32_t a, int32_t b)
+{
+#if defined(MCL_Q_USE_DSP)
+    return __nds__kaddw(a, b);
+#else
+    return hpm_mcl_q_sat((int64_t)a + b);
+#endif
+}
+
+static inline int32_t hpm_mcl_q_sub(int32_t a, int32_t b)
+{
+#if defined(MCL_Q_USE_DSP)
+    return __nds__ksubw(a, b);
+#else
+    return hpm_mcl_q_sat((int64_t)a - b);
+#endif
+}
+
+static inline int32_t hpm_mcl_q_neg(int32_t a)
+{
+    return (a == MCL_Q_MIN) ? MCL_Q_MAX : -a;
+}
+
+static inline int32_t hpm_mcl_q_mul(int32_t a, int32_t b)
+{
+    return hpm_mcl_q_sat(((int64_t)a * b + (1L << (MCL_Q_FRAC_BITS - 1))) >> MCL_Q_FRAC_BITS);
+}
+
+static inline int32_t hpm_mcl_q_div(int32_t a, int32_t b)
+{
+    if (b == 0) {
+        return (a < 0) ? MCL_Q_MIN : MCL_Q_MAX;
+    }
+    return hpm_mcl_q_sat(((int64_t)a << MCL_Q_FRAC_BITS) / b);
+}
+
+static inline int32_t hpm_mcl_q_from_float(float x)
+{
+    x = x * (float)MCL_Q_ONE;
+    if (x >= 2147483520.0f) {
+        return MCL_Q_MAX;
+    } else if (x <= -2147483648.0f) {
+        return MCL_Q_MIN;
+    }
+    return (int32_t)((x < 0) ? (x - 0.5f) : (x + 0.5f));
+}
+
+static inline int32_t hpm_mcl_q30_mul(int32_t a, int32_t b)
+{
+    return (int32_t)(((int64_t)a * b + (1L << 29)) >> 30);
+}
+
+/**
+ * @brief sin and cos of a Q angle in radians, the angle is reduced to [-pi/4, pi/4] by the
+ * nearest multiple of pi/2 in 64 bits, the polynomials of the float fast math are evaluated
+ * in Q30. Max error is one LSB of MCL_Q_FRAC_BITS for any input.
+ *
+ */
+static inline void hpm_mcl_math_q_sincos(int32_t x, int32_t *sin_x, int32_t *cos_x)
+{
+    int64_t u;
+    int32_t k, r, r2, s, c;
+
+    /* x * 2/pi with 32 more fractional bits, k is the nearest quadrant */
+    u = (int64_t)x * 2734261102LL;
+    k = (int32_t)((u + (1LL << (MCL_Q_FRAC_BITS + 31))) >> (MCL_Q_FRAC_BITS + 32));
+    /* r = (x * 2/pi - k) * pi/2 in Q30, |r| <= pi/4 */
+    r = (int32_t)((u - ((int64_t)k << (MCL_Q_FRAC_BITS + 32))) >> (MCL_Q_FRAC_BITS + 2));
+    r = hpm_mcl_q30_mul(r, MCL_Q30(1.5707963267948966));
+    r2 = hpm_mcl_q30_mul(r, r);
+    s = MCL_Q30(-1.6666654611e-1) + hpm_mcl_q30_mul(r2, MCL_Q30(8.3321608736e-3) + hpm_mcl_q30_mul(r2, MCL_Q30(-1.9515295891e-4)));
+    s = r + hpm_mcl_q30_mul(hpm_mcl_q30_mul(r, r2), s);
+    c = MCL_Q30(4.166664568298827e-2) + hpm_mcl_q30_mul(r2, MCL_Q30(-1.388731625493765e-3) + hpm_mcl_q30_mul(r2, MCL_Q30(2.443315711809948e-5)));
+    c = MCL_Q30_ONE - (r2 >> 1) + hpm_mcl_q30_mul(hpm_mcl_q30_mul(r2, r2), c);
+    s = (s + (1L << (29 - MCL_Q_FRAC_BITS))) >> (30 - MCL_Q_FRAC_BITS);
+    c = (c + (1L << (29 - MCL_Q_FRAC_BITS))) >> (30 - MCL_Q_FRAC_BITS);
+    switch ((uint32_t)k & 3) {
+    case 0:
+        *sin_x = s;
+        *cos_x = c;
+        break;
+    case 1:
+        *sin_x = c;
+        *cos_x = -s;
+        break;
+    case 2:
+        *sin_x = -s;
+        *cos_x = -c;
+        break;
+    default:
+        *sin_x = -c;
+        *cos_x = s;
+        break;
+    }
+}
+
+static inline int32_t hpm_mcl_math_q_sin(int32_t x)
+{
+    int32_t s, c;
+
+    hpm_mcl_math_q_sincos(x, &s, &c);
+    return s;
+}
+
+static inline int32_t hpm_mcl_math_q_cos(int32_t x)
+{
+    int32_t s, c;
+
+    hpm_mcl_math_q_sincos(x, &s, &c);
+    return c;
+}
+
+/**
+ * @brief atan2 of Q values, one 64 bit division for the ratio in Q30 and the polynomial of
+ * the float fast math, the result is a Q angle in radians, atan2(0, 0) is 0.
+ *
+ */
+static inline int32_t hpm_mcl_math_q_atan2(int32_t y, int32_t x)
+{
+    int64_t ax, ay;
+    int32_t z, z2, a;
+
+    ax = (x < 0) ? -(int64_t)x : x;
+    ay = (y < 0) ? -(int64_t)y : y;
+    if (ax == 0 && ay == 0) {
+        return 0;
+    }
+    z = (int32_t)((ay < ax) ? ((ay << 30) / ax) : ((ax << 30) / ay));
+    z2 = hpm_mcl_q30_mul(z, z);
+    a = MCL_Q30(0.05265332) + hpm_mcl_q30_mul(z2, MCL_Q30(-0.01172120));
+    a = MCL_Q30(-0.11643287) + hpm_mcl_q30_mul(z2, a);
+    a = MCL_Q30(0.19354346) + hpm_mcl_q30_mul(z2, a);
+    a = MCL_Q30(-0.33262347) + hpm_mcl_q30_mul(z2, a);
+    a = hpm_mcl_q30_mul(z, MCL_Q30(0.99997726) + hpm_mcl_q30_mul(z2, a));
+    if (ay > ax) {
+        a = MCL_Q30(1.5707963267948966) - a;
+    }
+    a = (a + (1L << (29 - MCL_Q_FRAC_BITS))) >> (30 - MCL_Q_FRAC_BITS);
+    if (x < 0) {
+        a = MCL_Q(3.14159265358979324f) - a;
+    }
+    return (y < 0) ? -a : a;
+}
+
 #define MCL_MATH_IS_ZERO(x) (x == 0)
-#define MCL_MATH_CONVERT_FLOAT(x) (x)
+#define MCL_MATH_CONVERT_FLOAT(x) ((float)(x) * (1.0f / MCL_Q_ONE))
+#define MCL_MATH_FLOAT_TO_TYPE(x) hpm_mcl_q_from_float((x))
+#define MCL_MATH_CONST(x) MCL_Q((x))
+#define MCL_MATH_ADD(a, b) hpm_mcl_q_add((a), (b))
+#define MCL_MATH_SUB(a, b) hpm_mcl_q_sub((a), (b))
+#define MCL_MATH_NEG(a) hpm_mcl_q_neg((a))
+#define MCL_MATH_MUL(a, b) hpm_mcl_q_mul((a), (b))
+#define MCL_MATH_MUL_INT(a, n) hpm_mcl_q_sat((int64_t)(a) * (n))
+#define MCL_MATH_DIV(a, b) hpm_mcl_q_div((a), (b))
+#define MCL_MATH_DIV2(a) ((a) >> 1)
+#define MCL_MATH_SIN(x) hpm_mcl_math_q_sin((x))
+#define MCL_MATH_COS(x) hpm_mcl_math_q_cos((x))
+#define MCL_MATH_SINCOS(x, s, c) hpm_mcl_math_q_sincos((x), (s), (c))
+#define MCL_MATH_ATAN2(y, x) hpm_mcl_math_q_atan2((y), (x))
 #endif
 
 #endif
@@ -112,6 +112,11 @@ typedef struct {
     physical_time_t time;
 } mcl_physical_para_t;
 
+/**
+ * @brief Physical parameters in the format of hpm_mcl_type_t, the loop takes vbus, ld, lq and flux from here
+ * when HPM_MCL_Q_EN is defined
+ *
+ */
 typedef struct {
     physical_motor_q_t motor;
     physical_board_q_t board;
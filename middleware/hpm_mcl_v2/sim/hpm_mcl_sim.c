@@ -0,0 +1,408 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "hpm_mcl_sim.h"
+
+#define MCL_SIM_SQRT3           (1.7320508075688772f)
+#define MCL_SIM_PHASE_BLDC_NUM  (3)
+
+static mcl_sim_t *s_sim;
+
+static void hpm_mcl_sim_drivers_init(void)
+{
+}
+
+static hpm_mcl_stat_t hpm_mcl_sim_update_duty_cycle(mcl_drivers_channel_t chn, float duty)
+{
+    MCL_ASSERT((uint32_t)chn < MCL_SIM_DRIVERS_CHN_NUM, mcl_invalid_argument);
+    s_sim->duty[chn] = duty;
+    return mcl_success;
+}
+
+/**
+ * @brief A paired channel a, b or c switches both transistors of its half bridge,
+ *        the plant only looks at the high and low side channels of each phase
+ *
+ */
+static void hpm_mcl_sim_set_enable(mcl_drivers_channel_t chn, bool enable)
+{
+    s_sim->enable[chn] = enable;
+    if (chn <= mcl_drivers_chn_c) {
+        s_sim->enable[mcl_drivers_chn_ah + 2 * chn] = enable;
+        s_sim->enable[mcl_drivers_chn_al + 2 * chn] = enable;
+    }
+}
+
+static hpm_mcl_stat_t hpm_mcl_sim_disable_drivers(mcl_drivers_channel_t chn)
+{
+    MCL_ASSERT((uint32_t)chn < MCL_SIM_DRIVERS_CHN_NUM, mcl_invalid_argument);
+    hpm_mcl_sim_set_enable(chn, false);
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t hpm_mcl_sim_enable_drivers(mcl_drivers_channel_t chn)
+{
+    MCL_ASSERT((uint32_t)chn < MCL_SIM_DRIVERS_CHN_NUM, mcl_invalid_argument);
+    hpm_mcl_sim_set_enable(chn, true);
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t hpm_mcl_sim_disable_all_drivers(void)
+{
+    for (uint32_t i = 0; i < MCL_SIM_DRIVERS_CHN_NUM; i++) {
+        s_sim->enable[i] = false;
+    }
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t hpm_mcl_sim_enable_all_drivers(void)
+{
+    for (uint32_t i = 0; i < MCL_SIM_DRIVERS_CHN_NUM; i++) {
+        s_sim->enable[i] = true;
+    }
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t hpm_mcl_sim_analog_init(void)
+{
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t hpm_mcl_sim_update_sample_location(mcl_analog_chn_t chn, uint32_t tick)
+{
+    (void)chn;
+    (void)tick;
+    return mcl_success;
+}
+
+/**
+ * @brief Inverse of the scaling done by hpm_mcl_analog_get_value. Phase currents are reported
+ *        with the inverted sign of a low side shunt amplifier, which is the polarity the svpwm
+ *        sector tables assume for a duty that is the high side on time. Stepper current sensing
+ *        only sees the magnitude, the loop restores the sign from the electrical angle.
+ *
+ */
+static hpm_mcl_stat_t hpm_mcl_sim_get_value(mcl_analog_chn_t chn, int32_t *value)
+{
+    physical_board_analog_t *board;
+    float val;
+
+    MCL_ASSERT((uint32_t)chn < MCL_ANALOG_CHN_NUM, mcl_invalid_argument);
+    switch (chn) {
+    case analog_a_current:
+        val = (s_sim->cfg.type == sim_motor_step) ? fabsf(s_sim->ia) : -s_sim->ia;
+        break;
+    case analog_b_current:
+        val = (s_sim->cfg.type == sim_motor_step) ? fabsf(s_sim->ib) : -s_sim->ib;
+        break;
+    case analog_c_current:
+        val = -s_sim->ic;
+        break;
+    case analog_a_voltage:
+    case analog_b_voltage:
+    case analog_c_voltage:
+        val = s_sim->pole_voltage[chn - analog_a_voltage];
+        break;
+    case analog_vbus:
+        val = s_sim->cfg.vbus;
+        break;
+    default:
+        return mcl_invalid_argument;
+    }
+    board = &s_sim->mcl_cfg->physical.board.analog[chn];
+    MCL_ASSERT(board->adc_reference_vol != 0, mcl_invalid_argument);
+    val = val * board->sample_res * board->opamp_gain * board->sample_precision / board->adc_reference_vol;
+    *value = (int32_t)((val >= 0) ? (val + 0.5f) : (val - 0.5f)) + s_sim->cfg.adc_offset;
+
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t hpm_mcl_sim_encoder_init(void)
+{
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t hpm_mcl_sim_start_sample(void)
+{
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t hpm_mcl_sim_get_theta(float *theta)
+{
+    float val = s_sim->theta;
+
+    if (s_sim->cfg.encoder_lines != 0) {
+        val = floorf(val * s_sim->cfg.encoder_lines / MCL_2PI) * MCL_2PI / s_sim->cfg.encoder_lines;
+    }
+    *theta = val;
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t hpm_mcl_sim_get_absolute_theta(float *theta)
+{
+    *theta = s_sim->position;
+    return mcl_success;
+}
+
+/**
+ * @brief 120 degree hall signals, placed to match the commutation table of hpm_mcl_drivers_block_update
+ *
+ */
+static hpm_mcl_stat_t hpm_mcl_sim_get_uvw_level(mcl_encoder_uvw_level_t *level)
+{
+    float theta_e = s_sim->theta * s_sim->cfg.pole_num + MCL_PI / 6;
+
+    level->u = sinf(theta_e) >= 0;
+    level->v = sinf(theta_e + 2 * MCL_PI / 3) >= 0;
+    level->w = sinf(theta_e - 2 * MCL_PI / 3) >= 0;
+    return mcl_success;
+}
+
+/**
+ * @brief Stationary frame voltage of a three-phase bridge. A phase with both transistors off is
+ *        taken to sit at the mean of the driven phases plus its back-emf, with fewer than two
+ *        driven phases no current can flow.
+ *
+ */
+static bool hpm_mcl_sim_bldc_voltage(mcl_sim_t *sim, float sinx, float cosx, float *valpha, float *vbeta)
+{
+    float emf[MCL_SIM_PHASE_BLDC_NUM];
+    float we_flux = sim->speed * sim->cfg.pole_num * sim->cfg.flux;
+    float sum = 0;
+    uint32_t driven = 0;
+    bool floating[MCL_SIM_PHASE_BLDC_NUM];
+    float *pole = sim->pole_voltage;
+
+    emf[0] = -we_flux * sinx;
+    emf[1] = -we_flux * (-0.5f * sinx - 0.5f * MCL_SIM_SQRT3 * cosx);
+    emf[2] = -we_flux * (-0.5f * sinx + 0.5f * MCL_SIM_SQRT3 * cosx);
+    for (uint32_t i = 0; i < MCL_SIM_PHASE_BLDC_NUM; i++) {
+        floating[i] = false;
+        if (sim->enable[mcl_drivers_chn_ah + 2 * i]) {
+            pole[i] = sim->duty[mcl_drivers_chn_a + i] * sim->cfg.vbus;
+        } else if (sim->enable[mcl_drivers_chn_al + 2 * i]) {
+            pole[i] = 0;
+        } else {
+            floating[i] = true;
+            continue;
+        }
+        sum += pole[i];
+        driven++;
+    }
+    if (driven < 2) {
+        for (uint32_t i = 0; i < MCL_SIM_PHASE_BLDC_NUM; i++) {
+            pole[i] = floating[i] ? emf[i] : pole[i];
+        }
+        return false;
+    }
+    for (uint32_t i = 0; i < MCL_SIM_PHASE_BLDC_NUM; i++) {
+        if (floating[i]) {
+            pole[i] = sum / driven + emf[i];
+        }
+    }
+    *valpha = (2.0f / 3.0f) * (pole[0] - 0.5f * (pole[1] + pole[2]));
+    *vbeta = (pole[1] - pole[2]) / MCL_SIM_SQRT3;
+    return true;
+}
+
+static void hpm_mcl_sim_step_voltage(mcl_sim_t *sim, float *valpha, float *vbeta)
+{
+    for (uint32_t i = 0; i < 2; i++) {
+        sim->pole_voltage[i] = 0;
+        if (sim->enable[mcl_drivers_chn_a1 + 2 * i]) {
+            sim->pole_voltage[i] += sim->duty[mcl_drivers_chn_a1 + 2 * i] * sim->cfg.vbus;
+        }
+        if (sim->enable[mcl_drivers_chn_a0 + 2 * i]) {
+            sim->pole_voltage[i] -= sim->duty[mcl_drivers_chn_a0 + 2 * i] * sim->cfg.vbus;
+        }
+    }
+    sim->pole_voltage[2] = 0;
+    *valpha = sim->pole_voltage[0];
+    *vbeta = sim->pole_voltage[1];
+}
+
+void hpm_mcl_sim_get_default_cfg(mcl_sim_cfg_t *cfg, mcl_sim_motor_type_t type, mcl_cfg_t *mcl_cfg)
+{
+    physical_motor_t *motor = &mcl_cfg->physical.motor;
+
+    cfg->type = type;
+    cfg->res = motor->res;
+    cfg->ld = (motor->ld != 0) ? motor->ld : motor->ls;
+    cfg->lq = (motor->lq != 0) ? motor->lq : motor->ls;
+    cfg->flux = motor->flux;
+    cfg->inertia = motor->inertia;
+    cfg->friction = 0;
+    cfg->load_torque = 0;
+    cfg->vbus = motor->vbus;
+    cfg->pole_num = motor->pole_num;
+    cfg->ts = mcl_cfg->physical.time.current_loop_ts;
+    cfg->sub_steps = 10;
+    cfg->encoder_lines = 0;
+    cfg->adc_offset = 0;
+}
+
+hpm_mcl_stat_t hpm_mcl_sim_init(mcl_sim_t *sim, mcl_sim_cfg_t *cfg, mcl_cfg_t *mcl_cfg)
+{
+    MCL_ASSERT(sim != NULL, mcl_invalid_pointer);
+    MCL_ASSERT(cfg != NULL, mcl_invalid_pointer);
+    MCL_ASSERT(mcl_cfg != NULL, mcl_invalid_pointer);
+    MCL_ASSERT((cfg->ld > 0) && (cfg->lq > 0) && (cfg->inertia > 0), mcl_invalid_argument);
+    MCL_ASSERT((cfg->ts > 0) && (cfg->sub_steps != 0) && (cfg->pole_num > 0), mcl_invalid_argument);
+
+    memset(sim, 0, sizeof(mcl_sim_t));
+    sim->cfg = *cfg;
+    sim->mcl_cfg = mcl_cfg;
+    for (uint32_t i = 0; i < MCL_SIM_DRIVERS_CHN_NUM; i++) {
+        sim->enable[i] = true;
+    }
+    return mcl_success;
+}
+
+void hpm_mcl_sim_set_callback(mcl_sim_t *sim, mcl_drivers_cfg_t *drivers, mcl_analog_cfg_t *analog, mcl_encoer_cfg_t *encoder)
+{
+    s_sim = sim;
+    if (drivers != NULL) {
+        drivers->callback.init = hpm_mcl_sim_drivers_init;
+        drivers->callback.update_duty_cycle = hpm_mcl_sim_update_duty_cycle;
+        drivers->callback.disable_all_drivers = hpm_mcl_sim_disable_all_drivers;
+        drivers->callback.enable_all_drivers = hpm_mcl_sim_enable_all_drivers;
+        drivers->callback.disable_drivers = hpm_mcl_sim_disable_drivers;
+        drivers->callback.enable_drivers = hpm_mcl_sim_enable_drivers;
+    }
+    if (analog != NULL) {
+        analog->callback.init = hpm_mcl_sim_analog_init;
+        analog->callback.update_sample_location = hpm_mcl_sim_update_sample_location;
+        analog->callback.get_value = hpm_mcl_sim_get_value;
+    }
+    if (encoder != NULL) {
+        encoder->callback.init = hpm_mcl_sim_encoder_init;
+        encoder->callback.start_sample = hpm_mcl_sim_start_sample;
+        encoder->callback.get_theta = hpm_mcl_sim_get_theta;
+        encoder->callback.get_absolute_theta = hpm_mcl_sim_get_absolute_theta;
+        encoder->callback.get_uvw_level = hpm_mcl_sim_get_uvw_level;
+    }
+}
+
+/**
+ * @brief Semi-implicit Euler on the dq model:
+ *        did/dt = (vd - R id + we Lq iq) / Ld
+ *        diq/dt = (vq - R iq - we Ld id - we flux) / Lq
+ *        dw/dt = (k p (flux iq + (Ld - Lq) id iq) - B w - TL) / J, k = 1.5 for three phases, 1 for two
+ *
+ */
+void hpm_mcl_sim_step(mcl_sim_t *sim)
+{
+    mcl_sim_cfg_t *cfg = &sim->cfg;
+    float dt = cfg->ts / cfg->sub_steps;
+    float k = (cfg->type == sim_motor_step) ? 1.0f : 1.5f;
+    float valpha = 0, vbeta = 0;
+    float vd, vq, we, te, did, diq;
+    float sinx, cosx;
+    float ialpha, ibeta;
+    bool conduct;
+
+    for (uint32_t i = 0; i < cfg->sub_steps; i++) {
+        hpm_mcl_math_sincos(sim->theta * cfg->pole_num, &sinx, &cosx);
+        if (cfg->type == sim_motor_step) {
+            hpm_mcl_sim_step_voltage(sim, &valpha, &vbeta);
+            conduct = true;
+        } else {
+            conduct = hpm_mcl_sim_bldc_voltage(sim, sinx, cosx, &valpha, &vbeta);
+        }
+        we = sim->speed * cfg->pole_num;
+        if (conduct) {
+            vd = valpha * cosx + vbeta * sinx;
+            vq = -valpha * sinx + vbeta * cosx;
+            did = (vd - cfg->res * sim->id + we * cfg->lq * sim->iq) / cfg->ld;
+            diq = (vq - cfg->res * sim->iq - we * cfg->ld * sim->id - we * cfg->flux) / cfg->lq;
+            sim->id += did * dt;
+            sim->iq += diq * dt;
+        } else {
+            sim->id = 0;
+            sim->iq = 0;
+        }
+        te = k * cfg->pole_num * (cfg->flux * sim->iq + (cfg->ld - cfg->lq) * sim->id * sim->iq);
+        sim->speed += (te - cfg->friction * sim->speed - cfg->load_torque) / cfg->inertia * dt;
+        sim->position += sim->speed * dt;
+        sim->theta = MCL_ANGLE_MOD_X(0, MCL_2PI, sim->theta + sim->speed * dt);
+    }
+
+    hpm_mcl_math_sincos(sim->theta * cfg->pole_num, &sinx, &cosx);
+    ialpha = sim->id * cosx - sim->iq * sinx;
+    ibeta = sim->id * sinx + sim->iq * cosx;
+    if (cfg->type == sim_motor_step) {
+        sim->ia = ialpha;
+        sim->ib = ibeta;
+        sim->ic = 0;
+    } else {
+        sim->ia = ialpha;
+        sim->ib = -0.5f * ialpha + 0.5f * MCL_SIM_SQRT3 * ibeta;
+        sim->ic = -sim->ia - sim->ib;
+    }
+    sim->step_count++;
+}
+
+void hpm_mcl_sim_timing_init(mcl_sim_timing_t *timing, uint32_t bin_width)
+{
+    memset(timing, 0, sizeof(mcl_sim_timing_t));
+    timing->bin_width = (bin_width != 0) ? bin_width : 1;
+}
+
+void hpm_mcl_sim_timing_record(mcl_sim_timing_t *timing, uint32_t ticks)
+{
+    uint32_t bin = ticks / timing->bin_width;
+
+    if (bin < MCL_SIM_TIMING_BIN_NUM) {
+        timing->bins[bin]++;
+    } else {
+        timing->overflow++;
+    }
+    if (ticks > timing->max) {
+        timing->max = ticks;
+    }
+    timing->sum += ticks;
+    timing->count++;
+}
+
+uint32_t hpm_mcl_sim_timing_percentile(mcl_sim_timing_t *timing, float percent)
+{
+    uint32_t target;
+    uint32_t acc = 0;
+
+    if (timing->count == 0) {
+        return 0;
+    }
+    target = (uint32_t)ceilf(timing->count * percent / 100.0f);
+    if (target == 0) {
+        target = 1;
+    }
+    for (uint32_t i = 0; i < MCL_SIM_TIMING_BIN_NUM; i++) {
+        acc += timing->bins[i];
+        if (acc >= target) {
+            return (i + 1) * timing->bin_width;
+        }
+    }
+    return timing->max;
+}
+
+void hpm_mcl_sim_error_record(mcl_sim_error_t *error, float ref, float actual)
+{
+    float err = actual - ref;
+
+    error->sum_sq += (double)err * err;
+    if (fabsf(err) > error->max_abs) {
+        error->max_abs = fabsf(err);
+    }
+    error->count++;
+}
+
+float hpm_mcl_sim_error_rms(mcl_sim_error_t *error)
+{
+    if (error->count == 0) {
+        return 0;
+    }
+    return (float)sqrt(error->sum_sq / error->count);
+}
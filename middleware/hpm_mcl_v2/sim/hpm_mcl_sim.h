@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef HPM_MCL_SIM_H
+#define HPM_MCL_SIM_H
+
+#include "hpm_mcl_common.h"
+#include "hpm_mcl_drivers.h"
+#include "hpm_mcl_analog.h"
+#include "hpm_mcl_encoder.h"
+
+/**
+ * @brief Number of bins of the execution time histogram
+ *
+ */
+#ifndef MCL_SIM_TIMING_BIN_NUM
+#define MCL_SIM_TIMING_BIN_NUM  (256)
+#endif
+
+#define MCL_SIM_DRIVERS_CHN_NUM (mcl_drivers_chn_cl + 1)
+
+/**
+ * @brief Type of the simulated motor
+ *
+ */
+typedef enum {
+    sim_motor_bldc = 0,     /**< three-phase pmsm/bldc, bridge channels a, b, c or ah - cl */
+    sim_motor_step = 1,     /**< two-phase hybrid stepper, bridge channels a0, a1, b0, b1 */
+} mcl_sim_motor_type_t;
+
+/**
+ * @brief Plant parameters, may differ from the @ref mcl_cfg_t the control code was tuned with
+ *
+ */
+typedef struct {
+    mcl_sim_motor_type_t type;
+    float res;          /**< phase resistance, ohms */
+    float ld;           /**< d-axis inductance, H */
+    float lq;           /**< q-axis inductance, H */
+    float flux;         /**< permanent magnet flux linkage, Wb */
+    float inertia;      /**< kgm^2 */
+    float friction;     /**< viscous friction, Nm/(rad/s) */
+    float load_torque;  /**< constant load torque, Nm, may be changed between steps */
+    float vbus;         /**< bus voltage, V */
+    int32_t pole_num;   /**< pole pairs */
+    float ts;           /**< time advanced by one @ref hpm_mcl_sim_step, s */
+    uint32_t sub_steps; /**< integration steps per @ref hpm_mcl_sim_step */
+    uint32_t encoder_lines; /**< angle quantisation per revolution, 0 - ideal encoder */
+    int32_t adc_offset; /**< offset added to every simulated adc value */
+} mcl_sim_cfg_t;
+
+/**
+ * @brief Plant state
+ *
+ */
+typedef struct {
+    mcl_sim_cfg_t cfg;
+    mcl_cfg_t *mcl_cfg;
+    float id;
+    float iq;
+    float speed;        /**< mechanical speed, rad/s */
+    float theta;        /**< mechanical angle, 0 - 2pi */
+    float position;     /**< unwrapped mechanical angle, rad */
+    float ia;           /**< phase a current, alpha current of a stepper */
+    float ib;           /**< phase b current, beta current of a stepper */
+    float ic;
+    float pole_voltage[3];
+    float duty[MCL_SIM_DRIVERS_CHN_NUM];
+    bool enable[MCL_SIM_DRIVERS_CHN_NUM];
+    uint32_t step_count;
+} mcl_sim_t;
+
+/**
+ * @brief Histogram of execution times, the unit is whatever the caller counts in,
+ *        e.g. mcycle on the target or clock_gettime ns on a host
+ *
+ */
+typedef struct {
+    uint32_t bin_width;
+    uint32_t bins[MCL_SIM_TIMING_BIN_NUM];
+    uint32_t overflow;
+    uint32_t count;
+    uint32_t max;
+    uint64_t sum;
+} mcl_sim_timing_t;
+
+/**
+ * @brief Tracking error accumulator
+ *
+ */
+typedef struct {
+    double sum_sq;
+    float max_abs;
+    uint32_t count;
+} mcl_sim_error_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Fill the plant parameters from the motor parameters of the control configuration
+ *
+ * @param cfg @ref mcl_sim_cfg_t
+ * @param type @ref mcl_sim_motor_type_t
+ * @param mcl_cfg @ref mcl_cfg_t
+ */
+void hpm_mcl_sim_get_default_cfg(mcl_sim_cfg_t *cfg, mcl_sim_motor_type_t type, mcl_cfg_t *mcl_cfg);
+
+/**
+ * @brief Initialise the plant at standstill, all driver channels enabled
+ *
+ * @param sim @ref mcl_sim_t
+ * @param cfg @ref mcl_sim_cfg_t
+ * @param mcl_cfg board parameters used to scale the simulated adc values
+ * @return hpm_mcl_stat_t
+ */
+hpm_mcl_stat_t hpm_mcl_sim_init(mcl_sim_t *sim, mcl_sim_cfg_t *cfg, mcl_cfg_t *mcl_cfg);
+
+/**
+ * @brief Point the driver, analog and encoder callbacks at the plant, any of the configurations may be NULL.
+ *        The callbacks have no context argument, so only one plant is bound at a time.
+ *
+ * @param sim @ref mcl_sim_t
+ * @param drivers @ref mcl_drivers_cfg_t
+ * @param analog @ref mcl_analog_cfg_t
+ * @param encoder @ref mcl_encoer_cfg_t
+ */
+void hpm_mcl_sim_set_callback(mcl_sim_t *sim, mcl_drivers_cfg_t *drivers, mcl_analog_cfg_t *analog, mcl_encoer_cfg_t *encoder);
+
+/**
+ * @brief Advance the plant by cfg.ts with the duty cycles last written by the loop
+ *
+ * @param sim @ref mcl_sim_t
+ */
+void hpm_mcl_sim_step(mcl_sim_t *sim);
+
+/**
+ * @brief Clear the histogram
+ *
+ * @param timing @ref mcl_sim_timing_t
+ * @param bin_width ticks per bin, MCL_SIM_TIMING_BIN_NUM * bin_width should cover the slowest expected call
+ */
+void hpm_mcl_sim_timing_init(mcl_sim_timing_t *timing, uint32_t bin_width);
+
+/**
+ * @brief Add one execution time
+ *
+ * @param timing @ref mcl_sim_timing_t
+ * @param ticks execution time
+ */
+void hpm_mcl_sim_timing_record(mcl_sim_timing_t *timing, uint32_t ticks);
+
+/**
+ * @brief Execution time below which the given share of calls completed,
+ *        resolution is one bin, samples beyond the last bin are reported as the maximum
+ *
+ * @param timing @ref mcl_sim_timing_t
+ * @param percent 0 - 100
+ * @return upper edge of the bin in ticks
+ */
+uint32_t hpm_mcl_sim_timing_percentile(mcl_sim_timing_t *timing, float percent);
+
+/**
+ * @brief Add one sample of reference and measured value
+ *
+ * @param error @ref mcl_sim_error_t
+ * @param ref reference
+ * @param actual value reached by the plant
+ */
+void hpm_mcl_sim_error_record(mcl_sim_error_t *error, float ref, float actual);
+
+/**
+ * @brief Root mean square of the recorded errors
+ *
+ * @param error @ref mcl_sim_error_t
+ * @return rms error, 0 if nothing was recorded
+ */
+float hpm_mcl_sim_error_rms(mcl_sim_error_t *error);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024 HPMicro
+# SPDX-License-Identifier: BSD-3-Clause
+"""
+Decode the hpm_mcl_v2 debug scope stream into csv.
+
+The frame layout is described in hpm_mcl_debug.h. The input is a raw capture
+of the link, either a file or a serial port (needs pyserial).
+
+    mcl_scope_decode.py capture.bin -o scope.csv --names ia,ib,speed
+    mcl_scope_decode.py --port /dev/ttyUSB0 --baud 2000000 -o scope.csv
+"""
+import argparse
+import struct
+import sys
+
+SYNC = b'\xaa\xbb'
+FRAME_DATA = 0x01
+FRAME_DESCRIPTOR = 0x02
+HEADER_SIZE = 16
+FLAG_TRIGGER = 1 << 0
+FLAG_LOST = 1 << 1
+FLAG_LAST = 1 << 2
+
+# type code -> struct format, the high byte of mcl_debug_data_type_t
+TYPES = {0: 'b', 1: 'h', 2: 'i', 3: 'f'}
+
+
+def fletcher16(data):
+    sum0 = 0
+    sum1 = 0
+    for b in data:
+        sum0 = (sum0 + b) % 255
+        sum1 = (sum1 + sum0) % 255
+    return (sum1 << 8) | sum0
+
+
+class Decoder:
+    def __init__(self):
+        self.buf = bytearray()
+        self.record = None
+        self.chn_num = 0
+        self.decimation = 1
+        self.bad = 0
+        self.lost = 0
+        self.next_seq = None
+
+    def feed(self, data):
+        """Append raw bytes, yield ('descriptor', types, decimation) and ('data', header, records)."""
+        self.buf += data
+        while True:
+            start = self.buf.find(SYNC)
+            if start < 0:
+                del self.buf[:-1]
+                return
+            del self.buf[:start]
+            if len(self.buf) < 4:
+                return
+            kind = self.buf[2]
+            chn_num = self.buf[3]
+            if kind == FRAME_DESCRIPTOR:
+                size = 8 + chn_num + 2
+            elif kind == FRAME_DATA:
+                if len(self.buf) < HEADER_SIZE:
+                    return
+                if self.record is None or chn_num != self.chn_num:
+                    # no matching descriptor yet, resync on the next frame
+                    del self.buf[:2]
+                    continue
+                record_num = struct.unpack_from('<H', self.buf, 6)[0]
+                size = HEADER_SIZE + record_num * self.record.size + 2
+            else:
+                del self.buf[:2]
+                continue
+            if len(self.buf) < size:
+                return
+            frame = bytes(self.buf[:size])
+            if struct.unpack_from('<H', frame, size - 2)[0] != fletcher16(frame[2:size - 2]):
+                self.bad += 1
+                del self.buf[:2]
+                continue
+            del self.buf[:size]
+            if kind == FRAME_DESCRIPTOR:
+                self.decimation = struct.unpack_from('<H', frame, 4)[0]
+                types = [TYPES[c] for c in frame[8:8 + chn_num]]
+                self.record = struct.Struct('<' + ''.join(types))
+                self.chn_num = chn_num
+                self.next_seq = None
+                yield ('descriptor', types, self.decimation)
+            else:
+                seq, record_num, first_index, flags, lost = struct.unpack_from('<HHIHH', frame, 4)
+                if self.next_seq is not None and seq != self.next_seq:
+                    self.bad += 1
+                self.next_seq = (seq + 1) & 0xffff
+                self.lost += lost
+                records = [self.record.unpack_from(frame, HEADER_SIZE + i * self.record.size)
+                           for i in range(record_num)]
+                yield ('data', (seq, first_index, flags, lost), records)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input', nargs='?', help='raw capture file')
+    parser.add_argument('--port', help='serial port to read instead of a file')
+    parser.add_argument('--baud', type=int, default=2000000)
+    parser.add_argument('-o', '--output', help='csv file, default stdout')
+    parser.add_argument('--names', help='comma separated channel names')
+    parser.add_argument('--ts', type=float, default=0.0, help='sample period in s, adds a time column')
+    args = parser.parse_args()
+
+    if args.port:
+        import serial
+        src = serial.Serial(args.port, args.baud, timeout=0.1)
+    elif args.input:
+        src = open(args.input, 'rb')
+    else:
+        parser.error('input file or --port is required')
+    out = open(args.output, 'w') if args.output else sys.stdout
+    names = args.names.split(',') if args.names else None
+
+    dec = Decoder()
+    try:
+        while True:
+            data = src.read(4096)
+            if not data:
+                if args.port:
+                    continue
+                break
+            for kind, head, body in dec.feed(data):
+                if kind == 'descriptor':
+                    cols = names if names and len(names) == len(head) else ['ch%d' % i for i in range(len(head))]
+                    time_col = ['time'] if args.ts > 0 else []
+                    out.write(','.join(['index'] + time_col + cols + ['trigger']) + '\n')
+                    continue
+                seq, first_index, flags, lost = head
+                for i, rec in enumerate(body):
+                    index = first_index + i
+                    row = [str(index)]
+                    if args.ts > 0:
+                        row.append('%.9g' % (index * dec.decimation * args.ts))
+                    row += ['%.9g' % v for v in rec]
+                    row.append('1' if i == 0 and flags & FLAG_TRIGGER else '0')
+                    out.write(','.join(row) + '\n')
+    except KeyboardInterrupt:
+        pass
+    sys.stderr.write('lost records %d, bad frames %d\n' % (dec.lost, dec.bad))
+
+
+if __name__ == '__main__':
+    main()
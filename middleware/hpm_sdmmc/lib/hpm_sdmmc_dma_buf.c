@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "hpm_sdmmc_dma_buf.h"
+#include "hpm_soc.h"
+#include "hpm_l1c_drv.h"
+
+static uint32_t s_noncacheable_start;
+static uint32_t s_noncacheable_size;
+static sdmmc_dma_buf_stats_t s_dma_buf_stats;
+
+static bool sdmmc_dma_buf_in_local_memory(uint32_t addr)
+{
+    (void) addr;
+#if defined(ADDRESS_IN_ILM)
+    if (ADDRESS_IN_ILM(addr)) {
+        return true;
+    }
+#endif
+#if defined(ADDRESS_IN_DLM)
+    if (ADDRESS_IN_DLM(addr)) {
+        return true;
+    }
+#endif
+#if defined(ADDRESS_IN_CORE0_ILM_SYSTEM)
+    if (ADDRESS_IN_CORE0_ILM_SYSTEM(addr)) {
+        return true;
+    }
+#endif
+#if defined(ADDRESS_IN_CORE0_DLM_SYSTEM)
+    if (ADDRESS_IN_CORE0_DLM_SYSTEM(addr)) {
+        return true;
+    }
+#endif
+#if defined(ADDRESS_IN_CORE1_ILM_SYSTEM)
+    if (ADDRESS_IN_CORE1_ILM_SYSTEM(addr)) {
+        return true;
+    }
+#endif
+#if defined(ADDRESS_IN_CORE1_DLM_SYSTEM)
+    if (ADDRESS_IN_CORE1_DLM_SYSTEM(addr)) {
+        return true;
+    }
+#endif
+    return false;
+}
+
+void sdmmc_dma_buf_set_noncacheable_region(uint32_t start, uint32_t size)
+{
+    s_noncacheable_start = start;
+    s_noncacheable_size = size;
+}
+
+bool sdmmc_dma_buf_is_cacheable(uint32_t addr, uint32_t size)
+{
+#if !defined(HPM_SDMMC_ENABLE_CACHE_MAINTENANCE) || (HPM_SDMMC_ENABLE_CACHE_MAINTENANCE == 1)
+    if ((size == 0U) || !l1c_dc_is_enabled()) {
+        return false;
+    }
+    if ((s_noncacheable_size != 0U) && (addr >= s_noncacheable_start) &&
+        ((addr - s_noncacheable_start) + size <= s_noncacheable_size)) {
+        return false;
+    }
+    return !sdmmc_dma_buf_in_local_memory(addr);
+#else
+    (void) addr;
+    (void) size;
+    return false;
+#endif
+}
+
+void sdmmc_dma_buf_prepare_tx(uint32_t addr, uint32_t size)
+{
+    if (!sdmmc_dma_buf_is_cacheable(addr, size)) {
+        s_dma_buf_stats.skipped_bytes += size;
+        return;
+    }
+    uint32_t aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN(addr);
+    uint32_t aligned_size = HPM_L1C_CACHELINE_ALIGN_UP(addr + size) - aligned_start;
+    l1c_dc_writeback(aligned_start, aligned_size);
+    s_dma_buf_stats.written_back_bytes += aligned_size;
+}
+
+void sdmmc_dma_buf_prepare_rx(uint32_t addr, uint32_t size)
+{
+    if (!sdmmc_dma_buf_is_cacheable(addr, size)) {
+        s_dma_buf_stats.skipped_bytes += size;
+        return;
+    }
+    uint32_t end = addr + size;
+    uint32_t inner_start = HPM_L1C_CACHELINE_ALIGN_UP(addr);
+    uint32_t inner_end = HPM_L1C_CACHELINE_ALIGN_DOWN(end);
+
+    /* Partial lines may hold dirty data next to the buffer, write it back before the DMA */
+    if (inner_start != addr) {
+        l1c_dc_flush(HPM_L1C_CACHELINE_ALIGN_DOWN(addr), HPM_L1C_CACHELINE_SIZE);
+        s_dma_buf_stats.flushed_bytes += HPM_L1C_CACHELINE_SIZE;
+    }
+    if ((inner_end != end) && (inner_end >= inner_start)) {
+        l1c_dc_flush(inner_end, HPM_L1C_CACHELINE_SIZE);
+        s_dma_buf_stats.flushed_bytes += HPM_L1C_CACHELINE_SIZE;
+    }
+    /* Whole lines are overwritten by the DMA, dropping them is enough */
+    if (inner_end > inner_start) {
+        l1c_dc_invalidate(inner_start, inner_end - inner_start);
+        s_dma_buf_stats.invalidated_bytes += inner_end - inner_start;
+    }
+}
+
+void sdmmc_dma_buf_complete_rx(uint32_t addr, uint32_t size)
+{
+    if (!sdmmc_dma_buf_is_cacheable(addr, size)) {
+        s_dma_buf_stats.skipped_bytes += size;
+        return;
+    }
+    uint32_t aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN(addr);
+    uint32_t aligned_size = HPM_L1C_CACHELINE_ALIGN_UP(addr + size) - aligned_start;
+    l1c_dc_invalidate(aligned_start, aligned_size);
+    s_dma_buf_stats.invalidated_bytes += aligned_size;
+}
+
+void sdmmc_dma_buf_get_stats(sdmmc_dma_buf_stats_t *stats)
+{
+    if (stats != NULL) {
+        *stats = s_dma_buf_stats;
+    }
+}
+
+void sdmmc_dma_buf_clear_stats(void)
+{
+    s_dma_buf_stats.flushed_bytes = 0;
+    s_dma_buf_stats.written_back_bytes = 0;
+    s_dma_buf_stats.invalidated_bytes = 0;
+    s_dma_buf_stats.skipped_bytes = 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_SDMMC_DMA_BUF_H
+#define HPM_SDMMC_DMA_BUF_H
+
+#include "hpm_common.h"
+
+/**
+ * @brief Cache maintenance statistics of the DMA buffers, in bytes of whole cache lines
+ */
+typedef struct {
+    uint64_t flushed_bytes;         /**< Written back and invalidated */
+    uint64_t written_back_bytes;    /**< Written back, lines stay valid */
+    uint64_t invalidated_bytes;     /**< Invalidated without write-back */
+    uint64_t skipped_bytes;         /**< Non-cacheable buffers or D-cache disabled, requested size */
+} sdmmc_dma_buf_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Declare a memory region that is not cached, e.g. the NONCACHEABLE_RAM of the linker script.
+ *        Buffers inside it and inside the core local memories are passed to DMA without cache maintenance.
+ *
+ * @param [in] start system address of the region
+ * @param [in] size size of the region in bytes, 0 removes the region
+ */
+void sdmmc_dma_buf_set_noncacheable_region(uint32_t start, uint32_t size);
+
+/**
+ * @brief Check whether a buffer needs cache maintenance before and after DMA
+ *
+ * @param [in] addr system address of the buffer
+ * @param [in] size buffer size in bytes
+ * @retval true the D-cache is enabled and the buffer is not in a non-cacheable region
+ */
+bool sdmmc_dma_buf_is_cacheable(uint32_t addr, uint32_t size);
+
+/**
+ * @brief Make a buffer visible to a DMA read of the memory (card write)
+ *
+ * @param [in] addr system address of the buffer
+ * @param [in] size bytes about to be transferred
+ */
+void sdmmc_dma_buf_prepare_tx(uint32_t addr, uint32_t size);
+
+/**
+ * @brief Prepare a buffer for a DMA write of the memory (card read)
+ *
+ * Cache lines shared with neighbouring data are flushed, lines owned by the buffer are only invalidated.
+ *
+ * @param [in] addr system address of the buffer
+ * @param [in] size bytes about to be transferred
+ */
+void sdmmc_dma_buf_prepare_rx(uint32_t addr, uint32_t size);
+
+/**
+ * @brief Drop lines fetched speculatively while the DMA was writing the buffer
+ *
+ * @note Writes to data sharing a cache line with the buffer during the transfer are lost
+ *
+ * @param [in] addr system address of the buffer
+ * @param [in] size bytes transferred
+ */
+void sdmmc_dma_buf_complete_rx(uint32_t addr, uint32_t size);
+
+/**
+ * @brief Get the cache maintenance statistics
+ *
+ * @note The counters are not updated atomically, concurrent transfers may lose counts
+ *
+ * @param [out] stats statistics
+ */
+void sdmmc_dma_buf_get_stats(sdmmc_dma_buf_stats_t *stats);
+
+/**
+ * @brief Clear the cache maintenance statistics
+ */
+void sdmmc_dma_buf_clear_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_SDMMC_DMA_BUF_H */
@@ -6,7 +6,7 @@
  */
 
 #include "hpm_sdmmc_emmc.h"
-#include "hpm_l1c_drv.h"
+#include "hpm_sdmmc_dma_buf.h"
 #include "hpm_clock_drv.h"
 
 #define SPEED_1Kbps (1000U)
@@ -854,17 +854,10 @@ hpm_stat_t emmc_read_blocks(emmc_card_t *card, uint8_t *buffer, uint32_t start_b
             data->rx_data = (uint32_t *) sdmmc_get_sys_addr(card->host, (uint32_t) buffer);
             content->data = data;
             content->command = cmd;
-#if !defined(HPM_SDMMC_ENABLE_CACHE_MAINTENANCE) || (HPM_SDMMC_ENABLE_CACHE_MAINTENANCE == 1)
-            uint32_t aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t) data->rx_data);
-            uint32_t end_addr = (uint32_t) data->rx_data + card->device_attribute.sector_size * block_count;
-            uint32_t aligned_end = HPM_L1C_CACHELINE_ALIGN_UP(end_addr);
-            uint32_t aligned_size = aligned_end - aligned_start;
-            l1c_dc_flush(aligned_start, aligned_size);
-#endif
+            uint32_t xfer_size = data->block_size * read_block_count;
+            sdmmc_dma_buf_prepare_rx((uint32_t) data->rx_data, xfer_size);
             status = emmc_transfer(card, content);
-#if !defined(HPM_SDMMC_ENABLE_CACHE_MAINTENANCE) || (HPM_SDMMC_ENABLE_CACHE_MAINTENANCE == 1)
-            l1c_dc_invalidate(aligned_start, aligned_size);
-#endif
+            sdmmc_dma_buf_complete_rx((uint32_t) data->rx_data, xfer_size);
             if (status != status_success) {
                 break;
             }
@@ -913,13 +906,7 @@ hpm_stat_t emmc_write_blocks(emmc_card_t *card, const uint8_t *buffer, uint32_t
             data->tx_data = (const uint32_t *) sdmmc_get_sys_addr(card->host, (uint32_t) buffer);
             content->data = data;
             content->command = cmd;
-#if !defined(HPM_SDMMC_ENABLE_CACHE_MAINTENANCE) || (HPM_SDMMC_ENABLE_CACHE_MAINTENANCE == 1)
-            uint32_t aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t) data->tx_data);
-            uint32_t aligned_end = HPM_L1C_CACHELINE_ALIGN_UP(
-                    (uint32_t) data->tx_data + card->device_attribute.sector_size * write_block_count);
-            uint32_t aligned_size = aligned_end - aligned_start;
-            l1c_dc_flush(aligned_start, aligned_size);
-#endif
+            sdmmc_dma_buf_prepare_tx((uint32_t) data->tx_data, data->block_size * write_block_count);
             status = emmc_transfer(card, content);
             if (status != status_success) {
                 break;
@@ -7,8 +7,11 @@
 
 #include "hpm_sdmmc_common.h"
 #include "hpm_sdmmc_host.h"
+#include "hpm_sdmmc_dma_buf.h"
 #include "board.h"
 
+#define SDMMCHOST_ASYNC_IRQ_MASK (SDXC_INT_STAT_XFER_COMPLETE_MASK | SDXC_STS_ERROR)
+
 
 static void sdmmchost_vsel_pin_control(sdmmc_host_t *host, hpm_sdmmc_io_volt_t io_volt);
 
@@ -19,6 +22,9 @@ static void sdmmchost_switch_to_3v3_as_needed(sdmmc_host_t *host);
 
 static hpm_stat_t sdmmchost_check_host_availablity(sdmmc_host_t *host);
 
+static hpm_stat_t sdmmchost_async_enqueue(sdmmc_host_t *host, sdmmchost_xfer_t *content,
+                                          sdmmchost_async_callback_t callback, void *user_data, bool cache_maintenance);
+
 static hpm_stat_t sdmmchost_check_host_availablity(sdmmc_host_t *host)
 {
     hpm_stat_t status = status_success;
@@ -70,6 +76,17 @@ hpm_stat_t sdmmchost_init(sdmmc_host_t *host)
 
         sdxc_init(host->host_param.base, &sdxc_config);
 
+        host->async_head = 0;
+        host->async_count = 0;
+        host->async_busy = false;
+#if defined(HPM_SDMMC_HOST_ENABLE_IRQ) && (HPM_SDMMC_HOST_ENABLE_IRQ == 1)
+        /* sdmmchost_init runs again on every card re-initialization, keep the event created the first time */
+        if (host->xfer_event.handle == NULL) {
+            status = sdmmc_osal_event_create(&host->xfer_event);
+            HPM_BREAK_IF(status != status_success);
+        }
+#endif
+
         sdmmchost_wait_card_active(host);
         sdmmchost_delay_ms(host, 10);
 
@@ -278,6 +295,35 @@ hpm_stat_t sdmmchost_send_command(sdmmc_host_t *host, sdmmchost_cmd_t *cmd)
     return status;
 }
 
+#if defined(HPM_SDMMC_HOST_ENABLE_IRQ) && (HPM_SDMMC_HOST_ENABLE_IRQ == 1)
+static void sdmmchost_transfer_irq_done(hpm_stat_t status, sdmmchost_cmd_t *cmd, void *user_data)
+{
+    sdmmc_host_t *host = (sdmmc_host_t *) user_data;
+
+    /* The blocking API reads the response from host->cmd */
+    memcpy(host->cmd.response, cmd->response, sizeof(host->cmd.response));
+    host->xfer_status = status;
+    sdmmc_osal_event_set_from_isr(&host->xfer_event);
+}
+
+static hpm_stat_t sdmmchost_transfer_irq(sdmmc_host_t *host, sdmmchost_xfer_t *content, uint32_t timeout_ms)
+{
+    /* The callers already do the cache maintenance of the blocking API */
+    hpm_stat_t status = sdmmchost_async_enqueue(host, content, sdmmchost_transfer_irq_done, host, false);
+    if (status != status_success) {
+        return status;
+    }
+    status = sdmmc_osal_event_wait(&host->xfer_event, timeout_ms + 500U);
+    if (status != status_success) {
+        sdmmchost_abort_async(host, status_sdxc_data_timeout_error);
+        /* consume the event set by the abort */
+        (void) sdmmc_osal_event_wait(&host->xfer_event, 0);
+        return status_sdxc_data_timeout_error;
+    }
+    return host->xfer_status;
+}
+#endif
+
 hpm_stat_t sdmmchost_transfer(sdmmc_host_t *host, sdmmchost_xfer_t *content)
 {
     hpm_stat_t status;
@@ -308,6 +354,13 @@ hpm_stat_t sdmmchost_transfer(sdmmc_host_t *host, sdmmchost_xfer_t *content)
         uint32_t read_write_size = block_cnt * block_size;
         uint32_t timeout_ms = (uint32_t) (1.0f * read_write_size / tx_rx_bytes_per_sec) * 1000 + 500;
         sdxc_set_data_timeout(host->host_param.base, timeout_ms, NULL);
+
+#if defined(HPM_SDMMC_HOST_ENABLE_IRQ) && (HPM_SDMMC_HOST_ENABLE_IRQ == 1)
+        return sdmmchost_transfer_irq(host, content, timeout_ms);
+#endif
+    }
+    if (host->async_busy) {
+        return status_sdxc_busy;
     }
     status = sdxc_transfer_nonblocking(host->host_param.base, config_ptr, content);
 
@@ -366,6 +419,170 @@ hpm_stat_t sdmmchost_transfer(sdmmc_host_t *host, sdmmchost_xfer_t *content)
     return status;
 }
 
+static hpm_stat_t sdmmchost_async_start(sdmmc_host_t *host)
+{
+    SDMMCHOST_Type *base = host->host_param.base;
+    sdmmchost_async_slot_t *slot = &host->async_slot[host->async_head];
+    sdxc_adma_config_t dma_config;
+    sdmmchost_xfer_t xfer;
+
+    dma_config.dma_type = sdxc_dmasel_adma2;
+    dma_config.adma_table_words = sizeof(slot->adma2_desc) / sizeof(uint32_t);
+    dma_config.adma_table = (uint32_t *) &slot->adma2_desc;
+    xfer.command = &slot->cmd;
+    xfer.data = &slot->data;
+
+    uint32_t bus_width = sdxc_get_data_bus_width(base);
+    uint32_t tx_rx_bytes_per_sec = host->clock_freq * bus_width / 8;
+    uint32_t read_write_size = slot->data.block_cnt * slot->data.block_size;
+    uint32_t timeout_ms = (uint32_t) (1.0f * read_write_size / tx_rx_bytes_per_sec) * 1000 + 500;
+    sdxc_set_data_timeout(base, timeout_ms, NULL);
+
+    return sdxc_transfer_nonblocking(base, &dma_config, &xfer);
+}
+
+/* Remove the head slot, the interrupt signal must be masked */
+static sdmmchost_async_slot_t *sdmmchost_async_pop(sdmmc_host_t *host)
+{
+    sdmmchost_async_slot_t *slot = &host->async_slot[host->async_head];
+
+    host->async_head = (host->async_head + 1U) % HPM_SDMMC_HOST_ASYNC_QUEUE_DEPTH;
+    host->async_count--;
+    return slot;
+}
+
+static void sdmmchost_async_complete(sdmmchost_async_slot_t *slot, sdmmchost_cmd_t *cmd, hpm_stat_t status)
+{
+    if (slot->cache_maintenance && (slot->data.rx_data != NULL)) {
+        sdmmc_dma_buf_complete_rx((uint32_t) slot->data.rx_data, slot->data.block_size * slot->data.block_cnt);
+    }
+    if (slot->callback != NULL) {
+        slot->callback(status, cmd, slot->user_data);
+    }
+}
+
+/* Start queued transfers until one is accepted by the controller, the interrupt signal must be masked */
+static void sdmmchost_async_start_next(sdmmc_host_t *host)
+{
+    /* a callback below may queue and start a transfer itself */
+    while (!host->async_busy && (host->async_count > 0U)) {
+        hpm_stat_t status = sdmmchost_async_start(host);
+        if (status == status_success) {
+            host->async_busy = true;
+            sdxc_enable_interrupt_signal(host->host_param.base, SDMMCHOST_ASYNC_IRQ_MASK, true);
+            return;
+        }
+        sdmmchost_async_slot_t *slot = sdmmchost_async_pop(host);
+        sdmmchost_cmd_t cmd = slot->cmd;
+        sdmmchost_async_complete(slot, &cmd, status);
+    }
+}
+
+static hpm_stat_t sdmmchost_async_enqueue(sdmmc_host_t *host, sdmmchost_xfer_t *content,
+                                          sdmmchost_async_callback_t callback, void *user_data, bool cache_maintenance)
+{
+    SDMMCHOST_Type *base = host->host_param.base;
+    hpm_stat_t status = status_success;
+
+    /* The interrupt is the only other writer of the queue */
+    sdxc_enable_interrupt_signal(base, SDMMCHOST_ASYNC_IRQ_MASK, false);
+    do {
+        if (host->async_count >= HPM_SDMMC_HOST_ASYNC_QUEUE_DEPTH) {
+            status = status_sdmmc_async_queue_full;
+            break;
+        }
+        uint32_t tail = (host->async_head + host->async_count) % HPM_SDMMC_HOST_ASYNC_QUEUE_DEPTH;
+        sdmmchost_async_slot_t *slot = &host->async_slot[tail];
+        slot->cmd = *content->command;
+        slot->data = *content->data;
+        slot->callback = callback;
+        slot->user_data = user_data;
+        slot->cache_maintenance = cache_maintenance;
+        if (cache_maintenance) {
+            uint32_t xfer_size = slot->data.block_size * slot->data.block_cnt;
+            if (slot->data.rx_data != NULL) {
+                sdmmc_dma_buf_prepare_rx((uint32_t) slot->data.rx_data, xfer_size);
+            } else {
+                sdmmc_dma_buf_prepare_tx((uint32_t) slot->data.tx_data, xfer_size);
+            }
+        }
+        host->async_count++;
+    } while (false);
+
+    if (!host->async_busy) {
+        sdmmchost_async_start_next(host);
+    } else {
+        sdxc_enable_interrupt_signal(base, SDMMCHOST_ASYNC_IRQ_MASK, true);
+    }
+
+    return status;
+}
+
+hpm_stat_t sdmmchost_transfer_async(sdmmc_host_t *host, sdmmchost_xfer_t *content,
+                                    sdmmchost_async_callback_t callback, void *user_data)
+{
+    if ((host == NULL) || (content == NULL) || (content->command == NULL) || (content->data == NULL)) {
+        return status_invalid_argument;
+    }
+    hpm_stat_t status = sdmmchost_check_host_availablity(host);
+    if (status != status_success) {
+        return status;
+    }
+
+    return sdmmchost_async_enqueue(host, content, callback, user_data, true);
+}
+
+uint32_t sdmmchost_get_async_pending(sdmmc_host_t *host)
+{
+    return host->async_count;
+}
+
+void sdmmchost_abort_async(sdmmc_host_t *host, hpm_stat_t status)
+{
+    SDMMCHOST_Type *base = host->host_param.base;
+
+    sdxc_enable_interrupt_signal(base, SDMMCHOST_ASYNC_IRQ_MASK, false);
+    sdxc_reset(base, sdxc_reset_cmd_line, 0xffffu);
+    sdxc_reset(base, sdxc_reset_data_line, 0xffffu);
+    sdxc_clear_interrupt_status(base, SDXC_STS_ALL_FLAGS);
+    host->async_busy = false;
+    while (host->async_count > 0U) {
+        sdmmchost_async_slot_t *slot = sdmmchost_async_pop(host);
+        sdmmchost_cmd_t cmd = slot->cmd;
+        sdmmchost_async_complete(slot, &cmd, status);
+    }
+}
+
+void sdmmchost_irq_handler(sdmmc_host_t *host)
+{
+    SDMMCHOST_Type *base = host->host_param.base;
+    uint32_t int_stat = sdxc_get_interrupt_status(base);
+
+    if (!host->async_busy || !IS_HPM_BITMASK_SET(int_stat, SDMMCHOST_ASYNC_IRQ_MASK)) {
+        return;
+    }
+    sdxc_enable_interrupt_signal(base, SDMMCHOST_ASYNC_IRQ_MASK, false);
+    host->async_busy = false;
+
+    hpm_stat_t status = sdxc_parse_interrupt_status(base);
+    sdmmchost_async_slot_t *slot = sdmmchost_async_pop(host);
+    /* the slot may be refilled from the callback */
+    sdmmchost_cmd_t cmd = slot->cmd;
+    if (status == status_success) {
+        status = sdxc_receive_cmd_response(base, &cmd);
+    }
+    sdxc_clear_interrupt_status(base, SDXC_INT_STAT_CMD_COMPLETE_MASK | SDXC_INT_STAT_XFER_COMPLETE_MASK);
+    if (status != status_success) {
+        sdxc_clear_interrupt_status(base, SDXC_STS_ERROR);
+        sdxc_reset(base, sdxc_reset_cmd_line, 0xffffu);
+        sdxc_reset(base, sdxc_reset_data_line, 0xffffu);
+    }
+
+    /* Keep the bus busy before running the callback */
+    sdmmchost_async_start_next(host);
+    sdmmchost_async_complete(slot, &cmd, status);
+}
+
 hpm_stat_t sdmmchost_set_speed_mode(sdmmc_host_t *host, sdmmc_speed_mode_t speed_mode)
 {
     if ((host == NULL) || (host->host_param.base == NULL)) {
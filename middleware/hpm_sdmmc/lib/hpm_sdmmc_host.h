@@ -11,6 +11,18 @@
 #include "hpm_common.h"
 #include "hpm_sdxc_drv.h"
 #include "hpm_gpio_drv.h"
+#include "hpm_sdmmc_osal.h"
+
+/* Data transfers of the blocking API wait for the SDXC interrupt instead of polling, sdmmchost_irq_handler
+ * must be called from the SDXC interrupt */
+#ifndef HPM_SDMMC_HOST_ENABLE_IRQ
+#define HPM_SDMMC_HOST_ENABLE_IRQ (0)
+#endif
+
+/* Number of transfers the asynchronous queue holds, including the running one */
+#ifndef HPM_SDMMC_HOST_ASYNC_QUEUE_DEPTH
+#define HPM_SDMMC_HOST_ASYNC_QUEUE_DEPTH (4U)
+#endif
 
 #define HPM_SDMMC_HOST_SUPPORT_4BIT               (1UL << 0)
 #define HPM_SDMMC_HOST_SUPPORT_8BIT               (1UL << 1)
@@ -177,6 +189,26 @@ typedef struct {
 } sdmmc_host_param_t;
 
 
+/**
+ * @brief Completion of an asynchronous transfer, called from the SDXC interrupt
+ * @param [in] status transfer status
+ * @param [in] cmd command with the card response
+ * @param [in] user_data user_data given at submission
+ */
+typedef void (*sdmmchost_async_callback_t)(hpm_stat_t status, sdmmchost_cmd_t *cmd, void *user_data);
+
+/**
+ * @brief Queued asynchronous transfer, each slot owns its ADMA2 descriptor table
+ */
+typedef struct {
+    sdmmchost_cmd_t cmd;
+    sdmmchost_data_t data;
+    sdmmc_adma2_desc_t adma2_desc;
+    sdmmchost_async_callback_t callback;
+    void *user_data;
+    bool cache_maintenance;
+} sdmmchost_async_slot_t;
+
 typedef struct {
     sdmmc_host_param_t host_param;
 
@@ -200,6 +232,16 @@ typedef struct {
     uint32_t int_stat;
     uint32_t auto_cmd_stat;
     uint32_t adma_error_stat;
+
+    /* Asynchronous transfer queue, head is the running transfer */
+    sdmmchost_async_slot_t async_slot[HPM_SDMMC_HOST_ASYNC_QUEUE_DEPTH];
+    volatile uint32_t async_head;
+    volatile uint32_t async_count;
+    volatile bool async_busy;
+#if defined(HPM_SDMMC_HOST_ENABLE_IRQ) && (HPM_SDMMC_HOST_ENABLE_IRQ == 1)
+    sdmmc_osal_event_t xfer_event;
+    volatile hpm_stat_t xfer_status;
+#endif
 } sdmmc_host_t;
 
 
@@ -245,5 +287,38 @@ void sdmmchost_set_cardclk_delay_chain(sdmmc_host_t *host);
 
 void sdmmchost_set_rxclk_delay_chain(sdmmc_host_t *host);
 
+/**
+ * @brief Queue a data transfer, it starts at once if the host is idle, otherwise from the interrupt
+ *        right after the previous transfer completes, so back to back transfers follow without task latency.
+ *        The command, data and descriptor table are copied into a queue slot, content may be reused on return.
+ *        The data buffer is flushed here and, for reads, invalidated before the callback
+ *        unless HPM_SDMMC_ENABLE_CACHE_MAINTENANCE is 0.
+ *        The blocking API must not be used while transfers are queued.
+ *        sdmmchost_irq_handler must be called from the SDXC interrupt.
+ * @param [in] host SD/MMC Host Context
+ * @param [in] content command and data, data must not be NULL
+ * @param [in] callback completion callback, may be NULL
+ * @param [in] user_data passed to callback
+ * @retval status_success queued
+ * @retval status_sdmmc_async_queue_full all slots are in use
+ */
+hpm_stat_t sdmmchost_transfer_async(sdmmc_host_t *host, sdmmchost_xfer_t *content,
+                                    sdmmchost_async_callback_t callback, void *user_data);
+
+/**
+ * @brief Number of queued transfers, including the running one
+ */
+uint32_t sdmmchost_get_async_pending(sdmmc_host_t *host);
+
+/**
+ * @brief Reset the command and data lines and complete all queued transfers with status
+ */
+void sdmmchost_abort_async(sdmmc_host_t *host, hpm_stat_t status);
+
+/**
+ * @brief SDXC interrupt handler, completes the running transfer and starts the next queued one
+ */
+void sdmmchost_irq_handler(sdmmc_host_t *host);
+
 
 #endif /* HPM_SDMMC_HOST_H */
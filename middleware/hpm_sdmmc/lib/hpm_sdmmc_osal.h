@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_SDMMC_OSAL_H
+#define HPM_SDMMC_OSAL_H
+
+#include "hpm_common.h"
+
+/**
+ * @brief Event signalled by the SDXC interrupt and waited for by the task that started the transfer
+ *
+ * On bare metal only is_set is used, an RTOS port keeps its semaphore in handle.
+ * The port is selected at build time: FreeRTOS, RT-Thread or bare metal.
+ */
+typedef struct {
+    void *handle;
+    volatile bool is_set;
+} sdmmc_osal_event_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+hpm_stat_t sdmmc_osal_event_create(sdmmc_osal_event_t *event);
+
+void sdmmc_osal_event_delete(sdmmc_osal_event_t *event);
+
+/**
+ * @brief Wait for the event and consume it
+ * @retval status_success event was set
+ * @retval status_timeout not set within timeout_ms
+ */
+hpm_stat_t sdmmc_osal_event_wait(sdmmc_osal_event_t *event, uint32_t timeout_ms);
+
+/**
+ * @brief Set the event, callable from the interrupt handler
+ */
+void sdmmc_osal_event_set_from_isr(sdmmc_osal_event_t *event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_SDMMC_OSAL_H */
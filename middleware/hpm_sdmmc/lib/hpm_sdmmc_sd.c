@@ -6,7 +6,7 @@
  */
 
 #include "hpm_sdmmc_sd.h"
-#include "hpm_l1c_drv.h"
+#include "hpm_sdmmc_dma_buf.h"
 #include "hpm_clock_drv.h"
 
 #define SPEED_1Kbps (1000U)
@@ -921,17 +921,10 @@ hpm_stat_t sd_read_blocks(sd_card_t *card, uint8_t *buffer, uint32_t start_block
             data->rx_data = (uint32_t *) sdmmc_get_sys_addr(card->host, (uint32_t) buffer);
             content->data = data;
             content->command = cmd;
-#if !defined(HPM_SDMMC_ENABLE_CACHE_MAINTENANCE) || (HPM_SDMMC_ENABLE_CACHE_MAINTENANCE == 1)
-            uint32_t aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t) data->rx_data);
-            uint32_t end_addr = (uint32_t) data->rx_data + card->block_size * block_count;
-            uint32_t aligned_end = HPM_L1C_CACHELINE_ALIGN_UP(end_addr);
-            uint32_t aligned_size = aligned_end - aligned_start;
-            l1c_dc_flush(aligned_start, aligned_size);
-#endif
+            uint32_t xfer_size = data->block_size * read_block_count;
+            sdmmc_dma_buf_prepare_rx((uint32_t) data->rx_data, xfer_size);
             status = sd_transfer(card, content);
-#if !defined(HPM_SDMMC_ENABLE_CACHE_MAINTENANCE) || (HPM_SDMMC_ENABLE_CACHE_MAINTENANCE == 1)
-            l1c_dc_invalidate(aligned_start, aligned_size);
-#endif
+            sdmmc_dma_buf_complete_rx((uint32_t) data->rx_data, xfer_size);
             if (status != status_success) {
                 break;
             }
@@ -994,13 +987,7 @@ hpm_stat_t sd_write_blocks(sd_card_t *card, const uint8_t *buffer, uint32_t star
             data->tx_data = (const uint32_t *) sdmmc_get_sys_addr(card->host, (uint32_t) buffer);
             content->data = data;
             content->command = cmd;
-#if !defined(HPM_SDMMC_ENABLE_CACHE_MAINTENANCE) || (HPM_SDMMC_ENABLE_CACHE_MAINTENANCE == 1)
-            uint32_t aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t) data->tx_data);
-            uint32_t aligned_end = HPM_L1C_CACHELINE_ALIGN_UP(
-                    (uint32_t) data->tx_data + card->block_size * write_block_count);
-            uint32_t aligned_size = aligned_end - aligned_start;
-            l1c_dc_flush(aligned_start, aligned_size);
-#endif
+            sdmmc_dma_buf_prepare_tx((uint32_t) data->tx_data, data->block_size * write_block_count);
             status = sd_transfer(card, content);
             if (status != status_success) {
                 break;
@@ -1017,6 +1004,80 @@ hpm_stat_t sd_write_blocks(sd_card_t *card, const uint8_t *buffer, uint32_t star
     return status;
 }
 
+static hpm_stat_t sd_transfer_blocks_async(sd_card_t *card, uint8_t *rx_buf, const uint8_t *tx_buf,
+                                           uint32_t start_block, uint32_t block_count,
+                                           sdmmchost_async_callback_t callback, void *user_data)
+{
+    hpm_stat_t status = sd_check_card_parameters(card);
+    do {
+        HPM_BREAK_IF(status != status_success);
+
+        if (!card->host->card_init_done) {
+            status = status_sdmmc_device_init_required;
+            break;
+        }
+        if ((block_count == 0U) || (block_count > MAX_BLOCK_COUNT)) {
+            status = status_invalid_argument;
+            break;
+        }
+
+        /* Built on the stack, the host copies them into its queue */
+        sdmmchost_cmd_t cmd;
+        sdmmchost_data_t data;
+        sdmmchost_xfer_t content;
+        memset(&cmd, 0, sizeof(cmd));
+        memset(&data, 0, sizeof(data));
+
+        bool is_write = (tx_buf != NULL);
+        if (block_count > 1U) {
+            cmd.cmd_index = is_write ? sdmmc_cmd_write_multiple_block : sdmmc_cmd_read_multiple_block;
+            if (card->sd_flags.support_set_block_count_cmd != 0) {
+                data.enable_auto_cmd23 = true;
+            } else {
+                data.enable_auto_cmd12 = true;
+            }
+        } else {
+            cmd.cmd_index = is_write ? sdmmc_cmd_write_single_block : sdmmc_cmd_read_single_block;
+        }
+        uint32_t start_addr = start_block;
+        if (card->sd_flags.is_byte_addressing_mode == 1U) {
+            start_addr *= card->block_size;
+        }
+        cmd.resp_type = (sdxc_dev_resp_type_t) sdmmc_resp_r1;
+        cmd.cmd_argument = start_addr;
+        data.block_size = SDMMC_BLOCK_SIZE_DEFAULT;
+        data.block_cnt = block_count;
+        if (is_write) {
+            data.tx_data = (const uint32_t *) sdmmc_get_sys_addr(card->host, (uint32_t) tx_buf);
+        } else {
+            data.rx_data = (uint32_t *) sdmmc_get_sys_addr(card->host, (uint32_t) rx_buf);
+        }
+        content.command = &cmd;
+        content.data = &data;
+        status = sdmmchost_transfer_async(card->host, &content, callback, user_data);
+    } while (false);
+
+    return status;
+}
+
+hpm_stat_t sd_read_blocks_async(sd_card_t *card, uint8_t *buffer, uint32_t start_block, uint32_t block_count,
+                                sdmmchost_async_callback_t callback, void *user_data)
+{
+    if (buffer == NULL) {
+        return status_invalid_argument;
+    }
+    return sd_transfer_blocks_async(card, buffer, NULL, start_block, block_count, callback, user_data);
+}
+
+hpm_stat_t sd_write_blocks_async(sd_card_t *card, const uint8_t *buffer, uint32_t start_block, uint32_t block_count,
+                                 sdmmchost_async_callback_t callback, void *user_data)
+{
+    if (buffer == NULL) {
+        return status_invalid_argument;
+    }
+    return sd_transfer_blocks_async(card, NULL, buffer, start_block, block_count, callback, user_data);
+}
+
 /**
  * @brief Calculate SD erase timeout value
  * Refer to SD_Specification_Part1_Physical_Layer_Specification_Version4.20.pdf, section 4.14 for more details.
@@ -144,6 +144,37 @@ hpm_stat_t sd_read_blocks(sd_card_t *card, uint8_t *buffer, uint32_t start_block
 
 hpm_stat_t sd_write_blocks(sd_card_t *card, const uint8_t *buffer, uint32_t start_block, uint32_t block_count);
 
+/**
+ * @brief Queue a read, the callback runs from the SDXC interrupt when the data is in buffer
+ *
+ * Requests queued back to back start from the interrupt as soon as the previous one completes.
+ * The blocking API must not be used until sdmmchost_get_async_pending() returns 0.
+ * @param [in] card SD card context
+ * @param [out] buffer destination, word aligned
+ * @param [in] start_block first block
+ * @param [in] block_count number of blocks, at most one ADMA2 descriptor
+ * @param [in] callback completion callback, may be NULL
+ * @param [in] user_data passed to callback
+ * @retval status_sdmmc_async_queue_full HPM_SDMMC_HOST_ASYNC_QUEUE_DEPTH requests are pending
+ */
+hpm_stat_t sd_read_blocks_async(sd_card_t *card, uint8_t *buffer, uint32_t start_block, uint32_t block_count,
+                                sdmmchost_async_callback_t callback, void *user_data);
+
+/**
+ * @brief Queue a write, the callback runs from the SDXC interrupt once the card released the busy signal
+ *
+ * Unlike sd_write_blocks no ACMD23 pre-erase hint is sent.
+ * @param [in] card SD card context
+ * @param [in] buffer source, word aligned, must stay unchanged until the callback
+ * @param [in] start_block first block
+ * @param [in] block_count number of blocks
+ * @param [in] callback completion callback, may be NULL
+ * @param [in] user_data passed to callback
+ * @retval status_sdmmc_async_queue_full HPM_SDMMC_HOST_ASYNC_QUEUE_DEPTH requests are pending
+ */
+hpm_stat_t sd_write_blocks_async(sd_card_t *card, const uint8_t *buffer, uint32_t start_block, uint32_t block_count,
+                                 sdmmchost_async_callback_t callback, void *user_data);
+
 hpm_stat_t sd_erase_blocks(sd_card_t *card, uint32_t start_block, uint32_t block_count);
 
 hpm_stat_t sd_set_driver_strength(sd_card_t *card, sd_drive_strength_t driver_strength);
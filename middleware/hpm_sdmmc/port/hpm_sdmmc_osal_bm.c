@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "hpm_sdmmc_osal.h"
+#include "board.h"
+
+hpm_stat_t sdmmc_osal_event_create(sdmmc_osal_event_t *event)
+{
+    event->handle = (void *) event;
+    event->is_set = false;
+    return status_success;
+}
+
+void sdmmc_osal_event_delete(sdmmc_osal_event_t *event)
+{
+    event->handle = NULL;
+}
+
+hpm_stat_t sdmmc_osal_event_wait(sdmmc_osal_event_t *event, uint32_t timeout_ms)
+{
+    uint32_t wait_cnt = timeout_ms * 100U;
+    while (!event->is_set) {
+        if (wait_cnt == 0U) {
+            return status_timeout;
+        }
+        board_delay_us(10);
+        wait_cnt--;
+    }
+    event->is_set = false;
+    return status_success;
+}
+
+void sdmmc_osal_event_set_from_isr(sdmmc_osal_event_t *event)
+{
+    event->is_set = true;
+}
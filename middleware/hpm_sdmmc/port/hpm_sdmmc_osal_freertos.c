@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "hpm_sdmmc_osal.h"
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+hpm_stat_t sdmmc_osal_event_create(sdmmc_osal_event_t *event)
+{
+    event->handle = (void *) xSemaphoreCreateBinary();
+    return (event->handle != NULL) ? status_success : status_fail;
+}
+
+void sdmmc_osal_event_delete(sdmmc_osal_event_t *event)
+{
+    if (event->handle != NULL) {
+        vSemaphoreDelete((SemaphoreHandle_t) event->handle);
+        event->handle = NULL;
+    }
+}
+
+hpm_stat_t sdmmc_osal_event_wait(sdmmc_osal_event_t *event, uint32_t timeout_ms)
+{
+    if (xSemaphoreTake((SemaphoreHandle_t) event->handle, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        return status_timeout;
+    }
+    return status_success;
+}
+
+void sdmmc_osal_event_set_from_isr(sdmmc_osal_event_t *event)
+{
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR((SemaphoreHandle_t) event->handle, &woken);
+    portYIELD_FROM_ISR(woken);
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include "hpm_sdmmc_osal.h"
+#include "rtthread.h"
+
+hpm_stat_t sdmmc_osal_event_create(sdmmc_osal_event_t *event)
+{
+    event->handle = (void *) rt_sem_create("sdmmc", 0, RT_IPC_FLAG_FIFO);
+    return (event->handle != NULL) ? status_success : status_fail;
+}
+
+void sdmmc_osal_event_delete(sdmmc_osal_event_t *event)
+{
+    if (event->handle != NULL) {
+        rt_sem_delete((rt_sem_t) event->handle);
+        event->handle = NULL;
+    }
+}
+
+hpm_stat_t sdmmc_osal_event_wait(sdmmc_osal_event_t *event, uint32_t timeout_ms)
+{
+    if (rt_sem_take((rt_sem_t) event->handle, rt_tick_from_millisecond(timeout_ms)) != RT_EOK) {
+        return status_timeout;
+    }
+    return status_success;
+}
+
+void sdmmc_osal_event_set_from_isr(sdmmc_osal_event_t *event)
+{
+    rt_sem_release((rt_sem_t) event->handle);
+}
@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Replay of draw buffer allocation traces on non_alloc.c: latency and fragmentation
+ *
+ * A trace is the console log of hpm_lvgl.c built with HPM_LVGL_DRAW_BUF_TRACE=1, one
+ * "na m <size> <address>" line per na_malloc and one "na f <address>" per na_free, other lines
+ * are skipped. The addresses only pair the frees with their allocations. Without a trace file
+ * a synthetic one is generated, modelled on VG-Lite drawing of an 800x480 ARGB8888 screen:
+ * layers of widgets that live for one frame, an image cache with evictions and a glyph cache,
+ * on the 1 MiB LV_MEM_SIZE of samples/lvgl/vglite.
+ *
+ * Every allocation is replayed on a heap of HEAP_SIZE with INFO_CNT block infos and the
+ * alignment of LV_DRAW_BUF_ALIGN, as in hpm_lvgl.c. The program prints the latency percentiles
+ * of na_malloc and na_free, the failed allocations, and the fragmentation, 1 - largest free block /
+ * free size, when the heap is fullest and at the end. Every block is filled and checked before
+ * its free, it must be aligned and inside the heap, and after the last free the heap must be one
+ * free block again, otherwise it ends with FAILED.
+ *
+ * ./na_replay/NaReplay [-s heap size] [-i info count] [-a align] [trace file ...]
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "non_alloc.h"
+
+#define HEAP_SIZE           (1U << 20)
+#define INFO_CNT            (128U)
+#define ALIGN               (64U)
+#define SLOT_CNT            (1U << 16)
+#define HIST_NS             (100000U)
+
+#define SYN_FRAMES          (20000U)
+#define SYN_SCREEN_W        (800U)
+#define SYN_SCREEN_H        (480U)
+#define SYN_LAYER_STRIP     (24U * 1024U)
+#define SYN_IMAGE_SLOTS     (8U)
+#define SYN_GLYPH_SLOTS     (32U)
+
+typedef struct {
+    uint64_t key;
+    uint8_t *mem;
+    uint32_t size;
+    uint8_t tag;
+} slot_t;
+
+typedef struct {
+    uint32_t hist[HIST_NS + 1];
+    uint64_t count;
+    uint32_t max;
+} latency_t;
+
+static uint8_t *heap;
+static uint8_t *info;
+static non_alloc_context_t ctx;
+static slot_t slots[SLOT_CNT];
+static latency_t malloc_lat, free_lat;
+static uint32_t heap_size = HEAP_SIZE, info_cnt = INFO_CNT, align = ALIGN;
+static uint64_t live, peak_live, ops, fails, unknown_frees;
+static non_alloc_info_t peak_info;
+static uint32_t errors;
+static uint32_t seed = 1;
+
+static uint32_t time_ns(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint32_t)(t.tv_sec * 1000000000ull + t.tv_nsec);
+}
+
+static void latency_record(latency_t *l, uint32_t ns)
+{
+    l->hist[(ns < HIST_NS) ? ns : HIST_NS]++;
+    l->count++;
+    l->max = (ns > l->max) ? ns : l->max;
+}
+
+static uint32_t latency_permille(latency_t *l, uint32_t permille)
+{
+    uint64_t sum = 0;
+
+    for (uint32_t ns = 0; ns <= HIST_NS; ns++) {
+        sum += l->hist[ns];
+        if (sum * 1000 >= l->count * permille) {
+            return ns;
+        }
+    }
+    return HIST_NS;
+}
+
+static void error(const char *what, uint64_t key)
+{
+    if (errors++ < 10) {
+        printf("%s, address 0x%llx\n", what, (unsigned long long)key);
+    }
+}
+
+static slot_t *slot_find(uint64_t key, bool insert)
+{
+    uint32_t i = (uint32_t)((key * 0x9e3779b97f4a7c15ull) >> 48);
+
+    for (uint32_t n = 0; n < SLOT_CNT; n++, i = (i + 1) & (SLOT_CNT - 1)) {
+        if (slots[i].mem == NULL) {
+            return insert ? &slots[i] : NULL;
+        }
+        if (slots[i].key == key) {
+            return &slots[i];
+        }
+    }
+    return NULL;
+}
+
+/* remove with backward shift, the probe chains stay unbroken */
+static void slot_remove(slot_t *s)
+{
+    uint32_t i = (uint32_t)(s - slots);
+    uint32_t j = i;
+
+    slots[i].mem = NULL;
+    for (;;) {
+        uint32_t home;
+
+        j = (j + 1) & (SLOT_CNT - 1);
+        if (slots[j].mem == NULL) {
+            return;
+        }
+        home = (uint32_t)((slots[j].key * 0x9e3779b97f4a7c15ull) >> 48);
+        if (((j - home) & (SLOT_CNT - 1)) >= ((j - i) & (SLOT_CNT - 1))) {
+            slots[i] = slots[j];
+            slots[j].mem = NULL;
+            i = j;
+        }
+    }
+}
+
+static void replay_malloc(uint64_t key, uint32_t size)
+{
+    slot_t *s = slot_find(key, true);
+    uint32_t t0, t1;
+    uint8_t *mem;
+
+    if ((s == NULL) || (s->mem != NULL)) {
+        error("allocation of an address still in use", key);
+        return;
+    }
+    t0 = time_ns();
+    mem = na_malloc(&ctx, size);
+    t1 = time_ns();
+    latency_record(&malloc_lat, t1 - t0);
+    ops++;
+    if (mem == NULL) {
+        fails++;
+        return;
+    }
+    if ((((uintptr_t)mem & (align - 1)) != 0) || (mem < heap) || (mem + size > heap + heap_size)) {
+        error("block not aligned or outside the heap", key);
+        return;
+    }
+    s->key = key;
+    s->mem = mem;
+    s->size = size;
+    s->tag = (uint8_t)(key * 31 + size);
+    memset(mem, s->tag, size);
+    live += size;
+    if (live > peak_live) {
+        peak_live = live;
+        na_get_info(&ctx, &peak_info);
+    }
+}
+
+static void replay_free(uint64_t key)
+{
+    slot_t *s = slot_find(key, false);
+    uint32_t t0, t1;
+
+    if (s == NULL) {
+        /* the allocation failed on the target or the log started later */
+        unknown_frees++;
+        return;
+    }
+    for (uint32_t i = 0; i < s->size; i++) {
+        if (s->mem[i] != s->tag) {
+            error("block overwritten", key);
+            break;
+        }
+    }
+    t0 = time_ns();
+    na_free(&ctx, s->mem);
+    t1 = time_ns();
+    latency_record(&free_lat, t1 - t0);
+    ops++;
+    live -= s->size;
+    slot_remove(s);
+}
+
+static int replay_file(const char *name)
+{
+    FILE *f = fopen(name, "r");
+    char line[256];
+
+    if (f == NULL) {
+        printf("can't open %s\n", name);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f) != NULL) {
+        char *p = strstr(line, "na ");
+        unsigned long long key = 0;
+        unsigned int size;
+        int n;
+
+        if (p == NULL) {
+            continue;
+        }
+        n = sscanf(p, "na m %u %llx", &size, &key);
+        if (n >= 1) {
+            /* a failed allocation prints a null pointer, as 0x0 or (nil) */
+            if (key != 0) {
+                replay_malloc(key, size);
+            } else {
+                fails++;
+            }
+        } else if (sscanf(p, "na f %llx", &key) == 1) {
+            replay_free(key);
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+static uint32_t rnd(uint32_t n)
+{
+    seed = seed * 1664525U + 1013904223U;
+    return (seed >> 8) % n;
+}
+
+/* lv_draw_buf stride of a w pixel wide ARGB8888 buffer, rounded to the alignment */
+static uint32_t syn_buf_size(uint32_t w, uint32_t h)
+{
+    return ((w * 4 + ALIGN - 1) & ~(ALIGN - 1)) * h;
+}
+
+static void replay_synthetic(void)
+{
+    uint64_t next_key = 1;
+    uint64_t image[SYN_IMAGE_SLOTS] = {0}, glyph[SYN_GLYPH_SLOTS] = {0};
+
+    for (uint32_t frame = 0; frame < SYN_FRAMES; frame++) {
+        uint64_t layer[4];
+        uint32_t layers = rnd(5);
+
+        /*
+         * widgets with opacity or blend modes draw into a layer in strips of SYN_LAYER_STRIP byte,
+         * transformed widgets into a layer of their whole size, for one frame
+         */
+        for (uint32_t i = 0; i < layers; i++) {
+            uint32_t w = 16 + rnd(SYN_SCREEN_W / 2), h = 16 + rnd(SYN_SCREEN_H / 2);
+
+            if ((rnd(20) != 0) && (syn_buf_size(w, h) > SYN_LAYER_STRIP)) {
+                h = SYN_LAYER_STRIP / syn_buf_size(w, 1);
+            }
+            layer[i] = next_key++ << 6;
+            replay_malloc(layer[i], syn_buf_size(w, h));
+        }
+        /* decoded images stay in the cache until evicted */
+        if (rnd(8) == 0) {
+            uint32_t i = rnd(SYN_IMAGE_SLOTS);
+
+            if (image[i] != 0) {
+                replay_free(image[i]);
+            }
+            image[i] = next_key++ << 6;
+            replay_malloc(image[i], syn_buf_size(16 + rnd(145), 16 + rnd(145)));
+        }
+        /* A8 glyph bitmaps of 12 to 48 pixel fonts */
+        for (uint32_t n = rnd(6); n > 0; n--) {
+            uint32_t i = rnd(SYN_GLYPH_SLOTS), px = 12 + rnd(37);
+
+            if (glyph[i] != 0) {
+                replay_free(glyph[i]);
+            }
+            glyph[i] = next_key++ << 6;
+            replay_malloc(glyph[i], ((px + ALIGN - 1) & ~(ALIGN - 1)) * px);
+        }
+        for (uint32_t i = layers; i > 0; i--) {
+            replay_free(layer[i - 1]);
+        }
+    }
+    for (uint32_t i = 0; i < SYN_IMAGE_SLOTS; i++) {
+        if (image[i] != 0) {
+            replay_free(image[i]);
+        }
+    }
+    for (uint32_t i = 0; i < SYN_GLYPH_SLOTS; i++) {
+        if (glyph[i] != 0) {
+            replay_free(glyph[i]);
+        }
+    }
+}
+
+/*
+ * Blocks below 64 byte share a list per 4 byte, a freed block must not be handed out for a
+ * larger size of its list. For every alignment up to 8 and every size below 128 byte a block
+ * is freed between two others and a larger size is allocated, its end must stay in front of
+ * the block info pointer of the next block.
+ */
+static void check_small_sizes(void)
+{
+    static uint8_t small_heap[4096];
+    static uint8_t small_info[NA_INFO_CELL_SIZE * NON_ALLOC_MIN_MEM_INFO_NUM];
+    non_alloc_context_t small;
+
+    for (uint32_t a = 1; a <= 8; a *= 2) {
+        uint32_t hdr = (sizeof(void *) + a - 1) & ~(a - 1);
+
+        for (uint32_t size = 1; size < 128; size++) {
+            for (uint32_t more = 1; more <= 4; more++) {
+                uint8_t *front, *freed, *next, *mem;
+
+                na_init(&small, a, small_heap, sizeof(small_heap), small_info, sizeof(small_info));
+                front = na_malloc(&small, 16);
+                freed = na_malloc(&small, size);
+                next = na_malloc(&small, 16);
+                na_free(&small, freed);
+                mem = na_malloc(&small, size + more);
+                if ((front == NULL) || (next == NULL) || (mem == NULL)) {
+                    printf("small sizes, align %u: allocation of %u byte failed\n", a, size + more);
+                    errors++;
+                    return;
+                }
+                if ((mem < next) && (mem + size + more > next - hdr)) {
+                    printf("small sizes, align %u: %u byte block returned for %u byte\n", a, size, size + more);
+                    errors++;
+                    return;
+                }
+            }
+        }
+    }
+}
+
+static double fragmentation(non_alloc_info_t *i)
+{
+    return i->free_size ? 100.0 * (1.0 - (double)i->largest_free_size / i->free_size) : 0;
+}
+
+int main(int argc, char **argv)
+{
+    non_alloc_info_t end_info, empty_info;
+    int files = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc)) {
+            heap_size = strtoul(argv[++i], NULL, 0);
+        } else if ((strcmp(argv[i], "-i") == 0) && (i + 1 < argc)) {
+            info_cnt = strtoul(argv[++i], NULL, 0);
+        } else if ((strcmp(argv[i], "-a") == 0) && (i + 1 < argc)) {
+            align = strtoul(argv[++i], NULL, 0);
+        }
+    }
+    check_small_sizes();
+
+    heap = malloc(heap_size);
+    info = malloc(NA_INFO_CELL_SIZE * info_cnt);
+    if ((heap == NULL) || (info == NULL)
+        || (na_init(&ctx, align, heap, heap_size, info, NA_INFO_CELL_SIZE * info_cnt) <= 0)) {
+        printf("na_init failed\nFAILED\n");
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if ((argv[i][0] == '-') && (i + 1 < argc)) {
+            i++;
+            continue;
+        }
+        if (replay_file(argv[i]) != 0) {
+            return 1;
+        }
+        files++;
+    }
+    if (files == 0) {
+        printf("synthetic trace: %u frames of an %ux%u ARGB8888 screen\n", SYN_FRAMES, SYN_SCREEN_W, SYN_SCREEN_H);
+        replay_synthetic();
+    }
+
+    na_get_info(&ctx, &end_info);
+    printf("heap %u byte, %u infos, align %u: %llu operations, %llu of %llu allocations failed, "
+           "%llu frees of unknown blocks\n", heap_size, info_cnt, align, (unsigned long long)ops,
+           (unsigned long long)fails, (unsigned long long)malloc_lat.count + fails, (unsigned long long)unknown_frees);
+    printf("na_malloc ns: p50 %u p99 %u p99.9 %u max %u\n", latency_permille(&malloc_lat, 500),
+           latency_permille(&malloc_lat, 990), latency_permille(&malloc_lat, 999), malloc_lat.max);
+    printf("na_free ns:   p50 %u p99 %u p99.9 %u max %u\n", latency_permille(&free_lat, 500),
+           latency_permille(&free_lat, 990), latency_permille(&free_lat, 999), free_lat.max);
+    printf("fullest: %llu byte live, free %lu largest %lu in %lu blocks, fragmentation %.1f%%\n",
+           (unsigned long long)peak_live, peak_info.free_size, peak_info.largest_free_size, peak_info.free_blk_num,
+           fragmentation(&peak_info));
+    printf("end:     %llu byte live, free %lu largest %lu in %lu blocks, fragmentation %.1f%%\n",
+           (unsigned long long)live, end_info.free_size, end_info.largest_free_size, end_info.free_blk_num,
+           fragmentation(&end_info));
+
+    /* whatever the trace left allocated is freed, the heap must merge back into one block */
+    for (uint32_t i = 0; i < SLOT_CNT; i++) {
+        while (slots[i].mem != NULL) {
+            replay_free(slots[i].key);
+        }
+    }
+    na_get_info(&ctx, &empty_info);
+    if ((empty_info.free_blk_num != 1) || (empty_info.allocated_blk_num != 0)) {
+        printf("heap not merged back into one free block, %lu free and %lu allocated blocks\n",
+               empty_info.free_blk_num, empty_info.allocated_blk_num);
+        errors++;
+    }
+
+    printf(errors ? "FAILED\n" : "PASSED.\n");
+    return errors ? 1 : 0;
+}
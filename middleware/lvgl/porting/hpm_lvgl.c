@@ -538,15 +538,32 @@ static non_alloc_context_t vg_draw_buf_na_ctx;
 static uint8_t __attribute__((section(".noncacheable"), aligned(HPM_L1C_CACHELINE_SIZE))) draw_buf_mem[LV_MEM_SIZE];
 static uint8_t draw_buf_mem_info[NA_INFO_CELL_SIZE * 128];
 
+/*
+ * HPM_LVGL_DRAW_BUF_TRACE prints every draw buffer allocation as "na m <size> <address>" and
+ * every free as "na f <address>", porting/examples/na_replay replays such a console log
+ */
+#ifndef HPM_LVGL_DRAW_BUF_TRACE
+#define HPM_LVGL_DRAW_BUF_TRACE 0
+#endif
+
 static void *draw_buf_malloc(size_t size_bytes, lv_color_format_t color_format)
 {
+    void *buf;
+
     LV_UNUSED(color_format);
 
-    return na_malloc(&vg_draw_buf_na_ctx, size_bytes);
+    buf = na_malloc(&vg_draw_buf_na_ctx, size_bytes);
+#if HPM_LVGL_DRAW_BUF_TRACE
+    printf("na m %u %p\n", (unsigned int)size_bytes, buf);
+#endif
+    return buf;
 }
 
 static void draw_buf_free(void *buf)
 {
+#if HPM_LVGL_DRAW_BUF_TRACE
+    printf("na f %p\n", buf);
+#endif
     na_free(&vg_draw_buf_na_ctx, buf);
 }
 
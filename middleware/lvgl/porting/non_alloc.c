@@ -6,8 +6,13 @@
  */
 #include "non_alloc.h"
 
+/*
+ * Block infos live in the info memory, the non memory only holds a pointer to
+ * the info of each block in front of the returned memory.
+ */
 typedef struct mem_blk_info {
-    struct na_list list;
+    struct mem_blk_info *free_pre;
+    struct mem_blk_info *free_nxt;
     struct mem_blk_info *pre;
     struct mem_blk_info *nxt;
     na_addr_t blk_start;
@@ -18,53 +23,164 @@ typedef struct mem_blk_info {
     na_size_t state: 2;
 } mem_blk_info_t;
 
-#define NA_MEMORY_CHECK_DEBUG 1
+#ifndef NA_MEMORY_CHECK_DEBUG
+#define NA_MEMORY_CHECK_DEBUG 0
+#endif
 #if defined(NA_MEMORY_CHECK_DEBUG) && NA_MEMORY_CHECK_DEBUG
 #include <stdio.h>
 static void na_memory_check(non_alloc_context_t *ctx);
 #endif
 
 #define NA_NULL (void *)0
-#define NON_ALLOC_MEM_INFO_ALIGN 4
+#define NON_ALLOC_MEM_INFO_ALIGN sizeof(na_addr_t)
+#define NON_ALLOC_MAX_BLK_LEN ((na_size_t)1 << 30)
 #define NON_ALLOC_ALIGN(x, align) (((x) + (align) - 1) & ~((align) - 1))
-#define NON_ALLOC_SIZE2BLK_LEN(size, align) (NON_ALLOC_ALIGN(size, align) + NON_ALLOC_ALIGN(sizeof(mem_blk_info_t *), align))
-#define NON_ALLOC_BLK2MEM(addr, align) (void *)((addr) + NON_ALLOC_ALIGN(sizeof(mem_blk_info_t *), align))
-#define NON_ALLOC_MEM2BLK(mem, align) ((na_addr_t)(mem) - NON_ALLOC_ALIGN(sizeof(mem_blk_info_t *), align))
+#define NON_ALLOC_HDR_LEN(align) NON_ALLOC_ALIGN(sizeof(mem_blk_info_t *), align)
+#define NON_ALLOC_MIN_BLK_LEN(align) (NON_ALLOC_HDR_LEN(align) + (align))
+#define NON_ALLOC_SIZE2BLK_LEN(size, align) (NON_ALLOC_ALIGN(size, align) + NON_ALLOC_HDR_LEN(align))
+#define NON_ALLOC_BLK2MEM(addr, align) (void *)((addr) + NON_ALLOC_HDR_LEN(align))
+#define NON_ALLOC_MEM2BLK(mem, align) ((na_addr_t)(mem) - NON_ALLOC_HDR_LEN(align))
+
+/* index of the most significant set bit, x must not be 0 */
+static inline int na_fls(uint32_t x)
+{
+    int bit = 0;
+
+    if (x & 0xffff0000) {
+        x >>= 16;
+        bit += 16;
+    }
+    if (x & 0xff00) {
+        x >>= 8;
+        bit += 8;
+    }
+    if (x & 0xf0) {
+        x >>= 4;
+        bit += 4;
+    }
+    if (x & 0xc) {
+        x >>= 2;
+        bit += 2;
+    }
+    if (x & 0x2)
+        bit += 1;
+
+    return bit;
+}
 
-static inline void na_list_node_init(na_list_t *node)
+/* index of the least significant set bit, x must not be 0 */
+static inline int na_ffs(uint32_t x)
 {
-    node->nxt = node;
-    node->pre = node;
+    return na_fls(x & (~x + 1));
+}
+
+static inline void na_mapping(na_size_t size, int *fl, int *sl)
+{
+    if (size < (1 << NA_TLSF_SMALL_LOG2)) {
+        *fl = 0;
+        *sl = (int)(size >> (NA_TLSF_SMALL_LOG2 - NA_TLSF_SL_LOG2));
+    } else {
+        int bit = na_fls((uint32_t)size);
+        *sl = (int)((size >> (bit - NA_TLSF_SL_LOG2)) ^ NA_TLSF_SL_COUNT);
+        *fl = bit - NA_TLSF_SMALL_LOG2 + 1;
+    }
+}
+
+static inline mem_blk_info_t *na_unused_get(non_alloc_context_t *ctx)
+{
+    mem_blk_info_t *blk = ctx->unused;
+
+    if (blk)
+        ctx->unused = blk->free_nxt;
+
+    return blk;
 }
 
-static inline void na_list_del(na_list_t *node)
+static inline void na_unused_put(non_alloc_context_t *ctx, mem_blk_info_t *blk)
 {
-    node->pre->nxt = node->nxt;
-    node->nxt->pre = node->pre;
+    blk->state = NON_ALLOC_STATE_UNUSED;
+    blk->free_nxt = ctx->unused;
+    ctx->unused = blk;
 }
 
-static inline void na_list_add(na_list_t *head, na_list_t *node)
+static void na_free_insert(non_alloc_context_t *ctx, mem_blk_info_t *blk)
 {
-    node->nxt = head->nxt;
-    node->pre = head;
-    head->nxt->pre = node;
-    head->nxt = node;
+    int fl, sl;
+    mem_blk_info_t *head;
+
+    na_mapping(blk->blk_len, &fl, &sl);
+    head = ctx->free[fl][sl];
+    blk->free_pre = NA_NULL;
+    blk->free_nxt = head;
+    if (head)
+        head->free_pre = blk;
+    ctx->free[fl][sl] = blk;
+    ctx->fl_bitmap |= 1U << fl;
+    ctx->sl_bitmap[fl] |= 1U << sl;
+    blk->state = NON_ALLOC_STATE_FREE;
 }
 
-static inline na_list_t *na_list_node_get(na_list_t *head)
+static void na_free_remove(non_alloc_context_t *ctx, mem_blk_info_t *blk)
 {
-    na_list_t *node = NA_NULL;
+    int fl, sl;
 
-    if (head->nxt != head) {
-        node = head->nxt;
-        na_list_del(node);
+    na_mapping(blk->blk_len, &fl, &sl);
+    if (blk->free_nxt)
+        blk->free_nxt->free_pre = blk->free_pre;
+    if (blk->free_pre) {
+        blk->free_pre->free_nxt = blk->free_nxt;
+    } else {
+        ctx->free[fl][sl] = blk->free_nxt;
+        if (!ctx->free[fl][sl]) {
+            ctx->sl_bitmap[fl] &= ~(1U << sl);
+            if (!ctx->sl_bitmap[fl])
+                ctx->fl_bitmap &= ~(1U << fl);
+        }
+    }
+}
+
+/* first block of the first non empty list whose blocks are all at least size long */
+static mem_blk_info_t *na_free_search(non_alloc_context_t *ctx, na_size_t size)
+{
+    int fl, sl;
+    uint32_t sl_map;
+    uint32_t fl_map;
+
+    /* round up to the next list, a list holds blocks of its whole range */
+    if (size >= (1 << NA_TLSF_SMALL_LOG2))
+        size += ((na_size_t)1 << (na_fls((uint32_t)size) - NA_TLSF_SL_LOG2)) - 1;
+    else
+        size = NON_ALLOC_ALIGN(size, (na_size_t)1 << (NA_TLSF_SMALL_LOG2 - NA_TLSF_SL_LOG2));
+    if (size >= NON_ALLOC_MAX_BLK_LEN)
+        return NA_NULL;
+
+    na_mapping(size, &fl, &sl);
+    sl_map = ctx->sl_bitmap[fl] & (~0U << sl);
+    if (!sl_map) {
+        fl_map = ctx->fl_bitmap & (~0U << (fl + 1));
+        if (!fl_map)
+            return NA_NULL;
+        fl = na_ffs(fl_map);
+        sl_map = ctx->sl_bitmap[fl];
     }
+    sl = na_ffs(sl_map);
 
-    return node;
+    return ctx->free[fl][sl];
 }
 
-#define na_list_for_each(node, head)\
-for (na_list_t *node = (head)->nxt; node != (head); node = node->nxt)
+/* split blk at offset len, the second part becomes a free block */
+static void na_blk_split(non_alloc_context_t *ctx, mem_blk_info_t *blk, mem_blk_info_t *rest, na_size_t len)
+{
+    rest->blk_start = blk->blk_start + len;
+    rest->blk_len = blk->blk_len - len;
+    rest->pre = blk;
+    rest->nxt = blk->nxt;
+    if (blk->nxt)
+        blk->nxt->pre = rest;
+    blk->nxt = rest;
+    blk->blk_len = len;
+    na_free_insert(ctx, rest);
+}
 
 int na_init(non_alloc_context_t *ctx, na_size_t mem_align, void *non_addr, na_size_t non_len, void *info_addr, na_size_t info_len)
 {
@@ -73,100 +189,119 @@ int na_init(non_alloc_context_t *ctx, na_size_t mem_align, void *non_addr, na_si
     na_addr_t info_len_align;
     na_size_t mem_blk_info_size_align;
 
-    if (!ctx || info_len < sizeof(mem_blk_info_t) * NON_ALLOC_MIN_MEM_INFO_NUM ||\
+    if (!ctx || !mem_align || (mem_align & (mem_align - 1)) ||\
+         info_len < sizeof(mem_blk_info_t) * NON_ALLOC_MIN_MEM_INFO_NUM ||\
          non_len < NON_ALLOC_MIN_NON_MEM_LEN)
         return -1;
 
     ctx->mem_info_num = 0;
     ctx->align = mem_align;
     ctx->non_addr = NON_ALLOC_ALIGN((na_addr_t)non_addr, mem_align);
-    ctx->non_len = non_len - ((na_addr_t)non_addr - ctx->non_addr);
+    ctx->non_len = (non_len - (ctx->non_addr - (na_addr_t)non_addr)) & ~(mem_align - 1);
     ctx->info_addr = NON_ALLOC_ALIGN((na_addr_t)info_addr, NON_ALLOC_MEM_INFO_ALIGN);
-    ctx->info_len = info_len - ((na_addr_t)info_addr - ctx->info_addr);
-    na_list_node_init(&ctx->unused);
-    na_list_node_init(&ctx->free);
-    na_list_node_init(&ctx->allocated);
+    ctx->info_len = info_len - (ctx->info_addr - (na_addr_t)info_addr);
+    ctx->unused = NA_NULL;
+    ctx->fl_bitmap = 0;
+    for (int fl = 0; fl < NA_TLSF_FL_COUNT; fl++) {
+        ctx->sl_bitmap[fl] = 0;
+        for (int sl = 0; sl < NA_TLSF_SL_COUNT; sl++)
+            ctx->free[fl][sl] = NA_NULL;
+    }
+
+    if (ctx->non_len >= NON_ALLOC_MAX_BLK_LEN || ctx->non_len < NON_ALLOC_MIN_BLK_LEN(mem_align))
+        return -1;
 
     info_addr_align = ctx->info_addr;
     info_len_align = ctx->info_len;
     mem_blk_info_size_align = NON_ALLOC_ALIGN(sizeof(mem_blk_info_t), NON_ALLOC_MEM_INFO_ALIGN);
     while (info_len_align >= mem_blk_info_size_align) {
-        na_list_add(&ctx->unused, (na_list_t *)info_addr_align);
+        na_unused_put(ctx, (mem_blk_info_t *)info_addr_align);
         info_addr_align += mem_blk_info_size_align;
         info_len_align -= mem_blk_info_size_align;
         ctx->mem_info_num++;
     }
 
-    mem_blk_info = (mem_blk_info_t *)na_list_node_get(&ctx->unused);
+    mem_blk_info = na_unused_get(ctx);
     mem_blk_info->blk_start = ctx->non_addr;
     mem_blk_info->blk_len = ctx->non_len;
-    mem_blk_info->state = NON_ALLOC_STATE_FREE;
     mem_blk_info->nxt = NA_NULL;
     mem_blk_info->pre = NA_NULL;
-    na_list_add(&ctx->free, (na_list_t *)mem_blk_info);
+    ctx->first = mem_blk_info;
+    na_free_insert(ctx, mem_blk_info);
 
     return ctx->mem_info_num;
 }
 
-void *na_malloc(non_alloc_context_t *ctx, na_size_t size)
+void *na_malloc_align(non_alloc_context_t *ctx, na_size_t size, na_size_t align)
 {
-    mem_blk_info_t *mem_blk_info;
-    mem_blk_info_t *free_blk = NA_NULL;
-    mem_blk_info_t *allocated_blk = NA_NULL;
+    mem_blk_info_t *blk;
+    mem_blk_info_t *split_blk;
+    na_size_t blk_len;
+    na_size_t search_len;
+    na_size_t hdr_len;
+    na_size_t min_blk_len;
     void *mem = NA_NULL;
 
-    if (!ctx || !size)
+    if (!ctx || !size || size >= ctx->non_len || (align & (align - 1)))
         goto ERROR;
 
-    size = NON_ALLOC_SIZE2BLK_LEN(size, ctx->align);
+    if (align < ctx->align)
+        align = ctx->align;
+    hdr_len = NON_ALLOC_HDR_LEN(ctx->align);
+    min_blk_len = NON_ALLOC_MIN_BLK_LEN(ctx->align);
+    blk_len = NON_ALLOC_SIZE2BLK_LEN(size, ctx->align);
+    /* room to move the start forward and leave a free block in front */
+    search_len = (align > ctx->align) ? blk_len + align + min_blk_len : blk_len;
 
-    na_list_for_each(node, &ctx->free) {
-        mem_blk_info = (mem_blk_info_t *)node;
-        if (mem_blk_info->blk_len >= size) {
-            free_blk = mem_blk_info;
-            break;
+    blk = na_free_search(ctx, search_len);
+    if (!blk)
+        goto ERROR;
+    na_free_remove(ctx, blk);
+
+    if (align > ctx->align) {
+        na_addr_t start = NON_ALLOC_ALIGN(blk->blk_start + hdr_len, align) - hdr_len;
+
+        while (start != blk->blk_start && start - blk->blk_start < min_blk_len)
+            start += align;
+
+        if (start != blk->blk_start) {
+            split_blk = na_unused_get(ctx);
+            if (!split_blk) {
+                na_free_insert(ctx, blk);
+                goto ERROR;
+            }
+            /* the front part keeps the info of blk, which the previous block links to */
+            na_blk_split(ctx, blk, split_blk, start - blk->blk_start);
+            na_free_remove(ctx, split_blk);
+            na_free_insert(ctx, blk);
+            blk = split_blk;
         }
     }
 
-    if (!free_blk)
-        goto ERROR;
-
-    if (free_blk->blk_len == size) {
-        na_list_del((na_list_t *)free_blk);
-        na_list_add(&ctx->allocated, (na_list_t *)free_blk);
-        free_blk->state = NON_ALLOC_STATE_ALLOCATED;
-        allocated_blk = free_blk;
-    } else {
-        allocated_blk = (mem_blk_info_t *)na_list_node_get(&ctx->unused);
-        if (!allocated_blk)
-            goto ERROR;
-
-        allocated_blk->blk_start = free_blk->blk_start;
-        allocated_blk->blk_len = size;
-        free_blk->blk_start += allocated_blk->blk_len;
-        free_blk->blk_len -= allocated_blk->blk_len;
-
-        allocated_blk->nxt = free_blk;
-        allocated_blk->pre = free_blk->pre;
-
-        if (free_blk->pre)
-            free_blk->pre->nxt = allocated_blk;
-        free_blk->pre = allocated_blk;
-
-        na_list_add(&ctx->allocated, (na_list_t *)allocated_blk);
-        allocated_blk->state = NON_ALLOC_STATE_ALLOCATED;
+    /* without a spare info the tail stays in the allocated block */
+    if (blk->blk_len >= blk_len + min_blk_len) {
+        split_blk = na_unused_get(ctx);
+        if (split_blk)
+            na_blk_split(ctx, blk, split_blk, blk_len);
     }
 
+    blk->state = NON_ALLOC_STATE_ALLOCATED;
     /* save blk info address to noncache memory */
-    *(mem_blk_info_t **)allocated_blk->blk_start = allocated_blk;
-    mem = NON_ALLOC_BLK2MEM(allocated_blk->blk_start, ctx->align);
+    *(mem_blk_info_t **)blk->blk_start = blk;
+    mem = NON_ALLOC_BLK2MEM(blk->blk_start, ctx->align);
 ERROR:
 #if defined(NA_MEMORY_CHECK_DEBUG) && NA_MEMORY_CHECK_DEBUG
-    na_memory_check(ctx);
+    if (ctx)
+        na_memory_check(ctx);
 #endif
     return mem;
 }
 
+void *na_malloc(non_alloc_context_t *ctx, na_size_t size)
+{
+    return na_malloc_align(ctx, size, 0);
+}
+
 void na_free(non_alloc_context_t *ctx, void *mem)
 {
     if (!ctx || !mem)
@@ -174,80 +309,128 @@ void na_free(non_alloc_context_t *ctx, void *mem)
 
     na_addr_t blk_start = NON_ALLOC_MEM2BLK(mem, ctx->align);
     mem_blk_info_t *free_blk = *(mem_blk_info_t **)blk_start;
-    mem_blk_info_t *nxt_blk = free_blk->nxt;
-    mem_blk_info_t *pre_blk = free_blk->pre;
+    mem_blk_info_t *nxt_blk;
+    mem_blk_info_t *pre_blk;
 
-    if (nxt_blk && (nxt_blk->state & NON_ALLOC_STATE_FREE)) {
-        free_blk->blk_len += nxt_blk->blk_len;
+    if ((na_addr_t)free_blk < ctx->info_addr || (na_addr_t)free_blk >= ctx->info_addr + ctx->info_len ||\
+        free_blk->state != NON_ALLOC_STATE_ALLOCATED || free_blk->blk_start != blk_start) {
+#if defined(NA_MEMORY_CHECK_DEBUG) && NA_MEMORY_CHECK_DEBUG
+        printf("[%s]: invalid or double free of %p\n", __FUNCTION__, mem);
+#endif
+        return;
+    }
 
+    nxt_blk = free_blk->nxt;
+    if (nxt_blk && nxt_blk->state == NON_ALLOC_STATE_FREE) {
+        na_free_remove(ctx, nxt_blk);
+        free_blk->blk_len += nxt_blk->blk_len;
+        free_blk->nxt = nxt_blk->nxt;
         if (nxt_blk->nxt)
             nxt_blk->nxt->pre = free_blk;
-        free_blk->nxt = nxt_blk->nxt;
-
-        na_list_del((na_list_t *)nxt_blk);
-        na_list_add(&ctx->unused, (na_list_t *)nxt_blk);
-        nxt_blk->state = NON_ALLOC_STATE_UNUSED;
+        na_unused_put(ctx, nxt_blk);
     }
 
-    if (pre_blk && (pre_blk->state == NON_ALLOC_STATE_FREE)) {
+    pre_blk = free_blk->pre;
+    if (pre_blk && pre_blk->state == NON_ALLOC_STATE_FREE) {
+        na_free_remove(ctx, pre_blk);
         pre_blk->blk_len += free_blk->blk_len;
-
+        pre_blk->nxt = free_blk->nxt;
         if (free_blk->nxt)
             free_blk->nxt->pre = pre_blk;
-        pre_blk->nxt = free_blk->nxt;
-
-        na_list_del((na_list_t *)free_blk);
-        na_list_add(&ctx->unused, (na_list_t *)free_blk);
-        free_blk->state = NON_ALLOC_STATE_UNUSED;
-    } else {
-        na_list_del((na_list_t *)free_blk);
-        na_list_add(&ctx->free, (na_list_t *)free_blk);
-        free_blk->state = NON_ALLOC_STATE_FREE;
+        na_unused_put(ctx, free_blk);
+        free_blk = pre_blk;
     }
+
+    na_free_insert(ctx, free_blk);
 #if defined(NA_MEMORY_CHECK_DEBUG) && NA_MEMORY_CHECK_DEBUG
     na_memory_check(ctx);
 #endif
 }
 
-#if defined(NA_MEMORY_CHECK_DEBUG) && NA_MEMORY_CHECK_DEBUG
-static void na_memory_check(non_alloc_context_t *ctx)
+void na_get_info(non_alloc_context_t *ctx, non_alloc_info_t *info)
 {
-    struct check_info {
-        na_size_t unused_cnt;
-        na_size_t free_cnt;
-        na_size_t allocated_cnt;
-        na_size_t free_size;
-        na_size_t allocated_size;
-    };
+    mem_blk_info_t *blk;
 
-    struct check_info info = {0};
-    mem_blk_info_t *blk_info;
+    if (!ctx || !info)
+        return;
 
-    na_list_for_each(node, &ctx->unused) {
-        info.unused_cnt++;
+    info->free_size = 0;
+    info->largest_free_size = 0;
+    info->free_blk_num = 0;
+    info->allocated_size = 0;
+    info->allocated_blk_num = 0;
+    info->unused_info_num = 0;
+
+    for (blk = ctx->first; blk; blk = blk->nxt) {
+        if (blk->state == NON_ALLOC_STATE_FREE) {
+            info->free_blk_num++;
+            info->free_size += blk->blk_len;
+            if (blk->blk_len > info->largest_free_size)
+                info->largest_free_size = blk->blk_len;
+        } else {
+            info->allocated_blk_num++;
+            info->allocated_size += blk->blk_len;
+        }
     }
 
-    na_list_for_each(node, &ctx->free) {
-        info.free_cnt++;
-        blk_info = (mem_blk_info_t *)node;
-        info.free_size += blk_info->blk_len;
-    }
+    for (blk = ctx->unused; blk; blk = blk->free_nxt)
+        info->unused_info_num++;
+}
 
-    na_list_for_each(node, &ctx->allocated) {
-        info.allocated_cnt++;
-        blk_info = (mem_blk_info_t *)node;
-        info.allocated_size += blk_info->blk_len;
-    }
+#if defined(NA_MEMORY_CHECK_DEBUG) && NA_MEMORY_CHECK_DEBUG
+static void na_memory_check(non_alloc_context_t *ctx)
+{
+    non_alloc_info_t info;
+    mem_blk_info_t *blk;
+    na_addr_t addr = ctx->non_addr;
+    na_size_t listed_cnt = 0;
+    int fl, sl;
+
+    na_get_info(ctx, &info);
 
-    if (info.free_cnt + info.allocated_cnt + info.unused_cnt != ctx->mem_info_num) {
+    if (info.free_blk_num + info.allocated_blk_num + info.unused_info_num != ctx->mem_info_num) {
         printf("[%s]: mem_info_num[%ld] != free_cnt[%ld] + allocated_cnt[%ld] + unsed_cnt[%ld]\n",\
-            __FUNCTION__, ctx->mem_info_num, info.free_cnt, info.allocated_cnt, info.unused_cnt);
+            __FUNCTION__, ctx->mem_info_num, info.free_blk_num, info.allocated_blk_num, info.unused_info_num);
     }
 
     if (info.free_size + info.allocated_size != ctx->non_len) {
         printf("[%s]: non_len[%ld] != free_size[%ld] + allocated_size[%ld]\n",\
             __FUNCTION__, ctx->non_len, info.free_size, info.allocated_size);
     }
+
+    for (blk = ctx->first; blk; blk = blk->nxt) {
+        if (blk->blk_start != addr || (blk->nxt && blk->nxt->pre != blk)) {
+            printf("[%s]: block at 0x%lx is not contiguous\n", __FUNCTION__, blk->blk_start);
+        }
+        if (blk->state == NON_ALLOC_STATE_FREE && blk->nxt && blk->nxt->state == NON_ALLOC_STATE_FREE) {
+            printf("[%s]: adjacent free blocks at 0x%lx\n", __FUNCTION__, blk->blk_start);
+        }
+        addr += blk->blk_len;
+    }
+
+    for (fl = 0; fl < NA_TLSF_FL_COUNT; fl++) {
+        for (sl = 0; sl < NA_TLSF_SL_COUNT; sl++) {
+            if (!ctx->free[fl][sl] != !(ctx->sl_bitmap[fl] & (1U << sl))) {
+                printf("[%s]: bitmap mismatch at fl[%d] sl[%d]\n", __FUNCTION__, fl, sl);
+            }
+            for (blk = ctx->free[fl][sl]; blk; blk = blk->free_nxt) {
+                int blk_fl, blk_sl;
+
+                na_mapping(blk->blk_len, &blk_fl, &blk_sl);
+                if (blk->state != NON_ALLOC_STATE_FREE || blk_fl != fl || blk_sl != sl) {
+                    printf("[%s]: block at 0x%lx in wrong list\n", __FUNCTION__, blk->blk_start);
+                }
+                listed_cnt++;
+            }
+        }
+        if (!ctx->sl_bitmap[fl] != !(ctx->fl_bitmap & (1U << fl))) {
+            printf("[%s]: bitmap mismatch at fl[%d]\n", __FUNCTION__, fl);
+        }
+    }
+
+    if (listed_cnt != info.free_blk_num) {
+        printf("[%s]: free_cnt[%ld] != listed_cnt[%ld]\n", __FUNCTION__, info.free_blk_num, listed_cnt);
+    }
 }
 
 #endif
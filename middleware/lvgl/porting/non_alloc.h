@@ -19,29 +19,50 @@
 #error "Unknown architecture"
 #endif
 
+/*
+ * Free blocks are kept in segregated lists: the first level splits sizes by power of two,
+ * the second level splits each power of two range into NA_TLSF_SL_COUNT lists.
+ */
+#define NA_TLSF_SL_LOG2 4
+#define NA_TLSF_SL_COUNT (1 << NA_TLSF_SL_LOG2)
+#define NA_TLSF_SMALL_LOG2 (NA_TLSF_SL_LOG2 + 2)
+/* block length is 30 bits wide */
+#define NA_TLSF_FL_COUNT (30 - NA_TLSF_SMALL_LOG2 + 1)
+
 typedef unsigned long na_addr_t;
 typedef unsigned long na_size_t;
 
-typedef struct na_list {
-    struct na_list *pre;
-    struct na_list *nxt;
-} na_list_t;
+struct mem_blk_info;
 
 typedef struct non_alloc_context {
     na_addr_t non_addr;
     na_size_t non_len;
     na_addr_t info_addr;
     na_addr_t info_len;
-    struct na_list unused;
-    struct na_list free;
-    struct na_list allocated;
+    struct mem_blk_info *unused;
+    struct mem_blk_info *first;
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[NA_TLSF_FL_COUNT];
+    struct mem_blk_info *free[NA_TLSF_FL_COUNT][NA_TLSF_SL_COUNT];
     na_size_t align;
     na_size_t mem_info_num;
 } non_alloc_context_t;
 
+typedef struct non_alloc_info {
+    na_size_t free_size;
+    na_size_t largest_free_size;
+    na_size_t free_blk_num;
+    na_size_t allocated_size;
+    na_size_t allocated_blk_num;
+    na_size_t unused_info_num;
+} non_alloc_info_t;
+
 int na_init(non_alloc_context_t *ctx, na_size_t mem_align, void *non_addr, na_size_t non_len, void *info_addr, na_size_t info_len);
 void *na_malloc(non_alloc_context_t *ctx, na_size_t size);
+/* align must be a power of two, it is raised to the alignment given to na_init() */
+void *na_malloc_align(non_alloc_context_t *ctx, na_size_t size, na_size_t align);
 void na_free(non_alloc_context_t *ctx, void *mem);
+/* walks all blocks, for debugging and fragmentation statistics */
+void na_get_info(non_alloc_context_t *ctx, non_alloc_info_t *info);
 
 #endif
-
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "board.h"
+#include "hpm_sdmmc_sd.h"
+#include "hpm_mchtmr_drv.h"
+#include "hpm_clock_drv.h"
+
+#define TEST_BLOCK_COUNT        (1024U)
+#define BUF_SIZE                (32U * 1024U)
+/* One queued request per quarter of the buffer, so that all slots of the queue are in use */
+#define REQUEST_SIZE            (BUF_SIZE / 4U)
+
+ATTR_PLACE_AT_NONCACHEABLE_BSS sdmmc_host_t g_sdmmc_host;
+static sd_card_t g_sd = { .host = &g_sdmmc_host };
+
+ATTR_PLACE_AT_NONCACHEABLE uint32_t s_write_buf[BUF_SIZE / sizeof(uint32_t)];
+ATTR_PLACE_AT_NONCACHEABLE uint32_t s_read_buf[BUF_SIZE / sizeof(uint32_t)];
+
+static volatile uint32_t s_done_count;
+static volatile hpm_stat_t s_async_status;
+
+SDK_DECLARE_EXT_ISR_M(BOARD_APP_SDCARD_SDXC_IRQ, isr_sdxc)
+void isr_sdxc(void)
+{
+    sdmmchost_irq_handler(&g_sdmmc_host);
+}
+
+/* Runs from isr_sdxc, the next queued request is already on the bus */
+static void async_done(hpm_stat_t status, sdmmchost_cmd_t *cmd, void *user_data)
+{
+    (void) cmd;
+    (void) user_data;
+    if (status != status_success) {
+        s_async_status = status;
+    }
+    s_done_count++;
+}
+
+static void wait_async_idle(void)
+{
+    while (sdmmchost_get_async_pending(&g_sdmmc_host) > 0U) {
+    }
+}
+
+static float speed_in_mb(uint32_t bytes, uint64_t ticks)
+{
+    return 1.0f * bytes / (1.0f * ticks / clock_get_frequency(clock_mchtmr0)) / 1024 / 1024;
+}
+
+static void fill_write_buf(void)
+{
+    srand((unsigned int) HPM_MCHTMR->MTIME);
+    for (uint32_t i = 0; i < ARRAY_SIZE(s_write_buf); i++) {
+        s_write_buf[i] = ((uint32_t) rand() << 16) | rand();
+    }
+}
+
+/* The blocking API sleeps on the transfer complete interrupt instead of polling the status */
+static bool test_blocking(uint32_t start_block)
+{
+    uint32_t step = BUF_SIZE / g_sd.block_size;
+    uint64_t write_ticks = 0;
+    uint64_t read_ticks = 0;
+    hpm_stat_t status = status_success;
+    bool result = false;
+
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i += step) {
+        uint64_t start_ticks = mchtmr_get_count(HPM_MCHTMR);
+        status = sd_write_blocks(&g_sd, (uint8_t *) s_write_buf, start_block + i, step);
+        if (status != status_success) {
+            break;
+        }
+        write_ticks += mchtmr_get_count(HPM_MCHTMR) - start_ticks;
+
+        start_ticks = mchtmr_get_count(HPM_MCHTMR);
+        status = sd_read_blocks(&g_sd, (uint8_t *) s_read_buf, start_block + i, step);
+        if (status != status_success) {
+            break;
+        }
+        read_ticks += mchtmr_get_count(HPM_MCHTMR) - start_ticks;
+        result = (memcmp(s_write_buf, s_read_buf, BUF_SIZE) == 0);
+        if (!result) {
+            break;
+        }
+    }
+
+    if (status != status_success) {
+        printf("Error code: %d\n", status);
+    }
+    printf("Blocking write-read-verify %s\n", result ? "PASSED" : "FAILED");
+    if (result) {
+        printf("Write Speed: %.2fMB/s, Read Speed: %.2fMB/s\n",
+               speed_in_mb(TEST_BLOCK_COUNT * g_sd.block_size, write_ticks),
+               speed_in_mb(TEST_BLOCK_COUNT * g_sd.block_size, read_ticks));
+    }
+    return result;
+}
+
+/*
+ * Requests are queued as long as a slot is free, the interrupt starts each one right after
+ * the previous one completes. The writes all come from the unchanged s_write_buf, each read
+ * window is verified once its HPM_SDMMC_HOST_ASYNC_QUEUE_DEPTH requests are completed.
+ */
+static bool test_queued(uint32_t start_block)
+{
+    uint32_t request_blocks = REQUEST_SIZE / g_sd.block_size;
+    uint32_t requests = TEST_BLOCK_COUNT / request_blocks;
+    uint32_t requests_per_buf = BUF_SIZE / REQUEST_SIZE;
+    uint64_t write_ticks;
+    uint64_t read_ticks = 0;
+    hpm_stat_t status = status_success;
+    bool result = false;
+
+    s_async_status = status_success;
+    s_done_count = 0;
+    uint64_t start_ticks = mchtmr_get_count(HPM_MCHTMR);
+    for (uint32_t i = 0; (i < requests) && (status == status_success);) {
+        uint32_t offset = (i % requests_per_buf) * REQUEST_SIZE;
+        status = sd_write_blocks_async(&g_sd, (uint8_t *) s_write_buf + offset, start_block + i * request_blocks,
+                                       request_blocks, async_done, NULL);
+        if (status == status_sdmmc_async_queue_full) {
+            status = status_success;
+        } else {
+            i++;
+        }
+    }
+    wait_async_idle();
+    write_ticks = mchtmr_get_count(HPM_MCHTMR) - start_ticks;
+
+    for (uint32_t i = 0; (i < requests) && (status == status_success) && (s_async_status == status_success);
+         i += requests_per_buf) {
+        memset(s_read_buf, 0, BUF_SIZE);
+        start_ticks = mchtmr_get_count(HPM_MCHTMR);
+        for (uint32_t j = 0; (j < requests_per_buf) && (status == status_success);) {
+            status = sd_read_blocks_async(&g_sd, (uint8_t *) s_read_buf + j * REQUEST_SIZE,
+                                          start_block + (i + j) * request_blocks, request_blocks, async_done, NULL);
+            if (status == status_sdmmc_async_queue_full) {
+                status = status_success;
+            } else {
+                j++;
+            }
+        }
+        wait_async_idle();
+        read_ticks += mchtmr_get_count(HPM_MCHTMR) - start_ticks;
+        result = (memcmp(s_write_buf, s_read_buf, BUF_SIZE) == 0);
+        if (!result) {
+            break;
+        }
+    }
+
+    if (status == status_success) {
+        status = s_async_status;
+    }
+    result = result && (status == status_success) && (s_done_count == 2U * requests);
+    if (status != status_success) {
+        printf("Error code: %d\n", status);
+    }
+    printf("Queued write-read-verify, %u requests of %u blocks %s\n", 2U * requests, request_blocks,
+           result ? "PASSED" : "FAILED");
+    if (result) {
+        printf("Write Speed: %.2fMB/s, Read Speed: %.2fMB/s\n",
+               speed_in_mb(TEST_BLOCK_COUNT * g_sd.block_size, write_ticks),
+               speed_in_mb(TEST_BLOCK_COUNT * g_sd.block_size, read_ticks));
+    }
+    return result;
+}
+
+int main(void)
+{
+    hpm_stat_t status;
+    board_init();
+
+    printf("SD card interrupt mode demo\n");
+    /* The card initialization already uses data transfers, which wait for the interrupt */
+    intc_m_enable_irq_with_priority(BOARD_APP_SDCARD_SDXC_IRQ, 1);
+    do {
+        printf("Please insert the SD card to SD slot...\n");
+        status = board_init_sd_host_params(&g_sdmmc_host, BOARD_APP_SDCARD_SDXC_BASE);
+        if (status != status_success) {
+            break;
+        }
+        status = sd_init(&g_sd);
+        if (status != status_success) {
+            board_delay_ms(1000);
+        }
+    } while (status != status_success);
+
+    printf("SD Card initialization succeeded, %u blocks of %u Bytes\n", g_sd.block_count, g_sd.block_size);
+
+    uint32_t start_block = g_sd.block_count - TEST_BLOCK_COUNT;
+    fill_write_buf();
+    bool result = test_blocking(start_block);
+    fill_write_buf();
+    result = test_queued(start_block) && result;
+    printf("Test completed, %s\n", result ? "PASSED" : "FAILED");
+
+    while (true) {
+    }
+
+    return 0;
+}
@@ -288,6 +288,37 @@ int main(void)
         fft_printf(&fft_buf[0], &fft_mag_output[0], point);
     }
     printf("**************************************\r\n\r\n\r\n\r\n");
+    /**
+     * @brief Software radix-4 with a precomputed plan.  2^j complex samples
+     *
+     */
+    for (uint8_t i = 6; i <= 10; i++) {
+        hpm_sw_fft_plan_t plan;
+        point = 1 << i;
+        shift = i;
+        hpm_sw_fft_plan_create(&plan, shift);
+        init_fft_inputbuf(&fft_buf[0], point);
+        start_time();
+        hpm_sw_cfft_f32(&plan, &fft_buf[0]);
+        run_times = get_end_time();
+        printf("Software fft plan radix-4 Total samples: %d.\r\n", point);
+        printf("total times:%d tick.\r\n", run_times);
+        fft_printf(&fft_buf[0], &fft_mag_output[0], point);
+
+        start_time();
+        hpm_sw_cifft_f32(&plan, &fft_buf[0]);
+        run_times = get_end_time();
+        printf("Software ifft plan radix-4 Total samples: %d.\r\n", point);
+        printf("total times:%d tick.\r\n", run_times);
+        for (uint32_t m = 0; m < 2 * point; m++) {
+            if ((fft_buf_copy[m] > fft_buf[m] + FFT_PRECISION) ||
+            (fft_buf_copy[m] < fft_buf[m] - FFT_PRECISION)) {
+                err_num++;
+            }
+        }
+        printf("------------------------------------\r\n\r\n\r\n");
+    }
+    printf("**************************************\r\n\r\n\r\n\r\n");
 /* conversion test */
     for (uint8_t i = 6; i <= 10; i++) {
         point = 1 << i;
@@ -141,8 +141,10 @@ Some MCUs allow computing and verifying the IP, UDP, TCP and ICMP checksums by h
   #define CHECKSUM_CHECK_UDP              0
   /* CHECKSUM_CHECK_TCP==0: Check checksums by hardware for incoming TCP packets.*/
   #define CHECKSUM_CHECK_TCP              0
-  /* CHECKSUM_CHECK_ICMP==0: Check checksums by hardware for incoming ICMP packets.*/
+  /* CHECKSUM_GEN_ICMP==0: Generate checksums by hardware for outgoing ICMP packets.*/
   #define CHECKSUM_GEN_ICMP               0
+  /* CHECKSUM_CHECK_ICMP==0: Check checksums by hardware for incoming ICMP packets.*/
+  #define CHECKSUM_CHECK_ICMP             0
 #else
   /* CHECKSUM_GEN_IP==1: Generate checksums in software for outgoing IP packets.*/
   #define CHECKSUM_GEN_IP                 1
@@ -156,8 +158,10 @@ Some MCUs allow computing and verifying the IP, UDP, TCP and ICMP checksums by h
   #define CHECKSUM_CHECK_UDP              1
   /* CHECKSUM_CHECK_TCP==1: Check checksums in software for incoming TCP packets.*/
   #define CHECKSUM_CHECK_TCP              1
-  /* CHECKSUM_CHECK_ICMP==1: Check checksums by hardware for incoming ICMP packets.*/
+  /* CHECKSUM_GEN_ICMP==1: Generate checksums in software for outgoing ICMP packets.*/
   #define CHECKSUM_GEN_ICMP               1
+  /* CHECKSUM_CHECK_ICMP==1: Check checksums in software for incoming ICMP packets.*/
+  #define CHECKSUM_CHECK_ICMP             1
 #endif
 
 
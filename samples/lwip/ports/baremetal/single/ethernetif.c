@@ -52,13 +52,12 @@
 
 #include "lwip/opt.h"
 #include "lwip/def.h"
-#include "lwip/mem.h"
 #include "lwip/pbuf.h"
 #include "lwip/netif.h"
 #include "lwip/err.h"
-#include "lwip/timeouts.h"
 #include "netif/etharp.h"
 #include "ethernetif.h"
+#include "hpm_enet_netif.h"
 #include "lwip.h"
 
 #if defined(NO_SYS) && !NO_SYS
@@ -70,7 +69,6 @@
 #endif
 #endif
 
-#define netifMTU                           (1500)
 #define netifINTERFACE_TASK_STACK_SIZE     (350)
 
 #if defined(__ENABLE_FREERTOS) && __ENABLE_FREERTOS
@@ -79,8 +77,6 @@
 #define netifINTERFACE_TASK_PRIORITY       (RT_THREAD_PRIORITY_MAX - 1)
 #endif
 
-#define netifGUARD_BLOCK_TIME              (250)
-
 /* The time to block waiting for input. */
 #define emacBLOCK_TIME_WAITING_FOR_INPUT   ((portTickType)100)
 
@@ -88,6 +84,26 @@
 #define IFNAME0 'e'
 #define IFNAME1 'n'
 
+/* Spare receive buffers swapped into the descriptors while lwIP holds received frames */
+#ifndef ENET_RX_POOL_COUNT
+#define ENET_RX_POOL_COUNT                 (ENET_RX_BUFF_COUNT / 2U)
+#endif
+
+/* Receive interrupt once per ENET_RX_COALESCING_FRAME_COUNT frames, or after the watchdog expires */
+#ifndef ENET_RX_COALESCING_FRAME_COUNT
+#define ENET_RX_COALESCING_FRAME_COUNT     (4U)
+#endif
+
+/* Units of 256 bus clock cycles */
+#ifndef ENET_RX_COALESCING_WATCHDOG
+#define ENET_RX_COALESCING_WATCHDOG        (32U)
+#endif
+
+ATTR_PLACE_AT_NONCACHEABLE_WITH_ALIGNMENT(ENET_SOC_BUFF_ADDR_ALIGNMENT)
+static uint8_t rx_pool_buff[ENET_RX_POOL_COUNT][ENET_RX_BUFF_SIZE];
+
+static hpm_enet_netif_t enet_netif;
+
 #if defined(NO_SYS) && !NO_SYS
 xSemaphoreHandle s_xSemaphore = NULL;
 #endif
@@ -99,19 +115,44 @@ xSemaphoreHandle s_xSemaphore = NULL;
 * @param netif the already initialized lwip network interface structure
 *        for this ethernetif
 */
-static void low_level_init(struct netif *netif)
+static err_t low_level_init(struct netif *netif)
 {
-    /* Set netif MAC hardware address length */
-    netif->hwaddr_len = ETHARP_HWADDR_LEN;
+    hpm_enet_netif_config_t config = {0};
+#if defined(__ENABLE_ENET_RECEIVE_INTERRUPT) && __ENABLE_ENET_RECEIVE_INTERRUPT
+    enet_rx_coalescing_config_t coalescing_config;
+#endif
+
+#ifdef CHECKSUM_BY_HARDWARE
+    /* lwIP neither generates nor checks the IP/TCP/UDP/ICMP checksums */
+    enet_enable_rx_checksum_offload(ENET, true);
+    desc.tx_control_config.cic = enet_cic_ip_pseudoheader;
+#else
+    enet_enable_rx_checksum_offload(ENET, false);
+    desc.tx_control_config.cic = enet_cic_disable;
+#endif
+
+#if defined(__ENABLE_ENET_RECEIVE_INTERRUPT) && __ENABLE_ENET_RECEIVE_INTERRUPT
+    coalescing_config.frame_count = ENET_RX_COALESCING_FRAME_COUNT;
+    coalescing_config.watchdog = ENET_RX_COALESCING_WATCHDOG;
+    if (enet_set_rx_coalescing(ENET, &desc, &coalescing_config) != status_success) {
+        return ERR_ARG;
+    }
+#endif
 
-    /* Set netif MAC hardware address */
-    memcpy(netif->hwaddr, mac, ETH_HWADDR_LEN);
+    config.base = ENET;
+    config.desc = &desc;
+    config.rx_pool_buff = (uint8_t *)rx_pool_buff;
+    config.rx_pool_count = ENET_RX_POOL_COUNT;
+    config.mac = mac;
+    config.running_core = BOARD_RUNNING_CORE;
 
-    /* Set netif maximum transfer unit */
-    netif->mtu = 1500;
+    if (hpm_enet_netif_setup(&enet_netif, &config) != status_success) {
+        return ERR_ARG;
+    }
 
-    /* Accept broadcast address and ARP traffic */
-    netif->flags |= NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_IGMP;
+    /* MAC address, MTU, flags and the output functions */
+    netif->state = &enet_netif;
+    hpm_enet_netif_init(netif);
 
 #if defined(NO_SYS) && !NO_SYS
     /* create binary semaphore used for informing ethernetif of frame reception */
@@ -123,214 +164,14 @@ static void low_level_init(struct netif *netif)
     xTaskCreate(ethernetif_input, "Eth_if", netifINTERFACE_TASK_STACK_SIZE, netif,
                 netifINTERFACE_TASK_PRIORITY, NULL);
 #endif
-}
-
-
-/**
-* This function should do the actual transmission of the packet. The packet is
-* contained in the pbuf that is passed to the function. This pbuf
-* might be chained.
-*
-* @param netif the lwip network interface structure for this ethernetif
-* @param p the MAC packet to send (e.g. IP packet including MAC addresses and type)
-* @return ERR_OK if the packet could be sent
-*         an err_t value if the packet couldn't be sent
-*
-* @note Returning ERR_MEM here if a DMA queue of your MAC is full can lead to
-*       strange results. You might consider waiting for space in the DMA queue
-*       to become availale since the stack doesn't retry to send a packet
-*       dropped because of memory failure (except for the TCP timers).
-*/
-
-static err_t low_level_output(struct netif *netif, struct pbuf *p)
-{
-    (void)netif;
-
-#if defined(NO_SYS) && !NO_SYS
-    static xSemaphoreHandle xTxSemaphore = NULL;
-#endif
-    struct pbuf *q;
-    uint8_t *buffer;
-
-    __IO enet_tx_desc_t *dma_tx_desc;
-    uint16_t frame_length = 0;
-    uint32_t buffer_offset = 0;
-    uint32_t bytes_left_to_copy = 0;
-    uint32_t payload_offset = 0;
-    enet_tx_desc_t  *tx_desc_list_cur = desc.tx_desc_list_cur;
-
-#if defined(LWIP_PTP) && LWIP_PTP
-    enet_ptp_ts_system_t timestamp;
-#endif
-
-#if defined(NO_SYS) && !NO_SYS
-    if (xTxSemaphore == NULL) {
-        vSemaphoreCreateBinary(xTxSemaphore);
-    }
-
-    if (xSemaphoreTake(xTxSemaphore, netifGUARD_BLOCK_TIME)) {
-#endif
-        dma_tx_desc = tx_desc_list_cur;
-        buffer = (uint8_t *)(dma_tx_desc->tdes2_bm.buffer1);
-        buffer_offset = 0;
-
-        for (q = p; q != NULL; q = q->next) {
-            /* Get bytes in current lwIP buffer  */
-            bytes_left_to_copy = q->len;
-            payload_offset = 0;
-
-
-            if (dma_tx_desc->tdes0_bm.own != 0) {
-                return ERR_INPROGRESS;
-            }
-
-            /* Check if the length of data to copy is bigger than Tx buffer size*/
-            while ((bytes_left_to_copy + buffer_offset) > ENET_TX_BUFF_SIZE) {
-                /* Copy data to Tx buffer*/
-                memcpy((uint8_t *)((uint8_t *)buffer + buffer_offset),
-                    (uint8_t *)((uint8_t *)q->payload + payload_offset),
-                            ENET_TX_BUFF_SIZE - buffer_offset);
-
-                /* Point to next descriptor */
-                dma_tx_desc = (enet_tx_desc_t *)(dma_tx_desc->tdes3_bm.next_desc);
-
-                /* Check if the buffer is available */
-                if (dma_tx_desc->tdes0_bm.own != 0) {
-                    return ERR_INPROGRESS;
-                }
-
-                buffer = (uint8_t *)(dma_tx_desc->tdes2_bm.buffer1);
-
-                bytes_left_to_copy = bytes_left_to_copy - (ENET_TX_BUFF_SIZE - buffer_offset);
-                payload_offset = payload_offset + (ENET_TX_BUFF_SIZE - buffer_offset);
-                frame_length = frame_length + (ENET_TX_BUFF_SIZE - buffer_offset);
-                buffer_offset = 0;
-            }
-
-            /* pass payload to buffer */
-            desc.tx_desc_list_cur->tdes2_bm.buffer1 = core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t)q->payload);
-            buffer_offset = buffer_offset + bytes_left_to_copy;
-            frame_length = frame_length + bytes_left_to_copy;
-        }
-        /* Prepare transmit descriptors to give to DMA*/
-        frame_length += 4;
-
-        #if defined(LWIP_PTP) && LWIP_PTP
-            enet_prepare_tx_desc_with_ts_record(ENET, &desc.tx_desc_list_cur, &desc.tx_control_config, frame_length, desc.tx_buff_cfg.size, &timestamp);
-            /* Get the transmit timestamp */
-            p->time_sec  = timestamp.sec;
-            p->time_nsec = timestamp.nsec;
-        #else
-            enet_prepare_tx_desc(ENET, &desc.tx_desc_list_cur, &desc.tx_control_config, frame_length, desc.tx_buff_cfg.size);
-        #endif
-
-#if defined(NO_SYS) && !NO_SYS
-        /* Give semaphore and exit */
-        xSemaphoreGive(xTxSemaphore);
-    }
-#endif
 
     return ERR_OK;
 }
 
-/**
-* Should allocate a pbuf and transfer the bytes of the incoming
-* packet from the interface into the pbuf.
-*
-* @param netif the lwip network interface structure for this ethernetif
-* @return a pbuf filled with the received packet (including MAC header)
-*         NULL on memory error
-*/
-static struct pbuf *low_level_input(struct netif *netif)
-{
-    (void)netif;
-
-    struct pbuf *p = NULL, *q;
-    u32_t len;
-    uint8_t *buffer;
-    enet_frame_t frame = {0, 0, 0};
-    enet_rx_desc_t *dma_rx_desc;
-    uint32_t buffer_offset = 0;
-    uint32_t payload_offset = 0;
-    uint32_t bytes_left_to_copy = 0;
-    uint32_t i = 0;
-
-    /* Check and get a received frame */
-    #if defined(__ENABLE_ENET_RECEIVE_INTERRUPT) && __ENABLE_ENET_RECEIVE_INTERRUPT || defined(NO_SYS) && !NO_SYS
-        frame = enet_get_received_frame_interrupt(&desc.rx_desc_list_cur, &desc.rx_frame_info, ENET_RX_BUFF_COUNT);
-    #else
-        if (enet_check_received_frame(&desc.rx_desc_list_cur, &desc.rx_frame_info) == 1) {
-            frame = enet_get_received_frame(&desc.rx_desc_list_cur, &desc.rx_frame_info);
-        }
-    #endif
-
-    /* Obtain the size of the packet and put it into the "len" variable. */
-    len = frame.length;
-    buffer = (uint8_t *)frame.buffer;
-
-    if (len > 0) {
-    /* Allocate a pbuf chain of pbufs from the Lwip buffer pool */
-        p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
-
-        if (p != NULL) {
-            dma_rx_desc = frame.rx_desc;
-            buffer_offset = 0;
-            for (q = p; q != NULL; q = q->next) {
-                bytes_left_to_copy = q->len;
-                payload_offset = 0;
-
-                /* Check if the length of bytes to copy in current pbuf is bigger than Rx buffer size*/
-                while ((bytes_left_to_copy + buffer_offset) > ENET_RX_BUFF_SIZE) {
-                    /* Copy data to pbuf*/
-                    memcpy((uint8_t *)((uint8_t *)q->payload + payload_offset), (uint8_t *)((uint8_t *)buffer + buffer_offset), (ENET_RX_BUFF_SIZE - buffer_offset));
-
-                    /* Point to next descriptor */
-                    dma_rx_desc = (enet_rx_desc_t *)(dma_rx_desc->rdes3_bm.next_desc);
-                    buffer = (uint8_t *)(dma_rx_desc->rdes2_bm.buffer1);
-
-                    bytes_left_to_copy = bytes_left_to_copy - (ENET_RX_BUFF_SIZE - buffer_offset);
-                    payload_offset = payload_offset + (ENET_RX_BUFF_SIZE - buffer_offset);
-                    buffer_offset = 0;
-                }
-
-            /* pass the buffer to pbuf */
-            q->payload = (void *)buffer;
-            buffer_offset = buffer_offset + bytes_left_to_copy;
-
-            #if defined(LWIP_PTP) && LWIP_PTP
-            /* Get the received timestamp */
-            p->time_sec  = frame.rx_desc->rdes7_bm.rtsh;
-            p->time_nsec = frame.rx_desc->rdes6_bm.rtsl;
-            #endif
-            }
-        }
-
-        /* Release descriptors to DMA */
-        dma_rx_desc = frame.rx_desc;
-
-        /* Set Own bit in Rx descriptors: gives the buffers back to DMA */
-        for (i = 0; i < desc.rx_frame_info.seg_count; i++) {
-            dma_rx_desc->rdes0_bm.own = 1;
-            dma_rx_desc = (enet_rx_desc_t *)(dma_rx_desc->rdes3_bm.next_desc);
-        }
-
-        /* Clear Segment_Count */
-        desc.rx_frame_info.seg_count = 0;
-    }
-
-    /* Resume Rx Process */
-    enet_rx_resume(ENET);
-
-    return p;
-}
-
-
 /**
 * This function is the ethernetif_input task, it is processed when a packet
-* is ready to be read from the interface. It uses the function low_level_input()
-* that should handle the actual reception of bytes from the network
-* interface. Then the type of the received packet is determined and
-* the appropriate input function is called.
+* is ready to be read from the interface. The received frames are passed
+* to netif->input by hpm_enet_netif_input().
 *
 * @param netif the lwip network interface structure for this ethernetif
 */
@@ -343,18 +184,9 @@ void ethernetif_input(void *pvParameters)
 {
     struct netif *netif = (struct netif *)pvParameters;
 
-    struct pbuf *p;
-
     for ( ;; ) {
         if (xSemaphoreTake(s_xSemaphore, emacBLOCK_TIME_WAITING_FOR_INPUT) == pdTRUE) {
-GET_NEXT_FRAME:
-            p = low_level_input(netif);
-            if (p != NULL) {
-                if (ERR_OK != netif->input(p, netif)) {
-                    pbuf_free(p);
-                } else {
-                    goto GET_NEXT_FRAME;
-                }
+            while (hpm_enet_netif_input(netif) > 0) {
             }
         }
     }
@@ -363,30 +195,15 @@ GET_NEXT_FRAME:
 err_t ethernetif_input(struct netif *netif)
 {
     err_t err = ERR_OK;
-    struct pbuf *p = NULL;
 #if defined(__ENABLE_ENET_RECEIVE_INTERRUPT) && __ENABLE_ENET_RECEIVE_INTERRUPT
     if (rx_flag) {
+        /* clear before reading so that a frame received meanwhile is not missed */
+        rx_flag = false;
 #endif
-        GET_NEXT_FRAME:
-        /* move received packet into a new pbuf */
-        p = low_level_input(netif);
-
-        /* no packet could be read, silently ignore this */
-        if (p == NULL) {
+        if (hpm_enet_netif_input(netif) == 0) {
             err = ERR_MEM;
-        } else {
-             /* entry point to the LwIP stack */
-            err = netif->input(p, netif);
-
-            if (err != ERR_OK) {
-                LWIP_DEBUGF(NETIF_DEBUG, ("ethernetif_input: IP input error\n"));
-                pbuf_free(p);
-            } else {
-                goto GET_NEXT_FRAME;
-            }
         }
 #if defined(__ENABLE_ENET_RECEIVE_INTERRUPT) && __ENABLE_ENET_RECEIVE_INTERRUPT
-        rx_flag = false;
     }
 #endif
     return err;
@@ -402,12 +219,13 @@ err_t ethernetif_input(struct netif *netif)
 *
 * @param netif the lwip network interface structure for this ethernetif
 * @return ERR_OK if the loopif is initialized
-*         ERR_MEM if private data couldn't be allocated
+*         ERR_ARG if the descriptor counts exceed the hpm_enet_netif limits
+*         or the receive interrupt coalescing config is invalid
 *         any other err_t on error
 */
 err_t ethernetif_init(struct netif *netif)
 {
-  LWIP_ASSERT("netif != NULL", (netif != NULL));
+    LWIP_ASSERT("netif != NULL", (netif != NULL));
 
 #if LWIP_NETIF_HOSTNAME
     /* Initialize interface hostname */
@@ -417,13 +235,12 @@ err_t ethernetif_init(struct netif *netif)
     netif->name[0] = IFNAME0;
     netif->name[1] = IFNAME1;
 
-    netif->output = etharp_output;
-    netif->linkoutput = low_level_output;
-
     /* initialize the hardware */
-    low_level_init(netif);
+    if (low_level_init(netif) != ERR_OK) {
+        return ERR_ARG;
+    }
 
     etharp_init();
 
     return ERR_OK;
-}
\ No newline at end of file
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * hpm_crc32.c backends against the bitwise CRC32
+ *
+ * 1. The bitwise backend must give the CRC32 check value 0xCBF43926 of "123456789".
+ * 2. crc32() of the NIBBLE, TABLE and SLICE8 backends must equal the bitwise one for every
+ *    length from 0 to CHECK_LEN at the buffer offsets 0 to 7.
+ * 3. crc32_init/update/final of every backend, fed with random chunk lengths that start at
+ *    odd offsets, must equal the bitwise crc32() of the whole buffer.
+ * 4. MB/s of every backend for 16 B to 64 KiB, the best of BENCH_REPEAT runs of BENCH_BYTES each.
+ *
+ * usage: ./crc32/Crc32Bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hpm_crc32.h"
+
+#define CHECK_LEN (1100U)
+#define MAX_LEN (64U * 1024U)
+#define BENCH_BYTES (16U << 20)
+#define BENCH_REPEAT (5)
+
+/* hpm_crc32.c built with -DHPM_CRC32_IMPL=HPM_CRC32_IMPL_<X> and its functions renamed, see Makefile */
+#define CRC32_BACKEND_DECLARE(name) \
+    uint32_t hpm_crc32_##name(const uint8_t *buf, uint32_t len); \
+    void hpm_crc32_##name##_init(crc32_context_t *ctx); \
+    void hpm_crc32_##name##_update(crc32_context_t *ctx, const uint8_t *buf, uint32_t len); \
+    uint32_t hpm_crc32_##name##_final(const crc32_context_t *ctx)
+
+CRC32_BACKEND_DECLARE(bitwise);
+CRC32_BACKEND_DECLARE(nibble);
+CRC32_BACKEND_DECLARE(table);
+CRC32_BACKEND_DECLARE(slice8);
+
+typedef struct {
+    const char *name;
+    uint32_t (*crc)(const uint8_t *buf, uint32_t len);
+    void (*init)(crc32_context_t *ctx);
+    void (*update)(crc32_context_t *ctx, const uint8_t *buf, uint32_t len);
+    uint32_t (*final)(const crc32_context_t *ctx);
+} crc32_backend_t;
+
+#define CRC32_BACKEND(name) \
+    { #name, hpm_crc32_##name, hpm_crc32_##name##_init, hpm_crc32_##name##_update, hpm_crc32_##name##_final }
+
+static const crc32_backend_t s_backends[] = {
+    CRC32_BACKEND(bitwise),
+    CRC32_BACKEND(nibble),
+    CRC32_BACKEND(table),
+    CRC32_BACKEND(slice8),
+};
+
+#define BACKEND_COUNT (sizeof(s_backends) / sizeof(s_backends[0]))
+
+static uint8_t s_data[MAX_LEN + 8];
+static int s_failures;
+
+static double time_seconds(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void check(int ok, const char *what, const crc32_backend_t *b, uint32_t offset, uint32_t length)
+{
+    if (!ok) {
+        printf("%s: %s, offset %u, %u byte\n", b->name, what, offset, length);
+        s_failures++;
+    }
+}
+
+static void check_lengths(const crc32_backend_t *b)
+{
+    for (uint32_t offset = 0; offset < 8U; offset++) {
+        for (uint32_t length = 0; length <= CHECK_LEN; length++) {
+            if (b->crc(s_data + offset, length) != hpm_crc32_bitwise(s_data + offset, length)) {
+                check(0, "crc32 differs from the bitwise crc32", b, offset, length);
+                return;
+            }
+        }
+    }
+}
+
+static void check_stream(const crc32_backend_t *b, uint32_t offset)
+{
+    uint32_t whole = hpm_crc32_bitwise(s_data + offset, MAX_LEN);
+    uint32_t pos = offset;
+    crc32_context_t ctx;
+
+    b->init(&ctx);
+    check(b->final(&ctx) == 0U, "final without update is not the crc32 of nothing", b, offset, 0);
+    while (pos < offset + MAX_LEN) {
+        /* mostly short odd chunks, so most of them start and end unaligned */
+        uint32_t length = ((uint32_t)rand() % 4U == 0U) ? (uint32_t)rand() % 3000U : (uint32_t)rand() % 13U;
+        if (length > offset + MAX_LEN - pos) {
+            length = offset + MAX_LEN - pos;
+        }
+        b->update(&ctx, s_data + pos, length);
+        pos += length;
+    }
+    check(b->final(&ctx) == whole, "crc32 fed in chunks differs", b, offset, MAX_LEN);
+    /* final does not change the context, the calculation may go on */
+    b->update(&ctx, s_data, 5U);
+    check(b->final(&ctx) != whole, "update after final has no effect", b, offset, 5U);
+}
+
+static void bench(uint32_t length)
+{
+    uint32_t calls = BENCH_BYTES / length;
+    double bytes = (double)calls * length;
+    volatile uint32_t sink;
+
+    printf("  %6u byte:", length);
+    for (uint32_t i = 0; i < BACKEND_COUNT; i++) {
+        const crc32_backend_t *b = &s_backends[i];
+        /* the bitwise loop runs an eighth of the calls to keep the run short */
+        uint32_t n = (i == 0U) ? calls / 8U : calls;
+        double best = 1e9;
+
+        for (int r = 0; r < BENCH_REPEAT; r++) {
+            double t0 = time_seconds();
+            for (uint32_t c = 0; c < n; c++) {
+                sink = b->crc(s_data + 1, length);
+            }
+            double t = (time_seconds() - t0) * calls / n;
+            best = (t < best) ? t : best;
+        }
+        printf(" %s %7.1f MB/s%s", b->name, bytes / best / 1e6, (i + 1U < BACKEND_COUNT) ? "," : "\n");
+    }
+    (void)sink;
+}
+
+int main(void)
+{
+    srand(1);
+    for (uint32_t i = 0; i < sizeof(s_data); i++) {
+        s_data[i] = (uint8_t)rand();
+    }
+
+    check(hpm_crc32_bitwise((const uint8_t *)"123456789", 9U) == 0xCBF43926UL, "wrong check value", &s_backends[0], 0, 9U);
+    for (uint32_t i = 1; i < BACKEND_COUNT; i++) {
+        check_lengths(&s_backends[i]);
+    }
+    for (uint32_t i = 0; i < BACKEND_COUNT; i++) {
+        for (uint32_t offset = 0; offset < 8U; offset++) {
+            check_stream(&s_backends[i], offset);
+        }
+    }
+    printf("lengths 0 to %u at offsets 0 to 7, chunked init/update/final %s\n", CHECK_LEN, s_failures ? "FAIL" : "ok");
+
+    for (uint32_t length = 16U; length <= MAX_LEN; length *= 4U) {
+        bench(length);
+    }
+
+    printf(s_failures ? "FAILED\n" : "PASSED.\n");
+    return s_failures ? 1 : 0;
+}
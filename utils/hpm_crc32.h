@@ -9,13 +9,66 @@
 #define _HPM_CRC32_H
 
 #include <stdint.h>
+
+/*
+ * CRC32 (IEEE 802.3, reflected polynomial 0xEDB88320) calculation backends
+ *
+ * HPM_CRC32_IMPL_BITWISE: one bit per iteration, no table
+ * HPM_CRC32_IMPL_NIBBLE:  4 bits per iteration, 64 bytes table
+ * HPM_CRC32_IMPL_TABLE:   8 bits per iteration, 1 KiB table
+ * HPM_CRC32_IMPL_SLICE8:  64 bits per iteration, 8 KiB table
+ */
+#define HPM_CRC32_IMPL_BITWISE (0U)
+#define HPM_CRC32_IMPL_NIBBLE  (1U)
+#define HPM_CRC32_IMPL_TABLE   (2U)
+#define HPM_CRC32_IMPL_SLICE8  (3U)
+
+#ifndef HPM_CRC32_IMPL
+#define HPM_CRC32_IMPL HPM_CRC32_IMPL_TABLE
+#endif
+
+typedef struct {
+    uint32_t crc;
+} crc32_context_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus  */
 
+/**
+ * @brief Calculate CRC32 of a buffer in one shot
+ *
+ * @param [in] buf data buffer
+ * @param [in] len data length in bytes
+ * @return CRC32 value
+ */
 uint32_t crc32(const uint8_t *buf, uint32_t len);
 
+/**
+ * @brief Initialize an incremental CRC32 calculation
+ *
+ * @param [out] ctx CRC32 context
+ */
+void crc32_init(crc32_context_t *ctx);
+
+/**
+ * @brief Feed a chunk of data into an incremental CRC32 calculation
+ *
+ * @param [in,out] ctx CRC32 context
+ * @param [in] buf data buffer
+ * @param [in] len data length in bytes
+ */
+void crc32_update(crc32_context_t *ctx, const uint8_t *buf, uint32_t len);
+
+/**
+ * @brief Finish an incremental CRC32 calculation
+ *
+ * @param [in] ctx CRC32 context
+ * @return CRC32 value of all data fed since crc32_init
+ */
+uint32_t crc32_final(const crc32_context_t *ctx);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus  */
-#endif
\ No newline at end of file
+#endif